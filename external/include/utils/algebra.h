@@ -40,6 +40,18 @@ construct an appropriate projection matrix for a particular graphics API.
 #define GRAPHICS_API_D3D		0
 #define GRAPHICS_API_METAL		0
 
+Set the following define to one before including this header file to use SSE or NEON
+for some of the matrix operations. The SIMD code evaluates the products and sums in the
+same order as the scalar code, but the results are only bit-identical when the compiler
+does not contract the scalar code into fused multiply-adds (-ffp-contract=off).
+
+#define KSALGEBRA_SIMD			0
+
+The NEON code has not been compiled or checked against the scalar code on an ARM target.
+It is only used when the following define is also set to one.
+
+#define KSALGEBRA_SIMD_NEON		0
+
 
 INTERFACE
 =========
@@ -117,6 +129,16 @@ static bool ksMatrix4x4f_CullBounds( const ksMatrix4x4f * mvp, const ksVector3f
 #include <math.h>
 #include <stdbool.h>
 
+#if defined( KSALGEBRA_SIMD ) && KSALGEBRA_SIMD == 1
+	#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+		#include <xmmintrin.h>			// for SSE
+		#define KSALGEBRA_USE_SSE
+	#elif ( defined( __ARM_NEON__ ) || defined( __ARM_NEON ) ) && defined( KSALGEBRA_SIMD_NEON ) && KSALGEBRA_SIMD_NEON == 1
+		#include <arm_neon.h>			// for NEON
+		#define KSALGEBRA_USE_NEON
+	#endif
+#endif
+
 #define MATH_PI				3.14159265358979323846f
 
 #define DEFAULT_NEAR_Z		0.015625f		// exact floating point representation
@@ -359,8 +381,36 @@ static void ksMatrix3x4f_CreateFromMatrix4x4f( ksMatrix3x4f * result, const ksMa
 }
 
 // Use left-multiplication to accumulate transformations.
+// The optional SIMD paths evaluate the products and sums in the same order as the scalar code.
 static void ksMatrix4x4f_Multiply( ksMatrix4x4f * result, const ksMatrix4x4f * a, const ksMatrix4x4f * b )
 {
+#if defined( KSALGEBRA_USE_SSE )
+	const __m128 a0 = _mm_loadu_ps( a->m[0] );
+	const __m128 a1 = _mm_loadu_ps( a->m[1] );
+	const __m128 a2 = _mm_loadu_ps( a->m[2] );
+	const __m128 a3 = _mm_loadu_ps( a->m[3] );
+	for ( int i = 0; i < 4; i++ )
+	{
+		__m128 r = _mm_mul_ps( a0, _mm_set1_ps( b->m[i][0] ) );
+		r = _mm_add_ps( r, _mm_mul_ps( a1, _mm_set1_ps( b->m[i][1] ) ) );
+		r = _mm_add_ps( r, _mm_mul_ps( a2, _mm_set1_ps( b->m[i][2] ) ) );
+		r = _mm_add_ps( r, _mm_mul_ps( a3, _mm_set1_ps( b->m[i][3] ) ) );
+		_mm_storeu_ps( result->m[i], r );
+	}
+#elif defined( KSALGEBRA_USE_NEON )
+	const float32x4_t a0 = vld1q_f32( a->m[0] );
+	const float32x4_t a1 = vld1q_f32( a->m[1] );
+	const float32x4_t a2 = vld1q_f32( a->m[2] );
+	const float32x4_t a3 = vld1q_f32( a->m[3] );
+	for ( int i = 0; i < 4; i++ )
+	{
+		float32x4_t r = vmulq_f32( a0, vdupq_n_f32( b->m[i][0] ) );
+		r = vaddq_f32( r, vmulq_f32( a1, vdupq_n_f32( b->m[i][1] ) ) );
+		r = vaddq_f32( r, vmulq_f32( a2, vdupq_n_f32( b->m[i][2] ) ) );
+		r = vaddq_f32( r, vmulq_f32( a3, vdupq_n_f32( b->m[i][3] ) ) );
+		vst1q_f32( result->m[i], r );
+	}
+#else
 	result->m[0][0] = a->m[0][0] * b->m[0][0] + a->m[1][0] * b->m[0][1] + a->m[2][0] * b->m[0][2] + a->m[3][0] * b->m[0][3];
 	result->m[0][1] = a->m[0][1] * b->m[0][0] + a->m[1][1] * b->m[0][1] + a->m[2][1] * b->m[0][2] + a->m[3][1] * b->m[0][3];
 	result->m[0][2] = a->m[0][2] * b->m[0][0] + a->m[1][2] * b->m[0][1] + a->m[2][2] * b->m[0][2] + a->m[3][2] * b->m[0][3];
@@ -380,6 +430,7 @@ static void ksMatrix4x4f_Multiply( ksMatrix4x4f * result, const ksMatrix4x4f * a
 	result->m[3][1] = a->m[0][1] * b->m[3][0] + a->m[1][1] * b->m[3][1] + a->m[2][1] * b->m[3][2] + a->m[3][1] * b->m[3][3];
 	result->m[3][2] = a->m[0][2] * b->m[3][0] + a->m[1][2] * b->m[3][1] + a->m[2][2] * b->m[3][2] + a->m[3][2] * b->m[3][3];
 	result->m[3][3] = a->m[0][3] * b->m[3][0] + a->m[1][3] * b->m[3][1] + a->m[2][3] * b->m[3][2] + a->m[3][3] * b->m[3][3];
+#endif
 }
 
 // Creates the transpose of the given matrix.
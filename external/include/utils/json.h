@@ -493,7 +493,8 @@ static int MemberIndexToMapIndex( int index )
 	}
 	return 0;
 #elif defined( __GNUC__ ) || defined( __clang__ )
-	return 32 - __builtin_clz( (unsigned int) index );
+	// The result of __builtin_clz is undefined for zero.
+	return ( index != 0 ) ? 32 - __builtin_clz( (unsigned int) index ) : 0;
 #else
 	int r = 0;
 	int t;
@@ -508,8 +509,8 @@ static int MemberIndexToMapIndex( int index )
 
 static int MapMemberOffset( int mapIndex )
 {
-	const int offset = ( 1 << ( mapIndex - 1 ) ) << JSON_BASE_ALLOC_PWR;
-	assert( mapIndex >= 1 || offset == 0 );	// Protect againt negative shift not producing zero.
+	// A negative shift is undefined so the first map explicitly starts at zero.
+	const int offset = ( mapIndex >= 1 ) ? ( ( 1 << ( mapIndex - 1 ) ) << JSON_BASE_ALLOC_PWR ) : 0;
 	return offset;
 }
 
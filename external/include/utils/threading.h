@@ -111,7 +111,7 @@ static ksAtomicUint32 ksAtomicUint32_Increment( ksAtomicUint32 * atomicUint32 )
 #elif defined( OS_HEXAGON )
 	return qurt_atomic_inc_return( atomicUint32 );
 #else
-	return __sync_fetch_and_add( atomicUint32, 1 );
+	return __sync_add_and_fetch( atomicUint32, 1 );
 #endif
 }
 
@@ -122,7 +122,7 @@ static ksAtomicUint32 ksAtomicUint32_Decrement( ksAtomicUint32 * atomicUint32 )
 #elif defined( OS_HEXAGON )
 	return qurt_atomic_dec_return( atomicUint32 );
 #else
-	return __sync_fetch_and_add( atomicUint32, -1 );
+	return __sync_add_and_fetch( atomicUint32, -1 );
 #endif
 }
 
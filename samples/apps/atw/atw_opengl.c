@@ -186,6 +186,8 @@ The following command-line options can be used to change various settings.
 	-w <0-3>	set per eye triangles per draw call level
 	-e <0-3>	set per eye fragment program complexity level
 	-m <0-1>	enable/disable multi-view
+	-n <0-1>	enable/disable instanced draw calls
+	-j <0-1>	enable/disable indirect draw calls
 	-c <0-1>	enable/disable correction for chromatic aberration
 	-i <name>	set time warp implementation: graphics, compute
 	-z <name>	set the render mode: atw, tw, scene
@@ -210,6 +212,8 @@ The following keys can be used at run-time to change various settings.
 	[W]		= cycle per eye triangles per draw call level
 	[E]		= cycle per eye fragment program complexity level
 	[M]		= toggle multi-view
+	[N]		= toggle instanced draw calls
+	[J]		= toggle indirect draw calls
 	[C]		= toggle correction for chromatic aberration
 	[I]		= toggle time warp implementation: graphics, compute
 	[Z]		= cycle the render mode: atw, tw, scene
@@ -573,6 +577,8 @@ Common headers
 #include <utils/sysinfo.h>
 #include <utils/nanoseconds.h>
 #include <utils/threading.h>
+
+#define KSALGEBRA_SIMD		1		// SSE matrix multiply, built with -ffp-contract=off so the results match the scalar code
 #include <utils/algebra.h>
 
 /*
@@ -1064,6 +1070,7 @@ typedef struct
 	bool multi_view;						// GL_OVR_multiview, GL_OVR_multiview2
 	bool multi_sampled_resolve;				// GL_EXT_multisampled_render_to_texture
 	bool multi_view_multi_sampled_resolve;	// GL_OVR_multiview_multisampled_render_to_texture
+	bool multi_draw_indirect;				// GL_ARB_multi_draw_indirect
 
 	int texture_clamp_to_border_id;
 } ksOpenGLExtensions;
@@ -1253,6 +1260,7 @@ PFNGLUNIFORMMATRIX4X3FVPROC							glUniformMatrix4x3fv;
 PFNGLUNIFORMMATRIX4FVPROC							glUniformMatrix4fv;
 
 PFNGLDRAWELEMENTSINSTANCEDPROC						glDrawElementsInstanced;
+PFNGLMULTIDRAWELEMENTSINDIRECTPROC					glMultiDrawElementsIndirect;
 PFNGLDISPATCHCOMPUTEPROC							glDispatchCompute;
 PFNGLMEMORYBARRIERPROC								glMemoryBarrier;
 
@@ -1387,6 +1395,7 @@ static void GlInitExtensions()
 	glShaderStorageBlockBinding					= (PFNGLSHADERSTORAGEBLOCKBINDINGPROC)	GetExtension( "glShaderStorageBlockBinding" );
 
 	glDrawElementsInstanced						= (PFNGLDRAWELEMENTSINSTANCEDPROC)		GetExtension( "glDrawElementsInstanced" );
+	glMultiDrawElementsIndirect					= (PFNGLMULTIDRAWELEMENTSINDIRECTPROC)	GetExtension( "glMultiDrawElementsIndirect" );
 	glDispatchCompute							= (PFNGLDISPATCHCOMPUTEPROC)			GetExtension( "glDispatchCompute" );
 	glMemoryBarrier								= (PFNGLMEMORYBARRIERPROC)				GetExtension( "glMemoryBarrier" );
 
@@ -1429,6 +1438,7 @@ static void GlInitExtensions()
 	glExtensions.multi_view							= GlCheckExtension( "GL_OVR_multiview2" );
 	glExtensions.multi_sampled_resolve				= GlCheckExtension( "GL_EXT_multisampled_render_to_texture" );
 	glExtensions.multi_view_multi_sampled_resolve	= GlCheckExtension( "GL_OVR_multiview_multisampled_render_to_texture" );
+	glExtensions.multi_draw_indirect				= GlCheckExtension( "GL_ARB_multi_draw_indirect" ) || ( OPENGL_VERSION_MAJOR * 10 + OPENGL_VERSION_MINOR >= 43 );
 
 	glExtensions.texture_clamp_to_border_id			= GL_CLAMP_TO_BORDER;
 }
@@ -1449,6 +1459,7 @@ static void GlInitExtensions()
 	glExtensions.multi_view							= GlCheckExtension( "GL_OVR_multiview2" );
 	glExtensions.multi_sampled_resolve				= GlCheckExtension( "GL_EXT_multisampled_render_to_texture" );
 	glExtensions.multi_view_multi_sampled_resolve	= GlCheckExtension( "GL_OVR_multiview_multisampled_render_to_texture" );
+	glExtensions.multi_draw_indirect				= false;
 
 	glExtensions.texture_clamp_to_border_id			= GL_CLAMP_TO_BORDER;
 }
@@ -1566,6 +1577,7 @@ static void GlInitExtensions()
 	glExtensions.multi_view							= GlCheckExtension( "GL_OVR_multiview2" );
 	glExtensions.multi_sampled_resolve				= GlCheckExtension( "GL_EXT_multisampled_render_to_texture" );
 	glExtensions.multi_view_multi_sampled_resolve	= GlCheckExtension( "GL_OVR_multiview_multisampled_render_to_texture" );
+	glExtensions.multi_draw_indirect				= false;
 
 	glExtensions.texture_clamp_to_border_id			=	( GlCheckExtension( "GL_OES_texture_border_clamp" ) ? GL_CLAMP_TO_BORDER :
 														( GlCheckExtension( "GL_EXT_texture_border_clamp" ) ? GL_CLAMP_TO_BORDER :
@@ -1592,7 +1604,9 @@ Compute support
 	#define GL_TEXTURE_FETCH_BARRIER_BIT		0x00000008
 	#define GL_TEXTURE_UPDATE_BARRIER_BIT		0x00000100
 	#define GL_SHADER_IMAGE_ACCESS_BARRIER_BIT	0x00000020
+	#define GL_COMMAND_BARRIER_BIT				0x00000040
 	#define GL_FRAMEBUFFER_BARRIER_BIT			0x00000400
+	#define GL_SHADER_STORAGE_BARRIER_BIT		0x00002000
 	#define GL_ALL_BARRIER_BITS					0xFFFFFFFF
 
 	static GLuint glGetProgramResourceIndex( GLuint program, GLenum programInterface, const GLchar *name ) { assert( false ); return 0; }
@@ -1620,7 +1634,9 @@ Compute support
 
 	#define GL_TEXTURE_FETCH_BARRIER_BIT		0x00000008
 	#define GL_SHADER_IMAGE_ACCESS_BARRIER_BIT	0x00000020
+	#define GL_COMMAND_BARRIER_BIT				0x00000040
 	#define GL_FRAMEBUFFER_BARRIER_BIT			0x00000400
+	#define GL_SHADER_STORAGE_BARRIER_BIT		0x00002000
 	#define GL_ALL_BARRIER_BITS					0xFFFFFFFF
 
 	static GLuint glGetProgramResourceIndex( GLuint program, GLenum programInterface, const GLchar *name ) { assert( false ); return 0; }
@@ -1637,6 +1653,22 @@ Compute support
 
 #endif
 
+/*
+================================
+Indirect draw support
+================================
+*/
+
+#if defined( OS_APPLE_MACOS ) || defined( OS_ANDROID )
+
+	#if !defined( GL_DRAW_INDIRECT_BUFFER )
+	#define GL_DRAW_INDIRECT_BUFFER				0x8F3F
+	#endif
+
+	static void glMultiDrawElementsIndirect( GLenum mode, GLenum type, const void * indirect, GLsizei drawcount, GLsizei stride ) { assert( false ); }
+
+#endif
+
 #if !defined( GL_SR8_EXT )
 #define GL_SR8_EXT							0x8FBD
 #endif
@@ -1806,6 +1838,7 @@ typedef struct ksGpuLimits
 {
 	size_t					maxPushConstantsSize;
 	int						maxSamples;
+	bool					drawIndirect;
 } ksGpuLimits;
 
 typedef struct
@@ -2673,6 +2706,7 @@ static void ksGpuContext_GetLimits( ksGpuContext * context, ksGpuLimits * limits
 
 	limits->maxPushConstantsSize = 512;
 	limits->maxSamples = glGetInteger( GL_MAX_SAMPLES );
+	limits->drawIndirect = glExtensions.multi_draw_indirect && OPENGL_COMPUTE_ENABLED;
 }
 
 /*
@@ -5247,6 +5281,7 @@ For optimal performance a buffer should only be created at load time, not at run
 The best performance is typically achieved when the buffer is not host visible.
 
 ksGpuBufferType
+ksGpuBufferUsage
 ksGpuBuffer
 
 static bool ksGpuBuffer_Create( ksGpuContext * context, ksGpuBuffer * buffer, const ksGpuBufferType type,
@@ -5262,9 +5297,16 @@ typedef enum
 	KS_GPU_BUFFER_TYPE_VERTEX,
 	KS_GPU_BUFFER_TYPE_INDEX,
 	KS_GPU_BUFFER_TYPE_UNIFORM,
-	KS_GPU_BUFFER_TYPE_STORAGE
+	KS_GPU_BUFFER_TYPE_STORAGE,
+	KS_GPU_BUFFER_TYPE_INDIRECT
 } ksGpuBufferType;
 
+typedef enum
+{
+	KS_GPU_BUFFER_USAGE_STORAGE,		// buffer is written by a compute program
+	KS_GPU_BUFFER_USAGE_INDIRECT		// buffer is read as indirect draw commands
+} ksGpuBufferUsage;
+
 typedef struct
 {
 	GLuint			target;
@@ -5283,7 +5325,8 @@ static bool ksGpuBuffer_Create( ksGpuContext * context, ksGpuBuffer * buffer, co
 						( ( type == KS_GPU_BUFFER_TYPE_INDEX ) ?	GL_ELEMENT_ARRAY_BUFFER :
 						( ( type == KS_GPU_BUFFER_TYPE_UNIFORM ) ?	GL_UNIFORM_BUFFER :
 						( ( type == KS_GPU_BUFFER_TYPE_STORAGE ) ?	GL_SHADER_STORAGE_BUFFER :
-																	0 ) ) ) );
+						( ( type == KS_GPU_BUFFER_TYPE_INDIRECT ) ?	GL_DRAW_INDIRECT_BUFFER :
+																	0 ) ) ) ) );
 	buffer->size = dataSize;
 
 	GL( glGenBuffers( 1, &buffer->buffer ) );
@@ -6604,7 +6647,8 @@ typedef enum
 	VERTEX_ATTRIBUTE_FLAG_UV2			= BIT( 7 ),		// vec2 vertexUv2
 	VERTEX_ATTRIBUTE_FLAG_JOINT_INDICES	= BIT( 8 ),		// vec4 jointIndices
 	VERTEX_ATTRIBUTE_FLAG_JOINT_WEIGHTS	= BIT( 9 ),		// vec4 jointWeights
-	VERTEX_ATTRIBUTE_FLAG_TRANSFORM		= BIT( 10 )		// mat4 vertexTransform (NOTE this mat4 takes up 4 attribute locations)
+	VERTEX_ATTRIBUTE_FLAG_TRANSFORM		= BIT( 10 ),	// mat4 vertexTransform (NOTE this mat4 takes up 4 attribute locations)
+	VERTEX_ATTRIBUTE_FLAG_TRANSFORM_INVERSE	= BIT( 11 )	// mat4 vertexTransformInverse (NOTE this mat4 takes up 4 attribute locations)
 } ksDefaultVertexAttributeFlags;
 
 typedef struct
@@ -6621,6 +6665,7 @@ typedef struct
 	ksVector4f *				jointIndices;
 	ksVector4f *				jointWeights;
 	ksMatrix4x4f *				transform;
+	ksMatrix4x4f *				transformInverse;
 } ksDefaultVertexAttributeArrays;
 
 static const ksGpuVertexAttribute DefaultVertexAttributeLayout[] =
@@ -6636,6 +6681,7 @@ static const ksGpuVertexAttribute DefaultVertexAttributeLayout[] =
 	{ VERTEX_ATTRIBUTE_FLAG_JOINT_INDICES,	OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, jointIndices ),	SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, jointIndices[0] ),	KS_GPU_ATTRIBUTE_FORMAT_R32G32B32A32_SFLOAT,	1,	"vertexJointIndices" },
 	{ VERTEX_ATTRIBUTE_FLAG_JOINT_WEIGHTS,	OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, jointWeights ),	SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, jointWeights[0] ),	KS_GPU_ATTRIBUTE_FORMAT_R32G32B32A32_SFLOAT,	1,	"vertexJointWeights" },
 	{ VERTEX_ATTRIBUTE_FLAG_TRANSFORM,		OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, transform ),		SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, transform[0] ),		KS_GPU_ATTRIBUTE_FORMAT_R32G32B32A32_SFLOAT,	4,	"vertexTransform" },
+	{ VERTEX_ATTRIBUTE_FLAG_TRANSFORM_INVERSE,	OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, transformInverse ),	SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, transformInverse[0] ),	KS_GPU_ATTRIBUTE_FORMAT_R32G32B32A32_SFLOAT,	4,	"vertexTransformInverse" },
 	{ 0, 0, 0, 0, 0, "" }
 };
 
@@ -8569,6 +8615,7 @@ at least past the submission of the command buffer into which the graphics comma
 submitted. Because pointers are maintained as state, DO NOT use pointers to local
 variables that will go out of scope before the command buffer is submitted.
 
+ksGpuDrawIndirectCommand
 ksGpuGraphicsCommand
 
 static void ksGpuGraphicsCommand_Init( ksGpuGraphicsCommand * command );
@@ -8597,17 +8644,31 @@ static void ksGpuGraphicsCommand_SetParmFloatMatrix4x2( ksGpuGraphicsCommand * c
 static void ksGpuGraphicsCommand_SetParmFloatMatrix4x3( ksGpuGraphicsCommand * command, const int index, const ksMatrix4x3f * value );
 static void ksGpuGraphicsCommand_SetParmFloatMatrix4x4( ksGpuGraphicsCommand * command, const int index, const ksMatrix4x4f * value );
 static void ksGpuGraphicsCommand_SetNumInstances( ksGpuGraphicsCommand * command, const int numInstances );
+static void ksGpuGraphicsCommand_SetIndirectBuffer( ksGpuGraphicsCommand * command, const ksGpuBuffer * indirectBuffer, const int firstDraw, const int drawCount );
 
 ================================================================================================================================
 */
 
+// Same layout as DrawElementsIndirectCommand.
+typedef struct
+{
+	uint32_t	indexCount;
+	uint32_t	instanceCount;
+	uint32_t	firstIndex;
+	int32_t		vertexOffset;
+	uint32_t	firstInstance;
+} ksGpuDrawIndirectCommand;
+
 typedef struct
 {
 	const ksGpuGraphicsPipeline *	pipeline;
 	const ksGpuBuffer *				vertexBuffer;		// vertex buffer returned by ksGpuCommandBuffer_MapVertexAttributes
 	const ksGpuBuffer *				instanceBuffer;		// instance buffer returned by ksGpuCommandBuffer_MapInstanceAttributes
+	const ksGpuBuffer *				indirectBuffer;		// buffer with ksGpuDrawIndirectCommand structures
 	ksGpuProgramParmState			parmState;
 	int								numInstances;
+	int								indirectFirstDraw;
+	int								indirectDrawCount;
 } ksGpuGraphicsCommand;
 
 static void ksGpuGraphicsCommand_Init( ksGpuGraphicsCommand * command )
@@ -8615,8 +8676,11 @@ static void ksGpuGraphicsCommand_Init( ksGpuGraphicsCommand * command )
 	command->pipeline = NULL;
 	command->vertexBuffer = NULL;
 	command->instanceBuffer = NULL;
+	command->indirectBuffer = NULL;
 	memset( (void *)&command->parmState, 0, sizeof( command->parmState ) );
 	command->numInstances = 1;
+	command->indirectFirstDraw = 0;
+	command->indirectDrawCount = 0;
 }
 
 static void ksGpuGraphicsCommand_SetPipeline( ksGpuGraphicsCommand * command, const ksGpuGraphicsPipeline * pipeline )
@@ -8744,6 +8808,13 @@ static void ksGpuGraphicsCommand_SetNumInstances( ksGpuGraphicsCommand * command
 	command->numInstances = numInstances;
 }
 
+static void ksGpuGraphicsCommand_SetIndirectBuffer( ksGpuGraphicsCommand * command, const ksGpuBuffer * indirectBuffer, const int firstDraw, const int drawCount )
+{
+	command->indirectBuffer = indirectBuffer;
+	command->indirectFirstDraw = firstDraw;
+	command->indirectDrawCount = drawCount;
+}
+
 /*
 ================================================================================================================================
 
@@ -8942,6 +9013,7 @@ static void ksGpuCommandBuffer_EndPrimary( ksGpuCommandBuffer * commandBuffer );
 static ksGpuFence * ksGpuCommandBuffer_SubmitPrimary( ksGpuCommandBuffer * commandBuffer );
 
 static void ksGpuCommandBuffer_ChangeTextureUsage( ksGpuCommandBuffer * commandBuffer, ksGpuTexture * texture, const ksGpuTextureUsage usage );
+static void ksGpuCommandBuffer_ChangeBufferUsage( ksGpuCommandBuffer * commandBuffer, ksGpuBuffer * buffer, const ksGpuBufferUsage usage );
 
 static void ksGpuCommandBuffer_BeginFramebuffer( ksGpuCommandBuffer * commandBuffer, ksGpuFramebuffer * framebuffer, const int arrayLayer, const ksGpuTextureUsage usage );
 static void ksGpuCommandBuffer_EndFramebuffer( ksGpuCommandBuffer * commandBuffer, ksGpuFramebuffer * framebuffer, const int arrayLayer, const ksGpuTextureUsage usage );
@@ -9180,6 +9252,18 @@ static void ksGpuCommandBuffer_ChangeTextureUsage( ksGpuCommandBuffer * commandB
 	commandBuffer->currentTextureUsage = usage;
 }
 
+static void ksGpuCommandBuffer_ChangeBufferUsage( ksGpuCommandBuffer * commandBuffer, ksGpuBuffer * buffer, const ksGpuBufferUsage usage )
+{
+	UNUSED_PARM( commandBuffer );
+	UNUSED_PARM( buffer );
+
+	// Only indirect draw commands are written by compute programs, so the barrier does not need to be tracked per buffer.
+	const GLbitfield barriers =	( ( usage == KS_GPU_BUFFER_USAGE_STORAGE ) ?	GL_SHADER_STORAGE_BARRIER_BIT :
+								( ( usage == KS_GPU_BUFFER_USAGE_INDIRECT ) ?	GL_COMMAND_BARRIER_BIT : GL_ALL_BARRIER_BITS ) );
+
+	GL( glMemoryBarrier( barriers ) );
+}
+
 static void ksGpuCommandBuffer_BeginFramebuffer( ksGpuCommandBuffer * commandBuffer, ksGpuFramebuffer * framebuffer, const int arrayLayer, const ksGpuTextureUsage usage )
 {
 	assert( commandBuffer->type == KS_GPU_COMMAND_BUFFER_TYPE_PRIMARY );
@@ -9462,7 +9546,7 @@ static void ksGpuCommandBuffer_UpdateProgramParms( const ksGpuProgramParmLayout
 		else if ( newLayout->parms[i].type == KS_GPU_PROGRAM_PARM_TYPE_BUFFER_STORAGE )
 		{
 			const ksGpuBuffer * buffer = (const ksGpuBuffer *)newParmState->parms[index];
-			assert( buffer->target == GL_SHADER_STORAGE_BUFFER );
+			assert( buffer->target == GL_SHADER_STORAGE_BUFFER || buffer->target == GL_DRAW_INDIRECT_BUFFER );
 			if ( force || buffer != oldStorageBuffers[binding] )
 			{
 				GL( glBindBufferBase( GL_SHADER_STORAGE_BUFFER, binding, buffer->buffer ) );
@@ -9527,7 +9611,16 @@ static void ksGpuCommandBuffer_SubmitGraphicsCommand( ksGpuCommandBuffer * comma
 	}
 
 	const GLenum indexType = ( sizeof( ksGpuTriangleIndex ) == sizeof( GLuint ) ) ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
-	if ( command->numInstances > 1 )
+	if ( command->indirectBuffer != NULL )
+	{
+		assert( command->indirectBuffer->target == GL_DRAW_INDIRECT_BUFFER );
+		assert( glExtensions.multi_draw_indirect );
+		GL( glBindBuffer( GL_DRAW_INDIRECT_BUFFER, command->indirectBuffer->buffer ) );
+		const GLintptr offset = command->indirectFirstDraw * sizeof( ksGpuDrawIndirectCommand );
+		GL( glMultiDrawElementsIndirect( GL_TRIANGLES, indexType, (const void *)offset, command->indirectDrawCount, sizeof( ksGpuDrawIndirectCommand ) ) );
+		GL( glBindBuffer( GL_DRAW_INDIRECT_BUFFER, 0 ) );
+	}
+	else if ( command->numInstances > 1 )
 	{
 		GL( glDrawElementsInstanced( GL_TRIANGLES, command->pipeline->geometry->indexCount, indexType, NULL, command->numInstances ) );
 	}
@@ -11991,9 +12084,13 @@ static void DumpGLSL()
 		{ "timeWarpChromaticFragmentProgram",		"frag",	timeWarpChromaticFragmentProgramGLSL },
 		{ "flatShadedVertexProgram",				"vert",	flatShadedVertexProgramGLSL },
 		{ "flatShadedMultiViewVertexProgram",		"vert",	flatShadedMultiViewVertexProgramGLSL },
+		{ "flatShadedInstancedVertexProgram",		"vert",	flatShadedInstancedVertexProgramGLSL },
+		{ "flatShadedInstancedMultiViewVertexProgram",	"vert",	flatShadedInstancedMultiViewVertexProgramGLSL },
 		{ "flatShadedFragmentProgram",				"frag",	flatShadedFragmentProgramGLSL },
 		{ "normalMappedVertexProgram",				"vert",	normalMappedVertexProgramGLSL },
 		{ "normalMappedMultiViewVertexProgram",		"vert",	normalMappedMultiViewVertexProgramGLSL },
+		{ "normalMappedInstancedVertexProgram",		"vert",	normalMappedInstancedVertexProgramGLSL },
+		{ "normalMappedInstancedMultiViewVertexProgram",	"vert",	normalMappedInstancedMultiViewVertexProgramGLSL },
 		{ "normalMapped100LightsFragmentProgram",	"frag",	normalMapped100LightsFragmentProgramGLSL },
 		{ "normalMapped1000LightsFragmentProgram",	"frag",	normalMapped1000LightsFragmentProgramGLSL },
 		{ "normalMapped2000LightsFragmentProgram",	"frag",	normalMapped2000LightsFragmentProgramGLSL },
@@ -12063,6 +12160,8 @@ typedef struct
 	int							triangleLevel;
 	int							fragmentLevel;
 	bool						useMultiView;
+	bool						useInstancing;
+	bool						useIndirect;
 	bool						correctChromaticAberration;
 	bool						hideGraphs;
 	ksTimeWarpImplementation	timeWarpImplementation;
@@ -12363,6 +12462,8 @@ bool RenderAsyncTimeWarp( ksStartupSettings * startupSettings )
 	ksSceneSettings_SetGltf( &sceneSettings, startupSettings->glTF );
 	ksSceneSettings_SetSimulationPaused( &sceneSettings, startupSettings->simulationPaused );
 	ksSceneSettings_SetMultiView( &sceneSettings, startupSettings->useMultiView );
+	ksSceneSettings_SetInstancing( &sceneSettings, startupSettings->useInstancing );
+	ksSceneSettings_SetIndirect( &sceneSettings, startupSettings->useIndirect );
 	ksSceneSettings_SetDisplayResolutionLevel( &sceneSettings, startupSettings->displayResolutionLevel );
 	ksSceneSettings_SetEyeImageResolutionLevel( &sceneSettings, startupSettings->eyeImageResolutionLevel );
 	ksSceneSettings_SetEyeImageSamplesLevel( &sceneSettings, startupSettings->eyeImageSamplesLevel );
@@ -12471,6 +12572,14 @@ bool RenderAsyncTimeWarp( ksStartupSettings * startupSettings )
 			ksSceneSettings_CycleFragmentLevel( &sceneSettings );
 			ksTimeWarp_SetFragmentLevel( &timeWarp, ksSceneSettings_GetFragmentLevel( &sceneSettings ) );
 		}
+		if ( ksGpuWindowInput_ConsumeKeyboardKey( &window.input, KEY_N ) )
+		{
+			ksSceneSettings_ToggleInstancing( &sceneSettings );
+		}
+		if ( ksGpuWindowInput_ConsumeKeyboardKey( &window.input, KEY_J ) )
+		{
+			ksSceneSettings_ToggleIndirect( &sceneSettings );
+		}
 		if ( ksGpuWindowInput_ConsumeKeyboardKey( &window.input, KEY_I ) )
 		{
 			ksTimeWarp_CycleImplementation( &timeWarp );
@@ -12697,6 +12806,8 @@ bool RenderScene( ksStartupSettings * startupSettings )
 	ksSceneSettings_Init( &window.context, &sceneSettings );
 	ksSceneSettings_SetGltf( &sceneSettings, startupSettings->glTF );
 	ksSceneSettings_SetSimulationPaused( &sceneSettings, startupSettings->simulationPaused );
+	ksSceneSettings_SetInstancing( &sceneSettings, startupSettings->useInstancing );
+	ksSceneSettings_SetIndirect( &sceneSettings, startupSettings->useIndirect );
 	ksSceneSettings_SetDisplayResolutionLevel( &sceneSettings, startupSettings->displayResolutionLevel );
 	ksSceneSettings_SetEyeImageResolutionLevel( &sceneSettings, startupSettings->eyeImageResolutionLevel );
 	ksSceneSettings_SetEyeImageSamplesLevel( &sceneSettings, startupSettings->eyeImageSamplesLevel );
@@ -12808,6 +12919,14 @@ bool RenderScene( ksStartupSettings * startupSettings )
 		{
 			ksSceneSettings_CycleFragmentLevel( &sceneSettings );
 		}
+		if ( ksGpuWindowInput_ConsumeKeyboardKey( &window.input, KEY_N ) )
+		{
+			ksSceneSettings_ToggleInstancing( &sceneSettings );
+		}
+		if ( ksGpuWindowInput_ConsumeKeyboardKey( &window.input, KEY_J ) )
+		{
+			ksSceneSettings_ToggleIndirect( &sceneSettings );
+		}
 		if ( ksGpuWindowInput_ConsumeKeyboardKey( &window.input, KEY_D ) )
 		{
 			DumpGLSL();
@@ -12939,6 +13058,8 @@ static int StartApplication( int argc, char * argv[] )
 		else if ( strcmp( arg, "w" ) == 0 && i + 1 < argc )	{ startupSettings.triangleLevel = ksStartupSettings_StringToLevel( argv[++i], MAX_SCENE_TRIANGLE_LEVELS ); }
 		else if ( strcmp( arg, "e" ) == 0 && i + 1 < argc )	{ startupSettings.fragmentLevel = ksStartupSettings_StringToLevel( argv[++i], MAX_SCENE_FRAGMENT_LEVELS ); }
 		else if ( strcmp( arg, "m" ) == 0 && i + 0 < argc )	{ startupSettings.useMultiView = ( atoi( argv[++i] ) != 0 ); }
+		else if ( strcmp( arg, "n" ) == 0 && i + 1 < argc )	{ startupSettings.useInstancing = ( atoi( argv[++i] ) != 0 ); }
+		else if ( strcmp( arg, "j" ) == 0 && i + 1 < argc )	{ startupSettings.useIndirect = ( atoi( argv[++i] ) != 0 ); }
 		else if ( strcmp( arg, "c" ) == 0 && i + 1 < argc )	{ startupSettings.correctChromaticAberration = ( atoi( argv[++i] ) != 0 ); }
 		else if ( strcmp( arg, "i" ) == 0 && i + 1 < argc )	{ startupSettings.timeWarpImplementation = (ksTimeWarpImplementation)ksStartupSettings_StringToTimeWarpImplementation( argv[++i] ); }
 		else if ( strcmp( arg, "z" ) == 0 && i + 1 < argc )	{ startupSettings.renderMode = ksStartupSettings_StringToRenderMode( argv[++i] ); }
@@ -12962,6 +13083,8 @@ static int StartApplication( int argc, char * argv[] )
 				   "   -w <0-3>    set per eye triangles per draw call level\n"
 				   "   -e <0-3>    set per eye fragment program complexity level\n"
 				   "   -m <0-1>    enable/disable multi-view\n"
+				   "   -n <0-1>    enable/disable instanced draw calls\n"
+				   "   -j <0-1>    enable/disable indirect draw calls\n"
 				   "   -c <0-1>    enable/disable correction for chromatic aberration\n"
 				   "   -i <name>   set time warp implementation: graphics, compute\n"
 				   "   -z <name>   set the render mode: atw, tw, scene\n"
@@ -12993,6 +13116,8 @@ static int StartApplication( int argc, char * argv[] )
 	Print( "    triangleLevel = %d\n",				startupSettings.triangleLevel );
 	Print( "    fragmentLevel = %d\n",				startupSettings.fragmentLevel );
 	Print( "    useMultiView = %d\n",				startupSettings.useMultiView );
+	Print( "    useInstancing = %d\n",				startupSettings.useInstancing );
+	Print( "    useIndirect = %d\n",				startupSettings.useIndirect );
 	Print( "    correctChromaticAberration = %d\n",	startupSettings.correctChromaticAberration );
 	Print( "    timeWarpImplementation = %d\n",		startupSettings.timeWarpImplementation );
 	Print( "    renderMode = %d\n",					startupSettings.renderMode );
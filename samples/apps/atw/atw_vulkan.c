@@ -186,6 +186,9 @@ The following command-line options can be used to change various settings.
 	-w <0-3>	set per eye triangles per draw call level
 	-e <0-3>	set per eye fragment program complexity level
 	-m <0-1>	enable/disable multi-view
+	-n <0-1>	enable/disable instanced draw calls
+	-j <0-1>	enable/disable indirect draw calls
+	-t <1-8>	set number of threads that record the scene
 	-c <0-1>	enable/disable correction for chromatic aberration
 	-i <name>	set time warp implementation: graphics, compute
 	-z <name>	set the render mode: atw, tw, scene
@@ -210,6 +213,8 @@ The following keys can be used at run-time to change various settings.
 	[W]		= cycle per eye triangles per draw call level
 	[E]		= cycle per eye fragment program complexity level
 	[M]		= toggle multi-view
+	[N]		= toggle instanced draw calls
+	[J]		= toggle indirect draw calls
 	[C]		= toggle correction for chromatic aberration
 	[I]		= toggle time warp implementation: graphics, compute
 	[Z]		= cycle the render mode: atw, tw, scene
@@ -592,6 +597,8 @@ Common headers
 #include <utils/sysinfo.h>
 #include <utils/nanoseconds.h>
 #include <utils/threading.h>
+
+#define KSALGEBRA_SIMD		1		// SSE matrix multiply, built with -ffp-contract=off so the results match the scalar code
 #include <utils/algebra.h>
 
 /*
@@ -620,6 +627,7 @@ Common defines
 #define USE_VALIDATION					0
 #define USE_SPIRV						1
 #define USE_PM_MULTIVIEW				1
+#define USE_TRANSFER_QUEUE				1	// upload through a dedicated transfer queue family when the device has one
 #define USE_API_DUMP					0	// place vk_layer_settings.txt in the executable folder and change APIDumpFile = TRUE
 
 #define ICD_SPV_MAGIC					0x07230203
@@ -1437,6 +1445,20 @@ static void ksDriverInstance_Destroy( ksDriverInstance * instance )
 /*
 ================================================================================================================================
 
+GPU memory allocator.
+
+Buffers and images are sub-allocated from large device memory blocks with a buddy system.
+The allocator only calls the driver through the block callbacks so it lives in a separate
+header that is also unit tested without a GPU.
+
+================================================================================================================================
+*/
+
+#include "gpu/gpu_memory_allocator.h"
+
+/*
+================================================================================================================================
+
 GPU device.
 
 ksGpuQueueProperty
@@ -1493,10 +1515,14 @@ typedef struct
 	ksMutex									queueFamilyMutex;
 	int										workQueueFamilyIndex;
 	int										presentQueueFamilyIndex;
+	int										transferQueueFamilyIndex;		// -1 if there is no dedicated transfer queue family
 
 	// The logical device.
 	VkDevice								device;
 
+	// Sub-allocator for buffer and image memory.
+	ksGpuMemoryAllocator					memoryAllocator;
+
 	// Device functions.
 	PFN_vkDestroyDevice						vkDestroyDevice;
 	PFN_vkGetDeviceQueue					vkGetDeviceQueue;
@@ -1745,8 +1771,25 @@ static bool ksGpuDevice_SelectPhysicalDevice( ksGpuDevice * device, ksDriverInst
 			continue;
 		}
 
+		// Use a queue family that only supports transfers for uploads when there is one.
+		int transferQueueFamilyIndex = -1;
+#if USE_TRANSFER_QUEUE == 1
+		for ( uint32_t queueFamilyIndex = 0; queueFamilyIndex < queueFamilyCount; queueFamilyIndex++ )
+		{
+			const VkQueueFlags queueFlags = queueFamilyProperties[queueFamilyIndex].queueFlags;
+			if ( ( queueFlags & VK_QUEUE_TRANSFER_BIT ) != 0 && ( queueFlags & ( VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT ) ) == 0 &&
+					(int)queueFamilyIndex != workQueueFamilyIndex && (int)queueFamilyIndex != presentQueueFamilyIndex &&
+						queueFamilyProperties[queueFamilyIndex].queueCount > 0 )
+			{
+				transferQueueFamilyIndex = queueFamilyIndex;
+				break;
+			}
+		}
+#endif
+
 		Print( "Work Queue Family    : %d\n", workQueueFamilyIndex );
 		Print( "Present Queue Family : %d\n", presentQueueFamilyIndex );
+		Print( "Transfer Queue Family: %d\n", transferQueueFamilyIndex );
 
 		const ksDriverFeature requestedExtensions[] =
 		{
@@ -1825,6 +1868,7 @@ static bool ksGpuDevice_SelectPhysicalDevice( ksGpuDevice * device, ksDriverInst
 		device->queueFamilyProperties = queueFamilyProperties;
 		device->workQueueFamilyIndex = workQueueFamilyIndex;
 		device->presentQueueFamilyIndex = presentQueueFamilyIndex;
+		device->transferQueueFamilyIndex = transferQueueFamilyIndex;
 
 		VC( instance->vkGetPhysicalDeviceFeatures( physicalDevices[physicalDeviceIndex], &device->physicalDeviceFeatures ) );
 		VC( instance->vkGetPhysicalDeviceProperties( physicalDevices[physicalDeviceIndex], &device->physicalDeviceProperties ) );
@@ -1853,6 +1897,35 @@ static bool ksGpuDevice_SelectPhysicalDevice( ksGpuDevice * device, ksDriverInst
 	return true;
 }
 
+static bool ksGpuDevice_AllocateMemoryBlock( void * userData, const uint32_t memoryTypeIndex, const VkDeviceSize size, const bool map,
+											VkDeviceMemory * memory, void ** mapped )
+{
+	ksGpuDevice * device = (ksGpuDevice *)userData;
+
+	VkMemoryAllocateInfo memoryAllocateInfo;
+	memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	memoryAllocateInfo.pNext = NULL;
+	memoryAllocateInfo.allocationSize = size;
+	memoryAllocateInfo.memoryTypeIndex = memoryTypeIndex;
+
+	VK( device->vkAllocateMemory( device->device, &memoryAllocateInfo, VK_ALLOCATOR, memory ) );
+
+	*mapped = NULL;
+	if ( map )
+	{
+		VK( device->vkMapMemory( device->device, *memory, 0, VK_WHOLE_SIZE, 0, mapped ) );
+	}
+	return true;
+}
+
+static void ksGpuDevice_FreeMemoryBlock( void * userData, VkDeviceMemory memory )
+{
+	ksGpuDevice * device = (ksGpuDevice *)userData;
+
+	// Freeing the memory implicitly unmaps it.
+	VC( device->vkFreeMemory( device->device, memory, VK_ALLOCATOR ) );
+}
+
 static bool ksGpuDevice_Create( ksGpuDevice * device, ksDriverInstance * instance, const ksGpuQueueInfo * queueInfo )
 {
 	//
@@ -1872,7 +1945,7 @@ static bool ksGpuDevice_Create( ksGpuDevice * device, ksDriverInstance * instanc
 	}
 
 	// Create the device.
-	VkDeviceQueueCreateInfo deviceQueueCreateInfo[2];
+	VkDeviceQueueCreateInfo deviceQueueCreateInfo[3];
 	deviceQueueCreateInfo[0].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
 	deviceQueueCreateInfo[0].pNext = NULL;
 	deviceQueueCreateInfo[0].flags = 0;
@@ -1887,17 +1960,42 @@ static bool ksGpuDevice_Create( ksGpuDevice * device, ksDriverInstance * instanc
 	deviceQueueCreateInfo[1].queueCount = 1;
 	deviceQueueCreateInfo[1].pQueuePriorities = NULL;
 
+	uint32_t queueCreateInfoCount = 1 + ( device->presentQueueFamilyIndex != -1 && device->presentQueueFamilyIndex != device->workQueueFamilyIndex );
+
+	// Create one transfer queue per work queue, as far as the transfer queue family allows.
+	if ( device->transferQueueFamilyIndex != -1 )
+	{
+		const int transferQueueCount = MIN( (int)device->queueFamilyProperties[device->transferQueueFamilyIndex].queueCount, queueInfo->queueCount );
+
+		deviceQueueCreateInfo[queueCreateInfoCount].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+		deviceQueueCreateInfo[queueCreateInfoCount].pNext = NULL;
+		deviceQueueCreateInfo[queueCreateInfoCount].flags = 0;
+		deviceQueueCreateInfo[queueCreateInfoCount].queueFamilyIndex = device->transferQueueFamilyIndex;
+		deviceQueueCreateInfo[queueCreateInfoCount].queueCount = transferQueueCount;
+		deviceQueueCreateInfo[queueCreateInfoCount].pQueuePriorities = floatPriorities;
+		queueCreateInfoCount++;
+
+		// Only the created queues are available.
+		device->queueFamilyUsedQueues[device->transferQueueFamilyIndex] = 0xFFFFFFFF << transferQueueCount;
+	}
+
+	// Enable the optional features that are used when available.
+	VkPhysicalDeviceFeatures enabledFeatures;
+	memset( &enabledFeatures, 0, sizeof( enabledFeatures ) );
+	enabledFeatures.multiDrawIndirect = device->physicalDeviceFeatures.multiDrawIndirect;
+	enabledFeatures.drawIndirectFirstInstance = device->physicalDeviceFeatures.drawIndirectFirstInstance;
+
 	VkDeviceCreateInfo deviceCreateInfo;
 	deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
 	deviceCreateInfo.pNext = NULL;
 	deviceCreateInfo.flags = 0;
-	deviceCreateInfo.queueCreateInfoCount = 1 + ( device->presentQueueFamilyIndex != -1 && device->presentQueueFamilyIndex != device->workQueueFamilyIndex );
+	deviceCreateInfo.queueCreateInfoCount = queueCreateInfoCount;
 	deviceCreateInfo.pQueueCreateInfos = deviceQueueCreateInfo;
 	deviceCreateInfo.enabledLayerCount = device->enabledLayerCount;
 	deviceCreateInfo.ppEnabledLayerNames = (const char * const *) ( device->enabledLayerCount != 0 ? device->enabledLayerNames : NULL );
 	deviceCreateInfo.enabledExtensionCount = device->enabledExtensionCount;
 	deviceCreateInfo.ppEnabledExtensionNames = (const char * const *) ( device->enabledExtensionCount != 0 ? device->enabledExtensionNames : NULL );
-	deviceCreateInfo.pEnabledFeatures = NULL;
+	deviceCreateInfo.pEnabledFeatures = &enabledFeatures;
 
 	VK( instance->vkCreateDevice( device->physicalDevice, &deviceCreateInfo, VK_ALLOCATOR, &device->device ) );
 
@@ -2046,6 +2144,15 @@ static bool ksGpuDevice_Create( ksGpuDevice * device, ksDriverInstance * instanc
 		GET_DEVICE_PROC_ADDR( vkAcquireNextImageKHR );
 		GET_DEVICE_PROC_ADDR( vkQueuePresentKHR );
 	}
+
+	ksGpuMemoryBlockCallbacks memoryBlockCallbacks;
+	memoryBlockCallbacks.userData = device;
+	memoryBlockCallbacks.allocateBlock = ksGpuDevice_AllocateMemoryBlock;
+	memoryBlockCallbacks.freeBlock = ksGpuDevice_FreeMemoryBlock;
+
+	ksGpuMemoryAllocator_Create( &device->memoryAllocator, &device->physicalDeviceMemoryProperties,
+								device->physicalDeviceProperties.limits.bufferImageGranularity, &memoryBlockCallbacks );
+
 	return true;
 }
 
@@ -2058,27 +2165,10 @@ static void ksGpuDevice_Destroy( ksGpuDevice * device )
 
 	ksMutex_Destroy( &device->queueFamilyMutex );
 
-	VC( device->vkDestroyDevice( device->device, VK_ALLOCATOR ) );
-}
+	ksGpuMemoryAllocator_PrintStats( &device->memoryAllocator );
+	ksGpuMemoryAllocator_Destroy( &device->memoryAllocator );
 
-static uint32_t ksGpuDevice_GetMemoryTypeIndex( ksGpuDevice * device, const uint32_t typeBits,
-											const VkMemoryPropertyFlags requiredProperties )
-{
-	// Search memory types to find the index with the requested properties.
-	for ( uint32_t type = 0; type < device->physicalDeviceMemoryProperties.memoryTypeCount; type++ )
-	{
-		if ( ( typeBits & ( 1 << type ) ) != 0 )
-		{
-			// Test if this memory type has the required properties.
-			const VkFlags propertyFlags = device->physicalDeviceMemoryProperties.memoryTypes[type].propertyFlags;
-			if ( ( propertyFlags & requiredProperties ) == requiredProperties )
-			{
-				return type;
-			}
-		}
-	}
-	Error( "Memory type %d with properties %d not found.", typeBits, requiredProperties );
-	return 0;
+	VC( device->vkDestroyDevice( device->device, VK_ALLOCATOR ) );
 }
 
 static void ksGpuDevice_CreateShader( ksGpuDevice * device, VkShaderModule * shaderModule,
@@ -2141,6 +2231,44 @@ static void ksGpuContext_GetLimits( ksGpuContext * context, ksGpuLimits * limits
 
 static bool ksGpuContext_Create( ksGpuContext * context, ksGpuDevice * device, const int queueIndex );
 
+Resource setup work (uploads and layout transitions) is recorded into a setup command buffer.
+Setup work from many resources is batched into a single submission that is only flushed
+when the context submits other work, when it waits for idle, or when the batch holds more
+than MAX_SETUP_STAGING_SIZE bytes of staging memory. Completion of a batch is tracked with
+a fence and the staging memory is released once the fence has signaled, so the queue is
+never drained just to create a resource.
+
+Upload data is staged in a persistently mapped ring buffer that is shared by all batches
+of a context. Space is handed out in order and wraps around at the end of the ring. The
+space used by a batch is reclaimed when its fence signals. Uploads should be split into
+chunks of at most MAX_SETUP_STAGING_SIZE bytes. Anything larger gets a staging buffer
+of its own that is released with the batch. A loader can decode straight into the memory
+returned by ksGpuContext_AllocateStaging. When that memory is passed as the data of the
+next buffer or texture that is created, it is copied to the resource without another copy
+through the CPU.
+
+When the device has a dedicated transfer queue family, the staging copies of a batch are
+recorded into the upload command buffer that is submitted to a transfer queue, and the
+setup command buffer waits for it with a semaphore. Buffers and images are created with
+exclusive sharing, so after its copies the ownership of a resource is released by the
+transfer queue family and acquired by the work queue family. Layout transitions, mip map
+generation and other setup work stay on the work queue. Without a transfer queue, the
+upload command buffer is the setup command buffer and the acquire calls do nothing.
+The transfer queue path has only been run on a device with a single queue family, where
+it takes this fallback, and it has not been checked with the validation layers.
+Completion is tracked with a fence per batch instead of a timeline semaphore, because
+timeline semaphores need Vulkan 1.2 or VK_KHR_timeline_semaphore, which are newer than
+the Vulkan headers this code is written against.
+
+static void ksGpuContext_CreateSetupCmdBuffer( ksGpuContext * context );
+static void * ksGpuContext_AllocateStaging( ksGpuContext * context, const VkDeviceSize size, VkBuffer * buffer, VkDeviceSize * offset );
+static bool ksGpuContext_GetStaging( ksGpuContext * context, const void * data, const VkDeviceSize size, VkBuffer * buffer, VkDeviceSize * offset );
+static void ksGpuContext_AcquireUploadBuffer( ksGpuContext * context, const VkBuffer buffer, const VkDeviceSize size );
+static void ksGpuContext_AcquireUploadImage( ksGpuContext * context, const VkImage image, const VkImageSubresourceRange * range );
+static void ksGpuContext_DeferSetupCmdBuffer( ksGpuContext * context );
+static void ksGpuContext_FlushSetupCmdBuffer( ksGpuContext * context );
+static void ksGpuContext_WaitSetupCmdBuffers( ksGpuContext * context );
+
 ================================================================================================================================
 */
 
@@ -2176,8 +2304,41 @@ typedef struct ksGpuLimits
 {
 	size_t					maxPushConstantsSize;
 	int						maxSamples;
+	bool					drawIndirect;
 } ksGpuLimits;
 
+#define MAX_SETUP_BATCHES			4
+#define MAX_SETUP_STAGING_SIZE		( 8 * 1024 * 1024 )
+#define STAGING_RING_SIZE			( 32 * 1024 * 1024 )	// a load may stage more, allocation then waits for the oldest batch
+#define STAGING_RING_ALIGNMENT		256		// multiple of any texel block size and of nonCoherentAtomSize
+
+typedef struct
+{
+	VkBuffer				buffer;
+	ksGpuMemoryAllocation	allocation;
+} ksGpuStagingBuffer;
+
+/*
+Staging memory for small uploads is sub-allocated from a persistently mapped ring buffer.
+The ring does not call the driver so it lives in a separate header that is also unit tested
+without a GPU.
+*/
+
+#include "gpu/gpu_staging_ring.h"
+
+typedef struct
+{
+	VkCommandBuffer			commandBuffer;
+	VkCommandBuffer			transferCommandBuffer;	// staging copies on the transfer queue, or VK_NULL_HANDLE
+	VkSemaphore				transferSemaphore;		// signaled by the transfer submission and waited for by the setup submission
+	VkFence					fence;
+	bool					submitted;
+	VkDeviceSize			stagingRingMark;
+	ksGpuStagingBuffer *	stagingBuffers;
+	int						stagingBufferCount;
+	int						stagingBufferCapacity;
+} ksGpuSetupBatch;
+
 typedef struct
 {
 	ksGpuDevice *	device;
@@ -2186,7 +2347,17 @@ typedef struct
 	VkQueue			queue;
 	VkCommandPool	commandPool;
 	VkPipelineCache	pipelineCache;
-	VkCommandBuffer	setupCommandBuffer;
+	uint32_t		transferQueueIndex;
+	VkQueue			transferQueue;			// dedicated transfer queue, or VK_NULL_HANDLE
+	VkCommandPool	transferCommandPool;
+	VkCommandBuffer	setupCommandBuffer;		// command buffer of the setup batch that is being recorded
+	VkCommandBuffer	uploadCommandBuffer;	// command buffer that the staging copies of the setup batch are recorded into
+	ksGpuSetupBatch	setupBatches[MAX_SETUP_BATCHES];
+	int				setupBatchIndex;		// the batch that is being recorded or the oldest batch in flight
+	VkDeviceSize	setupStagingSize;
+	ksGpuStagingRing		stagingRing;
+	VkBuffer				stagingRingBuffer;
+	ksGpuMemoryAllocation	stagingRingAllocation;
 } ksGpuContext;
 
 static bool ksGpuContext_Create( ksGpuContext * context, ksGpuDevice * device, const int queueIndex )
@@ -2221,6 +2392,52 @@ static bool ksGpuContext_Create( ksGpuContext * context, ksGpuDevice * device, c
 
 	VK( device->vkCreatePipelineCache( device->device, &pipelineCacheCreateInfo, VK_ALLOCATOR, &context->pipelineCache ) );
 
+	VkFenceCreateInfo fenceCreateInfo;
+	fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	fenceCreateInfo.pNext = NULL;
+	fenceCreateInfo.flags = 0;
+
+	for ( int i = 0; i < MAX_SETUP_BATCHES; i++ )
+	{
+		VK( device->vkCreateFence( device->device, &fenceCreateInfo, VK_ALLOCATOR, &context->setupBatches[i].fence ) );
+	}
+
+	// Claim a transfer queue. If they are all taken, the uploads of this context go through the work queue.
+	if ( device->transferQueueFamilyIndex != -1 )
+	{
+		bool foundTransferQueue = false;
+		ksMutex_Lock( &device->queueFamilyMutex, true );
+		for ( int i = 0; i < 32 && !foundTransferQueue; i++ )
+		{
+			if ( ( device->queueFamilyUsedQueues[device->transferQueueFamilyIndex] & ( 1 << i ) ) == 0 )
+			{
+				device->queueFamilyUsedQueues[device->transferQueueFamilyIndex] |= ( 1 << i );
+				context->transferQueueIndex = i;
+				foundTransferQueue = true;
+			}
+		}
+		ksMutex_Unlock( &device->queueFamilyMutex );
+
+		if ( foundTransferQueue )
+		{
+			VC( device->vkGetDeviceQueue( device->device, device->transferQueueFamilyIndex, context->transferQueueIndex, &context->transferQueue ) );
+
+			commandPoolCreateInfo.queueFamilyIndex = device->transferQueueFamilyIndex;
+
+			VK( device->vkCreateCommandPool( device->device, &commandPoolCreateInfo, VK_ALLOCATOR, &context->transferCommandPool ) );
+
+			VkSemaphoreCreateInfo semaphoreCreateInfo;
+			semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+			semaphoreCreateInfo.pNext = NULL;
+			semaphoreCreateInfo.flags = 0;
+
+			for ( int i = 0; i < MAX_SETUP_BATCHES; i++ )
+			{
+				VK( device->vkCreateSemaphore( device->device, &semaphoreCreateInfo, VK_ALLOCATOR, &context->setupBatches[i].transferSemaphore ) );
+			}
+		}
+	}
+
 	return true;
 }
 
@@ -2229,45 +2446,30 @@ static bool ksGpuContext_CreateShared( ksGpuContext * context, const ksGpuContex
 	return ksGpuContext_Create( context, other->device, queueIndex );
 }
 
-static void ksGpuContext_Destroy( ksGpuContext * context )
+static void ksGpuContext_ReleaseSetupBatch( ksGpuContext * context, ksGpuSetupBatch * batch )
 {
-	if ( context->device == NULL )
+	ksGpuStagingRing_Release( &context->stagingRing, batch->stagingRingMark );
+
+	for ( int i = 0; i < batch->stagingBufferCount; i++ )
 	{
-		return;
+		VC( context->device->vkDestroyBuffer( context->device->device, batch->stagingBuffers[i].buffer, VK_ALLOCATOR ) );
+		ksGpuMemoryAllocator_Free( &context->device->memoryAllocator, &batch->stagingBuffers[i].allocation );
 	}
+	batch->stagingBufferCount = 0;
 
-	// Mark the queue as no longer in use.
-	ksMutex_Lock( &context->device->queueFamilyMutex, true );
-	assert( ( context->device->queueFamilyUsedQueues[context->queueFamilyIndex] & ( 1 << context->queueIndex ) ) != 0 );
-	context->device->queueFamilyUsedQueues[context->queueFamilyIndex] &= ~( 1 << context->queueIndex );
-	ksMutex_Unlock( &context->device->queueFamilyMutex );
+	VC( context->device->vkFreeCommandBuffers( context->device->device, context->commandPool, 1, &batch->commandBuffer ) );
+	batch->commandBuffer = VK_NULL_HANDLE;
 
-	if ( context->setupCommandBuffer )
+	if ( batch->transferCommandBuffer != VK_NULL_HANDLE )
 	{
-		VC( context->device->vkFreeCommandBuffers( context->device->device, context->commandPool, 1, &context->setupCommandBuffer ) );
+		VC( context->device->vkFreeCommandBuffers( context->device->device, context->transferCommandPool, 1, &batch->transferCommandBuffer ) );
+		batch->transferCommandBuffer = VK_NULL_HANDLE;
 	}
-	VC( context->device->vkDestroyCommandPool( context->device->device, context->commandPool, VK_ALLOCATOR ) );
-	VC( context->device->vkDestroyPipelineCache( context->device->device, context->pipelineCache, VK_ALLOCATOR ) );
-}
-
-static void ksGpuContext_WaitIdle( ksGpuContext * context )
-{
-	VK( context->device->vkQueueWaitIdle( context->queue ) );
-}
 
-static void ksGpuContext_GetLimits( ksGpuContext * context, ksGpuLimits * limits )
-{
-	limits->maxPushConstantsSize = context->device->physicalDeviceProperties.limits.maxPushConstantsSize;
-	const VkSampleCountFlags availableSampleCounts = context->device->physicalDeviceProperties.limits.framebufferColorSampleCounts &
-														context->device->physicalDeviceProperties.limits.framebufferDepthSampleCounts;
-	limits->maxSamples = 0;
-	for ( int bit = VK_SAMPLE_COUNT_1_BIT; bit <= VK_SAMPLE_COUNT_64_BIT; bit <<= 1 )
+	if ( batch->submitted )
 	{
-		if ( ( availableSampleCounts & bit ) == 0 )
-		{
-			break;
-		}
-		limits->maxSamples = bit;
+		VK( context->device->vkResetFences( context->device->device, 1, &batch->fence ) );
+		batch->submitted = false;
 	}
 }
 
@@ -2278,6 +2480,29 @@ static void ksGpuContext_CreateSetupCmdBuffer( ksGpuContext * context )
 		return;
 	}
 
+	// Release the staging memory of the batches that have completed, oldest first.
+	for ( int i = 0; i < MAX_SETUP_BATCHES; i++ )
+	{
+		ksGpuSetupBatch * batch = &context->setupBatches[( context->setupBatchIndex + i ) % MAX_SETUP_BATCHES];
+		if ( batch->submitted )
+		{
+			VC( VkResult res = context->device->vkGetFenceStatus( context->device->device, batch->fence ) );
+			if ( res != VK_SUCCESS )
+			{
+				break;
+			}
+			ksGpuContext_ReleaseSetupBatch( context, batch );
+		}
+	}
+
+	// Only wait if the oldest batch is still in flight.
+	ksGpuSetupBatch * batch = &context->setupBatches[context->setupBatchIndex];
+	if ( batch->submitted )
+	{
+		VK( context->device->vkWaitForFences( context->device->device, 1, &batch->fence, VK_TRUE, UINT64_MAX ) );
+		ksGpuContext_ReleaseSetupBatch( context, batch );
+	}
+
 	VkCommandBufferAllocateInfo commandBufferAllocateInfo;
 	commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
 	commandBufferAllocateInfo.pNext = NULL;
@@ -2285,7 +2510,7 @@ static void ksGpuContext_CreateSetupCmdBuffer( ksGpuContext * context )
 	commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
 	commandBufferAllocateInfo.commandBufferCount = 1;
 
-	VK( context->device->vkAllocateCommandBuffers( context->device->device, &commandBufferAllocateInfo, &context->setupCommandBuffer ) );
+	VK( context->device->vkAllocateCommandBuffers( context->device->device, &commandBufferAllocateInfo, &batch->commandBuffer ) );
 
 	VkCommandBufferBeginInfo commandBufferBeginInfo;
 	commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -2293,7 +2518,19 @@ static void ksGpuContext_CreateSetupCmdBuffer( ksGpuContext * context )
 	commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 	commandBufferBeginInfo.pInheritanceInfo = NULL;
 
-	VK( context->device->vkBeginCommandBuffer( context->setupCommandBuffer, &commandBufferBeginInfo ) );
+	VK( context->device->vkBeginCommandBuffer( batch->commandBuffer, &commandBufferBeginInfo ) );
+
+	if ( context->transferQueue != VK_NULL_HANDLE )
+	{
+		commandBufferAllocateInfo.commandPool = context->transferCommandPool;
+
+		VK( context->device->vkAllocateCommandBuffers( context->device->device, &commandBufferAllocateInfo, &batch->transferCommandBuffer ) );
+		VK( context->device->vkBeginCommandBuffer( batch->transferCommandBuffer, &commandBufferBeginInfo ) );
+	}
+
+	context->setupCommandBuffer = batch->commandBuffer;
+	context->uploadCommandBuffer = ( batch->transferCommandBuffer != VK_NULL_HANDLE ) ? batch->transferCommandBuffer : batch->commandBuffer;
+	context->setupStagingSize = 0;
 }
 
 static void ksGpuContext_FlushSetupCmdBuffer( ksGpuContext * context )
@@ -2303,24 +2540,321 @@ static void ksGpuContext_FlushSetupCmdBuffer( ksGpuContext * context )
         return;
 	}
 
-	VK( context->device->vkEndCommandBuffer( context->setupCommandBuffer ) );
+	ksGpuSetupBatch * batch = &context->setupBatches[context->setupBatchIndex];
+
+	// The staging copies on the transfer queue are submitted first and the setup work waits for them.
+	if ( batch->transferCommandBuffer != VK_NULL_HANDLE )
+	{
+		VK( context->device->vkEndCommandBuffer( batch->transferCommandBuffer ) );
+
+		VkSubmitInfo transferSubmitInfo;
+		transferSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		transferSubmitInfo.pNext = NULL;
+		transferSubmitInfo.waitSemaphoreCount = 0;
+		transferSubmitInfo.pWaitSemaphores = NULL;
+		transferSubmitInfo.pWaitDstStageMask = NULL;
+		transferSubmitInfo.commandBufferCount = 1;
+		transferSubmitInfo.pCommandBuffers = &batch->transferCommandBuffer;
+		transferSubmitInfo.signalSemaphoreCount = 1;
+		transferSubmitInfo.pSignalSemaphores = &batch->transferSemaphore;
+
+		VK( context->device->vkQueueSubmit( context->transferQueue, 1, &transferSubmitInfo, VK_NULL_HANDLE ) );
+	}
+
+	VK( context->device->vkEndCommandBuffer( batch->commandBuffer ) );
+
+	const VkPipelineStageFlags waitDstStageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
 
 	VkSubmitInfo submitInfo;
 	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 	submitInfo.pNext = NULL;
-	submitInfo.waitSemaphoreCount = 0;
-	submitInfo.pWaitSemaphores = NULL;
-	submitInfo.pWaitDstStageMask = NULL;
+	submitInfo.waitSemaphoreCount = ( batch->transferCommandBuffer != VK_NULL_HANDLE ) ? 1 : 0;
+	submitInfo.pWaitSemaphores = ( batch->transferCommandBuffer != VK_NULL_HANDLE ) ? &batch->transferSemaphore : NULL;
+	submitInfo.pWaitDstStageMask = ( batch->transferCommandBuffer != VK_NULL_HANDLE ) ? &waitDstStageMask : NULL;
 	submitInfo.commandBufferCount = 1;
-	submitInfo.pCommandBuffers = &context->setupCommandBuffer;
+	submitInfo.pCommandBuffers = &batch->commandBuffer;
 	submitInfo.signalSemaphoreCount = 0;
 	submitInfo.pSignalSemaphores = NULL;
 
-	VK( context->device->vkQueueSubmit( context->queue, 1, &submitInfo, VK_NULL_HANDLE ) );
-	VK( context->device->vkQueueWaitIdle( context->queue ) );
+	VK( context->device->vkQueueSubmit( context->queue, 1, &submitInfo, batch->fence ) );
+	batch->submitted = true;
+	batch->stagingRingMark = ksGpuStagingRing_GetMark( &context->stagingRing );
 
-	VC( context->device->vkFreeCommandBuffers( context->device->device, context->commandPool, 1, &context->setupCommandBuffer ) );
 	context->setupCommandBuffer = VK_NULL_HANDLE;
+	context->uploadCommandBuffer = VK_NULL_HANDLE;
+	context->setupBatchIndex = ( context->setupBatchIndex + 1 ) % MAX_SETUP_BATCHES;
+}
+
+static VkBuffer ksGpuContext_CreateStagingBuffer( ksGpuContext * context, const VkDeviceSize size, ksGpuMemoryAllocation * allocation )
+{
+	VkBufferCreateInfo stagingBufferCreateInfo;
+	stagingBufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	stagingBufferCreateInfo.pNext = NULL;
+	stagingBufferCreateInfo.flags = 0;
+	stagingBufferCreateInfo.size = size;
+	stagingBufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	stagingBufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	stagingBufferCreateInfo.queueFamilyIndexCount = 0;
+	stagingBufferCreateInfo.pQueueFamilyIndices = NULL;
+
+	VkBuffer stagingBuffer;
+	VK( context->device->vkCreateBuffer( context->device->device, &stagingBufferCreateInfo, VK_ALLOCATOR, &stagingBuffer ) );
+
+	VkMemoryRequirements stagingMemoryRequirements;
+	VC( context->device->vkGetBufferMemoryRequirements( context->device->device, stagingBuffer, &stagingMemoryRequirements ) );
+
+	// Coherent memory is always available for host visible memory and the writes do not need to be flushed.
+	ksGpuMemoryAllocator_Allocate( &context->device->memoryAllocator, allocation, &stagingMemoryRequirements,
+									VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, false );
+
+	VK( context->device->vkBindBufferMemory( context->device->device, stagingBuffer, allocation->memory, allocation->offset ) );
+
+	return stagingBuffer;
+}
+
+// Returns mapped staging memory for an upload that is recorded into the current setup batch.
+static void * ksGpuContext_AllocateStaging( ksGpuContext * context, const VkDeviceSize size, VkBuffer * buffer, VkDeviceSize * offset )
+{
+	if ( size > MAX_SETUP_STAGING_SIZE )
+	{
+		ksGpuContext_CreateSetupCmdBuffer( context );
+
+		ksGpuSetupBatch * batch = &context->setupBatches[context->setupBatchIndex];
+		if ( batch->stagingBufferCount >= batch->stagingBufferCapacity )
+		{
+			batch->stagingBufferCapacity = ( batch->stagingBufferCapacity > 0 ) ? batch->stagingBufferCapacity * 2 : 16;
+			batch->stagingBuffers = (ksGpuStagingBuffer *) realloc( batch->stagingBuffers, batch->stagingBufferCapacity * sizeof( ksGpuStagingBuffer ) );
+		}
+		ksGpuStagingBuffer * stagingBuffer = &batch->stagingBuffers[batch->stagingBufferCount++];
+		stagingBuffer->buffer = ksGpuContext_CreateStagingBuffer( context, size, &stagingBuffer->allocation );
+
+		context->setupStagingSize += size;
+
+		*buffer = stagingBuffer->buffer;
+		*offset = 0;
+		return stagingBuffer->allocation.mapped;
+	}
+
+	if ( context->stagingRingBuffer == VK_NULL_HANDLE )
+	{
+		ksGpuStagingRing_Init( &context->stagingRing, STAGING_RING_SIZE );
+		context->stagingRingBuffer = ksGpuContext_CreateStagingBuffer( context, STAGING_RING_SIZE, &context->stagingRingAllocation );
+	}
+
+	while ( !ksGpuStagingRing_Allocate( &context->stagingRing, size, STAGING_RING_ALIGNMENT, offset ) )
+	{
+		// Make room by submitting the current batch and waiting for the oldest batch in flight.
+		ksGpuContext_FlushSetupCmdBuffer( context );
+
+		bool waited = false;
+		for ( int i = 0; i < MAX_SETUP_BATCHES && !waited; i++ )
+		{
+			ksGpuSetupBatch * batch = &context->setupBatches[( context->setupBatchIndex + i ) % MAX_SETUP_BATCHES];
+			if ( batch->submitted )
+			{
+				VK( context->device->vkWaitForFences( context->device->device, 1, &batch->fence, VK_TRUE, UINT64_MAX ) );
+				ksGpuContext_ReleaseSetupBatch( context, batch );
+				waited = true;
+			}
+		}
+		assert( waited );
+	}
+
+	ksGpuContext_CreateSetupCmdBuffer( context );
+
+	context->setupStagingSize += size;
+
+	*buffer = context->stagingRingBuffer;
+	return (uint8_t *)context->stagingRingAllocation.mapped + *offset;
+}
+
+// Returns the staging buffer and offset of data that was decoded straight into memory
+// returned by ksGpuContext_AllocateStaging for the setup batch that is being recorded.
+static bool ksGpuContext_GetStaging( ksGpuContext * context, const void * data, const VkDeviceSize size, VkBuffer * buffer, VkDeviceSize * offset )
+{
+	if ( context->setupCommandBuffer == VK_NULL_HANDLE )
+	{
+		return false;
+	}
+
+	const uint8_t * bytes = (const uint8_t *)data;
+	if ( context->stagingRingBuffer != VK_NULL_HANDLE )
+	{
+		const uint8_t * ring = (const uint8_t *)context->stagingRingAllocation.mapped;
+		if ( bytes >= ring && bytes + size <= ring + STAGING_RING_SIZE )
+		{
+			*buffer = context->stagingRingBuffer;
+			*offset = bytes - ring;
+			return true;
+		}
+	}
+
+	const ksGpuSetupBatch * batch = &context->setupBatches[context->setupBatchIndex];
+	for ( int i = 0; i < batch->stagingBufferCount; i++ )
+	{
+		const uint8_t * mapped = (const uint8_t *)batch->stagingBuffers[i].allocation.mapped;
+		if ( bytes >= mapped && bytes + size <= mapped + batch->stagingBuffers[i].allocation.requestedSize )
+		{
+			*buffer = batch->stagingBuffers[i].buffer;
+			*offset = bytes - mapped;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Hands a buffer that was written by staging copies from the transfer queue family to the work queue family.
+static void ksGpuContext_AcquireUploadBuffer( ksGpuContext * context, const VkBuffer buffer, const VkDeviceSize size )
+{
+	if ( context->transferQueue == VK_NULL_HANDLE )
+	{
+		return;
+	}
+
+	VkBufferMemoryBarrier bufferMemoryBarrier;
+	bufferMemoryBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	bufferMemoryBarrier.pNext = NULL;
+	bufferMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	bufferMemoryBarrier.dstAccessMask = 0;
+	bufferMemoryBarrier.srcQueueFamilyIndex = context->device->transferQueueFamilyIndex;
+	bufferMemoryBarrier.dstQueueFamilyIndex = context->queueFamilyIndex;
+	bufferMemoryBarrier.buffer = buffer;
+	bufferMemoryBarrier.offset = 0;
+	bufferMemoryBarrier.size = size;
+
+	// Release on the transfer queue.
+	VC( context->device->vkCmdPipelineBarrier( context->uploadCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+												0, 0, NULL, 1, &bufferMemoryBarrier, 0, NULL ) );
+
+	// Acquire on the work queue after the semaphore wait, as if the copies were recorded here.
+	bufferMemoryBarrier.srcAccessMask = 0;
+	bufferMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+	VC( context->device->vkCmdPipelineBarrier( context->setupCommandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+												0, 0, NULL, 1, &bufferMemoryBarrier, 0, NULL ) );
+}
+
+// Hands an image that was written by staging copies from the transfer queue family to the work queue family.
+// The image stays in the transfer destination layout.
+static void ksGpuContext_AcquireUploadImage( ksGpuContext * context, const VkImage image, const VkImageSubresourceRange * range )
+{
+	if ( context->transferQueue == VK_NULL_HANDLE )
+	{
+		return;
+	}
+
+	VkImageMemoryBarrier imageMemoryBarrier;
+	imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	imageMemoryBarrier.pNext = NULL;
+	imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	imageMemoryBarrier.dstAccessMask = 0;
+	imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	imageMemoryBarrier.srcQueueFamilyIndex = context->device->transferQueueFamilyIndex;
+	imageMemoryBarrier.dstQueueFamilyIndex = context->queueFamilyIndex;
+	imageMemoryBarrier.image = image;
+	imageMemoryBarrier.subresourceRange = *range;
+
+	// Release on the transfer queue.
+	VC( context->device->vkCmdPipelineBarrier( context->uploadCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+												0, 0, NULL, 0, NULL, 1, &imageMemoryBarrier ) );
+
+	// Acquire on the work queue after the semaphore wait, as if the copies were recorded here.
+	imageMemoryBarrier.srcAccessMask = 0;
+	imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+	VC( context->device->vkCmdPipelineBarrier( context->setupCommandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+												0, 0, NULL, 0, NULL, 1, &imageMemoryBarrier ) );
+}
+
+// Keeps recording into the same setup batch unless it holds too much staging memory.
+static void ksGpuContext_DeferSetupCmdBuffer( ksGpuContext * context )
+{
+	if ( context->setupStagingSize >= MAX_SETUP_STAGING_SIZE )
+	{
+		ksGpuContext_FlushSetupCmdBuffer( context );
+	}
+}
+
+// Flushes any pending setup work and waits for all setup batches to complete.
+static void ksGpuContext_WaitSetupCmdBuffers( ksGpuContext * context )
+{
+	ksGpuContext_FlushSetupCmdBuffer( context );
+
+	for ( int i = 0; i < MAX_SETUP_BATCHES; i++ )
+	{
+		ksGpuSetupBatch * batch = &context->setupBatches[( context->setupBatchIndex + i ) % MAX_SETUP_BATCHES];
+		if ( batch->submitted )
+		{
+			VK( context->device->vkWaitForFences( context->device->device, 1, &batch->fence, VK_TRUE, UINT64_MAX ) );
+			ksGpuContext_ReleaseSetupBatch( context, batch );
+		}
+	}
+}
+
+static void ksGpuContext_Destroy( ksGpuContext * context )
+{
+	if ( context->device == NULL )
+	{
+		return;
+	}
+
+	// Mark the queue as no longer in use.
+	ksMutex_Lock( &context->device->queueFamilyMutex, true );
+	assert( ( context->device->queueFamilyUsedQueues[context->queueFamilyIndex] & ( 1 << context->queueIndex ) ) != 0 );
+	context->device->queueFamilyUsedQueues[context->queueFamilyIndex] &= ~( 1 << context->queueIndex );
+	ksMutex_Unlock( &context->device->queueFamilyMutex );
+
+	ksGpuContext_WaitSetupCmdBuffers( context );
+	for ( int i = 0; i < MAX_SETUP_BATCHES; i++ )
+	{
+		VC( context->device->vkDestroyFence( context->device->device, context->setupBatches[i].fence, VK_ALLOCATOR ) );
+		free( context->setupBatches[i].stagingBuffers );
+	}
+	if ( context->transferQueue != VK_NULL_HANDLE )
+	{
+		for ( int i = 0; i < MAX_SETUP_BATCHES; i++ )
+		{
+			VC( context->device->vkDestroySemaphore( context->device->device, context->setupBatches[i].transferSemaphore, VK_ALLOCATOR ) );
+		}
+		VC( context->device->vkDestroyCommandPool( context->device->device, context->transferCommandPool, VK_ALLOCATOR ) );
+
+		ksMutex_Lock( &context->device->queueFamilyMutex, true );
+		context->device->queueFamilyUsedQueues[context->device->transferQueueFamilyIndex] &= ~( 1 << context->transferQueueIndex );
+		ksMutex_Unlock( &context->device->queueFamilyMutex );
+	}
+	if ( context->stagingRingBuffer != VK_NULL_HANDLE )
+	{
+		VC( context->device->vkDestroyBuffer( context->device->device, context->stagingRingBuffer, VK_ALLOCATOR ) );
+		ksGpuMemoryAllocator_Free( &context->device->memoryAllocator, &context->stagingRingAllocation );
+	}
+	VC( context->device->vkDestroyCommandPool( context->device->device, context->commandPool, VK_ALLOCATOR ) );
+	VC( context->device->vkDestroyPipelineCache( context->device->device, context->pipelineCache, VK_ALLOCATOR ) );
+}
+
+static void ksGpuContext_WaitIdle( ksGpuContext * context )
+{
+	ksGpuContext_FlushSetupCmdBuffer( context );
+	VK( context->device->vkQueueWaitIdle( context->queue ) );
+	ksGpuContext_WaitSetupCmdBuffers( context );
+}
+
+static void ksGpuContext_GetLimits( ksGpuContext * context, ksGpuLimits * limits )
+{
+	limits->maxPushConstantsSize = context->device->physicalDeviceProperties.limits.maxPushConstantsSize;
+	const VkSampleCountFlags availableSampleCounts = context->device->physicalDeviceProperties.limits.framebufferColorSampleCounts &
+														context->device->physicalDeviceProperties.limits.framebufferDepthSampleCounts;
+	limits->maxSamples = 0;
+	for ( int bit = VK_SAMPLE_COUNT_1_BIT; bit <= VK_SAMPLE_COUNT_64_BIT; bit <<= 1 )
+	{
+		if ( ( availableSampleCounts & bit ) == 0 )
+		{
+			break;
+		}
+		limits->maxSamples = bit;
+	}
+	limits->drawIndirect = ( context->device->physicalDeviceFeatures.drawIndirectFirstInstance != VK_FALSE );
 }
 
 /*
@@ -2746,7 +3280,7 @@ typedef struct
 	VkFormat				internalFormat;
 	VkImageLayout			imageLayout;
 	VkImage					image;
-	VkDeviceMemory			memory;
+	ksGpuMemoryAllocation	allocation;
 	VkImageView *			views;
 	int						numViews;
 } ksGpuDepthBuffer;
@@ -2801,14 +3335,9 @@ static void ksGpuDepthBuffer_Create( ksGpuContext * context, ksGpuDepthBuffer *
 	VkMemoryRequirements memoryRequirements;
 	VC( context->device->vkGetImageMemoryRequirements( context->device->device, depthBuffer->image, &memoryRequirements ) );
 
-	VkMemoryAllocateInfo memoryAllocateInfo;
-	memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	memoryAllocateInfo.pNext = NULL;
-	memoryAllocateInfo.allocationSize = memoryRequirements.size;
-	memoryAllocateInfo.memoryTypeIndex = ksGpuDevice_GetMemoryTypeIndex( context->device, memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT );
+	ksGpuMemoryAllocator_Allocate( &context->device->memoryAllocator, &depthBuffer->allocation, &memoryRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, true );
 
-	VK( context->device->vkAllocateMemory( context->device->device, &memoryAllocateInfo, VK_ALLOCATOR, &depthBuffer->memory ) );
-	VK( context->device->vkBindImageMemory( context->device->device, depthBuffer->image, depthBuffer->memory, 0 ) );
+	VK( context->device->vkBindImageMemory( context->device->device, depthBuffer->image, depthBuffer->allocation.memory, depthBuffer->allocation.offset ) );
 
 	depthBuffer->views = (VkImageView *) malloc( numLayers * sizeof( VkImageView ) );
 	depthBuffer->numViews = numLayers;
@@ -2864,7 +3393,7 @@ static void ksGpuDepthBuffer_Create( ksGpuContext * context, ksGpuDepthBuffer *
 
 		VC( context->device->vkCmdPipelineBarrier( context->setupCommandBuffer, src_stages, dst_stages, flags, 0, NULL, 0, NULL, 1, &imageMemoryBarrier ) );
 
-		ksGpuContext_FlushSetupCmdBuffer( context );
+		ksGpuContext_DeferSetupCmdBuffer( context );
 	}
 
 	depthBuffer->imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
@@ -2882,7 +3411,7 @@ static void ksGpuDepthBuffer_Destroy( ksGpuContext * context, ksGpuDepthBuffer *
 		VC( context->device->vkDestroyImageView( context->device->device, depthBuffer->views[viewIndex], VK_ALLOCATOR ) );
 	}
 	VC( context->device->vkDestroyImage( context->device->device, depthBuffer->image, VK_ALLOCATOR ) );
-	VC( context->device->vkFreeMemory( context->device->device, depthBuffer->memory, VK_ALLOCATOR ) );
+	ksGpuMemoryAllocator_Free( &context->device->memoryAllocator, &depthBuffer->allocation );
 
 	free( depthBuffer->views );
 }
@@ -5581,6 +6110,7 @@ For optimal performance a buffer should only be created at load time, not at run
 The best performance is typically achieved when the buffer is not host visible.
 
 ksGpuBufferType
+ksGpuBufferUsage
 ksGpuBuffer
 
 static bool ksGpuBuffer_Create( ksGpuContext * context, ksGpuBuffer * buffer, const ksGpuBufferType type,
@@ -5596,9 +6126,16 @@ typedef enum
 	KS_GPU_BUFFER_TYPE_VERTEX,
 	KS_GPU_BUFFER_TYPE_INDEX,
 	KS_GPU_BUFFER_TYPE_UNIFORM,
-	KS_GPU_BUFFER_TYPE_STORAGE
+	KS_GPU_BUFFER_TYPE_STORAGE,
+	KS_GPU_BUFFER_TYPE_INDIRECT
 } ksGpuBufferType;
 
+typedef enum
+{
+	KS_GPU_BUFFER_USAGE_STORAGE,		// buffer is written by a compute program
+	KS_GPU_BUFFER_USAGE_INDIRECT		// buffer is read as indirect draw commands
+} ksGpuBufferUsage;
+
 typedef struct ksGpuBuffer_s
 {
 	struct ksGpuBuffer_s *	next;
@@ -5607,7 +6144,8 @@ typedef struct ksGpuBuffer_s
 	size_t					size;
 	VkMemoryPropertyFlags	flags;
 	VkBuffer				buffer;
-	VkDeviceMemory			memory;
+	VkDeviceSize			offset;			// offset into the VkBuffer when the buffer is a sub-range of a larger buffer
+	ksGpuMemoryAllocation	allocation;
 	void *					mapped;
 	bool			owner;
 } ksGpuBuffer;
@@ -5617,7 +6155,8 @@ static VkBufferUsageFlags ksGpuBuffer_GetBufferUsage( const ksGpuBufferType type
 	return	( ( type == KS_GPU_BUFFER_TYPE_VERTEX ) ?	VK_BUFFER_USAGE_VERTEX_BUFFER_BIT :
 			( ( type == KS_GPU_BUFFER_TYPE_INDEX ) ?	VK_BUFFER_USAGE_INDEX_BUFFER_BIT :
 			( ( type == KS_GPU_BUFFER_TYPE_UNIFORM ) ?	VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT :
-			( ( type == KS_GPU_BUFFER_TYPE_STORAGE ) ?	VK_BUFFER_USAGE_STORAGE_BUFFER_BIT : 0 ) ) ) );
+			( ( type == KS_GPU_BUFFER_TYPE_STORAGE ) ?	VK_BUFFER_USAGE_STORAGE_BUFFER_BIT :
+			( ( type == KS_GPU_BUFFER_TYPE_INDIRECT ) ?	( VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT ) : 0 ) ) ) ) );
 }
 
 static VkAccessFlags ksGpuBuffer_GetBufferAccess( const ksGpuBufferType type )
@@ -5625,7 +6164,8 @@ static VkAccessFlags ksGpuBuffer_GetBufferAccess( const ksGpuBufferType type )
 	return	( ( type == KS_GPU_BUFFER_TYPE_INDEX ) ?	VK_ACCESS_INDEX_READ_BIT :
 			( ( type == KS_GPU_BUFFER_TYPE_VERTEX ) ?	VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT :
 			( ( type == KS_GPU_BUFFER_TYPE_UNIFORM ) ?	VK_ACCESS_UNIFORM_READ_BIT :
-			( ( type == KS_GPU_BUFFER_TYPE_STORAGE ) ?	( VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT ) : 0 ) ) ) );
+			( ( type == KS_GPU_BUFFER_TYPE_STORAGE ) ?	( VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT ) :
+			( ( type == KS_GPU_BUFFER_TYPE_INDIRECT ) ?	VK_ACCESS_INDIRECT_COMMAND_READ_BIT : 0 ) ) ) ) );
 }
 
 static bool ksGpuBuffer_Create( ksGpuContext * context, ksGpuBuffer * buffer, const ksGpuBufferType type,
@@ -5657,86 +6197,78 @@ static bool ksGpuBuffer_Create( ksGpuContext * context, ksGpuBuffer * buffer, co
 	VkMemoryRequirements memoryRequirements;
 	VC( context->device->vkGetBufferMemoryRequirements( context->device->device, buffer->buffer, &memoryRequirements ) );
 
-	VkMemoryAllocateInfo memoryAllocateInfo;
-	memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	memoryAllocateInfo.pNext = NULL;
-	memoryAllocateInfo.allocationSize = memoryRequirements.size;
-	memoryAllocateInfo.memoryTypeIndex = ksGpuDevice_GetMemoryTypeIndex( context->device, memoryRequirements.memoryTypeBits, buffer->flags );
+	ksGpuMemoryAllocator_Allocate( &context->device->memoryAllocator, &buffer->allocation, &memoryRequirements, buffer->flags, false );
 
-	VK( context->device->vkAllocateMemory( context->device->device, &memoryAllocateInfo, VK_ALLOCATOR, &buffer->memory ) );
-	VK( context->device->vkBindBufferMemory( context->device->device, buffer->buffer, buffer->memory, 0 ) );
+	VK( context->device->vkBindBufferMemory( context->device->device, buffer->buffer, buffer->allocation.memory, buffer->allocation.offset ) );
 
 	if ( data != NULL )
 	{
 		if ( hostVisible )
 		{
-			void * mapped;
-			VK( context->device->vkMapMemory( context->device->device, buffer->memory, 0, memoryRequirements.size, 0, &mapped ) );
-			memcpy( mapped, data, dataSize );
-			VC( context->device->vkUnmapMemory( context->device->device, buffer->memory ) );
+			memcpy( buffer->allocation.mapped, data, dataSize );
 
 			VkMappedMemoryRange mappedMemoryRange;
 			mappedMemoryRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
 			mappedMemoryRange.pNext = NULL;
-			mappedMemoryRange.memory = buffer->memory;
-			mappedMemoryRange.offset = 0;
-			mappedMemoryRange.size = VK_WHOLE_SIZE;
+			mappedMemoryRange.memory = buffer->allocation.memory;
+			mappedMemoryRange.offset = buffer->allocation.offset;
+			mappedMemoryRange.size = buffer->allocation.size;
 			VC( context->device->vkFlushMappedMemoryRanges( context->device->device, 1, &mappedMemoryRange ) );
 		}
 		else
 		{
-			VkBufferCreateInfo stagingBufferCreateInfo;
-			stagingBufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-			stagingBufferCreateInfo.pNext = NULL;
-			stagingBufferCreateInfo.flags = 0;
-			stagingBufferCreateInfo.size = dataSize;
-			stagingBufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-			stagingBufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-			stagingBufferCreateInfo.queueFamilyIndexCount = 0;
-			stagingBufferCreateInfo.pQueueFamilyIndices = NULL;
-
 			VkBuffer srcBuffer;
-			VK( context->device->vkCreateBuffer( context->device->device, &stagingBufferCreateInfo, VK_ALLOCATOR, &srcBuffer ) );
-
-			VkMemoryRequirements stagingMemoryRequirements;
-			VC( context->device->vkGetBufferMemoryRequirements( context->device->device, srcBuffer, &stagingMemoryRequirements ) );
+			VkDeviceSize srcOffset;
+			if ( ksGpuContext_GetStaging( context, data, dataSize, &srcBuffer, &srcOffset ) )
+			{
+				// The data was decoded straight into staging memory.
+				VkBufferCopy bufferCopy;
+				bufferCopy.srcOffset = srcOffset;
+				bufferCopy.dstOffset = 0;
+				bufferCopy.size = dataSize;
 
-			VkMemoryAllocateInfo stagingMemoryAllocateInfo;
-			stagingMemoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-			stagingMemoryAllocateInfo.pNext = NULL;
-			stagingMemoryAllocateInfo.allocationSize = stagingMemoryRequirements.size;
-			stagingMemoryAllocateInfo.memoryTypeIndex = ksGpuDevice_GetMemoryTypeIndex( context->device, stagingMemoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT );
+				VC( context->device->vkCmdCopyBuffer( context->uploadCommandBuffer, srcBuffer, buffer->buffer, 1, &bufferCopy ) );
+			}
+			else
+			{
+				// Upload through the staging ring in chunks.
+				for ( size_t chunkOffset = 0; chunkOffset < dataSize; chunkOffset += MAX_SETUP_STAGING_SIZE )
+				{
+					const size_t chunkSize = MIN( dataSize - chunkOffset, MAX_SETUP_STAGING_SIZE );
 
-			VkDeviceMemory srcMemory;
-			VK( context->device->vkAllocateMemory( context->device->device, &stagingMemoryAllocateInfo, VK_ALLOCATOR, &srcMemory ) );
-			VK( context->device->vkBindBufferMemory( context->device->device, srcBuffer, srcMemory, 0 ) );
+					void * staging = ksGpuContext_AllocateStaging( context, chunkSize, &srcBuffer, &srcOffset );
+					memcpy( staging, (const uint8_t *)data + chunkOffset, chunkSize );
 
-			void * mapped;
-			VK( context->device->vkMapMemory( context->device->device, srcMemory, 0, stagingMemoryRequirements.size, 0, &mapped ) );
-			memcpy( mapped, data, dataSize );
-			VC( context->device->vkUnmapMemory( context->device->device, srcMemory ) );
+					VkBufferCopy bufferCopy;
+					bufferCopy.srcOffset = srcOffset;
+					bufferCopy.dstOffset = chunkOffset;
+					bufferCopy.size = chunkSize;
 
-			VkMappedMemoryRange mappedMemoryRange;
-			mappedMemoryRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-			mappedMemoryRange.pNext = NULL;
-			mappedMemoryRange.memory = srcMemory;
-			mappedMemoryRange.offset = 0;
-			mappedMemoryRange.size = VK_WHOLE_SIZE;
-			VC( context->device->vkFlushMappedMemoryRanges( context->device->device, 1, &mappedMemoryRange ) );
+					VC( context->device->vkCmdCopyBuffer( context->uploadCommandBuffer, srcBuffer, buffer->buffer, 1, &bufferCopy ) );
+				}
+			}
 
-			ksGpuContext_CreateSetupCmdBuffer( context );
+			ksGpuContext_AcquireUploadBuffer( context, buffer->buffer, dataSize );
 
-			VkBufferCopy bufferCopy;
-			bufferCopy.srcOffset = 0;
-			bufferCopy.dstOffset = 0;
-			bufferCopy.size = dataSize;
+			// The copy is not waited for, so make it available to any later use of the buffer.
+			VkBufferMemoryBarrier bufferMemoryBarrier;
+			bufferMemoryBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+			bufferMemoryBarrier.pNext = NULL;
+			bufferMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			bufferMemoryBarrier.dstAccessMask = ksGpuBuffer_GetBufferAccess( type );
+			bufferMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			bufferMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			bufferMemoryBarrier.buffer = buffer->buffer;
+			bufferMemoryBarrier.offset = 0;
+			bufferMemoryBarrier.size = dataSize;
 
-			VC( context->device->vkCmdCopyBuffer( context->setupCommandBuffer, srcBuffer, buffer->buffer, 1, &bufferCopy ) );
+			const VkPipelineStageFlags src_stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			const VkPipelineStageFlags dst_stages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+			const VkDependencyFlags flags = 0;
 
-			ksGpuContext_FlushSetupCmdBuffer( context );
+			VC( context->device->vkCmdPipelineBarrier( context->setupCommandBuffer, src_stages, dst_stages, flags, 0, NULL, 1, &bufferMemoryBarrier, 0, NULL ) );
 
-			VC( context->device->vkDestroyBuffer( context->device->device, srcBuffer, VK_ALLOCATOR ) );
-			VC( context->device->vkFreeMemory( context->device->device, srcMemory, VK_ALLOCATOR ) );
+			ksGpuContext_DeferSetupCmdBuffer( context );
 		}
 	}
 
@@ -5753,21 +6285,23 @@ static void ksGpuBuffer_CreateReference( ksGpuContext * context, ksGpuBuffer * b
 	buffer->size = other->size;
 	buffer->flags = other->flags;
 	buffer->buffer = other->buffer;
-	buffer->memory = other->memory;
+	buffer->offset = other->offset;
+	buffer->allocation = other->allocation;
 	buffer->mapped = NULL;
 	buffer->owner = false;
 }
 
 static void ksGpuBuffer_Destroy( ksGpuContext * context, ksGpuBuffer * buffer )
 {
-	if ( buffer->mapped != NULL )
-	{
-		VC( context->device->vkUnmapMemory( context->device->device, buffer->memory ) );
-	}
 	if ( buffer->owner )
 	{
+		// The buffer may still be the destination of a batched upload.
+		if ( ( buffer->flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT ) != 0 )
+		{
+			ksGpuContext_WaitSetupCmdBuffers( context );
+		}
 		VC( context->device->vkDestroyBuffer( context->device->device, buffer->buffer, VK_ALLOCATOR ) );
-		VC( context->device->vkFreeMemory( context->device->device, buffer->memory, VK_ALLOCATOR ) );
+		ksGpuMemoryAllocator_Free( &context->device->memoryAllocator, &buffer->allocation );
 	}
 }
 
@@ -5995,7 +6529,7 @@ typedef struct
 	VkFormat				format;
 	VkImageLayout			imageLayout;
 	VkImage					image;
-	VkDeviceMemory			memory;
+	ksGpuMemoryAllocation	allocation;
 	VkImageView				view;
 	VkSampler				sampler;
 } ksGpuTexture;
@@ -6261,14 +6795,9 @@ static bool ksGpuTexture_CreateInternal( ksGpuContext * context, ksGpuTexture *
 	VkMemoryRequirements memoryRequirements;
 	VC( context->device->vkGetImageMemoryRequirements( context->device->device, texture->image, &memoryRequirements ) );
 
-	VkMemoryAllocateInfo memoryAllocateInfo;
-	memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	memoryAllocateInfo.pNext = NULL;
-	memoryAllocateInfo.allocationSize = memoryRequirements.size;
-	memoryAllocateInfo.memoryTypeIndex = ksGpuDevice_GetMemoryTypeIndex( context->device, memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT );
+	ksGpuMemoryAllocator_Allocate( &context->device->memoryAllocator, &texture->allocation, &memoryRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, true );
 
-	VK( context->device->vkAllocateMemory( context->device->device, &memoryAllocateInfo, VK_ALLOCATOR, &texture->memory ) );
-	VK( context->device->vkBindImageMemory( context->device->device, texture->image, texture->memory, 0 ) );
+	VK( context->device->vkBindImageMemory( context->device->device, texture->image, texture->allocation.memory, texture->allocation.offset ) );
 
 	if ( data == NULL )
 	{
@@ -6299,95 +6828,17 @@ static bool ksGpuTexture_CreateInternal( ksGpuContext * context, ksGpuTexture *
 			VC( context->device->vkCmdPipelineBarrier( context->setupCommandBuffer, src_stages, dst_stages, flags, 0, NULL, 0, NULL, 1, &imageMemoryBarrier ) );
 		}
 
-		ksGpuContext_FlushSetupCmdBuffer( context );
+		ksGpuContext_DeferSetupCmdBuffer( context );
 	}
 	else	// Copy source data through a staging buffer.
 	{
 		assert( sampleCount == KS_GPU_SAMPLE_COUNT_1 );
 
-		ksGpuContext_CreateSetupCmdBuffer( context );
-
-		// Set optimal image layout for transfer destination.
-		{
-			VkImageMemoryBarrier imageMemoryBarrier;
-			imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-			imageMemoryBarrier.pNext = NULL;
-			imageMemoryBarrier.srcAccessMask = 0;
-			imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-			imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-			imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-			imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-			imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-			imageMemoryBarrier.image = texture->image;
-			imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-			imageMemoryBarrier.subresourceRange.baseMipLevel = 0;
-			imageMemoryBarrier.subresourceRange.levelCount = numStorageLevels;
-			imageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
-			imageMemoryBarrier.subresourceRange.layerCount = arrayLayerCount;
-
-			const VkPipelineStageFlags src_stages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-			const VkPipelineStageFlags dst_stages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-			const VkDependencyFlags flags = 0;
-
-			VC( context->device->vkCmdPipelineBarrier( context->setupCommandBuffer, src_stages, dst_stages, flags, 0, NULL, 0, NULL, 1, &imageMemoryBarrier ) );
-		}
-
 		const int numDataLevels = ( mipCount >= 1 ) ? mipCount : 1;
 		bool compressed = false;
 
-		// Using a staging buffer to initialize the tiled image.
-		VkBufferCreateInfo stagingBufferCreateInfo;
-		stagingBufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-		stagingBufferCreateInfo.pNext = NULL;
-		stagingBufferCreateInfo.flags = 0;
-		stagingBufferCreateInfo.size = dataSize;
-		stagingBufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-		stagingBufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-		stagingBufferCreateInfo.queueFamilyIndexCount = 0;
-		stagingBufferCreateInfo.pQueueFamilyIndices = NULL;
-
-		VkBuffer stagingBuffer;
-		VK( context->device->vkCreateBuffer( context->device->device, &stagingBufferCreateInfo, VK_ALLOCATOR, &stagingBuffer ) );
-
-		VkMemoryRequirements stagingMemoryRequirements;
-		VC( context->device->vkGetBufferMemoryRequirements( context->device->device, stagingBuffer, &stagingMemoryRequirements ) );
-
-		VkMemoryAllocateInfo stagingMemoryAllocateInfo;
-		stagingMemoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		stagingMemoryAllocateInfo.pNext = NULL;
-		stagingMemoryAllocateInfo.allocationSize = stagingMemoryRequirements.size;
-		stagingMemoryAllocateInfo.memoryTypeIndex = ksGpuDevice_GetMemoryTypeIndex( context->device, stagingMemoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT );
-
-		VkDeviceMemory stagingMemory;
-		VK( context->device->vkAllocateMemory( context->device->device, &stagingMemoryAllocateInfo, VK_ALLOCATOR, &stagingMemory ) );
-		VK( context->device->vkBindBufferMemory( context->device->device, stagingBuffer, stagingMemory, 0 ) );
-
-		uint8_t * mapped;
-		VK( context->device->vkMapMemory( context->device->device, stagingMemory, 0, stagingMemoryRequirements.size, 0, (void **)&mapped ) );
-		memcpy( mapped, data, dataSize );
-		VC( context->device->vkUnmapMemory( context->device->device, stagingMemory ) );
-
-		// Make sure the CPU writes to the buffer are flushed.
-		{
-			VkBufferMemoryBarrier bufferMemoryBarrier;
-			bufferMemoryBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
-			bufferMemoryBarrier.pNext = NULL;
-			bufferMemoryBarrier.srcAccessMask = VK_ACCESS_HOST_WRITE_BIT;
-			bufferMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-			bufferMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-			bufferMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-			bufferMemoryBarrier.buffer = stagingBuffer;
-			bufferMemoryBarrier.offset = 0;
-			bufferMemoryBarrier.size = dataSize;
-
-			const VkPipelineStageFlags src_stages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-			const VkPipelineStageFlags dst_stages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-			const VkDependencyFlags flags = 0;
-
-			VC( context->device->vkCmdPipelineBarrier( context->setupCommandBuffer, src_stages, dst_stages, flags, 0, NULL, 1, &bufferMemoryBarrier, 0, NULL ) );
-		}
-
 		VkBufferImageCopy * bufferImageCopy = (VkBufferImageCopy *) malloc( numDataLevels * arrayLayerCount * MAX( depth, 1 ) * sizeof( VkBufferImageCopy ) );
+		uint32_t * bufferImageCopySize = (uint32_t *) malloc( numDataLevels * arrayLayerCount * MAX( depth, 1 ) * sizeof( uint32_t ) );
 		uint32_t bufferImageCopyIndex = 0;
 		uint32_t dataOffset = 0;
 		for ( int mipLevel = 0; mipLevel < numDataLevels; mipLevel++ )
@@ -6567,6 +7018,7 @@ static bool ksGpuTexture_CreateInternal( ksGpuContext * context, ksGpuTexture *
 
 					assert( dataOffset + mipSize <= dataSize );
 
+					bufferImageCopySize[bufferImageCopyIndex - 1] = mipSize;
 					totalMipSize += mipSize;
 					dataOffset += mipSize;
 					if ( mipSizeStored && ( depth <= 0 && layerCount <= 0 ) )
@@ -6585,8 +7037,88 @@ static bool ksGpuTexture_CreateInternal( ksGpuContext * context, ksGpuTexture *
 
 		assert( dataOffset == dataSize );
 
-		VC( context->device->vkCmdCopyBufferToImage( context->setupCommandBuffer, stagingBuffer, texture->image,
-					VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, numDataLevels * arrayLayerCount * MAX( depth, 1 ), bufferImageCopy ) );
+		const uint32_t bufferImageCopyCount = bufferImageCopyIndex;
+
+		// Textures that were decoded straight into staging memory and small textures
+		// are staged as a whole and copied with a single command.
+		VkBuffer stagingBuffer = VK_NULL_HANDLE;
+		VkDeviceSize stagingOffset = 0;
+		if ( !ksGpuContext_GetStaging( context, data, dataSize, &stagingBuffer, &stagingOffset ) )
+		{
+			if ( dataSize <= MAX_SETUP_STAGING_SIZE )
+			{
+				void * staging = ksGpuContext_AllocateStaging( context, dataSize, &stagingBuffer, &stagingOffset );
+				memcpy( staging, data, dataSize );
+			}
+			else
+			{
+				ksGpuContext_CreateSetupCmdBuffer( context );
+			}
+		}
+		if ( stagingBuffer != VK_NULL_HANDLE )
+		{
+			for ( uint32_t i = 0; i < bufferImageCopyCount; i++ )
+			{
+				bufferImageCopy[i].bufferOffset += stagingOffset;
+			}
+		}
+
+		// Set optimal image layout for transfer destination.
+		{
+			VkImageMemoryBarrier imageMemoryBarrier;
+			imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			imageMemoryBarrier.pNext = NULL;
+			imageMemoryBarrier.srcAccessMask = 0;
+			imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			imageMemoryBarrier.image = texture->image;
+			imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			imageMemoryBarrier.subresourceRange.baseMipLevel = 0;
+			imageMemoryBarrier.subresourceRange.levelCount = numStorageLevels;
+			imageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
+			imageMemoryBarrier.subresourceRange.layerCount = arrayLayerCount;
+
+			const VkPipelineStageFlags src_stages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+			const VkPipelineStageFlags dst_stages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+			const VkDependencyFlags flags = 0;
+
+			VC( context->device->vkCmdPipelineBarrier( context->uploadCommandBuffer, src_stages, dst_stages, flags, 0, NULL, 0, NULL, 1, &imageMemoryBarrier ) );
+		}
+
+		if ( stagingBuffer != VK_NULL_HANDLE )
+		{
+			VC( context->device->vkCmdCopyBufferToImage( context->uploadCommandBuffer, stagingBuffer, texture->image,
+						VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, bufferImageCopyCount, bufferImageCopy ) );
+		}
+		else
+		{
+			// Large textures are staged one region at a time.
+			for ( uint32_t i = 0; i < bufferImageCopyCount; i++ )
+			{
+				VkDeviceSize stagingOffset;
+				void * staging = ksGpuContext_AllocateStaging( context, bufferImageCopySize[i], &stagingBuffer, &stagingOffset );
+				memcpy( staging, (const uint8_t *)data + bufferImageCopy[i].bufferOffset, bufferImageCopySize[i] );
+				bufferImageCopy[i].bufferOffset = stagingOffset;
+
+				VC( context->device->vkCmdCopyBufferToImage( context->uploadCommandBuffer, stagingBuffer, texture->image,
+							VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &bufferImageCopy[i] ) );
+			}
+		}
+
+		// Mip map generation and the final layout transition happen on the work queue.
+		{
+			VkImageSubresourceRange subresourceRange;
+			subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			subresourceRange.baseMipLevel = 0;
+			subresourceRange.levelCount = numStorageLevels;
+			subresourceRange.baseArrayLayer = 0;
+			subresourceRange.layerCount = arrayLayerCount;
+
+			ksGpuContext_AcquireUploadImage( context, texture->image, &subresourceRange );
+		}
 
 		if ( mipCount < 1 )
 		{
@@ -6681,10 +7213,9 @@ static bool ksGpuTexture_CreateInternal( ksGpuContext * context, ksGpuTexture *
 			VC( context->device->vkCmdPipelineBarrier( context->setupCommandBuffer, src_stages, dst_stages, flags, 0, NULL, 0, NULL, 1, &imageMemoryBarrier ) );
 		}
 
-		ksGpuContext_FlushSetupCmdBuffer( context );
+		ksGpuContext_DeferSetupCmdBuffer( context );
 
-		VC( context->device->vkFreeMemory( context->device->device, stagingMemory, VK_ALLOCATOR ) );
-		VC( context->device->vkDestroyBuffer( context->device->device, stagingBuffer, VK_ALLOCATOR ) );
+		free( bufferImageCopySize );
 		free( bufferImageCopy );
 	}
 
@@ -6911,7 +7442,7 @@ static bool ksGpuTexture_CreateFromSwapchain( ksGpuContext * context, ksGpuTextu
 	texture->format = window->swapchain.internalFormat;
 	texture->imageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 	texture->image = window->swapchain.images[index];
-	texture->memory = VK_NULL_HANDLE;
+	memset( &texture->allocation, 0, sizeof( texture->allocation ) );
 	texture->view = window->swapchain.views[index];
 	texture->sampler = VK_NULL_HANDLE;
 	ksGpuTexture_UpdateSampler( context, texture );
@@ -7025,32 +7556,46 @@ static bool ksGpuTexture_CreateFromFile( ksGpuContext * context, ksGpuTexture *
 	size_t bufferSize = ftell( fp );
 	fseek( fp, 0L, SEEK_SET );
 
-	unsigned char * buffer = (unsigned char *) malloc( bufferSize );
+	// The texture data starts after the 64 byte header and the key value data.
+	unsigned char header[64];
+	if ( fread( header, 1, sizeof( header ), fp ) != sizeof( header ) )
+	{
+		Error( "%s: Invalid KTX file", fileName );
+		fclose( fp );
+		return false;
+	}
+	const unsigned int bytesOfKeyValueData = header[60] | ( header[61] << 8 ) | ( header[62] << 16 ) | ( (unsigned int)header[63] << 24 );
+	const size_t startTex = sizeof( header ) + bytesOfKeyValueData;
+	const size_t padding = ( STAGING_RING_ALIGNMENT - startTex % STAGING_RING_ALIGNMENT ) % STAGING_RING_ALIGNMENT;
+
+	// Read the file straight into staging memory with the texture data aligned for the copies to the image.
+	// Only the header and the stored mip sizes are read back from the staging memory.
+	VkBuffer stagingBuffer;
+	VkDeviceSize stagingOffset;
+	unsigned char * buffer = (unsigned char *)ksGpuContext_AllocateStaging( context, padding + bufferSize, &stagingBuffer, &stagingOffset ) + padding;
+	fseek( fp, 0L, SEEK_SET );
 	if ( fread( buffer, 1, bufferSize, fp ) != bufferSize )
 	{
 		Error( "Failed to read %s", fileName );
-		free( buffer );
 		fclose( fp );
 		return false;
 	}
 	fclose( fp );
 
-	bool success = ksGpuTexture_CreateFromKTX( context, texture, fileName, buffer, bufferSize );
-
-	free( buffer );
-
-	return success;
+	return ksGpuTexture_CreateFromKTX( context, texture, fileName, buffer, bufferSize );
 }
 
 static void ksGpuTexture_Destroy( ksGpuContext * context, ksGpuTexture * texture )
 {
 	VC( context->device->vkDestroySampler( context->device->device, texture->sampler, VK_ALLOCATOR ) );
 	// A texture created from a swapchain does not own the view, image or memory.
-	if ( texture->memory != VK_NULL_HANDLE )
+	if ( texture->allocation.memory != VK_NULL_HANDLE )
 	{
+		// The texture may still be the destination of a batched upload.
+		ksGpuContext_WaitSetupCmdBuffers( context );
 		VC( context->device->vkDestroyImageView( context->device->device, texture->view, VK_ALLOCATOR ) );
 		VC( context->device->vkDestroyImage( context->device->device, texture->image, VK_ALLOCATOR ) );
-		VC( context->device->vkFreeMemory( context->device->device, texture->memory, VK_ALLOCATOR ) );
+		ksGpuMemoryAllocator_Free( &context->device->memoryAllocator, &texture->allocation );
 	}
 	memset( texture, 0, sizeof( ksGpuTexture ) );
 }
@@ -7327,7 +7872,8 @@ typedef enum
 	VERTEX_ATTRIBUTE_FLAG_UV2			= BIT( 7 ),		// vec2 vertexUv2
 	VERTEX_ATTRIBUTE_FLAG_JOINT_INDICES	= BIT( 8 ),		// vec4 jointIndices
 	VERTEX_ATTRIBUTE_FLAG_JOINT_WEIGHTS	= BIT( 9 ),		// vec4 jointWeights
-	VERTEX_ATTRIBUTE_FLAG_TRANSFORM		= BIT( 10 )		// mat4 vertexTransform (NOTE this mat4 takes up 4 attribute locations)
+	VERTEX_ATTRIBUTE_FLAG_TRANSFORM		= BIT( 10 ),	// mat4 vertexTransform (NOTE this mat4 takes up 4 attribute locations)
+	VERTEX_ATTRIBUTE_FLAG_TRANSFORM_INVERSE	= BIT( 11 )	// mat4 vertexTransformInverse (NOTE this mat4 takes up 4 attribute locations)
 } ksDefaultVertexAttributeFlags;
 
 typedef struct
@@ -7344,6 +7890,7 @@ typedef struct
 	ksVector4f *				jointIndices;
 	ksVector4f *				jointWeights;
 	ksMatrix4x4f *				transform;
+	ksMatrix4x4f *				transformInverse;
 } ksDefaultVertexAttributeArrays;
 
 static const ksGpuVertexAttribute DefaultVertexAttributeLayout[] =
@@ -7359,6 +7906,7 @@ static const ksGpuVertexAttribute DefaultVertexAttributeLayout[] =
 	{ VERTEX_ATTRIBUTE_FLAG_JOINT_INDICES,	OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, jointIndices ),	SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, jointIndices[0] ),	KS_GPU_ATTRIBUTE_FORMAT_R32G32B32A32_SFLOAT,	1,	"vertexJointIndices" },
 	{ VERTEX_ATTRIBUTE_FLAG_JOINT_WEIGHTS,	OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, jointWeights ),	SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, jointWeights[0] ),	KS_GPU_ATTRIBUTE_FORMAT_R32G32B32A32_SFLOAT,	1,	"vertexJointWeights" },
 	{ VERTEX_ATTRIBUTE_FLAG_TRANSFORM,		OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, transform ),		SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, transform[0] ),		KS_GPU_ATTRIBUTE_FORMAT_R32G32B32A32_SFLOAT,	4,	"vertexTransform" },
+	{ VERTEX_ATTRIBUTE_FLAG_TRANSFORM_INVERSE,	OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, transformInverse ),	SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, transformInverse[0] ),	KS_GPU_ATTRIBUTE_FORMAT_R32G32B32A32_SFLOAT,	4,	"vertexTransformInverse" },
 	{ 0, 0, 0, 0, 0, "" }
 };
 
@@ -7900,7 +8448,7 @@ static bool ksGpuFramebuffer_CreateFromSwapchain( ksGpuWindow * window, ksGpuFra
 			window->windowWidth, window->windowHeight, 1, KS_GPU_TEXTURE_USAGE_COLOR_ATTACHMENT, NULL, 0 );
 		ksGpuContext_CreateSetupCmdBuffer( &window->context );
 		ksGpuTexture_ChangeUsage( &window->context, window->context.setupCommandBuffer, &framebuffer->renderTexture, KS_GPU_TEXTURE_USAGE_COLOR_ATTACHMENT );
-		ksGpuContext_FlushSetupCmdBuffer( &window->context );
+		ksGpuContext_DeferSetupCmdBuffer( &window->context );
 	}
 
 	for ( uint32_t imageIndex = 0; imageIndex < window->swapchain.imageCount; imageIndex++ )
@@ -7981,7 +8529,7 @@ static bool ksGpuFramebuffer_CreateFromTextures( ksGpuContext * context, ksGpuFr
 			width, height, 1, KS_GPU_TEXTURE_USAGE_COLOR_ATTACHMENT, NULL, 0 );
 		ksGpuContext_CreateSetupCmdBuffer( context );
 		ksGpuTexture_ChangeUsage( context, context->setupCommandBuffer, &framebuffer->renderTexture, KS_GPU_TEXTURE_USAGE_COLOR_ATTACHMENT );
-		ksGpuContext_FlushSetupCmdBuffer( context );
+		ksGpuContext_DeferSetupCmdBuffer( context );
 	}
 
 	if ( renderPass->internalDepthFormat != VK_FORMAT_UNDEFINED )
@@ -8069,7 +8617,7 @@ static bool ksGpuFramebuffer_CreateFromTextureArrays( ksGpuContext * context, ks
 			width, height, numLayers, 1, KS_GPU_TEXTURE_USAGE_COLOR_ATTACHMENT, NULL, 0 );
 		ksGpuContext_CreateSetupCmdBuffer( context );
 		ksGpuTexture_ChangeUsage( context, context->setupCommandBuffer, &framebuffer->renderTexture, KS_GPU_TEXTURE_USAGE_COLOR_ATTACHMENT );
-		ksGpuContext_FlushSetupCmdBuffer( context );
+		ksGpuContext_DeferSetupCmdBuffer( context );
 	}
 
 	if ( renderPass->internalDepthFormat != VK_FORMAT_UNDEFINED )
@@ -8332,8 +8880,8 @@ static VkDescriptorType ksGpuProgramParm_GetDescriptorType( const ksGpuProgramPa
 {
 	return	( ( type == KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED ) ?	VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER :
 			( ( type == KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_STORAGE ) ?	VK_DESCRIPTOR_TYPE_STORAGE_IMAGE :
-			( ( type == KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM ) ?		VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER :
-			( ( type == KS_GPU_PROGRAM_PARM_TYPE_BUFFER_STORAGE ) ?		VK_DESCRIPTOR_TYPE_STORAGE_BUFFER :
+			( ( type == KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM ) ?		VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC :
+			( ( type == KS_GPU_PROGRAM_PARM_TYPE_BUFFER_STORAGE ) ?		VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC :
 																		VK_DESCRIPTOR_TYPE_MAX_ENUM ) ) ) );
 }
 
@@ -9214,7 +9762,7 @@ static void ksGpuTimer_Create( ksGpuContext * context, ksGpuTimer * timer )
 
 	ksGpuContext_CreateSetupCmdBuffer( context );
 	VC( context->device->vkCmdResetQueryPool( context->setupCommandBuffer, timer->pool, 0, queryCount ) );
-	ksGpuContext_FlushSetupCmdBuffer( context );
+	ksGpuContext_DeferSetupCmdBuffer( context );
 }
 
 static void ksGpuTimer_Destroy( ksGpuContext * context, ksGpuTimer * timer )
@@ -9348,6 +9896,23 @@ static bool ksGpuProgramParmState_DescriptorsMatch( const ksGpuProgramParmLayout
 	return true;
 }
 
+// Buffers are bound with dynamic offsets so sub-ranges of the same buffer can share a descriptor set.
+static int ksGpuProgramParmState_GetDynamicOffsets( const ksGpuProgramParmLayout * layout, const ksGpuProgramParmState * parmState, uint32_t * offsets )
+{
+	int count = 0;
+	for ( int i = 0; i < layout->numBindings; i++ )
+	{
+		const ksGpuProgramParm * binding = layout->bindings[i];
+		if ( binding->type == KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM ||
+				binding->type == KS_GPU_PROGRAM_PARM_TYPE_BUFFER_STORAGE )
+		{
+			const ksGpuBuffer * buffer = (const ksGpuBuffer *)parmState->parms[binding->index];
+			offsets[count++] = (uint32_t)buffer->offset;
+		}
+	}
+	return count;
+}
+
 /*
 ================================================================================================================================
 
@@ -9359,6 +9924,7 @@ at least past the submission of the command buffer into which the graphics comma
 submitted. Because pointers are maintained as state, DO NOT use pointers to local
 variables that will go out of scope before the command buffer is submitted.
 
+ksGpuDrawIndirectCommand
 ksGpuGraphicsCommand
 
 static void ksGpuGraphicsCommand_Init( ksGpuGraphicsCommand * command );
@@ -9387,17 +9953,31 @@ static void ksGpuGraphicsCommand_SetParmFloatMatrix4x2( ksGpuGraphicsCommand * c
 static void ksGpuGraphicsCommand_SetParmFloatMatrix4x3( ksGpuGraphicsCommand * command, const int index, const ksMatrix4x3f * value );
 static void ksGpuGraphicsCommand_SetParmFloatMatrix4x4( ksGpuGraphicsCommand * command, const int index, const ksMatrix4x4f * value );
 static void ksGpuGraphicsCommand_SetNumInstances( ksGpuGraphicsCommand * command, const int numInstances );
+static void ksGpuGraphicsCommand_SetIndirectBuffer( ksGpuGraphicsCommand * command, const ksGpuBuffer * indirectBuffer, const int firstDraw, const int drawCount );
 
 ================================================================================================================================
 */
 
+// Same layout as VkDrawIndexedIndirectCommand.
+typedef struct
+{
+	uint32_t	indexCount;
+	uint32_t	instanceCount;
+	uint32_t	firstIndex;
+	int32_t		vertexOffset;
+	uint32_t	firstInstance;
+} ksGpuDrawIndirectCommand;
+
 typedef struct
 {
 	const ksGpuGraphicsPipeline *	pipeline;
 	const ksGpuBuffer *				vertexBuffer;		// vertex buffer returned by ksGpuCommandBuffer_MapVertexAttributes
 	const ksGpuBuffer *				instanceBuffer;		// instance buffer returned by ksGpuCommandBuffer_MapInstanceAttributes
+	const ksGpuBuffer *				indirectBuffer;		// buffer with ksGpuDrawIndirectCommand structures
 	ksGpuProgramParmState			parmState;
 	int								numInstances;
+	int								indirectFirstDraw;
+	int								indirectDrawCount;
 } ksGpuGraphicsCommand;
 
 static void ksGpuGraphicsCommand_Init( ksGpuGraphicsCommand * command )
@@ -9405,8 +9985,11 @@ static void ksGpuGraphicsCommand_Init( ksGpuGraphicsCommand * command )
 	command->pipeline = NULL;
 	command->vertexBuffer = NULL;
 	command->instanceBuffer = NULL;
+	command->indirectBuffer = NULL;
 	memset( (void *)&command->parmState, 0, sizeof( command->parmState ) );
 	command->numInstances = 1;
+	command->indirectFirstDraw = 0;
+	command->indirectDrawCount = 0;
 }
 
 static void ksGpuGraphicsCommand_SetPipeline( ksGpuGraphicsCommand * command, const ksGpuGraphicsPipeline * pipeline )
@@ -9534,6 +10117,13 @@ static void ksGpuGraphicsCommand_SetNumInstances( ksGpuGraphicsCommand * command
 	command->numInstances = numInstances;
 }
 
+static void ksGpuGraphicsCommand_SetIndirectBuffer( ksGpuGraphicsCommand * command, const ksGpuBuffer * indirectBuffer, const int firstDraw, const int drawCount )
+{
+	command->indirectBuffer = indirectBuffer;
+	command->indirectFirstDraw = firstDraw;
+	command->indirectDrawCount = drawCount;
+}
+
 /*
 ================================================================================================================================
 
@@ -9717,169 +10307,164 @@ GPU pipeline resources.
 
 Resources, like texture and uniform buffer descriptions, that are used by a graphics or compute pipeline.
 
+Descriptor sets are cached in a hash table that is keyed on the program parm layout and the
+bound resources. The descriptor sets are allocated from large descriptor pools that are shared
+by all resources in the cache. Resources that have not been used for a number of frames are
+removed from the hash table and their descriptor sets are recycled for new resources with the
+same descriptor set layout. The pools are only released when the cache is cleared or destroyed.
+The cache itself lives in gpu/gpu_descriptor_set_cache.h and only calls the graphics API through
+the descriptor set callbacks of the context.
+
 ksGpuPipelineResources
+ksGpuDescriptorSetCache
+
+static void ksGpuContext_GetDescriptorSetCallbacks( ksGpuContext * context, ksGpuDescriptorSetCallbacks * callbacks );
 
-static void ksGpuPipelineResources_Create( ksGpuContext * context, ksGpuPipelineResources * resources,
-										const ksGpuProgramParmLayout * parmLayout,
-										const ksGpuProgramParmState * parms );
-static void ksGpuPipelineResources_Destroy( ksGpuContext * context, ksGpuPipelineResources * resources );
+static void ksGpuDescriptorSetCache_Create( ksGpuDescriptorSetCache * cache, const ksGpuDescriptorSetCallbacks * callbacks );
+static void ksGpuDescriptorSetCache_Destroy( ksGpuDescriptorSetCache * cache );
+static void ksGpuDescriptorSetCache_Clear( ksGpuDescriptorSetCache * cache );
+static ksGpuPipelineResources * ksGpuDescriptorSetCache_Get( ksGpuDescriptorSetCache * cache,
+										const ksGpuProgramParmLayout * parmLayout, const ksGpuProgramParmState * parms );
+static void ksGpuDescriptorSetCache_RemoveUnused( ksGpuDescriptorSetCache * cache, const int maxUnusedCount );
 
 ================================================================================================================================
 */
 
-typedef struct ksGpuPipelineResources_s
-{
-	struct ksGpuPipelineResources_s *	next;
-	int									unusedCount;			// Number of frames these resources have not been used.
-	const ksGpuProgramParmLayout *		parmLayout;
-	ksGpuProgramParmState				parms;
-	VkDescriptorPool					descriptorPool;
-	VkDescriptorSet						descriptorSet;
-} ksGpuPipelineResources;
+#include "gpu/gpu_descriptor_set_cache.h"
 
-static void ksGpuPipelineResources_Create( ksGpuContext * context, ksGpuPipelineResources * resources,
-										const ksGpuProgramParmLayout * parmLayout,
-										const ksGpuProgramParmState * parms )
+static VkDescriptorPool ksGpuContext_CreateDescriptorPool( void * userData, const int maxSets, const int maxDescriptorsPerType )
 {
-	memset( resources, 0, sizeof( ksGpuPipelineResources ) );
-
-	resources->parmLayout = parmLayout;
-	memcpy( (void *)&resources->parms, parms, sizeof( ksGpuProgramParmState ) );
-
-	//
-	// Create descriptor pool.
-	//
+	ksGpuContext * context = (ksGpuContext *)userData;
 
+	VkDescriptorPoolSize typeCounts[DESCRIPTOR_POOL_TYPE_COUNT];
+	for ( int i = 0; i < DESCRIPTOR_POOL_TYPE_COUNT; i++ )
 	{
-		VkDescriptorPoolSize typeCounts[MAX_PROGRAM_PARMS];
-
-		int count = 0;
-		for ( int i = 0; i < parmLayout->numBindings; i++ )
-		{
-			VkDescriptorType type = ksGpuProgramParm_GetDescriptorType( parmLayout->bindings[i]->type );
-			for ( int j = 0; j < count; j++ )
-			{
-				if ( typeCounts[j].type == type )
-				{
-					typeCounts[j].descriptorCount++;
-					type = VK_DESCRIPTOR_TYPE_MAX_ENUM;
-					break;
-				}
-			}
-			if ( type != VK_DESCRIPTOR_TYPE_MAX_ENUM )
-			{
-				typeCounts[count].type = type;
-				typeCounts[count].descriptorCount = 1;
-				count++;
-			}
-		}
-		if ( count == 0 )
-		{
-			typeCounts[count].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-			typeCounts[count].descriptorCount = 1;
-			count++;
-		}
+		typeCounts[i].type = ksGpuProgramParm_GetDescriptorType( (ksGpuProgramParmType)i );
+		typeCounts[i].descriptorCount = maxDescriptorsPerType;
+	}
 
-		VkDescriptorPoolCreateInfo destriptorPoolCreateInfo;
-		destriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-		destriptorPoolCreateInfo.pNext = NULL;
-		destriptorPoolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-		destriptorPoolCreateInfo.maxSets = 1;
-		destriptorPoolCreateInfo.poolSizeCount = count;
-		destriptorPoolCreateInfo.pPoolSizes = ( count != 0 ) ? typeCounts : NULL;
+	VkDescriptorPoolCreateInfo destriptorPoolCreateInfo;
+	destriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	destriptorPoolCreateInfo.pNext = NULL;
+	destriptorPoolCreateInfo.flags = 0;
+	destriptorPoolCreateInfo.maxSets = maxSets;
+	destriptorPoolCreateInfo.poolSizeCount = DESCRIPTOR_POOL_TYPE_COUNT;
+	destriptorPoolCreateInfo.pPoolSizes = typeCounts;
 
-		VK( context->device->vkCreateDescriptorPool( context->device->device, &destriptorPoolCreateInfo, VK_ALLOCATOR, &resources->descriptorPool ) );
-	}
+	VkDescriptorPool pool;
+	VK( context->device->vkCreateDescriptorPool( context->device->device, &destriptorPoolCreateInfo, VK_ALLOCATOR, &pool ) );
+	return pool;
+}
 
-	//
-	// Allocated and update a descriptor set.
-	//
+static void ksGpuContext_DestroyDescriptorPool( void * userData, VkDescriptorPool pool )
+{
+	ksGpuContext * context = (ksGpuContext *)userData;
+	VC( context->device->vkDestroyDescriptorPool( context->device->device, pool, VK_ALLOCATOR ) );
+}
 
-	{
-		VkDescriptorSetAllocateInfo descriptorSetAllocateInfo;
-		descriptorSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-		descriptorSetAllocateInfo.pNext = NULL;
-		descriptorSetAllocateInfo.descriptorPool = resources->descriptorPool;
-		descriptorSetAllocateInfo.descriptorSetCount = 1;
-		descriptorSetAllocateInfo.pSetLayouts = &parmLayout->descriptorSetLayout;
+static void ksGpuContext_ResetDescriptorPool( void * userData, VkDescriptorPool pool )
+{
+	ksGpuContext * context = (ksGpuContext *)userData;
+	VK( context->device->vkResetDescriptorPool( context->device->device, pool, 0 ) );
+}
 
-		VK( context->device->vkAllocateDescriptorSets( context->device->device, &descriptorSetAllocateInfo, &resources->descriptorSet ) );
+static VkDescriptorSet ksGpuContext_AllocateDescriptorSet( void * userData, VkDescriptorPool pool, VkDescriptorSetLayout descriptorSetLayout )
+{
+	ksGpuContext * context = (ksGpuContext *)userData;
 
-		VkWriteDescriptorSet writes[MAX_PROGRAM_PARMS] = { { 0 } };
-		VkDescriptorImageInfo imageInfo[MAX_PROGRAM_PARMS] = { { 0 } };
-		VkDescriptorBufferInfo bufferInfo[MAX_PROGRAM_PARMS] = { { 0 } };
+	VkDescriptorSetAllocateInfo descriptorSetAllocateInfo;
+	descriptorSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	descriptorSetAllocateInfo.pNext = NULL;
+	descriptorSetAllocateInfo.descriptorPool = pool;
+	descriptorSetAllocateInfo.descriptorSetCount = 1;
+	descriptorSetAllocateInfo.pSetLayouts = &descriptorSetLayout;
 
-		int numWrites = 0;
-		for ( int i = 0; i < parmLayout->numBindings; i++ )
-		{
-			const ksGpuProgramParm * binding = parmLayout->bindings[i];
+	VkDescriptorSet descriptorSet;
+	VK( context->device->vkAllocateDescriptorSets( context->device->device, &descriptorSetAllocateInfo, &descriptorSet ) );
+	return descriptorSet;
+}
 
-			writes[numWrites].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			writes[numWrites].pNext = NULL;
-			writes[numWrites].dstSet = resources->descriptorSet;
-			writes[numWrites].dstBinding = binding->binding;
-			writes[numWrites].dstArrayElement = 0;
-			writes[numWrites].descriptorCount = 1;
-			writes[numWrites].descriptorType = ksGpuProgramParm_GetDescriptorType( parmLayout->bindings[i]->type );
-			writes[numWrites].pImageInfo = &imageInfo[numWrites];
-			writes[numWrites].pBufferInfo = &bufferInfo[numWrites];
-			writes[numWrites].pTexelBufferView = NULL;
+static void ksGpuContext_UpdateDescriptorSet( void * userData, VkDescriptorSet descriptorSet,
+										const ksGpuProgramParmLayout * parmLayout, const ksGpuProgramParmState * parms )
+{
+	ksGpuContext * context = (ksGpuContext *)userData;
 
-			if ( binding->type == KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED )
-			{
-				const ksGpuTexture * texture = (const ksGpuTexture *)parms->parms[binding->index];
-				assert( texture->usage == KS_GPU_TEXTURE_USAGE_SAMPLED );
-				assert( texture->imageLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL );
+	VkWriteDescriptorSet writes[MAX_PROGRAM_PARMS] = { { 0 } };
+	VkDescriptorImageInfo imageInfo[MAX_PROGRAM_PARMS] = { { 0 } };
+	VkDescriptorBufferInfo bufferInfo[MAX_PROGRAM_PARMS] = { { 0 } };
 
-				imageInfo[numWrites].sampler = texture->sampler;
-				imageInfo[numWrites].imageView = texture->view;
-				imageInfo[numWrites].imageLayout = texture->imageLayout;
-			}
-			else if ( binding->type == KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_STORAGE )
-			{
-				const ksGpuTexture * texture = (const ksGpuTexture *)parms->parms[binding->index];
-				assert( texture->usage == KS_GPU_TEXTURE_USAGE_STORAGE );
-				assert( texture->imageLayout == VK_IMAGE_LAYOUT_GENERAL );
+	int numWrites = 0;
+	for ( int i = 0; i < parmLayout->numBindings; i++ )
+	{
+		const ksGpuProgramParm * binding = parmLayout->bindings[i];
 
-				imageInfo[numWrites].sampler = VK_NULL_HANDLE;
-				imageInfo[numWrites].imageView = texture->view;
-				imageInfo[numWrites].imageLayout = texture->imageLayout;
-			}
-			else if ( binding->type == KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM )
-			{
-				const ksGpuBuffer * buffer = (const ksGpuBuffer *)parms->parms[binding->index];
-				assert( buffer->type == KS_GPU_BUFFER_TYPE_UNIFORM );
+		writes[numWrites].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writes[numWrites].pNext = NULL;
+		writes[numWrites].dstSet = descriptorSet;
+		writes[numWrites].dstBinding = binding->binding;
+		writes[numWrites].dstArrayElement = 0;
+		writes[numWrites].descriptorCount = 1;
+		writes[numWrites].descriptorType = ksGpuProgramParm_GetDescriptorType( parmLayout->bindings[i]->type );
+		writes[numWrites].pImageInfo = &imageInfo[numWrites];
+		writes[numWrites].pBufferInfo = &bufferInfo[numWrites];
+		writes[numWrites].pTexelBufferView = NULL;
 
-				bufferInfo[numWrites].buffer = buffer->buffer;
-				bufferInfo[numWrites].offset = 0;
-				bufferInfo[numWrites].range = buffer->size;
-			}
-			else if ( binding->type == KS_GPU_PROGRAM_PARM_TYPE_BUFFER_STORAGE )
-			{
-				const ksGpuBuffer * buffer = (const ksGpuBuffer *)parms->parms[binding->index];
-				assert( buffer->type == KS_GPU_BUFFER_TYPE_STORAGE );
+		if ( binding->type == KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED )
+		{
+			const ksGpuTexture * texture = (const ksGpuTexture *)parms->parms[binding->index];
+			assert( texture->usage == KS_GPU_TEXTURE_USAGE_SAMPLED );
+			assert( texture->imageLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL );
 
-				bufferInfo[numWrites].buffer = buffer->buffer;
-				bufferInfo[numWrites].offset = 0;
-				bufferInfo[numWrites].range = buffer->size;
-			}
+			imageInfo[numWrites].sampler = texture->sampler;
+			imageInfo[numWrites].imageView = texture->view;
+			imageInfo[numWrites].imageLayout = texture->imageLayout;
+		}
+		else if ( binding->type == KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_STORAGE )
+		{
+			const ksGpuTexture * texture = (const ksGpuTexture *)parms->parms[binding->index];
+			assert( texture->usage == KS_GPU_TEXTURE_USAGE_STORAGE );
+			assert( texture->imageLayout == VK_IMAGE_LAYOUT_GENERAL );
 
-			numWrites++;
+			imageInfo[numWrites].sampler = VK_NULL_HANDLE;
+			imageInfo[numWrites].imageView = texture->view;
+			imageInfo[numWrites].imageLayout = texture->imageLayout;
 		}
+		else if ( binding->type == KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM )
+		{
+			const ksGpuBuffer * buffer = (const ksGpuBuffer *)parms->parms[binding->index];
+			assert( buffer->type == KS_GPU_BUFFER_TYPE_UNIFORM );
 
-		if ( numWrites > 0 )
+			bufferInfo[numWrites].buffer = buffer->buffer;
+			bufferInfo[numWrites].offset = 0;
+			bufferInfo[numWrites].range = buffer->size;
+		}
+		else if ( binding->type == KS_GPU_PROGRAM_PARM_TYPE_BUFFER_STORAGE )
 		{
-			VC( context->device->vkUpdateDescriptorSets( context->device->device, numWrites, writes, 0, NULL ) );
+			const ksGpuBuffer * buffer = (const ksGpuBuffer *)parms->parms[binding->index];
+			assert( buffer->type == KS_GPU_BUFFER_TYPE_STORAGE || buffer->type == KS_GPU_BUFFER_TYPE_INDIRECT );
+
+			bufferInfo[numWrites].buffer = buffer->buffer;
+			bufferInfo[numWrites].offset = 0;
+			bufferInfo[numWrites].range = buffer->size;
 		}
+
+		numWrites++;
+	}
+
+	if ( numWrites > 0 )
+	{
+		VC( context->device->vkUpdateDescriptorSets( context->device->device, numWrites, writes, 0, NULL ) );
 	}
 }
 
-static void ksGpuPipelineResources_Destroy( ksGpuContext * context, ksGpuPipelineResources * resources )
+static void ksGpuContext_GetDescriptorSetCallbacks( ksGpuContext * context, ksGpuDescriptorSetCallbacks * callbacks )
 {
-	VC( context->device->vkFreeDescriptorSets( context->device->device, resources->descriptorPool, 1, &resources->descriptorSet ) );
-	VC( context->device->vkDestroyDescriptorPool( context->device->device, resources->descriptorPool, VK_ALLOCATOR ) );
-
-	memset( resources, 0, sizeof( ksGpuPipelineResources ) );
+	callbacks->userData = context;
+	callbacks->createPool = ksGpuContext_CreateDescriptorPool;
+	callbacks->destroyPool = ksGpuContext_DestroyDescriptorPool;
+	callbacks->resetPool = ksGpuContext_ResetDescriptorPool;
+	callbacks->allocateSet = ksGpuContext_AllocateDescriptorSet;
+	callbacks->updateSet = ksGpuContext_UpdateDescriptorSet;
 }
 
 /*
@@ -9892,6 +10477,18 @@ For optimal performance a command buffer should only be created at load time, no
 When a command is submitted, the state of the command is compared with the currently saved state,
 and only the state that has changed translates into graphics API function calls.
 
+Each buffer of a command buffer owns a large persistently mapped host visible buffer. Mapping a
+buffer sub-allocates a range from this buffer with the linear allocator from gpu/gpu_linear_allocator.h
+and returns a ksGpuBuffer that describes the range. The linear allocator is reset when the buffer
+is reused, which only happens after the fence of the command buffer has signaled. Mapping therefore
+does not create any graphics API objects. The n-th map of a frame reuses the range description of
+the n-th map of the last frame, so when the same buffers are mapped in the same order, a map does
+not search or allocate anything. Buffers are bound with dynamic offsets, so the descriptor sets of
+the mapped ranges are reused from frame to frame. A mapped range that is unmapped with
+KS_GPU_BUFFER_UNMAP_TYPE_USE_ALLOCATED can be bound directly until the command buffer is reused.
+If the mapped memory runs out during a frame, then a separate buffer is created and the mapped
+memory grows when it is next reused.
+
 ksGpuCommandBuffer
 ksGpuCommandBufferType
 ksGpuBufferUnmapType
@@ -9908,6 +10505,7 @@ static void ksGpuCommandBuffer_EndSecondary( ksGpuCommandBuffer * commandBuffer
 static void ksGpuCommandBuffer_SubmitSecondary( ksGpuCommandBuffer * commandBuffer, ksGpuCommandBuffer * primary );
 
 static void ksGpuCommandBuffer_ChangeTextureUsage( ksGpuCommandBuffer * commandBuffer, ksGpuTexture * texture, const ksGpuTextureUsage usage );
+static void ksGpuCommandBuffer_ChangeBufferUsage( ksGpuCommandBuffer * commandBuffer, ksGpuBuffer * buffer, const ksGpuBufferUsage usage );
 
 static void ksGpuCommandBuffer_BeginFramebuffer( ksGpuCommandBuffer * commandBuffer, ksGpuFramebuffer * framebuffer, const int arrayLayer, const ksGpuTextureUsage usage );
 static void ksGpuCommandBuffer_EndFramebuffer( ksGpuCommandBuffer * commandBuffer, ksGpuFramebuffer * framebuffer, const int arrayLayer, const ksGpuTextureUsage usage );
@@ -9949,6 +10547,20 @@ typedef enum
 	KS_GPU_COMMAND_BUFFER_TYPE_SECONDARY_CONTINUE_RENDER_PASS
 } ksGpuCommandBufferType;
 
+#include "gpu/gpu_linear_allocator.h"
+
+typedef struct
+{
+	VkBuffer				buffer;
+	ksGpuMemoryAllocation	allocation;
+	ksGpuLinearAllocator	allocator;
+	ksGpuBuffer **			ranges;				// range descriptions in map order
+	int						rangeCount;			// number of ranges mapped since the last reset
+	int						rangeCapacity;
+	ksGpuBuffer *			retiredRanges;		// replaced ranges that cached descriptor sets may still refer to
+	ksGpuBuffer *			separateBuffers;	// buffers created because the memory ran out
+} ksGpuMappedMemory;
+
 #define MAX_COMMAND_BUFFER_TIMERS	16
 
 typedef struct
@@ -9956,12 +10568,13 @@ typedef struct
 	ksGpuCommandBufferType		type;
 	int							numBuffers;
 	int							currentBuffer;
+	VkCommandPool				commandPool;		// own pool so command buffers can be recorded on different threads
 	VkCommandBuffer *			cmdBuffers;
 	ksGpuContext *				context;
 	ksGpuFence *				fences;
-	ksGpuBuffer **				mappedBuffers;
-	ksGpuBuffer **				oldMappedBuffers;
-	ksGpuPipelineResources **	pipelineResources;
+	ksGpuMappedMemory *			mappedMemory;
+	VkDeviceSize				mappedMemoryAlignment;
+	ksGpuDescriptorSetCache *	descriptorSetCaches;
 	ksGpuSwapchainBuffer *		swapchainBuffer;
 	ksGpuGraphicsCommand		currentGraphicsState;
 	ksGpuComputeCommand			currentComputeState;
@@ -9973,6 +10586,7 @@ typedef struct
 
 #define MAX_VERTEX_BUFFER_UNUSED_COUNT			16
 #define MAX_PIPELINE_RESOURCES_UNUSED_COUNT		16
+#define MIN_MAPPED_MEMORY_SIZE					( 256 * 1024 )	// grown after a frame that needed more
 
 static void ksGpuCommandBuffer_Create( ksGpuContext * context, ksGpuCommandBuffer * commandBuffer, const ksGpuCommandBufferType type, const int numBuffers )
 {
@@ -9984,16 +10598,31 @@ static void ksGpuCommandBuffer_Create( ksGpuContext * context, ksGpuCommandBuffe
 	commandBuffer->context = context;
 	commandBuffer->cmdBuffers = (VkCommandBuffer *) malloc( numBuffers * sizeof( VkCommandBuffer ) );
 	commandBuffer->fences = (ksGpuFence *) malloc( numBuffers * sizeof( ksGpuFence ) );
-	commandBuffer->mappedBuffers = (ksGpuBuffer **) malloc( numBuffers * sizeof( ksGpuBuffer * ) );
-	commandBuffer->oldMappedBuffers = (ksGpuBuffer **) malloc( numBuffers * sizeof( ksGpuBuffer * ) );
-	commandBuffer->pipelineResources = (ksGpuPipelineResources **) malloc( numBuffers * sizeof( ksGpuPipelineResources * ) );
+	commandBuffer->mappedMemory = (ksGpuMappedMemory *) malloc( numBuffers * sizeof( ksGpuMappedMemory ) );
+
+	// Mapped ranges may be bound as any type of buffer and are flushed individually.
+	const VkPhysicalDeviceLimits * limits = &context->device->physicalDeviceProperties.limits;
+	commandBuffer->mappedMemoryAlignment = MAX( MAX( limits->minUniformBufferOffsetAlignment, limits->minStorageBufferOffsetAlignment ),
+												MAX( limits->nonCoherentAtomSize, 16 ) );
+	commandBuffer->descriptorSetCaches = (ksGpuDescriptorSetCache *) malloc( numBuffers * sizeof( ksGpuDescriptorSetCache ) );
+
+	ksGpuDescriptorSetCallbacks descriptorSetCallbacks;
+	ksGpuContext_GetDescriptorSetCallbacks( context, &descriptorSetCallbacks );
+
+	VkCommandPoolCreateInfo commandPoolCreateInfo;
+	commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	commandPoolCreateInfo.pNext = NULL;
+	commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	commandPoolCreateInfo.queueFamilyIndex = context->queueFamilyIndex;
+
+	VK( context->device->vkCreateCommandPool( context->device->device, &commandPoolCreateInfo, VK_ALLOCATOR, &commandBuffer->commandPool ) );
 
 	for ( int i = 0; i < numBuffers; i++ )
 	{
 		VkCommandBufferAllocateInfo commandBufferAllocateInfo;
 		commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
 		commandBufferAllocateInfo.pNext = NULL;
-		commandBufferAllocateInfo.commandPool = context->commandPool;
+		commandBufferAllocateInfo.commandPool = commandBuffer->commandPool;
 		commandBufferAllocateInfo.level = ( type == KS_GPU_COMMAND_BUFFER_TYPE_PRIMARY ) ?
 												VK_COMMAND_BUFFER_LEVEL_PRIMARY :
 												VK_COMMAND_BUFFER_LEVEL_SECONDARY;
@@ -10003,50 +10632,111 @@ static void ksGpuCommandBuffer_Create( ksGpuContext * context, ksGpuCommandBuffe
 
 		ksGpuFence_Create( context, &commandBuffer->fences[i] );
 
-		commandBuffer->mappedBuffers[i] = NULL;
-		commandBuffer->oldMappedBuffers[i] = NULL;
-		commandBuffer->pipelineResources[i] = NULL;
+		memset( &commandBuffer->mappedMemory[i], 0, sizeof( ksGpuMappedMemory ) );
+		ksGpuDescriptorSetCache_Create( &commandBuffer->descriptorSetCaches[i], &descriptorSetCallbacks );
+	}
+}
+
+static void ksGpuCommandBuffer_CreateMappedMemory( ksGpuCommandBuffer * commandBuffer, ksGpuMappedMemory * mappedMemory, const VkDeviceSize size )
+{
+	ksGpuDevice * device = commandBuffer->context->device;
+
+	VkBufferCreateInfo bufferCreateInfo;
+	bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferCreateInfo.pNext = NULL;
+	bufferCreateInfo.flags = 0;
+	bufferCreateInfo.size = size;
+	bufferCreateInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+								VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+								VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	bufferCreateInfo.queueFamilyIndexCount = 0;
+	bufferCreateInfo.pQueueFamilyIndices = NULL;
+
+	VK( device->vkCreateBuffer( device->device, &bufferCreateInfo, VK_ALLOCATOR, &mappedMemory->buffer ) );
+
+	VkMemoryRequirements memoryRequirements;
+	VC( device->vkGetBufferMemoryRequirements( device->device, mappedMemory->buffer, &memoryRequirements ) );
+
+	ksGpuMemoryAllocator_Allocate( &device->memoryAllocator, &mappedMemory->allocation, &memoryRequirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, false );
+
+	VK( device->vkBindBufferMemory( device->device, mappedMemory->buffer, mappedMemory->allocation.memory, mappedMemory->allocation.offset ) );
+
+	ksGpuLinearAllocator_Init( &mappedMemory->allocator, size );
+}
+
+static void ksGpuCommandBuffer_FreeSeparateBuffers( ksGpuCommandBuffer * commandBuffer, ksGpuMappedMemory * mappedMemory )
+{
+	for ( ksGpuBuffer * b = mappedMemory->separateBuffers, * next = NULL; b != NULL; b = next )
+	{
+		next = b->next;
+		ksGpuBuffer_Destroy( commandBuffer->context, b );
+		free( b );
+	}
+	mappedMemory->separateBuffers = NULL;
+}
+
+static void ksGpuCommandBuffer_DestroyMappedMemory( ksGpuCommandBuffer * commandBuffer, ksGpuMappedMemory * mappedMemory )
+{
+	ksGpuDevice * device = commandBuffer->context->device;
+
+	ksGpuCommandBuffer_FreeSeparateBuffers( commandBuffer, mappedMemory );
+
+	// The range descriptions do not own any graphics API objects.
+	for ( int i = 0; i < mappedMemory->rangeCapacity; i++ )
+	{
+		free( mappedMemory->ranges[i] );
+	}
+	free( mappedMemory->ranges );
+	for ( ksGpuBuffer * b = mappedMemory->retiredRanges, * next = NULL; b != NULL; b = next )
+	{
+		next = b->next;
+		free( b );
+	}
+
+	if ( mappedMemory->buffer != VK_NULL_HANDLE )
+	{
+		VC( device->vkDestroyBuffer( device->device, mappedMemory->buffer, VK_ALLOCATOR ) );
+		ksGpuMemoryAllocator_Free( &device->memoryAllocator, &mappedMemory->allocation );
 	}
+	memset( mappedMemory, 0, sizeof( ksGpuMappedMemory ) );
 }
 
 static void ksGpuCommandBuffer_Destroy( ksGpuContext * context, ksGpuCommandBuffer * commandBuffer )
 {
 	assert( context == commandBuffer->context );
 
+	int hitCount = 0;
+	int missCount = 0;
+	int recycleCount = 0;
+	int poolCount = 0;
 	for ( int i = 0; i < commandBuffer->numBuffers; i++ )
 	{
-		VC( context->device->vkFreeCommandBuffers( context->device->device, context->commandPool, 1, &commandBuffer->cmdBuffers[i] ) );
+		hitCount += commandBuffer->descriptorSetCaches[i].hitCount;
+		missCount += commandBuffer->descriptorSetCaches[i].missCount;
+		recycleCount += commandBuffer->descriptorSetCaches[i].recycleCount;
+		poolCount += commandBuffer->descriptorSetCaches[i].poolCount;
+	}
+	if ( hitCount + missCount > 0 )
+	{
+		Print( "Descriptor sets     : %d hits, %d misses, %d recycled, %d pools\n", hitCount, missCount, recycleCount, poolCount );
+	}
 
-		ksGpuFence_Destroy( context, &commandBuffer->fences[i] );
+	for ( int i = 0; i < commandBuffer->numBuffers; i++ )
+	{
+		VC( context->device->vkFreeCommandBuffers( context->device->device, commandBuffer->commandPool, 1, &commandBuffer->cmdBuffers[i] ) );
 
-		for ( ksGpuBuffer * b = commandBuffer->mappedBuffers[i], * next = NULL; b != NULL; b = next )
-		{
-			next = b->next;
-			ksGpuBuffer_Destroy( context, b );
-			free( b );
-		}
-		commandBuffer->mappedBuffers[i] = NULL;
+		ksGpuFence_Destroy( context, &commandBuffer->fences[i] );
 
-		for ( ksGpuBuffer * b = commandBuffer->oldMappedBuffers[i], * next = NULL; b != NULL; b = next )
-		{
-			next = b->next;
-			ksGpuBuffer_Destroy( context, b );
-			free( b );
-		}
-		commandBuffer->oldMappedBuffers[i] = NULL;
+		ksGpuCommandBuffer_DestroyMappedMemory( commandBuffer, &commandBuffer->mappedMemory[i] );
 
-		for ( ksGpuPipelineResources * r = commandBuffer->pipelineResources[i], * next = NULL; r != NULL; r = next )
-		{
-			next = r->next;
-			ksGpuPipelineResources_Destroy( context, r );
-			free( r );
-		}
-		commandBuffer->pipelineResources[i] = NULL;
+		ksGpuDescriptorSetCache_Destroy( &commandBuffer->descriptorSetCaches[i] );
 	}
 
-	free( commandBuffer->pipelineResources );
-	free( commandBuffer->oldMappedBuffers );
-	free( commandBuffer->mappedBuffers );
+	VC( context->device->vkDestroyCommandPool( context->device->device, commandBuffer->commandPool, VK_ALLOCATOR ) );
+
+	free( commandBuffer->descriptorSetCaches );
+	free( commandBuffer->mappedMemory );
 	free( commandBuffer->fences );
 	free( commandBuffer->cmdBuffers );
 
@@ -10060,13 +10750,27 @@ static void ksGpuCommandBuffer_ManageBuffers( ksGpuCommandBuffer * commandBuffer
 	//
 
 	{
-		// Free any old buffers that were not reused for a number of frames.
-		for ( ksGpuBuffer ** b = &commandBuffer->oldMappedBuffers[commandBuffer->currentBuffer]; *b != NULL; )
+		ksGpuMappedMemory * mappedMemory = &commandBuffer->mappedMemory[commandBuffer->currentBuffer];
+
+		// Grow the mapped memory if it ran out during the last frame.
+		const VkDeviceSize growSize = ksGpuLinearAllocator_GetGrowSize( &mappedMemory->allocator, MIN_MAPPED_MEMORY_SIZE );
+		if ( growSize != 0 )
 		{
-			if ( (*b)->unusedCount++ >= MAX_VERTEX_BUFFER_UNUSED_COUNT )
+			// All buffers and descriptor sets that reference the old memory must go.
+			ksGpuDescriptorSetCache_Clear( &commandBuffer->descriptorSetCaches[commandBuffer->currentBuffer] );
+
+			ksGpuCommandBuffer_DestroyMappedMemory( commandBuffer, mappedMemory );
+			ksGpuCommandBuffer_CreateMappedMemory( commandBuffer, mappedMemory, growSize );
+		}
+		ksGpuLinearAllocator_Reset( &mappedMemory->allocator );
+		mappedMemory->rangeCount = 0;
+
+		// Free the replaced ranges once the descriptor sets that refer to them have been recycled.
+		for ( ksGpuBuffer ** b = &mappedMemory->retiredRanges; *b != NULL; )
+		{
+			if ( (*b)->unusedCount++ > MAX_PIPELINE_RESOURCES_UNUSED_COUNT )
 			{
 				ksGpuBuffer * next = (*b)->next;
-				ksGpuBuffer_Destroy( commandBuffer->context, *b );
 				free( *b );
 				*b = next;
 			}
@@ -10075,15 +10779,6 @@ static void ksGpuCommandBuffer_ManageBuffers( ksGpuCommandBuffer * commandBuffer
 				b = &(*b)->next;
 			}
 		}
-
-		// Move the last used buffers to the list with old buffers.
-		for ( ksGpuBuffer * b = commandBuffer->mappedBuffers[commandBuffer->currentBuffer], * next = NULL; b != NULL; b = next )
-		{
-			next = b->next;
-			b->next = commandBuffer->oldMappedBuffers[commandBuffer->currentBuffer];
-			commandBuffer->oldMappedBuffers[commandBuffer->currentBuffer] = b;
-		}
-		commandBuffer->mappedBuffers[commandBuffer->currentBuffer] = NULL;
 	}
 
 	//
@@ -10091,21 +10786,8 @@ static void ksGpuCommandBuffer_ManageBuffers( ksGpuCommandBuffer * commandBuffer
 	//
 
 	{
-		// Free any pipeline resources that were not reused for a number of frames.
-		for ( ksGpuPipelineResources ** r = &commandBuffer->pipelineResources[commandBuffer->currentBuffer]; *r != NULL; )
-		{
-			if ( (*r)->unusedCount++ >= MAX_PIPELINE_RESOURCES_UNUSED_COUNT )
-			{
-				ksGpuPipelineResources * next = (*r)->next;
-				ksGpuPipelineResources_Destroy( commandBuffer->context, *r );
-				free( *r );
-				*r = next;
-			}
-			else
-			{
-				r = &(*r)->next;
-			}
-		}
+		// Recycle the descriptor sets of pipeline resources that were not reused for a number of frames.
+		ksGpuDescriptorSetCache_RemoveUnused( &commandBuffer->descriptorSetCaches[commandBuffer->currentBuffer], MAX_PIPELINE_RESOURCES_UNUSED_COUNT );
 	}
 }
 
@@ -10226,6 +10908,9 @@ static ksGpuFence * ksGpuCommandBuffer_SubmitPrimary( ksGpuCommandBuffer * comma
 	submitInfo.signalSemaphoreCount = ( commandBuffer->swapchainBuffer != NULL ) ? 1 : 0;
 	submitInfo.pSignalSemaphores = ( commandBuffer->swapchainBuffer != NULL ) ? &commandBuffer->swapchainBuffer->renderingCompleteSemaphore : NULL;
 
+	// Any batched resource setup work must execute before this command buffer.
+	ksGpuContext_FlushSetupCmdBuffer( commandBuffer->context );
+
 	ksGpuFence * fence = &commandBuffer->fences[commandBuffer->currentBuffer];
 	VK( device->vkQueueSubmit( commandBuffer->context->queue, 1, &submitInfo, fence->fence ) );
 	ksGpuFence_Submit( commandBuffer->context, fence );
@@ -10300,6 +10985,32 @@ static void ksGpuCommandBuffer_ChangeTextureUsage( ksGpuCommandBuffer * commandB
 	ksGpuTexture_ChangeUsage( commandBuffer->context, commandBuffer->cmdBuffers[commandBuffer->currentBuffer], texture, usage );
 }
 
+static void ksGpuCommandBuffer_ChangeBufferUsage( ksGpuCommandBuffer * commandBuffer, ksGpuBuffer * buffer, const ksGpuBufferUsage usage )
+{
+	assert( commandBuffer->currentRenderPass == NULL );
+	assert( buffer->type == KS_GPU_BUFFER_TYPE_INDIRECT );
+
+	ksGpuDevice * device = commandBuffer->context->device;
+
+	// The buffer alternates between being read as indirect draw commands and being written by a compute program.
+	const bool toStorage = ( usage == KS_GPU_BUFFER_USAGE_STORAGE );
+	const VkPipelineStageFlags srcStageMask = toStorage ? VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT : VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	const VkPipelineStageFlags dstStageMask = toStorage ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT : VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+
+	VkBufferMemoryBarrier bufferMemoryBarrier;
+	bufferMemoryBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	bufferMemoryBarrier.pNext = NULL;
+	bufferMemoryBarrier.srcAccessMask = toStorage ? VK_ACCESS_INDIRECT_COMMAND_READ_BIT : VK_ACCESS_SHADER_WRITE_BIT;
+	bufferMemoryBarrier.dstAccessMask = toStorage ? VK_ACCESS_SHADER_WRITE_BIT : VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+	bufferMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	bufferMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	bufferMemoryBarrier.buffer = buffer->buffer;
+	bufferMemoryBarrier.offset = buffer->offset;
+	bufferMemoryBarrier.size = buffer->size;
+
+	VC( device->vkCmdPipelineBarrier( commandBuffer->cmdBuffers[commandBuffer->currentBuffer], srcStageMask, dstStageMask, 0, 0, NULL, 1, &bufferMemoryBarrier, 0, NULL ) );
+}
+
 static void ksGpuCommandBuffer_BeginFramebuffer( ksGpuCommandBuffer * commandBuffer, ksGpuFramebuffer * framebuffer, const int arrayLayer, const ksGpuTextureUsage usage )
 {
 	assert( commandBuffer->type == KS_GPU_COMMAND_BUFFER_TYPE_PRIMARY );
@@ -10538,32 +11249,24 @@ static void ksGpuCommandBuffer_UpdateProgramParms( ksGpuCommandBuffer * commandB
 	VkCommandBuffer cmdBuffer = commandBuffer->cmdBuffers[commandBuffer->currentBuffer];
 	ksGpuDevice * device = commandBuffer->context->device;
 
-	const bool descriptorsMatch = ksGpuProgramParmState_DescriptorsMatch( newLayout, newParmState, oldLayout, oldParmState );
+	uint32_t newDynamicOffsets[MAX_PROGRAM_PARMS];
+	uint32_t oldDynamicOffsets[MAX_PROGRAM_PARMS];
+	const int dynamicOffsetCount = ksGpuProgramParmState_GetDynamicOffsets( newLayout, newParmState, newDynamicOffsets );
+
+	bool descriptorsMatch = ksGpuProgramParmState_DescriptorsMatch( newLayout, newParmState, oldLayout, oldParmState );
+	if ( descriptorsMatch )
+	{
+		ksGpuProgramParmState_GetDynamicOffsets( oldLayout, oldParmState, oldDynamicOffsets );
+		descriptorsMatch = ( memcmp( newDynamicOffsets, oldDynamicOffsets, dynamicOffsetCount * sizeof( uint32_t ) ) == 0 );
+	}
 	if ( !descriptorsMatch )
 	{
-		// Try to find existing resources that match.
-		ksGpuPipelineResources * resources = NULL;
-		for ( ksGpuPipelineResources * r = commandBuffer->pipelineResources[commandBuffer->currentBuffer]; r != NULL; r = r->next )
-		{
-			if ( ksGpuProgramParmState_DescriptorsMatch( newLayout, newParmState, r->parmLayout, &r->parms ) )
-			{
-				r->unusedCount = 0;
-				resources = r;
-				break;
-			}
-		}
-
-		// Create new resources if none were found.
-		if ( resources == NULL )
-		{
-			resources = (ksGpuPipelineResources *) malloc( sizeof( ksGpuPipelineResources ) );
-			ksGpuPipelineResources_Create( commandBuffer->context, resources, newLayout, newParmState );
-			resources->next = commandBuffer->pipelineResources[commandBuffer->currentBuffer];
-			commandBuffer->pipelineResources[commandBuffer->currentBuffer] = resources;	
-		}
+		// Find existing resources that match or create new resources.
+		ksGpuPipelineResources * resources = ksGpuDescriptorSetCache_Get( &commandBuffer->descriptorSetCaches[commandBuffer->currentBuffer],
+												newLayout, newParmState );
 
 		VC( device->vkCmdBindDescriptorSets( cmdBuffer, bindPoint, newLayout->pipelineLayout,
-										0, 1, &resources->descriptorSet, 0, NULL ) );
+										0, 1, &resources->descriptorSet, dynamicOffsetCount, newDynamicOffsets ) );
 	}
 
 	for ( int i = 0; i < newLayout->numPushConstants; i++ )
@@ -10605,23 +11308,52 @@ static void ksGpuCommandBuffer_SubmitGraphicsCommand( ksGpuCommandBuffer * comma
 	// If the geometry has changed.
 	if ( state->pipeline == NULL || geometry != state->pipeline->geometry || command->vertexBuffer != state->vertexBuffer || command->instanceBuffer != state->instanceBuffer )
 	{
-		const VkBuffer vertexBuffer = ( command->vertexBuffer != NULL ) ? command->vertexBuffer->buffer : geometry->vertexBuffer.buffer;
+		const ksGpuBuffer * vertexBuffer = ( command->vertexBuffer != NULL ) ? command->vertexBuffer : &geometry->vertexBuffer;
 		for ( int i = 0; i < command->pipeline->firstInstanceBinding; i++ )
 		{
-			VC( device->vkCmdBindVertexBuffers( cmdBuffer, i, 1, &vertexBuffer, &command->pipeline->vertexBindingOffsets[i] ) );
+			const VkDeviceSize offset = vertexBuffer->offset + command->pipeline->vertexBindingOffsets[i];
+			VC( device->vkCmdBindVertexBuffers( cmdBuffer, i, 1, &vertexBuffer->buffer, &offset ) );
 		}
 
-		const VkBuffer instanceBuffer = ( command->instanceBuffer != NULL ) ? command->instanceBuffer->buffer : geometry->instanceBuffer.buffer;
+		const ksGpuBuffer * instanceBuffer = ( command->instanceBuffer != NULL ) ? command->instanceBuffer : &geometry->instanceBuffer;
 		for ( int i = command->pipeline->firstInstanceBinding; i < command->pipeline->vertexBindingCount; i++ )
 		{
-			VC( device->vkCmdBindVertexBuffers( cmdBuffer, i, 1, &instanceBuffer, &command->pipeline->vertexBindingOffsets[i] ) );
+			const VkDeviceSize offset = instanceBuffer->offset + command->pipeline->vertexBindingOffsets[i];
+			VC( device->vkCmdBindVertexBuffers( cmdBuffer, i, 1, &instanceBuffer->buffer, &offset ) );
 		}
 
 		const VkIndexType indexType = ( sizeof( ksGpuTriangleIndex ) == sizeof( unsigned int ) ) ? VK_INDEX_TYPE_UINT32 : VK_INDEX_TYPE_UINT16;
 		VC( device->vkCmdBindIndexBuffer( cmdBuffer, geometry->indexBuffer.buffer, 0, indexType ) );
 	}
 
-	VC( device->vkCmdDrawIndexed( cmdBuffer, geometry->indexCount, command->numInstances, 0, 0, 0 ) );
+	if ( command->indirectBuffer != NULL )
+	{
+		assert( command->indirectBuffer->type == KS_GPU_BUFFER_TYPE_INDIRECT );
+		const uint32_t stride = sizeof( ksGpuDrawIndirectCommand );
+		const VkDeviceSize offset = command->indirectBuffer->offset + command->indirectFirstDraw * stride;
+		if ( device->physicalDeviceFeatures.multiDrawIndirect )
+		{
+			// A single call may not exceed the maximum draw count.
+			const uint32_t maxDrawCount = device->physicalDeviceProperties.limits.maxDrawIndirectCount;
+			for ( uint32_t first = 0; first < (uint32_t)command->indirectDrawCount; first += maxDrawCount )
+			{
+				const uint32_t remaining = (uint32_t)command->indirectDrawCount - first;
+				const uint32_t drawCount = ( remaining < maxDrawCount ) ? remaining : maxDrawCount;
+				VC( device->vkCmdDrawIndexedIndirect( cmdBuffer, command->indirectBuffer->buffer, offset + first * stride, drawCount, stride ) );
+			}
+		}
+		else
+		{
+			for ( int i = 0; i < command->indirectDrawCount; i++ )
+			{
+				VC( device->vkCmdDrawIndexedIndirect( cmdBuffer, command->indirectBuffer->buffer, offset + i * stride, 1, stride ) );
+			}
+		}
+	}
+	else
+	{
+		VC( device->vkCmdDrawIndexed( cmdBuffer, geometry->indexCount, command->numInstances, 0, 0, 0 ) );
+	}
 
 	commandBuffer->currentGraphicsState = *command;
 }
@@ -10655,34 +11387,64 @@ static ksGpuBuffer * ksGpuCommandBuffer_MapBuffer( ksGpuCommandBuffer * commandB
 {
 	assert( commandBuffer->currentRenderPass == NULL );
 
-	ksGpuDevice * device = commandBuffer->context->device;
-
-	ksGpuBuffer * newBuffer = NULL;
-	for ( ksGpuBuffer ** b = &commandBuffer->oldMappedBuffers[commandBuffer->currentBuffer]; *b != NULL; b = &(*b)->next )
+	ksGpuMappedMemory * mappedMemory = &commandBuffer->mappedMemory[commandBuffer->currentBuffer];
+	if ( mappedMemory->buffer == VK_NULL_HANDLE )
 	{
-		if ( (*b)->size == buffer->size && (*b)->type == buffer->type )
-		{
-			newBuffer = *b;
-			*b = (*b)->next;
-			break;
-		}
+		ksGpuCommandBuffer_CreateMappedMemory( commandBuffer, mappedMemory, MIN_MAPPED_MEMORY_SIZE );
 	}
-	if ( newBuffer == NULL )
+
+	VkDeviceSize offset = 0;
+	if ( !ksGpuLinearAllocator_Allocate( &mappedMemory->allocator, buffer->size, commandBuffer->mappedMemoryAlignment, &offset ) )
 	{
-		newBuffer = (ksGpuBuffer *) malloc( sizeof( ksGpuBuffer ) );
+		// Out of mapped memory for this frame so fall back to a separate buffer.
+		ksGpuBuffer * newBuffer = (ksGpuBuffer *) malloc( sizeof( ksGpuBuffer ) );
 		ksGpuBuffer_Create( commandBuffer->context, newBuffer, buffer->type, buffer->size, NULL, true );
+		newBuffer->next = mappedMemory->separateBuffers;
+		mappedMemory->separateBuffers = newBuffer;
+
+		// Host visible buffers are persistently mapped by the memory allocator.
+		newBuffer->mapped = newBuffer->allocation.mapped;
+
+		*data = newBuffer->mapped;
+		return newBuffer;
+	}
+
+	if ( mappedMemory->rangeCount >= mappedMemory->rangeCapacity )
+	{
+		const int newCapacity = ( mappedMemory->rangeCapacity > 0 ) ? mappedMemory->rangeCapacity * 2 : 16;
+		mappedMemory->ranges = (ksGpuBuffer **) realloc( mappedMemory->ranges, newCapacity * sizeof( ksGpuBuffer * ) );
+		memset( mappedMemory->ranges + mappedMemory->rangeCapacity, 0, ( newCapacity - mappedMemory->rangeCapacity ) * sizeof( ksGpuBuffer * ) );
+		mappedMemory->rangeCapacity = newCapacity;
 	}
 
-	newBuffer->unusedCount = 0;
-	newBuffer->next = commandBuffer->mappedBuffers[commandBuffer->currentBuffer];
-	commandBuffer->mappedBuffers[commandBuffer->currentBuffer] = newBuffer;
+	// Reuse the range description of the map with the same index in the last frame.
+	ksGpuBuffer ** range = &mappedMemory->ranges[mappedMemory->rangeCount++];
+	if ( *range != NULL && ( (*range)->size != buffer->size || (*range)->type != buffer->type ) )
+	{
+		// Cached descriptor sets describe the old size, so the old range is kept until they are recycled.
+		(*range)->unusedCount = 0;
+		(*range)->next = mappedMemory->retiredRanges;
+		mappedMemory->retiredRanges = *range;
+		*range = NULL;
+	}
+	if ( *range == NULL )
+	{
+		*range = (ksGpuBuffer *) malloc( sizeof( ksGpuBuffer ) );
+		memset( *range, 0, sizeof( ksGpuBuffer ) );
+		(*range)->type = buffer->type;
+		(*range)->size = buffer->size;
+		(*range)->flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+		(*range)->buffer = mappedMemory->buffer;
+		(*range)->allocation = mappedMemory->allocation;
+		(*range)->owner = false;
+	}
 
-	assert( newBuffer->mapped == NULL );
-	VK( device->vkMapMemory( commandBuffer->context->device->device, newBuffer->memory, 0, newBuffer->size, 0, &newBuffer->mapped ) );
+	(*range)->offset = offset;
+	(*range)->mapped = (uint8_t *)mappedMemory->allocation.mapped + offset;
 
-	*data = newBuffer->mapped;
+	*data = (*range)->mapped;
 
-	return newBuffer;
+	return *range;
 }
 
 static void ksGpuCommandBuffer_UnmapBuffer( ksGpuCommandBuffer * commandBuffer, ksGpuBuffer * buffer, ksGpuBuffer * mappedBuffer, const ksGpuBufferUnmapType type )
@@ -10692,7 +11454,17 @@ static void ksGpuCommandBuffer_UnmapBuffer( ksGpuCommandBuffer * commandBuffer,
 
 	ksGpuDevice * device = commandBuffer->context->device;
 
-	VC( device->vkUnmapMemory( commandBuffer->context->device->device, mappedBuffer->memory ) );
+	// Ranges of the mapped memory start at a multiple of the non-coherent atom size.
+	const VkDeviceSize atomSize = device->physicalDeviceProperties.limits.nonCoherentAtomSize;
+	const VkDeviceSize flushSize = ( mappedBuffer->size + atomSize - 1 ) & ~( atomSize - 1 );
+
+	VkMappedMemoryRange mappedMemoryRange;
+	mappedMemoryRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+	mappedMemoryRange.pNext = NULL;
+	mappedMemoryRange.memory = mappedBuffer->allocation.memory;
+	mappedMemoryRange.offset = mappedBuffer->allocation.offset + mappedBuffer->offset;
+	mappedMemoryRange.size = MIN( flushSize, mappedBuffer->allocation.size - mappedBuffer->offset );
+	VC( device->vkFlushMappedMemoryRanges( device->device, 1, &mappedMemoryRange ) );
 	mappedBuffer->mapped = NULL;
 
 	// Optionally copy the mapped buffer back to the original buffer. While the copy is not for free,
@@ -10732,7 +11504,7 @@ static void ksGpuCommandBuffer_UnmapBuffer( ksGpuCommandBuffer * commandBuffer,
 			bufferMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 			bufferMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 			bufferMemoryBarrier.buffer = mappedBuffer->buffer;
-			bufferMemoryBarrier.offset = 0;
+			bufferMemoryBarrier.offset = mappedBuffer->offset;
 			bufferMemoryBarrier.size = mappedBuffer->size;
 
 			const VkPipelineStageFlags src_stages = VK_PIPELINE_STAGE_HOST_BIT;
@@ -10746,7 +11518,7 @@ static void ksGpuCommandBuffer_UnmapBuffer( ksGpuCommandBuffer * commandBuffer,
 		{
 			// Copy back to the original buffer.
 			VkBufferCopy bufferCopy;
-			bufferCopy.srcOffset = 0;
+			bufferCopy.srcOffset = mappedBuffer->offset;
 			bufferCopy.dstOffset = 0;
 			bufferCopy.size = buffer->size;
 
@@ -10786,7 +11558,7 @@ static void ksGpuCommandBuffer_UnmapBuffer( ksGpuCommandBuffer * commandBuffer,
 			bufferMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 			bufferMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 			bufferMemoryBarrier.buffer = mappedBuffer->buffer;
-			bufferMemoryBarrier.offset = 0;
+			bufferMemoryBarrier.offset = mappedBuffer->offset;
 			bufferMemoryBarrier.size = mappedBuffer->size;
 
 			const VkPipelineStageFlags src_stages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
@@ -13999,6 +14771,9 @@ typedef struct
 	int							triangleLevel;
 	int							fragmentLevel;
 	bool						useMultiView;
+	bool						useInstancing;
+	bool						useIndirect;
+	int							recordThreadCount;
 	bool						correctChromaticAberration;
 	bool						hideGraphs;
 	ksTimeWarpImplementation	timeWarpImplementation;
@@ -14058,11 +14833,61 @@ typedef struct
 	ksTimeWarp *			timeWarp;
 	ksSceneSettings *		sceneSettings;
 	ksGpuWindowInput *		input;
+	int						recordThreadCount;	// number of threads that record the scene into secondary command buffers
 
 	volatile bool			terminate;
 	volatile bool			openFrameLog;
 } ksSceneThreadData;
 
+// The perf scene or glTF scene is split into one part per record thread and each
+// part is recorded into its own secondary command buffer by one of the workers.
+typedef struct
+{
+	ksGpuCommandBuffer *	commandBuffers;		// one secondary command buffer per part
+	ksGpuRenderPass *		renderPass;
+	ksScreenRect			rect;
+	const ksPerfScene *		perfScene;			// either the perf scene or the glTF scene is recorded
+	const ksGltfScene *		gltfScene;
+	const ksViewState *		viewState;
+	int						partCount;
+	ksAtomicUint32			nextPart;			// atomic counter shared by all workers
+} ksSceneRecordJobs;
+
+static void SceneThread_RecordJobThread( void * data )
+{
+	ksSceneRecordJobs * jobs = (ksSceneRecordJobs *)data;
+
+	// Loop until no more parts to record.
+	for ( ; ; )
+	{
+		// Atomically add 1 to claim a part.
+		const unsigned int part = ksAtomicUint32_Increment( &jobs->nextPart ) - 1;
+
+		// Done when all parts have been claimed for recording.
+		if ( part >= (unsigned int)jobs->partCount )
+		{
+			break;
+		}
+
+		ksGpuCommandBuffer * commandBuffer = &jobs->commandBuffers[part];
+		ksGpuCommandBuffer_BeginSecondary( commandBuffer, jobs->renderPass, NULL );
+
+		ksGpuCommandBuffer_SetViewport( commandBuffer, &jobs->rect );
+		ksGpuCommandBuffer_SetScissor( commandBuffer, &jobs->rect );
+
+		if ( jobs->gltfScene == NULL )
+		{
+			ksPerfScene_RenderPart( commandBuffer, jobs->perfScene, jobs->viewState, (int)part, jobs->partCount );
+		}
+		else
+		{
+			ksGltfScene_RenderPart( commandBuffer, jobs->gltfScene, jobs->viewState, (int)part, jobs->partCount );
+		}
+
+		ksGpuCommandBuffer_EndSecondary( commandBuffer );
+	}
+}
+
 void SceneThread_Render( ksSceneThreadData * threadData )
 {
 	ksThread_SetAffinity( THREAD_AFFINITY_BIG_CORES );
@@ -14101,6 +14926,25 @@ void SceneThread_Render( ksSceneThreadData * threadData )
 	ksGpuCommandBuffer sceneCommandBuffer;
 	ksGpuCommandBuffer_Create( &context, &sceneCommandBuffer, KS_GPU_COMMAND_BUFFER_TYPE_SECONDARY_CONTINUE_RENDER_PASS, NUM_EYE_BUFFERS );
 
+	// Optionally record the scene on multiple threads, each with its own secondary command buffer and command pool.
+	const bool recordOnWorkers = ( threadData->recordThreadCount > 1 );
+	const int recordPartCount = recordOnWorkers ? threadData->recordThreadCount : 0;
+	ksGpuCommandBuffer recordCommandBuffers[NUM_EYES][MAX_WORKERS];
+	ksThreadPool recordThreadPool;
+	ksSceneRecordJobs recordJobs;
+	memset( &recordJobs, 0, sizeof( recordJobs ) );
+	if ( recordOnWorkers )
+	{
+		for ( int eye = 0; eye < NUM_EYES; eye++ )
+		{
+			for ( int part = 0; part < recordPartCount; part++ )
+			{
+				ksGpuCommandBuffer_Create( &context, &recordCommandBuffers[eye][part], KS_GPU_COMMAND_BUFFER_TYPE_SECONDARY_CONTINUE_RENDER_PASS, NUM_EYE_BUFFERS );
+			}
+		}
+		ksThreadPool_Create( &recordThreadPool, recordPartCount );
+	}
+
 	const ksBodyInfo * bodyInfo = GetDefaultBodyInfo();
 
 	ksViewState viewState;
@@ -14118,6 +14962,12 @@ void SceneThread_Render( ksSceneThreadData * threadData )
 		ksGltfScene_CreateFromFile( &context, &gltfScene, threadData->sceneSettings, &renderPassSingleView );
 	}
 
+	recordJobs.renderPass = &renderPassMultiView;
+	recordJobs.perfScene = &perfScene;
+	recordJobs.gltfScene = ( threadData->sceneSettings->glTF != NULL ) ? &gltfScene : NULL;
+	recordJobs.viewState = &viewState;
+	recordJobs.partCount = recordPartCount;
+
 	ksSignal_Raise( &threadData->initialized );
 
 	for ( int frameIndex = 0; !threadData->terminate; frameIndex++ )
@@ -14143,26 +14993,6 @@ void SceneThread_Render( ksSceneThreadData * threadData )
 
 		const ksNanoseconds t0 = GetTimeNanoseconds();
 
-		if ( threadData->sceneSettings->useMultiView )
-		{
-			const ksScreenRect sceneRect = { 0, 0, resolution, resolution };
-			ksGpuCommandBuffer_BeginSecondary( &sceneCommandBuffer, &renderPassMultiView, NULL );
-
-			ksGpuCommandBuffer_SetViewport( &sceneCommandBuffer, &sceneRect );
-			ksGpuCommandBuffer_SetScissor( &sceneCommandBuffer, &sceneRect );
-
-			if ( threadData->sceneSettings->glTF == NULL )
-			{
-				ksPerfScene_Render( &sceneCommandBuffer, &perfScene, &viewState );
-			}
-			else
-			{
-				ksGltfScene_Render( &sceneCommandBuffer, &gltfScene, &viewState );
-			}
-
-			ksGpuCommandBuffer_EndSecondary( &sceneCommandBuffer );
-		}
-
 		ksGpuTexture * eyeTexture[NUM_EYES] = { 0 };
 		ksGpuFence * eyeCompletionFence[NUM_EYES] = { 0 };
 		int eyeArrayLayer[NUM_EYES] = { 0, 1 };
@@ -14183,12 +15013,54 @@ void SceneThread_Render( ksSceneThreadData * threadData )
 				ksGltfScene_UpdateBuffers( &eyeCommandBuffer[eye], &gltfScene, &viewState, eye );
 			}
 
-			ksGpuRenderPass * renderPass = threadData->sceneSettings->useMultiView ? &renderPassMultiView : &renderPassSingleView;
+			// The scene is recorded after the buffers are updated, because the draw list is built while updating the buffers.
+			if ( recordOnWorkers && ( !threadData->sceneSettings->useMultiView || eye == 0 ) )
+			{
+				recordJobs.commandBuffers = recordCommandBuffers[eye];
+				recordJobs.rect.x = 0;
+				recordJobs.rect.y = 0;
+				recordJobs.rect.width = resolution;
+				recordJobs.rect.height = resolution;
+				recordJobs.nextPart = 0;
+
+				ksThreadPool_Submit( &recordThreadPool, SceneThread_RecordJobThread, &recordJobs );
+				ksThreadPool_Join( &recordThreadPool );
+			}
+			else if ( threadData->sceneSettings->useMultiView && eye == 0 )
+			{
+				const ksScreenRect sceneRect = { 0, 0, resolution, resolution };
+				ksGpuCommandBuffer_BeginSecondary( &sceneCommandBuffer, &renderPassMultiView, NULL );
+
+				ksGpuCommandBuffer_SetViewport( &sceneCommandBuffer, &sceneRect );
+				ksGpuCommandBuffer_SetScissor( &sceneCommandBuffer, &sceneRect );
+
+				if ( threadData->sceneSettings->glTF == NULL )
+				{
+					ksPerfScene_Render( &sceneCommandBuffer, &perfScene, &viewState );
+				}
+				else
+				{
+					ksGltfScene_Render( &sceneCommandBuffer, &gltfScene, &viewState );
+				}
+
+				ksGpuCommandBuffer_EndSecondary( &sceneCommandBuffer );
+			}
+
+			// The multi-view render pass executes secondary command buffers.
+			ksGpuRenderPass * renderPass = ( threadData->sceneSettings->useMultiView || recordOnWorkers ) ? &renderPassMultiView : &renderPassSingleView;
 
 			ksGpuCommandBuffer_BeginTimer( &eyeCommandBuffer[eye], &eyeTimer[eye] );
 			ksGpuCommandBuffer_BeginRenderPass( &eyeCommandBuffer[eye], renderPass, &framebuffer, &screenRect );
 
-			if ( threadData->sceneSettings->useMultiView )
+			if ( recordOnWorkers )
+			{
+				const int recordEye = threadData->sceneSettings->useMultiView ? 0 : eye;
+				for ( int part = 0; part < recordPartCount; part++ )
+				{
+					ksGpuCommandBuffer_SubmitSecondary( &recordCommandBuffers[recordEye][part], &eyeCommandBuffer[eye] );
+				}
+			}
+			else if ( threadData->sceneSettings->useMultiView )
 			{
 				ksGpuCommandBuffer_SubmitSecondary( &sceneCommandBuffer, &eyeCommandBuffer[eye] );
 			}
@@ -14241,6 +15113,18 @@ void SceneThread_Render( ksSceneThreadData * threadData )
 		ksGltfScene_Destroy( &context, &gltfScene );
 	}
 
+	if ( recordOnWorkers )
+	{
+		ksThreadPool_Destroy( &recordThreadPool );
+		for ( int eye = 0; eye < NUM_EYES; eye++ )
+		{
+			for ( int part = 0; part < recordPartCount; part++ )
+			{
+				ksGpuCommandBuffer_Destroy( &context, &recordCommandBuffers[eye][part] );
+			}
+		}
+	}
+
 	ksGpuCommandBuffer_Destroy( &context, &sceneCommandBuffer );
 
 	for ( int eye = 0; eye < NUM_EYES; eye++ )
@@ -14256,13 +15140,15 @@ void SceneThread_Render( ksSceneThreadData * threadData )
 }
 
 void SceneThread_Create( ksThread * sceneThread, ksSceneThreadData * sceneThreadData,
-							ksGpuWindow * window, ksTimeWarp * timeWarp, ksSceneSettings * sceneSettings )
+							ksGpuWindow * window, ksTimeWarp * timeWarp, ksSceneSettings * sceneSettings,
+							const int recordThreadCount )
 {
 	ksSignal_Create( &sceneThreadData->initialized, true );
 	sceneThreadData->shareContext = &window->context;
 	sceneThreadData->timeWarp = timeWarp;
 	sceneThreadData->sceneSettings = sceneSettings;
 	sceneThreadData->input = &window->input;
+	sceneThreadData->recordThreadCount = recordThreadCount;
 	sceneThreadData->terminate = false;
 	sceneThreadData->openFrameLog = false;
 
@@ -14324,6 +15210,8 @@ bool RenderAsyncTimeWarp( ksStartupSettings * startupSettings )
 	ksSceneSettings_SetGltf( &sceneSettings, startupSettings->glTF );
 	ksSceneSettings_SetSimulationPaused( &sceneSettings, startupSettings->simulationPaused );
 	ksSceneSettings_SetMultiView( &sceneSettings, startupSettings->useMultiView );
+	ksSceneSettings_SetInstancing( &sceneSettings, startupSettings->useInstancing );
+	ksSceneSettings_SetIndirect( &sceneSettings, startupSettings->useIndirect );
 	ksSceneSettings_SetDisplayResolutionLevel( &sceneSettings, startupSettings->displayResolutionLevel );
 	ksSceneSettings_SetEyeImageResolutionLevel( &sceneSettings, startupSettings->eyeImageResolutionLevel );
 	ksSceneSettings_SetEyeImageSamplesLevel( &sceneSettings, startupSettings->eyeImageSamplesLevel );
@@ -14333,7 +15221,7 @@ bool RenderAsyncTimeWarp( ksStartupSettings * startupSettings )
 
 	ksThread sceneThread;
 	ksSceneThreadData sceneThreadData;
-	SceneThread_Create( &sceneThread, &sceneThreadData, &window, &timeWarp, &sceneSettings );
+	SceneThread_Create( &sceneThread, &sceneThreadData, &window, &timeWarp, &sceneSettings, startupSettings->recordThreadCount );
 
 	hmd_headRotationDisabled = startupSettings->headRotationDisabled;
 
@@ -14432,6 +15320,14 @@ bool RenderAsyncTimeWarp( ksStartupSettings * startupSettings )
 			ksSceneSettings_CycleFragmentLevel( &sceneSettings );
 			ksTimeWarp_SetFragmentLevel( &timeWarp, ksSceneSettings_GetFragmentLevel( &sceneSettings ) );
 		}
+		if ( ksGpuWindowInput_ConsumeKeyboardKey( &window.input, KEY_N ) )
+		{
+			ksSceneSettings_ToggleInstancing( &sceneSettings );
+		}
+		if ( ksGpuWindowInput_ConsumeKeyboardKey( &window.input, KEY_J ) )
+		{
+			ksSceneSettings_ToggleIndirect( &sceneSettings );
+		}
 		if ( ksGpuWindowInput_ConsumeKeyboardKey( &window.input, KEY_I ) )
 		{
 			ksTimeWarp_CycleImplementation( &timeWarp );
@@ -14654,6 +15550,8 @@ bool RenderScene( ksStartupSettings * startupSettings )
 	ksSceneSettings sceneSettings;
 	ksSceneSettings_Init( &window.context, &sceneSettings );
 	ksSceneSettings_SetSimulationPaused( &sceneSettings, startupSettings->simulationPaused );
+	ksSceneSettings_SetInstancing( &sceneSettings, startupSettings->useInstancing );
+	ksSceneSettings_SetIndirect( &sceneSettings, startupSettings->useIndirect );
 	ksSceneSettings_SetDisplayResolutionLevel( &sceneSettings, startupSettings->displayResolutionLevel );
 	ksSceneSettings_SetEyeImageResolutionLevel( &sceneSettings, startupSettings->eyeImageResolutionLevel );
 	ksSceneSettings_SetEyeImageSamplesLevel( &sceneSettings, startupSettings->eyeImageSamplesLevel );
@@ -14765,6 +15663,14 @@ bool RenderScene( ksStartupSettings * startupSettings )
 		{
 			ksSceneSettings_CycleFragmentLevel( &sceneSettings );
 		}
+		if ( ksGpuWindowInput_ConsumeKeyboardKey( &window.input, KEY_N ) )
+		{
+			ksSceneSettings_ToggleInstancing( &sceneSettings );
+		}
+		if ( ksGpuWindowInput_ConsumeKeyboardKey( &window.input, KEY_J ) )
+		{
+			ksSceneSettings_ToggleIndirect( &sceneSettings );
+		}
 		if ( ksGpuWindowInput_ConsumeKeyboardKey( &window.input, KEY_D ) )
 		{
 			DumpGLSL();
@@ -14896,6 +15802,9 @@ static int StartApplication( int argc, char * argv[] )
 		else if ( strcmp( arg, "w" ) == 0 && i + 1 < argc )	{ startupSettings.triangleLevel = ksStartupSettings_StringToLevel( argv[++i], MAX_SCENE_TRIANGLE_LEVELS ); }
 		else if ( strcmp( arg, "e" ) == 0 && i + 1 < argc )	{ startupSettings.fragmentLevel = ksStartupSettings_StringToLevel( argv[++i], MAX_SCENE_FRAGMENT_LEVELS ); }
 		else if ( strcmp( arg, "m" ) == 0 && i + 0 < argc )	{ startupSettings.useMultiView = ( atoi( argv[++i] ) != 0 ); }
+		else if ( strcmp( arg, "n" ) == 0 && i + 1 < argc )	{ startupSettings.useInstancing = ( atoi( argv[++i] ) != 0 ); }
+		else if ( strcmp( arg, "j" ) == 0 && i + 1 < argc )	{ startupSettings.useIndirect = ( atoi( argv[++i] ) != 0 ); }
+		else if ( strcmp( arg, "t" ) == 0 && i + 1 < argc )	{ startupSettings.recordThreadCount = ksStartupSettings_StringToLevel( argv[++i], MAX_WORKERS + 1 ); }
 		else if ( strcmp( arg, "c" ) == 0 && i + 1 < argc )	{ startupSettings.correctChromaticAberration = ( atoi( argv[++i] ) != 0 ); }
 		else if ( strcmp( arg, "i" ) == 0 && i + 1 < argc )	{ startupSettings.timeWarpImplementation = (ksTimeWarpImplementation)ksStartupSettings_StringToTimeWarpImplementation( argv[++i] ); }
 		else if ( strcmp( arg, "z" ) == 0 && i + 1 < argc )	{ startupSettings.renderMode = ksStartupSettings_StringToRenderMode( argv[++i] ); }
@@ -14919,6 +15828,9 @@ static int StartApplication( int argc, char * argv[] )
 				   "   -w <0-3>    set per eye triangles per draw call level\n"
 				   "   -e <0-3>    set per eye fragment program complexity level\n"
 				   "   -m <0-1>    enable/disable multi-view\n"
+				   "   -n <0-1>    enable/disable instanced draw calls\n"
+				   "   -j <0-1>    enable/disable indirect draw calls\n"
+				   "   -t <1-8>    set number of threads that record the scene\n"
 				   "   -c <0-1>    enable/disable correction for chromatic aberration\n"
 				   "   -i <name>   set time warp implementation: graphics, compute\n"
 				   "   -z <name>   set the render mode: atw, tw, scene\n"
@@ -14950,6 +15862,9 @@ static int StartApplication( int argc, char * argv[] )
 	Print( "    triangleLevel = %d\n",				startupSettings.triangleLevel );
 	Print( "    fragmentLevel = %d\n",				startupSettings.fragmentLevel );
 	Print( "    useMultiView = %d\n",				startupSettings.useMultiView );
+	Print( "    useInstancing = %d\n",				startupSettings.useInstancing );
+	Print( "    useIndirect = %d\n",				startupSettings.useIndirect );
+	Print( "    recordThreadCount = %d\n",			startupSettings.recordThreadCount );
 	Print( "    correctChromaticAberration = %d\n",	startupSettings.correctChromaticAberration );
 	Print( "    timeWarpImplementation = %d\n",		startupSettings.timeWarpImplementation );
 	Print( "    renderMode = %d\n",					startupSettings.renderMode );
@@ -0,0 +1,357 @@
+/*
+================================================================================================
+
+Description	:	Cache of Vulkan descriptor sets keyed on the bound resources.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+
+DESCRIPTION
+===========
+
+Descriptor sets are cached in a hash table that is keyed on the program parm layout and the
+bound resources. The descriptor sets are allocated from large descriptor pools that are shared
+by all resources in the cache. Resources that have not been used for a number of frames are
+removed from the hash table and their descriptor sets are recycled for new resources with the
+same descriptor set layout. The pools are only released when the cache is cleared or destroyed.
+
+The cache only calls the driver through the descriptor set callbacks. Include it after
+ksGpuProgramParmLayout, ksGpuProgramParmState, ksGpuProgramParm_IsOpaqueBinding() and
+ksGpuProgramParmState_DescriptorsMatch().
+
+INTERFACE
+=========
+
+ksGpuDescriptorSetCallbacks
+ksGpuPipelineResources
+ksGpuDescriptorPool
+ksGpuDescriptorSetCache
+
+static unsigned int ksGpuProgramParmState_DescriptorHash( const ksGpuProgramParmLayout * layout, const ksGpuProgramParmState * parmState );
+
+static void ksGpuDescriptorSetCache_Create( ksGpuDescriptorSetCache * cache, const ksGpuDescriptorSetCallbacks * callbacks );
+static void ksGpuDescriptorSetCache_Destroy( ksGpuDescriptorSetCache * cache );
+static void ksGpuDescriptorSetCache_Clear( ksGpuDescriptorSetCache * cache );
+static ksGpuPipelineResources * ksGpuDescriptorSetCache_Get( ksGpuDescriptorSetCache * cache,
+										const ksGpuProgramParmLayout * parmLayout, const ksGpuProgramParmState * parms );
+static void ksGpuDescriptorSetCache_RemoveUnused( ksGpuDescriptorSetCache * cache, const int maxUnusedCount );
+
+================================================================================================
+*/
+
+#if !defined( KSGPU_DESCRIPTOR_SET_CACHE_H )
+#define KSGPU_DESCRIPTOR_SET_CACHE_H
+
+#define DESCRIPTOR_POOL_MAX_SETS			256									// per pool, and each cache has its own pools
+#define DESCRIPTOR_POOL_MAX_DESCRIPTORS		( 4 * DESCRIPTOR_POOL_MAX_SETS )	// per descriptor type
+#define DESCRIPTOR_POOL_TYPE_COUNT			4									// one descriptor type per opaque parm type
+#define DESCRIPTOR_SET_CACHE_MIN_SIZE		64
+
+typedef struct
+{
+	void *				userData;
+	VkDescriptorPool	(*createPool)( void * userData, const int maxSets, const int maxDescriptorsPerType );
+	void				(*destroyPool)( void * userData, VkDescriptorPool pool );
+	void				(*resetPool)( void * userData, VkDescriptorPool pool );
+	VkDescriptorSet		(*allocateSet)( void * userData, VkDescriptorPool pool, VkDescriptorSetLayout descriptorSetLayout );
+	void				(*updateSet)( void * userData, VkDescriptorSet descriptorSet,
+										const ksGpuProgramParmLayout * parmLayout, const ksGpuProgramParmState * parms );
+} ksGpuDescriptorSetCallbacks;
+
+typedef struct ksGpuPipelineResources_s
+{
+	struct ksGpuPipelineResources_s *	next;
+	int									unusedCount;			// Number of frames these resources have not been used.
+	unsigned int						hash;
+	const ksGpuProgramParmLayout *		parmLayout;
+	ksGpuProgramParmState				parms;
+	VkDescriptorSetLayout				descriptorSetLayout;
+	VkDescriptorSet						descriptorSet;
+} ksGpuPipelineResources;
+
+typedef struct ksGpuDescriptorPool_s
+{
+	struct ksGpuDescriptorPool_s *	next;
+	VkDescriptorPool				pool;
+	int								freeSets;
+	int								freeDescriptors[DESCRIPTOR_POOL_TYPE_COUNT];
+} ksGpuDescriptorPool;
+
+typedef struct
+{
+	ksGpuDescriptorSetCallbacks	callbacks;
+	ksGpuPipelineResources **	table;
+	int							tableSize;			// power of two
+	int							count;
+	ksGpuPipelineResources *	freeResources;		// resources with descriptor sets that can be recycled
+	ksGpuDescriptorPool *		pools;				// new descriptor sets are allocated from the first pool with enough room
+	int							hitCount;
+	int							missCount;
+	int							recycleCount;
+	int							poolCount;
+} ksGpuDescriptorSetCache;
+
+static unsigned int ksGpuProgramParmState_DescriptorHash( const ksGpuProgramParmLayout * layout, const ksGpuProgramParmState * parmState )
+{
+	unsigned int hash = layout->hash;
+	for ( int i = 0; i < layout->numBindings; i++ )
+	{
+		const uint64_t pointer = (uint64_t)(uintptr_t)parmState->parms[layout->bindings[i]->index];
+		hash = ( hash ^ (unsigned int)( pointer ^ ( pointer >> 32 ) ) ) * 16777619u;
+	}
+	// Pointers are aligned, so mix the high bits into the low bits that select the hash table slot.
+	hash ^= hash >> 16;
+	hash *= 0x85EBCA6Bu;
+	hash ^= hash >> 13;
+	return hash;
+}
+
+static void ksGpuDescriptorSetCache_Create( ksGpuDescriptorSetCache * cache, const ksGpuDescriptorSetCallbacks * callbacks )
+{
+	memset( cache, 0, sizeof( ksGpuDescriptorSetCache ) );
+	cache->callbacks = *callbacks;
+}
+
+static void ksGpuDescriptorSetCache_FreeResources( ksGpuDescriptorSetCache * cache )
+{
+	for ( int i = 0; i < cache->tableSize; i++ )
+	{
+		for ( ksGpuPipelineResources * r = cache->table[i], * next = NULL; r != NULL; r = next )
+		{
+			next = r->next;
+			free( r );
+		}
+		cache->table[i] = NULL;
+	}
+	for ( ksGpuPipelineResources * r = cache->freeResources, * next = NULL; r != NULL; r = next )
+	{
+		next = r->next;
+		free( r );
+	}
+	cache->freeResources = NULL;
+	cache->count = 0;
+}
+
+static void ksGpuDescriptorSetCache_Destroy( ksGpuDescriptorSetCache * cache )
+{
+	ksGpuDescriptorSetCache_FreeResources( cache );
+
+	for ( ksGpuDescriptorPool * p = cache->pools, * next = NULL; p != NULL; p = next )
+	{
+		next = p->next;
+		cache->callbacks.destroyPool( cache->callbacks.userData, p->pool );
+		free( p );
+	}
+
+	free( cache->table );
+
+	memset( cache, 0, sizeof( ksGpuDescriptorSetCache ) );
+}
+
+// Frees all descriptor sets but keeps the descriptor pools and the statistics.
+static void ksGpuDescriptorSetCache_Clear( ksGpuDescriptorSetCache * cache )
+{
+	ksGpuDescriptorSetCache_FreeResources( cache );
+
+	for ( ksGpuDescriptorPool * p = cache->pools; p != NULL; p = p->next )
+	{
+		cache->callbacks.resetPool( cache->callbacks.userData, p->pool );
+		p->freeSets = DESCRIPTOR_POOL_MAX_SETS;
+		for ( int i = 0; i < DESCRIPTOR_POOL_TYPE_COUNT; i++ )
+		{
+			p->freeDescriptors[i] = DESCRIPTOR_POOL_MAX_DESCRIPTORS;
+		}
+	}
+}
+
+static ksGpuPipelineResources * ksGpuDescriptorSetCache_Find( ksGpuDescriptorSetCache * cache, const unsigned int hash,
+										const ksGpuProgramParmLayout * parmLayout, const ksGpuProgramParmState * parms )
+{
+	if ( cache->tableSize == 0 )
+	{
+		return NULL;
+	}
+	for ( ksGpuPipelineResources * r = cache->table[hash & ( cache->tableSize - 1 )]; r != NULL; r = r->next )
+	{
+		if ( r->hash == hash && ksGpuProgramParmState_DescriptorsMatch( parmLayout, parms, r->parmLayout, &r->parms ) )
+		{
+			return r;
+		}
+	}
+	return NULL;
+}
+
+static void ksGpuDescriptorSetCache_Insert( ksGpuDescriptorSetCache * cache, ksGpuPipelineResources * resources )
+{
+	if ( cache->count >= cache->tableSize )
+	{
+		const int newTableSize = ( cache->tableSize > 0 ) ? cache->tableSize * 2 : DESCRIPTOR_SET_CACHE_MIN_SIZE;
+		ksGpuPipelineResources ** newTable = (ksGpuPipelineResources **) calloc( newTableSize, sizeof( ksGpuPipelineResources * ) );
+		for ( int i = 0; i < cache->tableSize; i++ )
+		{
+			for ( ksGpuPipelineResources * r = cache->table[i], * next = NULL; r != NULL; r = next )
+			{
+				next = r->next;
+				ksGpuPipelineResources ** slot = &newTable[r->hash & ( newTableSize - 1 )];
+				r->next = *slot;
+				*slot = r;
+			}
+		}
+		free( cache->table );
+		cache->table = newTable;
+		cache->tableSize = newTableSize;
+	}
+
+	ksGpuPipelineResources ** slot = &cache->table[resources->hash & ( cache->tableSize - 1 )];
+	resources->next = *slot;
+	*slot = resources;
+	cache->count++;
+}
+
+// Moves the resources that were not used for a number of frames to the list with recyclable resources.
+static void ksGpuDescriptorSetCache_RemoveUnused( ksGpuDescriptorSetCache * cache, const int maxUnusedCount )
+{
+	for ( int i = 0; i < cache->tableSize; i++ )
+	{
+		for ( ksGpuPipelineResources ** r = &cache->table[i]; *r != NULL; )
+		{
+			if ( (*r)->unusedCount++ >= maxUnusedCount )
+			{
+				ksGpuPipelineResources * unused = *r;
+				*r = unused->next;
+				unused->next = cache->freeResources;
+				cache->freeResources = unused;
+				cache->count--;
+			}
+			else
+			{
+				r = &(*r)->next;
+			}
+		}
+	}
+}
+
+// Returns recyclable resources with a descriptor set of the given layout, or NULL if there are none.
+static ksGpuPipelineResources * ksGpuDescriptorSetCache_TakeUnused( ksGpuDescriptorSetCache * cache, const VkDescriptorSetLayout descriptorSetLayout )
+{
+	for ( ksGpuPipelineResources ** r = &cache->freeResources; *r != NULL; r = &(*r)->next )
+	{
+		if ( (*r)->descriptorSetLayout == descriptorSetLayout )
+		{
+			ksGpuPipelineResources * resources = *r;
+			*r = resources->next;
+			resources->next = NULL;
+			return resources;
+		}
+	}
+	return NULL;
+}
+
+static VkDescriptorSet ksGpuDescriptorSetCache_AllocateDescriptorSet( ksGpuDescriptorSetCache * cache, const ksGpuProgramParmLayout * parmLayout )
+{
+	int descriptorCounts[DESCRIPTOR_POOL_TYPE_COUNT] = { 0 };
+	for ( int i = 0; i < parmLayout->numBindings; i++ )
+	{
+		assert( ksGpuProgramParm_IsOpaqueBinding( parmLayout->bindings[i]->type ) );
+		assert( parmLayout->bindings[i]->type < DESCRIPTOR_POOL_TYPE_COUNT );
+		descriptorCounts[parmLayout->bindings[i]->type]++;
+	}
+
+	// There are only a few pools, and after a clear all of them have room again.
+	ksGpuDescriptorPool * pool = cache->pools;
+	for ( ; pool != NULL; pool = pool->next )
+	{
+		bool fits = ( pool->freeSets > 0 );
+		for ( int i = 0; i < DESCRIPTOR_POOL_TYPE_COUNT && fits; i++ )
+		{
+			fits = ( descriptorCounts[i] <= pool->freeDescriptors[i] );
+		}
+		if ( fits )
+		{
+			break;
+		}
+	}
+
+	if ( pool == NULL )
+	{
+		pool = (ksGpuDescriptorPool *) malloc( sizeof( ksGpuDescriptorPool ) );
+		pool->pool = cache->callbacks.createPool( cache->callbacks.userData, DESCRIPTOR_POOL_MAX_SETS, DESCRIPTOR_POOL_MAX_DESCRIPTORS );
+		pool->freeSets = DESCRIPTOR_POOL_MAX_SETS;
+		for ( int i = 0; i < DESCRIPTOR_POOL_TYPE_COUNT; i++ )
+		{
+			pool->freeDescriptors[i] = DESCRIPTOR_POOL_MAX_DESCRIPTORS;
+		}
+		pool->next = cache->pools;
+		cache->pools = pool;
+		cache->poolCount++;
+	}
+
+	pool->freeSets--;
+	for ( int i = 0; i < DESCRIPTOR_POOL_TYPE_COUNT; i++ )
+	{
+		pool->freeDescriptors[i] -= descriptorCounts[i];
+	}
+
+	return cache->callbacks.allocateSet( cache->callbacks.userData, pool->pool, parmLayout->descriptorSetLayout );
+}
+
+static ksGpuPipelineResources * ksGpuDescriptorSetCache_Get( ksGpuDescriptorSetCache * cache,
+										const ksGpuProgramParmLayout * parmLayout, const ksGpuProgramParmState * parms )
+{
+	const unsigned int hash = ksGpuProgramParmState_DescriptorHash( parmLayout, parms );
+
+	ksGpuPipelineResources * resources = ksGpuDescriptorSetCache_Find( cache, hash, parmLayout, parms );
+	if ( resources != NULL )
+	{
+		resources->unusedCount = 0;
+		cache->hitCount++;
+		return resources;
+	}
+	cache->missCount++;
+
+	// Recycle a descriptor set if possible, otherwise allocate a new one.
+	resources = ksGpuDescriptorSetCache_TakeUnused( cache, parmLayout->descriptorSetLayout );
+	if ( resources != NULL )
+	{
+		cache->recycleCount++;
+	}
+	else
+	{
+		resources = (ksGpuPipelineResources *) malloc( sizeof( ksGpuPipelineResources ) );
+		resources->descriptorSetLayout = parmLayout->descriptorSetLayout;
+		resources->descriptorSet = ksGpuDescriptorSetCache_AllocateDescriptorSet( cache, parmLayout );
+	}
+
+	resources->unusedCount = 0;
+	resources->hash = hash;
+	resources->parmLayout = parmLayout;
+	memcpy( (void *)&resources->parms, parms, sizeof( ksGpuProgramParmState ) );
+
+	cache->callbacks.updateSet( cache->callbacks.userData, resources->descriptorSet, parmLayout, &resources->parms );
+	ksGpuDescriptorSetCache_Insert( cache, resources );
+
+	return resources;
+}
+
+#endif // !KSGPU_DESCRIPTOR_SET_CACHE_H
@@ -0,0 +1,110 @@
+/*
+================================================================================================
+
+Description	:	Per-frame linear allocator for mapped Vulkan buffers.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Every buffer of a command buffer owns one persistently mapped buffer. Mapping a buffer
+sub-allocates a range from it by bumping an offset, and the offset is reset when the
+command buffer is reused after its fence has signaled, so a map is O(1) and never calls
+the graphics API.
+
+When a range does not fit, the allocation fails and the caller falls back to a separate
+buffer for the rest of the frame. The allocator keeps counting the bytes that would have
+been needed, so the memory can grow to fit a whole frame the next time it is reused.
+
+The allocator only keeps offsets.
+
+INTERFACE
+=========
+
+ksGpuLinearAllocator
+
+static void ksGpuLinearAllocator_Init( ksGpuLinearAllocator * allocator, const VkDeviceSize size );
+static void ksGpuLinearAllocator_Reset( ksGpuLinearAllocator * allocator );
+static bool ksGpuLinearAllocator_Allocate( ksGpuLinearAllocator * allocator, const VkDeviceSize size, const VkDeviceSize alignment, VkDeviceSize * offset );
+static VkDeviceSize ksGpuLinearAllocator_GetGrowSize( const ksGpuLinearAllocator * allocator, const VkDeviceSize minSize );
+
+================================================================================================
+*/
+
+#if !defined( KSGPU_LINEAR_ALLOCATOR_H )
+#define KSGPU_LINEAR_ALLOCATOR_H
+
+typedef struct
+{
+	VkDeviceSize			size;
+	VkDeviceSize			offset;		// bytes allocated so far
+	VkDeviceSize			required;	// bytes that would have been allocated if there was enough space
+} ksGpuLinearAllocator;
+
+static void ksGpuLinearAllocator_Init( ksGpuLinearAllocator * allocator, const VkDeviceSize size )
+{
+	allocator->size = size;
+	allocator->offset = 0;
+	allocator->required = 0;
+}
+
+static void ksGpuLinearAllocator_Reset( ksGpuLinearAllocator * allocator )
+{
+	allocator->offset = 0;
+	allocator->required = 0;
+}
+
+// The alignment must be a power of two.
+static bool ksGpuLinearAllocator_Allocate( ksGpuLinearAllocator * allocator, const VkDeviceSize size, const VkDeviceSize alignment, VkDeviceSize * offset )
+{
+	allocator->required = ( ( allocator->required + alignment - 1 ) & ~( alignment - 1 ) ) + size;
+
+	const VkDeviceSize start = ( allocator->offset + alignment - 1 ) & ~( alignment - 1 );
+	if ( start + size > allocator->size )
+	{
+		return false;
+	}
+	allocator->offset = start + size;
+	*offset = start;
+	return true;
+}
+
+// Returns the size the memory should grow to for everything that was allocated since the last reset
+// to fit, which is a power of two times the minimum size, or zero if everything fit.
+static VkDeviceSize ksGpuLinearAllocator_GetGrowSize( const ksGpuLinearAllocator * allocator, const VkDeviceSize minSize )
+{
+	if ( allocator->required <= allocator->size )
+	{
+		return 0;
+	}
+	VkDeviceSize size = minSize;
+	while ( size < allocator->required )
+	{
+		size *= 2;
+	}
+	return size;
+}
+
+#endif // !KSGPU_LINEAR_ALLOCATOR_H
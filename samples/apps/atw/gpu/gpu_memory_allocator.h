@@ -0,0 +1,494 @@
+/*
+================================================================================================
+
+Description	:	Device memory sub-allocator for Vulkan.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Buffers and images are sub-allocated from large device memory blocks instead of calling
+vkAllocateMemory per resource, which is slow and quickly runs into maxMemoryAllocationCount.
+There is a pool of blocks per memory type and each block places allocations with a buddy system.
+A buddy node is aligned to its own size, so any alignment up to the allocation size comes for free,
+and mapped ranges always start and end on a multiple of nonCoherentAtomSize (at most 256 bytes).
+When the bufferImageGranularity is larger than the smallest node, linear resources (buffers) and
+optimal resources (images) use separate pools so they never share a granularity page.
+Large images and anything that would take up more than half a block get a dedicated allocation.
+Host visible blocks are persistently mapped.
+
+The allocator only calls the driver through the block callbacks.
+
+INTERFACE
+=========
+
+ksGpuMemoryBlockCallbacks
+ksGpuMemoryAllocation
+ksGpuMemoryStats
+ksGpuMemoryAllocator
+
+static void ksGpuMemoryAllocator_Create( ksGpuMemoryAllocator * allocator, const VkPhysicalDeviceMemoryProperties * memoryProperties,
+										const VkDeviceSize bufferImageGranularity, const ksGpuMemoryBlockCallbacks * callbacks );
+static void ksGpuMemoryAllocator_Destroy( ksGpuMemoryAllocator * allocator );
+static uint32_t ksGpuMemoryAllocator_GetMemoryTypeIndex( const ksGpuMemoryAllocator * allocator, const uint32_t typeBits,
+										const VkMemoryPropertyFlags requiredProperties );
+static bool ksGpuMemoryAllocator_Allocate( ksGpuMemoryAllocator * allocator, ksGpuMemoryAllocation * allocation,
+										const VkMemoryRequirements * requirements, const VkMemoryPropertyFlags requiredProperties,
+										const bool optimalTiling );
+static void ksGpuMemoryAllocator_Free( ksGpuMemoryAllocator * allocator, ksGpuMemoryAllocation * allocation );
+static void ksGpuMemoryAllocator_GetStats( ksGpuMemoryAllocator * allocator, const uint32_t memoryTypeIndex, ksGpuMemoryStats * stats );
+static void ksGpuMemoryAllocator_PrintStats( ksGpuMemoryAllocator * allocator );
+
+================================================================================================
+*/
+
+#if !defined( KSGPU_MEMORY_ALLOCATOR_H )
+#define KSGPU_MEMORY_ALLOCATOR_H
+
+#define KS_GPU_MEMORY_MIN_NODE_SIZE			256
+#define KS_GPU_MEMORY_MIN_NODE_SIZE_LOG2	8
+#define KS_GPU_MEMORY_MIN_BLOCK_SIZE		( 1024 * 1024 )
+#define KS_GPU_MEMORY_MAX_BLOCK_SIZE		( 64 * 1024 * 1024 )
+#define KS_GPU_MEMORY_DEDICATED_IMAGE_SIZE	( 16 * 1024 * 1024 )
+
+typedef struct
+{
+	void *	userData;
+	bool	(*allocateBlock)( void * userData, const uint32_t memoryTypeIndex, const VkDeviceSize size, const bool map,
+								VkDeviceMemory * memory, void ** mapped );
+	void	(*freeBlock)( void * userData, VkDeviceMemory memory );
+} ksGpuMemoryBlockCallbacks;
+
+typedef struct ksGpuMemoryBlock_s
+{
+	struct ksGpuMemoryBlock_s *	next;
+	VkDeviceMemory				memory;
+	void *						mapped;
+	VkDeviceSize				freeSize;
+	int							allocationCount;
+	uint8_t *					longest;		// per buddy node, 1 + order of the largest free node in its sub-tree, or 0 if full
+} ksGpuMemoryBlock;
+
+typedef struct
+{
+	ksGpuMemoryBlock *	blocks;
+	VkDeviceSize		blockSize;
+	int					maxOrder;
+} ksGpuMemoryPool;
+
+typedef struct
+{
+	VkDeviceMemory		memory;
+	VkDeviceSize		offset;
+	VkDeviceSize		size;			// reserved size, at least the requested size
+	VkDeviceSize		requestedSize;
+	void *				mapped;			// NULL unless the memory is host visible
+	uint32_t			memoryTypeIndex;
+	int					order;			// buddy order, or -1 for a dedicated allocation
+	ksGpuMemoryPool *	pool;
+	ksGpuMemoryBlock *	block;
+} ksGpuMemoryAllocation;
+
+typedef struct
+{
+	int					blockCount;
+	int					dedicatedCount;
+	int					allocationCount;
+	VkDeviceSize		blockBytes;			// device memory held by blocks
+	VkDeviceSize		dedicatedBytes;		// device memory held by dedicated allocations
+	VkDeviceSize		requestedBytes;		// bytes requested by sub-allocations
+	VkDeviceSize		reservedBytes;		// bytes reserved by sub-allocations including buddy rounding
+	VkDeviceSize		largestFreeBytes;	// largest free node over all blocks
+	VkDeviceSize		peakBytes;			// peak device memory held by blocks and dedicated allocations
+} ksGpuMemoryStats;
+
+typedef struct
+{
+	VkPhysicalDeviceMemoryProperties	memoryProperties;
+	VkDeviceSize						bufferImageGranularity;
+	ksGpuMemoryBlockCallbacks			callbacks;
+	ksGpuMemoryPool						pools[VK_MAX_MEMORY_TYPES][2];	// linear and optimal
+	ksGpuMemoryStats					stats[VK_MAX_MEMORY_TYPES];
+	ksMutex								mutex;
+} ksGpuMemoryAllocator;
+
+static int ksGpuMemoryAllocator_GetOrder( const VkDeviceSize size )
+{
+	int order = 0;
+	while ( ( (VkDeviceSize)KS_GPU_MEMORY_MIN_NODE_SIZE << order ) < size )
+	{
+		order++;
+	}
+	return order;
+}
+
+static void ksGpuMemoryAllocator_Create( ksGpuMemoryAllocator * allocator, const VkPhysicalDeviceMemoryProperties * memoryProperties,
+										const VkDeviceSize bufferImageGranularity, const ksGpuMemoryBlockCallbacks * callbacks )
+{
+	memset( allocator, 0, sizeof( ksGpuMemoryAllocator ) );
+
+	allocator->memoryProperties = *memoryProperties;
+	allocator->bufferImageGranularity = bufferImageGranularity;
+	allocator->callbacks = *callbacks;
+
+	for ( uint32_t type = 0; type < memoryProperties->memoryTypeCount; type++ )
+	{
+		// Use blocks of at most 1/8th of the heap so small heaps are not exhausted by a single block.
+		const VkDeviceSize heapSize = memoryProperties->memoryHeaps[memoryProperties->memoryTypes[type].heapIndex].size;
+		VkDeviceSize blockSize = KS_GPU_MEMORY_MAX_BLOCK_SIZE;
+		while ( blockSize > KS_GPU_MEMORY_MIN_BLOCK_SIZE && blockSize > heapSize / 8 )
+		{
+			blockSize >>= 1;
+		}
+		for ( int tiling = 0; tiling < 2; tiling++ )
+		{
+			allocator->pools[type][tiling].blocks = NULL;
+			allocator->pools[type][tiling].blockSize = blockSize;
+			allocator->pools[type][tiling].maxOrder = ksGpuMemoryAllocator_GetOrder( blockSize );
+		}
+	}
+
+	ksMutex_Create( &allocator->mutex );
+}
+
+static void ksGpuMemoryAllocator_DestroyBlock( ksGpuMemoryAllocator * allocator, ksGpuMemoryBlock * block )
+{
+	allocator->callbacks.freeBlock( allocator->callbacks.userData, block->memory );
+	free( block->longest );
+	free( block );
+}
+
+static void ksGpuMemoryAllocator_Destroy( ksGpuMemoryAllocator * allocator )
+{
+	for ( uint32_t type = 0; type < allocator->memoryProperties.memoryTypeCount; type++ )
+	{
+		for ( int tiling = 0; tiling < 2; tiling++ )
+		{
+			for ( ksGpuMemoryBlock * block = allocator->pools[type][tiling].blocks; block != NULL; )
+			{
+				ksGpuMemoryBlock * next = block->next;
+				ksGpuMemoryAllocator_DestroyBlock( allocator, block );
+				block = next;
+			}
+			allocator->pools[type][tiling].blocks = NULL;
+		}
+	}
+
+	ksMutex_Destroy( &allocator->mutex );
+}
+
+static uint32_t ksGpuMemoryAllocator_GetMemoryTypeIndex( const ksGpuMemoryAllocator * allocator, const uint32_t typeBits,
+										const VkMemoryPropertyFlags requiredProperties )
+{
+	// Search memory types to find the index with the requested properties.
+	for ( uint32_t type = 0; type < allocator->memoryProperties.memoryTypeCount; type++ )
+	{
+		if ( ( typeBits & ( 1 << type ) ) != 0 )
+		{
+			// Test if this memory type has the required properties.
+			const VkFlags propertyFlags = allocator->memoryProperties.memoryTypes[type].propertyFlags;
+			if ( ( propertyFlags & requiredProperties ) == requiredProperties )
+			{
+				return type;
+			}
+		}
+	}
+	Error( "Memory type %d with properties %d not found.", typeBits, requiredProperties );
+	return 0;
+}
+
+static ksGpuMemoryBlock * ksGpuMemoryAllocator_CreateBlock( ksGpuMemoryAllocator * allocator, ksGpuMemoryPool * pool, const uint32_t memoryTypeIndex )
+{
+	const bool hostVisible = ( allocator->memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT ) != 0;
+
+	VkDeviceMemory memory = VK_NULL_HANDLE;
+	void * mapped = NULL;
+	if ( !allocator->callbacks.allocateBlock( allocator->callbacks.userData, memoryTypeIndex, pool->blockSize, hostVisible, &memory, &mapped ) )
+	{
+		return NULL;
+	}
+
+	// The buddy tree is stored breadth first with the root at index 0 and the children of node i at 2i+1 and 2i+2.
+	const int nodeCount = ( 2 << pool->maxOrder ) - 1;
+
+	ksGpuMemoryBlock * block = (ksGpuMemoryBlock *) malloc( sizeof( ksGpuMemoryBlock ) );
+	block->next = pool->blocks;
+	block->memory = memory;
+	block->mapped = mapped;
+	block->freeSize = pool->blockSize;
+	block->allocationCount = 0;
+	block->longest = (uint8_t *) malloc( nodeCount * sizeof( uint8_t ) );
+	for ( int depth = 0; depth <= pool->maxOrder; depth++ )
+	{
+		memset( block->longest + ( 1 << depth ) - 1, pool->maxOrder - depth + 1, ( 1 << depth ) );
+	}
+	pool->blocks = block;
+
+	ksGpuMemoryStats * stats = &allocator->stats[memoryTypeIndex];
+	stats->blockCount++;
+	stats->blockBytes += pool->blockSize;
+	if ( stats->peakBytes < stats->blockBytes + stats->dedicatedBytes )
+	{
+		stats->peakBytes = stats->blockBytes + stats->dedicatedBytes;
+	}
+
+	return block;
+}
+
+static void ksGpuMemoryAllocator_UpdateParents( uint8_t * longest, int index, const int order )
+{
+	for ( int childOrder = order; index > 0; childOrder++ )
+	{
+		index = ( index - 1 ) >> 1;
+		const uint8_t left = longest[2 * index + 1];
+		const uint8_t right = longest[2 * index + 2];
+		longest[index] = ( left == childOrder + 1 && right == childOrder + 1 ) ? (uint8_t)( childOrder + 2 ) : ( ( left > right ) ? left : right );
+	}
+}
+
+// Returns the offset of a free node of the given order, or -1 if the block has no such node.
+static VkDeviceSize ksGpuMemoryAllocator_AllocateNode( ksGpuMemoryBlock * block, const int maxOrder, const int order )
+{
+	if ( block->longest[0] < order + 1 )
+	{
+		return (VkDeviceSize)-1;
+	}
+
+	// Walk down to the requested order, picking the child with the smallest node that still fits.
+	int index = 0;
+	for ( int nodeOrder = maxOrder; nodeOrder > order; nodeOrder-- )
+	{
+		const uint8_t left = block->longest[2 * index + 1];
+		const uint8_t right = block->longest[2 * index + 2];
+		index = ( left >= order + 1 && ( right < order + 1 || left <= right ) ) ? ( 2 * index + 1 ) : ( 2 * index + 2 );
+	}
+
+	assert( block->longest[index] == order + 1 );
+	block->longest[index] = 0;
+	ksGpuMemoryAllocator_UpdateParents( block->longest, index, order );
+
+	const int depth = maxOrder - order;
+	return (VkDeviceSize)( index - ( 1 << depth ) + 1 ) << ( KS_GPU_MEMORY_MIN_NODE_SIZE_LOG2 + order );
+}
+
+static void ksGpuMemoryAllocator_FreeNode( ksGpuMemoryBlock * block, const int maxOrder, const VkDeviceSize offset, const int order )
+{
+	const int depth = maxOrder - order;
+	const int index = (int)( offset >> ( KS_GPU_MEMORY_MIN_NODE_SIZE_LOG2 + order ) ) + ( 1 << depth ) - 1;
+
+	assert( block->longest[index] == 0 );
+	block->longest[index] = (uint8_t)( order + 1 );
+	ksGpuMemoryAllocator_UpdateParents( block->longest, index, order );
+}
+
+static bool ksGpuMemoryAllocator_Allocate( ksGpuMemoryAllocator * allocator, ksGpuMemoryAllocation * allocation,
+										const VkMemoryRequirements * requirements, const VkMemoryPropertyFlags requiredProperties,
+										const bool optimalTiling )
+{
+	memset( allocation, 0, sizeof( ksGpuMemoryAllocation ) );
+
+	const uint32_t memoryTypeIndex = ksGpuMemoryAllocator_GetMemoryTypeIndex( allocator, requirements->memoryTypeBits, requiredProperties );
+	const bool separateTiling = ( allocator->bufferImageGranularity > KS_GPU_MEMORY_MIN_NODE_SIZE );
+	ksGpuMemoryPool * pool = &allocator->pools[memoryTypeIndex][( separateTiling && optimalTiling ) ? 1 : 0];
+	ksGpuMemoryStats * stats = &allocator->stats[memoryTypeIndex];
+
+	// Buddy nodes are aligned to their size so rounding up to the alignment is enough.
+	const VkDeviceSize alignedSize = ( requirements->size > requirements->alignment ) ? requirements->size : requirements->alignment;
+	const int order = ksGpuMemoryAllocator_GetOrder( alignedSize );
+
+	allocation->requestedSize = requirements->size;
+	allocation->memoryTypeIndex = memoryTypeIndex;
+
+	ksMutex_Lock( &allocator->mutex, true );
+
+	if ( order >= pool->maxOrder || ( optimalTiling && requirements->size >= KS_GPU_MEMORY_DEDICATED_IMAGE_SIZE ) )
+	{
+		const bool hostVisible = ( allocator->memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT ) != 0;
+		if ( !allocator->callbacks.allocateBlock( allocator->callbacks.userData, memoryTypeIndex, requirements->size, hostVisible,
+													&allocation->memory, &allocation->mapped ) )
+		{
+			ksMutex_Unlock( &allocator->mutex );
+			Error( "Failed to allocate %lld bytes of dedicated device memory.", (long long)requirements->size );
+			return false;
+		}
+		allocation->offset = 0;
+		allocation->size = requirements->size;
+		allocation->order = -1;
+
+		stats->dedicatedCount++;
+		stats->dedicatedBytes += requirements->size;
+		if ( stats->peakBytes < stats->blockBytes + stats->dedicatedBytes )
+		{
+			stats->peakBytes = stats->blockBytes + stats->dedicatedBytes;
+		}
+
+		ksMutex_Unlock( &allocator->mutex );
+		return true;
+	}
+
+	VkDeviceSize offset = (VkDeviceSize)-1;
+	ksGpuMemoryBlock * block = NULL;
+	for ( block = pool->blocks; block != NULL; block = block->next )
+	{
+		offset = ksGpuMemoryAllocator_AllocateNode( block, pool->maxOrder, order );
+		if ( offset != (VkDeviceSize)-1 )
+		{
+			break;
+		}
+	}
+	if ( block == NULL )
+	{
+		block = ksGpuMemoryAllocator_CreateBlock( allocator, pool, memoryTypeIndex );
+		if ( block == NULL )
+		{
+			ksMutex_Unlock( &allocator->mutex );
+			Error( "Failed to allocate a %lld byte device memory block.", (long long)pool->blockSize );
+			return false;
+		}
+		offset = ksGpuMemoryAllocator_AllocateNode( block, pool->maxOrder, order );
+		assert( offset != (VkDeviceSize)-1 );
+	}
+
+	const VkDeviceSize nodeSize = (VkDeviceSize)KS_GPU_MEMORY_MIN_NODE_SIZE << order;
+	block->freeSize -= nodeSize;
+	block->allocationCount++;
+
+	allocation->memory = block->memory;
+	allocation->offset = offset;
+	allocation->size = nodeSize;
+	allocation->mapped = ( block->mapped != NULL ) ? (uint8_t *)block->mapped + offset : NULL;
+	allocation->order = order;
+	allocation->pool = pool;
+	allocation->block = block;
+
+	stats->allocationCount++;
+	stats->requestedBytes += requirements->size;
+	stats->reservedBytes += nodeSize;
+
+	ksMutex_Unlock( &allocator->mutex );
+	return true;
+}
+
+static void ksGpuMemoryAllocator_Free( ksGpuMemoryAllocator * allocator, ksGpuMemoryAllocation * allocation )
+{
+	if ( allocation->memory == VK_NULL_HANDLE )
+	{
+		return;
+	}
+
+	ksMutex_Lock( &allocator->mutex, true );
+
+	ksGpuMemoryStats * stats = &allocator->stats[allocation->memoryTypeIndex];
+
+	if ( allocation->order < 0 )
+	{
+		allocator->callbacks.freeBlock( allocator->callbacks.userData, allocation->memory );
+
+		stats->dedicatedCount--;
+		stats->dedicatedBytes -= allocation->size;
+	}
+	else
+	{
+		ksGpuMemoryPool * pool = allocation->pool;
+		ksGpuMemoryBlock * block = allocation->block;
+
+		ksGpuMemoryAllocator_FreeNode( block, pool->maxOrder, allocation->offset, allocation->order );
+		block->freeSize += allocation->size;
+		block->allocationCount--;
+
+		stats->allocationCount--;
+		stats->requestedBytes -= allocation->requestedSize;
+		stats->reservedBytes -= allocation->size;
+
+		// Release empty blocks but keep the last block of a pool around to avoid thrashing.
+		if ( block->allocationCount == 0 && !( pool->blocks == block && block->next == NULL ) )
+		{
+			for ( ksGpuMemoryBlock ** b = &pool->blocks; *b != NULL; b = &(*b)->next )
+			{
+				if ( *b == block )
+				{
+					*b = block->next;
+					break;
+				}
+			}
+			ksGpuMemoryAllocator_DestroyBlock( allocator, block );
+
+			stats->blockCount--;
+			stats->blockBytes -= pool->blockSize;
+		}
+	}
+
+	ksMutex_Unlock( &allocator->mutex );
+
+	memset( allocation, 0, sizeof( ksGpuMemoryAllocation ) );
+}
+
+static void ksGpuMemoryAllocator_GetStats( ksGpuMemoryAllocator * allocator, const uint32_t memoryTypeIndex, ksGpuMemoryStats * stats )
+{
+	ksMutex_Lock( &allocator->mutex, true );
+
+	*stats = allocator->stats[memoryTypeIndex];
+	stats->largestFreeBytes = 0;
+	for ( int tiling = 0; tiling < 2; tiling++ )
+	{
+		for ( const ksGpuMemoryBlock * block = allocator->pools[memoryTypeIndex][tiling].blocks; block != NULL; block = block->next )
+		{
+			const VkDeviceSize largestFree = ( block->longest[0] > 0 ) ? ( (VkDeviceSize)KS_GPU_MEMORY_MIN_NODE_SIZE << ( block->longest[0] - 1 ) ) : 0;
+			if ( stats->largestFreeBytes < largestFree )
+			{
+				stats->largestFreeBytes = largestFree;
+			}
+		}
+	}
+
+	ksMutex_Unlock( &allocator->mutex );
+}
+
+static void ksGpuMemoryAllocator_PrintStats( ksGpuMemoryAllocator * allocator )
+{
+	for ( uint32_t type = 0; type < allocator->memoryProperties.memoryTypeCount; type++ )
+	{
+		ksGpuMemoryStats stats;
+		ksGpuMemoryAllocator_GetStats( allocator, type, &stats );
+		if ( stats.peakBytes == 0 )
+		{
+			continue;
+		}
+
+		// Internal fragmentation is the buddy rounding, external fragmentation is free space that is not in the largest free node.
+		const VkDeviceSize freeBytes = stats.blockBytes - stats.reservedBytes;
+		const float internal = ( stats.reservedBytes > 0 ) ? 100.0f * ( stats.reservedBytes - stats.requestedBytes ) / stats.reservedBytes : 0.0f;
+		const float external = ( freeBytes > 0 ) ? 100.0f * ( freeBytes - stats.largestFreeBytes ) / freeBytes : 0.0f;
+
+		Print( "Memory Type %-9d: %d blocks (%lld kB), %d allocations (%lld kB), %d dedicated (%lld kB), peak %lld kB, "
+				"fragmentation %1.1f%% internal %1.1f%% external\n",
+				type, stats.blockCount, (long long)( stats.blockBytes / 1024 ),
+				stats.allocationCount, (long long)( stats.requestedBytes / 1024 ),
+				stats.dedicatedCount, (long long)( stats.dedicatedBytes / 1024 ),
+				(long long)( stats.peakBytes / 1024 ), internal, external );
+	}
+}
+
+#endif // !KSGPU_MEMORY_ALLOCATOR_H
@@ -0,0 +1,113 @@
+/*
+================================================================================================
+
+Description	:	Staging ring buffer for Vulkan uploads.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Small uploads are staged in a single persistently mapped buffer that is used as a ring.
+Allocations are placed one after the other at the requested alignment. An allocation that
+does not fit before the end of the ring wraps around to the start, and the skipped space
+at the end counts as used until it is released together with the allocation before it.
+Allocation fails when the ring is full. The caller then waits for the oldest upload to
+complete and releases it.
+
+The ring only keeps offsets. The setup batches take a mark when they are submitted and
+release the mark when their fence is signaled, so everything staged for a batch is freed at
+once and marks are released in the order they were taken.
+
+INTERFACE
+=========
+
+ksGpuStagingRing
+
+static void ksGpuStagingRing_Init( ksGpuStagingRing * ring, const VkDeviceSize size );
+static bool ksGpuStagingRing_Allocate( ksGpuStagingRing * ring, const VkDeviceSize size, const VkDeviceSize alignment, VkDeviceSize * offset );
+static VkDeviceSize ksGpuStagingRing_GetMark( const ksGpuStagingRing * ring );
+static void ksGpuStagingRing_Release( ksGpuStagingRing * ring, const VkDeviceSize mark );
+
+================================================================================================
+*/
+
+#if !defined( KSGPU_STAGING_RING_H )
+#define KSGPU_STAGING_RING_H
+
+typedef struct
+{
+	VkDeviceSize			size;
+	VkDeviceSize			head;			// offset where the next allocation starts
+	VkDeviceSize			used;			// bytes still in use before the head, including padding at the end of the ring
+	VkDeviceSize			allocated;		// total number of bytes ever handed out, including padding
+} ksGpuStagingRing;
+
+static void ksGpuStagingRing_Init( ksGpuStagingRing * ring, const VkDeviceSize size )
+{
+	ring->size = size;
+	ring->head = 0;
+	ring->used = 0;
+	ring->allocated = 0;
+}
+
+static bool ksGpuStagingRing_Allocate( ksGpuStagingRing * ring, const VkDeviceSize size, const VkDeviceSize alignment, VkDeviceSize * offset )
+{
+	VkDeviceSize start = ( ring->head + alignment - 1 ) & ~( alignment - 1 );
+	if ( start + size > ring->size )
+	{
+		// Skip the space at the end of the ring and wrap around.
+		start = 0;
+	}
+	const VkDeviceSize padding = ( start >= ring->head ) ? ( start - ring->head ) : ( ring->size - ring->head );
+	if ( ring->used + padding + size > ring->size )
+	{
+		return false;
+	}
+	ring->head = start + size;
+	ring->used += padding + size;
+	ring->allocated += padding + size;
+	*offset = start;
+	return true;
+}
+
+// Returns a mark that can be used to release everything allocated so far.
+static VkDeviceSize ksGpuStagingRing_GetMark( const ksGpuStagingRing * ring )
+{
+	return ring->allocated;
+}
+
+// Marks must be released in the order they were taken.
+static void ksGpuStagingRing_Release( ksGpuStagingRing * ring, const VkDeviceSize mark )
+{
+	assert( mark <= ring->allocated );
+	assert( mark >= ring->allocated - ring->used );
+	ring->used = ring->allocated - mark;
+	if ( ring->used == 0 )
+	{
+		ring->head = 0;
+	}
+}
+
+#endif // !KSGPU_STAGING_RING_H
@@ -63,6 +63,15 @@ This implementation supports the following extensions:
 
 This implementation only supports KTX images.
 
+glTF 2.0 JSON files and .glb files are loaded as well. The objects reference
+each other by index, so they are linked up directly instead of through the name
+hashes. The binary chunk of a .glb file is used in place as a buffer, and images
+stored in buffer views are not copied. glTF 2.0 has no techniques, so a GLSL 1.00
+program and technique are generated for each combination of metallic-roughness
+material features used by the scene. Only the OpenGL and Vulkan paths can render
+glTF 2.0 materials. Morph targets, sparse accessors, normal textures and cubic
+spline animation are not supported.
+
 glTF 1.0 is not perfect.
 
 Incorrect usage of JSON:
@@ -181,12 +190,18 @@ This glTF implementation overcomes some of these issues.
 	- Time-lines that are fixed-rate are identified at load time. A fixed-rate
 	  time-line allows for very fast direct indexing of key frames based on
 	  the current time.
+	- Variable rate time-lines are searched by walking forward from the key
+	  frame that was found during the previous update, and a binary search
+	  is only used after a seek or when the animation loops.
 	- Time-lines are evaluated separately so they can be shared by different
 	  animations.
 	- The bindShapeMatrix is folded into the inverseBindMatrices at load
 	  time to avoid another run-time matrix multiplication.
 	- This implementation supports culling of animated models using the
 	  KHR_skin_culling glTF extension.
+	- The node hierarchy is used as a bounding volume hierarchy. The bounds
+	  of each node and all its descendants are refit every frame and whole
+	  sub-hierarchies are culled early against the frustum of the rendered eye.
 	- The nodes are sorted to allow a simple linear walk to transform
 	  nodes from local space to global space.
 
@@ -209,6 +224,10 @@ static void ksGltfScene_SetNodeScale( ksGltfScene * scene, const char * nodeName
 static void ksGltfScene_Simulate( ksGltfScene * scene, ksViewState * viewState, ksGpuWindowInput * input, const ksNanoseconds time );
 static void ksGltfScene_UpdateBuffers( ksGpuCommandBuffer * commandBuffer, ksGltfScene * scene, const ksViewState * viewState, const int eye );
 static void ksGltfScene_Render( ksGpuCommandBuffer * commandBuffer, const ksGltfScene * scene, const ksViewState * viewState );
+static void ksGltfScene_RenderPart( ksGpuCommandBuffer * commandBuffer, const ksGltfScene * scene, const ksViewState * viewState, const int part, const int partCount );
+
+ksGltfScene_RenderPart only reads the draw list built by ksGltfScene_UpdateBuffers, so the parts can be recorded
+into different command buffers on different threads.
 
 ================================================================================================================================
 */
@@ -223,6 +242,9 @@ static void ksGltfScene_Render( ksGpuCommandBuffer * commandBuffer, const ksGltf
 #define GL_UNSIGNED_BYTE				0x1401
 #define GL_SHORT						0x1402
 #define GL_UNSIGNED_SHORT				0x1403
+#define GL_UNSIGNED_INT					0x1405
+
+#define GL_TRIANGLES					0x0004
 
 #define GL_BOOL							0x8B56
 #define GL_BOOL_VEC2					0x8B57
@@ -721,13 +743,19 @@ static const char unitCubeFlatShadeFragmentProgramMetalSL[] =
 
 #define GLTF_JSON_VERSION_10			"1.0"
 #define GLTF_JSON_VERSION_101			"1.0.1"
+#define GLTF_JSON_VERSION_20			"2.0"
 #define GLTF_BINARY_MAGIC				( ( 'g' << 0 ) | ( 'l' << 8 ) | ( 'T' << 16 ) | ( 'F' << 24 ) )
 #define GLTF_BINARY_VERSION				1
+#define GLTF_BINARY_VERSION_20			2		// chunk based container of glTF 2.0
 #define GLTF_BINARY_CONTENT_FORMAT		0
+#define GLTF_BINARY_CHUNK_TYPE_JSON		( ( 'J' << 0 ) | ( 'S' << 8 ) | ( 'O' << 16 ) | ( 'N' << 24 ) )
+#define GLTF_BINARY_CHUNK_TYPE_BIN		( ( 'B' << 0 ) | ( 'I' << 8 ) | ( 'N' << 16 ) )
 
 #define URI_SCHEME_APPLICATION_BINARY			"data:application/binary,"
 #define URI_SCHEME_APPLICATION_BINARY_LENGTH	24
 
+// A glTF 2.0 binary starts with the same 20 bytes, where the content length and format
+// are the length and type of the first chunk, which is always the JSON chunk.
 typedef struct ksGltfBinaryHeader
 {
 	uint32_t					magic;
@@ -737,6 +765,12 @@ typedef struct ksGltfBinaryHeader
 	uint32_t					contentFormat;
 } ksGltfBinaryHeader;
 
+typedef struct ksGltfBinaryChunkHeader
+{
+	uint32_t					length;
+	uint32_t					type;
+} ksGltfBinaryChunkHeader;
+
 typedef struct ksGltfBuffer
 {
 	char *						name;
@@ -751,6 +785,7 @@ typedef struct ksGltfBufferView
 	const ksGltfBuffer *		buffer;
 	size_t						byteOffset;
 	size_t						byteLength;
+	size_t						byteStride;			// glTF 2.0 stride of the vertex attributes in this view, zero if tightly packed
 	int							target;
 } ksGltfBufferView;
 
@@ -763,6 +798,7 @@ typedef struct ksGltfAccessor
 	size_t						byteStride;
 	int							componentType;
 	int							count;
+	bool						normalized;			// glTF 2.0 integer components that map to [0, 1] or [-1, 1]
 	int							intMin[16];
 	int							intMax[16];
 	float						floatMin[16];
@@ -781,6 +817,7 @@ typedef struct ksGltfImage
 	char *						name;
 	ksGltfImageVersion *		versions;
 	int							versionCount;
+	const ksGltfBufferView *	bufferView;		// glTF 2.0 image stored in a buffer view instead of a uri
 } ksGltfImage;
 
 typedef struct ksGltfSampler
@@ -928,6 +965,8 @@ typedef struct ksGltfTechnique
 {
 	char *						name;
 	ksGpuGraphicsProgram		program;
+	ksGpuGraphicsProgram		instancedProgram;	// program with a per-instance model matrix, only valid if 'instanced'
+	bool						instanced;
 	ksGpuProgramParm *			parms;
 	ksGltfUniform *				uniforms;
 	int							uniformCount;
@@ -936,6 +975,7 @@ typedef struct ksGltfTechnique
 	ksGpuVertexAttribute *		vertexAttributeLayout;
 	int							vertexAttribsFlags;
 	ksGpuRasterOperations		rop;
+	int							pipelineRank;		// dense rank shared by techniques with the same converted program and raster operations
 } ksGltfTechnique;
 
 typedef struct ksGltfMaterialValue
@@ -944,12 +984,42 @@ typedef struct ksGltfMaterialValue
 	ksGltfUniformValue			value;
 } ksGltfMaterialValue;
 
+typedef enum
+{
+	GLTF_UNIFORM_OP_VALUE,					// constant default or material value
+	GLTF_UNIFORM_OP_MATRIX,					// matrix at a fixed address that is updated every frame
+	GLTF_UNIFORM_OP_DRAW_MATRIX,			// matrix of the draw selected by 'slot'
+	GLTF_UNIFORM_OP_DRAW_JOINT_BUFFER,		// joint buffer of the draw
+	GLTF_UNIFORM_OP_VIEW_PROJECTION_BUFFER,	// view projection buffer of the frame
+	GLTF_UNIFORM_OP_VIEWPORT
+} ksGltfUniformOpType;
+
+typedef enum
+{
+	GLTF_DRAW_MATRIX_LOCAL,
+	GLTF_DRAW_MATRIX_MODEL,
+	GLTF_DRAW_MATRIX_MODEL_INVERSE,
+	GLTF_DRAW_MATRIX_MAX
+} ksGltfDrawMatrix;
+
+typedef struct ksGltfUniformOp
+{
+	ksGltfUniformOpType			type;
+	int							index;			// program parm index
+	int							slot;			// ksGltfDrawMatrix for GLTF_UNIFORM_OP_DRAW_MATRIX
+	const ksGltfUniform *		uniform;		// uniform and value for GLTF_UNIFORM_OP_VALUE
+	const ksGltfUniformValue *	value;
+	const ksMatrix4x4f *		matrix;			// matrix for GLTF_UNIFORM_OP_MATRIX
+} ksGltfUniformOp;
+
 typedef struct ksGltfMaterial
 {
 	char *						name;
 	const ksGltfTechnique *		technique;
 	ksGltfMaterialValue *		values;
 	int							valueCount;
+	ksGltfUniformOp *			uniformOps;		// technique uniforms and material values compiled into a flat list
+	int							uniformOpCount;
 } ksGltfMaterial;
 
 typedef struct ksGltfGeometryAccessors
@@ -972,6 +1042,7 @@ typedef struct ksGltfSurface
 	const ksGltfMaterial *		material;		// material used to render this surface
 	ksGpuGeometry				geometry;		// surface geometry
 	ksGpuGraphicsPipeline		pipeline;		// rendering pipeline for this surface
+	ksGpuGraphicsPipeline		instancedPipeline;	// instanced rendering pipeline, only valid if the geometry has instances
 	ksVector3f					mins;			// minimums of the surface geometry excluding animations
 	ksVector3f					maxs;			// maximums of the surface geometry excluding animations
 } ksGltfSurface;
@@ -985,12 +1056,34 @@ typedef struct ksGltfModel
 	ksVector3f					maxs;			// maximums of the surface geometry excluding animations
 } ksGltfModel;
 
+typedef enum
+{
+	GLTF_CHANNEL_TRANSLATION,
+	GLTF_CHANNEL_ROTATION,
+	GLTF_CHANNEL_SCALE,
+	GLTF_CHANNEL_MAX
+} ksGltfChannelType;
+
+// The animation channels that share a time line are packed into one structure-of-arrays block per channel type.
+// For each key frame the block stores all x components, followed by all y components, etc. Each run of components
+// is padded to a multiple of 4 channels so every run starts 16-byte aligned.
+typedef struct ksGltfChannelBlock
+{
+	ksGltfChannelType			type;
+	struct ksGltfNode **		nodes;			// target node of each channel
+	float *						keys;			// [sampleCount][componentCount][stride]
+	int							componentCount;	// 3 for translation and scale, 4 for rotation
+	int							channelCount;
+	int							stride;			// channelCount rounded up to a multiple of 4
+} ksGltfChannelBlock;
+
 typedef struct ksGltfTimeLine
 {
 	float						duration;		// in seconds
 	float						rcpStep;		// in seconds
 	float *						sampleTimes;	// in seconds
 	int							sampleCount;
+	ksGltfChannelBlock			channelBlocks[GLTF_CHANNEL_MAX];
 } ksGltfTimeLine;
 
 typedef struct ksGltfAnimationChannel
@@ -1026,6 +1119,7 @@ typedef struct ksGltfSkin
 	ksGltfJoint *				joints;					// joints of this skin
 	int							jointCount;				// number of joints
 	ksGpuBuffer					jointBuffer;			// buffer with joint matrices
+	const ksGpuBuffer *			jointBinding;			// buffer with the joint matrices of this frame (modified at run-time)
 	ksVector3f					mins;					// minimums of the complete skin geometry (modified at run-time)
 	ksVector3f					maxs;					// maximums of the complete skin geometry (modified at run-time)
 	bool						culled;					// true if the skin is culled (modified at run-time)
@@ -1085,6 +1179,8 @@ typedef struct ksGltfSubTree
 	int							timeLineCount;
 	ksGltfAnimation **			animations;
 	int							animationCount;
+	int *						levelOffsets;		// offsets of the breadth-first depth levels into the nodes (levelCount + 1 entries)
+	int							levelCount;
 } ksGltfSubTree;
 
 typedef struct ksGltfSubScene
@@ -1094,9 +1190,11 @@ typedef struct ksGltfSubScene
 	int							subTreeCount;
 } ksGltfSubScene;
 
+#define GLTF_TIMELINE_MAX_FORWARD_STEPS		4		// key frames to walk forward from the last frame before using a binary search
+
 typedef struct ksGltfTimeLineFrameState
 {
-	int							frame;
+	int							frame;				// also used as the starting point of the search during the next update
 	float						fraction;
 } ksGltfTimeLineFrameState;
 
@@ -1115,6 +1213,15 @@ typedef struct ksGltfNodeState
 	ksVector3f					scale;
 	ksMatrix4x4f				localTransform;
 	ksMatrix4x4f				globalTransform;
+	ksVector3f					geometryMins;	// global space minimums of the geometry of this node
+	ksVector3f					geometryMaxs;	// global space maximums of the geometry of this node
+	ksVector3f					subTreeMins;	// global space minimums of the geometry of this node and all its descendants
+	ksVector3f					subTreeMaxs;	// global space maximums of the geometry of this node and all its descendants
+	bool						localDirty;		// translation, rotation or scale changed since the last update
+	bool						channelDirty[GLTF_CHANNEL_MAX];	// changed by an animation channel (one flag per channel job)
+	bool						globalDirty;	// global transform changed during the last update
+	bool						boundsDirty;	// global transform changed since the geometry bounds were last refreshed by the culler
+	bool						culled;			// true if the geometry of this node and all its descendants is culled
 } ksGltfNodeState;
 
 typedef struct ksGltfSubTreeState
@@ -1131,107 +1238,390 @@ typedef struct ksGltfState
 	ksGltfSubTreeState *		subTreeState;
 } ksGltfState;
 
+#if !defined( GLTF_WORKERS )
+	#define GLTF_WORKERS			4		// number of worker threads used to load scenes and to simulate and update large scenes
+#endif
+#define GLTF_MAX_JOINTS				( (int)( 16384 / sizeof( ksMatrix4x4f ) ) )	// based on a GL_MAX_UNIFORM_BLOCK_SIZE of 16384 on the ARM Mali
+#define GLTF_JOB_SIZE				64		// number of time lines, channels or nodes claimed by a worker at once, a multiple of 4 for the SIMD channel sweep
+#define GLTF_SKIN_JOB_SIZE			4		// number of skins claimed by a worker at once
+#if !defined( GLTF_THREAD_MIN_NODES )
+	#define GLTF_THREAD_MIN_NODES	GLTF_JOB_SIZE	// scenes with more nodes are simulated and updated on worker threads, see gltf_simulate_bench
+#endif
+
+typedef struct ksGltfJob
+{
+	ksGltfTimeLine **			timeLines;			// time lines to look up, or NULL
+	const ksGltfTimeLine *		channelTimeLine;	// time line of the channel block
+	const ksGltfChannelBlock *	channelBlock;		// channel block with channels to apply, or NULL
+	ksGltfNode **				nodes;				// nodes to transform into global space, or NULL
+	ksGltfSkin **				cullSkins;			// skins to calculate the bounds of and to cull, or NULL
+	ksGltfSubTree **			cullSubTrees;		// sub-trees to cull hierarchically, or NULL
+	ksGltfSkin **				jointSkins;			// skins to calculate the joint matrices of, or NULL
+	ksMatrix4x4f **				joints;				// mapped joint buffer memory of the joint skins
+	int							first;
+	int							count;
+	int							testedNodes;		// number of nodes tested by the sub-tree cull job
+	int							culledNodes;		// number of nodes culled by the sub-tree cull job
+} ksGltfJob;
+
+typedef struct ksGltfJobs
+{
+	struct ksGltfScene *		scene;
+	ksNanoseconds				time;
+	const ksViewState *			viewState;
+	int							eye;
+	ksGltfJob *					jobs;
+	int							jobCount;
+	ksAtomicUint32				nextJob;			// atomic counter shared by all workers
+	ksGltfTimeLine **			timeLines;			// time lines used by the visible sub-trees
+	bool *						timeLineUsed;
+	ksGltfSubTree **			subTrees;			// visible sub-trees of the current sub-scene
+	ksGltfSkin **				skins;				// skins used by the visible sub-trees
+	ksMatrix4x4f **				skinJoints;			// mapped joint buffer memory of the skins that are not culled
+	ksGpuBuffer **				mappedJointBuffers;
+	bool *						skinUsed;
+} ksGltfJobs;
+
+typedef struct ksGltfDrawTransform
+{
+	const ksMatrix4x4f *		localMatrix;
+	const ksMatrix4x4f *		modelMatrix;
+	ksMatrix4x4f				modelInverseMatrix;
+	const ksGpuBuffer *			jointBuffer;
+	const ksGltfSkin *			skin;
+} ksGltfDrawTransform;
+
+typedef struct ksGltfDrawSurface
+{
+	ksGltfSurface *				surface;
+	int							transform;			// index of the draw transform of the surface
+} ksGltfDrawSurface;
+
+typedef struct ksGltfDrawBatch
+{
+	int							first;				// first sorted surface of the batch
+	int							count;				// number of instances of the same surface
+} ksGltfDrawBatch;
+
+typedef struct ksGltfDrawList
+{
+	ksGltfDrawTransform *		transforms;			// one per visible node with models
+	ksGltfDrawSurface *			surfaces;			// visible surfaces in hierarchy order
+	uint64_t *					keys;				// state sort key per visible surface
+	int *						order;				// surface indices in sorted order
+	uint64_t *					sortKeys;			// scratch memory for the radix sort
+	int *						sortOrder;			// scratch memory for the radix sort
+	ksGltfDrawBatch *			batches;			// runs of sorted surfaces drawn with a single draw call
+	const ksGpuBuffer *			indirectBuffer;		// one indirect draw command per batch, NULL when drawing without indirect buffer
+	const ksGpuBuffer *			viewProjectionBuffer;	// view and projection matrices of the frame
+	int							transformCount;
+	int							surfaceCount;
+	int							batchCount;
+	int							pipelineChanges;	// number of batches with a different pipeline rank than the previous batch
+	int							materialChanges;	// number of batches with a different material than the previous batch
+	bool						sortOnState;		// false if the pipeline ranks, materials or models do not fit in the sort key
+} ksGltfDrawList;
+
+#define GLTF_DRAW_KEY_MAX_PIPELINE_RANKS	0x8000		// 15 bits of the sort key
+#define GLTF_DRAW_KEY_MAX_MATERIALS			0x10000		// 16 bits of the sort key
+#define GLTF_DRAW_KEY_MAX_MODELS			0x10000		// 16 bits of the sort key
+
+#if !defined( GLTF_PROFILE_CPU )
+	#define GLTF_PROFILE_CPU		0		// periodically print CPU time percentiles of the simulate and update phases
+#endif
+#define GLTF_PROFILE_SAMPLES		256		// number of samples per phase over which the percentiles are calculated
+
+typedef enum
+{
+	GLTF_PROFILE_SIMULATE,			// animation and node transforms
+	GLTF_PROFILE_CULL,				// skin bounds and hierarchical node culling
+	GLTF_PROFILE_JOINTS,			// joint matrices
+	GLTF_PROFILE_DRAW_LIST,			// draw list, sort, batches and instance buffers
+	GLTF_PROFILE_MAX
+} ksGltfProfilePhase;
+
+typedef struct ksGltfProfile
+{
+	ksNanoseconds				samples[GLTF_PROFILE_MAX][GLTF_PROFILE_SAMPLES];
+	int							sampleCount[GLTF_PROFILE_MAX];
+	int							cullVisitedNodes;	// nodes of the visible sub-trees visited by the culling, summed over the cull samples
+	int							cullTestedNodes;	// nodes with bounds tested against the frusta, summed over the cull samples
+	int							cullCulledNodes;	// nodes that were culled, summed over the cull samples
+	int							drawBatches;		// draw calls, summed over the draw list samples
+	int							drawPipelineChanges;	// pipeline rank changes between draw calls, summed over the draw list samples
+	int							drawMaterialChanges;	// material changes between draw calls, summed over the draw list samples
+	int							shaderCacheMemoryHits;	// technique shaders copied from an identical technique when the scene was loaded
+	int							shaderCacheDiskHits;	// technique shaders read from the disk cache when the scene was loaded
+	ksNanoseconds				shaderConversionTime;	// time spent converting technique shaders when the scene was loaded
+	ksNanoseconds				shaderCacheSavedTime;	// conversion time saved by the shader cache when the scene was loaded
+} ksGltfProfile;
+
+typedef enum
+{
+	GLTF_SHADER_CACHE_MISS,			// the shaders were converted
+	GLTF_SHADER_CACHE_HIT_MEMORY,	// the shaders were copied from an identical technique of the same scene
+	GLTF_SHADER_CACHE_HIT_DISK		// the shaders were read from the shader cache on disk
+} ksGltfShaderCacheResult;
+
+typedef struct ksGltfTechniqueSource
+{
+	ksGltfTechnique *			technique;
+	const ksGltfProgram *		program;
+	int							conversion;
+	const char *				semanticUniforms[GLTF_UNIFORM_SEMANTIC_MAX];
+	const char *				newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MAX];
+	uint64_t					hash;				// hash of all inputs of the shader conversion
+	const struct ksGltfTechniqueSource * original;	// identical technique converted earlier, or NULL
+	ksGltfShaderCacheResult		cacheResult;
+	ksNanoseconds				conversionTime;		// time it took to convert the shaders, also when read from the disk cache
+	ksNanoseconds				cacheTime;			// time spent reading or writing the disk cache
+	uint32_t					cacheFileSize;		// size of the disk cache file, or zero if there is none
+	unsigned char *				vertexSource;		// converted vertex shader, or NULL if not converted
+	unsigned char *				fragmentSource;		// converted fragment shader, or NULL if not converted
+	unsigned char *				instancedVertexSource;	// converted vertex shader with a per-instance model matrix, or NULL
+	size_t						vertexSourceSize;
+	size_t						fragmentSourceSize;
+	size_t						instancedVertexSourceSize;
+} ksGltfTechniqueSource;
+
+typedef struct ksGltfLoadJob
+{
+	const char *				uri;				// URI to read, or NULL
+	unsigned char **			data;				// receives the data read from the URI
+	size_t *					dataSize;			// receives the size of the data read from the URI, or NULL
+	ksGltfTechniqueSource *		techniqueSource;	// technique to convert the shaders of, or NULL
+} ksGltfLoadJob;
+
+typedef struct ksGltfLoadJobs
+{
+	ksThreadPool *				threadPool;
+	const unsigned char *		binaryBuffer;
+	ksGltfLoadJob *				jobs;
+	int							jobCount;
+	int							maxJobs;
+	ksAtomicUint32				nextJob;			// atomic counter shared by all workers
+} ksGltfLoadJobs;
+
+/*
+	Name lookups use open-addressing hash tables with linear probing. The full 32-bit string
+	hash is stored next to the object index so most probes of other names are rejected without
+	a string compare, and so the table can grow without hashing the names again. The table
+	doubles in size whenever it would become more than half full.
+*/
+typedef struct ksGltfNameHash
+{
+	uint32_t *					hashes;				// full string hash per slot
+	int *						indices;			// object index per slot, or -1 if the slot is empty
+	int							size;				// number of slots, always a power of two
+	int							shift;				// 32 - log2( size )
+	int							count;				// number of occupied slots
+} ksGltfNameHash;
+
 typedef struct ksGltfScene
 {
 	ksGltfBuffer *				buffers;
-	int *						bufferNameHash;
+	ksGltfNameHash				bufferNameHash;
 	int							bufferCount;
 	ksGltfBufferView *			bufferViews;
-	int *						bufferViewNameHash;
+	ksGltfNameHash				bufferViewNameHash;
 	int							bufferViewCount;
 	ksGltfAccessor *			accessors;
-	int *						accessorNameHash;
+	ksGltfNameHash				accessorNameHash;
 	int							accessorCount;
 	ksGltfImage *				images;
-	int *						imageNameHash;
+	ksGltfNameHash				imageNameHash;
 	int							imageCount;
 	ksGltfSampler *				samplers;
-	int *						samplerNameHash;
+	ksGltfNameHash				samplerNameHash;
 	int							samplerCount;
 	ksGltfTexture *				textures;
-	int *						textureNameHash;
+	ksGltfNameHash				textureNameHash;
 	int							textureCount;
 	ksGltfShader *				shaders;
-	int *						shaderNameHash;
+	ksGltfNameHash				shaderNameHash;
 	int							shaderCount;
 	ksGltfProgram *				programs;
-	int *						programNameHash;
+	ksGltfNameHash				programNameHash;
 	int							programCount;
 	ksGltfTechnique *			techniques;
-	int *						techniqueNameHash;
+	ksGltfNameHash				techniqueNameHash;
 	int							techniqueCount;
 	ksGltfMaterial *			materials;
-	int *						materialNameHash;
+	ksGltfNameHash				materialNameHash;
 	int							materialCount;
 	ksGltfSkin *				skins;
-	int *						skinNameHash;
+	ksGltfNameHash				skinNameHash;
 	int							skinCount;
 	ksGltfModel *				models;
-	int *						modelNameHash;
+	ksGltfNameHash				modelNameHash;
 	int							modelCount;
 	ksGltfTimeLine *			timeLines;
-	int *						timeLineNameHash;
+	ksGltfNameHash				timeLineNameHash;
 	int							timeLineCount;
 	ksGltfAnimation *			animations;
-	int *						animationNameHash;
+	ksGltfNameHash				animationNameHash;
 	int							animationCount;
 	ksGltfCamera *				cameras;
-	int *						cameraNameHash;
+	ksGltfNameHash				cameraNameHash;
 	int							cameraCount;
 	ksGltfNode *				nodes;
-	int *						nodeNameHash;
-	int *						nodeJointNameHash;
+	ksGltfNameHash				nodeNameHash;
+	ksGltfNameHash				nodeJointNameHash;
 	int							nodeCount;
 	ksGltfSubTree *				subTrees;
-	int *						subTreeNameHash;
+	ksGltfNameHash				subTreeNameHash;
 	int							subTreeCount;
 	ksGltfSubScene *			subScenes;
-	int *						subSceneNameHash;
+	ksGltfNameHash				subSceneNameHash;
 	int							subSceneCount;
 
 	ksGltfState					state;
 
+	bool						useThreadPool;		// true if large enough to use worker threads
+	bool						simulateParallel;	// true if using worker threads and sub-trees and animation channel targets do not overlap
+	bool						cullBothEyes;		// true if the commands recorded for one eye are also used for the other eye, updated every frame
+	ksSceneSettings *			newSettings;		// settings that may change while the scene is rendered
+	ksThreadPool				threadPool;
+	ksGltfJobs					jobs;
+	ksGltfDrawList				drawList;
+	ksGltfProfile				profile;
+
 	ksGpuBuffer					viewProjectionBuffer;
+	ksGpuBuffer					indirectBuffer;		// only valid if drawIndirect is set
+	bool						drawIndirect;		// true if the batches can be drawn from an indirect buffer
 	ksGpuBuffer					defaultJointBuffer;
 	ksGpuGeometry				unitCubeGeometry;
 	ksGpuGraphicsProgram		unitCubeFlatShadeProgram;
 	ksGpuGraphicsPipeline		unitCubePipeline;
 } ksGltfScene;
 
-#define HASH_TABLE_SIZE		256
-
-static unsigned int StringHash( const char * string )
+static uint32_t ksGltfNameHash_StringHash( const char * string )
 {
 	ksStringHash hash;
 	ksStringHash_Init( &hash );
 	ksStringHash_Update( &hash, string );
-	return ( hash & ( HASH_TABLE_SIZE - 1 ) );
+	return hash;
+}
+
+// Fibonacci hashing spreads the poorly distributed low bits of the string hash over the table.
+static int ksGltfNameHash_FirstSlot( const ksGltfNameHash * table, const uint32_t hash )
+{
+	return (int)( ( hash * 2654435769u ) >> table->shift );
+}
+
+static void ksGltfNameHash_Alloc( ksGltfNameHash * table, const int size )
+{
+	assert( ( size & ( size - 1 ) ) == 0 );
+	table->hashes = (uint32_t *) malloc( size * sizeof( table->hashes[0] ) );
+	table->indices = (int *) malloc( size * sizeof( table->indices[0] ) );
+	memset( table->indices, -1, size * sizeof( table->indices[0] ) );
+	table->size = size;
+	table->shift = 32 - IntegerLog2( size );
+	table->count = 0;
+}
+
+static void ksGltfNameHash_Destroy( ksGltfNameHash * table )
+{
+	free( table->hashes );
+	free( table->indices );
+	memset( table, 0, sizeof( ksGltfNameHash ) );
+}
+
+static void ksGltfNameHash_InsertHash( ksGltfNameHash * table, const uint32_t hash, const int index )
+{
+	for ( int slot = ksGltfNameHash_FirstSlot( table, hash ); ; slot = ( slot + 1 ) & ( table->size - 1 ) )
+	{
+		if ( table->indices[slot] < 0 )
+		{
+			table->hashes[slot] = hash;
+			table->indices[slot] = index;
+			table->count++;
+			return;
+		}
+	}
+}
+
+static void ksGltfNameHash_Resize( ksGltfNameHash * table, const int size )
+{
+	ksGltfNameHash old = *table;
+	ksGltfNameHash_Alloc( table, size );
+	for ( int slot = 0; slot < old.size; slot++ )
+	{
+		if ( old.indices[slot] >= 0 )
+		{
+			ksGltfNameHash_InsertHash( table, old.hashes[slot], old.indices[slot] );
+		}
+	}
+	ksGltfNameHash_Destroy( &old );
+}
+
+// Allocates a table that holds 'count' names without resizing.
+static void ksGltfNameHash_Create( ksGltfNameHash * table, const int count )
+{
+	int size = 16;
+	while ( size < count * 2 )
+	{
+		size <<= 1;
+	}
+	ksGltfNameHash_Alloc( table, size );
+}
+
+static void ksGltfNameHash_Insert( ksGltfNameHash * table, const uint32_t hash, const int index )
+{
+	if ( ( table->count + 1 ) * 2 > table->size )
+	{
+		ksGltfNameHash_Resize( table, table->size * 2 );
+	}
+	ksGltfNameHash_InsertHash( table, hash, index );
 }
 
+/*
+	Each name is stored only once and empty names are not stored at all. Without this an
+	empty jointName on every node, or many objects with the same name, would form one long
+	probe sequence that every lookup with the same hash has to walk. When a name occurs more
+	than once the index that was inserted first wins. Objects are inserted in reverse order
+	so the name resolves to the last object with that name, like the original chained table.
+*/
 #define GLTF_HASH( type, typeCapitalized, name, nameCapitalized ) \
-	static void ksGltf_Create##typeCapitalized##nameCapitalized##Hash( ksGltfScene * scene ) \
+	static int ksGltf_Find##typeCapitalized##By##nameCapitalized( const ksGltfScene * scene, const char * name, const uint32_t hash ) \
 	{ \
-		scene->type##nameCapitalized##Hash = (int *) malloc( ( HASH_TABLE_SIZE + scene->type##Count ) * sizeof( scene->type##nameCapitalized##Hash[0] ) ); \
-		memset( scene->type##nameCapitalized##Hash, -1, ( HASH_TABLE_SIZE + scene->type##Count ) * sizeof( scene->type##nameCapitalized##Hash[0] ) ); \
-		for ( int i = 0; i < scene->type##Count; i++ ) \
+		const ksGltfNameHash * table = &scene->type##nameCapitalized##Hash; \
+		for ( int slot = ksGltfNameHash_FirstSlot( table, hash ); table->indices[slot] >= 0; slot = ( slot + 1 ) & ( table->size - 1 ) ) \
 		{ \
-			const unsigned int hash = StringHash( scene->type##s[i].name ); \
-			scene->type##nameCapitalized##Hash[HASH_TABLE_SIZE + i] = scene->type##nameCapitalized##Hash[hash]; \
-			scene->type##nameCapitalized##Hash[hash] = i; \
+			if ( table->hashes[slot] == hash && strcmp( scene->type##s[table->indices[slot]].name, name ) == 0 ) \
+			{ \
+				return table->indices[slot]; \
+			} \
 		} \
+		return -1; \
 	} \
 	\
-	static ksGltf##typeCapitalized * ksGltf_Get##typeCapitalized##By##nameCapitalized( const ksGltfScene * scene, const char * name ) \
+	static void ksGltf_Create##typeCapitalized##nameCapitalized##Hash( ksGltfScene * scene ) \
 	{ \
-		const unsigned int hash = StringHash( name ); \
-		for ( int i = scene->type##nameCapitalized##Hash[hash]; i >= 0; i = scene->type##nameCapitalized##Hash[HASH_TABLE_SIZE + i] ) \
+		ksGltfNameHash_Create( &scene->type##nameCapitalized##Hash, scene->type##Count ); \
+		for ( int i = scene->type##Count - 1; i >= 0; i-- ) \
 		{ \
-			if ( strcmp( scene->type##s[i].name, name ) == 0 ) \
+			const char * name = scene->type##s[i].name; \
+			if ( name == NULL || name[0] == '\0' ) \
+			{ \
+				continue; \
+			} \
+			const uint32_t hash = ksGltfNameHash_StringHash( name ); \
+			if ( ksGltf_Find##typeCapitalized##By##nameCapitalized( scene, name, hash ) < 0 ) \
 			{ \
-				return &scene->type##s[i]; \
+				ksGltfNameHash_Insert( &scene->type##nameCapitalized##Hash, hash, i ); \
 			} \
 		} \
-		return NULL; \
+	} \
+	\
+	static ksGltf##typeCapitalized * ksGltf_Get##typeCapitalized##By##nameCapitalized( const ksGltfScene * scene, const char * name ) \
+	{ \
+		if ( scene->type##nameCapitalized##Hash.size == 0 || name == NULL || name[0] == '\0' ) \
+		{ \
+			return NULL; \
+		} \
+		const int index = ksGltf_Find##typeCapitalized##By##nameCapitalized( scene, name, ksGltfNameHash_StringHash( name ) ); \
+		return ( index >= 0 ) ? &scene->type##s[index] : NULL; \
 	}
 
 GLTF_HASH( buffer,		Buffer,		name,		Name );
@@ -1375,6 +1765,16 @@ static unsigned char * ksGltf_ReadUri( const unsigned char * binaryBuffer, const
 		{
 			return ksGltf_ReadBase64( uri + 37, outSizeInBytes );
 		}
+		// Base64 glTF 2.0 binary buffer.
+		else if ( strncmp( uri, "data:application/gltf-buffer;base64,", 36 ) == 0 )
+		{
+			return ksGltf_ReadBase64( uri + 36, outSizeInBytes );
+		}
+		// Base64 JPEG image with the glTF 2.0 MIME type.
+		else if ( strncmp( uri, "data:image/jpeg;base64,", 23 ) == 0 )
+		{
+			return ksGltf_ReadBase64( uri + 23, outSizeInBytes );
+		}
 		// Base64 JPG, PNG, BMP, GIF, KTX image.
 		else if (	strncmp( uri, "data:image/jpg;base64,", 22 ) == 0 ||
 					strncmp( uri, "data:image/png;base64,", 22 ) == 0 ||
@@ -1423,6 +1823,7 @@ const char * ksGltf_GetImageContainerFromUri( const char * uri )
 	if ( strncmp( uri, "data:image/", 11 ) == 0 )
 	{
 		if ( strncmp( uri + 11, "jpg;", 4 ) == 0 ) { return "jpg"; }
+		if ( strncmp( uri + 11, "jpeg;", 5 ) == 0 ) { return "jpg"; }
 		if ( strncmp( uri + 11, "png;", 4 ) == 0 ) { return "png"; }
 		if ( strncmp( uri + 11, "bmp;", 4 ) == 0 ) { return "bmp"; }
 		if ( strncmp( uri + 11, "gif;", 4 ) == 0 ) { return "gif"; }
@@ -1750,6 +2151,30 @@ static ksGpuBlendFactor ksGltf_GetBlendFactor( const int factor )
 	}
 }
 
+static bool ksGltf_EqualRasterOperations( const ksGpuRasterOperations * a, const ksGpuRasterOperations * b )
+{
+	return	a->blendEnable == b->blendEnable &&
+			a->redWriteEnable == b->redWriteEnable &&
+			a->blueWriteEnable == b->blueWriteEnable &&
+			a->greenWriteEnable == b->greenWriteEnable &&
+			a->alphaWriteEnable == b->alphaWriteEnable &&
+			a->depthTestEnable == b->depthTestEnable &&
+			a->depthWriteEnable == b->depthWriteEnable &&
+			a->frontFace == b->frontFace &&
+			a->cullMode == b->cullMode &&
+			a->depthCompare == b->depthCompare &&
+			a->blendColor.x == b->blendColor.x &&
+			a->blendColor.y == b->blendColor.y &&
+			a->blendColor.z == b->blendColor.z &&
+			a->blendColor.w == b->blendColor.w &&
+			a->blendOpColor == b->blendOpColor &&
+			a->blendSrcColor == b->blendSrcColor &&
+			a->blendDstColor == b->blendDstColor &&
+			a->blendOpAlpha == b->blendOpAlpha &&
+			a->blendSrcAlpha == b->blendSrcAlpha &&
+			a->blendDstAlpha == b->blendDstAlpha;
+}
+
 static int ksGltf_GetVertexAttributeLocation( const ksGltfTechnique * technique, const unsigned char * nameStart, const unsigned char * nameEnd )
 {
 	for ( int i = 0; i < technique->attributeCount; i++ )
@@ -1789,6 +2214,20 @@ static void ksGltf_SetUniformStageFlag( const ksGltfTechnique * technique, const
 	assert( false );
 }
 
+// Returns the per-instance vertex attributes of an instanced technique. The inverse model matrix is
+// calculated on the CPU and only stored per instance when the technique uses the model inverse.
+static int ksGltf_GetInstanceAttribsFlags( const ksGltfTechnique * technique )
+{
+	for ( int i = 0; i < technique->uniformCount; i++ )
+	{
+		if ( technique->uniforms[i].semantic == GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE )
+		{
+			return VERTEX_ATTRIBUTE_FLAG_TRANSFORM | VERTEX_ATTRIBUTE_FLAG_TRANSFORM_INVERSE;
+		}
+	}
+	return VERTEX_ATTRIBUTE_FLAG_TRANSFORM;
+}
+
 #define JOINT_UNIFORM_BUFFER_NAME							"jointUniformBuffer"
 #define VIEW_PROJECTION_UNIFORM_BUFFER_NAME					"viewProjectionUniformBuffer"
 #define VIEW_PROJECTION_MULTI_VIEW_UNIFORM_BUFFER_NAME		"viewProjectionMultiViewUniformBuffer"
@@ -1800,7 +2239,8 @@ typedef enum
 	KS_GLSL_CONVERSION_FLAG_VIEW_PROJECTION_BUFFER	= BIT( 1 ),	// KHR_glsl_view_projection_buffer
 	KS_GLSL_CONVERSION_FLAG_MULTI_VIEW				= BIT( 2 ),	// KHR_glsl_multi_view
 	KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL			= BIT( 3 ),	// KHR_glsl_layout_opengl
-	KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN			= BIT( 4 )	// KHR_glsl_layout_vulkan
+	KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN			= BIT( 4 ),	// KHR_glsl_layout_vulkan
+	KS_GLSL_CONVERSION_FLAG_INSTANCE_TRANSFORM		= BIT( 5 )	// model matrix multiplied with a per-instance vertex attribute
 } ksGlslConversionFlags;
 
 typedef struct ksGltfInOutParm
@@ -1904,6 +2344,51 @@ unsigned char * ksGltf_ConvertShaderGLSL( const unsigned char * source, size_t *
 	const char * pushConstantInstanceName =
 					( ( conversion & KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) != 0 ) ? "pc." : "";
 
+	// Per-instance model matrix and its inverse that are stored after the vertex attributes of the technique.
+	// The inverse is calculated on the CPU and is only added when the technique uses the model inverse.
+	const bool instanceTransform = ( conversion & KS_GLSL_CONVERSION_FLAG_INSTANCE_TRANSFORM ) != 0;
+	const int instanceAttribsFlags = instanceTransform ? ksGltf_GetInstanceAttribsFlags( technique ) : 0;
+	const char * instanceTransformName = "";
+	const char * instanceTransformInverseName = "";
+	int instanceTransformLocation = 0;
+	int instanceTransformInverseLocation = 0;
+	for ( int i = 0, location = 0; technique->vertexAttributeLayout[i].attributeFlag != 0; i++ )
+	{
+		const ksGpuVertexAttribute * v = &technique->vertexAttributeLayout[i];
+		if ( v->attributeFlag == VERTEX_ATTRIBUTE_FLAG_TRANSFORM )
+		{
+			instanceTransformName = v->name;
+			instanceTransformLocation = location;
+		}
+		else if ( v->attributeFlag == VERTEX_ATTRIBUTE_FLAG_TRANSFORM_INVERSE )
+		{
+			instanceTransformInverseName = v->name;
+			instanceTransformInverseLocation = location;
+		}
+		if ( ( v->attributeFlag & ( technique->vertexAttribsFlags | instanceAttribsFlags ) ) != 0 )
+		{
+			location += v->locationCount;
+		}
+	}
+
+	// The model matrix and its inverse, optionally combined with the per-instance model matrix.
+	const char * modelName = ( newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] != NULL ) ? newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] : "";
+	const char * modelInverseName = ( newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] != NULL ) ? newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] : "";
+	char modelMatrixString[256];
+	char modelInverseMatrixString[256];
+	if ( instanceTransform )
+	{
+		snprintf( modelMatrixString, sizeof( modelMatrixString ), "( %s%s * %s )",
+					pushConstantInstanceName, modelName, instanceTransformName );
+		snprintf( modelInverseMatrixString, sizeof( modelInverseMatrixString ), "( %s * %s%s )",
+					instanceTransformInverseName, pushConstantInstanceName, modelInverseName );
+	}
+	else
+	{
+		snprintf( modelMatrixString, sizeof( modelMatrixString ), "%s%s", pushConstantInstanceName, modelName );
+		snprintf( modelInverseMatrixString, sizeof( modelInverseMatrixString ), "%s%s", pushConstantInstanceName, modelInverseName );
+	}
+
 	// Vertex and fragment out parameters.
 	const char * perVertexString =
 					"out gl_PerVertex { vec4 gl_Position; };\n";
@@ -1914,20 +2399,46 @@ unsigned char * ksGltf_ConvertShaderGLSL( const unsigned char * source, size_t *
 	const size_t fragColorStringLength =
 					strlen( fragColorString );
 
-	unsigned char * newSource = (unsigned char *) malloc( *sourceSize * 2 +
-						versionStringLength +
-						precisionStringLength +
-						perVertexExtensionStringLength +
-						layoutExtensionStringLength +
-						jointUniformSemanticStringLength +
-						jointUniformBufferStringLength +
-						viewProjectionUniformSemanticStringLength +
-						viewProjectionUniformBufferStringLength +
-						multiviewStringLength +
-						pushConstantStartStringLength +
-						pushConstantEndStringLength +
-						perVertexStringLength +
-						fragColorStringLength );
+	// The declarations added before the converted source print at most one line per uniform, semantic uniform and instance attribute.
+	size_t namesLength = strlen( instanceTransformName ) + strlen( instanceTransformInverseName );
+	size_t maxNameLength = 0;
+	for ( int i = 0; i < technique->uniformCount; i++ )
+	{
+		namesLength += strlen( technique->parms[i].name );
+		maxNameLength = MAX( maxNameLength, strlen( technique->parms[i].name ) );
+	}
+	size_t semanticNamesLength = 0;
+	for ( int i = 0; i < GLTF_UNIFORM_SEMANTIC_MAX; i++ )
+	{
+		semanticNamesLength += ( newSemanticUniforms[i] != NULL ) ? strlen( newSemanticUniforms[i] ) : 0;
+	}
+	const size_t maxDeclarationLength = 64;
+	const size_t headerSize =	versionStringLength +
+								precisionStringLength +
+								perVertexExtensionStringLength +
+								layoutExtensionStringLength +
+								jointUniformSemanticStringLength +
+								jointUniformBufferStringLength +
+								viewProjectionUniformSemanticStringLength +
+								viewProjectionUniformBufferStringLength +
+								multiviewStringLength +
+								pushConstantStartStringLength +
+								pushConstantEndStringLength +
+								perVertexStringLength +
+								fragColorStringLength +
+								namesLength + 4 * semanticNamesLength +
+								( technique->uniformCount + GLTF_UNIFORM_SEMANTIC_MAX + 2 ) * maxDeclarationLength;
+
+	// Every source token consumes at least one character and grows by at most the indentation, a layout
+	// qualifier and the longest replacement, which uses each semantic uniform name at most once.
+	// One more character is needed for the null terminator.
+	const size_t maxTokenGrowth =	16 + 1 + maxDeclarationLength + 1 +
+									semanticNamesLength + maxNameLength +
+									strlen( modelMatrixString ) + strlen( modelInverseMatrixString ) +
+									2 * strlen( multiviewArrayIndexString ) + strlen( pushConstantInstanceName );
+	const unsigned char * sourceEnd = source + *sourceSize;
+	size_t newSourceCapacity = headerSize + *sourceSize + maxTokenGrowth;
+	unsigned char * newSource = (unsigned char *) malloc( newSourceCapacity );
 	unsigned char * out = newSource;
 	const unsigned char * ptr = source;
 
@@ -2054,6 +2565,24 @@ unsigned char * ksGltf_ConvertShaderGLSL( const unsigned char * source, size_t *
 				}
 			}
 		}
+
+		// Optionally add a per-instance model matrix and its inverse.
+		if ( instanceTransform )
+		{
+			if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL | KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) ) != 0 )
+			{
+				out += sprintf( (char *)out, "layout( location = %d ) ", instanceTransformLocation );
+			}
+			out += sprintf( (char *)out, "in mat4 %s;\n", instanceTransformName );
+		}
+		if ( ( instanceAttribsFlags & VERTEX_ATTRIBUTE_FLAG_TRANSFORM_INVERSE ) != 0 )
+		{
+			if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL | KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) ) != 0 )
+			{
+				out += sprintf( (char *)out, "layout( location = %d ) ", instanceTransformInverseLocation );
+			}
+			out += sprintf( (char *)out, "in mat4 %s;\n", instanceTransformInverseName );
+		}
 	}
 
 	// Optionally add a push constant block.
@@ -2102,8 +2631,18 @@ unsigned char * ksGltf_ConvertShaderGLSL( const unsigned char * source, size_t *
 	int addSpace = 0;
 	int addTabs = 0;
 	bool newLine = true;
+	assert( (size_t)( out - newSource ) <= headerSize );
 	while ( ptr[0] != '\0' )
 	{
+		// Grow the new source when the rest of the source may not fit.
+		const size_t outSize = out - newSource;
+		if ( outSize + ( sourceEnd - ptr ) + maxTokenGrowth > newSourceCapacity )
+		{
+			newSourceCapacity = ( outSize + ( sourceEnd - ptr ) + maxTokenGrowth ) * 2;
+			newSource = (unsigned char *) realloc( newSource, newSourceCapacity );
+			out = newSource + outSize;
+		}
+
 		const unsigned char * token;
 		ksTokenInfo tokenInfo;
 		ptr = ksLexer_NextToken( source, ptr, &token, &tokenInfo );
@@ -2363,11 +2902,28 @@ unsigned char * ksGltf_ConvertShaderGLSL( const unsigned char * source, size_t *
 			// Optionally replace uniform usage.
 			if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_VIEW_PROJECTION_BUFFER | KS_GLSL_CONVERSION_FLAG_MULTI_VIEW ) ) != 0 )
 			{
+				if ( instanceTransform )
+				{
+					if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] ) )
+					{
+						assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
+						out += sprintf( (char *)out, "%s", modelMatrixString );
+						ksGltf_SetUniformStageFlag( technique, token, ptr, stage );
+						continue;
+					}
+					if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] ) )
+					{
+						assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
+						out += sprintf( (char *)out, "%s", modelInverseMatrixString );
+						ksGltf_SetUniformStageFlag( technique, token, ptr, stage );
+						continue;
+					}
+				}
 				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE_TRANSPOSE] ) )
 				{
 					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
-					out += sprintf( (char *)out, "transpose( mat3( %s%s ) )",
-							pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] );
+					out += sprintf( (char *)out, "transpose( mat3( %s ) )",
+							modelInverseMatrixString );
 					ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE], NULL, stage );
 					continue;
 				}
@@ -2402,47 +2958,47 @@ unsigned char * ksGltf_ConvertShaderGLSL( const unsigned char * source, size_t *
 				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW] ) )
 				{
 					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
-					out += sprintf( (char *)out, "%s%s * %s%s",
+					out += sprintf( (char *)out, "%s%s * %s",
 							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW], multiviewArrayIndexString,
-							pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] );
+							modelMatrixString );
 					ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL], NULL, stage );
 					continue;
 				}
 				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE] ) )
 				{
 					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
-					out += sprintf( (char *)out, "%s%s * %s%s",
+					out += sprintf( (char *)out, "%s%s * %s",
 							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE], multiviewArrayIndexString,
-							pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] );
+							modelInverseMatrixString );
 					ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE], NULL, stage );
 					continue;
 				}
 				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE_TRANSPOSE] ) )
 				{
 					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
-					out += sprintf( (char *)out, "transpose( mat3( %s%s ) ) * transpose( mat3( %s%s ) )",
+					out += sprintf( (char *)out, "transpose( mat3( %s%s ) ) * transpose( mat3( %s ) )",
 							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE], multiviewArrayIndexString,
-							pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] );
+							modelInverseMatrixString );
 					ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE], NULL, stage );
 					continue;
 				}
 				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION] ) )
 				{
 					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
-					out += sprintf( (char *)out, "%s%s * %s%s * %s%s",
+					out += sprintf( (char *)out, "%s%s * %s%s * %s",
 							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION], multiviewArrayIndexString,
 							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW], multiviewArrayIndexString,
-							pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] );
+							modelMatrixString );
 					ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL], NULL, stage );
 					continue;
 				}
 				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION_INVERSE] ) )
 				{
 					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
-					out += sprintf( (char *)out, "%s%s * %s%s * %s%s",
+					out += sprintf( (char *)out, "%s%s * %s%s * %s",
 							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE], multiviewArrayIndexString,
 							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE], multiviewArrayIndexString,
-							pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] );
+							modelInverseMatrixString );
 					ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE], NULL, stage );
 					continue;
 				}
@@ -2494,35 +3050,35 @@ unsigned char * ksGltf_ConvertShaderGLSL( const unsigned char * source, size_t *
 								found = true;
 								break;
 							case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW:
-								out += sprintf( (char *)out, "%s%s * %s%s * %s%s",
+								out += sprintf( (char *)out, "%s%s * %s * %s%s",
 										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW], multiviewArrayIndexString,
-										pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL],
+										modelMatrixString,
 										pushConstantInstanceName, technique->parms[i].name );
 								ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL], NULL, stage );
 								found = true;
 								break;
 							case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE:
-								out += sprintf( (char *)out, "%s%s * %s%s * %s%s",
+								out += sprintf( (char *)out, "%s%s * %s * %s%s",
 										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE], multiviewArrayIndexString,
-										pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE],
+										modelInverseMatrixString,
 										pushConstantInstanceName, technique->parms[i].name );
 								ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE], NULL, stage );
 								found = true;
 								break;
 							case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION:
-								out += sprintf( (char *)out, "%s%s * %s%s * %s%s * %s%s",
+								out += sprintf( (char *)out, "%s%s * %s%s * %s * %s%s",
 										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION], multiviewArrayIndexString,
 										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW], multiviewArrayIndexString,
-										pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL],
+										modelMatrixString,
 										pushConstantInstanceName, technique->parms[i].name );
 								ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL], NULL, stage );
 								found = true;
 								break;
 							case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION_INVERSE:
-								out += sprintf( (char *)out, "%s%s * %s%s * %s%s * %s%s",
+								out += sprintf( (char *)out, "%s%s * %s%s * %s * %s%s",
 										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE], multiviewArrayIndexString,
 										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE], multiviewArrayIndexString,
-										pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE],
+										modelInverseMatrixString,
 										pushConstantInstanceName, technique->parms[i].name );
 								ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE], NULL, stage );
 								found = true;
@@ -2630,15 +3186,19 @@ unsigned char * ksGltf_ConvertShaderGLSL( const unsigned char * source, size_t *
 
 #endif
 
-void ksGltf_CreateTechniqueProgram( ksGpuContext * context, ksGltfTechnique * technique, const ksGltfProgram * program,
-								const int conversion, const char * semanticUniforms[] )
+// Updates / replaces the uniforms of a technique for the shader conversion.
+void ksGltf_UpdateTechniqueUniforms( ksGltfTechniqueSource * source )
 {
+	ksGltfTechnique * technique = source->technique;
+	const int conversion = source->conversion;
+	const char ** semanticUniforms = source->semanticUniforms;
+	const char ** newSemanticUniforms = source->newSemanticUniforms;
+
+	memset( source->newSemanticUniforms, 0, sizeof( source->newSemanticUniforms ) );
+
 #if GRAPHICS_API_OPENGL == 1 || GRAPHICS_API_OPENGL_ES == 1 || GRAPHICS_API_VULKAN == 1
 	if ( conversion != KS_GLSL_CONVERSION_NONE )
 	{
-		const char * newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MAX] = { 0 };
-
-		// Update / replace technique uniforms.
 		{
 			// At most three new uniforms are added.
 			ksGpuProgramParm * newParms = (ksGpuProgramParm *) calloc( technique->uniformCount + 3, sizeof( ksGpuProgramParm ) );
@@ -2867,7 +3427,68 @@ void ksGltf_CreateTechniqueProgram( ksGpuContext * context, ksGltfTechnique * te
 			technique->uniforms = newUniforms;
 			technique->uniformCount = newUniformCount;
 		}
+	}
+#else
+	UNUSED_PARM( technique );
+	UNUSED_PARM( conversion );
+	UNUSED_PARM( semanticUniforms );
+	UNUSED_PARM( newSemanticUniforms );
+#endif
+}
+
+// Returns true if an instanced vertex shader can be derived from the technique. This is the case when the
+// converted shaders only depend on the node being drawn through the added model matrix uniforms, which the
+// instanced vertex shader multiplies with a per-instance model matrix.
+static bool ksGltf_CanInstanceTechnique( const ksGltfTechnique * technique, const int conversion )
+{
+	if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_VIEW_PROJECTION_BUFFER | KS_GLSL_CONVERSION_FLAG_MULTI_VIEW ) ) == 0 )
+	{
+		return false;
+	}
+
+	bool model = false;
+	for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
+	{
+		const ksGltfUniform * uniform = &technique->uniforms[uniformIndex];
+		switch ( uniform->semantic )
+		{
+			case GLTF_UNIFORM_SEMANTIC_LOCAL:
+			case GLTF_UNIFORM_SEMANTIC_JOINT_ARRAY:
+			case GLTF_UNIFORM_SEMANTIC_JOINT_BUFFER:
+				return false;
+			case GLTF_UNIFORM_SEMANTIC_MODEL:
+			case GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE:
+				if ( uniform->nodeName != NULL )
+				{
+					return false;
+				}
+				model = true;
+				break;
+			default:
+				break;
+		}
+	}
+	return model;
+}
+
+// Converts the shaders of the technique program. This does not touch the GPU context
+// and only writes to the technique, so it may run on any thread.
+void ksGltf_ConvertTechniqueProgram( ksGltfTechniqueSource * source )
+{
+	ksGltfTechnique * technique = source->technique;
+	const ksGltfProgram * program = source->program;
+	const int conversion = source->conversion;
+
+	source->vertexSource = NULL;
+	source->fragmentSource = NULL;
+	source->instancedVertexSource = NULL;
+	source->vertexSourceSize = 0;
+	source->fragmentSourceSize = 0;
+	source->instancedVertexSourceSize = 0;
 
+#if GRAPHICS_API_OPENGL == 1 || GRAPHICS_API_OPENGL_ES == 1 || GRAPHICS_API_VULKAN == 1
+	if ( conversion != KS_GLSL_CONVERSION_NONE )
+	{
 		ksGltfInOutParm inOutParms[16];
 		int inOutParmCount = 0;
 
@@ -2875,2136 +3496,5695 @@ void ksGltf_CreateTechniqueProgram( ksGpuContext * context, ksGltfTechnique * te
 		size_t fragmentSourceSize = program->fragmentSourceSize;
 
 		unsigned char * vertexSource = ksGltf_ConvertShaderGLSL( program->vertexSource, &vertexSourceSize, KS_GPU_PROGRAM_STAGE_FLAG_VERTEX, conversion,
-																	technique, semanticUniforms, newSemanticUniforms, inOutParms, &inOutParmCount );
+																	technique, source->semanticUniforms, source->newSemanticUniforms, inOutParms, &inOutParmCount );
 		unsigned char * fragmentSource = ksGltf_ConvertShaderGLSL( program->fragmentSource, &fragmentSourceSize, KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT, conversion,
-																	technique, semanticUniforms, newSemanticUniforms, inOutParms, &inOutParmCount );
+																	technique, source->semanticUniforms, source->newSemanticUniforms, inOutParms, &inOutParmCount );
 
 		for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
 		{
 			assert( technique->parms[uniformIndex].stageFlags != 0 );
 		}
 
-		ksGpuGraphicsProgram_Create( context, &technique->program,
-									vertexSource, vertexSourceSize,
-									fragmentSource, fragmentSourceSize,
-									technique->parms, technique->uniformCount,
-									technique->vertexAttributeLayout, technique->vertexAttribsFlags );
+		source->vertexSource = vertexSource;
+		source->fragmentSource = fragmentSource;
+		source->vertexSourceSize = vertexSourceSize;
+		source->fragmentSourceSize = fragmentSourceSize;
 
-		free( vertexSource );
-		free( fragmentSource );
+		// The fragment shader is shared with the instanced program and the in/out parameters are declared in the same order.
+		if ( ksGltf_CanInstanceTechnique( technique, conversion ) )
+		{
+			ksGltfInOutParm instancedInOutParms[16];
+			int instancedInOutParmCount = 0;
+
+			size_t instancedVertexSourceSize = program->vertexSourceSize;
+
+			source->instancedVertexSource = ksGltf_ConvertShaderGLSL( program->vertexSource, &instancedVertexSourceSize, KS_GPU_PROGRAM_STAGE_FLAG_VERTEX,
+																		conversion | KS_GLSL_CONVERSION_FLAG_INSTANCE_TRANSFORM, technique,
+																		source->semanticUniforms, source->newSemanticUniforms, instancedInOutParms, &instancedInOutParmCount );
+			source->instancedVertexSourceSize = instancedVertexSourceSize;
+		}
 	}
-	else
 #else
+	UNUSED_PARM( technique );
+	UNUSED_PARM( program );
 	UNUSED_PARM( conversion );
-	UNUSED_PARM( semanticUniforms );
 #endif
+}
+
+/*
+	Converted shaders are cached in memory and on disk. The cache is content addressed
+	with a hash of everything the conversion depends on: the GLSL version, the conversion
+	flags, the program sources, the vertex attributes and their layout, the semantic uniforms
+	and the updated technique uniforms. Besides the converted sources, a cache entry stores
+	the program stages of each uniform because those are set as a side effect of the conversion.
+
+	A cache file is written to a temporary file first and then renamed, such that a reader never
+	sees a partially written file. The payload of a cache file is also hashed, which rejects files
+	that are damaged in any other way. An index file records the size of each cache file and when
+	it was last used. After a scene is loaded, the least recently used cache files are removed
+	until the total size is below GLTF_SHADER_CACHE_MAX_SIZE. Cache files that are not in the index,
+	for instance because the index was deleted, are not counted and not removed.
+*/
+
+#define GLTF_SHADER_CACHE_MAGIC			0x4353534B		// "KSSC"
+#define GLTF_SHADER_CACHE_VERSION		4
+#define GLTF_SHADER_CACHE_PATH			OUTPUT_PATH "gltf_shader_cache_"
+#define GLTF_SHADER_CACHE_INDEX			OUTPUT_PATH "gltf_shader_cache_index.bin"
+#define GLTF_SHADER_CACHE_MAX_SIZE		( 16 * 1024 * 1024 )
+
+typedef struct ksGltfShaderCacheHeader
+{
+	uint64_t					hash;
+	uint64_t					payloadHash;				// hash of everything that follows the header
+	uint64_t					conversionTime;				// nanoseconds it took to convert the shaders
+	uint32_t					magic;
+	uint32_t					version;
+	uint32_t					uniformCount;
+	uint32_t					vertexSourceSize;
+	uint32_t					fragmentSourceSize;
+	uint32_t					instancedVertexSourceSize;	// zero if the technique is not instanced
+} ksGltfShaderCacheHeader;
+
+typedef struct ksGltfShaderCacheIndexEntry
+{
+	uint64_t					hash;
+	uint32_t					fileSize;
+	uint32_t					lastUse;					// value of the index use counter when last read or written
+} ksGltfShaderCacheIndexEntry;
+
+typedef struct ksGltfShaderCacheIndexHeader
+{
+	uint32_t					magic;
+	uint32_t					version;
+	uint32_t					useCounter;					// incremented every time a scene is loaded
+	uint32_t					entryCount;
+} ksGltfShaderCacheIndexHeader;
+
+// 64-bit FNV-1a
+static uint64_t ksGltf_HashBytes( uint64_t hash, const void * data, const size_t size )
+{
+	const unsigned char * bytes = (const unsigned char *)data;
+	for ( size_t i = 0; i < size; i++ )
 	{
-		ksGpuGraphicsProgram_Create( context, &technique->program,
-									program->vertexSource, program->vertexSourceSize,
-									program->fragmentSource, program->fragmentSourceSize,
-									technique->parms, technique->uniformCount,
-									technique->vertexAttributeLayout, technique->vertexAttribsFlags );
+		hash = ( hash ^ bytes[i] ) * 0x100000001B3ULL;
 	}
+	return hash;
 }
 
-// Sort the nodes such that parents come before their children and every sub-tree is a contiguous sequence of nodes.
-// Note that the node graph must be acyclic and no node may be a direct or indirect descendant of more than one node.
-static void ksGltf_SortNodes( ksGltfNode * nodes, const int nodeCount )
+static uint64_t ksGltf_HashString( uint64_t hash, const char * string )
 {
-	ksGltfNode * nodeStack = (ksGltfNode *) malloc( nodeCount * sizeof( ksGltfNode ) );
-	int stackSize = 0;
-	int stackOffset = 0;
-	for ( int nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++ )
+	if ( string == NULL )
 	{
-		bool foundParent = false;
-		for ( int nodeSearchIndex = 0; nodeSearchIndex < nodeCount; nodeSearchIndex++ )
-		{
-			for ( int childIndex = 0; childIndex < nodes[nodeSearchIndex].childCount; childIndex++ )
-			{
-				if ( strcmp( nodes[nodeSearchIndex].childNames[childIndex], nodes[nodeIndex].name ) == 0 )
-				{
-					foundParent = true;
-					break;
-				}
-			}
-		}
-		if ( !foundParent )
-		{
-			const int subTreeStartOffset = stackSize;
-			nodeStack[stackSize++] = nodes[nodeIndex];
-			while( stackOffset < stackSize )
-			{
-				const ksGltfNode * node = &nodeStack[stackOffset++];
-				for ( int childIndex = 0; childIndex < node->childCount; childIndex++ )
-				{
-					for ( int nodeSearchIndex = 0; nodeSearchIndex < nodeCount; nodeSearchIndex++ )
-					{
-						if ( strcmp( node->childNames[childIndex], nodes[nodeSearchIndex].name ) == 0 )
-						{
-							assert( stackSize < nodeCount );
-							nodeStack[stackSize++] = nodes[nodeSearchIndex];
-							break;
-						}
-					}
-				}
-			}
-			for ( int updateNodeIndex = subTreeStartOffset; updateNodeIndex < stackSize; updateNodeIndex++ )
-			{
-				nodeStack[updateNodeIndex].subTreeNodeCount = stackSize - updateNodeIndex;
-			}
-		}
+		const unsigned char none = 0xFF;
+		return ksGltf_HashBytes( hash, &none, 1 );
 	}
-	assert( stackSize == nodeCount );
-	memcpy( nodes, nodeStack, nodeCount * sizeof( nodes[0] ) );
-	free( nodeStack );
+	return ksGltf_HashBytes( hash, string, strlen( string ) + 1 );
 }
 
-#if defined( _MSC_VER )
-#define strcasecmp _stricmp
+static uint64_t ksGltf_HashInt( uint64_t hash, const int value )
+{
+	return ksGltf_HashBytes( hash, &value, sizeof( value ) );
+}
+
+// Must be called after the technique uniforms are updated.
+static uint64_t ksGltf_HashTechniqueSource( const ksGltfTechniqueSource * source )
+{
+	const ksGltfTechnique * technique = source->technique;
+	const ksGltfProgram * program = source->program;
+
+	uint64_t hash = 0xCBF29CE484222325ULL;
+	hash = ksGltf_HashInt( hash, GLTF_SHADER_CACHE_VERSION );
+#if defined( GLSL_VERSION )
+	hash = ksGltf_HashString( hash, GLSL_VERSION );
 #endif
+	hash = ksGltf_HashInt( hash, source->conversion );
+	hash = ksGltf_HashInt( hash, (int)program->vertexSourceSize );
+	hash = ksGltf_HashBytes( hash, program->vertexSource, program->vertexSourceSize );
+	hash = ksGltf_HashInt( hash, (int)program->fragmentSourceSize );
+	hash = ksGltf_HashBytes( hash, program->fragmentSource, program->fragmentSourceSize );
+	// The attribute locations are written into the converted vertex shader.
+	hash = ksGltf_HashInt( hash, technique->attributeCount );
+	for ( int attributeIndex = 0; attributeIndex < technique->attributeCount; attributeIndex++ )
+	{
+		hash = ksGltf_HashString( hash, technique->attributes[attributeIndex].name );
+		hash = ksGltf_HashInt( hash, technique->attributes[attributeIndex].location );
+	}
+	// The layout and the used attributes determine the name and location of the per-instance model matrix.
+	hash = ksGltf_HashInt( hash, technique->vertexAttribsFlags );
+	for ( int layoutIndex = 0; technique->vertexAttributeLayout[layoutIndex].attributeFlag != 0; layoutIndex++ )
+	{
+		const ksGpuVertexAttribute * v = &technique->vertexAttributeLayout[layoutIndex];
+		hash = ksGltf_HashInt( hash, v->attributeFlag );
+		hash = ksGltf_HashInt( hash, v->locationCount );
+		hash = ksGltf_HashString( hash, v->name );
+	}
+	for ( int semantic = 0; semantic < GLTF_UNIFORM_SEMANTIC_MAX; semantic++ )
+	{
+		hash = ksGltf_HashString( hash, source->semanticUniforms[semantic] );
+		hash = ksGltf_HashString( hash, source->newSemanticUniforms[semantic] );
+	}
+	hash = ksGltf_HashInt( hash, technique->uniformCount );
+	for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
+	{
+		hash = ksGltf_HashString( hash, technique->parms[uniformIndex].name );
+		hash = ksGltf_HashInt( hash, technique->parms[uniformIndex].type );
+		hash = ksGltf_HashInt( hash, technique->parms[uniformIndex].binding );
+		hash = ksGltf_HashInt( hash, technique->uniforms[uniformIndex].semantic );
+		hash = ksGltf_HashInt( hash, technique->uniforms[uniformIndex].nodeName != NULL );
+	}
+	return hash;
+}
 
-static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * scene, ksSceneSettings * settings, ksGpuRenderPass * renderPass )
+static void ksGltf_GetShaderCacheFileName( char * fileName, const size_t fileNameSize, const uint64_t hash )
 {
-	const ksNanoseconds t0 = GetTimeNanoseconds();
+	snprintf( fileName, fileNameSize, "%s%08X%08X.bin", GLTF_SHADER_CACHE_PATH, (uint32_t)( hash >> 32 ), (uint32_t)hash );
+}
 
-	memset( scene, 0, sizeof( ksGltfScene ) );
+// Moves a completely written temporary file in place. The rename does not replace an existing file on all platforms.
+static bool ksGltf_ReplaceFile( const char * tempFileName, const char * fileName )
+{
+	if ( rename( tempFileName, fileName ) != 0 )
+	{
+		remove( fileName );
+		if ( rename( tempFileName, fileName ) != 0 )
+		{
+			remove( tempFileName );
+			return false;
+		}
+	}
+	return true;
+}
 
-	// Based on a GL_MAX_UNIFORM_BLOCK_SIZE of 16384 on the ARM Mali.
-	const int MAX_JOINTS = 16384 / sizeof( ksMatrix4x4f );
+// Reads the converted shaders of a technique from the disk cache.
+static bool ksGltf_ReadShaderCache( ksGltfTechniqueSource * source )
+{
+	if ( source->conversion == KS_GLSL_CONVERSION_NONE )
+	{
+		return false;
+	}
 
-	ksJson * rootNode = ksJson_Create();
+	const ksNanoseconds startTime = GetTimeNanoseconds();
 
-	//
-	// Load either the glTF .json or .glb
-	//
+	char fileName[1024];
+	ksGltf_GetShaderCacheFileName( fileName, sizeof( fileName ), source->hash );
 
-	unsigned char * binaryBuffer = NULL;
-	size_t binaryBufferLength = 0;
+	FILE * file = fopen( fileName, "rb" );
+	if ( file == NULL )
+	{
+		return false;
+	}
 
-	const char * fileName = settings->glTF;
-	const size_t fileNameLength = strlen( fileName );
-	if ( fileNameLength > 4 && strcasecmp( &fileName[fileNameLength - 4], ".glb" ) == 0 )
+	ksGltfTechnique * technique = source->technique;
+
+	ksGltfShaderCacheHeader header;
+	if ( fread( &header, 1, sizeof( header ), file ) != sizeof( header ) ||
+			header.magic != GLTF_SHADER_CACHE_MAGIC ||
+			header.version != GLTF_SHADER_CACHE_VERSION ||
+			header.hash != source->hash ||
+			header.uniformCount != (uint32_t)technique->uniformCount ||
+			header.vertexSourceSize == 0 ||
+			header.fragmentSourceSize == 0 )
 	{
-		FILE * binaryFile = fopen( fileName, "rb" );
-		if ( binaryFile == NULL )
+		fclose( file );
+		return false;
+	}
+
+	uint32_t * stageFlags = (uint32_t *) malloc( ( header.uniformCount + 1 ) * sizeof( uint32_t ) );
+	unsigned char * vertexSource = (unsigned char *) malloc( header.vertexSourceSize );
+	unsigned char * fragmentSource = (unsigned char *) malloc( header.fragmentSourceSize );
+	unsigned char * instancedVertexSource = ( header.instancedVertexSourceSize != 0 ) ? (unsigned char *) malloc( header.instancedVertexSourceSize ) : NULL;
+
+	bool success =
+		fread( stageFlags, sizeof( uint32_t ), header.uniformCount, file ) == header.uniformCount &&
+		fread( vertexSource, 1, header.vertexSourceSize, file ) == header.vertexSourceSize &&
+		fread( fragmentSource, 1, header.fragmentSourceSize, file ) == header.fragmentSourceSize &&
+		( instancedVertexSource == NULL || fread( instancedVertexSource, 1, header.instancedVertexSourceSize, file ) == header.instancedVertexSourceSize );
+
+	fclose( file );
+
+	if ( success )
+	{
+		uint64_t payloadHash = 0xCBF29CE484222325ULL;
+		payloadHash = ksGltf_HashBytes( payloadHash, stageFlags, header.uniformCount * sizeof( uint32_t ) );
+		payloadHash = ksGltf_HashBytes( payloadHash, vertexSource, header.vertexSourceSize );
+		payloadHash = ksGltf_HashBytes( payloadHash, fragmentSource, header.fragmentSourceSize );
+		if ( instancedVertexSource != NULL )
 		{
-			ksJson_Destroy( rootNode );
-			Error( "Failed to open %s", fileName );
-			return false;
+			payloadHash = ksGltf_HashBytes( payloadHash, instancedVertexSource, header.instancedVertexSourceSize );
 		}
+		success = ( payloadHash == header.payloadHash );
+	}
 
-		ksGltfBinaryHeader header;
-		if ( fread( &header, 1, sizeof( header ), binaryFile ) != sizeof( header ) )
+	if ( !success )
+	{
+		free( stageFlags );
+		free( vertexSource );
+		free( fragmentSource );
+		free( instancedVertexSource );
+		return false;
+	}
+
+	for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
+	{
+		technique->parms[uniformIndex].stageFlags = (ksGpuProgramStageFlags)stageFlags[uniformIndex];
+	}
+	free( stageFlags );
+
+	source->vertexSource = vertexSource;
+	source->fragmentSource = fragmentSource;
+	source->instancedVertexSource = instancedVertexSource;
+	source->vertexSourceSize = header.vertexSourceSize;
+	source->fragmentSourceSize = header.fragmentSourceSize;
+	source->instancedVertexSourceSize = header.instancedVertexSourceSize;
+	source->conversionTime = (ksNanoseconds)header.conversionTime;
+	source->cacheTime = GetTimeNanoseconds() - startTime;
+	source->cacheFileSize = (uint32_t)( sizeof( header ) + header.uniformCount * sizeof( uint32_t ) +
+								header.vertexSourceSize + header.fragmentSourceSize + header.instancedVertexSourceSize );
+	return true;
+}
+
+// Writes the converted shaders of a technique to the disk cache.
+static void ksGltf_WriteShaderCache( ksGltfTechniqueSource * source )
+{
+	if ( source->vertexSource == NULL || source->fragmentSource == NULL )
+	{
+		return;
+	}
+
+	const ksNanoseconds startTime = GetTimeNanoseconds();
+
+	char fileName[1024];
+	ksGltf_GetShaderCacheFileName( fileName, sizeof( fileName ), source->hash );
+	char tempFileName[sizeof( fileName ) + 8];
+	snprintf( tempFileName, sizeof( tempFileName ), "%s.tmp", fileName );
+
+	FILE * file = fopen( tempFileName, "wb" );
+	if ( file == NULL )
+	{
+		return;
+	}
+
+	const ksGltfTechnique * technique = source->technique;
+
+	uint32_t * stageFlags = (uint32_t *) malloc( ( technique->uniformCount + 1 ) * sizeof( uint32_t ) );
+	for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
+	{
+		stageFlags[uniformIndex] = (uint32_t)technique->parms[uniformIndex].stageFlags;
+	}
+
+	ksGltfShaderCacheHeader header;
+	header.hash = source->hash;
+	header.conversionTime = (uint64_t)source->conversionTime;
+	header.magic = GLTF_SHADER_CACHE_MAGIC;
+	header.version = GLTF_SHADER_CACHE_VERSION;
+	header.uniformCount = (uint32_t)technique->uniformCount;
+	header.vertexSourceSize = (uint32_t)source->vertexSourceSize;
+	header.fragmentSourceSize = (uint32_t)source->fragmentSourceSize;
+	header.instancedVertexSourceSize = ( source->instancedVertexSource != NULL ) ? (uint32_t)source->instancedVertexSourceSize : 0;
+
+	header.payloadHash = 0xCBF29CE484222325ULL;
+	header.payloadHash = ksGltf_HashBytes( header.payloadHash, stageFlags, header.uniformCount * sizeof( uint32_t ) );
+	header.payloadHash = ksGltf_HashBytes( header.payloadHash, source->vertexSource, header.vertexSourceSize );
+	header.payloadHash = ksGltf_HashBytes( header.payloadHash, source->fragmentSource, header.fragmentSourceSize );
+	if ( source->instancedVertexSource != NULL )
+	{
+		header.payloadHash = ksGltf_HashBytes( header.payloadHash, source->instancedVertexSource, header.instancedVertexSourceSize );
+	}
+
+	bool success =
+		fwrite( &header, sizeof( header ), 1, file ) == 1 &&
+		fwrite( stageFlags, sizeof( uint32_t ), header.uniformCount, file ) == header.uniformCount &&
+		fwrite( source->vertexSource, 1, header.vertexSourceSize, file ) == header.vertexSourceSize &&
+		fwrite( source->fragmentSource, 1, header.fragmentSourceSize, file ) == header.fragmentSourceSize &&
+		( source->instancedVertexSource == NULL || fwrite( source->instancedVertexSource, 1, header.instancedVertexSourceSize, file ) == header.instancedVertexSourceSize );
+	success = ( fclose( file ) == 0 ) && success;
+
+	free( stageFlags );
+
+	if ( !success )
+	{
+		remove( tempFileName );
+		return;
+	}
+	if ( ksGltf_ReplaceFile( tempFileName, fileName ) )
+	{
+		source->cacheFileSize = (uint32_t)( sizeof( header ) + header.uniformCount * sizeof( uint32_t ) +
+									header.vertexSourceSize + header.fragmentSourceSize + header.instancedVertexSourceSize );
+	}
+	source->cacheTime = GetTimeNanoseconds() - startTime;
+}
+
+static int ksGltf_CompareShaderCacheIndexEntries( const void * a, const void * b )
+{
+	const uint32_t lastUseA = ((const ksGltfShaderCacheIndexEntry *)a)->lastUse;
+	const uint32_t lastUseB = ((const ksGltfShaderCacheIndexEntry *)b)->lastUse;
+	return ( lastUseA < lastUseB ) ? 1 : ( ( lastUseA > lastUseB ) ? -1 : 0 );
+}
+
+// Records the disk cache files used by a scene in the index and removes the least recently used files
+// until the total size of the cache is below the limit. Must be called after all load jobs completed.
+static void ksGltf_UpdateShaderCacheIndex( const ksGltfTechniqueSource * sources, const int sourceCount )
+{
+	ksGltfShaderCacheIndexHeader header;
+	ksGltfShaderCacheIndexEntry * entries = NULL;
+
+	FILE * file = fopen( GLTF_SHADER_CACHE_INDEX, "rb" );
+	bool valid = ( file != NULL ) &&
+					fread( &header, sizeof( header ), 1, file ) == 1 &&
+					header.magic == GLTF_SHADER_CACHE_MAGIC &&
+					header.version == GLTF_SHADER_CACHE_VERSION;
+	if ( valid )
+	{
+		entries = (ksGltfShaderCacheIndexEntry *) malloc( ( header.entryCount + sourceCount + 1 ) * sizeof( ksGltfShaderCacheIndexEntry ) );
+		valid = ( fread( entries, sizeof( ksGltfShaderCacheIndexEntry ), header.entryCount, file ) == header.entryCount );
+	}
+	if ( file != NULL )
+	{
+		fclose( file );
+	}
+	if ( !valid )
+	{
+		free( entries );
+		entries = (ksGltfShaderCacheIndexEntry *) malloc( ( sourceCount + 1 ) * sizeof( ksGltfShaderCacheIndexEntry ) );
+		header.magic = GLTF_SHADER_CACHE_MAGIC;
+		header.version = GLTF_SHADER_CACHE_VERSION;
+		header.useCounter = 0;
+		header.entryCount = 0;
+	}
+
+	header.useCounter++;
+
+	for ( int sourceIndex = 0; sourceIndex < sourceCount; sourceIndex++ )
+	{
+		const ksGltfTechniqueSource * source = &sources[sourceIndex];
+		if ( source->cacheFileSize == 0 )
 		{
-			fclose( binaryFile );
-			ksJson_Destroy( rootNode );
-			Error( "Failed to read glTF binary header %s", fileName );
-			return false;
+			continue;
 		}
-
-		if ( header.magic != GLTF_BINARY_MAGIC || header.version != GLTF_BINARY_VERSION || header.contentFormat != GLTF_BINARY_CONTENT_FORMAT )
+		uint32_t entryIndex = 0;
+		while ( entryIndex < header.entryCount && entries[entryIndex].hash != source->hash )
 		{
-			fclose( binaryFile );
-			ksJson_Destroy( rootNode );
-			Error( "Invalid glTF binary header %s", fileName );
-			return false;
+			entryIndex++;
+		}
+		if ( entryIndex == header.entryCount )
+		{
+			header.entryCount++;
 		}
+		entries[entryIndex].hash = source->hash;
+		entries[entryIndex].fileSize = source->cacheFileSize;
+		entries[entryIndex].lastUse = header.useCounter;
+	}
 
-		char * content = (char *) malloc( header.contentLength + 1 );
-		if ( fread( content, 1, header.contentLength, binaryFile ) != header.contentLength )
+	// Keep the most recently used files that fit and remove the others, except the files used by this scene.
+	qsort( entries, header.entryCount, sizeof( ksGltfShaderCacheIndexEntry ), ksGltf_CompareShaderCacheIndexEntries );
+	uint64_t totalSize = 0;
+	uint32_t keepCount = 0;
+	for ( uint32_t entryIndex = 0; entryIndex < header.entryCount; entryIndex++ )
+	{
+		totalSize += entries[entryIndex].fileSize;
+		if ( totalSize > GLTF_SHADER_CACHE_MAX_SIZE && entries[entryIndex].lastUse != header.useCounter )
 		{
-			free( content );
-			fclose( binaryFile );
-			ksJson_Destroy( rootNode );
-			Error( "Failed to read binary glTF content %s", fileName );
-			return false;
+			char fileName[1024];
+			ksGltf_GetShaderCacheFileName( fileName, sizeof( fileName ), entries[entryIndex].hash );
+			remove( fileName );
+			totalSize -= entries[entryIndex].fileSize;
+			continue;
 		}
-		content[header.contentLength] = '\0';	// make sure the buffer is zero terminated
+		entries[keepCount++] = entries[entryIndex];
+	}
+	header.entryCount = keepCount;
 
-		const char * errorString = "";
-		if ( !ksJson_ReadFromBuffer( rootNode, content, &errorString ) )
+	const char * tempFileName = GLTF_SHADER_CACHE_INDEX ".tmp";
+	file = fopen( tempFileName, "wb" );
+	if ( file != NULL )
+	{
+		bool success =
+			fwrite( &header, sizeof( header ), 1, file ) == 1 &&
+			fwrite( entries, sizeof( ksGltfShaderCacheIndexEntry ), header.entryCount, file ) == header.entryCount;
+		success = ( fclose( file ) == 0 ) && success;
+		if ( success )
 		{
-			free( content );
-			fclose( binaryFile );
-			ksJson_Destroy( rootNode );
-			Error( "Failed to load %s (%s)", fileName, errorString );
-			return false;
+			ksGltf_ReplaceFile( tempFileName, GLTF_SHADER_CACHE_INDEX );
 		}
+		else
+		{
+			remove( tempFileName );
+		}
+	}
 
-		free( content );
+	free( entries );
+}
 
-		assert( ( ( sizeof( header ) + header.contentLength ) & 3 ) == 0 );
+// Copies the converted shaders of an identical technique of the same scene.
+static void ksGltf_CopyTechniqueSource( ksGltfTechniqueSource * source, const ksGltfTechniqueSource * original )
+{
+	assert( source->technique->uniformCount == original->technique->uniformCount );
 
-		binaryBufferLength = header.length - header.contentLength - sizeof( header );
-		binaryBuffer = (unsigned char *) malloc( binaryBufferLength );
-		if ( fread( binaryBuffer, 1, binaryBufferLength, binaryFile ) != binaryBufferLength )
+	for ( int uniformIndex = 0; uniformIndex < source->technique->uniformCount; uniformIndex++ )
+	{
+		source->technique->parms[uniformIndex].stageFlags = original->technique->parms[uniformIndex].stageFlags;
+	}
+
+	source->vertexSource = NULL;
+	source->fragmentSource = NULL;
+	source->instancedVertexSource = NULL;
+	source->vertexSourceSize = 0;
+	source->fragmentSourceSize = 0;
+	source->instancedVertexSourceSize = 0;
+
+	if ( original->vertexSource != NULL && original->fragmentSource != NULL )
+	{
+		source->vertexSource = (unsigned char *) malloc( original->vertexSourceSize );
+		source->fragmentSource = (unsigned char *) malloc( original->fragmentSourceSize );
+		memcpy( source->vertexSource, original->vertexSource, original->vertexSourceSize );
+		memcpy( source->fragmentSource, original->fragmentSource, original->fragmentSourceSize );
+		source->vertexSourceSize = original->vertexSourceSize;
+		source->fragmentSourceSize = original->fragmentSourceSize;
+	}
+	if ( original->instancedVertexSource != NULL )
+	{
+		source->instancedVertexSource = (unsigned char *) malloc( original->instancedVertexSourceSize );
+		memcpy( source->instancedVertexSource, original->instancedVertexSource, original->instancedVertexSourceSize );
+		source->instancedVertexSourceSize = original->instancedVertexSourceSize;
+	}
+}
+
+// Creates the graphics program of a technique on the thread that owns the GPU context.
+void ksGltf_CreateTechniqueProgram( ksGpuContext * context, ksGltfTechniqueSource * source )
+{
+	ksGltfTechnique * technique = source->technique;
+	const ksGltfProgram * program = source->program;
+
+	if ( source->vertexSource != NULL && source->fragmentSource != NULL )
+	{
+		ksGpuGraphicsProgram_Create( context, &technique->program,
+									source->vertexSource, source->vertexSourceSize,
+									source->fragmentSource, source->fragmentSourceSize,
+									technique->parms, technique->uniformCount,
+									technique->vertexAttributeLayout, technique->vertexAttribsFlags );
+
+		// The instanced program reads the per-instance model matrix and its inverse from the instance buffer.
+		if ( source->instancedVertexSource != NULL )
 		{
-			free( binaryBuffer );
-			fclose( binaryFile );
-			ksJson_Destroy( rootNode );
-			Error( "Failed to read binary glTF content %s", fileName );
-			return false;
+			ksGpuGraphicsProgram_Create( context, &technique->instancedProgram,
+										source->instancedVertexSource, source->instancedVertexSourceSize,
+										source->fragmentSource, source->fragmentSourceSize,
+										technique->parms, technique->uniformCount,
+										technique->vertexAttributeLayout, technique->vertexAttribsFlags | ksGltf_GetInstanceAttribsFlags( technique ) );
+			technique->instanced = true;
+
+			free( source->instancedVertexSource );
+			source->instancedVertexSource = NULL;
 		}
 
-		fclose( binaryFile );
+		free( source->vertexSource );
+		free( source->fragmentSource );
+		source->vertexSource = NULL;
+		source->fragmentSource = NULL;
 	}
 	else
 	{
-		const char * errorString = "";
-		if ( !ksJson_ReadFromFile( rootNode, fileName, &errorString ) )
-		{
-			ksJson_Destroy( rootNode );
-			Error( "Failed to load %s (%s)", fileName, errorString );
-			return false;
-		}
+		ksGpuGraphicsProgram_Create( context, &technique->program,
+									program->vertexSource, program->vertexSourceSize,
+									program->fragmentSource, program->fragmentSourceSize,
+									technique->parms, technique->uniformCount,
+									technique->vertexAttributeLayout, technique->vertexAttribsFlags );
 	}
+}
 
-	//
-	// Check the glTF JSON version.
-	//
+// Sort the nodes such that parents come before their children and every sub-tree is a contiguous sequence of nodes.
+// Note that the node graph must be acyclic and no node may be a direct or indirect descendant of more than one node.
+// The children of node 'i' are the node indices childNodes[firstChild[i]] up to childNodes[firstChild[i + 1]].
+// The roots are found and the sub-trees are traversed breadth-first using only node indices.
+// Returns the new index of every node, which must be freed by the caller.
+static int * ksGltf_SortNodeGraph( ksGltfNode * nodes, const int nodeCount, const int * firstChild, const int * childNodes )
+{
+	int * nodeOrder = (int *) malloc( nodeCount * sizeof( int ) );
+	int * newNodeIndex = (int *) malloc( ( nodeCount + 1 ) * sizeof( int ) );
+	bool * hasParent = (bool *) malloc( nodeCount * sizeof( bool ) );
 
-	const ksJson * asset = ksJson_GetMemberByName( rootNode, "asset" );
-	const char * version = ksJson_GetString( ksJson_GetMemberByName( asset, "version" ), "1.0" );
-	if ( strcmp( version, GLTF_JSON_VERSION_10 ) != 0 && strcmp( version, GLTF_JSON_VERSION_101 ) != 0 )
+	memset( hasParent, 0, nodeCount * sizeof( bool ) );
+	for ( int offset = 0; offset < firstChild[nodeCount]; offset++ )
 	{
-		Error( "glTF version is %s instead of %s", version, GLTF_JSON_VERSION_10 );
-		ksJson_Destroy( rootNode );
-		return false;
+		hasParent[childNodes[offset]] = true;
 	}
 
-	//
-	// glTF buffers
-	//
+	ksGltfNode * sortedNodes = (ksGltfNode *) malloc( nodeCount * sizeof( ksGltfNode ) );
+	int orderSize = 0;
+	int orderOffset = 0;
+	for ( int nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++ )
 	{
-		const ksNanoseconds startTime = GetTimeNanoseconds();
-
-		const ksJson * buffers = ksJson_GetMemberByName( rootNode, "buffers" );
-		scene->bufferCount = ksJson_GetMemberCount( buffers );
-		scene->buffers = (ksGltfBuffer *) calloc( scene->bufferCount, sizeof( ksGltfBuffer ) );
-		for ( int bufferIndex = 0; bufferIndex < scene->bufferCount; bufferIndex++ )
+		if ( !hasParent[nodeIndex] )
 		{
-			const ksJson * buffer = ksJson_GetMemberByIndex( buffers, bufferIndex );
-			scene->buffers[bufferIndex].name = ksGltf_strdup( ksJson_GetMemberName( buffer ) );
-			scene->buffers[bufferIndex].byteLength = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( buffer, "byteLength" ), 0 );
-			scene->buffers[bufferIndex].type = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( buffer, "type" ), "" ) );
-			if ( strcmp( scene->buffers[bufferIndex].name, "binary_glTF" ) == 0 )
+			const int subTreeStartOffset = orderSize;
+			nodeOrder[orderSize++] = nodeIndex;
+			while ( orderOffset < orderSize )
 			{
-				assert( scene->buffers[bufferIndex].byteLength == binaryBufferLength );
-				scene->buffers[bufferIndex].bufferData = binaryBuffer;
+				const int parentIndex = nodeOrder[orderOffset++];
+				for ( int offset = firstChild[parentIndex]; offset < firstChild[parentIndex + 1]; offset++ )
+				{
+					assert( orderSize < nodeCount );
+					nodeOrder[orderSize++] = childNodes[offset];
+				}
 			}
-			else
+			for ( int updateNodeIndex = subTreeStartOffset; updateNodeIndex < orderSize; updateNodeIndex++ )
 			{
-				scene->buffers[bufferIndex].bufferData = ksGltf_ReadUri( binaryBuffer, ksJson_GetString( ksJson_GetMemberByName( buffer, "uri" ), "" ), NULL );
+				sortedNodes[updateNodeIndex] = nodes[nodeOrder[updateNodeIndex]];
+				sortedNodes[updateNodeIndex].subTreeNodeCount = orderSize - updateNodeIndex;
+				newNodeIndex[nodeOrder[updateNodeIndex]] = updateNodeIndex;
 			}
-			assert( scene->buffers[bufferIndex].name[0] != '\0' );
-			assert( scene->buffers[bufferIndex].byteLength != 0 );
-			assert( scene->buffers[bufferIndex].bufferData != NULL );
 		}
-		ksGltf_CreateBufferNameHash( scene );
-
-		const ksNanoseconds endTime = GetTimeNanoseconds();
-		Print( "%1.3f seconds to load buffers\n", ( endTime - startTime ) * 1e-9f );
 	}
+	assert( orderSize == nodeCount );
+	memcpy( nodes, sortedNodes, nodeCount * sizeof( nodes[0] ) );
 
-	//
-	// glTF bufferViews
-	//
-	{
-		const ksNanoseconds startTime = GetTimeNanoseconds();
+	free( sortedNodes );
+	free( hasParent );
+	free( nodeOrder );
 
-		const ksJson * bufferViews = ksJson_GetMemberByName( rootNode, "bufferViews" );
-		scene->bufferViewCount = ksJson_GetMemberCount( bufferViews );
-		scene->bufferViews = (ksGltfBufferView *) calloc( scene->bufferViewCount, sizeof( ksGltfBufferView ) );
-		for ( int bufferViewIndex = 0; bufferViewIndex < scene->bufferViewCount; bufferViewIndex++ )
-		{
-			const ksJson * view = ksJson_GetMemberByIndex( bufferViews, bufferViewIndex );
-			scene->bufferViews[bufferViewIndex].name = ksGltf_strdup( ksJson_GetMemberName( view ) );
-			scene->bufferViews[bufferViewIndex].buffer = ksGltf_GetBufferByName( scene, ksJson_GetString( ksJson_GetMemberByName( view, "buffer" ), "" ) );
-			scene->bufferViews[bufferViewIndex].byteOffset = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( view, "byteOffset" ), 0 );
-			scene->bufferViews[bufferViewIndex].byteLength = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( view, "byteLength" ), 0 );
-			scene->bufferViews[bufferViewIndex].target = ksJson_GetUint16( ksJson_GetMemberByName( view, "target" ), 0 );
-			assert( scene->bufferViews[bufferViewIndex].name[0] != '\0' );
-			assert( scene->bufferViews[bufferViewIndex].buffer != NULL );
-			assert( scene->bufferViews[bufferViewIndex].byteLength != 0 );
-			assert( scene->bufferViews[bufferViewIndex].byteOffset +
-					scene->bufferViews[bufferViewIndex].byteLength <=
-					scene->bufferViews[bufferViewIndex].buffer->byteLength );
-		}
-		ksGltf_CreateBufferViewNameHash( scene );
+	return newNodeIndex;
+}
 
-		const ksNanoseconds endTime = GetTimeNanoseconds();
-		Print( "%1.3f seconds to load buffer views\n", ( endTime - startTime ) * 1e-9f );
+// Sort glTF 1.0 nodes, which reference their children by name. The child names are resolved once
+// through a temporary name hash table.
+static void ksGltf_SortNodes( ksGltfNode * nodes, const int nodeCount )
+{
+	int totalChildCount = 0;
+	for ( int nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++ )
+	{
+		totalChildCount += nodes[nodeIndex].childCount;
 	}
 
-	//
-	// glTF accessors
-	//
+	int * firstChild = (int *) malloc( ( nodeCount + 1 ) * sizeof( int ) );
+	int * childNodes = (int *) malloc( ( totalChildCount + 1 ) * sizeof( int ) );
+
+	// Insert in order so that a name that occurs more than once resolves to the first node with that name.
+	ksGltfNameHash nodeNameHash;
+	ksGltfNameHash_Create( &nodeNameHash, nodeCount );
+	for ( int nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++ )
 	{
-		const ksNanoseconds startTime = GetTimeNanoseconds();
+		ksGltfNameHash_Insert( &nodeNameHash, ksGltfNameHash_StringHash( nodes[nodeIndex].name ), nodeIndex );
+	}
 
-		const ksJson * accessors = ksJson_GetMemberByName( rootNode, "accessors" );
-		scene->accessorCount = ksJson_GetMemberCount( accessors );
-		scene->accessors = (ksGltfAccessor *) calloc( scene->accessorCount, sizeof( ksGltfAccessor ) );
-		for ( int accessorIndex = 0; accessorIndex < scene->accessorCount; accessorIndex++ )
+	int childOffset = 0;
+	for ( int nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++ )
+	{
+		firstChild[nodeIndex] = childOffset;
+		for ( int childIndex = 0; childIndex < nodes[nodeIndex].childCount; childIndex++ )
 		{
-			const ksJson * access = ksJson_GetMemberByIndex( accessors, accessorIndex );
-			scene->accessors[accessorIndex].name = ksGltf_strdup( ksJson_GetMemberName( access ) );
-			scene->accessors[accessorIndex].bufferView = ksGltf_GetBufferViewByName( scene, ksJson_GetString( ksJson_GetMemberByName( access, "bufferView" ), "" ) );
-			scene->accessors[accessorIndex].byteOffset = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( access, "byteOffset" ), 0 );
-			scene->accessors[accessorIndex].byteStride = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( access, "byteStride" ), 0 );
-			scene->accessors[accessorIndex].componentType = ksJson_GetUint16( ksJson_GetMemberByName( access, "componentType" ), 0 );
-			scene->accessors[accessorIndex].count = ksJson_GetInt32( ksJson_GetMemberByName( access, "count" ), 0 );
-			scene->accessors[accessorIndex].type =  ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( access, "type" ), "" ) );
-			const ksJson * min = ksJson_GetMemberByName( access, "min" );
-			const ksJson * max = ksJson_GetMemberByName( access, "max" );
-			if ( min != NULL && max != NULL )
+			const char * childName = nodes[nodeIndex].childNames[childIndex];
+			const uint32_t hash = ksGltfNameHash_StringHash( childName );
+			int childNodeIndex = -1;
+			for ( int slot = ksGltfNameHash_FirstSlot( &nodeNameHash, hash ); nodeNameHash.indices[slot] >= 0; slot = ( slot + 1 ) & ( nodeNameHash.size - 1 ) )
 			{
-				int componentCount = 0;
-				if ( strcmp( scene->accessors[accessorIndex].type, "SCALAR" ) == 0 ) { componentCount = 1; }
-				else if ( strcmp( scene->accessors[accessorIndex].type, "VEC2" ) == 0 ) { componentCount = 2; }
-				else if ( strcmp( scene->accessors[accessorIndex].type, "VEC3" ) == 0 ) { componentCount = 3; }
-				else if ( strcmp( scene->accessors[accessorIndex].type, "VEC4" ) == 0 ) { componentCount = 4; }
-				else if ( strcmp( scene->accessors[accessorIndex].type, "MAT2" ) == 0 ) { componentCount = 4; }
-				else if ( strcmp( scene->accessors[accessorIndex].type, "MAT3" ) == 0 ) { componentCount = 9; }
-				else if ( strcmp( scene->accessors[accessorIndex].type, "MAT4" ) == 0 ) { componentCount = 16; }
-
-				switch ( scene->accessors[accessorIndex].componentType )
+				if ( nodeNameHash.hashes[slot] == hash && strcmp( nodes[nodeNameHash.indices[slot]].name, childName ) == 0 )
 				{
-					case GL_BYTE:
-					case GL_UNSIGNED_BYTE:
-					case GL_SHORT:
-					case GL_UNSIGNED_SHORT:
-						ksGltf_ParseIntArray( scene->accessors[accessorIndex].intMin, componentCount, min );
-						ksGltf_ParseIntArray( scene->accessors[accessorIndex].intMax, componentCount, max );
-						break;
-					case GL_FLOAT:
-						ksGltf_ParseFloatArray( scene->accessors[accessorIndex].floatMin, componentCount, min );
-						ksGltf_ParseFloatArray( scene->accessors[accessorIndex].floatMax, componentCount, max );
-						break;
+					childNodeIndex = nodeNameHash.indices[slot];
+					break;
 				}
 			}
-			assert( scene->accessors[accessorIndex].name[0] != '\0' );
-			assert( scene->accessors[accessorIndex].bufferView != NULL );
-			assert( scene->accessors[accessorIndex].componentType != 0 );
-			assert( scene->accessors[accessorIndex].count != 0 );
-			assert( scene->accessors[accessorIndex].type[0] != '\0' );
-			assert( scene->accessors[accessorIndex].byteOffset +
-					scene->accessors[accessorIndex].count *
-					scene->accessors[accessorIndex].byteStride <=
-					scene->accessors[accessorIndex].bufferView->byteLength );
+			if ( childNodeIndex >= 0 )
+			{
+				childNodes[childOffset++] = childNodeIndex;
+			}
 		}
-		ksGltf_CreateAccessorNameHash( scene );
+	}
+	firstChild[nodeCount] = childOffset;
 
-		const ksNanoseconds endTime = GetTimeNanoseconds();
-		Print( "%1.3f seconds to load accessors\n", ( endTime - startTime ) * 1e-9f );
+	free( ksGltf_SortNodeGraph( nodes, nodeCount, firstChild, childNodes ) );
+
+	free( childNodes );
+	free( firstChild );
+	ksGltfNameHash_Destroy( &nodeNameHash );
+}
+
+static const float * ksGltf_GetChannelValues( const ksGltfAnimationChannel * channel, const ksGltfChannelType type )
+{
+	switch ( type )
+	{
+		case GLTF_CHANNEL_TRANSLATION:	return ( channel->translation != NULL ) ? &channel->translation[0].x : NULL;
+		case GLTF_CHANNEL_ROTATION:		return ( channel->rotation != NULL ) ? &channel->rotation[0].x : NULL;
+		case GLTF_CHANNEL_SCALE:		return ( channel->scale != NULL ) ? &channel->scale[0].x : NULL;
+		default:						return NULL;
 	}
+}
 
-	//
-	// glTF images
-	//
+#if defined( _MSC_VER )
+#define strcasecmp _stricmp
+#endif
+
+static void ksGltf_LoadJobThread( void * data )
+{
+	ksGltfLoadJobs * loadJobs = (ksGltfLoadJobs *)data;
+
+	for ( ; ; )
 	{
-		const ksNanoseconds startTime = GetTimeNanoseconds();
+		const unsigned int jobIndex = ksAtomicUint32_Increment( &loadJobs->nextJob ) - 1;
+		if ( jobIndex >= (unsigned int)loadJobs->jobCount )
+		{
+			break;
+		}
 
-		const ksJson * images = ksJson_GetMemberByName( rootNode, "images" );
-		scene->imageCount = ksJson_GetMemberCount( images );
-		scene->images = (ksGltfImage *) calloc( scene->imageCount, sizeof( ksGltfImage ) );
-		for ( int imageIndex = 0; imageIndex < scene->imageCount; imageIndex++ )
+		const ksGltfLoadJob * job = &loadJobs->jobs[jobIndex];
+		if ( job->uri != NULL )
 		{
-			const ksJson * image = ksJson_GetMemberByIndex( images, imageIndex );
-			scene->images[imageIndex].name = ksGltf_strdup( ksJson_GetMemberName( image ) );
-			char * baseUri = ksGltf_ParseUri( scene, image, "uri" );
+			*job->data = ksGltf_ReadUri( loadJobs->binaryBuffer, job->uri, job->dataSize );
+		}
+		else if ( job->techniqueSource != NULL )
+		{
+			if ( ksGltf_ReadShaderCache( job->techniqueSource ) )
+			{
+				job->techniqueSource->cacheResult = GLTF_SHADER_CACHE_HIT_DISK;
+			}
+			else
+			{
+				const ksNanoseconds startTime = GetTimeNanoseconds();
+				ksGltf_ConvertTechniqueProgram( job->techniqueSource );
+				job->techniqueSource->conversionTime = GetTimeNanoseconds() - startTime;
+				ksGltf_WriteShaderCache( job->techniqueSource );
+				job->techniqueSource->cacheResult = GLTF_SHADER_CACHE_MISS;
+			}
+		}
+	}
+}
 
-			assert( scene->images[imageIndex].name[0] != '\0' );
-			assert( baseUri != '\0' );
+static ksGltfLoadJob * ksGltf_AddLoadJob( ksGltfLoadJobs * loadJobs )
+{
+	if ( loadJobs->jobCount >= loadJobs->maxJobs )
+	{
+		loadJobs->maxJobs = ( loadJobs->maxJobs > 0 ) ? loadJobs->maxJobs * 2 : 64;
+		loadJobs->jobs = (ksGltfLoadJob *) realloc( loadJobs->jobs, loadJobs->maxJobs * sizeof( ksGltfLoadJob ) );
+	}
+	ksGltfLoadJob * job = &loadJobs->jobs[loadJobs->jobCount++];
+	memset( job, 0, sizeof( ksGltfLoadJob ) );
+	return job;
+}
 
-			const ksJson * extensions = ksJson_GetMemberByName( image, "extensions" );
-			if ( extensions != NULL )
+// Runs all added load jobs on the worker threads and waits for them to complete.
+static void ksGltf_RunLoadJobs( ksGltfLoadJobs * loadJobs )
+{
+	loadJobs->nextJob = 0;
+	if ( loadJobs->jobCount > 1 )
+	{
+		ksThreadPool_Submit( loadJobs->threadPool, ksGltf_LoadJobThread, loadJobs );
+		ksThreadPool_Join( loadJobs->threadPool );
+	}
+	else
+	{
+		ksGltf_LoadJobThread( loadJobs );
+	}
+	loadJobs->jobCount = 0;
+}
+
+// Compiles the uniforms of the material technique and the material values into a flat list of operations.
+// Everything that can be resolved at load time is resolved here, so rendering only has to walk the list.
+// Default values that are overridden by a material value are dropped.
+static void ksGltf_CompileUniformOps( ksGltfScene * scene, ksGltfMaterial * material )
+{
+	const ksGltfTechnique * technique = material->technique;
+
+	material->uniformOps = (ksGltfUniformOp *) malloc( ( technique->uniformCount + material->valueCount + 1 ) * sizeof( ksGltfUniformOp ) );
+	material->uniformOpCount = 0;
+
+	for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
+	{
+		const ksGltfUniform * uniform = &technique->uniforms[uniformIndex];
+
+		ksGltfUniformOp op;
+		memset( &op, 0, sizeof( op ) );
+		op.index = uniform->index;
+
+		if ( uniform->node != NULL )
+		{
+			op.type = GLTF_UNIFORM_OP_MATRIX;
+			op.matrix = &scene->state.nodeState[(int)( uniform->node - scene->nodes )].globalTransform;
+		}
+		else
+		{
+			switch ( uniform->semantic )
 			{
-				const ksJson * KHR_image_versions = ksJson_GetMemberByName( extensions, "KHR_image_versions" );
-				if ( KHR_image_versions != NULL )
+				case GLTF_UNIFORM_SEMANTIC_DEFAULT_VALUE:
 				{
-					const ksJson * versions = ksJson_GetMemberByName( KHR_image_versions, "versions" );
-					const int versionCount = ksJson_GetMemberCount( versions );
-					scene->images[imageIndex].versions = (ksGltfImageVersion *) calloc( versionCount + 1, sizeof( ksGltfImageVersion ) );
-					scene->images[imageIndex].versionCount = versionCount + 1;
-					for ( int versionIndex = 0; versionIndex < versionCount; versionIndex++ )
+					bool overridden = false;
+					for ( int valueIndex = 0; valueIndex < material->valueCount; valueIndex++ )
 					{
-						const ksJson * v = ksJson_GetMemberByIndex( versions, versionIndex );
-						scene->images[imageIndex].versions[versionIndex].container = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( v, "container" ), "" ) );
-						scene->images[imageIndex].versions[versionIndex].glInternalFormat = ksJson_GetUint32( ksJson_GetMemberByName( v, "glInternalFormat" ), 0 );
-						scene->images[imageIndex].versions[versionIndex].uri = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( v, "uri" ), "" ) );
+						overridden |= ( material->values[valueIndex].uniform == uniform );
 					}
+					if ( overridden )
+					{
+						continue;
+					}
+					op.type = GLTF_UNIFORM_OP_VALUE;
+					op.uniform = uniform;
+					op.value = &uniform->defaultValue;
+					break;
 				}
+				case GLTF_UNIFORM_SEMANTIC_NONE:								continue;
+				case GLTF_UNIFORM_SEMANTIC_VIEW:								assert( false ); continue;	// replaced by KHR_glsl_view_projection_buffer
+				case GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE:						assert( false ); continue;	// replaced by KHR_glsl_view_projection_buffer
+				case GLTF_UNIFORM_SEMANTIC_PROJECTION:							assert( false ); continue;	// replaced by KHR_glsl_view_projection_buffer
+				case GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE:					assert( false ); continue;	// replaced by KHR_glsl_view_projection_buffer
+				case GLTF_UNIFORM_SEMANTIC_LOCAL:								op.type = GLTF_UNIFORM_OP_DRAW_MATRIX; op.slot = GLTF_DRAW_MATRIX_LOCAL; break;
+				case GLTF_UNIFORM_SEMANTIC_MODEL:								op.type = GLTF_UNIFORM_OP_DRAW_MATRIX; op.slot = GLTF_DRAW_MATRIX_MODEL; break;
+				case GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE:						op.type = GLTF_UNIFORM_OP_DRAW_MATRIX; op.slot = GLTF_DRAW_MATRIX_MODEL_INVERSE; break;
+				case GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE_TRANSPOSE:				assert( false ); continue;	// replaced by KHR_glsl_view_projection_buffer
+				case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW:							assert( false ); continue;	// replaced by KHR_glsl_view_projection_buffer
+				case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE:					assert( false ); continue;	// replaced by KHR_glsl_view_projection_buffer
+				case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE_TRANSPOSE:		assert( false ); continue;	// replaced by KHR_glsl_view_projection_buffer
+				case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION:				assert( false ); continue;	// replaced by KHR_glsl_view_projection_buffer
+				case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION_INVERSE:		assert( false ); continue;	// replaced by KHR_glsl_view_projection_buffer
+				case GLTF_UNIFORM_SEMANTIC_VIEWPORT:							op.type = GLTF_UNIFORM_OP_VIEWPORT; break;
+				case GLTF_UNIFORM_SEMANTIC_JOINT_ARRAY:							assert( false ); continue;	// replaced by KHR_glsl_joint_buffer
+				case GLTF_UNIFORM_SEMANTIC_JOINT_BUFFER:						op.type = GLTF_UNIFORM_OP_DRAW_JOINT_BUFFER; break;
+				case GLTF_UNIFORM_SEMANTIC_VIEW_PROJECTION_BUFFER:				op.type = GLTF_UNIFORM_OP_VIEW_PROJECTION_BUFFER; break;
+				case GLTF_UNIFORM_SEMANTIC_VIEW_PROJECTION_MULTI_VIEW_BUFFER:	op.type = GLTF_UNIFORM_OP_VIEW_PROJECTION_BUFFER; break;
+				default:														continue;
 			}
-			if ( scene->images[imageIndex].versions == NULL )
-			{
-				scene->images[imageIndex].versions = (ksGltfImageVersion *) calloc( 1, sizeof( ksGltfImageVersion ) );
-				scene->images[imageIndex].versionCount = 1;
-			}
-			const int count = scene->images[imageIndex].versionCount;
-			scene->images[imageIndex].versions[count - 1].container = ksGltf_strdup( ksGltf_GetImageContainerFromUri( baseUri ) );
-			scene->images[imageIndex].versions[count - 1].glInternalFormat = ksGltf_GetImageInternalFormatFromUri( binaryBuffer, baseUri );
-			scene->images[imageIndex].versions[count - 1].uri = baseUri;
 		}
-		ksGltf_CreateImageNameHash( scene );
 
-		const ksNanoseconds endTime = GetTimeNanoseconds();
-		Print( "%1.3f seconds to load images\n", ( endTime - startTime ) * 1e-9f );
+		material->uniformOps[material->uniformOpCount++] = op;
 	}
 
-	//
-	// glTF samplers
-	//
+	for ( int valueIndex = 0; valueIndex < material->valueCount; valueIndex++ )
 	{
-		const ksNanoseconds startTime = GetTimeNanoseconds();
-
-		const ksJson * samplers = ksJson_GetMemberByName( rootNode, "samplers" );
-		scene->samplerCount = ksJson_GetMemberCount( samplers );
-		scene->samplers = (ksGltfSampler *) calloc( scene->samplerCount, sizeof( ksGltfSampler ) );
-		for ( int samplerIndex = 0; samplerIndex < scene->samplerCount; samplerIndex++ )
+		const ksGltfMaterialValue * value = &material->values[valueIndex];
+		if ( value->uniform == NULL )
 		{
-			const ksJson * sampler = ksJson_GetMemberByIndex( samplers, samplerIndex );
-			scene->samplers[samplerIndex].name = ksGltf_strdup( ksJson_GetMemberName( sampler ) );
-			scene->samplers[samplerIndex].magFilter = ksJson_GetUint16( ksJson_GetMemberByName( sampler, "magFilter" ), GL_LINEAR );
-			scene->samplers[samplerIndex].minFilter = ksJson_GetUint16( ksJson_GetMemberByName( sampler, "minFilter" ), GL_NEAREST_MIPMAP_LINEAR );
-			scene->samplers[samplerIndex].wrapS = ksJson_GetUint16( ksJson_GetMemberByName( sampler, "wrapS" ), GL_REPEAT );
-			scene->samplers[samplerIndex].wrapT = ksJson_GetUint16( ksJson_GetMemberByName( sampler, "wrapT" ), GL_REPEAT );
-			assert( scene->samplers[samplerIndex].name[0] != '\0' );
+			continue;
 		}
-		ksGltf_CreateSamplerNameHash( scene );
 
-		const ksNanoseconds endTime = GetTimeNanoseconds();
-		Print( "%1.3f seconds to load samplers\n", ( endTime - startTime ) * 1e-9f );
+		ksGltfUniformOp op;
+		memset( &op, 0, sizeof( op ) );
+		op.type = GLTF_UNIFORM_OP_VALUE;
+		op.index = value->uniform->index;
+		op.uniform = value->uniform;
+		op.value = &value->value;
+
+		material->uniformOps[material->uniformOpCount++] = op;
 	}
+}
 
-	//
-	// glTF textures
-	//
+// Loads the techniques and converts, compiles and links their shader programs. The shaders of the programs
+// must have been loaded. Techniques with identical shader conversions share the converted programs.
+static void ksGltf_LoadTechniques( ksGpuContext * context, ksGltfScene * scene, ksSceneSettings * settings, const ksJson * techniques, ksGltfLoadJobs * loadJobs )
+{
+	const ksNanoseconds startTime = GetTimeNanoseconds();
+
+	scene->techniqueCount = ksJson_GetMemberCount( techniques );
+	scene->techniques = (ksGltfTechnique *) calloc( scene->techniqueCount, sizeof( ksGltfTechnique ) );
+	ksGltfTechniqueSource * techniqueSources = (ksGltfTechniqueSource *) calloc( scene->techniqueCount, sizeof( ksGltfTechniqueSource ) );
+	int pipelineRankCount = 0;
+	for ( int techniqueIndex = 0; techniqueIndex < scene->techniqueCount; techniqueIndex++ )
 	{
-		const ksNanoseconds startTime = GetTimeNanoseconds();
+		const ksJson * technique = ksJson_GetMemberByIndex( techniques, techniqueIndex );
+		scene->techniques[techniqueIndex].name = ksGltf_strdup( ksJson_GetMemberName( technique ) );
 
-		const ksJson * textures = ksJson_GetMemberByName( rootNode, "textures" );
-		scene->textureCount = ksJson_GetMemberCount( textures );
-		scene->textures = (ksGltfTexture *) calloc( scene->textureCount, sizeof( ksGltfTexture ) );
-		for ( int textureIndex = 0; textureIndex < scene->textureCount; textureIndex++ )
-		{
-			const ksJson * texture = ksJson_GetMemberByIndex( textures, textureIndex );
-			scene->textures[textureIndex].name = ksGltf_strdup( ksJson_GetMemberName( texture ) );
-			scene->textures[textureIndex].image = ksGltf_GetImageByName( scene, ksJson_GetString( ksJson_GetMemberByName( texture, "source" ), "" ) );
-			scene->textures[textureIndex].sampler = ksGltf_GetSamplerByName( scene, ksJson_GetString( ksJson_GetMemberByName( texture, "sampler" ), "" ) );
+		assert( scene->techniques[techniqueIndex].name[0] != '\0' );
 
-			assert( scene->textures[textureIndex].name[0] != '\0' );
-			assert( scene->textures[textureIndex].image != NULL );
-			//assert( scene->textures[textureIndex].sampler != NULL );
+		const ksJson * parameters = ksJson_GetMemberByName( technique, "parameters" );
 
-			const char * containers[] = { "ktx", NULL };
-#if defined( OS_WINDOWS ) || defined( OS_LINUX ) || defined( OS_MACOS )
-			const int flags = GLTF_COMPRESSED_IMAGE_DXT | GLTF_COMPRESSED_IMAGE_DXT_SRGB;
+#if GRAPHICS_API_OPENGL == 1 || GRAPHICS_API_OPENGL_ES == 1
+		int conversion = KS_GLSL_CONVERSION_FLAG_JOINT_BUFFER | KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL |
+							( settings->useMultiView ? KS_GLSL_CONVERSION_FLAG_MULTI_VIEW : KS_GLSL_CONVERSION_FLAG_VIEW_PROJECTION_BUFFER );
+#elif GRAPHICS_API_VULKAN == 1
+		int conversion = KS_GLSL_CONVERSION_FLAG_JOINT_BUFFER | KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN |
+							( settings->useMultiView ? KS_GLSL_CONVERSION_FLAG_MULTI_VIEW : KS_GLSL_CONVERSION_FLAG_VIEW_PROJECTION_BUFFER );
 #else
-			const int flags = GLTF_COMPRESSED_IMAGE_ETC2 | GLTF_COMPRESSED_IMAGE_ETC2_SRGB |
-								GLTF_COMPRESSED_IMAGE_ASTC | GLTF_COMPRESSED_IMAGE_ASTC_SRGB;
+		int conversion = KS_GLSL_CONVERSION_NONE;
 #endif
-			const char * uri = ksGltf_FindImageUri( scene->textures[textureIndex].image, containers, flags );
-			assert( uri != NULL );
 
-			// The "format", "internalFormat", "target" and "type" are automatically derived from the KTX file.
-			size_t dataSizeInBytes = 0;
-			unsigned char * data = ksGltf_ReadUri( binaryBuffer, uri, &dataSizeInBytes );
-			ksGpuTexture_CreateFromKTX( context, &scene->textures[textureIndex].texture, scene->textures[textureIndex].name, data, dataSizeInBytes );
-			free( data );
-		}
-		ksGltf_CreateTextureNameHash( scene );
+		//
+		// Parse Vertex Attributes.
+		//
 
-		const ksNanoseconds endTime = GetTimeNanoseconds();
-		Print( "%1.3f seconds to load textures\n", ( endTime - startTime ) * 1e-9f );
-	}
+		scene->techniques[techniqueIndex].vertexAttributeLayout = (ksGpuVertexAttribute *) malloc( sizeof( DefaultVertexAttributeLayout ) );
+		memcpy( scene->techniques[techniqueIndex].vertexAttributeLayout, DefaultVertexAttributeLayout, sizeof( DefaultVertexAttributeLayout ) );
 
-	//
-	// glTF shaders
-	//
-	{
-		const ksNanoseconds startTime = GetTimeNanoseconds();
+		int vertexAttribsFlags = 0;
+		const ksJson * attributes = ksJson_GetMemberByName( technique, "attributes" );
+		const int attributeCount = ksJson_GetMemberCount( attributes );
+		scene->techniques[techniqueIndex].attributeCount = attributeCount;
+		scene->techniques[techniqueIndex].attributes = (ksGltfVertexAttribute *) calloc( attributeCount, sizeof( ksGltfVertexAttribute ) );
+		for ( int j = 0; j < attributeCount; j++ )
+		{
+			const ksJson * attrib = ksJson_GetMemberByIndex( attributes, j );
+			const char * attribName = ksJson_GetMemberName( attrib );
+			const char * parmName = ksJson_GetString( attrib, "" );
+			// Check for default shader.
+			if ( parmName[0] == '\0' )
+			{
+				assert( attributeCount == 1 );
+				vertexAttribsFlags |= VERTEX_ATTRIBUTE_FLAG_POSITION;
+				scene->techniques[techniqueIndex].attributes[j].name = ksGltf_strdup( attribName );
+				scene->techniques[techniqueIndex].attributes[j].format = KS_GPU_ATTRIBUTE_FORMAT_R32G32B32_SFLOAT;
+				scene->techniques[techniqueIndex].vertexAttributeLayout[0].name = scene->techniques[techniqueIndex].attributes[j].name;
+				break;
+			}
 
-		const int defaultGlslShaderCount = 3;
+			const ksJson * parameter = ksJson_GetMemberByName( parameters, parmName );
+			const char * semantic = ksJson_GetString( ksJson_GetMemberByName( parameter, "semantic" ), "" );
+			const int type = ksJson_GetUint16( ksJson_GetMemberByName( parameter, "type" ), 0 );
+
+			int attributeFlag = 0;
+			if ( strcmp( semantic, "POSITION" ) == 0 )			{ assert( type == GL_FLOAT_VEC3 ); attributeFlag |= VERTEX_ATTRIBUTE_FLAG_POSITION; }
+			else if ( strcmp( semantic, "NORMAL" ) == 0 )		{ assert( type == GL_FLOAT_VEC3 ); attributeFlag |= VERTEX_ATTRIBUTE_FLAG_NORMAL; }
+			else if ( strcmp( semantic, "TANGENT" ) == 0 )		{ assert( type == GL_FLOAT_VEC3 ); attributeFlag |= VERTEX_ATTRIBUTE_FLAG_TANGENT; }
+			else if ( strcmp( semantic, "BINORMAL" ) == 0 )		{ assert( type == GL_FLOAT_VEC3 ); attributeFlag |= VERTEX_ATTRIBUTE_FLAG_BINORMAL; }
+			else if ( strcmp( semantic, "COLOR" ) == 0 )		{ assert( type == GL_FLOAT_VEC4 ); attributeFlag |= VERTEX_ATTRIBUTE_FLAG_COLOR; }
+			else if ( strcmp( semantic, "TEXCOORD_0" ) == 0 )	{ assert( type == GL_FLOAT_VEC2 ); attributeFlag |= VERTEX_ATTRIBUTE_FLAG_UV0; }
+			else if ( strcmp( semantic, "TEXCOORD_1" ) == 0 )	{ assert( type == GL_FLOAT_VEC2 ); attributeFlag |= VERTEX_ATTRIBUTE_FLAG_UV1; }
+			else if ( strcmp( semantic, "TEXCOORD_2" ) == 0 )	{ assert( type == GL_FLOAT_VEC2 ); attributeFlag |= VERTEX_ATTRIBUTE_FLAG_UV2; }
+			else if ( strcmp( semantic, "JOINT" ) == 0 )		{ assert( type == GL_FLOAT_VEC4 ); attributeFlag |= VERTEX_ATTRIBUTE_FLAG_JOINT_INDICES; }
+			else if ( strcmp( semantic, "WEIGHT" ) == 0 )		{ assert( type == GL_FLOAT_VEC4 ); attributeFlag |= VERTEX_ATTRIBUTE_FLAG_JOINT_WEIGHTS; }
+
+			vertexAttribsFlags |= attributeFlag;
+
+			ksGpuAttributeFormat format = KS_GPU_ATTRIBUTE_FORMAT_R32G32B32_SFLOAT;
+			if ( type == GL_FLOAT )				{ format = KS_GPU_ATTRIBUTE_FORMAT_R32_SFLOAT; }
+			else if ( type == GL_FLOAT_VEC2 )	{ format = KS_GPU_ATTRIBUTE_FORMAT_R32G32_SFLOAT; }
+			else if ( type == GL_FLOAT_VEC3 )	{ format = KS_GPU_ATTRIBUTE_FORMAT_R32G32B32_SFLOAT; }
+			else if ( type == GL_FLOAT_VEC4 )	{ format = KS_GPU_ATTRIBUTE_FORMAT_R32G32B32A32_SFLOAT; }
+
+			scene->techniques[techniqueIndex].attributes[j].name = ksGltf_strdup( attribName );
+			scene->techniques[techniqueIndex].attributes[j].format = format;
+			scene->techniques[techniqueIndex].attributes[j].attributeFlag = attributeFlag;
+
+			// Change the layout attribute name.
+			for ( int attribIndex = 0; scene->techniques[techniqueIndex].vertexAttributeLayout[attribIndex].attributeFlag != 0; attribIndex++ )
+			{
+				ksGpuVertexAttribute * v = &scene->techniques[techniqueIndex].vertexAttributeLayout[attribIndex];
+				if ( ( v->attributeFlag & attributeFlag ) != 0 )
+				{
+					v->name = scene->techniques[techniqueIndex].attributes[j].name;
+					break;
+				}
+			}
+		}
 
-		const ksJson * shaders = ksJson_GetMemberByName( rootNode, "shaders" );
-		scene->shaderCount = ksJson_GetMemberCount( shaders );
-		scene->shaders = (ksGltfShader *) calloc( scene->shaderCount, sizeof( ksGltfShader ) );
-		for ( int shaderIndex = 0; shaderIndex < scene->shaderCount; shaderIndex++ )
+		// Get the attribute locations.
+		for ( int j = 0; j < attributeCount; j++ )
 		{
-			const ksJson * shader = ksJson_GetMemberByIndex( shaders, shaderIndex );
-			scene->shaders[shaderIndex].name = ksGltf_strdup( ksJson_GetMemberName( shader ) );
-			scene->shaders[shaderIndex].stage = ksJson_GetUint16( ksJson_GetMemberByName( shader, "type" ), 0 );
+			const int attributeFlag = scene->techniques[techniqueIndex].attributes[j].attributeFlag;
+			int location = 0;
+			for ( int bit = 1; bit < attributeFlag; bit <<= 1 )
+			{
+				if ( ( vertexAttribsFlags & bit ) != 0 )
+				{
+					location++;
+				}
+			}
+			scene->techniques[techniqueIndex].attributes[j].location = location;
+		}
 
-			assert( scene->shaders[shaderIndex].name[0] != '\0' );
-			assert( scene->shaders[shaderIndex].stage != 0 );
+		// Must have at least positions.
+		assert( ( vertexAttribsFlags & VERTEX_ATTRIBUTE_FLAG_POSITION ) != 0 );
+		scene->techniques[techniqueIndex].vertexAttribsFlags = vertexAttribsFlags;
 
-			const ksJson * extensions = ksJson_GetMemberByName( shader, "extensions" );
+		//
+		// Parse Uniforms.
+		//
+
+		const char * semanticUniforms[GLTF_UNIFORM_SEMANTIC_MAX] = { 0 };
+
+		const ksJson * uniforms = ksJson_GetMemberByName( technique, "uniforms" );
+		const int uniformCount = ksJson_GetMemberCount( uniforms );
+		scene->techniques[techniqueIndex].parms = (ksGpuProgramParm *) calloc( uniformCount, sizeof( ksGpuProgramParm ) );
+		scene->techniques[techniqueIndex].uniformCount = uniformCount;
+		scene->techniques[techniqueIndex].uniforms = (ksGltfUniform *) calloc( uniformCount, sizeof( ksGltfUniform ) );
+		memset( scene->techniques[techniqueIndex].uniforms, 0, uniformCount * sizeof( ksGltfUniform ) );
+		for ( int uniformIndex = 0; uniformIndex < uniformCount; uniformIndex++ )
+		{
+			const ksJson * uniform = ksJson_GetMemberByIndex( uniforms, uniformIndex );
+			const char * uniformName = ksJson_GetMemberName( uniform );
+			const char * parmName = ksJson_GetString( uniform, "" );
+
+			const ksJson * parameter = ksJson_GetMemberByName( parameters, parmName );
+			const char * semanticName = ksJson_GetString( ksJson_GetMemberByName( parameter, "semantic" ), "" );
+			const int type = ksJson_GetUint16( ksJson_GetMemberByName( parameter, "type" ), 0 );
+			const int count = ksJson_GetUint32( ksJson_GetMemberByName( parameter, "count" ), 0 );
+			const char * node = ksJson_GetString( ksJson_GetMemberByName( parameter, "node" ), "" );
+			int stageFlags = 0;
+			int binding = 0;
+
+			const ksJson * extensions = ksJson_GetMemberByName( parameter, "extensions" );
 			if ( extensions != NULL )
 			{
-				for ( int shaderType = 0; shaderType < GLTF_SHADER_TYPE_MAX; shaderType++ )
+				const ksJson * KHR_technique_uniform_stages = ksJson_GetMemberByName( extensions, "KHR_technique_uniform_stages" );
+				if ( KHR_technique_uniform_stages != NULL )
 				{
-					const ksJson * shader_versions = ksJson_GetMemberByName( extensions, shaderVersionExtensions[shaderType] );
-					if ( shader_versions != NULL )
+					const ksJson * stageArray = ksJson_GetMemberByName( KHR_technique_uniform_stages, "stages" );
+					const int stageCount = ksJson_GetMemberCount( stageArray );
+					for ( int stateIndex = 0; stateIndex < stageCount; stateIndex++ )
 					{
-						const int count = ksJson_GetMemberCount( shader_versions );
-						const int extra = ( shaderType == GLTF_SHADER_TYPE_GLSL ) * defaultGlslShaderCount;
-						scene->shaders[shaderIndex].shaders[shaderType] = (ksGltfShaderVersion *) calloc( count + extra, sizeof( ksGltfShaderVersion ) );
-						scene->shaders[shaderIndex].shaderCount[shaderType] = count + extra;
-						for ( int index = 0; index < count; index++ )
-						{
-							const ksJson * glslShader = ksJson_GetMemberByIndex( shader_versions, index );
-							scene->shaders[shaderIndex].shaders[shaderType][index].api = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( glslShader, "api" ), "" ) );
-							scene->shaders[shaderIndex].shaders[shaderType][index].version = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( glslShader, "version" ), "" ) );
-							scene->shaders[shaderIndex].shaders[shaderType][index].uri = ksGltf_ParseUri( scene, glslShader, "uri" );
-						}
+						stageFlags |= ksGltf_GetProgramStageFlag( ksJson_GetUint16( ksJson_GetMemberByIndex( stageArray, stateIndex ), 0 ) );
 					}
 				}
-			}
 
-			if ( scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL] == NULL )
-			{
-				scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL] = (ksGltfShaderVersion *) calloc( defaultGlslShaderCount, sizeof( ksGltfShaderVersion ) );
-				scene->shaders[shaderIndex].shaderCount[GLTF_SHADER_TYPE_GLSL] = defaultGlslShaderCount;
-			}
-			const int count = scene->shaders[shaderIndex].shaderCount[GLTF_SHADER_TYPE_GLSL];
-			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 3].api = ksGltf_strdup( "opengl" );
-			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 3].version = ksGltf_strdup( "100" );
-			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 3].uri = ksGltf_ParseUri( scene, shader, "uri" );
-			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 2].api = ksGltf_strdup( "opengles" );
-			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 2].version = ksGltf_strdup( "100 es" );
-			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 2].uri = ksGltf_ParseUri( scene, shader, "uri" );
-			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 1].api = ksGltf_strdup( "vulkan" );
-			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 1].version = ksGltf_strdup( "100 es" );
-			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 1].uri = ksGltf_ParseUri( scene, shader, "uri" );
-
-#if GRAPHICS_API_OPENGL == 1
-			assert( ksGltf_FindShaderUri( &scene->shaders[shaderIndex], GLTF_SHADER_TYPE_SPIRV, "opengl", SPIRV_VERSION ) != NULL ||
-					ksGltf_FindShaderUri( &scene->shaders[shaderIndex], GLTF_SHADER_TYPE_GLSL, "opengl", GLSL_VERSION ) != NULL );
-#elif GRAPHICS_API_OPENGL_ES == 1
-			assert( ksGltf_FindShaderUri( &scene->shaders[shaderIndex], GLTF_SHADER_TYPE_SPIRV, "opengles", SPIRV_VERSION ) != NULL ||
-					ksGltf_FindShaderUri( &scene->shaders[shaderIndex], GLTF_SHADER_TYPE_GLSL, "opengles", GLSL_VERSION ) != NULL );
+#if GRAPHICS_API_OPENGL == 1 || GRAPHICS_API_OPENGL_ES == 1
+				const ksJson * KHR_technique_uniform_binding_opengl = ksJson_GetMemberByName( extensions, "KHR_technique_uniform_binding_opengl" );
+				if ( KHR_technique_uniform_binding_opengl != NULL )
+				{
+					binding = ksJson_GetUint32( ksJson_GetMemberByName( parameter, "binding" ), 0 );
+				}
 #elif GRAPHICS_API_VULKAN == 1
-			assert( ksGltf_FindShaderUri( &scene->shaders[shaderIndex], GLTF_SHADER_TYPE_SPIRV, "vulkan", SPIRV_VERSION ) != NULL ||
-					ksGltf_FindShaderUri( &scene->shaders[shaderIndex], GLTF_SHADER_TYPE_GLSL, "vulkan", GLSL_VERSION ) != NULL );
+				const ksJson * KHR_technique_uniform_binding_vulkan = ksJson_GetMemberByName( extensions, "KHR_technique_uniform_binding_vulkan" );
+				if ( KHR_technique_uniform_binding_vulkan != NULL )
+				{
+					binding = ksJson_GetUint32( ksJson_GetMemberByName( parameter, "binding" ), 0 );
+				}
 #elif GRAPHICS_API_D3D == 1
-			assert( ksGltf_FindShaderUri( &scene->shaders[shaderIndex], GLTF_SHADER_TYPE_HLSL, "d3d", HLSL_VERSION ) != NULL );
+				const ksJson * KHR_technique_uniform_binding_d3d = ksJson_GetMemberByName( extensions, "KHR_technique_uniform_binding_d3d" );
+				if ( KHR_technique_uniform_binding_d3d != NULL )
+				{
+					binding = ksJson_GetUint32( ksJson_GetMemberByName( parameter, "binding" ), 0 );
+				}
 #elif GRAPHICS_API_METAL == 1
-			assert( ksGltf_FindShaderUri( &scene->shaders[shaderIndex], GLTF_SHADER_TYPE_METALSL, "metal", METALSL_VERSION ) != NULL );
+				const ksJson * KHR_technique_uniform_binding_metal = ksJson_GetMemberByName( extensions, "KHR_technique_uniform_binding_metal" );
+				if ( KHR_technique_uniform_binding_metal != NULL )
+				{
+					binding = ksJson_GetUint32( ksJson_GetMemberByName( parameter, "binding" ), 0 );
+				}
 #endif
-		}
-		ksGltf_CreateShaderNameHash( scene );
+			}
 
-		const ksNanoseconds endTime = GetTimeNanoseconds();
-		Print( "%1.3f seconds to load shaders\n", ( endTime - startTime ) * 1e-9f );
-	}
+			ksGpuProgramParmType parmType = KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED;
+			switch ( type )
+			{
+				case GL_SAMPLER_2D:				parmType = KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED; break;
+				case GL_SAMPLER_3D:				parmType = KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED; break;
+				case GL_SAMPLER_CUBE:			parmType = KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED; break;
+				case GL_INT:					parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT; break;
+				case GL_INT_VEC2:				parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT_VECTOR2; break;
+				case GL_INT_VEC3:				parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT_VECTOR3; break;
+				case GL_INT_VEC4:				parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT_VECTOR4; break;
+				case GL_FLOAT:					parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT; break;
+				case GL_FLOAT_VEC2:				parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_VECTOR2; break;
+				case GL_FLOAT_VEC3:				parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_VECTOR3; break;
+				case GL_FLOAT_VEC4:				parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_VECTOR4; break;
+				case GL_FLOAT_MAT2:				parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX2X2; break;
+				case GL_FLOAT_MAT2x3:			parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX2X3; break;
+				case GL_FLOAT_MAT2x4:			parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX2X4; break;
+				case GL_FLOAT_MAT3x2:			parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX3X2; break;
+				case GL_FLOAT_MAT3:				parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX3X3; break;
+				case GL_FLOAT_MAT3x4:			parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX3X4; break;
+				case GL_FLOAT_MAT4x2:			parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X2; break;
+				case GL_FLOAT_MAT4x3:			parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X3; break;
+				case GL_FLOAT_MAT4:				parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X4; break;
+				default:						assert( false ); break;
+			}
 
-	//
-	// glTF programs
-	//
-	{
-		const ksNanoseconds startTime = GetTimeNanoseconds();
+			if ( node[0] != '\0' )
+			{
+				assert( parmType == KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X4 );
+			}
 
-		const ksJson * programs = ksJson_GetMemberByName( rootNode, "programs" );
-		scene->programCount = ksJson_GetMemberCount( programs );
-		scene->programs = (ksGltfProgram *) calloc( scene->programCount, sizeof( ksGltfProgram ) );
-		for ( int programIndex = 0; programIndex < scene->programCount; programIndex++ )
-		{
-			const ksJson * program = ksJson_GetMemberByIndex( programs, programIndex );
-			const char * vertexShaderName = ksJson_GetString( ksJson_GetMemberByName( program, "vertexShader" ), "" );
-			const char * fragmentShaderName = ksJson_GetString( ksJson_GetMemberByName( program, "fragmentShader" ), "" );
-			const ksGltfShader * vertexShader = ksGltf_GetShaderByName( scene, vertexShaderName );
-			const ksGltfShader * fragmentShader = ksGltf_GetShaderByName( scene, fragmentShaderName );
+			ksGltfUniformSemantic semantic = GLTF_UNIFORM_SEMANTIC_NONE;	// default to the material setting the uniform
+			for ( int s = 0; s < sizeof( gltfUniformSemanticNames ) / sizeof( gltfUniformSemanticNames[0] ); s++ )
+			{
+				if ( strcmp( gltfUniformSemanticNames[s].name, semanticName ) == 0 )
+				{
+					semantic = gltfUniformSemanticNames[s].semantic;
+					semanticUniforms[semantic] = uniformName;
+					break;
+				}
+			}
 
-			assert( vertexShader != NULL );
-			assert( fragmentShader != NULL );
+			// General uniform arrays are not supported, should be using uniform buffers instead.
+			assert( semantic == GLTF_UNIFORM_SEMANTIC_JOINT_ARRAY || count == 0 );
+			UNUSED_PARM( count );
+
+			scene->techniques[techniqueIndex].parms[uniformIndex].stageFlags = ( stageFlags != 0 ) ? stageFlags : KS_GPU_PROGRAM_STAGE_FLAG_VERTEX;
+			scene->techniques[techniqueIndex].parms[uniformIndex].type = parmType;
+			scene->techniques[techniqueIndex].parms[uniformIndex].access = KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY;	// assume all parms are read-only
+			scene->techniques[techniqueIndex].parms[uniformIndex].index = uniformIndex;
+			scene->techniques[techniqueIndex].parms[uniformIndex].name = ksGltf_strdup( uniformName );
+			scene->techniques[techniqueIndex].parms[uniformIndex].binding = binding;
+
+			scene->techniques[techniqueIndex].uniforms[uniformIndex].name = ksGltf_strdup( parmName );
+			scene->techniques[techniqueIndex].uniforms[uniformIndex].semantic = semantic;
+			scene->techniques[techniqueIndex].uniforms[uniformIndex].nodeName = ( node[0] != '\0' ) ? ksGltf_strdup( node ) : NULL;
+			scene->techniques[techniqueIndex].uniforms[uniformIndex].node = NULL;	// linked up later
+			scene->techniques[techniqueIndex].uniforms[uniformIndex].type = parmType;
+			scene->techniques[techniqueIndex].uniforms[uniformIndex].index = uniformIndex;
+
+			const ksJson * value = ksJson_GetMemberByName( parameter, "value" );
+			if ( value != NULL )
+			{
+				ksGltfUniform * techniqueUniform = &scene->techniques[techniqueIndex].uniforms[uniformIndex];
+				techniqueUniform->semantic = GLTF_UNIFORM_SEMANTIC_DEFAULT_VALUE;
+				ksGltf_ParseUniformValue( &techniqueUniform->defaultValue, value, techniqueUniform->type, scene );
+			}
+		}
 
-			scene->programs[programIndex].name = ksGltf_strdup( ksJson_GetMemberName( program ) );
-			assert( scene->programs[programIndex].name[0] != '\0' );
+		scene->techniques[techniqueIndex].rop.blendEnable = false;
+		scene->techniques[techniqueIndex].rop.redWriteEnable = true;
+		scene->techniques[techniqueIndex].rop.blueWriteEnable = true;
+		scene->techniques[techniqueIndex].rop.greenWriteEnable = true;
+		scene->techniques[techniqueIndex].rop.alphaWriteEnable = true;
+		scene->techniques[techniqueIndex].rop.depthTestEnable = false;
+		scene->techniques[techniqueIndex].rop.depthWriteEnable = true;
+		scene->techniques[techniqueIndex].rop.frontFace = KS_GPU_FRONT_FACE_COUNTER_CLOCKWISE;
+		scene->techniques[techniqueIndex].rop.cullMode = KS_GPU_CULL_MODE_NONE;
+		scene->techniques[techniqueIndex].rop.depthCompare = KS_GPU_COMPARE_OP_LESS;
+		scene->techniques[techniqueIndex].rop.blendColor.x = 0.0f;
+		scene->techniques[techniqueIndex].rop.blendColor.y = 0.0f;
+		scene->techniques[techniqueIndex].rop.blendColor.z = 0.0f;
+		scene->techniques[techniqueIndex].rop.blendColor.w = 0.0f;
+		scene->techniques[techniqueIndex].rop.blendOpColor = KS_GPU_BLEND_OP_ADD;
+		scene->techniques[techniqueIndex].rop.blendSrcColor = KS_GPU_BLEND_FACTOR_ONE;
+		scene->techniques[techniqueIndex].rop.blendDstColor = KS_GPU_BLEND_FACTOR_ZERO;
+		scene->techniques[techniqueIndex].rop.blendOpAlpha = KS_GPU_BLEND_OP_ADD;
+		scene->techniques[techniqueIndex].rop.blendSrcAlpha = KS_GPU_BLEND_FACTOR_ONE;
+		scene->techniques[techniqueIndex].rop.blendDstAlpha = KS_GPU_BLEND_FACTOR_ZERO;
+
+		const ksJson * states = ksJson_GetMemberByName( technique, "states" );
+		const ksJson * enable = ksJson_GetMemberByName( states, "enable" );
+		const int enableCount = ksJson_GetMemberCount( enable );
+		for ( int enableIndex = 0; enableIndex < enableCount; enableIndex++ )
+		{
+			const int enableState = ksJson_GetUint16( ksJson_GetMemberByIndex( enable, enableIndex ), 0 );
+			switch ( enableState )
+			{
+				case GL_BLEND:
+					scene->techniques[techniqueIndex].rop.blendEnable = true;
+					scene->techniques[techniqueIndex].rop.blendOpColor = KS_GPU_BLEND_OP_ADD;
+					scene->techniques[techniqueIndex].rop.blendSrcColor = KS_GPU_BLEND_FACTOR_SRC_ALPHA;
+					scene->techniques[techniqueIndex].rop.blendDstColor = KS_GPU_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+					break;
+				case GL_DEPTH_TEST:
+					scene->techniques[techniqueIndex].rop.depthTestEnable = true;
+					break;
+				case GL_CULL_FACE:
+					scene->techniques[techniqueIndex].rop.cullMode = KS_GPU_CULL_MODE_BACK;
+					break;
+				case GL_POLYGON_OFFSET_FILL:
+					assert( false );
+					break;
+				case GL_SAMPLE_ALPHA_TO_COVERAGE:
+					assert( false );
+					break;
+				case GL_SCISSOR_TEST:
+					assert( false );
+					break;
+			}
+		}
 
-#if GRAPHICS_API_OPENGL == 1
-			const char * vertexShaderUri = ksGltf_FindShaderUri( vertexShader, GLTF_SHADER_TYPE_SPIRV, "opengl", SPIRV_VERSION );
-			const char * fragmentShaderUri = ksGltf_FindShaderUri( fragmentShader, GLTF_SHADER_TYPE_SPIRV, "opengl", SPIRV_VERSION );
-			if ( vertexShaderUri == NULL || fragmentShaderUri == NULL )
+		const ksJson * functions = ksJson_GetMemberByName( states, "functions" );
+		const int functionCount = ksJson_GetMemberCount( functions );
+		for ( int functionIndex = 0; functionIndex < functionCount; functionIndex++ )
+		{
+			const ksJson * func = ksJson_GetMemberByIndex( functions, functionIndex );
+			const char * funcName = ksJson_GetMemberName( func );
+			if ( strcmp( funcName, "blendColor" ) == 0 )
 			{
-				vertexShaderUri = ksGltf_FindShaderUri( vertexShader, GLTF_SHADER_TYPE_GLSL, "opengl", GLSL_VERSION );
-				fragmentShaderUri = ksGltf_FindShaderUri( fragmentShader, GLTF_SHADER_TYPE_GLSL, "opengl", GLSL_VERSION );
+				// [float:red, float:blue, float:green, float:alpha]
+				scene->techniques[techniqueIndex].rop.blendColor.x = ksJson_GetFloat( ksJson_GetMemberByIndex( func, 0 ), 0.0f );
+				scene->techniques[techniqueIndex].rop.blendColor.y = ksJson_GetFloat( ksJson_GetMemberByIndex( func, 1 ), 0.0f );
+				scene->techniques[techniqueIndex].rop.blendColor.z = ksJson_GetFloat( ksJson_GetMemberByIndex( func, 2 ), 0.0f );
+				scene->techniques[techniqueIndex].rop.blendColor.w = ksJson_GetFloat( ksJson_GetMemberByIndex( func, 3 ), 0.0f );
 			}
-#elif GRAPHICS_API_OPENGL_ES == 1
-			const char * vertexShaderUri = ksGltf_FindShaderUri( vertexShader, GLTF_SHADER_TYPE_SPIRV, "opengles", SPIRV_VERSION );
-			const char * fragmentShaderUri = ksGltf_FindShaderUri( fragmentShader, GLTF_SHADER_TYPE_SPIRV, "opengles", SPIRV_VERSION );
-			if ( vertexShaderUri == NULL || fragmentShaderUri == NULL )
+			else if ( strcmp( funcName, "blendEquationSeparate" ) == 0 )
 			{
-				vertexShaderUri = ksGltf_FindShaderUri( vertexShader, GLTF_SHADER_TYPE_GLSL, "opengles", GLSL_VERSION );
-				fragmentShaderUri = ksGltf_FindShaderUri( fragmentShader, GLTF_SHADER_TYPE_GLSL, "opengles", GLSL_VERSION );
+				// [GLenum:GL_FUNC_* (rgb), GLenum:GL_FUNC_* (alpha)]
+				scene->techniques[techniqueIndex].rop.blendOpColor = ksGltf_GetBlendOp( ksJson_GetUint16( ksJson_GetMemberByIndex( func, 0 ), 0 ) );
+				scene->techniques[techniqueIndex].rop.blendOpAlpha = ksGltf_GetBlendOp( ksJson_GetUint16( ksJson_GetMemberByIndex( func, 1 ), 0 ) );
 			}
-#elif GRAPHICS_API_VULKAN == 1
-			const char * vertexShaderUri = ksGltf_FindShaderUri( vertexShader, GLTF_SHADER_TYPE_SPIRV, "vulkan", SPIRV_VERSION );
-			const char * fragmentShaderUri = ksGltf_FindShaderUri( fragmentShader, GLTF_SHADER_TYPE_SPIRV, "vulkan", SPIRV_VERSION );
-			if ( vertexShaderUri == NULL || fragmentShaderUri == NULL )
+			else if ( strcmp( funcName, "blendFuncSeparate" ) == 0 )
 			{
-				vertexShaderUri = ksGltf_FindShaderUri( vertexShader, GLTF_SHADER_TYPE_GLSL, "vulkan", GLSL_VERSION );
-				fragmentShaderUri = ksGltf_FindShaderUri( fragmentShader, GLTF_SHADER_TYPE_GLSL, "vulkan", GLSL_VERSION );
+				// [GLenum:GL_ONE (srcRGB), GLenum:GL_ZERO (dstRGB), GLenum:GL_ONE (srcAlpha), GLenum:GL_ZERO (dstAlpha)]
+				scene->techniques[techniqueIndex].rop.blendSrcColor = ksGltf_GetBlendFactor( ksJson_GetUint16( ksJson_GetMemberByIndex( func, 0 ), 0 ) );
+				scene->techniques[techniqueIndex].rop.blendDstColor = ksGltf_GetBlendFactor( ksJson_GetUint16( ksJson_GetMemberByIndex( func, 1 ), 0 ) );
+				scene->techniques[techniqueIndex].rop.blendSrcAlpha = ksGltf_GetBlendFactor( ksJson_GetUint16( ksJson_GetMemberByIndex( func, 2 ), 0 ) );
+				scene->techniques[techniqueIndex].rop.blendDstAlpha = ksGltf_GetBlendFactor( ksJson_GetUint16( ksJson_GetMemberByIndex( func, 3 ), 0 ) );
 			}
-#elif GRAPHICS_API_D3D == 1
-			const char * vertexShaderUri = ksGltf_FindShaderUri( vertexShader, GLTF_SHADER_TYPE_HLSL, "d3d", HLSL_VERSION );
-			const char * fragmentShaderUri = ksGltf_FindShaderUri( fragmentShader, GLTF_SHADER_TYPE_HLSL, "d3d", HLSL_VERSION );
-#elif GRAPHICS_API_METAL == 1
-			const char * vertexShaderUri = ksGltf_FindShaderUri( vertexShader, GLTF_SHADER_TYPE_METALSL, "metal", METALSL_VERSION );
-			const char * fragmentShaderUri = ksGltf_FindShaderUri( fragmentShader, GLTF_SHADER_TYPE_METALSL, "metal", METALSL_VERSION );
-#endif
-			scene->programs[programIndex].vertexSource = ksGltf_ReadUri( binaryBuffer, vertexShaderUri, &scene->programs[programIndex].vertexSourceSize );
-			scene->programs[programIndex].fragmentSource = ksGltf_ReadUri( binaryBuffer, fragmentShaderUri, &scene->programs[programIndex].fragmentSourceSize );
+			else if ( strcmp( funcName, "colorMask" ) == 0 )
+			{
+				// [bool:red, bool:green, bool:blue, bool:alpha]
+				scene->techniques[techniqueIndex].rop.redWriteEnable = ksJson_GetBool( ksJson_GetMemberByIndex( func, 0 ), false );
+				scene->techniques[techniqueIndex].rop.blueWriteEnable = ksJson_GetBool( ksJson_GetMemberByIndex( func, 1 ), false );
+				scene->techniques[techniqueIndex].rop.greenWriteEnable = ksJson_GetBool( ksJson_GetMemberByIndex( func, 2 ), false );
+				scene->techniques[techniqueIndex].rop.alphaWriteEnable = ksJson_GetBool( ksJson_GetMemberByIndex( func, 3 ), false );
+			}
+			else if ( strcmp( funcName, "cullFace" ) == 0 )
+			{
+				// [GLenum:GL_BACK,GL_FRONT]
+				scene->techniques[techniqueIndex].rop.cullMode = ksGltf_GetCullMode( ksJson_GetUint16( ksJson_GetMemberByIndex( func, 0 ), 0 ) );
+			}
+			else if ( strcmp( funcName, "depthFunc" ) == 0 )
+			{
+				// [GLenum:GL_LESS,GL_LEQUAL,GL_GREATER]
+				scene->techniques[techniqueIndex].rop.depthCompare = ksGltf_GetCompareOp( ksJson_GetUint16( ksJson_GetMemberByIndex( func, 0 ), 0 ) );
+			}
+			else if ( strcmp( funcName, "depthMask" ) == 0 )
+			{
+				// [bool:mask]
+				scene->techniques[techniqueIndex].rop.depthWriteEnable = ksJson_GetBool( ksJson_GetMemberByIndex( func, 0 ), false );
+			}
+			else if ( strcmp( funcName, "frontFace" ) == 0 )
+			{
+				// [Glenum:GL_CCW,GL_CW]
+				scene->techniques[techniqueIndex].rop.frontFace = ksGltf_GetFrontFace( ksJson_GetUint16( ksJson_GetMemberByIndex( func, 0 ), 0 ) );
+			}
+			else if ( strcmp( funcName, "lineWidth" ) == 0 )
+			{
+				// [float:width]
+				assert( false );
+			}
+			else if ( strcmp( funcName, "polygonOffset" ) == 0 )
+			{
+				// [float:factor, float:units]
+				assert( false );
+			}
+			else if ( strcmp( funcName, "depthRange" ) == 0 )
+			{
+				// [float:znear, float:zfar]
+				assert( false );
+			}
+			else if ( strcmp( funcName, "scissor" ) == 0 )
+			{
+				// [int:x, int:y, int:width, int:height]
+				assert( false );
+			}
+		}
 
-			assert( scene->programs[programIndex].vertexSource[0] != '\0' );
-			assert( scene->programs[programIndex].fragmentSource[0] != '\0' );
+		ksGltfProgram * program = ksGltf_GetProgramByName( scene, ksJson_GetString( ksJson_GetMemberByName( technique, "program" ), "" ) );
+		assert( program != NULL );
+
+		techniqueSources[techniqueIndex].technique = &scene->techniques[techniqueIndex];
+		techniqueSources[techniqueIndex].program = program;
+		techniqueSources[techniqueIndex].conversion = conversion;
+		memcpy( techniqueSources[techniqueIndex].semanticUniforms, semanticUniforms, sizeof( semanticUniforms ) );
+
+		ksGltf_UpdateTechniqueUniforms( &techniqueSources[techniqueIndex] );
+		techniqueSources[techniqueIndex].hash = ksGltf_HashTechniqueSource( &techniqueSources[techniqueIndex] );
+
+		// Techniques with the same converted program and raster operations only differ in their uniforms.
+		scene->techniques[techniqueIndex].pipelineRank = pipelineRankCount;
+		for ( int otherIndex = 0; otherIndex < techniqueIndex; otherIndex++ )
+		{
+			if ( techniqueSources[otherIndex].hash == techniqueSources[techniqueIndex].hash &&
+					ksGltf_EqualRasterOperations( &scene->techniques[otherIndex].rop, &scene->techniques[techniqueIndex].rop ) )
+			{
+				scene->techniques[techniqueIndex].pipelineRank = scene->techniques[otherIndex].pipelineRank;
+				break;
+			}
+		}
+		if ( scene->techniques[techniqueIndex].pipelineRank == pipelineRankCount )
+		{
+			pipelineRankCount++;
 		}
-		ksGltf_CreateProgramNameHash( scene );
 
-		const ksNanoseconds endTime = GetTimeNanoseconds();
-		Print( "%1.3f seconds to load programs\n", ( endTime - startTime ) * 1e-9f );
+		// Only convert the shaders once for techniques that are identical as far as the conversion is concerned.
+		for ( int otherIndex = 0; otherIndex < techniqueIndex && conversion != KS_GLSL_CONVERSION_NONE; otherIndex++ )
+		{
+			if ( techniqueSources[otherIndex].original == NULL && techniqueSources[otherIndex].hash == techniqueSources[techniqueIndex].hash )
+			{
+				techniqueSources[techniqueIndex].original = &techniqueSources[otherIndex];
+				break;
+			}
+		}
+		if ( techniqueSources[techniqueIndex].original == NULL )
+		{
+			ksGltfLoadJob * job = ksGltf_AddLoadJob( loadJobs );
+			job->techniqueSource = &techniqueSources[techniqueIndex];
+		}
+	}
+	ksGltf_RunLoadJobs( loadJobs );
+
+	// The time saved by a cache hit is the time the original conversion took minus the time spent reading the cache.
+	int shaderCacheHits[GLTF_SHADER_CACHE_HIT_DISK + 1] = { 0 };
+	int shaderCacheFiles = 0;
+	ksNanoseconds shaderConversionTime = 0;
+	ksNanoseconds shaderCacheSavedTime = 0;
+	for ( int techniqueIndex = 0; techniqueIndex < scene->techniqueCount; techniqueIndex++ )
+	{
+		ksGltfTechniqueSource * source = &techniqueSources[techniqueIndex];
+		if ( source->original != NULL )
+		{
+			ksGltf_CopyTechniqueSource( source, source->original );
+			source->cacheResult = GLTF_SHADER_CACHE_HIT_MEMORY;
+			shaderCacheSavedTime += source->original->conversionTime;
+		}
+		else if ( source->cacheResult == GLTF_SHADER_CACHE_HIT_DISK )
+		{
+			shaderCacheSavedTime += source->conversionTime - source->cacheTime;
+		}
+		else
+		{
+			shaderConversionTime += source->conversionTime + source->cacheTime;
+		}
+		shaderCacheHits[source->cacheResult]++;
+		shaderCacheFiles += ( source->cacheFileSize != 0 );
+	}
+	Print( "%d of %d technique shaders from cache (%d memory, %d disk, %1.0f%% hit rate), %1.3f ms converting, %1.3f ms saved\n",
+			shaderCacheHits[GLTF_SHADER_CACHE_HIT_MEMORY] + shaderCacheHits[GLTF_SHADER_CACHE_HIT_DISK], scene->techniqueCount,
+			shaderCacheHits[GLTF_SHADER_CACHE_HIT_MEMORY], shaderCacheHits[GLTF_SHADER_CACHE_HIT_DISK],
+			( scene->techniqueCount > 0 ) ? 100.0f * ( scene->techniqueCount - shaderCacheHits[GLTF_SHADER_CACHE_MISS] ) / scene->techniqueCount : 0.0f,
+			shaderConversionTime * 1e-6f, shaderCacheSavedTime * 1e-6f );
+
+	scene->profile.shaderCacheMemoryHits = shaderCacheHits[GLTF_SHADER_CACHE_HIT_MEMORY];
+	scene->profile.shaderCacheDiskHits = shaderCacheHits[GLTF_SHADER_CACHE_HIT_DISK];
+	scene->profile.shaderConversionTime = shaderConversionTime;
+	scene->profile.shaderCacheSavedTime = shaderCacheSavedTime;
+
+	if ( shaderCacheFiles > 0 )
+	{
+		ksGltf_UpdateShaderCacheIndex( techniqueSources, scene->techniqueCount );
 	}
 
-	//
-	// glTF techniques
-	//
+	for ( int techniqueIndex = 0; techniqueIndex < scene->techniqueCount; techniqueIndex++ )
 	{
-		const ksNanoseconds startTime = GetTimeNanoseconds();
+		ksGltf_CreateTechniqueProgram( context, &techniqueSources[techniqueIndex] );
 
-		const ksJson * techniques = ksJson_GetMemberByName( rootNode, "techniques" );
-		scene->techniqueCount = ksJson_GetMemberCount( techniques );
-		scene->techniques = (ksGltfTechnique *) calloc( scene->techniqueCount, sizeof( ksGltfTechnique ) );
-		for ( int techniqueIndex = 0; techniqueIndex < scene->techniqueCount; techniqueIndex++ )
+		size_t totalPushConstantBytes = 0;
+		for ( int uniformIndex = 0; uniformIndex < scene->techniques[techniqueIndex].uniformCount; uniformIndex++ )
 		{
-			const ksJson * technique = ksJson_GetMemberByIndex( techniques, techniqueIndex );
-			scene->techniques[techniqueIndex].name = ksGltf_strdup( ksJson_GetMemberName( technique ) );
+			totalPushConstantBytes += ksGpuProgramParm_GetPushConstantSize( scene->techniques[techniqueIndex].parms[uniformIndex].type );
+		}
+		ksGpuLimits limits;
+		ksGpuContext_GetLimits( context, &limits );
+		assert( totalPushConstantBytes <= limits.maxPushConstantsSize );
+	}
+	free( techniqueSources );
+	ksGltf_CreateTechniqueNameHash( scene );
 
-			assert( scene->techniques[techniqueIndex].name[0] != '\0' );
+	const ksNanoseconds endTime = GetTimeNanoseconds();
+	Print( "%1.3f seconds to load techniques\n", ( endTime - startTime ) * 1e-9f );
+}
 
-			const ksJson * parameters = ksJson_GetMemberByName( technique, "parameters" );
+static int ksGltf_GetAccessorComponentCount( const char * type )
+{
+	if ( strcmp( type, "SCALAR" ) == 0 )	{ return 1; }
+	if ( strcmp( type, "VEC2" ) == 0 )		{ return 2; }
+	if ( strcmp( type, "VEC3" ) == 0 )		{ return 3; }
+	if ( strcmp( type, "VEC4" ) == 0 )		{ return 4; }
+	if ( strcmp( type, "MAT2" ) == 0 )		{ return 4; }
+	if ( strcmp( type, "MAT3" ) == 0 )		{ return 9; }
+	if ( strcmp( type, "MAT4" ) == 0 )		{ return 16; }
+	return 0;
+}
 
-#if GRAPHICS_API_OPENGL == 1 || GRAPHICS_API_OPENGL_ES == 1
-			int conversion = KS_GLSL_CONVERSION_FLAG_JOINT_BUFFER | KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL |
-								( settings->useMultiView ? KS_GLSL_CONVERSION_FLAG_MULTI_VIEW : KS_GLSL_CONVERSION_FLAG_VIEW_PROJECTION_BUFFER );
-#elif GRAPHICS_API_VULKAN == 1
-			int conversion = KS_GLSL_CONVERSION_FLAG_JOINT_BUFFER | KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN |
-								( settings->useMultiView ? KS_GLSL_CONVERSION_FLAG_MULTI_VIEW : KS_GLSL_CONVERSION_FLAG_VIEW_PROJECTION_BUFFER );
-#else
-			int conversion = KS_GLSL_CONVERSION_NONE;
-#endif
+static int ksGltf_GetComponentSize( const int componentType )
+{
+	switch ( componentType )
+	{
+		case GL_BYTE:			return 1;
+		case GL_UNSIGNED_BYTE:	return 1;
+		case GL_SHORT:			return 2;
+		case GL_UNSIGNED_SHORT:	return 2;
+		case GL_UNSIGNED_INT:	return 4;
+		case GL_FLOAT:			return 4;
+		default:				return 0;
+	}
+}
 
-			//
-			// Parse Vertex Attributes.
-			//
-
-			scene->techniques[techniqueIndex].vertexAttributeLayout = (ksGpuVertexAttribute *) malloc( sizeof( DefaultVertexAttributeLayout ) );
-			memcpy( scene->techniques[techniqueIndex].vertexAttributeLayout, DefaultVertexAttributeLayout, sizeof( DefaultVertexAttributeLayout ) );
-
-			int vertexAttribsFlags = 0;
-			const ksJson * attributes = ksJson_GetMemberByName( technique, "attributes" );
-			const int attributeCount = ksJson_GetMemberCount( attributes );
-			scene->techniques[techniqueIndex].attributeCount = attributeCount;
-			scene->techniques[techniqueIndex].attributes = (ksGltfVertexAttribute *) calloc( attributeCount, sizeof( ksGltfVertexAttribute ) );
-			for ( int j = 0; j < attributeCount; j++ )
-			{
-				const ksJson * attrib = ksJson_GetMemberByIndex( attributes, j );
-				const char * attribName = ksJson_GetMemberName( attrib );
-				const char * parmName = ksJson_GetString( attrib, "" );
-				// Check for default shader.
-				if ( parmName[0] == '\0' )
-				{
-					assert( attributeCount == 1 );
-					vertexAttribsFlags |= VERTEX_ATTRIBUTE_FLAG_POSITION;
-					scene->techniques[techniqueIndex].attributes[j].name = ksGltf_strdup( attribName );
-					scene->techniques[techniqueIndex].attributes[j].format = KS_GPU_ATTRIBUTE_FORMAT_R32G32B32_SFLOAT;
-					scene->techniques[techniqueIndex].vertexAttributeLayout[0].name = scene->techniques[techniqueIndex].attributes[j].name;
-					break;
-				}
+// Returns the number of bytes between consecutive elements of an accessor.
+static size_t ksGltf_GetAccessorStride( const ksGltfAccessor * accessor )
+{
+	if ( accessor->byteStride != 0 )
+	{
+		return accessor->byteStride;
+	}
+	return ksGltf_GetAccessorComponentCount( accessor->type ) * ksGltf_GetComponentSize( accessor->componentType );
+}
+
+// Reads a single component that may not be aligned. Normalized integers map to [0, 1] or [-1, 1].
+static float ksGltf_GetComponentFloat( const unsigned char * data, const int componentType, const bool normalized )
+{
+	switch ( componentType )
+	{
+		case GL_BYTE:
+		{
+			const float value = (float)*(const signed char *)data;
+			return normalized ? ( ( value > -127.0f ) ? value / 127.0f : -1.0f ) : value;
+		}
+		case GL_UNSIGNED_BYTE:
+		{
+			const float value = (float)data[0];
+			return normalized ? value / 255.0f : value;
+		}
+		case GL_SHORT:
+		{
+			short s;
+			memcpy( &s, data, sizeof( s ) );
+			const float value = (float)s;
+			return normalized ? ( ( value > -32767.0f ) ? value / 32767.0f : -1.0f ) : value;
+		}
+		case GL_UNSIGNED_SHORT:
+		{
+			unsigned short us;
+			memcpy( &us, data, sizeof( us ) );
+			const float value = (float)us;
+			return normalized ? value / 65535.0f : value;
+		}
+		case GL_UNSIGNED_INT:
+		{
+			uint32_t ui;
+			memcpy( &ui, data, sizeof( ui ) );
+			return (float)ui;
+		}
+		case GL_FLOAT:
+		{
+			float f;
+			memcpy( &f, data, sizeof( f ) );
+			return f;
+		}
+		default:
+		{
+			return 0.0f;
+		}
+	}
+}
 
-				const ksJson * parameter = ksJson_GetMemberByName( parameters, parmName );
-				const char * semantic = ksJson_GetString( ksJson_GetMemberByName( parameter, "semantic" ), "" );
-				const int type = ksJson_GetUint16( ksJson_GetMemberByName( parameter, "type" ), 0 );
-
-				int attributeFlag = 0;
-				if ( strcmp( semantic, "POSITION" ) == 0 )			{ assert( type == GL_FLOAT_VEC3 ); attributeFlag |= VERTEX_ATTRIBUTE_FLAG_POSITION; }
-				else if ( strcmp( semantic, "NORMAL" ) == 0 )		{ assert( type == GL_FLOAT_VEC3 ); attributeFlag |= VERTEX_ATTRIBUTE_FLAG_NORMAL; }
-				else if ( strcmp( semantic, "TANGENT" ) == 0 )		{ assert( type == GL_FLOAT_VEC3 ); attributeFlag |= VERTEX_ATTRIBUTE_FLAG_TANGENT; }
-				else if ( strcmp( semantic, "BINORMAL" ) == 0 )		{ assert( type == GL_FLOAT_VEC3 ); attributeFlag |= VERTEX_ATTRIBUTE_FLAG_BINORMAL; }
-				else if ( strcmp( semantic, "COLOR" ) == 0 )		{ assert( type == GL_FLOAT_VEC4 ); attributeFlag |= VERTEX_ATTRIBUTE_FLAG_COLOR; }
-				else if ( strcmp( semantic, "TEXCOORD_0" ) == 0 )	{ assert( type == GL_FLOAT_VEC2 ); attributeFlag |= VERTEX_ATTRIBUTE_FLAG_UV0; }
-				else if ( strcmp( semantic, "TEXCOORD_1" ) == 0 )	{ assert( type == GL_FLOAT_VEC2 ); attributeFlag |= VERTEX_ATTRIBUTE_FLAG_UV1; }
-				else if ( strcmp( semantic, "TEXCOORD_2" ) == 0 )	{ assert( type == GL_FLOAT_VEC2 ); attributeFlag |= VERTEX_ATTRIBUTE_FLAG_UV2; }
-				else if ( strcmp( semantic, "JOINT" ) == 0 )		{ assert( type == GL_FLOAT_VEC4 ); attributeFlag |= VERTEX_ATTRIBUTE_FLAG_JOINT_INDICES; }
-				else if ( strcmp( semantic, "WEIGHT" ) == 0 )		{ assert( type == GL_FLOAT_VEC4 ); attributeFlag |= VERTEX_ATTRIBUTE_FLAG_JOINT_WEIGHTS; }
-
-				vertexAttribsFlags |= attributeFlag;
-
-				ksGpuAttributeFormat format = KS_GPU_ATTRIBUTE_FORMAT_R32G32B32_SFLOAT;
-				if ( type == GL_FLOAT )				{ format = KS_GPU_ATTRIBUTE_FORMAT_R32_SFLOAT; }
-				else if ( type == GL_FLOAT_VEC2 )	{ format = KS_GPU_ATTRIBUTE_FORMAT_R32G32_SFLOAT; }
-				else if ( type == GL_FLOAT_VEC3 )	{ format = KS_GPU_ATTRIBUTE_FORMAT_R32G32B32_SFLOAT; }
-				else if ( type == GL_FLOAT_VEC4 )	{ format = KS_GPU_ATTRIBUTE_FORMAT_R32G32B32A32_SFLOAT; }
+// Copies the elements of an accessor to an array with 'destComponentCount' floats per element.
+// Tightly packed float data is copied straight from the buffer. Other data is converted per component,
+// where missing components are set to zero, except for the fourth component which is set to one.
+static void ksGltf_CopyAccessorFloats( float * dest, const int destComponentCount, const ksGltfAccessor * accessor )
+{
+	const unsigned char * data = (const unsigned char *)ksGltf_GetBufferData( accessor );
+	const int componentCount = ksGltf_GetAccessorComponentCount( accessor->type );
+	const int componentSize = ksGltf_GetComponentSize( accessor->componentType );
+	const size_t stride = ksGltf_GetAccessorStride( accessor );
 
-				scene->techniques[techniqueIndex].attributes[j].name = ksGltf_strdup( attribName );
-				scene->techniques[techniqueIndex].attributes[j].format = format;
-				scene->techniques[techniqueIndex].attributes[j].attributeFlag = attributeFlag;
+	if ( accessor->componentType == GL_FLOAT && componentCount == destComponentCount && stride == destComponentCount * sizeof( float ) )
+	{
+		memcpy( dest, data, accessor->count * stride );
+		return;
+	}
 
-				// Change the layout attribute name.
-				for ( int attribIndex = 0; scene->techniques[techniqueIndex].vertexAttributeLayout[attribIndex].attributeFlag != 0; attribIndex++ )
-				{
-					ksGpuVertexAttribute * v = &scene->techniques[techniqueIndex].vertexAttributeLayout[attribIndex];
-					if ( ( v->attributeFlag & attributeFlag ) != 0 )
-					{
-						v->name = scene->techniques[techniqueIndex].attributes[j].name;
-						break;
-					}
-				}
-			}
+	for ( int elementIndex = 0; elementIndex < accessor->count; elementIndex++ )
+	{
+		const unsigned char * element = data + elementIndex * stride;
+		for ( int component = 0; component < destComponentCount; component++ )
+		{
+			dest[elementIndex * destComponentCount + component] = ( component < componentCount ) ?
+				ksGltf_GetComponentFloat( element + component * componentSize, accessor->componentType, accessor->normalized ) :
+				( ( component == 3 ) ? 1.0f : 0.0f );
+		}
+	}
+}
 
-			// Get the attribute locations.
-			for ( int j = 0; j < attributeCount; j++ )
-			{
-				const int attributeFlag = scene->techniques[techniqueIndex].attributes[j].attributeFlag;
-				int location = 0;
-				for ( int bit = 1; bit < attributeFlag; bit <<= 1 )
-				{
-					if ( ( vertexAttribsFlags & bit ) != 0 )
-					{
-						location++;
-					}
-				}
-				scene->techniques[techniqueIndex].attributes[j].location = location;
-			}
+// Allocates the triangle indices of a surface. Tightly packed indices of the native index type are copied straight
+// from the buffer, other index types are converted, and sequential indices are used if there is no index accessor.
+// Returns false if the vertices cannot be addressed with the native index type.
+static bool ksGltf_AllocTriangleIndices( ksGpuTriangleIndexArray * indices, const ksGltfAccessor * accessor, const int vertexCount )
+{
+	const uint64_t maxVertexCount = (uint64_t)(ksGpuTriangleIndex)~0 + 1;
+	if ( (uint64_t)vertexCount > maxVertexCount )
+	{
+		Print( "Warning: %d vertices cannot be addressed with %d-bit indices\n", vertexCount, (int)( 8 * sizeof( ksGpuTriangleIndex ) ) );
+		return false;
+	}
+
+	if ( accessor == NULL )
+	{
+		ksGpuTriangleIndexArray_Alloc( indices, vertexCount, NULL );
+		for ( int i = 0; i < vertexCount; i++ )
+		{
+			indices->indexArray[i] = (ksGpuTriangleIndex)i;
+		}
+		return true;
+	}
 
-			// Must have at least positions.
-			assert( ( vertexAttribsFlags & VERTEX_ATTRIBUTE_FLAG_POSITION ) != 0 );
-			scene->techniques[techniqueIndex].vertexAttribsFlags = vertexAttribsFlags;
+	const unsigned char * data = (const unsigned char *)ksGltf_GetBufferData( accessor );
+	const size_t stride = ksGltf_GetAccessorStride( accessor );
+	const int nativeComponentType = ( sizeof( ksGpuTriangleIndex ) == sizeof( uint32_t ) ) ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
 
-			//
-			// Parse Uniforms.
-			//
+	if ( accessor->componentType == nativeComponentType && stride == sizeof( ksGpuTriangleIndex ) )
+	{
+		ksGpuTriangleIndexArray_Alloc( indices, accessor->count, (const ksGpuTriangleIndex *)data );
+		return true;
+	}
 
-			const char * semanticUniforms[GLTF_UNIFORM_SEMANTIC_MAX] = { 0 };
+	ksGpuTriangleIndexArray_Alloc( indices, accessor->count, NULL );
+	for ( int i = 0; i < accessor->count; i++ )
+	{
+		const unsigned char * element = data + i * stride;
+		uint32_t index = 0;
+		switch ( accessor->componentType )
+		{
+			case GL_UNSIGNED_BYTE:	index = element[0]; break;
+			case GL_UNSIGNED_SHORT:	{ unsigned short us; memcpy( &us, element, sizeof( us ) ); index = us; break; }
+			case GL_UNSIGNED_INT:	{ memcpy( &index, element, sizeof( index ) ); break; }
+			default:				assert( false ); break;
+		}
+		assert( index < (uint32_t)vertexCount );
+		indices->indexArray[i] = (ksGpuTriangleIndex)index;
+	}
+	return true;
+}
 
-			const ksJson * uniforms = ksJson_GetMemberByName( technique, "uniforms" );
-			const int uniformCount = ksJson_GetMemberCount( uniforms );
-			scene->techniques[techniqueIndex].parms = (ksGpuProgramParm *) calloc( uniformCount, sizeof( ksGpuProgramParm ) );
-			scene->techniques[techniqueIndex].uniformCount = uniformCount;
-			scene->techniques[techniqueIndex].uniforms = (ksGltfUniform *) calloc( uniformCount, sizeof( ksGltfUniform ) );
-			memset( scene->techniques[techniqueIndex].uniforms, 0, uniformCount * sizeof( ksGltfUniform ) );
-			for ( int uniformIndex = 0; uniformIndex < uniformCount; uniformIndex++ )
+// Creates the geometry and pipeline of a surface from the accessors of the surface. The vertex and index buffers
+// are shared with previously created surfaces that use the same accessors. Returns false if the surface cannot be created.
+static bool ksGltf_CreateSurface( ksGpuContext * context, ksGltfScene * scene, ksGpuRenderPass * renderPass,
+									ksGltfGeometryAccessors ** accessors, const int modelIndex, const int surfaceIndex )
+{
+	ksGltfSurface * surface = &scene->models[modelIndex].surfaces[surfaceIndex];
+	const ksGltfGeometryAccessors * surfaceAccessors = &accessors[modelIndex][surfaceIndex];
+
+	assert( surfaceAccessors->normal		== NULL || surfaceAccessors->normal->count			== surfaceAccessors->position->count );
+	assert( surfaceAccessors->tangent		== NULL || surfaceAccessors->tangent->count			== surfaceAccessors->position->count );
+	assert( surfaceAccessors->binormal		== NULL || surfaceAccessors->binormal->count		== surfaceAccessors->position->count );
+	assert( surfaceAccessors->color			== NULL || surfaceAccessors->color->count			== surfaceAccessors->position->count );
+	assert( surfaceAccessors->uv0			== NULL || surfaceAccessors->uv0->count				== surfaceAccessors->position->count );
+	assert( surfaceAccessors->uv1			== NULL || surfaceAccessors->uv1->count				== surfaceAccessors->position->count );
+	assert( surfaceAccessors->uv2			== NULL || surfaceAccessors->uv2->count				== surfaceAccessors->position->count );
+	assert( surfaceAccessors->jointIndices	== NULL || surfaceAccessors->jointIndices->count	== surfaceAccessors->position->count );
+	assert( surfaceAccessors->jointWeights	== NULL || surfaceAccessors->jointWeights->count	== surfaceAccessors->position->count );
+
+	ksGpuTriangleIndexArray indices;
+	memset( &indices, 0, sizeof( indices ) );
+
+	for ( int i = 0; i <= modelIndex && surfaceAccessors->indices != NULL; i++ )
+	{
+		const int surfaceCount = ( i == modelIndex ) ? surfaceIndex : scene->models[i].surfaceCount;
+		for ( int j = 0; j < surfaceCount; j++ )
+		{
+			const ksGltfGeometryAccessors * otherAccessors = &accessors[i][j];
+			if ( surfaceAccessors->indices == otherAccessors->indices )
 			{
-				const ksJson * uniform = ksJson_GetMemberByIndex( uniforms, uniformIndex );
-				const char * uniformName = ksJson_GetMemberName( uniform );
-				const char * parmName = ksJson_GetString( uniform, "" );
+				ksGpuTriangleIndexArray_CreateFromBuffer( &indices, surfaceAccessors->indices->count,
+														&scene->models[i].surfaces[j].geometry.indexBuffer );
+				i = modelIndex;
+				break;
+			}
+		}
+	}
 
-				const ksJson * parameter = ksJson_GetMemberByName( parameters, parmName );
-				const char * semanticName = ksJson_GetString( ksJson_GetMemberByName( parameter, "semantic" ), "" );
-				const int type = ksJson_GetUint16( ksJson_GetMemberByName( parameter, "type" ), 0 );
-				const int count = ksJson_GetUint32( ksJson_GetMemberByName( parameter, "count" ), 0 );
-				const char * node = ksJson_GetString( ksJson_GetMemberByName( parameter, "node" ), "" );
-				int stageFlags = 0;
-				int binding = 0;
+	if ( indices.buffer == NULL )
+	{
+		if ( !ksGltf_AllocTriangleIndices( &indices, surfaceAccessors->indices, surfaceAccessors->position->count ) )
+		{
+			return false;
+		}
+	}
 
-				const ksJson * extensions = ksJson_GetMemberByName( parameter, "extensions" );
-				if ( extensions != NULL )
-				{
-					const ksJson * KHR_technique_uniform_stages = ksJson_GetMemberByName( extensions, "KHR_technique_uniform_stages" );
-					if ( KHR_technique_uniform_stages != NULL )
-					{
-						const ksJson * stageArray = ksJson_GetMemberByName( KHR_technique_uniform_stages, "stages" );
-						const int stageCount = ksJson_GetMemberCount( stageArray );
-						for ( int stateIndex = 0; stateIndex < stageCount; stateIndex++ )
-						{
-							stageFlags |= ksGltf_GetProgramStageFlag( ksJson_GetUint16( ksJson_GetMemberByIndex( stageArray, stateIndex ), 0 ) );
-						}
-					}
+	ksDefaultVertexAttributeArrays attribs;
+	memset( &attribs, 0, sizeof( attribs ) );
 
-#if GRAPHICS_API_OPENGL == 1 || GRAPHICS_API_OPENGL_ES == 1
-					const ksJson * KHR_technique_uniform_binding_opengl = ksJson_GetMemberByName( extensions, "KHR_technique_uniform_binding_opengl" );
-					if ( KHR_technique_uniform_binding_opengl != NULL )
-					{
-						binding = ksJson_GetUint32( ksJson_GetMemberByName( parameter, "binding" ), 0 );
-					}
-#elif GRAPHICS_API_VULKAN == 1
-					const ksJson * KHR_technique_uniform_binding_vulkan = ksJson_GetMemberByName( extensions, "KHR_technique_uniform_binding_vulkan" );
-					if ( KHR_technique_uniform_binding_vulkan != NULL )
-					{
-						binding = ksJson_GetUint32( ksJson_GetMemberByName( parameter, "binding" ), 0 );
-					}
-#elif GRAPHICS_API_D3D == 1
-					const ksJson * KHR_technique_uniform_binding_d3d = ksJson_GetMemberByName( extensions, "KHR_technique_uniform_binding_d3d" );
-					if ( KHR_technique_uniform_binding_d3d != NULL )
-					{
-						binding = ksJson_GetUint32( ksJson_GetMemberByName( parameter, "binding" ), 0 );
-					}
-#elif GRAPHICS_API_METAL == 1
-					const ksJson * KHR_technique_uniform_binding_metal = ksJson_GetMemberByName( extensions, "KHR_technique_uniform_binding_metal" );
-					if ( KHR_technique_uniform_binding_metal != NULL )
-					{
-						binding = ksJson_GetUint32( ksJson_GetMemberByName( parameter, "binding" ), 0 );
-					}
-#endif
-				}
+	for ( int i = 0; i <= modelIndex; i++ )
+	{
+		const int surfaceCount = ( i == modelIndex ) ? surfaceIndex : scene->models[i].surfaceCount;
+		for ( int j = 0; j < surfaceCount; j++ )
+		{
+			const ksGltfGeometryAccessors * otherAccessors = &accessors[i][j];
+			if (	( surfaceAccessors->position		== NULL || surfaceAccessors->position		== otherAccessors->position		) &&
+					( surfaceAccessors->normal			== NULL || surfaceAccessors->normal			== otherAccessors->normal		) &&
+					( surfaceAccessors->tangent			== NULL || surfaceAccessors->tangent		== otherAccessors->tangent		) &&
+					( surfaceAccessors->binormal		== NULL || surfaceAccessors->binormal		== otherAccessors->binormal		) &&
+					( surfaceAccessors->color			== NULL || surfaceAccessors->color			== otherAccessors->color		) &&
+					( surfaceAccessors->uv0				== NULL || surfaceAccessors->uv0			== otherAccessors->uv0			) &&
+					( surfaceAccessors->uv1				== NULL || surfaceAccessors->uv1			== otherAccessors->uv1			) &&
+					( surfaceAccessors->uv2				== NULL || surfaceAccessors->uv2			== otherAccessors->uv2			) &&
+					( surfaceAccessors->jointIndices	== NULL || surfaceAccessors->jointIndices	== otherAccessors->jointIndices	) &&
+					( surfaceAccessors->jointWeights	== NULL || surfaceAccessors->jointWeights	== otherAccessors->jointWeights	)
+				)
+			{
+				ksGpuVertexAttributeArrays_CreateFromBuffer( &attribs.base,
+								scene->models[i].surfaces[j].geometry.layout,
+								scene->models[i].surfaces[j].geometry.vertexCount,
+								scene->models[i].surfaces[j].geometry.vertexAttribsFlags,
+								&scene->models[i].surfaces[j].geometry.vertexBuffer );
+				i = modelIndex;
+				break;
+			}
+		}
+	}
 
-				ksGpuProgramParmType parmType = KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED;
-				switch ( type )
-				{
-					case GL_SAMPLER_2D:				parmType = KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED; break;
-					case GL_SAMPLER_3D:				parmType = KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED; break;
-					case GL_SAMPLER_CUBE:			parmType = KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED; break;
-					case GL_INT:					parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT; break;
-					case GL_INT_VEC2:				parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT_VECTOR2; break;
-					case GL_INT_VEC3:				parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT_VECTOR3; break;
-					case GL_INT_VEC4:				parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT_VECTOR4; break;
-					case GL_FLOAT:					parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT; break;
-					case GL_FLOAT_VEC2:				parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_VECTOR2; break;
-					case GL_FLOAT_VEC3:				parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_VECTOR3; break;
-					case GL_FLOAT_VEC4:				parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_VECTOR4; break;
-					case GL_FLOAT_MAT2:				parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX2X2; break;
-					case GL_FLOAT_MAT2x3:			parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX2X3; break;
-					case GL_FLOAT_MAT2x4:			parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX2X4; break;
-					case GL_FLOAT_MAT3x2:			parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX3X2; break;
-					case GL_FLOAT_MAT3:				parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX3X3; break;
-					case GL_FLOAT_MAT3x4:			parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX3X4; break;
-					case GL_FLOAT_MAT4x2:			parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X2; break;
-					case GL_FLOAT_MAT4x3:			parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X3; break;
-					case GL_FLOAT_MAT4:				parmType = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X4; break;
-					default:						assert( false ); break;
-				}
+	if ( attribs.base.buffer == NULL )
+	{
+		const int attribsFlags = ( surfaceAccessors->position != NULL		? VERTEX_ATTRIBUTE_FLAG_POSITION : 0 ) |
+								( surfaceAccessors->normal != NULL			? VERTEX_ATTRIBUTE_FLAG_NORMAL : 0 ) |
+								( surfaceAccessors->tangent != NULL			? VERTEX_ATTRIBUTE_FLAG_TANGENT : 0 ) |
+								( surfaceAccessors->binormal != NULL		? VERTEX_ATTRIBUTE_FLAG_BINORMAL : 0 ) |
+								( surfaceAccessors->color != NULL			? VERTEX_ATTRIBUTE_FLAG_COLOR : 0 ) |
+								( surfaceAccessors->uv0 != NULL				? VERTEX_ATTRIBUTE_FLAG_UV0 : 0 ) |
+								( surfaceAccessors->uv1 != NULL				? VERTEX_ATTRIBUTE_FLAG_UV1 : 0 ) |
+								( surfaceAccessors->uv2 != NULL				? VERTEX_ATTRIBUTE_FLAG_UV2 : 0 ) |
+								( surfaceAccessors->jointIndices != NULL	? VERTEX_ATTRIBUTE_FLAG_JOINT_INDICES : 0 ) |
+								( surfaceAccessors->jointWeights != NULL	? VERTEX_ATTRIBUTE_FLAG_JOINT_WEIGHTS : 0 );
+
+		ksGpuVertexAttributeArrays_Alloc( &attribs.base, surface->material->technique->vertexAttributeLayout, surfaceAccessors->position->count, attribsFlags );
+
+		if ( surfaceAccessors->position != NULL )		ksGltf_CopyAccessorFloats( &attribs.position[0].x,		3, surfaceAccessors->position );
+		if ( surfaceAccessors->normal != NULL )			ksGltf_CopyAccessorFloats( &attribs.normal[0].x,		3, surfaceAccessors->normal );
+		if ( surfaceAccessors->tangent != NULL )		ksGltf_CopyAccessorFloats( &attribs.tangent[0].x,		3, surfaceAccessors->tangent );
+		if ( surfaceAccessors->binormal != NULL )		ksGltf_CopyAccessorFloats( &attribs.binormal[0].x,		3, surfaceAccessors->binormal );
+		if ( surfaceAccessors->color != NULL )			ksGltf_CopyAccessorFloats( &attribs.color[0].x,			4, surfaceAccessors->color );
+		if ( surfaceAccessors->uv0 != NULL )			ksGltf_CopyAccessorFloats( &attribs.uv0[0].x,			2, surfaceAccessors->uv0 );
+		if ( surfaceAccessors->uv1 != NULL )			ksGltf_CopyAccessorFloats( &attribs.uv1[0].x,			2, surfaceAccessors->uv1 );
+		if ( surfaceAccessors->uv2 != NULL )			ksGltf_CopyAccessorFloats( &attribs.uv2[0].x,			2, surfaceAccessors->uv2 );
+		if ( surfaceAccessors->jointIndices != NULL )	ksGltf_CopyAccessorFloats( &attribs.jointIndices[0].x,	4, surfaceAccessors->jointIndices );
+		if ( surfaceAccessors->jointWeights != NULL )	ksGltf_CopyAccessorFloats( &attribs.jointWeights[0].x,	4, surfaceAccessors->jointWeights );
+	}
 
-				if ( node[0] != '\0' )
-				{
-					assert( parmType == KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X4 );
-				}
+	ksGpuGeometry_Create( context, &surface->geometry, &attribs.base, &indices );
 
-				ksGltfUniformSemantic semantic = GLTF_UNIFORM_SEMANTIC_NONE;	// default to the material setting the uniform
-				for ( int s = 0; s < sizeof( gltfUniformSemanticNames ) / sizeof( gltfUniformSemanticNames[0] ); s++ )
-				{
-					if ( strcmp( gltfUniformSemanticNames[s].name, semanticName ) == 0 )
-					{
-						semantic = gltfUniformSemanticNames[s].semantic;
-						semanticUniforms[semantic] = uniformName;
-						break;
-					}
-				}
+	ksGpuVertexAttributeArrays_Free( &attribs.base );
+	ksGpuTriangleIndexArray_Free( &indices );
 
-				// General uniform arrays are not supported, should be using uniform buffers instead.
-				assert( semantic == GLTF_UNIFORM_SEMANTIC_JOINT_ARRAY || count == 0 );
-				UNUSED_PARM( count );
-
-				scene->techniques[techniqueIndex].parms[uniformIndex].stageFlags = ( stageFlags != 0 ) ? stageFlags : KS_GPU_PROGRAM_STAGE_FLAG_VERTEX;
-				scene->techniques[techniqueIndex].parms[uniformIndex].type = parmType;
-				scene->techniques[techniqueIndex].parms[uniformIndex].access = KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY;	// assume all parms are read-only
-				scene->techniques[techniqueIndex].parms[uniformIndex].index = uniformIndex;
-				scene->techniques[techniqueIndex].parms[uniformIndex].name = ksGltf_strdup( uniformName );
-				scene->techniques[techniqueIndex].parms[uniformIndex].binding = binding;
-
-				scene->techniques[techniqueIndex].uniforms[uniformIndex].name = ksGltf_strdup( parmName );
-				scene->techniques[techniqueIndex].uniforms[uniformIndex].semantic = semantic;
-				scene->techniques[techniqueIndex].uniforms[uniformIndex].nodeName = ( node[0] != '\0' ) ? ksGltf_strdup( node ) : NULL;
-				scene->techniques[techniqueIndex].uniforms[uniformIndex].node = NULL;	// linked up later
-				scene->techniques[techniqueIndex].uniforms[uniformIndex].type = parmType;
-				scene->techniques[techniqueIndex].uniforms[uniformIndex].index = uniformIndex;
-
-				const ksJson * value = ksJson_GetMemberByName( parameter, "value" );
-				if ( value != NULL )
-				{
-					ksGltfUniform * techniqueUniform = &scene->techniques[techniqueIndex].uniforms[uniformIndex];
-					techniqueUniform->semantic = GLTF_UNIFORM_SEMANTIC_DEFAULT_VALUE;
-					ksGltf_ParseUniformValue( &techniqueUniform->defaultValue, value, techniqueUniform->type, scene );
-				}
-			}
+	ksGpuGraphicsPipelineParms pipelineParms;
+	ksGpuGraphicsPipelineParms_Init( &pipelineParms );
+
+	pipelineParms.renderPass = renderPass;
+	pipelineParms.program = &surface->material->technique->program;
+	pipelineParms.geometry = &surface->geometry;
+	pipelineParms.rop = surface->material->technique->rop;
+
+	ksGpuGraphicsPipeline_Create( context, &surface->pipeline, &pipelineParms );
+
+	return true;
+}
+
+// Returns the time line with the given key frame times. Animation time lines are often shared so a new
+// time line is only added if there is no time line yet with the same key frame times.
+static ksGltfTimeLine * ksGltf_GetTimeLine( ksGltfScene * scene, float * sampleTimes, const int sampleCount )
+{
+	for ( int timeLineIndex = 0; timeLineIndex < scene->timeLineCount; timeLineIndex++ )
+	{
+		if ( sampleCount == scene->timeLines[timeLineIndex].sampleCount &&
+				sampleTimes == scene->timeLines[timeLineIndex].sampleTimes )
+		{
+			return &scene->timeLines[timeLineIndex];
+		}
+	}
+
+	ksGltfTimeLine * timeLine = &scene->timeLines[scene->timeLineCount++];
+	timeLine->sampleCount = sampleCount;
+	timeLine->sampleTimes = sampleTimes;
+
+	const float step = ( timeLine->sampleTimes[timeLine->sampleCount - 1] - timeLine->sampleTimes[0] ) / timeLine->sampleCount;
+	timeLine->duration = timeLine->sampleTimes[timeLine->sampleCount - 1] - timeLine->sampleTimes[0];
+	timeLine->rcpStep = 1.0f / step;
+	for ( int keyFrameIndex = 0; keyFrameIndex < timeLine->sampleCount; keyFrameIndex++ )
+	{
+		const float delta = timeLine->sampleTimes[keyFrameIndex] - keyFrameIndex * step;
+		// Check if the time is more than 0.1 milliseconds from a fixed-rate time-line.
+		if ( fabs( delta ) > 1e-4f )
+		{
+			timeLine->rcpStep = 0.0f;
+			break;
+		}
+	}
+	return timeLine;
+}
 
-			scene->techniques[techniqueIndex].rop.blendEnable = false;
-			scene->techniques[techniqueIndex].rop.redWriteEnable = true;
-			scene->techniques[techniqueIndex].rop.blueWriteEnable = true;
-			scene->techniques[techniqueIndex].rop.greenWriteEnable = true;
-			scene->techniques[techniqueIndex].rop.alphaWriteEnable = true;
-			scene->techniques[techniqueIndex].rop.depthTestEnable = false;
-			scene->techniques[techniqueIndex].rop.depthWriteEnable = true;
-			scene->techniques[techniqueIndex].rop.frontFace = KS_GPU_FRONT_FACE_COUNTER_CLOCKWISE;
-			scene->techniques[techniqueIndex].rop.cullMode = KS_GPU_CULL_MODE_NONE;
-			scene->techniques[techniqueIndex].rop.depthCompare = KS_GPU_COMPARE_OP_LESS;
-			scene->techniques[techniqueIndex].rop.blendColor.x = 0.0f;
-			scene->techniques[techniqueIndex].rop.blendColor.y = 0.0f;
-			scene->techniques[techniqueIndex].rop.blendColor.z = 0.0f;
-			scene->techniques[techniqueIndex].rop.blendColor.w = 0.0f;
-			scene->techniques[techniqueIndex].rop.blendOpColor = KS_GPU_BLEND_OP_ADD;
-			scene->techniques[techniqueIndex].rop.blendSrcColor = KS_GPU_BLEND_FACTOR_ONE;
-			scene->techniques[techniqueIndex].rop.blendDstColor = KS_GPU_BLEND_FACTOR_ZERO;
-			scene->techniques[techniqueIndex].rop.blendOpAlpha = KS_GPU_BLEND_OP_ADD;
-			scene->techniques[techniqueIndex].rop.blendSrcAlpha = KS_GPU_BLEND_FACTOR_ONE;
-			scene->techniques[techniqueIndex].rop.blendDstAlpha = KS_GPU_BLEND_FACTOR_ZERO;
-
-			const ksJson * states = ksJson_GetMemberByName( technique, "states" );
-			const ksJson * enable = ksJson_GetMemberByName( states, "enable" );
-			const int enableCount = ksJson_GetMemberCount( enable );
-			for ( int enableIndex = 0; enableIndex < enableCount; enableIndex++ )
-			{
-				const int enableState = ksJson_GetUint16( ksJson_GetMemberByIndex( enable, enableIndex ), 0 );
-				switch ( enableState )
+// Packs the animation channels per time line. The channel nodes must have been linked up.
+static void ksGltf_PackChannelBlocks( ksGltfScene * scene )
+{
+	for ( int timeLineIndex = 0; timeLineIndex < scene->timeLineCount; timeLineIndex++ )
+	{
+		ksGltfTimeLine * timeLine = &scene->timeLines[timeLineIndex];
+		for ( int type = 0; type < GLTF_CHANNEL_MAX; type++ )
+		{
+			ksGltfChannelBlock * block = &timeLine->channelBlocks[type];
+			block->type = (ksGltfChannelType)type;
+			block->componentCount = ( type == GLTF_CHANNEL_ROTATION ) ? 4 : 3;
+			block->channelCount = 0;
+			for ( int animationIndex = 0; animationIndex < scene->animationCount; animationIndex++ )
+			{
+				const ksGltfAnimation * animation = &scene->animations[animationIndex];
+				for ( int channelIndex = 0; channelIndex < animation->channelCount && animation->timeLine == timeLine; channelIndex++ )
 				{
-					case GL_BLEND:
-						scene->techniques[techniqueIndex].rop.blendEnable = true;
-						scene->techniques[techniqueIndex].rop.blendOpColor = KS_GPU_BLEND_OP_ADD;
-						scene->techniques[techniqueIndex].rop.blendSrcColor = KS_GPU_BLEND_FACTOR_SRC_ALPHA;
-						scene->techniques[techniqueIndex].rop.blendDstColor = KS_GPU_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-						break;
-					case GL_DEPTH_TEST:
-						scene->techniques[techniqueIndex].rop.depthTestEnable = true;
-						break;
-					case GL_CULL_FACE:
-						scene->techniques[techniqueIndex].rop.cullMode = KS_GPU_CULL_MODE_BACK;
-						break;
-					case GL_POLYGON_OFFSET_FILL:
-						assert( false );
-						break;
-					case GL_SAMPLE_ALPHA_TO_COVERAGE:
-						assert( false );
-						break;
-					case GL_SCISSOR_TEST:
-						assert( false );
-						break;
+					const float * values = ksGltf_GetChannelValues( &animation->channels[channelIndex], block->type );
+					block->channelCount += ( values != NULL );
 				}
 			}
+			block->stride = ( block->channelCount + 3 ) & ~3;
+			block->nodes = (ksGltfNode **) malloc( block->stride * sizeof( ksGltfNode * ) );
+			block->keys = (float *) AllocAlignedMemory( timeLine->sampleCount * block->componentCount * block->stride * sizeof( float ), 16 );
+			memset( block->keys, 0, timeLine->sampleCount * block->componentCount * block->stride * sizeof( float ) );
 
-			const ksJson * functions = ksJson_GetMemberByName( states, "functions" );
-			const int functionCount = ksJson_GetMemberCount( functions );
-			for ( int functionIndex = 0; functionIndex < functionCount; functionIndex++ )
+			int lane = 0;
+			for ( int animationIndex = 0; animationIndex < scene->animationCount; animationIndex++ )
 			{
-				const ksJson * func = ksJson_GetMemberByIndex( functions, functionIndex );
-				const char * funcName = ksJson_GetMemberName( func );
-				if ( strcmp( funcName, "blendColor" ) == 0 )
-				{
-					// [float:red, float:blue, float:green, float:alpha]
-					scene->techniques[techniqueIndex].rop.blendColor.x = ksJson_GetFloat( ksJson_GetMemberByIndex( func, 0 ), 0.0f );
-					scene->techniques[techniqueIndex].rop.blendColor.y = ksJson_GetFloat( ksJson_GetMemberByIndex( func, 1 ), 0.0f );
-					scene->techniques[techniqueIndex].rop.blendColor.z = ksJson_GetFloat( ksJson_GetMemberByIndex( func, 2 ), 0.0f );
-					scene->techniques[techniqueIndex].rop.blendColor.w = ksJson_GetFloat( ksJson_GetMemberByIndex( func, 3 ), 0.0f );
-				}
-				else if ( strcmp( funcName, "blendEquationSeparate" ) == 0 )
-				{
-					// [GLenum:GL_FUNC_* (rgb), GLenum:GL_FUNC_* (alpha)]
-					scene->techniques[techniqueIndex].rop.blendOpColor = ksGltf_GetBlendOp( ksJson_GetUint16( ksJson_GetMemberByIndex( func, 0 ), 0 ) );
-					scene->techniques[techniqueIndex].rop.blendOpAlpha = ksGltf_GetBlendOp( ksJson_GetUint16( ksJson_GetMemberByIndex( func, 1 ), 0 ) );
-				}
-				else if ( strcmp( funcName, "blendFuncSeparate" ) == 0 )
-				{
-					// [GLenum:GL_ONE (srcRGB), GLenum:GL_ZERO (dstRGB), GLenum:GL_ONE (srcAlpha), GLenum:GL_ZERO (dstAlpha)]
-					scene->techniques[techniqueIndex].rop.blendSrcColor = ksGltf_GetBlendFactor( ksJson_GetUint16( ksJson_GetMemberByIndex( func, 0 ), 0 ) );
-					scene->techniques[techniqueIndex].rop.blendDstColor = ksGltf_GetBlendFactor( ksJson_GetUint16( ksJson_GetMemberByIndex( func, 1 ), 0 ) );
-					scene->techniques[techniqueIndex].rop.blendSrcAlpha = ksGltf_GetBlendFactor( ksJson_GetUint16( ksJson_GetMemberByIndex( func, 2 ), 0 ) );
-					scene->techniques[techniqueIndex].rop.blendDstAlpha = ksGltf_GetBlendFactor( ksJson_GetUint16( ksJson_GetMemberByIndex( func, 3 ), 0 ) );
-				}
-				else if ( strcmp( funcName, "colorMask" ) == 0 )
-				{
-					// [bool:red, bool:green, bool:blue, bool:alpha]
-					scene->techniques[techniqueIndex].rop.redWriteEnable = ksJson_GetBool( ksJson_GetMemberByIndex( func, 0 ), false );
-					scene->techniques[techniqueIndex].rop.blueWriteEnable = ksJson_GetBool( ksJson_GetMemberByIndex( func, 1 ), false );
-					scene->techniques[techniqueIndex].rop.greenWriteEnable = ksJson_GetBool( ksJson_GetMemberByIndex( func, 2 ), false );
-					scene->techniques[techniqueIndex].rop.alphaWriteEnable = ksJson_GetBool( ksJson_GetMemberByIndex( func, 3 ), false );
-				}
-				else if ( strcmp( funcName, "cullFace" ) == 0 )
-				{
-					// [GLenum:GL_BACK,GL_FRONT]
-					scene->techniques[techniqueIndex].rop.cullMode = ksGltf_GetCullMode( ksJson_GetUint16( ksJson_GetMemberByIndex( func, 0 ), 0 ) );
-				}
-				else if ( strcmp( funcName, "depthFunc" ) == 0 )
-				{
-					// [GLenum:GL_LESS,GL_LEQUAL,GL_GREATER]
-					scene->techniques[techniqueIndex].rop.depthCompare = ksGltf_GetCompareOp( ksJson_GetUint16( ksJson_GetMemberByIndex( func, 0 ), 0 ) );
-				}
-				else if ( strcmp( funcName, "depthMask" ) == 0 )
-				{
-					// [bool:mask]
-					scene->techniques[techniqueIndex].rop.depthWriteEnable = ksJson_GetBool( ksJson_GetMemberByIndex( func, 0 ), false );
-				}
-				else if ( strcmp( funcName, "frontFace" ) == 0 )
-				{
-					// [Glenum:GL_CCW,GL_CW]
-					scene->techniques[techniqueIndex].rop.frontFace = ksGltf_GetFrontFace( ksJson_GetUint16( ksJson_GetMemberByIndex( func, 0 ), 0 ) );
-				}
-				else if ( strcmp( funcName, "lineWidth" ) == 0 )
-				{
-					// [float:width]
-					assert( false );
-				}
-				else if ( strcmp( funcName, "polygonOffset" ) == 0 )
-				{
-					// [float:factor, float:units]
-					assert( false );
-				}
-				else if ( strcmp( funcName, "depthRange" ) == 0 )
-				{
-					// [float:znear, float:zfar]
-					assert( false );
-				}
-				else if ( strcmp( funcName, "scissor" ) == 0 )
+				const ksGltfAnimation * animation = &scene->animations[animationIndex];
+				for ( int channelIndex = 0; channelIndex < animation->channelCount && animation->timeLine == timeLine; channelIndex++ )
 				{
-					// [int:x, int:y, int:width, int:height]
-					assert( false );
+					const float * values = ksGltf_GetChannelValues( &animation->channels[channelIndex], block->type );
+					if ( values == NULL )
+					{
+						continue;
+					}
+					block->nodes[lane] = animation->channels[channelIndex].node;
+					for ( int frame = 0; frame < timeLine->sampleCount; frame++ )
+					{
+						for ( int component = 0; component < block->componentCount; component++ )
+						{
+							block->keys[( frame * block->componentCount + component ) * block->stride + lane] = values[frame * block->componentCount + component];
+						}
+					}
+					lane++;
 				}
 			}
+		}
+	}
+}
 
-			ksGltfProgram * program = ksGltf_GetProgramByName( scene, ksJson_GetString( ksJson_GetMemberByName( technique, "program" ), "" ) );
-			assert( program != NULL );
-
-			ksGltf_CreateTechniqueProgram( context, &scene->techniques[techniqueIndex], program, conversion, semanticUniforms );
-
-			size_t totalPushConstantBytes = 0;
-			for ( int uniformIndex = 0; uniformIndex < scene->techniques[techniqueIndex].uniformCount; uniformIndex++ )
+// Returns the parent of the root joint of a skin. The joint nodes must have been linked up.
+// If the root joint has no parent then the root joint itself is used.
+static ksGltfNode * ksGltf_FindSkinParentNode( const ksGltfSkin * skin )
+{
+	ksGltfNode * root = NULL;
+	for ( int jointIndex = 0; jointIndex < skin->jointCount && root == NULL; jointIndex++ )
+	{
+		root = skin->joints[jointIndex].node;
+		for ( int k = 0; k < skin->jointCount; k++ )
+		{
+			if ( root->parent == skin->joints[k].node )
 			{
-				totalPushConstantBytes += ksGpuProgramParm_GetPushConstantSize( scene->techniques[techniqueIndex].parms[uniformIndex].type );
+				root = NULL;
+				break;
 			}
-			ksGpuLimits limits;
-			ksGpuContext_GetLimits( context, &limits );
-			assert( totalPushConstantBytes <= limits.maxPushConstantsSize );
-
 		}
-		ksGltf_CreateTechniqueNameHash( scene );
-
-		const ksNanoseconds endTime = GetTimeNanoseconds();
-		Print( "%1.3f seconds to load techniques\n", ( endTime - startTime ) * 1e-9f );
 	}
+	assert( root != NULL );
+	return ( root->parent != NULL ) ? root->parent : root;
+}
 
-	//
-	// glTF materials
-	//
+// Sets up a sub-tree with the nodes, animations and time lines below the given root node.
+// The nodes must be sorted and the depth of each node is passed in.
+static void ksGltf_CreateSubTree( ksGltfScene * scene, ksGltfSubTree * subTree, ksGltfNode * subTreeRootNode, const int * nodeDepth )
+{
+	subTree->nodes = (ksGltfNode **) calloc( subTreeRootNode->subTreeNodeCount, sizeof( ksGltfNode * ) );
+	subTree->nodeCount = subTreeRootNode->subTreeNodeCount;
+	for ( int nodeIndex = 0; nodeIndex < subTreeRootNode->subTreeNodeCount; nodeIndex++ )
 	{
-		const ksNanoseconds startTime = GetTimeNanoseconds();
+		// Note that the nodes of one subtree should be laid out consecutively in memory after sorting the nodes.
+		subTree->nodes[nodeIndex] = subTreeRootNode + nodeIndex;
+	}
 
-		const ksJson * materials = ksJson_GetMemberByName( rootNode, "materials" );
-		scene->materialCount = ksJson_GetMemberCount( materials );
-		scene->materials = (ksGltfMaterial *) calloc( scene->materialCount, sizeof( ksGltfMaterial ) );
-		for ( int materialIndex = 0; materialIndex < scene->materialCount; materialIndex++ )
+	// The sub-tree nodes are in breadth-first order so each depth level is a contiguous range of nodes.
+	const int rootNodeIndex = (int)( subTreeRootNode - scene->nodes );
+	const int rootDepth = nodeDepth[rootNodeIndex];
+	subTree->levelCount = nodeDepth[rootNodeIndex + subTree->nodeCount - 1] - rootDepth + 1;
+	subTree->levelOffsets = (int *) malloc( ( subTree->levelCount + 1 ) * sizeof( int ) );
+	subTree->levelOffsets[0] = 0;
+	for ( int nodeIndex = 1, level = 1; nodeIndex < subTree->nodeCount; nodeIndex++ )
+	{
+		const int depth = nodeDepth[rootNodeIndex + nodeIndex] - rootDepth;
+		assert( depth == level - 1 || depth == level );
+		if ( depth == level )
 		{
-			const ksJson * material = ksJson_GetMemberByIndex( materials, materialIndex );
-			scene->materials[materialIndex].name = ksGltf_strdup( ksJson_GetMemberName( material ) );
-			assert( scene->materials[materialIndex].name[0] != '\0' );
+			subTree->levelOffsets[level++] = nodeIndex;
+		}
+	}
+	subTree->levelOffsets[subTree->levelCount] = subTree->nodeCount;
 
-			const ksGltfTechnique * technique = ksGltf_GetTechniqueByName( scene, ksJson_GetString( ksJson_GetMemberByName( material, "technique" ), "" ) );
-			if ( settings->useMultiView )
+	subTree->timeLines = (ksGltfTimeLine **) calloc( scene->timeLineCount, sizeof( ksGltfTimeLine * ) );
+	subTree->timeLineCount = 0;
+	subTree->animations = (ksGltfAnimation **) calloc( scene->animationCount, sizeof( ksGltfAnimation * ) );
+	subTree->animationCount = 0;
+	for ( int animationIndex = 0; animationIndex < scene->animationCount; animationIndex++ )
+	{
+		bool include = false;
+		ksGltfAnimation * animation = &scene->animations[animationIndex];
+		for ( int channelIndex = 0; channelIndex < animation->channelCount; channelIndex++ )
+		{
+			if ( animation->channels[channelIndex].node >= subTreeRootNode &&
+					animation->channels[channelIndex].node < subTreeRootNode + subTreeRootNode->subTreeNodeCount )
 			{
-				const ksJson * extensions = ksJson_GetMemberByName( material, "extensions" );
-				if ( extensions != NULL )
+				include = true;
+				break;
+			}
+		}
+		if ( include )
+		{
+			for ( int i = 0; i < subTree->animationCount; i++ )
+			{
+				if ( subTree->animations[i] == animation )
 				{
-					const ksJson * KHR_glsl_multi_view = ksJson_GetMemberByName( extensions, "KHR_glsl_multi_view" );
-					if ( KHR_glsl_multi_view != NULL )
-					{
-						const ksGltfTechnique * multiViewTechnique = ksGltf_GetTechniqueByName( scene, ksJson_GetString( ksJson_GetMemberByName( KHR_glsl_multi_view, "technique" ), "" ) );
-						assert( multiViewTechnique != NULL );
-						technique = multiViewTechnique;
-					}
+					include = false;
+					break;
 				}
 			}
-			scene->materials[materialIndex].technique = technique;
-			assert( scene->materials[materialIndex].technique != NULL );
-
-			const ksJson * values = ksJson_GetMemberByName( material, "values" );
-			scene->materials[materialIndex].valueCount = ksJson_GetMemberCount( values );
-			scene->materials[materialIndex].values = (ksGltfMaterialValue *) calloc( scene->materials[materialIndex].valueCount, sizeof( ksGltfMaterialValue ) );
-			for ( int valueIndex = 0; valueIndex < scene->materials[materialIndex].valueCount; valueIndex++ )
+			if ( include )
 			{
-				const ksJson * value = ksJson_GetMemberByIndex( values, valueIndex );
-				const char * valueName = ksJson_GetMemberName( value );
-				ksGltfUniform * uniform = NULL;
-				for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
+				subTree->animations[subTree->animationCount++] = animation;
+				for ( int i = 0; i < subTree->timeLineCount; i++ )
 				{
-					if ( strcmp( technique->uniforms[uniformIndex].name, valueName ) == 0 )
+					if ( subTree->timeLines[i] == animation->timeLine )
 					{
-						uniform = &technique->uniforms[uniformIndex];
+						include = false;
 						break;
 					}
 				}
-				if ( uniform == NULL )
+				if ( include )
 				{
-					assert( false );
-					continue;
+					subTree->timeLines[subTree->timeLineCount++] = animation->timeLine;
 				}
-				assert( uniform->semantic == GLTF_UNIFORM_SEMANTIC_NONE || uniform->semantic == GLTF_UNIFORM_SEMANTIC_DEFAULT_VALUE );
-				scene->materials[materialIndex].values[valueIndex].uniform = uniform;
-				ksGltf_ParseUniformValue( &scene->materials[materialIndex].values[valueIndex].value, value, uniform->type, scene );
 			}
-			// Make sure that the material sets any uniforms that do not have a special semantic or a default value.
-			for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
+		}
+	}
+}
+
+// Parses a camera that is the same in glTF 1.0 and 2.0, except that the aspect ratio is optional in glTF 2.0.
+// Without an aspect ratio the horizontal field of view is set equal to the vertical field of view.
+static void ksGltf_ParseCamera( ksGltfCamera * camera, const ksJson * json )
+{
+	const char * type = ksJson_GetString( ksJson_GetMemberByName( json, "type" ), "" );
+	if ( strcmp( type, "perspective" ) == 0 )
+	{
+		const ksJson * perspective = ksJson_GetMemberByName( json, "perspective" );
+		const float aspectRatio = ksJson_GetFloat( ksJson_GetMemberByName( perspective, "aspectRatio" ), 0.0f );
+		const float yfov = ksJson_GetFloat( ksJson_GetMemberByName( perspective, "yfov" ), 0.0f );
+		camera->type = GLTF_CAMERA_TYPE_PERSPECTIVE;
+		camera->perspective.aspectRatio = aspectRatio;
+		camera->perspective.fovDegreesX = ( 180.0f / MATH_PI ) * 2.0f * atanf( tanf( yfov * 0.5f ) * ( ( aspectRatio > 0.0f ) ? aspectRatio : 1.0f ) );
+		camera->perspective.fovDegreesY = ( 180.0f / MATH_PI ) * yfov;
+		camera->perspective.nearZ = ksJson_GetFloat( ksJson_GetMemberByName( perspective, "znear" ), 0.0f );
+		camera->perspective.farZ = ksJson_GetFloat( ksJson_GetMemberByName( perspective, "zfar" ), 0.0f );
+		assert( camera->perspective.fovDegreesX > 0.0f );
+		assert( camera->perspective.fovDegreesY > 0.0f );
+		assert( camera->perspective.nearZ > 0.0f );
+	}
+	else
+	{
+		const ksJson * orthographic = ksJson_GetMemberByName( json, "orthographic" );
+		camera->type = GLTF_CAMERA_TYPE_ORTHOGRAPHIC;
+		camera->orthographic.magX = ksJson_GetFloat( ksJson_GetMemberByName( orthographic, "xmag" ), 0.0f );
+		camera->orthographic.magY = ksJson_GetFloat( ksJson_GetMemberByName( orthographic, "ymag" ), 0.0f );
+		camera->orthographic.nearZ = ksJson_GetFloat( ksJson_GetMemberByName( orthographic, "znear" ), 0.0f );
+		camera->orthographic.farZ = ksJson_GetFloat( ksJson_GetMemberByName( orthographic, "zfar" ), 0.0f );
+		assert( camera->orthographic.magX > 0.0f );
+		assert( camera->orthographic.magY > 0.0f );
+		assert( camera->orthographic.nearZ > 0.0f );
+	}
+}
+
+// Loads the glTF 1.0 objects, which reference each other by name.
+static void ksGltf_LoadVersion10( ksGpuContext * context, ksGltfScene * scene, ksSceneSettings * settings, ksGpuRenderPass * renderPass,
+									const ksJson * rootNode, unsigned char * binaryBuffer, const size_t binaryBufferLength, ksGltfLoadJobs * loadJobs )
+{
+	//
+	// glTF buffers
+	//
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+
+		const ksJson * buffers = ksJson_GetMemberByName( rootNode, "buffers" );
+		scene->bufferCount = ksJson_GetMemberCount( buffers );
+		scene->buffers = (ksGltfBuffer *) calloc( scene->bufferCount, sizeof( ksGltfBuffer ) );
+		for ( int bufferIndex = 0; bufferIndex < scene->bufferCount; bufferIndex++ )
+		{
+			const ksJson * buffer = ksJson_GetMemberByIndex( buffers, bufferIndex );
+			scene->buffers[bufferIndex].name = ksGltf_strdup( ksJson_GetMemberName( buffer ) );
+			scene->buffers[bufferIndex].byteLength = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( buffer, "byteLength" ), 0 );
+			scene->buffers[bufferIndex].type = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( buffer, "type" ), "" ) );
+			if ( strcmp( scene->buffers[bufferIndex].name, "binary_glTF" ) == 0 )
 			{
-				if ( technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_NONE )
-				{
-					bool found = false;
-					for ( int valueIndex = 0; valueIndex < scene->materials[materialIndex].valueCount; valueIndex++ )
-					{
-						if ( scene->materials[materialIndex].values[valueIndex].uniform == &technique->uniforms[uniformIndex] )
-						{
-							found = true;
-							break;
-						}
-					}
-					assert( found );
-					UNUSED_PARM( found );
-				}
+				assert( scene->buffers[bufferIndex].byteLength == binaryBufferLength );
+				scene->buffers[bufferIndex].bufferData = binaryBuffer;
+			}
+			else
+			{
+				ksGltfLoadJob * job = ksGltf_AddLoadJob( loadJobs );
+				job->uri = ksJson_GetString( ksJson_GetMemberByName( buffer, "uri" ), "" );
+				job->data = &scene->buffers[bufferIndex].bufferData;
 			}
 		}
-		ksGltf_CreateMaterialNameHash( scene );
+		ksGltf_RunLoadJobs( loadJobs );
+		for ( int bufferIndex = 0; bufferIndex < scene->bufferCount; bufferIndex++ )
+		{
+			assert( scene->buffers[bufferIndex].name[0] != '\0' );
+			assert( scene->buffers[bufferIndex].byteLength != 0 );
+			assert( scene->buffers[bufferIndex].bufferData != NULL );
+		}
+		ksGltf_CreateBufferNameHash( scene );
 
 		const ksNanoseconds endTime = GetTimeNanoseconds();
-		Print( "%1.3f seconds to load materials\n", ( endTime - startTime ) * 1e-9f );
+		Print( "%1.3f seconds to load buffers\n", ( endTime - startTime ) * 1e-9f );
 	}
 
 	//
-	// glTF meshes
+	// glTF bufferViews
 	//
 	{
 		const ksNanoseconds startTime = GetTimeNanoseconds();
 
-		const ksJson * models = ksJson_GetMemberByName( rootNode, "meshes" );
-		scene->modelCount = ksJson_GetMemberCount( models );
-		scene->models = (ksGltfModel *) calloc( scene->modelCount, sizeof( ksGltfModel ) );
-		ksGltfGeometryAccessors ** accessors = (ksGltfGeometryAccessors **) calloc( scene->modelCount, sizeof( ksGltfGeometryAccessors * ) );
-		for ( int modelIndex = 0; modelIndex < scene->modelCount; modelIndex++ )
+		const ksJson * bufferViews = ksJson_GetMemberByName( rootNode, "bufferViews" );
+		scene->bufferViewCount = ksJson_GetMemberCount( bufferViews );
+		scene->bufferViews = (ksGltfBufferView *) calloc( scene->bufferViewCount, sizeof( ksGltfBufferView ) );
+		for ( int bufferViewIndex = 0; bufferViewIndex < scene->bufferViewCount; bufferViewIndex++ )
 		{
-			const ksJson * model = ksJson_GetMemberByIndex( models, modelIndex );
-			scene->models[modelIndex].name = ksGltf_strdup( ksJson_GetMemberName( model ) );
+			const ksJson * view = ksJson_GetMemberByIndex( bufferViews, bufferViewIndex );
+			scene->bufferViews[bufferViewIndex].name = ksGltf_strdup( ksJson_GetMemberName( view ) );
+			scene->bufferViews[bufferViewIndex].buffer = ksGltf_GetBufferByName( scene, ksJson_GetString( ksJson_GetMemberByName( view, "buffer" ), "" ) );
+			scene->bufferViews[bufferViewIndex].byteOffset = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( view, "byteOffset" ), 0 );
+			scene->bufferViews[bufferViewIndex].byteLength = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( view, "byteLength" ), 0 );
+			scene->bufferViews[bufferViewIndex].target = ksJson_GetUint16( ksJson_GetMemberByName( view, "target" ), 0 );
+			assert( scene->bufferViews[bufferViewIndex].name[0] != '\0' );
+			assert( scene->bufferViews[bufferViewIndex].buffer != NULL );
+			assert( scene->bufferViews[bufferViewIndex].byteLength != 0 );
+			assert( scene->bufferViews[bufferViewIndex].byteOffset +
+					scene->bufferViews[bufferViewIndex].byteLength <=
+					scene->bufferViews[bufferViewIndex].buffer->byteLength );
+		}
+		ksGltf_CreateBufferViewNameHash( scene );
 
-			ksVector3f_Set( &scene->models[modelIndex].mins, FLT_MAX );
-			ksVector3f_Set( &scene->models[modelIndex].maxs, -FLT_MAX );
+		const ksNanoseconds endTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to load buffer views\n", ( endTime - startTime ) * 1e-9f );
+	}
 
-			assert( scene->models[modelIndex].name[0] != '\0' );
+	//
+	// glTF accessors
+	//
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
 
-			const ksJson * primitives = ksJson_GetMemberByName( model, "primitives" );
-			scene->models[modelIndex].surfaceCount = ksJson_GetMemberCount( primitives );
-			scene->models[modelIndex].surfaces = (ksGltfSurface *) calloc( scene->models[modelIndex].surfaceCount, sizeof( ksGltfSurface ) );
-			accessors[modelIndex] = (ksGltfGeometryAccessors *) calloc( scene->models[modelIndex].surfaceCount, sizeof( ksGltfGeometryAccessors ) );
-			for ( int surfaceIndex = 0; surfaceIndex < scene->models[modelIndex].surfaceCount; surfaceIndex++ )
+		const ksJson * accessors = ksJson_GetMemberByName( rootNode, "accessors" );
+		scene->accessorCount = ksJson_GetMemberCount( accessors );
+		scene->accessors = (ksGltfAccessor *) calloc( scene->accessorCount, sizeof( ksGltfAccessor ) );
+		for ( int accessorIndex = 0; accessorIndex < scene->accessorCount; accessorIndex++ )
+		{
+			const ksJson * access = ksJson_GetMemberByIndex( accessors, accessorIndex );
+			scene->accessors[accessorIndex].name = ksGltf_strdup( ksJson_GetMemberName( access ) );
+			scene->accessors[accessorIndex].bufferView = ksGltf_GetBufferViewByName( scene, ksJson_GetString( ksJson_GetMemberByName( access, "bufferView" ), "" ) );
+			scene->accessors[accessorIndex].byteOffset = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( access, "byteOffset" ), 0 );
+			scene->accessors[accessorIndex].byteStride = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( access, "byteStride" ), 0 );
+			scene->accessors[accessorIndex].componentType = ksJson_GetUint16( ksJson_GetMemberByName( access, "componentType" ), 0 );
+			scene->accessors[accessorIndex].count = ksJson_GetInt32( ksJson_GetMemberByName( access, "count" ), 0 );
+			scene->accessors[accessorIndex].type =  ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( access, "type" ), "" ) );
+			const ksJson * min = ksJson_GetMemberByName( access, "min" );
+			const ksJson * max = ksJson_GetMemberByName( access, "max" );
+			if ( min != NULL && max != NULL )
 			{
-				ksGltfSurface * surface = &scene->models[modelIndex].surfaces[surfaceIndex];
-				const ksJson * primitive = ksJson_GetMemberByIndex( primitives, surfaceIndex );
-				const ksJson * attributes = ksJson_GetMemberByName( primitive, "attributes" );
-
-				const char * positionAccessorName		= ksJson_GetString( ksJson_GetMemberByName( attributes, "POSITION" ), "" );
-				const char * normalAccessorName			= ksJson_GetString( ksJson_GetMemberByName( attributes, "NORMAL" ), "" );
-				const char * tangentAccessorName		= ksJson_GetString( ksJson_GetMemberByName( attributes, "TANGENT" ), "" );
-				const char * binormalAccessorName		= ksJson_GetString( ksJson_GetMemberByName( attributes, "BINORMAL" ), "" );
-				const char * colorAccessorName			= ksJson_GetString( ksJson_GetMemberByName( attributes, "COLOR" ), "" );
-				const char * uv0AccessorName			= ksJson_GetString( ksJson_GetMemberByName( attributes, "TEXCOORD_0" ), "" );
-				const char * uv1AccessorName			= ksJson_GetString( ksJson_GetMemberByName( attributes, "TEXCOORD_1" ), "" );
-				const char * uv2AccessorName			= ksJson_GetString( ksJson_GetMemberByName( attributes, "TEXCOORD_2" ), "" );
-				const char * jointIndicesAccessorName	= ksJson_GetString( ksJson_GetMemberByName( attributes, "JOINT" ), "" );
-				const char * jointWeightsAccessorName	= ksJson_GetString( ksJson_GetMemberByName( attributes, "WEIGHT" ), "" );
-				const char * indicesAccessorName		= ksJson_GetString( ksJson_GetMemberByName( primitive, "indices" ), "" );
-
-				surface->material = ksGltf_GetMaterialByName( scene, ksJson_GetString( ksJson_GetMemberByName( primitive, "material" ), "" ) );
-				assert( surface->material != NULL );
-
-				ksGltfGeometryAccessors * surfaceAccessors = &accessors[modelIndex][surfaceIndex];
-				surfaceAccessors->position		= ksGltf_GetAccessorByNameAndType( scene, positionAccessorName,		"VEC3",		GL_FLOAT );
-				surfaceAccessors->normal		= ksGltf_GetAccessorByNameAndType( scene, normalAccessorName,		"VEC3",		GL_FLOAT );
-				surfaceAccessors->tangent		= ksGltf_GetAccessorByNameAndType( scene, tangentAccessorName,		"VEC3",		GL_FLOAT );
-				surfaceAccessors->binormal		= ksGltf_GetAccessorByNameAndType( scene, binormalAccessorName,		"VEC3",		GL_FLOAT );
-				surfaceAccessors->color			= ksGltf_GetAccessorByNameAndType( scene, colorAccessorName,		"VEC4",		GL_FLOAT );
-				surfaceAccessors->uv0			= ksGltf_GetAccessorByNameAndType( scene, uv0AccessorName,			"VEC2",		GL_FLOAT );
-				surfaceAccessors->uv1			= ksGltf_GetAccessorByNameAndType( scene, uv1AccessorName,			"VEC2",		GL_FLOAT );
-				surfaceAccessors->uv2			= ksGltf_GetAccessorByNameAndType( scene, uv2AccessorName,			"VEC2",		GL_FLOAT );
-				surfaceAccessors->jointIndices	= ksGltf_GetAccessorByNameAndType( scene, jointIndicesAccessorName,	"VEC4",		GL_FLOAT );
-				surfaceAccessors->jointWeights	= ksGltf_GetAccessorByNameAndType( scene, jointWeightsAccessorName,	"VEC4",		GL_FLOAT );
-				surfaceAccessors->indices		= ksGltf_GetAccessorByNameAndType( scene, indicesAccessorName,		"SCALAR",	GL_UNSIGNED_SHORT );
+				const int componentCount = ksGltf_GetAccessorComponentCount( scene->accessors[accessorIndex].type );
 
-				if ( surfaceAccessors->position == NULL || surfaceAccessors->indices == NULL )
+				switch ( scene->accessors[accessorIndex].componentType )
 				{
-					assert( false );
-					continue;
+					case GL_BYTE:
+					case GL_UNSIGNED_BYTE:
+					case GL_SHORT:
+					case GL_UNSIGNED_SHORT:
+					case GL_UNSIGNED_INT:
+						ksGltf_ParseIntArray( scene->accessors[accessorIndex].intMin, componentCount, min );
+						ksGltf_ParseIntArray( scene->accessors[accessorIndex].intMax, componentCount, max );
+						break;
+					case GL_FLOAT:
+						ksGltf_ParseFloatArray( scene->accessors[accessorIndex].floatMin, componentCount, min );
+						ksGltf_ParseFloatArray( scene->accessors[accessorIndex].floatMax, componentCount, max );
+						break;
 				}
+			}
+			assert( scene->accessors[accessorIndex].name[0] != '\0' );
+			assert( scene->accessors[accessorIndex].bufferView != NULL );
+			assert( scene->accessors[accessorIndex].componentType != 0 );
+			assert( scene->accessors[accessorIndex].count != 0 );
+			assert( scene->accessors[accessorIndex].type[0] != '\0' );
+			assert( scene->accessors[accessorIndex].byteOffset +
+					scene->accessors[accessorIndex].count *
+					scene->accessors[accessorIndex].byteStride <=
+					scene->accessors[accessorIndex].bufferView->byteLength );
+		}
+		ksGltf_CreateAccessorNameHash( scene );
 
-				surface->mins.x = surfaceAccessors->position->floatMin[0];
-				surface->mins.y = surfaceAccessors->position->floatMin[1];
-				surface->mins.z = surfaceAccessors->position->floatMin[2];
-				surface->maxs.x = surfaceAccessors->position->floatMax[0];
-				surface->maxs.y = surfaceAccessors->position->floatMax[1];
-				surface->maxs.z = surfaceAccessors->position->floatMax[2];
+		const ksNanoseconds endTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to load accessors\n", ( endTime - startTime ) * 1e-9f );
+	}
+
+	//
+	// glTF images
+	//
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
 
-				assert( surfaceAccessors->normal		== NULL || surfaceAccessors->normal->count			== surfaceAccessors->position->count );
-				assert( surfaceAccessors->tangent		== NULL || surfaceAccessors->tangent->count			== surfaceAccessors->position->count );
-				assert( surfaceAccessors->binormal		== NULL || surfaceAccessors->binormal->count		== surfaceAccessors->position->count );
-				assert( surfaceAccessors->color			== NULL || surfaceAccessors->color->count			== surfaceAccessors->position->count );
-				assert( surfaceAccessors->uv0			== NULL || surfaceAccessors->uv0->count				== surfaceAccessors->position->count );
-				assert( surfaceAccessors->uv1			== NULL || surfaceAccessors->uv1->count				== surfaceAccessors->position->count );
-				assert( surfaceAccessors->uv2			== NULL || surfaceAccessors->uv2->count				== surfaceAccessors->position->count );
-				assert( surfaceAccessors->jointIndices	== NULL || surfaceAccessors->jointIndices->count	== surfaceAccessors->position->count );
-				assert( surfaceAccessors->jointWeights	== NULL || surfaceAccessors->jointWeights->count	== surfaceAccessors->position->count );
+		const ksJson * images = ksJson_GetMemberByName( rootNode, "images" );
+		scene->imageCount = ksJson_GetMemberCount( images );
+		scene->images = (ksGltfImage *) calloc( scene->imageCount, sizeof( ksGltfImage ) );
+		for ( int imageIndex = 0; imageIndex < scene->imageCount; imageIndex++ )
+		{
+			const ksJson * image = ksJson_GetMemberByIndex( images, imageIndex );
+			scene->images[imageIndex].name = ksGltf_strdup( ksJson_GetMemberName( image ) );
+			char * baseUri = ksGltf_ParseUri( scene, image, "uri" );
 
-				ksDefaultVertexAttributeArrays attribs;
-				memset( &attribs, 0, sizeof( attribs ) );
+			assert( scene->images[imageIndex].name[0] != '\0' );
+			assert( baseUri != NULL );
 
-				for ( int i = 0; i <= modelIndex; i++ )
+			const ksJson * extensions = ksJson_GetMemberByName( image, "extensions" );
+			if ( extensions != NULL )
+			{
+				const ksJson * KHR_image_versions = ksJson_GetMemberByName( extensions, "KHR_image_versions" );
+				if ( KHR_image_versions != NULL )
 				{
-					const int surfaceCount = ( i == modelIndex ) ? surfaceIndex : scene->models[i].surfaceCount;
-					for ( int j = 0; j < surfaceCount; j++ )
+					const ksJson * versions = ksJson_GetMemberByName( KHR_image_versions, "versions" );
+					const int versionCount = ksJson_GetMemberCount( versions );
+					scene->images[imageIndex].versions = (ksGltfImageVersion *) calloc( versionCount + 1, sizeof( ksGltfImageVersion ) );
+					scene->images[imageIndex].versionCount = versionCount + 1;
+					for ( int versionIndex = 0; versionIndex < versionCount; versionIndex++ )
 					{
-						const ksGltfGeometryAccessors * otherAccessors = &accessors[i][j];
-						if (	( surfaceAccessors->position		== NULL || surfaceAccessors->position		== otherAccessors->position		) &&
-								( surfaceAccessors->normal			== NULL || surfaceAccessors->normal			== otherAccessors->normal		) &&
-								( surfaceAccessors->tangent			== NULL || surfaceAccessors->tangent		== otherAccessors->tangent		) &&
-								( surfaceAccessors->binormal		== NULL || surfaceAccessors->binormal		== otherAccessors->binormal		) &&
-								( surfaceAccessors->color			== NULL || surfaceAccessors->color			== otherAccessors->color		) &&
-								( surfaceAccessors->uv0				== NULL || surfaceAccessors->uv0			== otherAccessors->uv0			) &&
-								( surfaceAccessors->uv1				== NULL || surfaceAccessors->uv1			== otherAccessors->uv1			) &&
-								( surfaceAccessors->uv2				== NULL || surfaceAccessors->uv2			== otherAccessors->uv2			) &&
-								( surfaceAccessors->jointIndices	== NULL || surfaceAccessors->jointIndices	== otherAccessors->jointIndices	) &&
-								( surfaceAccessors->jointWeights	== NULL || surfaceAccessors->jointWeights	== otherAccessors->jointWeights	)
-							)
-						{
-							ksGpuVertexAttributeArrays_CreateFromBuffer( &attribs.base,
-											scene->models[i].surfaces[j].geometry.layout,
-											scene->models[i].surfaces[j].geometry.vertexCount,
-											scene->models[i].surfaces[j].geometry.vertexAttribsFlags,
-											&scene->models[i].surfaces[j].geometry.vertexBuffer );
-							i = modelIndex;
-							break;
-						}
+						const ksJson * v = ksJson_GetMemberByIndex( versions, versionIndex );
+						scene->images[imageIndex].versions[versionIndex].container = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( v, "container" ), "" ) );
+						scene->images[imageIndex].versions[versionIndex].glInternalFormat = ksJson_GetUint32( ksJson_GetMemberByName( v, "glInternalFormat" ), 0 );
+						scene->images[imageIndex].versions[versionIndex].uri = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( v, "uri" ), "" ) );
 					}
 				}
+			}
+			if ( scene->images[imageIndex].versions == NULL )
+			{
+				scene->images[imageIndex].versions = (ksGltfImageVersion *) calloc( 1, sizeof( ksGltfImageVersion ) );
+				scene->images[imageIndex].versionCount = 1;
+			}
+			const int count = scene->images[imageIndex].versionCount;
+			scene->images[imageIndex].versions[count - 1].container = ksGltf_strdup( ksGltf_GetImageContainerFromUri( baseUri ) );
+			scene->images[imageIndex].versions[count - 1].glInternalFormat = ksGltf_GetImageInternalFormatFromUri( binaryBuffer, baseUri );
+			scene->images[imageIndex].versions[count - 1].uri = baseUri;
+		}
+		ksGltf_CreateImageNameHash( scene );
 
-				if ( attribs.base.buffer == NULL )
-				{
-					const int attribsFlags = ( surfaceAccessors->position != NULL		? VERTEX_ATTRIBUTE_FLAG_POSITION : 0 ) |
-											( surfaceAccessors->normal != NULL			? VERTEX_ATTRIBUTE_FLAG_NORMAL : 0 ) |
-											( surfaceAccessors->tangent != NULL			? VERTEX_ATTRIBUTE_FLAG_TANGENT : 0 ) |
-											( surfaceAccessors->binormal != NULL		? VERTEX_ATTRIBUTE_FLAG_BINORMAL : 0 ) |
-											( surfaceAccessors->color != NULL			? VERTEX_ATTRIBUTE_FLAG_COLOR : 0 ) |
-											( surfaceAccessors->uv0 != NULL				? VERTEX_ATTRIBUTE_FLAG_UV0 : 0 ) |
-											( surfaceAccessors->uv1 != NULL				? VERTEX_ATTRIBUTE_FLAG_UV1 : 0 ) |
-											( surfaceAccessors->uv2 != NULL				? VERTEX_ATTRIBUTE_FLAG_UV2 : 0 ) |
-											( surfaceAccessors->jointIndices != NULL	? VERTEX_ATTRIBUTE_FLAG_JOINT_INDICES : 0 ) |
-											( surfaceAccessors->jointWeights != NULL	? VERTEX_ATTRIBUTE_FLAG_JOINT_WEIGHTS : 0 );
-
-					ksGpuVertexAttributeArrays_Alloc( &attribs.base, surface->material->technique->vertexAttributeLayout, surfaceAccessors->position->count, attribsFlags );
-
-					if ( surfaceAccessors->position != NULL )		memcpy( attribs.position,		ksGltf_GetBufferData( surfaceAccessors->position ),		surfaceAccessors->position->count		* sizeof( attribs.position[0] ) );
-					if ( surfaceAccessors->normal != NULL )			memcpy( attribs.normal,			ksGltf_GetBufferData( surfaceAccessors->normal ),		surfaceAccessors->normal->count			* sizeof( attribs.normal[0] ) );
-					if ( surfaceAccessors->tangent != NULL )		memcpy( attribs.tangent,		ksGltf_GetBufferData( surfaceAccessors->tangent ),		surfaceAccessors->tangent->count		* sizeof( attribs.tangent[0] ) );
-					if ( surfaceAccessors->binormal != NULL )		memcpy( attribs.binormal,		ksGltf_GetBufferData( surfaceAccessors->binormal ),		surfaceAccessors->binormal->count		* sizeof( attribs.binormal[0] ) );
-					if ( surfaceAccessors->color != NULL )			memcpy( attribs.color,			ksGltf_GetBufferData( surfaceAccessors->color ),		surfaceAccessors->color->count			* sizeof( attribs.color[0] ) );
-					if ( surfaceAccessors->uv0 != NULL )			memcpy( attribs.uv0,			ksGltf_GetBufferData( surfaceAccessors->uv0 ),			surfaceAccessors->uv0->count			* sizeof( attribs.uv0[0] ) );
-					if ( surfaceAccessors->uv1 != NULL )			memcpy( attribs.uv1,			ksGltf_GetBufferData( surfaceAccessors->uv1 ),			surfaceAccessors->uv1->count			* sizeof( attribs.uv1[0] ) );
-					if ( surfaceAccessors->uv2 != NULL )			memcpy( attribs.uv2,			ksGltf_GetBufferData( surfaceAccessors->uv2 ),			surfaceAccessors->uv2->count			* sizeof( attribs.uv2[0] ) );
-					if ( surfaceAccessors->jointIndices != NULL )	memcpy( attribs.jointIndices,	ksGltf_GetBufferData( surfaceAccessors->jointIndices ),	surfaceAccessors->jointIndices->count	* sizeof( attribs.jointIndices[0] ) );
-					if ( surfaceAccessors->jointWeights != NULL )	memcpy( attribs.jointWeights,	ksGltf_GetBufferData( surfaceAccessors->jointWeights ),	surfaceAccessors->jointWeights->count	* sizeof( attribs.jointWeights[0] ) );
-				}
-
-				ksGpuTriangleIndexArray indices;
-				memset( &indices, 0, sizeof( indices ) );
+		const ksNanoseconds endTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to load images\n", ( endTime - startTime ) * 1e-9f );
+	}
 
-				for ( int i = 0; i <= modelIndex; i++ )
-				{
-					const int surfaceCount = ( i == modelIndex ) ? surfaceIndex : scene->models[i].surfaceCount;
-					for ( int j = 0; j < surfaceCount; j++ )
-					{
-						const ksGltfGeometryAccessors * otherAccessors = &accessors[i][j];
-						if ( surfaceAccessors->indices == otherAccessors->indices )
-						{
-							ksGpuTriangleIndexArray_CreateFromBuffer( &indices, surfaceAccessors->indices->count,
-																	&scene->models[i].surfaces[j].geometry.indexBuffer );
-							i = modelIndex;
-							break;
-						}
-					}
-				}
+	//
+	// glTF samplers
+	//
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
 
-				if ( indices.buffer == NULL )
-				{
-					ksGpuTriangleIndexArray_Alloc( &indices, surfaceAccessors->indices->count, (ksGpuTriangleIndex *)ksGltf_GetBufferData( surfaceAccessors->indices ) );
-				}
+		const ksJson * samplers = ksJson_GetMemberByName( rootNode, "samplers" );
+		scene->samplerCount = ksJson_GetMemberCount( samplers );
+		scene->samplers = (ksGltfSampler *) calloc( scene->samplerCount, sizeof( ksGltfSampler ) );
+		for ( int samplerIndex = 0; samplerIndex < scene->samplerCount; samplerIndex++ )
+		{
+			const ksJson * sampler = ksJson_GetMemberByIndex( samplers, samplerIndex );
+			scene->samplers[samplerIndex].name = ksGltf_strdup( ksJson_GetMemberName( sampler ) );
+			scene->samplers[samplerIndex].magFilter = ksJson_GetUint16( ksJson_GetMemberByName( sampler, "magFilter" ), GL_LINEAR );
+			scene->samplers[samplerIndex].minFilter = ksJson_GetUint16( ksJson_GetMemberByName( sampler, "minFilter" ), GL_NEAREST_MIPMAP_LINEAR );
+			scene->samplers[samplerIndex].wrapS = ksJson_GetUint16( ksJson_GetMemberByName( sampler, "wrapS" ), GL_REPEAT );
+			scene->samplers[samplerIndex].wrapT = ksJson_GetUint16( ksJson_GetMemberByName( sampler, "wrapT" ), GL_REPEAT );
+			assert( scene->samplers[samplerIndex].name[0] != '\0' );
+		}
+		ksGltf_CreateSamplerNameHash( scene );
 
-				ksGpuGeometry_Create( context, &surface->geometry, &attribs.base, &indices );
+		const ksNanoseconds endTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to load samplers\n", ( endTime - startTime ) * 1e-9f );
+	}
 
-				ksGpuVertexAttributeArrays_Free( &attribs.base );
-				ksGpuTriangleIndexArray_Free( &indices );
+	//
+	// glTF textures
+	//
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
 
-				ksGpuGraphicsPipelineParms pipelineParms;
-				ksGpuGraphicsPipelineParms_Init( &pipelineParms );
+		const ksJson * textures = ksJson_GetMemberByName( rootNode, "textures" );
+		scene->textureCount = ksJson_GetMemberCount( textures );
+		scene->textures = (ksGltfTexture *) calloc( scene->textureCount, sizeof( ksGltfTexture ) );
+		unsigned char ** textureData = (unsigned char **) calloc( scene->textureCount, sizeof( unsigned char * ) );
+		size_t * textureDataSize = (size_t *) calloc( scene->textureCount, sizeof( size_t ) );
+		for ( int textureIndex = 0; textureIndex < scene->textureCount; textureIndex++ )
+		{
+			const ksJson * texture = ksJson_GetMemberByIndex( textures, textureIndex );
+			scene->textures[textureIndex].name = ksGltf_strdup( ksJson_GetMemberName( texture ) );
+			scene->textures[textureIndex].image = ksGltf_GetImageByName( scene, ksJson_GetString( ksJson_GetMemberByName( texture, "source" ), "" ) );
+			scene->textures[textureIndex].sampler = ksGltf_GetSamplerByName( scene, ksJson_GetString( ksJson_GetMemberByName( texture, "sampler" ), "" ) );
 
-				pipelineParms.renderPass = renderPass;
-				pipelineParms.program = &surface->material->technique->program;
-				pipelineParms.geometry = &surface->geometry;
-				pipelineParms.rop = surface->material->technique->rop;
+			assert( scene->textures[textureIndex].name[0] != '\0' );
+			assert( scene->textures[textureIndex].image != NULL );
+			//assert( scene->textures[textureIndex].sampler != NULL );
 
-				ksGpuGraphicsPipeline_Create( context, &surface->pipeline, &pipelineParms );
+			const char * containers[] = { "ktx", NULL };
+#if defined( OS_WINDOWS ) || defined( OS_LINUX ) || defined( OS_MACOS )
+			const int flags = GLTF_COMPRESSED_IMAGE_DXT | GLTF_COMPRESSED_IMAGE_DXT_SRGB;
+#else
+			const int flags = GLTF_COMPRESSED_IMAGE_ETC2 | GLTF_COMPRESSED_IMAGE_ETC2_SRGB |
+								GLTF_COMPRESSED_IMAGE_ASTC | GLTF_COMPRESSED_IMAGE_ASTC_SRGB;
+#endif
+			const char * uri = ksGltf_FindImageUri( scene->textures[textureIndex].image, containers, flags );
+			assert( uri != NULL );
 
-				ksVector3f_Min( &scene->models[modelIndex].mins, &scene->models[modelIndex].mins, &surface->mins );
-				ksVector3f_Max( &scene->models[modelIndex].maxs, &scene->models[modelIndex].maxs, &surface->maxs );
-			}
+			ksGltfLoadJob * job = ksGltf_AddLoadJob( loadJobs );
+			job->uri = uri;
+			job->data = &textureData[textureIndex];
+			job->dataSize = &textureDataSize[textureIndex];
 		}
-
-		// Free the accessors.
-		for ( int modelIndex = 0; modelIndex < scene->modelCount; modelIndex++ )
+		ksGltf_RunLoadJobs( loadJobs );
+		for ( int textureIndex = 0; textureIndex < scene->textureCount; textureIndex++ )
 		{
-			free( accessors[modelIndex] );
+			// The "format", "internalFormat", "target" and "type" are automatically derived from the KTX file.
+			ksGpuTexture_CreateFromKTX( context, &scene->textures[textureIndex].texture, scene->textures[textureIndex].name,
+										textureData[textureIndex], textureDataSize[textureIndex] );
+			free( textureData[textureIndex] );
 		}
-		free( accessors );
-
-		ksGltf_CreateModelNameHash( scene );
+		free( textureData );
+		free( textureDataSize );
+		ksGltf_CreateTextureNameHash( scene );
 
 		const ksNanoseconds endTime = GetTimeNanoseconds();
-		Print( "%1.3f seconds to load models\n", ( endTime - startTime ) * 1e-9f );
+		Print( "%1.3f seconds to load textures\n", ( endTime - startTime ) * 1e-9f );
 	}
 
 	//
-	// glTF animations
+	// glTF shaders
 	//
 	{
 		const ksNanoseconds startTime = GetTimeNanoseconds();
 
-		const ksJson * animations = ksJson_GetMemberByName( rootNode, "animations" );
-		scene->animationCount = ksJson_GetMemberCount( animations );
-		scene->animations = (ksGltfAnimation *) calloc( scene->animationCount, sizeof( ksGltfAnimation ) );
-		scene->timeLineCount = 0;	// May not need all because they are often shared.
-		scene->timeLines = (ksGltfTimeLine *) calloc( scene->animationCount, sizeof( ksGltfTimeLine ) );
-		for ( int animationIndex = 0; animationIndex < scene->animationCount; animationIndex++ )
-		{
-			const ksJson * animation = ksJson_GetMemberByIndex( animations, animationIndex );
-			scene->animations[animationIndex].name = ksGltf_strdup( ksJson_GetMemberName( animation ) );
+		const int defaultGlslShaderCount = 3;
 
-			const ksJson * parameters = ksJson_GetMemberByName( animation, "parameters" );
-			const ksJson * samplers = ksJson_GetMemberByName( animation, "samplers" );
+		const ksJson * shaders = ksJson_GetMemberByName( rootNode, "shaders" );
+		scene->shaderCount = ksJson_GetMemberCount( shaders );
+		scene->shaders = (ksGltfShader *) calloc( scene->shaderCount, sizeof( ksGltfShader ) );
+		for ( int shaderIndex = 0; shaderIndex < scene->shaderCount; shaderIndex++ )
+		{
+			const ksJson * shader = ksJson_GetMemberByIndex( shaders, shaderIndex );
+			scene->shaders[shaderIndex].name = ksGltf_strdup( ksJson_GetMemberName( shader ) );
+			scene->shaders[shaderIndex].stage = ksJson_GetUint16( ksJson_GetMemberByName( shader, "type" ), 0 );
 
-			// This assumes there is only a single time-line per animation.
-			const char * timeAccessorName = ksJson_GetString( ksJson_GetMemberByName( parameters, "TIME" ), "" );
-			const ksGltfAccessor * timeAccessor = ksGltf_GetAccessorByNameAndType( scene, timeAccessorName, "SCALAR", GL_FLOAT );
+			assert( scene->shaders[shaderIndex].name[0] != '\0' );
+			assert( scene->shaders[shaderIndex].stage != 0 );
 
-			if ( timeAccessor == NULL || timeAccessor->count <= 0 )
+			const ksJson * extensions = ksJson_GetMemberByName( shader, "extensions" );
+			if ( extensions != NULL )
 			{
-				assert( false );
-				continue;
-			}
-
-			const int sampleCount = timeAccessor->count;
-			float * sampleTimes = (float *)ksGltf_GetBufferData( timeAccessor );
-
-			assert( sampleCount >= 2 );
-			assert( sampleTimes != NULL );
-
-			// Animation time lines are often shared so check if this one already exists.
-			for ( int timeLineIndex = 0; timeLineIndex < scene->timeLineCount; timeLineIndex++ )
-			{
-				if ( sampleCount == scene->timeLines[timeLineIndex].sampleCount &&
-						sampleTimes == scene->timeLines[timeLineIndex].sampleTimes )
-				{
-					scene->animations[animationIndex].timeLine = &scene->timeLines[timeLineIndex];
-					break;
-				}
-			}
-			if ( scene->animations[animationIndex].timeLine == NULL )
-			{
-				// Create a new time line.
-				ksGltfTimeLine * timeLine = &scene->timeLines[scene->timeLineCount++];
-				timeLine->sampleCount = sampleCount;
-				timeLine->sampleTimes = sampleTimes;
-
-				const float step = ( timeLine->sampleTimes[timeLine->sampleCount - 1] - timeLine->sampleTimes[0] ) / timeLine->sampleCount;
-				timeLine->duration = timeLine->sampleTimes[timeLine->sampleCount - 1] - timeLine->sampleTimes[0];
-				timeLine->rcpStep = 1.0f / step;
-				for ( int keyFrameIndex = 0; keyFrameIndex < timeLine->sampleCount; keyFrameIndex++ )
-				{
-					const float delta = timeLine->sampleTimes[keyFrameIndex] - keyFrameIndex * step;
-					// Check if the time is more than 0.1 milliseconds from a fixed-rate time-line.
-					if ( fabs( delta ) > 1e-4f )
-					{
-						timeLine->rcpStep = 0.0f;
-						break;
-					}
-				}
-
-				scene->animations[animationIndex].timeLine = timeLine;
-			}
-
-			const ksJson * channels = ksJson_GetMemberByName( animation, "channels" );
-			scene->animations[animationIndex].channelCount = ksJson_GetMemberCount( channels );
-			scene->animations[animationIndex].channels = (ksGltfAnimationChannel *) calloc( scene->animations[animationIndex].channelCount, sizeof( ksGltfAnimationChannel ) );
-			int newChannelCount = 0;
-			for ( int channelIndex = 0; channelIndex < scene->animations[animationIndex].channelCount; channelIndex++ )
-			{
-				const ksJson * channel = ksJson_GetMemberByIndex( channels, channelIndex );
-				const char * samplerName = ksJson_GetString( ksJson_GetMemberByName( channel, "sampler" ), "" );
-				const ksJson * sampler = ksJson_GetMemberByName( samplers, samplerName );
-				const char * inputName = ksJson_GetString( ksJson_GetMemberByName( sampler, "input" ), "" );
-				const char * interpolation = ksJson_GetString( ksJson_GetMemberByName( sampler, "interpolation" ), "" );
-				const char * outputName = ksJson_GetString( ksJson_GetMemberByName( sampler, "output" ), "" );
-				const char * accessorName = ksJson_GetString( ksJson_GetMemberByName( parameters, outputName ), "" );
-
-				assert( strcmp( inputName, "TIME" ) == 0 );
-				assert( strcmp( interpolation, "LINEAR" ) == 0 );
-				assert( outputName[0] != '\0' );
-				assert( accessorName[0] != '\0' );
-
-				UNUSED_PARM( inputName );
-				UNUSED_PARM( interpolation );
-
-				const ksJson * target = ksJson_GetMemberByName( channel, "target" );
-				const char * nodeName = ksJson_GetString( ksJson_GetMemberByName( target, "id" ), "" );
-				const char * pathName = ksJson_GetString( ksJson_GetMemberByName( target, "path" ), "" );
-
-				ksVector3f * translation = NULL;
-				ksQuatf * rotation = NULL;
-				ksVector3f * scale = NULL;
-
-				if ( strcmp( pathName, "translation" ) == 0 )
-				{
-					const ksGltfAccessor * accessor	= ksGltf_GetAccessorByNameAndType( scene, accessorName, "VEC3", GL_FLOAT );
-					assert( accessor != NULL );
-					translation = (ksVector3f *) ksGltf_GetBufferData( accessor );
-				}
-				else if ( strcmp( pathName, "rotation" ) == 0 )
-				{
-					const ksGltfAccessor * accessor	= ksGltf_GetAccessorByNameAndType( scene, accessorName, "VEC4", GL_FLOAT );
-					assert( accessor != NULL );
-					rotation = (ksQuatf *) ksGltf_GetBufferData( accessor );
-				}
-				else if ( strcmp( pathName, "scale" ) == 0 )
-				{
-					const ksGltfAccessor * accessor	= ksGltf_GetAccessorByNameAndType( scene, accessorName, "VEC3", GL_FLOAT );
-					assert( accessor != NULL );
-					scale = (ksVector3f *) ksGltf_GetBufferData( accessor );
-				}
-
-				// Try to merge this channel with a previous channel for the same node.
-				for ( int k = 0; k < newChannelCount; k++ )
+				for ( int shaderType = 0; shaderType < GLTF_SHADER_TYPE_MAX; shaderType++ )
 				{
-					if ( strcmp( nodeName, scene->animations[animationIndex].channels[k].nodeName ) == 0 )
+					const ksJson * shader_versions = ksJson_GetMemberByName( extensions, shaderVersionExtensions[shaderType] );
+					if ( shader_versions != NULL )
 					{
-						if ( translation != NULL )
-						{
-							scene->animations[animationIndex].channels[k].translation = translation;
-							translation = NULL;
-						}
-						if ( rotation != NULL )
-						{
-							scene->animations[animationIndex].channels[k].rotation = rotation;
-							rotation = NULL;
-						}
-						if ( scale != NULL )
+						const int count = ksJson_GetMemberCount( shader_versions );
+						const int extra = ( shaderType == GLTF_SHADER_TYPE_GLSL ) * defaultGlslShaderCount;
+						scene->shaders[shaderIndex].shaders[shaderType] = (ksGltfShaderVersion *) calloc( count + extra, sizeof( ksGltfShaderVersion ) );
+						scene->shaders[shaderIndex].shaderCount[shaderType] = count + extra;
+						for ( int index = 0; index < count; index++ )
 						{
-							scene->animations[animationIndex].channels[k].scale = scale;
-							scale = NULL;
+							const ksJson * glslShader = ksJson_GetMemberByIndex( shader_versions, index );
+							scene->shaders[shaderIndex].shaders[shaderType][index].api = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( glslShader, "api" ), "" ) );
+							scene->shaders[shaderIndex].shaders[shaderType][index].version = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( glslShader, "version" ), "" ) );
+							scene->shaders[shaderIndex].shaders[shaderType][index].uri = ksGltf_ParseUri( scene, glslShader, "uri" );
 						}
-						break;
 					}
 				}
+			}
 
-				// Only store the channel if it was not merged.
-				if ( translation != NULL || rotation != NULL || scale != NULL )
-				{
-					scene->animations[animationIndex].channels[newChannelCount].nodeName = ksGltf_strdup( nodeName );
-					scene->animations[animationIndex].channels[newChannelCount].node = NULL; // linked up once the nodes are loaded
-					scene->animations[animationIndex].channels[newChannelCount].translation = translation;
-					scene->animations[animationIndex].channels[newChannelCount].rotation = rotation;
-					scene->animations[animationIndex].channels[newChannelCount].scale = scale;
-					newChannelCount++;
-				}
+			if ( scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL] == NULL )
+			{
+				scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL] = (ksGltfShaderVersion *) calloc( defaultGlslShaderCount, sizeof( ksGltfShaderVersion ) );
+				scene->shaders[shaderIndex].shaderCount[GLTF_SHADER_TYPE_GLSL] = defaultGlslShaderCount;
 			}
-			scene->animations[animationIndex].channelCount = newChannelCount;
+			const int count = scene->shaders[shaderIndex].shaderCount[GLTF_SHADER_TYPE_GLSL];
+			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 3].api = ksGltf_strdup( "opengl" );
+			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 3].version = ksGltf_strdup( "100" );
+			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 3].uri = ksGltf_ParseUri( scene, shader, "uri" );
+			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 2].api = ksGltf_strdup( "opengles" );
+			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 2].version = ksGltf_strdup( "100 es" );
+			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 2].uri = ksGltf_ParseUri( scene, shader, "uri" );
+			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 1].api = ksGltf_strdup( "vulkan" );
+			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 1].version = ksGltf_strdup( "100 es" );
+			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 1].uri = ksGltf_ParseUri( scene, shader, "uri" );
+
+#if GRAPHICS_API_OPENGL == 1
+			assert( ksGltf_FindShaderUri( &scene->shaders[shaderIndex], GLTF_SHADER_TYPE_SPIRV, "opengl", SPIRV_VERSION ) != NULL ||
+					ksGltf_FindShaderUri( &scene->shaders[shaderIndex], GLTF_SHADER_TYPE_GLSL, "opengl", GLSL_VERSION ) != NULL );
+#elif GRAPHICS_API_OPENGL_ES == 1
+			assert( ksGltf_FindShaderUri( &scene->shaders[shaderIndex], GLTF_SHADER_TYPE_SPIRV, "opengles", SPIRV_VERSION ) != NULL ||
+					ksGltf_FindShaderUri( &scene->shaders[shaderIndex], GLTF_SHADER_TYPE_GLSL, "opengles", GLSL_VERSION ) != NULL );
+#elif GRAPHICS_API_VULKAN == 1
+			assert( ksGltf_FindShaderUri( &scene->shaders[shaderIndex], GLTF_SHADER_TYPE_SPIRV, "vulkan", SPIRV_VERSION ) != NULL ||
+					ksGltf_FindShaderUri( &scene->shaders[shaderIndex], GLTF_SHADER_TYPE_GLSL, "vulkan", GLSL_VERSION ) != NULL );
+#elif GRAPHICS_API_D3D == 1
+			assert( ksGltf_FindShaderUri( &scene->shaders[shaderIndex], GLTF_SHADER_TYPE_HLSL, "d3d", HLSL_VERSION ) != NULL );
+#elif GRAPHICS_API_METAL == 1
+			assert( ksGltf_FindShaderUri( &scene->shaders[shaderIndex], GLTF_SHADER_TYPE_METALSL, "metal", METALSL_VERSION ) != NULL );
+#endif
 		}
-		ksGltf_CreateAnimationNameHash( scene );
+		ksGltf_CreateShaderNameHash( scene );
 
 		const ksNanoseconds endTime = GetTimeNanoseconds();
-		Print( "%1.3f seconds to load animations\n", ( endTime - startTime ) * 1e-9f );
+		Print( "%1.3f seconds to load shaders\n", ( endTime - startTime ) * 1e-9f );
 	}
 
 	//
-	// glTF skins
+	// glTF programs
 	//
 	{
 		const ksNanoseconds startTime = GetTimeNanoseconds();
 
-		const ksJson * skins = ksJson_GetMemberByName( rootNode, "skins" );
-		scene->skinCount = ksJson_GetMemberCount( skins );
-		scene->skins = (ksGltfSkin *) calloc( scene->skinCount, sizeof( ksGltfSkin ) );
-		for ( int skinIndex = 0; skinIndex < scene->skinCount; skinIndex++ )
+		const ksJson * programs = ksJson_GetMemberByName( rootNode, "programs" );
+		scene->programCount = ksJson_GetMemberCount( programs );
+		scene->programs = (ksGltfProgram *) calloc( scene->programCount, sizeof( ksGltfProgram ) );
+		for ( int programIndex = 0; programIndex < scene->programCount; programIndex++ )
 		{
-			const ksJson * skin = ksJson_GetMemberByIndex( skins, skinIndex );
-			scene->skins[skinIndex].name = ksGltf_strdup( ksJson_GetMemberName( skin ) );
-			ksMatrix4x4f bindShapeMatrix;
-			ksGltf_ParseFloatArray( bindShapeMatrix.m[0], 16, ksJson_GetMemberByName( skin, "bindShapeMatrix" ) );
-
-			const char * bindAccessorName = ksJson_GetString( ksJson_GetMemberByName( skin, "inverseBindMatrices" ), "" );
-			const ksGltfAccessor * bindAccess = ksGltf_GetAccessorByNameAndType( scene, bindAccessorName, "MAT4", GL_FLOAT );
-			scene->skins[skinIndex].inverseBindMatrices = ksGltf_GetBufferData( bindAccess );
+			const ksJson * program = ksJson_GetMemberByIndex( programs, programIndex );
+			const char * vertexShaderName = ksJson_GetString( ksJson_GetMemberByName( program, "vertexShader" ), "" );
+			const char * fragmentShaderName = ksJson_GetString( ksJson_GetMemberByName( program, "fragmentShader" ), "" );
+			const ksGltfShader * vertexShader = ksGltf_GetShaderByName( scene, vertexShaderName );
+			const ksGltfShader * fragmentShader = ksGltf_GetShaderByName( scene, fragmentShaderName );
 
-			assert( scene->skins[skinIndex].name[0] != '\0' );
-			assert( scene->skins[skinIndex].inverseBindMatrices != NULL );
+			assert( vertexShader != NULL );
+			assert( fragmentShader != NULL );
 
-			scene->skins[skinIndex].parentNode = NULL;	// linked up once the nodes are loaded
+			scene->programs[programIndex].name = ksGltf_strdup( ksJson_GetMemberName( program ) );
+			assert( scene->programs[programIndex].name[0] != '\0' );
 
-			const ksJson * jointNames = ksJson_GetMemberByName( skin, "jointNames" );
-			scene->skins[skinIndex].jointCount = ksJson_GetMemberCount( jointNames );
-			scene->skins[skinIndex].joints = (ksGltfJoint *) calloc( scene->skins[skinIndex].jointCount, sizeof( ksGltfJoint ) );
-			assert( scene->skins[skinIndex].jointCount <= MAX_JOINTS );
-			for ( int jointIndex = 0; jointIndex < scene->skins[skinIndex].jointCount; jointIndex++ )
+#if GRAPHICS_API_OPENGL == 1
+			const char * vertexShaderUri = ksGltf_FindShaderUri( vertexShader, GLTF_SHADER_TYPE_SPIRV, "opengl", SPIRV_VERSION );
+			const char * fragmentShaderUri = ksGltf_FindShaderUri( fragmentShader, GLTF_SHADER_TYPE_SPIRV, "opengl", SPIRV_VERSION );
+			if ( vertexShaderUri == NULL || fragmentShaderUri == NULL )
 			{
-				ksMatrix4x4f inverseBindMatrix;
-				ksMatrix4x4f_Multiply( &inverseBindMatrix, &scene->skins[skinIndex].inverseBindMatrices[jointIndex], &bindShapeMatrix );
-				scene->skins[skinIndex].inverseBindMatrices[jointIndex] = inverseBindMatrix;
-
-				scene->skins[skinIndex].joints[jointIndex].name = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByIndex( jointNames, jointIndex ), "" ) );
-				scene->skins[skinIndex].joints[jointIndex].node = NULL; // linked up once the nodes are loaded
+				vertexShaderUri = ksGltf_FindShaderUri( vertexShader, GLTF_SHADER_TYPE_GLSL, "opengl", GLSL_VERSION );
+				fragmentShaderUri = ksGltf_FindShaderUri( fragmentShader, GLTF_SHADER_TYPE_GLSL, "opengl", GLSL_VERSION );
 			}
-			assert( bindAccess->count == scene->skins[skinIndex].jointCount );
-
-			ksGpuBuffer_Create( context, &scene->skins[skinIndex].jointBuffer, KS_GPU_BUFFER_TYPE_UNIFORM, scene->skins[skinIndex].jointCount * sizeof( ksMatrix4x4f ), NULL, false );
-
-			const ksJson * extensions = ksJson_GetMemberByName( skin, "extensions" );
-			if ( extensions != NULL )
+#elif GRAPHICS_API_OPENGL_ES == 1
+			const char * vertexShaderUri = ksGltf_FindShaderUri( vertexShader, GLTF_SHADER_TYPE_SPIRV, "opengles", SPIRV_VERSION );
+			const char * fragmentShaderUri = ksGltf_FindShaderUri( fragmentShader, GLTF_SHADER_TYPE_SPIRV, "opengles", SPIRV_VERSION );
+			if ( vertexShaderUri == NULL || fragmentShaderUri == NULL )
 			{
-				const ksJson * KHR_skin_culling = ksJson_GetMemberByName( extensions, "KHR_skin_culling" );
-				if ( KHR_skin_culling != NULL )
-				{
-					const char * minsAccessorName = ksJson_GetString( ksJson_GetMemberByName( KHR_skin_culling, "jointGeometryMins" ), "" );
-					const ksGltfAccessor * minsAccessor = ksGltf_GetAccessorByNameAndType( scene, minsAccessorName, "VEC3", GL_FLOAT );
-					scene->skins[skinIndex].jointGeometryMins = ksGltf_GetBufferData( minsAccessor );
-
-					const char * maxsAccessorName = ksJson_GetString( ksJson_GetMemberByName( KHR_skin_culling, "jointGeometryMaxs" ), "" );
-					const ksGltfAccessor * maxsAccessor = ksGltf_GetAccessorByNameAndType( scene, maxsAccessorName, "VEC3", GL_FLOAT );
-					scene->skins[skinIndex].jointGeometryMaxs = ksGltf_GetBufferData( maxsAccessor );
-				}
+				vertexShaderUri = ksGltf_FindShaderUri( vertexShader, GLTF_SHADER_TYPE_GLSL, "opengles", GLSL_VERSION );
+				fragmentShaderUri = ksGltf_FindShaderUri( fragmentShader, GLTF_SHADER_TYPE_GLSL, "opengles", GLSL_VERSION );
+			}
+#elif GRAPHICS_API_VULKAN == 1
+			const char * vertexShaderUri = ksGltf_FindShaderUri( vertexShader, GLTF_SHADER_TYPE_SPIRV, "vulkan", SPIRV_VERSION );
+			const char * fragmentShaderUri = ksGltf_FindShaderUri( fragmentShader, GLTF_SHADER_TYPE_SPIRV, "vulkan", SPIRV_VERSION );
+			if ( vertexShaderUri == NULL || fragmentShaderUri == NULL )
+			{
+				vertexShaderUri = ksGltf_FindShaderUri( vertexShader, GLTF_SHADER_TYPE_GLSL, "vulkan", GLSL_VERSION );
+				fragmentShaderUri = ksGltf_FindShaderUri( fragmentShader, GLTF_SHADER_TYPE_GLSL, "vulkan", GLSL_VERSION );
 			}
+#elif GRAPHICS_API_D3D == 1
+			const char * vertexShaderUri = ksGltf_FindShaderUri( vertexShader, GLTF_SHADER_TYPE_HLSL, "d3d", HLSL_VERSION );
+			const char * fragmentShaderUri = ksGltf_FindShaderUri( fragmentShader, GLTF_SHADER_TYPE_HLSL, "d3d", HLSL_VERSION );
+#elif GRAPHICS_API_METAL == 1
+			const char * vertexShaderUri = ksGltf_FindShaderUri( vertexShader, GLTF_SHADER_TYPE_METALSL, "metal", METALSL_VERSION );
+			const char * fragmentShaderUri = ksGltf_FindShaderUri( fragmentShader, GLTF_SHADER_TYPE_METALSL, "metal", METALSL_VERSION );
+#endif
+			ksGltfLoadJob * vertexJob = ksGltf_AddLoadJob( loadJobs );
+			vertexJob->uri = vertexShaderUri;
+			vertexJob->data = &scene->programs[programIndex].vertexSource;
+			vertexJob->dataSize = &scene->programs[programIndex].vertexSourceSize;
+
+			ksGltfLoadJob * fragmentJob = ksGltf_AddLoadJob( loadJobs );
+			fragmentJob->uri = fragmentShaderUri;
+			fragmentJob->data = &scene->programs[programIndex].fragmentSource;
+			fragmentJob->dataSize = &scene->programs[programIndex].fragmentSourceSize;
 		}
-		ksGltf_CreateSkinNameHash( scene );
+		ksGltf_RunLoadJobs( loadJobs );
+		for ( int programIndex = 0; programIndex < scene->programCount; programIndex++ )
+		{
+			assert( scene->programs[programIndex].vertexSource[0] != '\0' );
+			assert( scene->programs[programIndex].fragmentSource[0] != '\0' );
+		}
+		ksGltf_CreateProgramNameHash( scene );
 
 		const ksNanoseconds endTime = GetTimeNanoseconds();
-		Print( "%1.3f seconds to load skins\n", ( endTime - startTime ) * 1e-9f );
+		Print( "%1.3f seconds to load programs\n", ( endTime - startTime ) * 1e-9f );
 	}
 
 	//
-	// glTF cameras
+	// glTF techniques
+	//
+	ksGltf_LoadTechniques( context, scene, settings, ksJson_GetMemberByName( rootNode, "techniques" ), loadJobs );
+
+	//
+	// glTF materials
 	//
 	{
 		const ksNanoseconds startTime = GetTimeNanoseconds();
 
-		const ksJson * cameras = ksJson_GetMemberByName( rootNode, "cameras" );
-		scene->cameraCount = ksJson_GetMemberCount( cameras );
-		scene->cameras = (ksGltfCamera *) calloc( scene->cameraCount, sizeof( ksGltfCamera ) );
-		for ( int cameraIndex = 0; cameraIndex < scene->cameraCount; cameraIndex++ )
+		const ksJson * materials = ksJson_GetMemberByName( rootNode, "materials" );
+		scene->materialCount = ksJson_GetMemberCount( materials );
+		scene->materials = (ksGltfMaterial *) calloc( scene->materialCount, sizeof( ksGltfMaterial ) );
+		for ( int materialIndex = 0; materialIndex < scene->materialCount; materialIndex++ )
 		{
-			const ksJson * camera = ksJson_GetMemberByIndex( cameras, cameraIndex );
-			const char * type = ksJson_GetString( ksJson_GetMemberByName( camera, "type" ), "" );
-			scene->cameras[cameraIndex].name = ksGltf_strdup( ksJson_GetMemberName( camera ) );
-			if ( strcmp( type, "perspective" ) == 0 )
-			{
-				const ksJson * perspective = ksJson_GetMemberByName( camera, "perspective" );
-				const float aspectRatio = ksJson_GetFloat( ksJson_GetMemberByName( perspective, "aspectRatio" ), 0.0f );
-				const float yfov = ksJson_GetFloat( ksJson_GetMemberByName( perspective, "yfov" ), 0.0f );
-				scene->cameras[cameraIndex].type = GLTF_CAMERA_TYPE_PERSPECTIVE;
-				scene->cameras[cameraIndex].perspective.fovDegreesX = ( 180.0f / MATH_PI ) * 2.0f * atanf( tanf( yfov * 0.5f ) * aspectRatio );
-				scene->cameras[cameraIndex].perspective.fovDegreesY = ( 180.0f / MATH_PI ) * yfov;
-				scene->cameras[cameraIndex].perspective.nearZ = ksJson_GetFloat( ksJson_GetMemberByName( perspective, "znear" ), 0.0f );
-				scene->cameras[cameraIndex].perspective.farZ = ksJson_GetFloat( ksJson_GetMemberByName( perspective, "zfar" ), 0.0f );
-				assert( scene->cameras[cameraIndex].perspective.fovDegreesX > 0.0f );
-				assert( scene->cameras[cameraIndex].perspective.fovDegreesY > 0.0f );
-				assert( scene->cameras[cameraIndex].perspective.nearZ > 0.0f );
-			}
-			else
-			{
-				const ksJson * orthographic = ksJson_GetMemberByName( camera, "orthographic" );
-				scene->cameras[cameraIndex].type = GLTF_CAMERA_TYPE_ORTHOGRAPHIC;
-				scene->cameras[cameraIndex].orthographic.magX = ksJson_GetFloat( ksJson_GetMemberByName( orthographic, "xmag" ), 0.0f );
-				scene->cameras[cameraIndex].orthographic.magY = ksJson_GetFloat( ksJson_GetMemberByName( orthographic, "ymag" ), 0.0f );
-				scene->cameras[cameraIndex].orthographic.nearZ = ksJson_GetFloat( ksJson_GetMemberByName( orthographic, "znear" ), 0.0f );
-				scene->cameras[cameraIndex].orthographic.farZ = ksJson_GetFloat( ksJson_GetMemberByName( orthographic, "zfar" ), 0.0f );
-				assert( scene->cameras[cameraIndex].orthographic.magX > 0.0f );
-				assert( scene->cameras[cameraIndex].orthographic.magY > 0.0f );
-				assert( scene->cameras[cameraIndex].orthographic.nearZ > 0.0f );
-			}
-		}
-		ksGltf_CreateCameraNameHash( scene );
+			const ksJson * material = ksJson_GetMemberByIndex( materials, materialIndex );
+			scene->materials[materialIndex].name = ksGltf_strdup( ksJson_GetMemberName( material ) );
+			assert( scene->materials[materialIndex].name[0] != '\0' );
+
+			const ksGltfTechnique * technique = ksGltf_GetTechniqueByName( scene, ksJson_GetString( ksJson_GetMemberByName( material, "technique" ), "" ) );
+			if ( settings->useMultiView )
+			{
+				const ksJson * extensions = ksJson_GetMemberByName( material, "extensions" );
+				if ( extensions != NULL )
+				{
+					const ksJson * KHR_glsl_multi_view = ksJson_GetMemberByName( extensions, "KHR_glsl_multi_view" );
+					if ( KHR_glsl_multi_view != NULL )
+					{
+						const ksGltfTechnique * multiViewTechnique = ksGltf_GetTechniqueByName( scene, ksJson_GetString( ksJson_GetMemberByName( KHR_glsl_multi_view, "technique" ), "" ) );
+						assert( multiViewTechnique != NULL );
+						technique = multiViewTechnique;
+					}
+				}
+			}
+			scene->materials[materialIndex].technique = technique;
+			assert( scene->materials[materialIndex].technique != NULL );
+
+			const ksJson * values = ksJson_GetMemberByName( material, "values" );
+			scene->materials[materialIndex].valueCount = ksJson_GetMemberCount( values );
+			scene->materials[materialIndex].values = (ksGltfMaterialValue *) calloc( scene->materials[materialIndex].valueCount, sizeof( ksGltfMaterialValue ) );
+			for ( int valueIndex = 0; valueIndex < scene->materials[materialIndex].valueCount; valueIndex++ )
+			{
+				const ksJson * value = ksJson_GetMemberByIndex( values, valueIndex );
+				const char * valueName = ksJson_GetMemberName( value );
+				ksGltfUniform * uniform = NULL;
+				for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
+				{
+					if ( strcmp( technique->uniforms[uniformIndex].name, valueName ) == 0 )
+					{
+						uniform = &technique->uniforms[uniformIndex];
+						break;
+					}
+				}
+				if ( uniform == NULL )
+				{
+					assert( false );
+					continue;
+				}
+				assert( uniform->semantic == GLTF_UNIFORM_SEMANTIC_NONE || uniform->semantic == GLTF_UNIFORM_SEMANTIC_DEFAULT_VALUE );
+				scene->materials[materialIndex].values[valueIndex].uniform = uniform;
+				ksGltf_ParseUniformValue( &scene->materials[materialIndex].values[valueIndex].value, value, uniform->type, scene );
+			}
+			// Make sure that the material sets any uniforms that do not have a special semantic or a default value.
+			for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
+			{
+				if ( technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_NONE )
+				{
+					bool found = false;
+					for ( int valueIndex = 0; valueIndex < scene->materials[materialIndex].valueCount; valueIndex++ )
+					{
+						if ( scene->materials[materialIndex].values[valueIndex].uniform == &technique->uniforms[uniformIndex] )
+						{
+							found = true;
+							break;
+						}
+					}
+					assert( found );
+					UNUSED_PARM( found );
+				}
+			}
+		}
+		ksGltf_CreateMaterialNameHash( scene );
 
 		const ksNanoseconds endTime = GetTimeNanoseconds();
-		Print( "%1.3f seconds to load cameras\n", ( endTime - startTime ) * 1e-9f );
+		Print( "%1.3f seconds to load materials\n", ( endTime - startTime ) * 1e-9f );
 	}
 
 	//
-	// glTF nodes
+	// glTF meshes
 	//
 	{
 		const ksNanoseconds startTime = GetTimeNanoseconds();
 
-		const ksJson * nodes = ksJson_GetMemberByName( rootNode, "nodes" );
-		scene->nodeCount = ksJson_GetMemberCount( nodes );
-		scene->nodes = (ksGltfNode *) calloc( scene->nodeCount, sizeof( ksGltfNode ) );
-		for ( int nodeIndex = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
+		const ksJson * models = ksJson_GetMemberByName( rootNode, "meshes" );
+		scene->modelCount = ksJson_GetMemberCount( models );
+		scene->models = (ksGltfModel *) calloc( scene->modelCount, sizeof( ksGltfModel ) );
+		ksGltfGeometryAccessors ** accessors = (ksGltfGeometryAccessors **) calloc( scene->modelCount, sizeof( ksGltfGeometryAccessors * ) );
+		for ( int modelIndex = 0; modelIndex < scene->modelCount; modelIndex++ )
 		{
-			const ksJson * node = ksJson_GetMemberByIndex( nodes, nodeIndex );
-			scene->nodes[nodeIndex].name = ksGltf_strdup( ksJson_GetMemberName( node ) );
-			scene->nodes[nodeIndex].jointName = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( node, "jointName" ), "" ) );
-			const ksJson * matrix = ksJson_GetMemberByName( node, "matrix" );
-			if ( ksJson_IsArray( matrix ) )
-			{
-				ksMatrix4x4f localTransform;
-				ksGltf_ParseFloatArray( localTransform.m[0], 16, matrix );
-				ksMatrix4x4f_GetTranslation( &scene->nodes[nodeIndex].translation, &localTransform );
-				ksMatrix4x4f_GetRotation( &scene->nodes[nodeIndex].rotation, &localTransform );
-				ksMatrix4x4f_GetScale( &scene->nodes[nodeIndex].scale, &localTransform );
-			}
-			else
+			const ksJson * model = ksJson_GetMemberByIndex( models, modelIndex );
+			scene->models[modelIndex].name = ksGltf_strdup( ksJson_GetMemberName( model ) );
+
+			ksVector3f_Set( &scene->models[modelIndex].mins, FLT_MAX );
+			ksVector3f_Set( &scene->models[modelIndex].maxs, -FLT_MAX );
+
+			assert( scene->models[modelIndex].name[0] != '\0' );
+
+			const ksJson * primitives = ksJson_GetMemberByName( model, "primitives" );
+			scene->models[modelIndex].surfaceCount = ksJson_GetMemberCount( primitives );
+			scene->models[modelIndex].surfaces = (ksGltfSurface *) calloc( scene->models[modelIndex].surfaceCount, sizeof( ksGltfSurface ) );
+			accessors[modelIndex] = (ksGltfGeometryAccessors *) calloc( scene->models[modelIndex].surfaceCount, sizeof( ksGltfGeometryAccessors ) );
+			for ( int surfaceIndex = 0; surfaceIndex < scene->models[modelIndex].surfaceCount; surfaceIndex++ )
 			{
-				ksGltf_ParseFloatArray( &scene->nodes[nodeIndex].rotation.x, 4, ksJson_GetMemberByName( node, "rotation" ) );
-				ksGltf_ParseFloatArray( &scene->nodes[nodeIndex].scale.x, 3, ksJson_GetMemberByName( node, "scale" ) );
-				ksGltf_ParseFloatArray( &scene->nodes[nodeIndex].translation.x, 3, ksJson_GetMemberByName( node, "translation" ) );
+				ksGltfSurface * surface = &scene->models[modelIndex].surfaces[surfaceIndex];
+				const ksJson * primitive = ksJson_GetMemberByIndex( primitives, surfaceIndex );
+				const ksJson * attributes = ksJson_GetMemberByName( primitive, "attributes" );
+
+				const char * positionAccessorName		= ksJson_GetString( ksJson_GetMemberByName( attributes, "POSITION" ), "" );
+				const char * normalAccessorName			= ksJson_GetString( ksJson_GetMemberByName( attributes, "NORMAL" ), "" );
+				const char * tangentAccessorName		= ksJson_GetString( ksJson_GetMemberByName( attributes, "TANGENT" ), "" );
+				const char * binormalAccessorName		= ksJson_GetString( ksJson_GetMemberByName( attributes, "BINORMAL" ), "" );
+				const char * colorAccessorName			= ksJson_GetString( ksJson_GetMemberByName( attributes, "COLOR" ), "" );
+				const char * uv0AccessorName			= ksJson_GetString( ksJson_GetMemberByName( attributes, "TEXCOORD_0" ), "" );
+				const char * uv1AccessorName			= ksJson_GetString( ksJson_GetMemberByName( attributes, "TEXCOORD_1" ), "" );
+				const char * uv2AccessorName			= ksJson_GetString( ksJson_GetMemberByName( attributes, "TEXCOORD_2" ), "" );
+				const char * jointIndicesAccessorName	= ksJson_GetString( ksJson_GetMemberByName( attributes, "JOINT" ), "" );
+				const char * jointWeightsAccessorName	= ksJson_GetString( ksJson_GetMemberByName( attributes, "WEIGHT" ), "" );
+				const char * indicesAccessorName		= ksJson_GetString( ksJson_GetMemberByName( primitive, "indices" ), "" );
+
+				surface->material = ksGltf_GetMaterialByName( scene, ksJson_GetString( ksJson_GetMemberByName( primitive, "material" ), "" ) );
+				assert( surface->material != NULL );
+
+				ksGltfGeometryAccessors * surfaceAccessors = &accessors[modelIndex][surfaceIndex];
+				surfaceAccessors->position		= ksGltf_GetAccessorByNameAndType( scene, positionAccessorName,		"VEC3",		GL_FLOAT );
+				surfaceAccessors->normal		= ksGltf_GetAccessorByNameAndType( scene, normalAccessorName,		"VEC3",		GL_FLOAT );
+				surfaceAccessors->tangent		= ksGltf_GetAccessorByNameAndType( scene, tangentAccessorName,		"VEC3",		GL_FLOAT );
+				surfaceAccessors->binormal		= ksGltf_GetAccessorByNameAndType( scene, binormalAccessorName,		"VEC3",		GL_FLOAT );
+				surfaceAccessors->color			= ksGltf_GetAccessorByNameAndType( scene, colorAccessorName,		"VEC4",		GL_FLOAT );
+				surfaceAccessors->uv0			= ksGltf_GetAccessorByNameAndType( scene, uv0AccessorName,			"VEC2",		GL_FLOAT );
+				surfaceAccessors->uv1			= ksGltf_GetAccessorByNameAndType( scene, uv1AccessorName,			"VEC2",		GL_FLOAT );
+				surfaceAccessors->uv2			= ksGltf_GetAccessorByNameAndType( scene, uv2AccessorName,			"VEC2",		GL_FLOAT );
+				surfaceAccessors->jointIndices	= ksGltf_GetAccessorByNameAndType( scene, jointIndicesAccessorName,	"VEC4",		GL_FLOAT );
+				surfaceAccessors->jointWeights	= ksGltf_GetAccessorByNameAndType( scene, jointWeightsAccessorName,	"VEC4",		GL_FLOAT );
+				surfaceAccessors->indices		= ksGltf_GetAccessorByNameAndType( scene, indicesAccessorName,		"SCALAR",	GL_UNSIGNED_SHORT );
+
+				if ( surfaceAccessors->position == NULL || surfaceAccessors->indices == NULL )
+				{
+					assert( false );
+					continue;
+				}
+
+				surface->mins.x = surfaceAccessors->position->floatMin[0];
+				surface->mins.y = surfaceAccessors->position->floatMin[1];
+				surface->mins.z = surfaceAccessors->position->floatMin[2];
+				surface->maxs.x = surfaceAccessors->position->floatMax[0];
+				surface->maxs.y = surfaceAccessors->position->floatMax[1];
+				surface->maxs.z = surfaceAccessors->position->floatMax[2];
+
+				ksGltf_CreateSurface( context, scene, renderPass, accessors, modelIndex, surfaceIndex );
+
+				ksVector3f_Min( &scene->models[modelIndex].mins, &scene->models[modelIndex].mins, &surface->mins );
+				ksVector3f_Max( &scene->models[modelIndex].maxs, &scene->models[modelIndex].maxs, &surface->maxs );
 			}
+		}
 
-			assert( scene->nodes[nodeIndex].name[0] != '\0' );
+		// Free the accessors.
+		for ( int modelIndex = 0; modelIndex < scene->modelCount; modelIndex++ )
+		{
+			free( accessors[modelIndex] );
+		}
+		free( accessors );
 
-			const ksJson * children = ksJson_GetMemberByName( node, "children" );
-			scene->nodes[nodeIndex].childCount = ksJson_GetMemberCount( children );
-			scene->nodes[nodeIndex].childNames = (char **) calloc( scene->nodes[nodeIndex].childCount, sizeof( char * ) );
-			for ( int c = 0; c < scene->nodes[nodeIndex].childCount; c++ )
+		ksGltf_CreateModelNameHash( scene );
+
+		const ksNanoseconds endTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to load models\n", ( endTime - startTime ) * 1e-9f );
+	}
+
+	//
+	// glTF animations
+	//
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+
+		const ksJson * animations = ksJson_GetMemberByName( rootNode, "animations" );
+		scene->animationCount = ksJson_GetMemberCount( animations );
+		scene->animations = (ksGltfAnimation *) calloc( scene->animationCount, sizeof( ksGltfAnimation ) );
+		scene->timeLineCount = 0;	// May not need all because they are often shared.
+		scene->timeLines = (ksGltfTimeLine *) calloc( scene->animationCount, sizeof( ksGltfTimeLine ) );
+		for ( int animationIndex = 0; animationIndex < scene->animationCount; animationIndex++ )
+		{
+			const ksJson * animation = ksJson_GetMemberByIndex( animations, animationIndex );
+			scene->animations[animationIndex].name = ksGltf_strdup( ksJson_GetMemberName( animation ) );
+
+			const ksJson * parameters = ksJson_GetMemberByName( animation, "parameters" );
+			const ksJson * samplers = ksJson_GetMemberByName( animation, "samplers" );
+
+			// This assumes there is only a single time-line per animation.
+			const char * timeAccessorName = ksJson_GetString( ksJson_GetMemberByName( parameters, "TIME" ), "" );
+			const ksGltfAccessor * timeAccessor = ksGltf_GetAccessorByNameAndType( scene, timeAccessorName, "SCALAR", GL_FLOAT );
+
+			if ( timeAccessor == NULL || timeAccessor->count <= 0 )
 			{
-				scene->nodes[nodeIndex].childNames[c] = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByIndex( children, c ), "" ) );
+				assert( false );
+				continue;
 			}
-			scene->nodes[nodeIndex].camera = ksGltf_GetCameraByName( scene, ksJson_GetString( ksJson_GetMemberByName( node, "camera" ), "" ) );
-			scene->nodes[nodeIndex].skin = ksGltf_GetSkinByName( scene, ksJson_GetString( ksJson_GetMemberByName( node, "skin" ), "" ) );
-			const ksJson * meshes = ksJson_GetMemberByName( node, "meshes" );
-			scene->nodes[nodeIndex].modelCount = ksJson_GetMemberCount( meshes );
-			scene->nodes[nodeIndex].models = (ksGltfModel **) calloc( scene->nodes[nodeIndex].modelCount, sizeof( ksGltfModel ** ) );
-			for ( int m = 0; m < scene->nodes[nodeIndex].modelCount; m++ )
+
+			const int sampleCount = timeAccessor->count;
+			float * sampleTimes = (float *)ksGltf_GetBufferData( timeAccessor );
+
+			assert( sampleCount >= 2 );
+			assert( sampleTimes != NULL );
+
+			scene->animations[animationIndex].timeLine = ksGltf_GetTimeLine( scene, sampleTimes, sampleCount );
+
+			const ksJson * channels = ksJson_GetMemberByName( animation, "channels" );
+			scene->animations[animationIndex].channelCount = ksJson_GetMemberCount( channels );
+			scene->animations[animationIndex].channels = (ksGltfAnimationChannel *) calloc( scene->animations[animationIndex].channelCount, sizeof( ksGltfAnimationChannel ) );
+			int newChannelCount = 0;
+			for ( int channelIndex = 0; channelIndex < scene->animations[animationIndex].channelCount; channelIndex++ )
 			{
-				scene->nodes[nodeIndex].models[m] = ksGltf_GetModelByName( scene, ksJson_GetString( ksJson_GetMemberByIndex( meshes, m ), "" ) );
-				assert( scene->nodes[nodeIndex].models[m] != NULL );
-			}
-		}
-		ksGltf_SortNodes( scene->nodes, scene->nodeCount );
-		ksGltf_CreateNodeNameHash( scene );
-		ksGltf_CreateNodeJointNameHash( scene );
+				const ksJson * channel = ksJson_GetMemberByIndex( channels, channelIndex );
+				const char * samplerName = ksJson_GetString( ksJson_GetMemberByName( channel, "sampler" ), "" );
+				const ksJson * sampler = ksJson_GetMemberByName( samplers, samplerName );
+				const char * inputName = ksJson_GetString( ksJson_GetMemberByName( sampler, "input" ), "" );
+				const char * interpolation = ksJson_GetString( ksJson_GetMemberByName( sampler, "interpolation" ), "" );
+				const char * outputName = ksJson_GetString( ksJson_GetMemberByName( sampler, "output" ), "" );
+				const char * accessorName = ksJson_GetString( ksJson_GetMemberByName( parameters, outputName ), "" );
+
+				assert( strcmp( inputName, "TIME" ) == 0 );
+				assert( strcmp( interpolation, "LINEAR" ) == 0 );
+				assert( outputName[0] != '\0' );
+				assert( accessorName[0] != '\0' );
+
+				UNUSED_PARM( inputName );
+				UNUSED_PARM( interpolation );
+
+				const ksJson * target = ksJson_GetMemberByName( channel, "target" );
+				const char * nodeName = ksJson_GetString( ksJson_GetMemberByName( target, "id" ), "" );
+				const char * pathName = ksJson_GetString( ksJson_GetMemberByName( target, "path" ), "" );
+
+				ksVector3f * translation = NULL;
+				ksQuatf * rotation = NULL;
+				ksVector3f * scale = NULL;
+
+				if ( strcmp( pathName, "translation" ) == 0 )
+				{
+					const ksGltfAccessor * accessor	= ksGltf_GetAccessorByNameAndType( scene, accessorName, "VEC3", GL_FLOAT );
+					assert( accessor != NULL );
+					translation = (ksVector3f *) ksGltf_GetBufferData( accessor );
+				}
+				else if ( strcmp( pathName, "rotation" ) == 0 )
+				{
+					const ksGltfAccessor * accessor	= ksGltf_GetAccessorByNameAndType( scene, accessorName, "VEC4", GL_FLOAT );
+					assert( accessor != NULL );
+					rotation = (ksQuatf *) ksGltf_GetBufferData( accessor );
+				}
+				else if ( strcmp( pathName, "scale" ) == 0 )
+				{
+					const ksGltfAccessor * accessor	= ksGltf_GetAccessorByNameAndType( scene, accessorName, "VEC3", GL_FLOAT );
+					assert( accessor != NULL );
+					scale = (ksVector3f *) ksGltf_GetBufferData( accessor );
+				}
+
+				// Try to merge this channel with a previous channel for the same node.
+				for ( int k = 0; k < newChannelCount; k++ )
+				{
+					if ( strcmp( nodeName, scene->animations[animationIndex].channels[k].nodeName ) == 0 )
+					{
+						if ( translation != NULL )
+						{
+							scene->animations[animationIndex].channels[k].translation = translation;
+							translation = NULL;
+						}
+						if ( rotation != NULL )
+						{
+							scene->animations[animationIndex].channels[k].rotation = rotation;
+							rotation = NULL;
+						}
+						if ( scale != NULL )
+						{
+							scene->animations[animationIndex].channels[k].scale = scale;
+							scale = NULL;
+						}
+						break;
+					}
+				}
+
+				// Only store the channel if it was not merged.
+				if ( translation != NULL || rotation != NULL || scale != NULL )
+				{
+					scene->animations[animationIndex].channels[newChannelCount].nodeName = ksGltf_strdup( nodeName );
+					scene->animations[animationIndex].channels[newChannelCount].node = NULL; // linked up once the nodes are loaded
+					scene->animations[animationIndex].channels[newChannelCount].translation = translation;
+					scene->animations[animationIndex].channels[newChannelCount].rotation = rotation;
+					scene->animations[animationIndex].channels[newChannelCount].scale = scale;
+					newChannelCount++;
+				}
+			}
+			scene->animations[animationIndex].channelCount = newChannelCount;
+		}
+		ksGltf_CreateAnimationNameHash( scene );
+
+		const ksNanoseconds endTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to load animations\n", ( endTime - startTime ) * 1e-9f );
+	}
+
+	//
+	// glTF skins
+	//
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+
+		const ksJson * skins = ksJson_GetMemberByName( rootNode, "skins" );
+		scene->skinCount = ksJson_GetMemberCount( skins );
+		scene->skins = (ksGltfSkin *) calloc( scene->skinCount, sizeof( ksGltfSkin ) );
+		for ( int skinIndex = 0; skinIndex < scene->skinCount; skinIndex++ )
+		{
+			const ksJson * skin = ksJson_GetMemberByIndex( skins, skinIndex );
+			scene->skins[skinIndex].name = ksGltf_strdup( ksJson_GetMemberName( skin ) );
+			ksMatrix4x4f bindShapeMatrix;
+			ksGltf_ParseFloatArray( bindShapeMatrix.m[0], 16, ksJson_GetMemberByName( skin, "bindShapeMatrix" ) );
+
+			const char * bindAccessorName = ksJson_GetString( ksJson_GetMemberByName( skin, "inverseBindMatrices" ), "" );
+			const ksGltfAccessor * bindAccess = ksGltf_GetAccessorByNameAndType( scene, bindAccessorName, "MAT4", GL_FLOAT );
+			scene->skins[skinIndex].inverseBindMatrices = ksGltf_GetBufferData( bindAccess );
+
+			assert( scene->skins[skinIndex].name[0] != '\0' );
+			assert( scene->skins[skinIndex].inverseBindMatrices != NULL );
+
+			scene->skins[skinIndex].parentNode = NULL;	// linked up once the nodes are loaded
+
+			const ksJson * jointNames = ksJson_GetMemberByName( skin, "jointNames" );
+			scene->skins[skinIndex].jointCount = ksJson_GetMemberCount( jointNames );
+			scene->skins[skinIndex].joints = (ksGltfJoint *) calloc( scene->skins[skinIndex].jointCount, sizeof( ksGltfJoint ) );
+			assert( scene->skins[skinIndex].jointCount <= GLTF_MAX_JOINTS );
+			for ( int jointIndex = 0; jointIndex < scene->skins[skinIndex].jointCount; jointIndex++ )
+			{
+				ksMatrix4x4f inverseBindMatrix;
+				ksMatrix4x4f_Multiply( &inverseBindMatrix, &scene->skins[skinIndex].inverseBindMatrices[jointIndex], &bindShapeMatrix );
+				scene->skins[skinIndex].inverseBindMatrices[jointIndex] = inverseBindMatrix;
+
+				scene->skins[skinIndex].joints[jointIndex].name = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByIndex( jointNames, jointIndex ), "" ) );
+				scene->skins[skinIndex].joints[jointIndex].node = NULL; // linked up once the nodes are loaded
+			}
+			assert( bindAccess->count == scene->skins[skinIndex].jointCount );
+
+			ksGpuBuffer_Create( context, &scene->skins[skinIndex].jointBuffer, KS_GPU_BUFFER_TYPE_UNIFORM, scene->skins[skinIndex].jointCount * sizeof( ksMatrix4x4f ), NULL, false );
+			scene->skins[skinIndex].jointBinding = &scene->skins[skinIndex].jointBuffer;
+
+			const ksJson * extensions = ksJson_GetMemberByName( skin, "extensions" );
+			if ( extensions != NULL )
+			{
+				const ksJson * KHR_skin_culling = ksJson_GetMemberByName( extensions, "KHR_skin_culling" );
+				if ( KHR_skin_culling != NULL )
+				{
+					const char * minsAccessorName = ksJson_GetString( ksJson_GetMemberByName( KHR_skin_culling, "jointGeometryMins" ), "" );
+					const ksGltfAccessor * minsAccessor = ksGltf_GetAccessorByNameAndType( scene, minsAccessorName, "VEC3", GL_FLOAT );
+					scene->skins[skinIndex].jointGeometryMins = ksGltf_GetBufferData( minsAccessor );
+
+					const char * maxsAccessorName = ksJson_GetString( ksJson_GetMemberByName( KHR_skin_culling, "jointGeometryMaxs" ), "" );
+					const ksGltfAccessor * maxsAccessor = ksGltf_GetAccessorByNameAndType( scene, maxsAccessorName, "VEC3", GL_FLOAT );
+					scene->skins[skinIndex].jointGeometryMaxs = ksGltf_GetBufferData( maxsAccessor );
+				}
+			}
+		}
+		ksGltf_CreateSkinNameHash( scene );
+
+		const ksNanoseconds endTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to load skins\n", ( endTime - startTime ) * 1e-9f );
+	}
+
+	//
+	// glTF cameras
+	//
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+
+		const ksJson * cameras = ksJson_GetMemberByName( rootNode, "cameras" );
+		scene->cameraCount = ksJson_GetMemberCount( cameras );
+		scene->cameras = (ksGltfCamera *) calloc( scene->cameraCount, sizeof( ksGltfCamera ) );
+		for ( int cameraIndex = 0; cameraIndex < scene->cameraCount; cameraIndex++ )
+		{
+			const ksJson * camera = ksJson_GetMemberByIndex( cameras, cameraIndex );
+			scene->cameras[cameraIndex].name = ksGltf_strdup( ksJson_GetMemberName( camera ) );
+			ksGltf_ParseCamera( &scene->cameras[cameraIndex], camera );
+		}
+		ksGltf_CreateCameraNameHash( scene );
+
+		const ksNanoseconds endTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to load cameras\n", ( endTime - startTime ) * 1e-9f );
+	}
+
+	//
+	// glTF nodes
+	//
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+
+		const ksJson * nodes = ksJson_GetMemberByName( rootNode, "nodes" );
+		scene->nodeCount = ksJson_GetMemberCount( nodes );
+		scene->nodes = (ksGltfNode *) calloc( scene->nodeCount, sizeof( ksGltfNode ) );
+		for ( int nodeIndex = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
+		{
+			const ksJson * node = ksJson_GetMemberByIndex( nodes, nodeIndex );
+			scene->nodes[nodeIndex].name = ksGltf_strdup( ksJson_GetMemberName( node ) );
+			scene->nodes[nodeIndex].jointName = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( node, "jointName" ), "" ) );
+			const ksJson * matrix = ksJson_GetMemberByName( node, "matrix" );
+			if ( ksJson_IsArray( matrix ) )
+			{
+				ksMatrix4x4f localTransform;
+				ksGltf_ParseFloatArray( localTransform.m[0], 16, matrix );
+				ksMatrix4x4f_GetTranslation( &scene->nodes[nodeIndex].translation, &localTransform );
+				ksMatrix4x4f_GetRotation( &scene->nodes[nodeIndex].rotation, &localTransform );
+				ksMatrix4x4f_GetScale( &scene->nodes[nodeIndex].scale, &localTransform );
+			}
+			else
+			{
+				ksGltf_ParseFloatArray( &scene->nodes[nodeIndex].rotation.x, 4, ksJson_GetMemberByName( node, "rotation" ) );
+				ksGltf_ParseFloatArray( &scene->nodes[nodeIndex].scale.x, 3, ksJson_GetMemberByName( node, "scale" ) );
+				ksGltf_ParseFloatArray( &scene->nodes[nodeIndex].translation.x, 3, ksJson_GetMemberByName( node, "translation" ) );
+			}
+
+			assert( scene->nodes[nodeIndex].name[0] != '\0' );
+
+			const ksJson * children = ksJson_GetMemberByName( node, "children" );
+			scene->nodes[nodeIndex].childCount = ksJson_GetMemberCount( children );
+			scene->nodes[nodeIndex].childNames = (char **) calloc( scene->nodes[nodeIndex].childCount, sizeof( char * ) );
+			for ( int c = 0; c < scene->nodes[nodeIndex].childCount; c++ )
+			{
+				scene->nodes[nodeIndex].childNames[c] = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByIndex( children, c ), "" ) );
+			}
+			scene->nodes[nodeIndex].camera = ksGltf_GetCameraByName( scene, ksJson_GetString( ksJson_GetMemberByName( node, "camera" ), "" ) );
+			scene->nodes[nodeIndex].skin = ksGltf_GetSkinByName( scene, ksJson_GetString( ksJson_GetMemberByName( node, "skin" ), "" ) );
+			const ksJson * meshes = ksJson_GetMemberByName( node, "meshes" );
+			scene->nodes[nodeIndex].modelCount = ksJson_GetMemberCount( meshes );
+			scene->nodes[nodeIndex].models = (ksGltfModel **) calloc( scene->nodes[nodeIndex].modelCount, sizeof( ksGltfModel ** ) );
+			for ( int m = 0; m < scene->nodes[nodeIndex].modelCount; m++ )
+			{
+				scene->nodes[nodeIndex].models[m] = ksGltf_GetModelByName( scene, ksJson_GetString( ksJson_GetMemberByIndex( meshes, m ), "" ) );
+				assert( scene->nodes[nodeIndex].models[m] != NULL );
+			}
+		}
+		ksGltf_SortNodes( scene->nodes, scene->nodeCount );
+		ksGltf_CreateNodeNameHash( scene );
+		ksGltf_CreateNodeJointNameHash( scene );
+
+		const ksNanoseconds endTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to load nodes\n", ( endTime - startTime ) * 1e-9f );
+	}
+
+	//
+	// Assign node pointers now that the nodes are sorted and the hash is setup.
+	//
+	{
+		// Get the node children and parents.
+		for ( int nodeIndex = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
+		{
+			ksGltfNode * node = &scene->nodes[nodeIndex];
+			node->children = (ksGltfNode **) calloc( node->childCount, sizeof( ksGltfNode * ) );
+			for ( int childIndex = 0; childIndex < node->childCount; childIndex++ )
+			{
+				node->children[childIndex] = ksGltf_GetNodeByName( scene, node->childNames[childIndex] );
+				assert( node->children[childIndex] != NULL );
+				node->children[childIndex]->parent = node;
+			}
+		}
+		// Get the uniform nodes of techniques.
+		for ( int techniqueIndex = 0; techniqueIndex < scene->techniqueCount; techniqueIndex++ )
+		{
+			for ( int uniformIndex = 0; uniformIndex < scene->techniques[techniqueIndex].uniformCount; uniformIndex++ )
+			{
+				ksGltfUniform * uniform = &scene->techniques[techniqueIndex].uniforms[uniformIndex];
+				if ( uniform->nodeName != NULL )
+				{
+					uniform->node = ksGltf_GetNodeByName( scene, uniform->nodeName );
+					assert( uniform->node != NULL );
+				}
+			}
+		}
+		// Get the animated nodes.
+		for ( int animationIndex = 0; animationIndex < scene->animationCount; animationIndex++ )
+		{
+			for ( int channelIndex = 0; channelIndex < scene->animations[animationIndex].channelCount; channelIndex++ )
+			{
+				ksGltfAnimationChannel * channel = &scene->animations[animationIndex].channels[channelIndex];
+				channel->node = ksGltf_GetNodeByName( scene, channel->nodeName );
+				assert( channel->node != NULL );
+			}
+		}
+		// Pack the animation channels per time line.
+		ksGltf_PackChannelBlocks( scene );
+		// Get the skin joint nodes.
+		for ( int skinIndex = 0; skinIndex < scene->skinCount; skinIndex++ )
+		{
+			for ( int jointIndex = 0; jointIndex < scene->skins[skinIndex].jointCount; jointIndex++ )
+			{
+				scene->skins[skinIndex].joints[jointIndex].node = ksGltf_GetNodeByJointName( scene, scene->skins[skinIndex].joints[jointIndex].name );
+				assert( scene->skins[skinIndex].joints[jointIndex].node != NULL );
+			}
+			scene->skins[skinIndex].parentNode = ksGltf_FindSkinParentNode( &scene->skins[skinIndex] );
+		}
+	}
+
+	//
+	// glTF sub-scenes
+	//
+	{
+		// The nodes are sorted such that parents come before their children.
+		int * nodeDepth = (int *) malloc( scene->nodeCount * sizeof( int ) );
+		for ( int nodeIndex = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
+		{
+			const ksGltfNode * parent = scene->nodes[nodeIndex].parent;
+			nodeDepth[nodeIndex] = ( parent != NULL ) ? nodeDepth[(int)( parent - scene->nodes )] + 1 : 0;
+		}
+
+		const ksJson * subScenes = ksJson_GetMemberByName( rootNode, "scenes" );
+		scene->subTreeCount = 0;
+		scene->subTrees = (ksGltfSubTree *) calloc( scene->nodeCount, sizeof( ksGltfSubTree ) );
+		scene->subSceneCount = ksJson_GetMemberCount( subScenes );
+		scene->subScenes = (ksGltfSubScene *) calloc( scene->subSceneCount, sizeof( ksGltfSubScene ) );
+		for ( int subSceneIndex = 0; subSceneIndex < scene->subSceneCount; subSceneIndex++ )
+		{
+			const ksJson * subScene = ksJson_GetMemberByIndex( subScenes, subSceneIndex );
+			scene->subScenes[subSceneIndex].name = ksGltf_strdup( ksJson_GetMemberName( subScene ) );
+
+			const ksJson * nodes = ksJson_GetMemberByName( subScene, "nodes" );
+			scene->subScenes[subSceneIndex].subTreeCount = ksJson_GetMemberCount( nodes );
+			scene->subScenes[subSceneIndex].subTrees = (ksGltfSubTree **) calloc( scene->subScenes[subSceneIndex].subTreeCount, sizeof( ksGltfSubTree * ) );
+
+			for ( int subTreeIndex = 0; subTreeIndex < scene->subScenes[subSceneIndex].subTreeCount; subTreeIndex++ )
+			{
+				const char * nodeName = ksJson_GetString( ksJson_GetMemberByIndex( nodes, subTreeIndex ), "" );
+
+				scene->subScenes[subSceneIndex].subTrees[subTreeIndex] = NULL;
+				for ( int i = 0; i < scene->subTreeCount; i++ )
+				{
+					if ( strcmp( scene->subTrees[i].name, nodeName ) == 0 )
+					{
+						scene->subScenes[subSceneIndex].subTrees[subTreeIndex] = &scene->subTrees[i];
+						break;
+					}
+				}
+
+				if ( scene->subScenes[subSceneIndex].subTrees[subTreeIndex] == NULL )
+				{
+					ksGltfSubTree * subTree = &scene->subTrees[scene->subTreeCount++];
+					subTree->name = ksGltf_strdup( nodeName );
+
+					ksGltfNode * subTreeRootNode = ksGltf_GetNodeByName( scene, nodeName );
+					assert( subTreeRootNode != NULL );
+
+					ksGltf_CreateSubTree( scene, subTree, subTreeRootNode, nodeDepth );
+
+					scene->subScenes[subSceneIndex].subTrees[subTreeIndex] = subTree;
+				}
+			}
+		}
+		ksGltf_CreateSubTreeNameHash( scene );
+		ksGltf_CreateSubSceneNameHash( scene );
+
+		free( nodeDepth );
+	}
+
+	//
+	// glTF default scene
+	//
+
+	const char * defaultSceneName = ksJson_GetString( ksJson_GetMemberByName( rootNode, "scene" ), "" );
+	scene->state.currentSubScene = ksGltf_GetSubSceneByName( scene, defaultSceneName );
+	assert( scene->state.currentSubScene != NULL );
+}
+
+// Returns the glTF 2.0 index stored in a JSON node, or -1 if there is no valid index.
+static int ksGltf_ParseIndex( const ksJson * json, const int count )
+{
+	const int index = ksJson_GetInt32( json, -1 );
+	assert( index < count );
+	return ( index >= 0 && index < count ) ? index : -1;
+}
+
+/*
+	glTF 2.0 has no techniques, shaders or programs. All materials use the metallic-roughness
+	PBR model, so a GLSL 1.00 program and a technique are generated for every combination of
+	material features and vertex attributes that is actually used by the scene. The generated
+	techniques are loaded and converted exactly like glTF 1.0 techniques.
+*/
+typedef enum
+{
+	GLTF_PBR_FLAG_TEXCOORD						= BIT( 0 ),
+	GLTF_PBR_FLAG_BASE_COLOR_TEXTURE			= BIT( 1 ),
+	GLTF_PBR_FLAG_METALLIC_ROUGHNESS_TEXTURE	= BIT( 2 ),
+	GLTF_PBR_FLAG_OCCLUSION_TEXTURE				= BIT( 3 ),
+	GLTF_PBR_FLAG_EMISSIVE_TEXTURE				= BIT( 4 ),
+	GLTF_PBR_FLAG_VERTEX_COLOR					= BIT( 5 ),
+	GLTF_PBR_FLAG_NORMAL						= BIT( 6 ),
+	GLTF_PBR_FLAG_SKINNED						= BIT( 7 ),
+	GLTF_PBR_FLAG_ALPHA_MASK					= BIT( 8 ),
+	GLTF_PBR_FLAG_ALPHA_BLEND					= BIT( 9 ),
+	GLTF_PBR_FLAG_DOUBLE_SIDED					= BIT( 10 )
+} ksGltfPbrFlags;
+
+#define GLTF_PBR_FLAG_TEXTURES		( GLTF_PBR_FLAG_BASE_COLOR_TEXTURE | GLTF_PBR_FLAG_METALLIC_ROUGHNESS_TEXTURE | \
+									GLTF_PBR_FLAG_OCCLUSION_TEXTURE | GLTF_PBR_FLAG_EMISSIVE_TEXTURE )
+
+typedef struct
+{
+	int							required;		// flags that must all be set to include the line
+	int							excluded;		// flags that must all be clear to include the line
+	const char *				line;
+} ksGltfPbrLine;
+
+static const ksGltfPbrLine gltfPbrVertexShader[] =
+{
+	{ 0,									0,						"precision highp float;\n" },
+	{ 0,									0,						"uniform mat4 u_modelMatrix;\n" },
+	{ 0,									0,						"uniform mat4 u_viewMatrix;\n" },
+	{ 0,									0,						"uniform mat4 u_projectionMatrix;\n" },
+	{ GLTF_PBR_FLAG_NORMAL,					0,						"uniform mat4 u_viewInverseMatrix;\n" },
+	{ GLTF_PBR_FLAG_SKINNED,				0,						"uniform mat4 u_jointMatrices[256];\n" },
+	{ 0,									0,						"attribute vec3 a_position;\n" },
+	{ GLTF_PBR_FLAG_NORMAL,					0,						"attribute vec3 a_normal;\n" },
+	{ GLTF_PBR_FLAG_TEXCOORD,				0,						"attribute vec2 a_uv0;\n" },
+	{ GLTF_PBR_FLAG_VERTEX_COLOR,			0,						"attribute vec4 a_color;\n" },
+	{ GLTF_PBR_FLAG_SKINNED,				0,						"attribute vec4 a_joints;\n" },
+	{ GLTF_PBR_FLAG_SKINNED,				0,						"attribute vec4 a_weights;\n" },
+	{ GLTF_PBR_FLAG_NORMAL,					0,						"varying vec3 v_normal;\n" },
+	{ GLTF_PBR_FLAG_NORMAL,					0,						"varying vec3 v_viewDirection;\n" },
+	{ GLTF_PBR_FLAG_TEXCOORD,				0,						"varying vec2 v_uv0;\n" },
+	{ GLTF_PBR_FLAG_VERTEX_COLOR,			0,						"varying vec4 v_color;\n" },
+	{ 0,									0,						"void main( void )\n" },
+	{ 0,									0,						"{\n" },
+	{ 0,									GLTF_PBR_FLAG_SKINNED,	"	mat4 modelMatrix = u_modelMatrix;\n" },
+	{ GLTF_PBR_FLAG_SKINNED,				0,						"	mat4 modelMatrix = u_modelMatrix * (\n" },
+	{ GLTF_PBR_FLAG_SKINNED,				0,						"		a_weights.x * u_jointMatrices[int( a_joints.x )] +\n" },
+	{ GLTF_PBR_FLAG_SKINNED,				0,						"		a_weights.y * u_jointMatrices[int( a_joints.y )] +\n" },
+	{ GLTF_PBR_FLAG_SKINNED,				0,						"		a_weights.z * u_jointMatrices[int( a_joints.z )] +\n" },
+	{ GLTF_PBR_FLAG_SKINNED,				0,						"		a_weights.w * u_jointMatrices[int( a_joints.w )] );\n" },
+	{ 0,									0,						"	vec4 position = modelMatrix * vec4( a_position, 1.0 );\n" },
+	{ GLTF_PBR_FLAG_NORMAL,					0,						"	v_normal = mat3( modelMatrix ) * a_normal;\n" },
+	{ GLTF_PBR_FLAG_NORMAL,					0,						"	v_viewDirection = u_viewInverseMatrix[3].xyz - position.xyz;\n" },
+	{ GLTF_PBR_FLAG_TEXCOORD,				0,						"	v_uv0 = a_uv0;\n" },
+	{ GLTF_PBR_FLAG_VERTEX_COLOR,			0,						"	v_color = a_color;\n" },
+	{ 0,									0,						"	gl_Position = u_projectionMatrix * ( u_viewMatrix * position );\n" },
+	{ 0,									0,						"}\n" }
+};
+
+// A single directional light with a GGX specular term and a constant ambient term.
+static const ksGltfPbrLine gltfPbrFragmentShader[] =
+{
+	{ 0,											0,							"precision highp float;\n" },
+	{ 0,											0,							"uniform vec4 u_baseColorFactor;\n" },
+	{ 0,											0,							"uniform vec3 u_emissiveFactor;\n" },
+	{ 0,											0,							"uniform vec4 u_materialFactors;\n" },
+	{ GLTF_PBR_FLAG_BASE_COLOR_TEXTURE,				0,							"uniform sampler2D u_baseColorTexture;\n" },
+	{ GLTF_PBR_FLAG_METALLIC_ROUGHNESS_TEXTURE,		0,							"uniform sampler2D u_metallicRoughnessTexture;\n" },
+	{ GLTF_PBR_FLAG_OCCLUSION_TEXTURE,				0,							"uniform sampler2D u_occlusionTexture;\n" },
+	{ GLTF_PBR_FLAG_EMISSIVE_TEXTURE,				0,							"uniform sampler2D u_emissiveTexture;\n" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,							"varying vec3 v_normal;\n" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,							"varying vec3 v_viewDirection;\n" },
+	{ GLTF_PBR_FLAG_TEXCOORD,						0,							"varying vec2 v_uv0;\n" },
+	{ GLTF_PBR_FLAG_VERTEX_COLOR,					0,							"varying vec4 v_color;\n" },
+	{ 0,											0,							"void main( void )\n" },
+	{ 0,											0,							"{\n" },
+	{ 0,											0,							"	vec4 baseColor = u_baseColorFactor;\n" },
+	{ GLTF_PBR_FLAG_BASE_COLOR_TEXTURE,				0,							"	baseColor *= texture2D( u_baseColorTexture, v_uv0 );\n" },
+	{ GLTF_PBR_FLAG_VERTEX_COLOR,					0,							"	baseColor *= v_color;\n" },
+	{ GLTF_PBR_FLAG_ALPHA_MASK,						0,							"	if ( baseColor.a < u_materialFactors.w ) { discard; }\n" },
+	{ 0,											GLTF_PBR_FLAG_ALPHA_BLEND,	"	baseColor.a = 1.0;\n" },
+	{ 0,											0,							"	float metallic = u_materialFactors.x;\n" },
+	{ 0,											0,							"	float roughness = u_materialFactors.y;\n" },
+	{ GLTF_PBR_FLAG_METALLIC_ROUGHNESS_TEXTURE,		0,							"	vec4 metallicRoughness = texture2D( u_metallicRoughnessTexture, v_uv0 );\n" },
+	{ GLTF_PBR_FLAG_METALLIC_ROUGHNESS_TEXTURE,		0,							"	metallic *= metallicRoughness.b;\n" },
+	{ GLTF_PBR_FLAG_METALLIC_ROUGHNESS_TEXTURE,		0,							"	roughness *= metallicRoughness.g;\n" },
+	{ 0,											0,							"	metallic = clamp( metallic, 0.0, 1.0 );\n" },
+	{ 0,											0,							"	roughness = clamp( roughness, 0.04, 1.0 );\n" },
+	{ 0,											0,							"	float occlusion = 1.0;\n" },
+	{ GLTF_PBR_FLAG_OCCLUSION_TEXTURE,				0,							"	occlusion += u_materialFactors.z * ( texture2D( u_occlusionTexture, v_uv0 ).r - 1.0 );\n" },
+	{ 0,											0,							"	vec3 emissive = u_emissiveFactor;\n" },
+	{ GLTF_PBR_FLAG_EMISSIVE_TEXTURE,				0,							"	emissive *= texture2D( u_emissiveTexture, v_uv0 ).rgb;\n" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,							"	vec3 N = normalize( v_normal );\n" },
+	{ GLTF_PBR_FLAG_NORMAL | GLTF_PBR_FLAG_DOUBLE_SIDED,	0,					"	N = gl_FrontFacing ? N : -N;\n" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,							"	vec3 V = normalize( v_viewDirection );\n" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,							"	vec3 L = normalize( vec3( 0.5, 1.0, 0.5 ) );\n" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,							"	vec3 H = normalize( L + V );\n" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,							"	float NdotL = clamp( dot( N, L ), 0.0, 1.0 );\n" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,							"	float NdotV = clamp( abs( dot( N, V ) ), 0.0001, 1.0 );\n" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,							"	float NdotH = clamp( dot( N, H ), 0.0, 1.0 );\n" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,							"	float VdotH = clamp( dot( V, H ), 0.0, 1.0 );\n" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,							"	float alpha = roughness * roughness;\n" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,							"	float alpha2 = alpha * alpha;\n" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,							"	float d = NdotH * NdotH * ( alpha2 - 1.0 ) + 1.0;\n" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,							"	float D = alpha2 / ( 3.14159265 * d * d );\n" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,							"	float k = 0.5 * alpha;\n" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,							"	float G = ( NdotL / ( NdotL * ( 1.0 - k ) + k ) ) * ( NdotV / ( NdotV * ( 1.0 - k ) + k ) );\n" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,							"	vec3 F0 = mix( vec3( 0.04 ), baseColor.rgb, metallic );\n" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,							"	vec3 F = F0 + ( vec3( 1.0 ) - F0 ) * pow( 1.0 - VdotH, 5.0 );\n" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,							"	vec3 diffuse = ( vec3( 1.0 ) - F ) * ( 1.0 - metallic ) * baseColor.rgb;\n" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,							"	vec3 specular = 3.14159265 * F * D * G / max( 4.0 * NdotL * NdotV, 0.0001 );\n" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,							"	vec3 color = NdotL * ( diffuse + specular ) + 0.2 * occlusion * baseColor.rgb;\n" },
+	{ 0,											GLTF_PBR_FLAG_NORMAL,		"	vec3 color = occlusion * baseColor.rgb;\n" },
+	{ 0,											0,							"	gl_FragColor = vec4( color + emissive, baseColor.a );\n" },
+	{ 0,											0,							"}\n" }
+};
+
+static const ksGltfPbrLine gltfPbrTechniqueParameters[] =
+{
+	{ 0,											0,	"\"modelMatrix\": { \"semantic\": \"MODEL\", \"type\": 35676 }" },
+	{ 0,											0,	"\"viewMatrix\": { \"semantic\": \"VIEW\", \"type\": 35676 }" },
+	{ 0,											0,	"\"projectionMatrix\": { \"semantic\": \"PROJECTION\", \"type\": 35676 }" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,	"\"viewInverseMatrix\": { \"semantic\": \"VIEWINVERSE\", \"type\": 35676 }" },
+	{ GLTF_PBR_FLAG_SKINNED,						0,	"\"jointMatrices\": { \"semantic\": \"JOINTMATRIX\", \"type\": 35676, \"count\": 256 }" },
+	{ 0,											0,	"\"baseColorFactor\": { \"type\": 35666 }" },
+	{ 0,											0,	"\"emissiveFactor\": { \"type\": 35665 }" },
+	{ 0,											0,	"\"materialFactors\": { \"type\": 35666 }" },
+	{ GLTF_PBR_FLAG_BASE_COLOR_TEXTURE,				0,	"\"baseColorTexture\": { \"type\": 35678 }" },
+	{ GLTF_PBR_FLAG_METALLIC_ROUGHNESS_TEXTURE,		0,	"\"metallicRoughnessTexture\": { \"type\": 35678 }" },
+	{ GLTF_PBR_FLAG_OCCLUSION_TEXTURE,				0,	"\"occlusionTexture\": { \"type\": 35678 }" },
+	{ GLTF_PBR_FLAG_EMISSIVE_TEXTURE,				0,	"\"emissiveTexture\": { \"type\": 35678 }" },
+	{ 0,											0,	"\"position\": { \"semantic\": \"POSITION\", \"type\": 35665 }" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,	"\"normal\": { \"semantic\": \"NORMAL\", \"type\": 35665 }" },
+	{ GLTF_PBR_FLAG_TEXCOORD,						0,	"\"uv0\": { \"semantic\": \"TEXCOORD_0\", \"type\": 35664 }" },
+	{ GLTF_PBR_FLAG_VERTEX_COLOR,					0,	"\"color\": { \"semantic\": \"COLOR\", \"type\": 35666 }" },
+	{ GLTF_PBR_FLAG_SKINNED,						0,	"\"joints\": { \"semantic\": \"JOINT\", \"type\": 35666 }" },
+	{ GLTF_PBR_FLAG_SKINNED,						0,	"\"weights\": { \"semantic\": \"WEIGHT\", \"type\": 35666 }" }
+};
+
+static const ksGltfPbrLine gltfPbrTechniqueAttributes[] =
+{
+	{ 0,								0,	"\"a_position\": \"position\"" },
+	{ GLTF_PBR_FLAG_NORMAL,				0,	"\"a_normal\": \"normal\"" },
+	{ GLTF_PBR_FLAG_TEXCOORD,			0,	"\"a_uv0\": \"uv0\"" },
+	{ GLTF_PBR_FLAG_VERTEX_COLOR,		0,	"\"a_color\": \"color\"" },
+	{ GLTF_PBR_FLAG_SKINNED,			0,	"\"a_joints\": \"joints\"" },
+	{ GLTF_PBR_FLAG_SKINNED,			0,	"\"a_weights\": \"weights\"" }
+};
+
+static const ksGltfPbrLine gltfPbrTechniqueUniforms[] =
+{
+	{ 0,											0,	"\"u_modelMatrix\": \"modelMatrix\"" },
+	{ 0,											0,	"\"u_viewMatrix\": \"viewMatrix\"" },
+	{ 0,											0,	"\"u_projectionMatrix\": \"projectionMatrix\"" },
+	{ GLTF_PBR_FLAG_NORMAL,							0,	"\"u_viewInverseMatrix\": \"viewInverseMatrix\"" },
+	{ GLTF_PBR_FLAG_SKINNED,						0,	"\"u_jointMatrices\": \"jointMatrices\"" },
+	{ 0,											0,	"\"u_baseColorFactor\": \"baseColorFactor\"" },
+	{ 0,											0,	"\"u_emissiveFactor\": \"emissiveFactor\"" },
+	{ 0,											0,	"\"u_materialFactors\": \"materialFactors\"" },
+	{ GLTF_PBR_FLAG_BASE_COLOR_TEXTURE,				0,	"\"u_baseColorTexture\": \"baseColorTexture\"" },
+	{ GLTF_PBR_FLAG_METALLIC_ROUGHNESS_TEXTURE,		0,	"\"u_metallicRoughnessTexture\": \"metallicRoughnessTexture\"" },
+	{ GLTF_PBR_FLAG_OCCLUSION_TEXTURE,				0,	"\"u_occlusionTexture\": \"occlusionTexture\"" },
+	{ GLTF_PBR_FLAG_EMISSIVE_TEXTURE,				0,	"\"u_emissiveTexture\": \"emissiveTexture\"" }
+};
+
+static const ksGltfPbrLine gltfPbrTechniqueStates[] =
+{
+	{ 0,								0,								"\"enable\": [ 2929" },		// GL_DEPTH_TEST
+	{ 0,								GLTF_PBR_FLAG_DOUBLE_SIDED,		", 2884" },					// GL_CULL_FACE
+	{ GLTF_PBR_FLAG_ALPHA_BLEND,		0,								", 3042" },					// GL_BLEND
+	{ 0,								0,								" ]" },
+	{ GLTF_PBR_FLAG_ALPHA_BLEND,		0,								", \"functions\": { \"depthMask\": [ false ] }" }
+};
+
+// Returns the size of the text with all lines separated by the separator, excluding the zero terminator.
+static size_t ksGltf_GetPbrLinesSize( const ksGltfPbrLine * lines, const int lineCount, const char * separator )
+{
+	size_t size = 0;
+	for ( int lineIndex = 0; lineIndex < lineCount; lineIndex++ )
+	{
+		size += strlen( separator ) + strlen( lines[lineIndex].line );
+	}
+	return size;
+}
+
+// Appends the lines that are selected by the flags, separated by the separator, and returns the new end of the text.
+static char * ksGltf_AppendPbrLines( char * out, const ksGltfPbrLine * lines, const int lineCount, const int flags, const char * separator )
+{
+	bool first = true;
+	for ( int lineIndex = 0; lineIndex < lineCount; lineIndex++ )
+	{
+		if ( ( flags & lines[lineIndex].required ) != lines[lineIndex].required || ( flags & lines[lineIndex].excluded ) != 0 )
+		{
+			continue;
+		}
+		out += sprintf( out, "%s%s", first ? "" : separator, lines[lineIndex].line );
+		first = false;
+	}
+	return out;
+}
+
+// Generates the vertex and fragment shader of the PBR program with the given flags.
+static void ksGltf_CreatePbrProgram( ksGltfProgram * program, const int flags )
+{
+	char name[32];
+	snprintf( name, sizeof( name ), "pbr_%x", flags );
+	program->name = ksGltf_strdup( name );
+
+	program->vertexSource = (unsigned char *) malloc( ksGltf_GetPbrLinesSize( gltfPbrVertexShader, ARRAY_SIZE( gltfPbrVertexShader ), "" ) + 1 );
+	program->vertexSourceSize = (size_t)( ksGltf_AppendPbrLines( (char *)program->vertexSource, gltfPbrVertexShader, ARRAY_SIZE( gltfPbrVertexShader ), flags, "" ) -
+											(char *)program->vertexSource );
+
+	program->fragmentSource = (unsigned char *) malloc( ksGltf_GetPbrLinesSize( gltfPbrFragmentShader, ARRAY_SIZE( gltfPbrFragmentShader ), "" ) + 1 );
+	program->fragmentSourceSize = (size_t)( ksGltf_AppendPbrLines( (char *)program->fragmentSource, gltfPbrFragmentShader, ARRAY_SIZE( gltfPbrFragmentShader ), flags, "" ) -
+											(char *)program->fragmentSource );
+}
+
+// Generates the JSON text of the techniques that use the PBR programs, in the same order as the programs.
+static char * ksGltf_CreatePbrTechniquesJson( const ksGltfScene * scene, const int * programFlags )
+{
+	const size_t maxTechniqueSize = 256 +
+									ksGltf_GetPbrLinesSize( gltfPbrTechniqueParameters, ARRAY_SIZE( gltfPbrTechniqueParameters ), ", " ) +
+									ksGltf_GetPbrLinesSize( gltfPbrTechniqueAttributes, ARRAY_SIZE( gltfPbrTechniqueAttributes ), ", " ) +
+									ksGltf_GetPbrLinesSize( gltfPbrTechniqueUniforms, ARRAY_SIZE( gltfPbrTechniqueUniforms ), ", " ) +
+									ksGltf_GetPbrLinesSize( gltfPbrTechniqueStates, ARRAY_SIZE( gltfPbrTechniqueStates ), "" );
+
+	char * json = (char *) malloc( 4 + scene->programCount * maxTechniqueSize );
+	char * out = json;
+	out += sprintf( out, "{" );
+	for ( int programIndex = 0; programIndex < scene->programCount; programIndex++ )
+	{
+		const int flags = programFlags[programIndex];
+		out += sprintf( out, "%s\"%s\": { \"parameters\": { ", ( programIndex > 0 ) ? "," : "", scene->programs[programIndex].name );
+		out = ksGltf_AppendPbrLines( out, gltfPbrTechniqueParameters, ARRAY_SIZE( gltfPbrTechniqueParameters ), flags, ", " );
+		out += sprintf( out, " }, \"attributes\": { " );
+		out = ksGltf_AppendPbrLines( out, gltfPbrTechniqueAttributes, ARRAY_SIZE( gltfPbrTechniqueAttributes ), flags, ", " );
+		out += sprintf( out, " }, \"uniforms\": { " );
+		out = ksGltf_AppendPbrLines( out, gltfPbrTechniqueUniforms, ARRAY_SIZE( gltfPbrTechniqueUniforms ), flags, ", " );
+		out += sprintf( out, " }, \"program\": \"%s\", \"states\": { ", scene->programs[programIndex].name );
+		out = ksGltf_AppendPbrLines( out, gltfPbrTechniqueStates, ARRAY_SIZE( gltfPbrTechniqueStates ), flags, "" );
+		out += sprintf( out, " } }" );
+	}
+	out += sprintf( out, "}" );
+	return json;
+}
+
+// Returns the PBR flags of a glTF 2.0 material. Textures are only used with texture coordinates.
+static int ksGltf_GetPbrMaterialFlags( const ksJson * material )
+{
+	const ksJson * pbrMetallicRoughness = ksJson_GetMemberByName( material, "pbrMetallicRoughness" );
+	const char * alphaMode = ksJson_GetString( ksJson_GetMemberByName( material, "alphaMode" ), "OPAQUE" );
+
+	int flags = 0;
+	flags |= ( ksJson_GetMemberByName( pbrMetallicRoughness, "baseColorTexture" ) != NULL ) ? GLTF_PBR_FLAG_BASE_COLOR_TEXTURE : 0;
+	flags |= ( ksJson_GetMemberByName( pbrMetallicRoughness, "metallicRoughnessTexture" ) != NULL ) ? GLTF_PBR_FLAG_METALLIC_ROUGHNESS_TEXTURE : 0;
+	flags |= ( ksJson_GetMemberByName( material, "occlusionTexture" ) != NULL ) ? GLTF_PBR_FLAG_OCCLUSION_TEXTURE : 0;
+	flags |= ( ksJson_GetMemberByName( material, "emissiveTexture" ) != NULL ) ? GLTF_PBR_FLAG_EMISSIVE_TEXTURE : 0;
+	flags |= ( strcmp( alphaMode, "MASK" ) == 0 ) ? GLTF_PBR_FLAG_ALPHA_MASK : 0;
+	flags |= ( strcmp( alphaMode, "BLEND" ) == 0 ) ? GLTF_PBR_FLAG_ALPHA_BLEND : 0;
+	flags |= ksJson_GetBool( ksJson_GetMemberByName( material, "doubleSided" ), false ) ? GLTF_PBR_FLAG_DOUBLE_SIDED : 0;
+	return flags;
+}
+
+// Sets a material value of the uniform with the given name, if the technique has such a uniform.
+static ksGltfUniformValue * ksGltf_AddMaterialValue( ksGltfMaterial * material, const char * uniformName )
+{
+	const ksGltfTechnique * technique = material->technique;
+	for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
+	{
+		if ( strcmp( technique->uniforms[uniformIndex].name, uniformName ) == 0 )
+		{
+			ksGltfMaterialValue * value = &material->values[material->valueCount++];
+			value->uniform = &technique->uniforms[uniformIndex];
+			return &value->value;
+		}
+	}
+	return NULL;
+}
+
+// Sets the texture of a glTF 2.0 texture info to the material value of the uniform with the given name.
+static void ksGltf_AddMaterialTexture( ksGltfScene * scene, ksGltfMaterial * material, const char * uniformName, const ksJson * textureInfo )
+{
+	if ( textureInfo == NULL )
+	{
+		return;
+	}
+	ksGltfUniformValue * value = ksGltf_AddMaterialValue( material, uniformName );
+	if ( value == NULL )
+	{
+		return;
+	}
+	const int textureIndex = ksGltf_ParseIndex( ksJson_GetMemberByName( textureInfo, "index" ), scene->textureCount );
+	if ( ksJson_GetInt32( ksJson_GetMemberByName( textureInfo, "texCoord" ), 0 ) != 0 )
+	{
+		Print( "Warning: %s of material %s uses a texture coordinate set other than TEXCOORD_0\n", uniformName, material->name );
+	}
+	value->texture = ( textureIndex >= 0 ) ? &scene->textures[textureIndex] : NULL;
+	assert( value->texture != NULL );
+}
+
+
+// Returns true if the data starts with a KTX 1.1 header.
+static bool ksGltf_IsKtxData( const unsigned char * data, const size_t dataSize )
+{
+	static const unsigned char fileIdentifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', '\x1A', '\n' };
+	return ( data != NULL && dataSize >= 64 && memcmp( data, fileIdentifier, sizeof( fileIdentifier ) ) == 0 );
+}
+
+// Loads the glTF 2.0 objects, which reference each other by index. A buffer without a uri uses the binary chunk
+// of a .glb file in place, and accessors, images, animations and skins point straight into the buffers.
+static void ksGltf_LoadVersion20( ksGpuContext * context, ksGltfScene * scene, ksSceneSettings * settings, ksGpuRenderPass * renderPass,
+									const ksJson * rootNode, unsigned char * binaryBuffer, const size_t binaryBufferLength, ksGltfLoadJobs * loadJobs )
+{
+#if GRAPHICS_API_D3D == 1 || GRAPHICS_API_METAL == 1
+	Error( "glTF 2.0 materials are only implemented with GLSL" );
+#endif
+
+	const ksJson * extensionsRequired = ksJson_GetMemberByName( rootNode, "extensionsRequired" );
+	for ( int extensionIndex = 0; extensionIndex < ksJson_GetMemberCount( extensionsRequired ); extensionIndex++ )
+	{
+		const char * extension = ksJson_GetString( ksJson_GetMemberByIndex( extensionsRequired, extensionIndex ), "" );
+		if ( strcmp( extension, "KHR_skin_culling" ) != 0 )
+		{
+			Error( "Required glTF extension %s is not supported", extension );
+		}
+	}
+
+	const ksJson * jsonBuffers = ksJson_GetMemberByName( rootNode, "buffers" );
+	const ksJson * jsonBufferViews = ksJson_GetMemberByName( rootNode, "bufferViews" );
+	const ksJson * jsonAccessors = ksJson_GetMemberByName( rootNode, "accessors" );
+	const ksJson * jsonSkins = ksJson_GetMemberByName( rootNode, "skins" );
+	const int jsonBufferCount = ksJson_GetMemberCount( jsonBuffers );
+	const int jsonBufferViewCount = ksJson_GetMemberCount( jsonBufferViews );
+
+	ksGltfBuffer * zeroBuffer = NULL;				// zeros for accessors without a buffer view
+	ksGltfBuffer * identityBuffer = NULL;			// identity matrices for skins without inverse bind matrices
+	const ksGltfBufferView * zeroBufferView = NULL;
+
+	//
+	// glTF buffers
+	//
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+
+		scene->bufferCount = jsonBufferCount;
+		scene->buffers = (ksGltfBuffer *) calloc( jsonBufferCount + 2, sizeof( ksGltfBuffer ) );
+		for ( int bufferIndex = 0; bufferIndex < jsonBufferCount; bufferIndex++ )
+		{
+			const ksJson * buffer = ksJson_GetMemberByIndex( jsonBuffers, bufferIndex );
+			const ksJson * uri = ksJson_GetMemberByName( buffer, "uri" );
+			scene->buffers[bufferIndex].name = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( buffer, "name" ), "" ) );
+			scene->buffers[bufferIndex].byteLength = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( buffer, "byteLength" ), 0 );
+			scene->buffers[bufferIndex].type = ksGltf_strdup( "" );
+			if ( uri == NULL )
+			{
+				// The binary chunk is used in place and freed together with the buffer.
+				if ( binaryBuffer == NULL || scene->buffers[bufferIndex].byteLength > binaryBufferLength )
+				{
+					Error( "glTF buffer %d has no uri and no binary chunk", bufferIndex );
+				}
+				scene->buffers[bufferIndex].bufferData = binaryBuffer;
+				binaryBuffer = NULL;
+			}
+			else
+			{
+				ksGltfLoadJob * job = ksGltf_AddLoadJob( loadJobs );
+				job->uri = ksJson_GetString( uri, "" );
+				job->data = &scene->buffers[bufferIndex].bufferData;
+			}
+		}
+		ksGltf_RunLoadJobs( loadJobs );
+		for ( int bufferIndex = 0; bufferIndex < jsonBufferCount; bufferIndex++ )
+		{
+			assert( scene->buffers[bufferIndex].byteLength != 0 );
+			assert( scene->buffers[bufferIndex].bufferData != NULL );
+		}
+
+		// A binary chunk that is not used by any buffer is no longer needed.
+		free( binaryBuffer );
+		binaryBuffer = NULL;
+		loadJobs->binaryBuffer = NULL;
+
+		size_t zeroBufferLength = 0;
+		for ( int accessorIndex = 0; accessorIndex < ksJson_GetMemberCount( jsonAccessors ); accessorIndex++ )
+		{
+			const ksJson * access = ksJson_GetMemberByIndex( jsonAccessors, accessorIndex );
+			if ( ksJson_GetMemberByName( access, "bufferView" ) == NULL )
+			{
+				const size_t byteLength = (size_t)ksJson_GetInt32( ksJson_GetMemberByName( access, "count" ), 0 ) *
+											ksGltf_GetAccessorComponentCount( ksJson_GetString( ksJson_GetMemberByName( access, "type" ), "" ) ) *
+											ksGltf_GetComponentSize( ksJson_GetUint16( ksJson_GetMemberByName( access, "componentType" ), 0 ) );
+				zeroBufferLength = MAX( zeroBufferLength, byteLength );
+			}
+		}
+		if ( zeroBufferLength > 0 )
+		{
+			zeroBuffer = &scene->buffers[scene->bufferCount++];
+			zeroBuffer->name = ksGltf_strdup( "" );
+			zeroBuffer->type = ksGltf_strdup( "" );
+			zeroBuffer->byteLength = zeroBufferLength;
+			zeroBuffer->bufferData = (unsigned char *) calloc( zeroBufferLength, 1 );
+		}
+
+		for ( int skinIndex = 0; skinIndex < ksJson_GetMemberCount( jsonSkins ) && identityBuffer == NULL; skinIndex++ )
+		{
+			if ( ksJson_GetMemberByName( ksJson_GetMemberByIndex( jsonSkins, skinIndex ), "inverseBindMatrices" ) == NULL )
+			{
+				identityBuffer = &scene->buffers[scene->bufferCount++];
+				identityBuffer->name = ksGltf_strdup( "" );
+				identityBuffer->type = ksGltf_strdup( "" );
+				identityBuffer->byteLength = GLTF_MAX_JOINTS * sizeof( ksMatrix4x4f );
+				identityBuffer->bufferData = (unsigned char *) malloc( identityBuffer->byteLength );
+				for ( int jointIndex = 0; jointIndex < GLTF_MAX_JOINTS; jointIndex++ )
+				{
+					ksMatrix4x4f_CreateIdentity( (ksMatrix4x4f *)identityBuffer->bufferData + jointIndex );
+				}
+			}
+		}
+
+		const ksNanoseconds endTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to load buffers\n", ( endTime - startTime ) * 1e-9f );
+	}
+
+	//
+	// glTF bufferViews
+	//
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+
+		scene->bufferViewCount = jsonBufferViewCount;
+		scene->bufferViews = (ksGltfBufferView *) calloc( jsonBufferViewCount + 1, sizeof( ksGltfBufferView ) );
+		for ( int bufferViewIndex = 0; bufferViewIndex < jsonBufferViewCount; bufferViewIndex++ )
+		{
+			const ksJson * view = ksJson_GetMemberByIndex( jsonBufferViews, bufferViewIndex );
+			const int bufferIndex = ksGltf_ParseIndex( ksJson_GetMemberByName( view, "buffer" ), jsonBufferCount );
+			scene->bufferViews[bufferViewIndex].name = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( view, "name" ), "" ) );
+			scene->bufferViews[bufferViewIndex].buffer = ( bufferIndex >= 0 ) ? &scene->buffers[bufferIndex] : NULL;
+			scene->bufferViews[bufferViewIndex].byteOffset = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( view, "byteOffset" ), 0 );
+			scene->bufferViews[bufferViewIndex].byteLength = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( view, "byteLength" ), 0 );
+			scene->bufferViews[bufferViewIndex].byteStride = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( view, "byteStride" ), 0 );
+			scene->bufferViews[bufferViewIndex].target = ksJson_GetUint16( ksJson_GetMemberByName( view, "target" ), 0 );
+			assert( scene->bufferViews[bufferViewIndex].buffer != NULL );
+			assert( scene->bufferViews[bufferViewIndex].byteLength != 0 );
+			assert( scene->bufferViews[bufferViewIndex].byteOffset +
+					scene->bufferViews[bufferViewIndex].byteLength <=
+					scene->bufferViews[bufferViewIndex].buffer->byteLength );
+		}
+		if ( zeroBuffer != NULL )
+		{
+			ksGltfBufferView * view = &scene->bufferViews[scene->bufferViewCount++];
+			view->name = ksGltf_strdup( "" );
+			view->buffer = zeroBuffer;
+			view->byteLength = zeroBuffer->byteLength;
+			zeroBufferView = view;
+		}
+
+		const ksNanoseconds endTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to load buffer views\n", ( endTime - startTime ) * 1e-9f );
+	}
+
+	//
+	// glTF accessors
+	//
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+
+		scene->accessorCount = ksJson_GetMemberCount( jsonAccessors );
+		scene->accessors = (ksGltfAccessor *) calloc( scene->accessorCount, sizeof( ksGltfAccessor ) );
+		for ( int accessorIndex = 0; accessorIndex < scene->accessorCount; accessorIndex++ )
+		{
+			const ksJson * access = ksJson_GetMemberByIndex( jsonAccessors, accessorIndex );
+			const int bufferViewIndex = ksGltf_ParseIndex( ksJson_GetMemberByName( access, "bufferView" ), jsonBufferViewCount );
+			ksGltfAccessor * accessor = &scene->accessors[accessorIndex];
+			accessor->name = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( access, "name" ), "" ) );
+			accessor->bufferView = ( bufferViewIndex >= 0 ) ? &scene->bufferViews[bufferViewIndex] : zeroBufferView;
+			accessor->byteOffset = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( access, "byteOffset" ), 0 );
+			accessor->byteStride = ( accessor->bufferView != NULL ) ? accessor->bufferView->byteStride : 0;
+			accessor->componentType = ksJson_GetUint16( ksJson_GetMemberByName( access, "componentType" ), 0 );
+			accessor->count = ksJson_GetInt32( ksJson_GetMemberByName( access, "count" ), 0 );
+			accessor->type = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( access, "type" ), "" ) );
+			accessor->normalized = ksJson_GetBool( ksJson_GetMemberByName( access, "normalized" ), false );
+			const ksJson * min = ksJson_GetMemberByName( access, "min" );
+			const ksJson * max = ksJson_GetMemberByName( access, "max" );
+			if ( min != NULL && max != NULL )
+			{
+				const int componentCount = ksGltf_GetAccessorComponentCount( accessor->type );
+
+				switch ( accessor->componentType )
+				{
+					case GL_BYTE:
+					case GL_UNSIGNED_BYTE:
+					case GL_SHORT:
+					case GL_UNSIGNED_SHORT:
+					case GL_UNSIGNED_INT:
+						ksGltf_ParseIntArray( accessor->intMin, componentCount, min );
+						ksGltf_ParseIntArray( accessor->intMax, componentCount, max );
+						break;
+					case GL_FLOAT:
+						ksGltf_ParseFloatArray( accessor->floatMin, componentCount, min );
+						ksGltf_ParseFloatArray( accessor->floatMax, componentCount, max );
+						break;
+				}
+			}
+			if ( ksJson_GetMemberByName( access, "sparse" ) != NULL )
+			{
+				Print( "Warning: sparse values of glTF accessor %d are ignored\n", accessorIndex );
+			}
+			assert( accessor->bufferView != NULL );
+			assert( accessor->componentType != 0 );
+			assert( accessor->count != 0 );
+			assert( accessor->type[0] != '\0' );
+			assert( accessor->byteOffset +
+					( accessor->count - 1 ) * ksGltf_GetAccessorStride( accessor ) +
+					ksGltf_GetAccessorComponentCount( accessor->type ) * ksGltf_GetComponentSize( accessor->componentType ) <=
+					accessor->bufferView->byteLength );
+		}
+
+		const ksNanoseconds endTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to load accessors\n", ( endTime - startTime ) * 1e-9f );
+	}
+
+	//
+	// glTF images
+	//
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+
+		const ksJson * images = ksJson_GetMemberByName( rootNode, "images" );
+		scene->imageCount = ksJson_GetMemberCount( images );
+		scene->images = (ksGltfImage *) calloc( scene->imageCount, sizeof( ksGltfImage ) );
+		for ( int imageIndex = 0; imageIndex < scene->imageCount; imageIndex++ )
+		{
+			const ksJson * image = ksJson_GetMemberByIndex( images, imageIndex );
+			const int bufferViewIndex = ksGltf_ParseIndex( ksJson_GetMemberByName( image, "bufferView" ), jsonBufferViewCount );
+			const char * mimeType = ksJson_GetString( ksJson_GetMemberByName( image, "mimeType" ), "" );
+			const char * uri = ksJson_GetString( ksJson_GetMemberByName( image, "uri" ), "" );
+
+			scene->images[imageIndex].name = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( image, "name" ), "" ) );
+			scene->images[imageIndex].bufferView = ( bufferViewIndex >= 0 ) ? &scene->bufferViews[bufferViewIndex] : NULL;
+			scene->images[imageIndex].versions = (ksGltfImageVersion *) calloc( 1, sizeof( ksGltfImageVersion ) );
+			scene->images[imageIndex].versionCount = 1;
+
+			assert( scene->images[imageIndex].bufferView != NULL || uri[0] != '\0' );
+
+			ksGltfImageVersion * version = &scene->images[imageIndex].versions[0];
+			if ( strcmp( mimeType, "image/ktx" ) == 0 )			{ version->container = ksGltf_strdup( "ktx" ); }
+			else if ( strcmp( mimeType, "image/png" ) == 0 )	{ version->container = ksGltf_strdup( "png" ); }
+			else if ( strcmp( mimeType, "image/jpeg" ) == 0 )	{ version->container = ksGltf_strdup( "jpg" ); }
+			else												{ version->container = ksGltf_strdup( ksGltf_GetImageContainerFromUri( uri ) ); }
+
+			if ( scene->images[imageIndex].bufferView != NULL )
+			{
+				const ksGltfBufferView * view = scene->images[imageIndex].bufferView;
+				const unsigned char * data = view->buffer->bufferData + view->byteOffset;
+				uint32_t glInternalFormat = GL_RGB8;
+				if ( ksGltf_IsKtxData( data, view->byteLength ) )
+				{
+					memcpy( &glInternalFormat, data + 28, sizeof( glInternalFormat ) );
+				}
+				version->glInternalFormat = (int)glInternalFormat;
+			}
+			else
+			{
+				version->glInternalFormat = ksGltf_GetImageInternalFormatFromUri( NULL, uri );
+			}
+			version->uri = ksGltf_strdup( uri );
+		}
+
+		const ksNanoseconds endTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to load images\n", ( endTime - startTime ) * 1e-9f );
+	}
+
+	//
+	// glTF samplers
+	//
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+
+		const ksJson * samplers = ksJson_GetMemberByName( rootNode, "samplers" );
+		scene->samplerCount = ksJson_GetMemberCount( samplers );
+		scene->samplers = (ksGltfSampler *) calloc( scene->samplerCount, sizeof( ksGltfSampler ) );
+		for ( int samplerIndex = 0; samplerIndex < scene->samplerCount; samplerIndex++ )
+		{
+			const ksJson * sampler = ksJson_GetMemberByIndex( samplers, samplerIndex );
+			scene->samplers[samplerIndex].name = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( sampler, "name" ), "" ) );
+			scene->samplers[samplerIndex].magFilter = ksJson_GetUint16( ksJson_GetMemberByName( sampler, "magFilter" ), GL_LINEAR );
+			scene->samplers[samplerIndex].minFilter = ksJson_GetUint16( ksJson_GetMemberByName( sampler, "minFilter" ), GL_NEAREST_MIPMAP_LINEAR );
+			scene->samplers[samplerIndex].wrapS = ksJson_GetUint16( ksJson_GetMemberByName( sampler, "wrapS" ), GL_REPEAT );
+			scene->samplers[samplerIndex].wrapT = ksJson_GetUint16( ksJson_GetMemberByName( sampler, "wrapT" ), GL_REPEAT );
+		}
+
+		const ksNanoseconds endTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to load samplers\n", ( endTime - startTime ) * 1e-9f );
+	}
+
+	//
+	// glTF textures
+	//
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+
+		const ksJson * textures = ksJson_GetMemberByName( rootNode, "textures" );
+		scene->textureCount = ksJson_GetMemberCount( textures );
+		scene->textures = (ksGltfTexture *) calloc( scene->textureCount, sizeof( ksGltfTexture ) );
+		unsigned char ** textureData = (unsigned char **) calloc( scene->textureCount, sizeof( unsigned char * ) );
+		size_t * textureDataSize = (size_t *) calloc( scene->textureCount, sizeof( size_t ) );
+		for ( int textureIndex = 0; textureIndex < scene->textureCount; textureIndex++ )
+		{
+			const ksJson * texture = ksJson_GetMemberByIndex( textures, textureIndex );
+			const int imageIndex = ksGltf_ParseIndex( ksJson_GetMemberByName( texture, "source" ), scene->imageCount );
+			const int samplerIndex = ksGltf_ParseIndex( ksJson_GetMemberByName( texture, "sampler" ), scene->samplerCount );
+			scene->textures[textureIndex].name = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( texture, "name" ), "" ) );
+			scene->textures[textureIndex].image = ( imageIndex >= 0 ) ? &scene->images[imageIndex] : NULL;
+			scene->textures[textureIndex].sampler = ( samplerIndex >= 0 ) ? &scene->samplers[samplerIndex] : NULL;
+
+			// Images in a buffer view are used in place, only images with a uri are read.
+			const ksGltfImage * image = scene->textures[textureIndex].image;
+			if ( image != NULL && image->bufferView == NULL )
+			{
+				ksGltfLoadJob * job = ksGltf_AddLoadJob( loadJobs );
+				job->uri = image->versions[0].uri;
+				job->data = &textureData[textureIndex];
+				job->dataSize = &textureDataSize[textureIndex];
+			}
+		}
+		ksGltf_RunLoadJobs( loadJobs );
+		for ( int textureIndex = 0; textureIndex < scene->textureCount; textureIndex++ )
+		{
+			const ksGltfImage * image = scene->textures[textureIndex].image;
+			const unsigned char * data = textureData[textureIndex];
+			size_t dataSize = textureDataSize[textureIndex];
+			if ( image != NULL && image->bufferView != NULL )
+			{
+				data = image->bufferView->buffer->bufferData + image->bufferView->byteOffset;
+				dataSize = image->bufferView->byteLength;
+			}
+
+			if ( ksGltf_IsKtxData( data, dataSize ) )
+			{
+				ksGpuTexture_CreateFromKTX( context, &scene->textures[textureIndex].texture, scene->textures[textureIndex].name, data, dataSize );
+			}
+			else
+			{
+				Print( "Warning: glTF texture %d is not a KTX image and is replaced with a checkerboard\n", textureIndex );
+				ksGpuTexture_CreateDefault( context, &scene->textures[textureIndex].texture, KS_GPU_TEXTURE_DEFAULT_CHECKERBOARD, 32, 32, 0, 0, 1, true, false );
+			}
+			free( textureData[textureIndex] );
+		}
+		free( textureData );
+		free( textureDataSize );
+
+		const ksNanoseconds endTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to load textures\n", ( endTime - startTime ) * 1e-9f );
+	}
+
+	//
+	// glTF materials and meshes
+	//
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+
+		const ksJson * materials = ksJson_GetMemberByName( rootNode, "materials" );
+		const ksJson * meshes = ksJson_GetMemberByName( rootNode, "meshes" );
+		const int jsonMaterialCount = ksJson_GetMemberCount( materials );
+		const int meshCount = ksJson_GetMemberCount( meshes );
+
+		int primitiveCount = 0;
+		for ( int meshIndex = 0; meshIndex < meshCount; meshIndex++ )
+		{
+			primitiveCount += ksJson_GetMemberCount( ksJson_GetMemberByName( ksJson_GetMemberByIndex( meshes, meshIndex ), "primitives" ) );
+		}
+
+		// Every combination of a material and the PBR flags of the primitives that use it becomes a material variant,
+		// and every distinct set of PBR flags becomes a program and technique. Variants of a material are linked per material.
+		int * primitiveVariant = (int *) malloc( ( primitiveCount + 1 ) * sizeof( int ) );
+		int * variantMaterial = (int *) malloc( ( primitiveCount + 1 ) * sizeof( int ) );
+		int * variantFlags = (int *) malloc( ( primitiveCount + 1 ) * sizeof( int ) );
+		int * variantProgram = (int *) malloc( ( primitiveCount + 1 ) * sizeof( int ) );
+		int * variantNext = (int *) malloc( ( primitiveCount + 1 ) * sizeof( int ) );
+		int * materialFirstVariant = (int *) malloc( ( jsonMaterialCount + 1 ) * sizeof( int ) );
+		int * programFlags = (int *) malloc( ( primitiveCount + 1 ) * sizeof( int ) );
+		int variantCount = 0;
+		int programCount = 0;
+
+		for ( int materialIndex = 0; materialIndex <= jsonMaterialCount; materialIndex++ )
+		{
+			materialFirstVariant[materialIndex] = -1;
+		}
+
+		for ( int meshIndex = 0, primitiveOffset = 0; meshIndex < meshCount; meshIndex++ )
+		{
+			const ksJson * primitives = ksJson_GetMemberByName( ksJson_GetMemberByIndex( meshes, meshIndex ), "primitives" );
+			for ( int primitiveIndex = 0; primitiveIndex < ksJson_GetMemberCount( primitives ); primitiveIndex++, primitiveOffset++ )
+			{
+				const ksJson * primitive = ksJson_GetMemberByIndex( primitives, primitiveIndex );
+				const ksJson * attributes = ksJson_GetMemberByName( primitive, "attributes" );
+				const int mode = ksJson_GetInt32( ksJson_GetMemberByName( primitive, "mode" ), GL_TRIANGLES );
+
+				primitiveVariant[primitiveOffset] = -1;
+				if ( mode != GL_TRIANGLES || ksJson_GetMemberByName( attributes, "POSITION" ) == NULL )
+				{
+					Print( "Warning: primitive %d of glTF mesh %d is not a triangle list with positions\n", primitiveIndex, meshIndex );
+					continue;
+				}
+				if ( ksJson_GetMemberByName( primitive, "targets" ) != NULL )
+				{
+					Print( "Warning: morph targets of primitive %d of glTF mesh %d are ignored\n", primitiveIndex, meshIndex );
+				}
+
+				const int materialIndex = ksGltf_ParseIndex( ksJson_GetMemberByName( primitive, "material" ), jsonMaterialCount );
+				int flags = ( materialIndex >= 0 ) ? ksGltf_GetPbrMaterialFlags( ksJson_GetMemberByIndex( materials, materialIndex ) ) : 0;
+				if ( ksJson_GetMemberByName( attributes, "TEXCOORD_0" ) == NULL )
+				{
+					flags &= ~GLTF_PBR_FLAG_TEXTURES;
+				}
+				flags |= ( ( flags & GLTF_PBR_FLAG_TEXTURES ) != 0 ) ? GLTF_PBR_FLAG_TEXCOORD : 0;
+				flags |= ( ksJson_GetMemberByName( attributes, "NORMAL" ) != NULL ) ? GLTF_PBR_FLAG_NORMAL : 0;
+				flags |= ( ksJson_GetMemberByName( attributes, "COLOR_0" ) != NULL ) ? GLTF_PBR_FLAG_VERTEX_COLOR : 0;
+				flags |= ( ksJson_GetMemberByName( attributes, "JOINTS_0" ) != NULL &&
+							ksJson_GetMemberByName( attributes, "WEIGHTS_0" ) != NULL ) ? GLTF_PBR_FLAG_SKINNED : 0;
+
+				const int slot = ( materialIndex >= 0 ) ? materialIndex : jsonMaterialCount;
+				int variantIndex = materialFirstVariant[slot];
+				while ( variantIndex >= 0 && variantFlags[variantIndex] != flags )
+				{
+					variantIndex = variantNext[variantIndex];
+				}
+				if ( variantIndex < 0 )
+				{
+					variantIndex = variantCount++;
+					variantMaterial[variantIndex] = materialIndex;
+					variantFlags[variantIndex] = flags;
+					variantNext[variantIndex] = materialFirstVariant[slot];
+					materialFirstVariant[slot] = variantIndex;
+
+					int programIndex = 0;
+					while ( programIndex < programCount && programFlags[programIndex] != flags )
+					{
+						programIndex++;
+					}
+					if ( programIndex == programCount )
+					{
+						programFlags[programCount++] = flags;
+					}
+					variantProgram[variantIndex] = programIndex;
+				}
+				primitiveVariant[primitiveOffset] = variantIndex;
+			}
+		}
+
+		//
+		// Generated programs and techniques
+		//
+
+		scene->programCount = programCount;
+		scene->programs = (ksGltfProgram *) calloc( scene->programCount, sizeof( ksGltfProgram ) );
+		for ( int programIndex = 0; programIndex < scene->programCount; programIndex++ )
+		{
+			ksGltf_CreatePbrProgram( &scene->programs[programIndex], programFlags[programIndex] );
+		}
+		ksGltf_CreateProgramNameHash( scene );
+
+		char * techniquesText = ksGltf_CreatePbrTechniquesJson( scene, programFlags );
+		ksJson * techniques = ksJson_Create();
+		const char * errorString = "";
+		if ( !ksJson_ReadFromBuffer( techniques, techniquesText, &errorString ) )
+		{
+			Error( "Failed to parse the glTF 2.0 techniques (%s)", errorString );
+		}
+		ksGltf_LoadTechniques( context, scene, settings, techniques, loadJobs );
+		ksJson_Destroy( techniques );
+		free( techniquesText );
+
+		assert( scene->techniqueCount == scene->programCount );
+
+		//
+		// Materials
+		//
+
+		scene->materialCount = variantCount;
+		scene->materials = (ksGltfMaterial *) calloc( scene->materialCount, sizeof( ksGltfMaterial ) );
+		for ( int materialIndex = 0; materialIndex < scene->materialCount; materialIndex++ )
+		{
+			const ksJson * material = ksJson_GetMemberByIndex( materials, variantMaterial[materialIndex] );
+			const ksJson * pbrMetallicRoughness = ksJson_GetMemberByName( material, "pbrMetallicRoughness" );
+			const ksJson * occlusionTexture = ksJson_GetMemberByName( material, "occlusionTexture" );
+
+			scene->materials[materialIndex].name = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( material, "name" ), "" ) );
+			scene->materials[materialIndex].technique = &scene->techniques[variantProgram[materialIndex]];
+			scene->materials[materialIndex].values = (ksGltfMaterialValue *) calloc( scene->materials[materialIndex].technique->uniformCount, sizeof( ksGltfMaterialValue ) );
+			scene->materials[materialIndex].valueCount = 0;
+
+			ksGltfUniformValue * baseColorFactor = ksGltf_AddMaterialValue( &scene->materials[materialIndex], "baseColorFactor" );
+			ksGltfUniformValue * emissiveFactor = ksGltf_AddMaterialValue( &scene->materials[materialIndex], "emissiveFactor" );
+			ksGltfUniformValue * materialFactors = ksGltf_AddMaterialValue( &scene->materials[materialIndex], "materialFactors" );
+			assert( baseColorFactor != NULL && emissiveFactor != NULL && materialFactors != NULL );
+
+			const ksJson * baseColor = ksJson_GetMemberByName( pbrMetallicRoughness, "baseColorFactor" );
+			if ( baseColor != NULL )
+			{
+				ksGltf_ParseFloatArray( baseColorFactor->floatValue, 4, baseColor );
+			}
+			else
+			{
+				baseColorFactor->floatValue[0] = 1.0f;
+				baseColorFactor->floatValue[1] = 1.0f;
+				baseColorFactor->floatValue[2] = 1.0f;
+				baseColorFactor->floatValue[3] = 1.0f;
+			}
+			ksGltf_ParseFloatArray( emissiveFactor->floatValue, 3, ksJson_GetMemberByName( material, "emissiveFactor" ) );
+			materialFactors->floatValue[0] = ksJson_GetFloat( ksJson_GetMemberByName( pbrMetallicRoughness, "metallicFactor" ), 1.0f );
+			materialFactors->floatValue[1] = ksJson_GetFloat( ksJson_GetMemberByName( pbrMetallicRoughness, "roughnessFactor" ), 1.0f );
+			materialFactors->floatValue[2] = ksJson_GetFloat( ksJson_GetMemberByName( occlusionTexture, "strength" ), 1.0f );
+			materialFactors->floatValue[3] = ksJson_GetFloat( ksJson_GetMemberByName( material, "alphaCutoff" ), 0.5f );
+
+			ksGltf_AddMaterialTexture( scene, &scene->materials[materialIndex], "baseColorTexture", ksJson_GetMemberByName( pbrMetallicRoughness, "baseColorTexture" ) );
+			ksGltf_AddMaterialTexture( scene, &scene->materials[materialIndex], "metallicRoughnessTexture", ksJson_GetMemberByName( pbrMetallicRoughness, "metallicRoughnessTexture" ) );
+			ksGltf_AddMaterialTexture( scene, &scene->materials[materialIndex], "occlusionTexture", occlusionTexture );
+			ksGltf_AddMaterialTexture( scene, &scene->materials[materialIndex], "emissiveTexture", ksJson_GetMemberByName( material, "emissiveTexture" ) );
+
+			if ( ksJson_GetMemberByName( material, "normalTexture" ) != NULL )
+			{
+				Print( "Warning: normal texture of glTF material %d is ignored\n", variantMaterial[materialIndex] );
+			}
+		}
+
+		//
+		// Meshes
+		//
+
+		scene->modelCount = meshCount;
+		scene->models = (ksGltfModel *) calloc( scene->modelCount, sizeof( ksGltfModel ) );
+		ksGltfGeometryAccessors ** accessors = (ksGltfGeometryAccessors **) calloc( scene->modelCount, sizeof( ksGltfGeometryAccessors * ) );
+		for ( int modelIndex = 0, primitiveOffset = 0; modelIndex < scene->modelCount; modelIndex++ )
+		{
+			const ksJson * model = ksJson_GetMemberByIndex( meshes, modelIndex );
+			const ksJson * primitives = ksJson_GetMemberByName( model, "primitives" );
+			const int surfaceCount = ksJson_GetMemberCount( primitives );
+
+			scene->models[modelIndex].name = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( model, "name" ), "" ) );
+			scene->models[modelIndex].surfaces = (ksGltfSurface *) calloc( surfaceCount, sizeof( ksGltfSurface ) );
+			scene->models[modelIndex].surfaceCount = 0;
+			accessors[modelIndex] = (ksGltfGeometryAccessors *) calloc( surfaceCount, sizeof( ksGltfGeometryAccessors ) );
+
+			ksVector3f_Set( &scene->models[modelIndex].mins, FLT_MAX );
+			ksVector3f_Set( &scene->models[modelIndex].maxs, -FLT_MAX );
+
+			for ( int primitiveIndex = 0; primitiveIndex < surfaceCount; primitiveIndex++, primitiveOffset++ )
+			{
+				const int variantIndex = primitiveVariant[primitiveOffset];
+				if ( variantIndex < 0 )
+				{
+					continue;
+				}
+
+				const int surfaceIndex = scene->models[modelIndex].surfaceCount;
+				const int flags = variantFlags[variantIndex];
+				const ksJson * primitive = ksJson_GetMemberByIndex( primitives, primitiveIndex );
+				const ksJson * attributes = ksJson_GetMemberByName( primitive, "attributes" );
+				const int positionIndex = ksGltf_ParseIndex( ksJson_GetMemberByName( attributes, "POSITION" ), scene->accessorCount );
+				const int normalIndex = ksGltf_ParseIndex( ksJson_GetMemberByName( attributes, "NORMAL" ), scene->accessorCount );
+				const int colorIndex = ksGltf_ParseIndex( ksJson_GetMemberByName( attributes, "COLOR_0" ), scene->accessorCount );
+				const int uv0Index = ksGltf_ParseIndex( ksJson_GetMemberByName( attributes, "TEXCOORD_0" ), scene->accessorCount );
+				const int jointIndicesIndex = ksGltf_ParseIndex( ksJson_GetMemberByName( attributes, "JOINTS_0" ), scene->accessorCount );
+				const int jointWeightsIndex = ksGltf_ParseIndex( ksJson_GetMemberByName( attributes, "WEIGHTS_0" ), scene->accessorCount );
+				const int indicesIndex = ksGltf_ParseIndex( ksJson_GetMemberByName( primitive, "indices" ), scene->accessorCount );
+
+				// Only the attributes that are used by the program of the material variant are passed on.
+				ksGltfGeometryAccessors * surfaceAccessors = &accessors[modelIndex][surfaceIndex];
+				memset( surfaceAccessors, 0, sizeof( ksGltfGeometryAccessors ) );
+				surfaceAccessors->position		= ( positionIndex >= 0 ) ? &scene->accessors[positionIndex] : NULL;
+				surfaceAccessors->normal		= ( ( flags & GLTF_PBR_FLAG_NORMAL ) != 0 && normalIndex >= 0 ) ? &scene->accessors[normalIndex] : NULL;
+				surfaceAccessors->color			= ( ( flags & GLTF_PBR_FLAG_VERTEX_COLOR ) != 0 && colorIndex >= 0 ) ? &scene->accessors[colorIndex] : NULL;
+				surfaceAccessors->uv0			= ( ( flags & GLTF_PBR_FLAG_TEXCOORD ) != 0 && uv0Index >= 0 ) ? &scene->accessors[uv0Index] : NULL;
+				surfaceAccessors->jointIndices	= ( ( flags & GLTF_PBR_FLAG_SKINNED ) != 0 && jointIndicesIndex >= 0 ) ? &scene->accessors[jointIndicesIndex] : NULL;
+				surfaceAccessors->jointWeights	= ( ( flags & GLTF_PBR_FLAG_SKINNED ) != 0 && jointWeightsIndex >= 0 ) ? &scene->accessors[jointWeightsIndex] : NULL;
+				surfaceAccessors->indices		= ( indicesIndex >= 0 ) ? &scene->accessors[indicesIndex] : NULL;
+
+				if ( surfaceAccessors->position == NULL || surfaceAccessors->position->componentType != GL_FLOAT ||
+						strcmp( surfaceAccessors->position->type, "VEC3" ) != 0 )
+				{
+					Print( "Warning: primitive %d of glTF mesh %d does not have float positions\n", primitiveIndex, modelIndex );
+					continue;
+				}
+
+				ksGltfSurface * surface = &scene->models[modelIndex].surfaces[surfaceIndex];
+				surface->material = &scene->materials[variantIndex];
+				surface->mins.x = surfaceAccessors->position->floatMin[0];
+				surface->mins.y = surfaceAccessors->position->floatMin[1];
+				surface->mins.z = surfaceAccessors->position->floatMin[2];
+				surface->maxs.x = surfaceAccessors->position->floatMax[0];
+				surface->maxs.y = surfaceAccessors->position->floatMax[1];
+				surface->maxs.z = surfaceAccessors->position->floatMax[2];
+
+				if ( !ksGltf_CreateSurface( context, scene, renderPass, accessors, modelIndex, surfaceIndex ) )
+				{
+					continue;
+				}
+				scene->models[modelIndex].surfaceCount++;
+
+				ksVector3f_Min( &scene->models[modelIndex].mins, &scene->models[modelIndex].mins, &surface->mins );
+				ksVector3f_Max( &scene->models[modelIndex].maxs, &scene->models[modelIndex].maxs, &surface->maxs );
+			}
+		}
+
+		for ( int modelIndex = 0; modelIndex < scene->modelCount; modelIndex++ )
+		{
+			free( accessors[modelIndex] );
+		}
+		free( accessors );
+
+		free( primitiveVariant );
+		free( variantMaterial );
+		free( variantFlags );
+		free( variantProgram );
+		free( variantNext );
+		free( materialFirstVariant );
+		free( programFlags );
+
+		const ksNanoseconds endTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to load materials and models\n", ( endTime - startTime ) * 1e-9f );
+	}
+
+	//
+	// glTF cameras
+	//
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+
+		const ksJson * cameras = ksJson_GetMemberByName( rootNode, "cameras" );
+		scene->cameraCount = ksJson_GetMemberCount( cameras );
+		scene->cameras = (ksGltfCamera *) calloc( scene->cameraCount, sizeof( ksGltfCamera ) );
+		for ( int cameraIndex = 0; cameraIndex < scene->cameraCount; cameraIndex++ )
+		{
+			const ksJson * camera = ksJson_GetMemberByIndex( cameras, cameraIndex );
+			scene->cameras[cameraIndex].name = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( camera, "name" ), "" ) );
+			ksGltf_ParseCamera( &scene->cameras[cameraIndex], camera );
+		}
+
+		const ksNanoseconds endTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to load cameras\n", ( endTime - startTime ) * 1e-9f );
+	}
+
+	//
+	// glTF skins
+	//
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+
+		scene->skinCount = ksJson_GetMemberCount( jsonSkins );
+		scene->skins = (ksGltfSkin *) calloc( scene->skinCount, sizeof( ksGltfSkin ) );
+		for ( int skinIndex = 0; skinIndex < scene->skinCount; skinIndex++ )
+		{
+			const ksJson * skin = ksJson_GetMemberByIndex( jsonSkins, skinIndex );
+			const ksJson * joints = ksJson_GetMemberByName( skin, "joints" );
+			scene->skins[skinIndex].name = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( skin, "name" ), "" ) );
+			scene->skins[skinIndex].parentNode = NULL;	// linked up once the nodes are loaded
+			scene->skins[skinIndex].jointCount = ksJson_GetMemberCount( joints );
+			scene->skins[skinIndex].joints = (ksGltfJoint *) calloc( scene->skins[skinIndex].jointCount, sizeof( ksGltfJoint ) );
+			assert( scene->skins[skinIndex].jointCount <= GLTF_MAX_JOINTS );
+
+			// There is no bind shape matrix in glTF 2.0 so the inverse bind matrices are used in place.
+			const int bindAccessorIndex = ksGltf_ParseIndex( ksJson_GetMemberByName( skin, "inverseBindMatrices" ), scene->accessorCount );
+			if ( bindAccessorIndex >= 0 )
+			{
+				const ksGltfAccessor * bindAccess = &scene->accessors[bindAccessorIndex];
+				assert( bindAccess->componentType == GL_FLOAT && strcmp( bindAccess->type, "MAT4" ) == 0 );
+				assert( ksGltf_GetAccessorStride( bindAccess ) == sizeof( ksMatrix4x4f ) );
+				assert( bindAccess->count >= scene->skins[skinIndex].jointCount );
+				scene->skins[skinIndex].inverseBindMatrices = (ksMatrix4x4f *) ksGltf_GetBufferData( bindAccess );
+			}
+			else
+			{
+				scene->skins[skinIndex].inverseBindMatrices = (ksMatrix4x4f *) identityBuffer->bufferData;
+			}
+
+			ksGpuBuffer_Create( context, &scene->skins[skinIndex].jointBuffer, KS_GPU_BUFFER_TYPE_UNIFORM, scene->skins[skinIndex].jointCount * sizeof( ksMatrix4x4f ), NULL, false );
+			scene->skins[skinIndex].jointBinding = &scene->skins[skinIndex].jointBuffer;
+
+			const ksJson * KHR_skin_culling = ksJson_GetMemberByName( ksJson_GetMemberByName( skin, "extensions" ), "KHR_skin_culling" );
+			if ( KHR_skin_culling != NULL )
+			{
+				const int minsAccessorIndex = ksGltf_ParseIndex( ksJson_GetMemberByName( KHR_skin_culling, "jointGeometryMins" ), scene->accessorCount );
+				const int maxsAccessorIndex = ksGltf_ParseIndex( ksJson_GetMemberByName( KHR_skin_culling, "jointGeometryMaxs" ), scene->accessorCount );
+				if ( minsAccessorIndex >= 0 && maxsAccessorIndex >= 0 )
+				{
+					scene->skins[skinIndex].jointGeometryMins = (ksVector3f *) ksGltf_GetBufferData( &scene->accessors[minsAccessorIndex] );
+					scene->skins[skinIndex].jointGeometryMaxs = (ksVector3f *) ksGltf_GetBufferData( &scene->accessors[maxsAccessorIndex] );
+				}
+			}
+		}
+
+		const ksNanoseconds endTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to load skins\n", ( endTime - startTime ) * 1e-9f );
+	}
+
+	//
+	// glTF nodes
+	//
+	const ksJson * nodes = ksJson_GetMemberByName( rootNode, "nodes" );
+	const int nodeCount = ksJson_GetMemberCount( nodes );
+	int * newNodeIndex = NULL;	// index of each glTF node after sorting the nodes
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+
+		int totalChildCount = 0;
+		for ( int nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++ )
+		{
+			totalChildCount += ksJson_GetMemberCount( ksJson_GetMemberByName( ksJson_GetMemberByIndex( nodes, nodeIndex ), "children" ) );
+		}
+
+		int * firstChild = (int *) malloc( ( nodeCount + 1 ) * sizeof( int ) );
+		int * childNodes = (int *) malloc( ( totalChildCount + 1 ) * sizeof( int ) );
+
+		scene->nodeCount = nodeCount;
+		scene->nodes = (ksGltfNode *) calloc( scene->nodeCount, sizeof( ksGltfNode ) );
+		for ( int nodeIndex = 0, childOffset = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
+		{
+			const ksJson * node = ksJson_GetMemberByIndex( nodes, nodeIndex );
+			scene->nodes[nodeIndex].name = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( node, "name" ), "" ) );
+			scene->nodes[nodeIndex].jointName = ksGltf_strdup( "" );	// joints reference nodes by index
+			scene->nodes[nodeIndex].rotation.w = 1.0f;
+			ksVector3f_Set( &scene->nodes[nodeIndex].scale, 1.0f );
+
+			const ksJson * matrix = ksJson_GetMemberByName( node, "matrix" );
+			const ksJson * rotation = ksJson_GetMemberByName( node, "rotation" );
+			const ksJson * scale = ksJson_GetMemberByName( node, "scale" );
+			const ksJson * translation = ksJson_GetMemberByName( node, "translation" );
+			if ( ksJson_IsArray( matrix ) )
+			{
+				ksMatrix4x4f localTransform;
+				ksGltf_ParseFloatArray( localTransform.m[0], 16, matrix );
+				ksMatrix4x4f_GetTranslation( &scene->nodes[nodeIndex].translation, &localTransform );
+				ksMatrix4x4f_GetRotation( &scene->nodes[nodeIndex].rotation, &localTransform );
+				ksMatrix4x4f_GetScale( &scene->nodes[nodeIndex].scale, &localTransform );
+			}
+			if ( rotation != NULL )
+			{
+				ksGltf_ParseFloatArray( &scene->nodes[nodeIndex].rotation.x, 4, rotation );
+			}
+			if ( scale != NULL )
+			{
+				ksGltf_ParseFloatArray( &scene->nodes[nodeIndex].scale.x, 3, scale );
+			}
+			if ( translation != NULL )
+			{
+				ksGltf_ParseFloatArray( &scene->nodes[nodeIndex].translation.x, 3, translation );
+			}
+
+			const int modelIndex = ksGltf_ParseIndex( ksJson_GetMemberByName( node, "mesh" ), scene->modelCount );
+			const int skinIndex = ksGltf_ParseIndex( ksJson_GetMemberByName( node, "skin" ), scene->skinCount );
+			const int cameraIndex = ksGltf_ParseIndex( ksJson_GetMemberByName( node, "camera" ), scene->cameraCount );
+			scene->nodes[nodeIndex].camera = ( cameraIndex >= 0 ) ? &scene->cameras[cameraIndex] : NULL;
+			scene->nodes[nodeIndex].skin = ( skinIndex >= 0 ) ? &scene->skins[skinIndex] : NULL;
+			scene->nodes[nodeIndex].modelCount = ( modelIndex >= 0 );
+			scene->nodes[nodeIndex].models = (ksGltfModel **) calloc( scene->nodes[nodeIndex].modelCount, sizeof( ksGltfModel * ) );
+			if ( modelIndex >= 0 )
+			{
+				scene->nodes[nodeIndex].models[0] = &scene->models[modelIndex];
+			}
+
+			const ksJson * children = ksJson_GetMemberByName( node, "children" );
+			scene->nodes[nodeIndex].childCount = ksJson_GetMemberCount( children );
+			firstChild[nodeIndex] = childOffset;
+			for ( int c = 0; c < scene->nodes[nodeIndex].childCount; c++ )
+			{
+				childNodes[childOffset] = ksGltf_ParseIndex( ksJson_GetMemberByIndex( children, c ), nodeCount );
+				assert( childNodes[childOffset] >= 0 );
+				childOffset++;
+			}
+			firstChild[nodeIndex + 1] = childOffset;
+		}
+		firstChild[nodeCount] = totalChildCount;
+
+		newNodeIndex = ksGltf_SortNodeGraph( scene->nodes, nodeCount, firstChild, childNodes );
+
+		// Get the node children and parents.
+		for ( int nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++ )
+		{
+			ksGltfNode * node = &scene->nodes[newNodeIndex[nodeIndex]];
+			node->children = (ksGltfNode **) calloc( node->childCount, sizeof( ksGltfNode * ) );
+			for ( int childIndex = 0; childIndex < node->childCount; childIndex++ )
+			{
+				node->children[childIndex] = &scene->nodes[newNodeIndex[childNodes[firstChild[nodeIndex] + childIndex]]];
+				node->children[childIndex]->parent = node;
+			}
+		}
+
+		free( firstChild );
+		free( childNodes );
+
+		// Get the skin joint nodes.
+		for ( int skinIndex = 0; skinIndex < scene->skinCount; skinIndex++ )
+		{
+			const ksJson * joints = ksJson_GetMemberByName( ksJson_GetMemberByIndex( jsonSkins, skinIndex ), "joints" );
+			for ( int jointIndex = 0; jointIndex < scene->skins[skinIndex].jointCount; jointIndex++ )
+			{
+				const int nodeIndex = ksGltf_ParseIndex( ksJson_GetMemberByIndex( joints, jointIndex ), nodeCount );
+				assert( nodeIndex >= 0 );
+				scene->skins[skinIndex].joints[jointIndex].node = &scene->nodes[newNodeIndex[nodeIndex]];
+				scene->skins[skinIndex].joints[jointIndex].name = ksGltf_strdup( scene->skins[skinIndex].joints[jointIndex].node->name );
+			}
+			scene->skins[skinIndex].parentNode = ksGltf_FindSkinParentNode( &scene->skins[skinIndex] );
+		}
+
+		const ksNanoseconds endTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to load nodes\n", ( endTime - startTime ) * 1e-9f );
+	}
+
+	//
+	// glTF animations
+	//
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+
+		// Each glTF 2.0 animation becomes one animation per distinct sampler input, because every animation here has a single time line.
+		const ksJson * animations = ksJson_GetMemberByName( rootNode, "animations" );
+		int maxAnimations = 0;
+		for ( int animationIndex = 0; animationIndex < ksJson_GetMemberCount( animations ); animationIndex++ )
+		{
+			maxAnimations += ksJson_GetMemberCount( ksJson_GetMemberByName( ksJson_GetMemberByIndex( animations, animationIndex ), "samplers" ) );
+		}
+		scene->animationCount = 0;
+		scene->animations = (ksGltfAnimation *) calloc( maxAnimations, sizeof( ksGltfAnimation ) );
+		scene->timeLineCount = 0;	// May not need all because they are often shared.
+		scene->timeLines = (ksGltfTimeLine *) calloc( maxAnimations, sizeof( ksGltfTimeLine ) );
+		for ( int jsonAnimationIndex = 0; jsonAnimationIndex < ksJson_GetMemberCount( animations ); jsonAnimationIndex++ )
+		{
+			const ksJson * jsonAnimation = ksJson_GetMemberByIndex( animations, jsonAnimationIndex );
+			const ksJson * samplers = ksJson_GetMemberByName( jsonAnimation, "samplers" );
+			const ksJson * channels = ksJson_GetMemberByName( jsonAnimation, "channels" );
+			const int samplerCount = ksJson_GetMemberCount( samplers );
+			const int channelCount = ksJson_GetMemberCount( channels );
+
+			for ( int samplerIndex = 0; samplerIndex < samplerCount; samplerIndex++ )
+			{
+				const int inputIndex = ksGltf_ParseIndex( ksJson_GetMemberByName( ksJson_GetMemberByIndex( samplers, samplerIndex ), "input" ), scene->accessorCount );
+				bool firstInput = ( inputIndex >= 0 );
+				for ( int otherIndex = 0; otherIndex < samplerIndex && firstInput; otherIndex++ )
+				{
+					firstInput = ( ksGltf_ParseIndex( ksJson_GetMemberByName( ksJson_GetMemberByIndex( samplers, otherIndex ), "input" ), scene->accessorCount ) != inputIndex );
+				}
+				if ( !firstInput )
+				{
+					continue;
+				}
+
+				const ksGltfAccessor * timeAccessor = &scene->accessors[inputIndex];
+				if ( timeAccessor->componentType != GL_FLOAT || strcmp( timeAccessor->type, "SCALAR" ) != 0 ||
+						ksGltf_GetAccessorStride( timeAccessor ) != sizeof( float ) || timeAccessor->count < 2 )
+				{
+					Print( "Warning: glTF animation %d has a time line that is not made up of at least 2 floats\n", jsonAnimationIndex );
+					continue;
+				}
+
+				ksGltfAnimation * animation = &scene->animations[scene->animationCount];
+				animation->channels = (ksGltfAnimationChannel *) calloc( channelCount, sizeof( ksGltfAnimationChannel ) );
+				animation->channelCount = 0;
+				for ( int channelIndex = 0; channelIndex < channelCount; channelIndex++ )
+				{
+					const ksJson * channel = ksJson_GetMemberByIndex( channels, channelIndex );
+					const ksJson * sampler = ksJson_GetMemberByIndex( samplers, ksGltf_ParseIndex( ksJson_GetMemberByName( channel, "sampler" ), samplerCount ) );
+					if ( sampler == NULL || ksGltf_ParseIndex( ksJson_GetMemberByName( sampler, "input" ), scene->accessorCount ) != inputIndex )
+					{
+						continue;
+					}
+
+					const ksJson * target = ksJson_GetMemberByName( channel, "target" );
+					const int nodeIndex = ksGltf_ParseIndex( ksJson_GetMemberByName( target, "node" ), nodeCount );
+					const char * pathName = ksJson_GetString( ksJson_GetMemberByName( target, "path" ), "" );
+					const char * interpolation = ksJson_GetString( ksJson_GetMemberByName( sampler, "interpolation" ), "LINEAR" );
+					const int outputIndex = ksGltf_ParseIndex( ksJson_GetMemberByName( sampler, "output" ), scene->accessorCount );
+					const ksGltfAccessor * output = ( outputIndex >= 0 ) ? &scene->accessors[outputIndex] : NULL;
+					const char * outputType = ( strcmp( pathName, "rotation" ) == 0 ) ? "VEC4" : "VEC3";
+
+					if ( nodeIndex < 0 || strcmp( pathName, "weights" ) == 0 || strcmp( interpolation, "CUBICSPLINE" ) == 0 )
+					{
+						Print( "Warning: channel %d of glTF animation %d is not a linear node transform and is ignored\n", channelIndex, jsonAnimationIndex );
+						continue;
+					}
+					if ( output == NULL || output->componentType != GL_FLOAT || strcmp( output->type, outputType ) != 0 ||
+							ksGltf_GetAccessorStride( output ) != ksGltf_GetAccessorComponentCount( outputType ) * sizeof( float ) ||
+								output->count < timeAccessor->count )
+					{
+						Print( "Warning: channel %d of glTF animation %d does not have tightly packed float key frames and is ignored\n", channelIndex, jsonAnimationIndex );
+						continue;
+					}
+					if ( strcmp( interpolation, "STEP" ) == 0 )
+					{
+						Print( "Warning: channel %d of glTF animation %d is interpolated linearly instead of with steps\n", channelIndex, jsonAnimationIndex );
+					}
+
+					ksGltfNode * node = &scene->nodes[newNodeIndex[nodeIndex]];
+					void * values = ksGltf_GetBufferData( output );
+
+					// Merge this channel with a previous channel for the same node.
+					ksGltfAnimationChannel * animationChannel = NULL;
+					for ( int k = 0; k < animation->channelCount; k++ )
+					{
+						if ( animation->channels[k].node == node )
+						{
+							animationChannel = &animation->channels[k];
+							break;
+						}
+					}
+					if ( animationChannel == NULL )
+					{
+						animationChannel = &animation->channels[animation->channelCount++];
+						animationChannel->nodeName = ksGltf_strdup( node->name );
+						animationChannel->node = node;
+					}
+
+					if ( strcmp( pathName, "translation" ) == 0 )		{ animationChannel->translation = (ksVector3f *) values; }
+					else if ( strcmp( pathName, "rotation" ) == 0 )		{ animationChannel->rotation = (ksQuatf *) values; }
+					else if ( strcmp( pathName, "scale" ) == 0 )		{ animationChannel->scale = (ksVector3f *) values; }
+				}
+
+				if ( animation->channelCount == 0 )
+				{
+					free( animation->channels );
+					animation->channels = NULL;
+					continue;
+				}
+
+				animation->name = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( jsonAnimation, "name" ), "" ) );
+				animation->timeLine = ksGltf_GetTimeLine( scene, (float *) ksGltf_GetBufferData( timeAccessor ), timeAccessor->count );
+				scene->animationCount++;
+			}
+		}
+
+		// Pack the animation channels per time line.
+		ksGltf_PackChannelBlocks( scene );
+
+		const ksNanoseconds endTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to load animations\n", ( endTime - startTime ) * 1e-9f );
+	}
+
+	//
+	// glTF sub-scenes
+	//
+	{
+		// The nodes are sorted such that parents come before their children.
+		int * nodeDepth = (int *) malloc( ( scene->nodeCount + 1 ) * sizeof( int ) );
+		for ( int nodeIndex = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
+		{
+			const ksGltfNode * parent = scene->nodes[nodeIndex].parent;
+			nodeDepth[nodeIndex] = ( parent != NULL ) ? nodeDepth[(int)( parent - scene->nodes )] + 1 : 0;
+		}
+
+		// Without any scenes all root nodes make up a single sub-scene.
+		const ksJson * subScenes = ksJson_GetMemberByName( rootNode, "scenes" );
+		int rootNodeCount = 0;
+		for ( int nodeIndex = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
+		{
+			rootNodeCount += ( scene->nodes[nodeIndex].parent == NULL );
+		}
+
+		scene->subTreeCount = 0;
+		scene->subTrees = (ksGltfSubTree *) calloc( scene->nodeCount, sizeof( ksGltfSubTree ) );
+		scene->subSceneCount = MAX( ksJson_GetMemberCount( subScenes ), 1 );
+		scene->subScenes = (ksGltfSubScene *) calloc( scene->subSceneCount, sizeof( ksGltfSubScene ) );
+		for ( int subSceneIndex = 0; subSceneIndex < scene->subSceneCount; subSceneIndex++ )
+		{
+			const ksJson * subScene = ksJson_GetMemberByIndex( subScenes, subSceneIndex );
+			const ksJson * subSceneNodes = ksJson_GetMemberByName( subScene, "nodes" );
+			scene->subScenes[subSceneIndex].name = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( subScene, "name" ), "" ) );
+			scene->subScenes[subSceneIndex].subTreeCount = ( subScene != NULL ) ? ksJson_GetMemberCount( subSceneNodes ) : rootNodeCount;
+			scene->subScenes[subSceneIndex].subTrees = (ksGltfSubTree **) calloc( scene->subScenes[subSceneIndex].subTreeCount, sizeof( ksGltfSubTree * ) );
+
+			for ( int subTreeIndex = 0, nextRootNode = 0; subTreeIndex < scene->subScenes[subSceneIndex].subTreeCount; subTreeIndex++ )
+			{
+				ksGltfNode * subTreeRootNode = NULL;
+				if ( subScene != NULL )
+				{
+					const int nodeIndex = ksGltf_ParseIndex( ksJson_GetMemberByIndex( subSceneNodes, subTreeIndex ), nodeCount );
+					assert( nodeIndex >= 0 );
+					subTreeRootNode = &scene->nodes[newNodeIndex[nodeIndex]];
+				}
+				else
+				{
+					while ( scene->nodes[nextRootNode].parent != NULL )
+					{
+						nextRootNode++;
+					}
+					subTreeRootNode = &scene->nodes[nextRootNode++];
+				}
+				assert( subTreeRootNode->parent == NULL );
+
+				scene->subScenes[subSceneIndex].subTrees[subTreeIndex] = NULL;
+				for ( int i = 0; i < scene->subTreeCount; i++ )
+				{
+					if ( scene->subTrees[i].nodes[0] == subTreeRootNode )
+					{
+						scene->subScenes[subSceneIndex].subTrees[subTreeIndex] = &scene->subTrees[i];
+						break;
+					}
+				}
+
+				if ( scene->subScenes[subSceneIndex].subTrees[subTreeIndex] == NULL )
+				{
+					ksGltfSubTree * subTree = &scene->subTrees[scene->subTreeCount++];
+					subTree->name = ksGltf_strdup( subTreeRootNode->name );
+
+					ksGltf_CreateSubTree( scene, subTree, subTreeRootNode, nodeDepth );
+
+					scene->subScenes[subSceneIndex].subTrees[subTreeIndex] = subTree;
+				}
+			}
+		}
+
+		free( nodeDepth );
+	}
+
+	free( newNodeIndex );
+
+	//
+	// glTF default scene
+	//
+
+	const int defaultSubScene = ksGltf_ParseIndex( ksJson_GetMemberByName( rootNode, "scene" ), scene->subSceneCount );
+	scene->state.currentSubScene = &scene->subScenes[( defaultSubScene >= 0 ) ? defaultSubScene : 0];
+
+	// Objects are referenced by index in glTF 2.0, so the names are only hashed for the scene interface.
+	ksGltf_CreateBufferNameHash( scene );
+	ksGltf_CreateBufferViewNameHash( scene );
+	ksGltf_CreateAccessorNameHash( scene );
+	ksGltf_CreateImageNameHash( scene );
+	ksGltf_CreateSamplerNameHash( scene );
+	ksGltf_CreateTextureNameHash( scene );
+	ksGltf_CreateMaterialNameHash( scene );
+	ksGltf_CreateModelNameHash( scene );
+	ksGltf_CreateSkinNameHash( scene );
+	ksGltf_CreateCameraNameHash( scene );
+	ksGltf_CreateNodeNameHash( scene );
+	ksGltf_CreateNodeJointNameHash( scene );
+	ksGltf_CreateAnimationNameHash( scene );
+	ksGltf_CreateSubTreeNameHash( scene );
+	ksGltf_CreateSubSceneNameHash( scene );
+}
+
+static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * scene, ksSceneSettings * settings, ksGpuRenderPass * renderPass )
+{
+	const ksNanoseconds t0 = GetTimeNanoseconds();
+
+	memset( scene, 0, sizeof( ksGltfScene ) );
+
+	scene->newSettings = settings;
+
+	ksJson * rootNode = ksJson_Create();
+
+	//
+	// Load either the glTF .json or .glb
+	//
+
+	unsigned char * binaryBuffer = NULL;
+	size_t binaryBufferLength = 0;
+
+	const char * fileName = settings->glTF;
+	const size_t fileNameLength = strlen( fileName );
+	if ( fileNameLength > 4 && strcasecmp( &fileName[fileNameLength - 4], ".glb" ) == 0 )
+	{
+		FILE * binaryFile = fopen( fileName, "rb" );
+		if ( binaryFile == NULL )
+		{
+			ksJson_Destroy( rootNode );
+			Error( "Failed to open %s", fileName );
+			return false;
+		}
+
+		ksGltfBinaryHeader header;
+		if ( fread( &header, 1, sizeof( header ), binaryFile ) != sizeof( header ) )
+		{
+			fclose( binaryFile );
+			ksJson_Destroy( rootNode );
+			Error( "Failed to read glTF binary header %s", fileName );
+			return false;
+		}
+
+		// A glTF 1.0 binary has a single binary body after the content, while the JSON chunk of
+		// a glTF 2.0 binary is followed by an optional chunk with the binary buffer.
+		const bool binaryVersion10 = ( header.version == GLTF_BINARY_VERSION && header.contentFormat == GLTF_BINARY_CONTENT_FORMAT );
+		const bool binaryVersion20 = ( header.version == GLTF_BINARY_VERSION_20 && header.contentFormat == GLTF_BINARY_CHUNK_TYPE_JSON );
+		if ( header.magic != GLTF_BINARY_MAGIC || ( !binaryVersion10 && !binaryVersion20 ) )
+		{
+			fclose( binaryFile );
+			ksJson_Destroy( rootNode );
+			Error( "Invalid glTF binary header %s", fileName );
+			return false;
+		}
+
+		char * content = (char *) malloc( header.contentLength + 1 );
+		if ( fread( content, 1, header.contentLength, binaryFile ) != header.contentLength )
+		{
+			free( content );
+			fclose( binaryFile );
+			ksJson_Destroy( rootNode );
+			Error( "Failed to read binary glTF content %s", fileName );
+			return false;
+		}
+		content[header.contentLength] = '\0';	// make sure the buffer is zero terminated
+
+		const char * errorString = "";
+		if ( !ksJson_ReadFromBuffer( rootNode, content, &errorString ) )
+		{
+			free( content );
+			fclose( binaryFile );
+			ksJson_Destroy( rootNode );
+			Error( "Failed to load %s (%s)", fileName, errorString );
+			return false;
+		}
+
+		free( content );
+
+		assert( ( ( sizeof( header ) + header.contentLength ) & 3 ) == 0 );
+
+		if ( binaryVersion20 )
+		{
+			ksGltfBinaryChunkHeader chunkHeader;
+			if ( sizeof( header ) + header.contentLength + sizeof( chunkHeader ) <= header.length &&
+					fread( &chunkHeader, 1, sizeof( chunkHeader ), binaryFile ) == sizeof( chunkHeader ) &&
+						chunkHeader.type == GLTF_BINARY_CHUNK_TYPE_BIN )
+			{
+				binaryBufferLength = chunkHeader.length;
+			}
+		}
+		else
+		{
+			binaryBufferLength = header.length - header.contentLength - sizeof( header );
+		}
+
+		binaryBuffer = ( binaryBufferLength > 0 ) ? (unsigned char *) malloc( binaryBufferLength ) : NULL;
+		if ( fread( binaryBuffer, 1, binaryBufferLength, binaryFile ) != binaryBufferLength )
+		{
+			free( binaryBuffer );
+			fclose( binaryFile );
+			ksJson_Destroy( rootNode );
+			Error( "Failed to read binary glTF content %s", fileName );
+			return false;
+		}
+
+		fclose( binaryFile );
+	}
+	else
+	{
+		const char * errorString = "";
+		if ( !ksJson_ReadFromFile( rootNode, fileName, &errorString ) )
+		{
+			ksJson_Destroy( rootNode );
+			Error( "Failed to load %s (%s)", fileName, errorString );
+			return false;
+		}
+	}
+
+	//
+	// Check the glTF JSON version.
+	//
+
+	const ksJson * asset = ksJson_GetMemberByName( rootNode, "asset" );
+	const char * version = ksJson_GetString( ksJson_GetMemberByName( asset, "version" ), "1.0" );
+	const bool version20 = ( strcmp( version, GLTF_JSON_VERSION_20 ) == 0 );
+	if ( !version20 && strcmp( version, GLTF_JSON_VERSION_10 ) != 0 && strcmp( version, GLTF_JSON_VERSION_101 ) != 0 )
+	{
+		Error( "glTF version is %s instead of %s or %s", version, GLTF_JSON_VERSION_10, GLTF_JSON_VERSION_20 );
+		free( binaryBuffer );
+		ksJson_Destroy( rootNode );
+		return false;
+	}
+
+	// The CPU side work of reading and decoding files and converting shaders is spread over worker threads,
+	// while all GPU objects are created on this thread.
+	ksThreadPool_Create( &scene->threadPool, GLTF_WORKERS );
+
+	ksGltfLoadJobs loadJobs;
+	memset( &loadJobs, 0, sizeof( loadJobs ) );
+	loadJobs.threadPool = &scene->threadPool;
+	loadJobs.binaryBuffer = binaryBuffer;
+
+	if ( version20 )
+	{
+		ksGltf_LoadVersion20( context, scene, settings, renderPass, rootNode, binaryBuffer, binaryBufferLength, &loadJobs );
+	}
+	else
+	{
+		ksGltf_LoadVersion10( context, scene, settings, renderPass, rootNode, binaryBuffer, binaryBufferLength, &loadJobs );
+	}
+
+	ksJson_Destroy( rootNode );
+
+	// Allocate run-time state memory.
+	scene->state.timeLineFrameState = (ksGltfTimeLineFrameState *) calloc( scene->timeLineCount, sizeof( ksGltfTimeLineFrameState ) );
+	scene->state.skinCullingState = (ksGltfSkinCullingState *) calloc( scene->skinCount, sizeof( ksGltfSkinCullingState ) );
+	for ( int skinIndex = 0; skinIndex < scene->skinCount; skinIndex++ )
+	{
+		ksGltfSkinCullingState * skinCullingState = &scene->state.skinCullingState[skinIndex];
+		ksVector3f_Set( &skinCullingState->mins, FLT_MAX );
+		ksVector3f_Set( &skinCullingState->maxs, -FLT_MAX );
+		skinCullingState->culled = false;
+	}
+	scene->state.nodeState = (ksGltfNodeState *) calloc( scene->nodeCount, sizeof( ksGltfNodeState ) );
+	for ( int nodeIndex = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
+	{
+		const ksGltfNode * node = &scene->nodes[nodeIndex];
+		ksGltfNodeState * nodeState = &scene->state.nodeState[nodeIndex];
+		nodeState->parent = ( node->parent != NULL ) ? &scene->state.nodeState[(int)( node->parent - scene->nodes )] : NULL;
+		nodeState->translation = node->translation;
+		nodeState->rotation = node->rotation;
+		nodeState->scale = node->scale;
+		ksMatrix4x4f_CreateIdentity( &nodeState->localTransform );
+		ksMatrix4x4f_CreateIdentity( &nodeState->globalTransform );
+		ksVector3f_Set( &nodeState->geometryMins, FLT_MAX );
+		ksVector3f_Set( &nodeState->geometryMaxs, -FLT_MAX );
+		ksVector3f_Set( &nodeState->subTreeMins, FLT_MAX );
+		ksVector3f_Set( &nodeState->subTreeMaxs, -FLT_MAX );
+		nodeState->localDirty = true;
+		nodeState->globalDirty = true;
+		nodeState->boundsDirty = true;
+		nodeState->culled = false;
+	}
+	scene->state.subTreeState = (ksGltfSubTreeState *) calloc( scene->subTreeCount, sizeof( ksGltfSubTreeState ) );
+	for ( int subTreeIndex = 0; subTreeIndex < scene->subTreeCount; subTreeIndex++ )
+	{
+		scene->state.subTreeState[subTreeIndex].visible = true;
+	}
+
+	// Large scenes use worker threads. The nodes are only simulated on worker threads if every node is part of at most
+	// one sub-tree and is targeted by at most one animation channel, so that no two workers ever write the same node.
+	{
+		int totalChannelCount = 0;
+		for ( int animationIndex = 0; animationIndex < scene->animationCount; animationIndex++ )
+		{
+			totalChannelCount += scene->animations[animationIndex].channelCount;
+		}
+
+		bool overlap = false;
+		bool * nodeUsed = (bool *) calloc( scene->nodeCount, sizeof( bool ) );
+		for ( int subTreeIndex = 0; subTreeIndex < scene->subTreeCount && !overlap; subTreeIndex++ )
+		{
+			const ksGltfSubTree * subTree = &scene->subTrees[subTreeIndex];
+			for ( int nodeIndex = 0; nodeIndex < subTree->nodeCount && !overlap; nodeIndex++ )
+			{
+				bool * used = &nodeUsed[(int)( subTree->nodes[nodeIndex] - scene->nodes )];
+				overlap = *used;
+				*used = true;
+			}
+		}
+		memset( nodeUsed, 0, scene->nodeCount * sizeof( bool ) );
+		for ( int animationIndex = 0; animationIndex < scene->animationCount && !overlap; animationIndex++ )
+		{
+			const ksGltfAnimation * animation = &scene->animations[animationIndex];
+			for ( int channelIndex = 0; channelIndex < animation->channelCount && !overlap; channelIndex++ )
+			{
+				bool * used = &nodeUsed[(int)( animation->channels[channelIndex].node - scene->nodes )];
+				overlap = *used;
+				*used = true;
+			}
+		}
+		free( nodeUsed );
+
+		scene->useThreadPool = ( scene->nodeCount > GLTF_THREAD_MIN_NODES );
+		scene->simulateParallel = ( scene->useThreadPool && !overlap );
+
+		int maxJobs = ( scene->nodeCount > GLTF_CHANNEL_MAX * totalChannelCount ) ? scene->nodeCount : GLTF_CHANNEL_MAX * totalChannelCount;
+		maxJobs = ( maxJobs > scene->timeLineCount ) ? maxJobs : scene->timeLineCount;
+		maxJobs = ( maxJobs > scene->skinCount ) ? maxJobs : scene->skinCount;
+
+		ksGltfJobs * jobs = &scene->jobs;
+		jobs->scene = scene;
+		jobs->jobs = (ksGltfJob *) malloc( ( maxJobs + 1 ) * sizeof( ksGltfJob ) );
+		jobs->jobCount = 0;
+		jobs->timeLines = (ksGltfTimeLine **) malloc( ( scene->timeLineCount + 1 ) * sizeof( ksGltfTimeLine * ) );
+		jobs->timeLineUsed = (bool *) malloc( ( scene->timeLineCount + 1 ) * sizeof( bool ) );
+		jobs->subTrees = (ksGltfSubTree **) malloc( ( scene->subTreeCount + 1 ) * sizeof( ksGltfSubTree * ) );
+		jobs->skins = (ksGltfSkin **) malloc( ( scene->skinCount + 1 ) * sizeof( ksGltfSkin * ) );
+		jobs->skinJoints = (ksMatrix4x4f **) malloc( ( scene->skinCount + 1 ) * sizeof( ksMatrix4x4f * ) );
+		jobs->mappedJointBuffers = (ksGpuBuffer **) malloc( ( scene->skinCount + 1 ) * sizeof( ksGpuBuffer * ) );
+		jobs->skinUsed = (bool *) malloc( ( scene->skinCount + 1 ) * sizeof( bool ) );
+
+		// The thread pool was created for loading and is only kept for large scenes.
+		if ( !scene->useThreadPool )
+		{
+			ksThreadPool_Destroy( &scene->threadPool );
+		}
+		free( loadJobs.jobs );
+	}
+
+	// Allocate the draw list for the worst case where all surfaces are visible.
+	{
+		int maxTransforms = 0;
+		int maxSurfaces = 0;
+		for ( int nodeIndex = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
+		{
+			const ksGltfNode * node = &scene->nodes[nodeIndex];
+			maxTransforms += ( node->modelCount > 0 );
+			for ( int modelIndex = 0; modelIndex < node->modelCount; modelIndex++ )
+			{
+				maxSurfaces += node->models[modelIndex]->surfaceCount;
+			}
+		}
+
+		ksGltfDrawList * drawList = &scene->drawList;
+		drawList->transforms = (ksGltfDrawTransform *) malloc( ( maxTransforms + 1 ) * sizeof( ksGltfDrawTransform ) );
+		drawList->surfaces = (ksGltfDrawSurface *) malloc( ( maxSurfaces + 1 ) * sizeof( ksGltfDrawSurface ) );
+		drawList->keys = (uint64_t *) malloc( ( maxSurfaces + 1 ) * sizeof( uint64_t ) );
+		drawList->order = (int *) malloc( ( maxSurfaces + 1 ) * sizeof( int ) );
+		drawList->sortKeys = (uint64_t *) malloc( ( maxSurfaces + 1 ) * sizeof( uint64_t ) );
+		drawList->sortOrder = (int *) malloc( ( maxSurfaces + 1 ) * sizeof( int ) );
+		drawList->batches = (ksGltfDrawBatch *) malloc( ( maxSurfaces + 1 ) * sizeof( ksGltfDrawBatch ) );
+		drawList->indirectBuffer = NULL;
+		drawList->viewProjectionBuffer = &scene->viewProjectionBuffer;
+		drawList->transformCount = 0;
+		drawList->surfaceCount = 0;
+		drawList->batchCount = 0;
+
+		int pipelineRankCount = 0;
+		for ( int techniqueIndex = 0; techniqueIndex < scene->techniqueCount; techniqueIndex++ )
+		{
+			if ( scene->techniques[techniqueIndex].pipelineRank >= pipelineRankCount )
+			{
+				pipelineRankCount = scene->techniques[techniqueIndex].pipelineRank + 1;
+			}
+		}
+		// There can be no more batches than surfaces, so a batch can always find its indirect draw command.
+		ksGpuLimits limits;
+		ksGpuContext_GetLimits( context, &limits );
+		scene->drawIndirect = limits.drawIndirect;
+		if ( scene->drawIndirect )
+		{
+			ksGpuBuffer_Create( context, &scene->indirectBuffer, KS_GPU_BUFFER_TYPE_INDIRECT, ( maxSurfaces + 1 ) * sizeof( ksGpuDrawIndirectCommand ), NULL, false );
+		}
+
+		drawList->sortOnState = ( pipelineRankCount <= GLTF_DRAW_KEY_MAX_PIPELINE_RANKS &&
+									scene->materialCount <= GLTF_DRAW_KEY_MAX_MATERIALS &&
+									scene->modelCount <= GLTF_DRAW_KEY_MAX_MODELS );
+		if ( !drawList->sortOnState )
+		{
+			Print( "%d pipelines, %d materials and %d models do not fit in the draw sort key, drawing opaque surfaces in hierarchy order\n",
+					pipelineRankCount, scene->materialCount, scene->modelCount );
+		}
+	}
+
+	// Add a per-instance model matrix to the surfaces of models that are referenced by multiple nodes.
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+
+		int * modelReferences = (int *) calloc( scene->modelCount + 1, sizeof( int ) );
+		for ( int nodeIndex = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
+		{
+			const ksGltfNode * node = &scene->nodes[nodeIndex];
+			for ( int modelIndex = 0; modelIndex < node->modelCount; modelIndex++ )
+			{
+				modelReferences[(int)( node->models[modelIndex] - scene->models )]++;
+			}
+		}
+
+		int instancedSurfaceCount = 0;
+		for ( int modelIndex = 0; modelIndex < scene->modelCount; modelIndex++ )
+		{
+			if ( modelReferences[modelIndex] <= 1 )
+			{
+				continue;
+			}
+			for ( int surfaceIndex = 0; surfaceIndex < scene->models[modelIndex].surfaceCount; surfaceIndex++ )
+			{
+				ksGltfSurface * surface = &scene->models[modelIndex].surfaces[surfaceIndex];
+				const ksGltfTechnique * technique = surface->material->technique;
+				if ( !technique->instanced || technique->rop.blendEnable )
+				{
+					continue;
+				}
+
+				ksGpuGeometry_AddInstanceAttributes( context, &surface->geometry, modelReferences[modelIndex], ksGltf_GetInstanceAttribsFlags( technique ) );
+
+				ksGpuGraphicsPipelineParms pipelineParms;
+				ksGpuGraphicsPipelineParms_Init( &pipelineParms );
+
+				pipelineParms.renderPass = renderPass;
+				pipelineParms.program = &technique->instancedProgram;
+				pipelineParms.geometry = &surface->geometry;
+				pipelineParms.rop = technique->rop;
+
+				ksGpuGraphicsPipeline_Create( context, &surface->instancedPipeline, &pipelineParms );
+
+				instancedSurfaceCount++;
+			}
+		}
+		free( modelReferences );
+
+		const ksNanoseconds endTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to create %d instanced surfaces\n", ( endTime - startTime ) * 1e-9f, instancedSurfaceCount );
+	}
+
+	// Create view projection uniform buffer. With multi-view it stores the matrices of both eyes.
+	{
+		ksGpuBuffer_Create( context, &scene->viewProjectionBuffer, KS_GPU_BUFFER_TYPE_UNIFORM, 4 * NUM_EYES * sizeof( ksMatrix4x4f ), NULL, false );
+	}
+
+	// Compile the uniforms of the materials.
+	{
+		for ( int materialIndex = 0; materialIndex < scene->materialCount; materialIndex++ )
+		{
+			ksGltf_CompileUniformOps( scene, &scene->materials[materialIndex] );
+		}
+	}
+
+	// Create a default joint uniform buffer.
+	{
+		ksMatrix4x4f * data = malloc( GLTF_MAX_JOINTS * sizeof( ksMatrix4x4f ) );
+		for ( int jointIndex = 0; jointIndex < GLTF_MAX_JOINTS; jointIndex++ )
+		{
+			ksMatrix4x4f_CreateIdentity( &data[jointIndex] );
+		}
+		ksGpuBuffer_Create( context, &scene->defaultJointBuffer, KS_GPU_BUFFER_TYPE_UNIFORM, GLTF_MAX_JOINTS * sizeof( ksMatrix4x4f ), data, false );
+		free( data );
+	}
+
+	// Create unit cube.
+	{
+		ksGpuGeometry_CreateCube( context, &scene->unitCubeGeometry, 0.0f, 1.0f );
+		ksGpuGraphicsProgram_Create( context, &scene->unitCubeFlatShadeProgram,
+									PROGRAM( unitCubeFlatShadeVertexProgram ), sizeof( PROGRAM( unitCubeFlatShadeVertexProgram ) ),
+									PROGRAM( unitCubeFlatShadeFragmentProgram ), sizeof( PROGRAM( unitCubeFlatShadeFragmentProgram ) ),
+									unitCubeFlatShadeProgramParms, ARRAY_SIZE( unitCubeFlatShadeProgramParms ),
+									scene->unitCubeGeometry.layout, VERTEX_ATTRIBUTE_FLAG_POSITION | VERTEX_ATTRIBUTE_FLAG_NORMAL );
+
+		ksGpuGraphicsPipelineParms pipelineParms;
+		ksGpuGraphicsPipelineParms_Init( &pipelineParms );
+
+		pipelineParms.renderPass = renderPass;
+		pipelineParms.program = &scene->unitCubeFlatShadeProgram;
+		pipelineParms.geometry = &scene->unitCubeGeometry;
+
+		ksGpuGraphicsPipeline_Create( context, &scene->unitCubePipeline, &pipelineParms );
+	}
+
+	const ksNanoseconds t1 = GetTimeNanoseconds();
+
+	Print( "%1.3f seconds to load %s\n", ( t1 - t0 ) * 1e-9f, fileName );
+
+	return true;
+}
+
+static void ksGltfScene_Destroy( ksGpuContext * context, ksGltfScene * scene )
+{
+	ksGpuContext_WaitIdle( context );
+
+	{
+		free( scene->state.timeLineFrameState );
+		free( scene->state.skinCullingState );
+		free( scene->state.nodeState );
+		free( scene->state.subTreeState );
+	}
+	{
+		if ( scene->useThreadPool )
+		{
+			ksThreadPool_Destroy( &scene->threadPool );
+		}
+		free( scene->jobs.jobs );
+		free( scene->jobs.timeLines );
+		free( scene->jobs.timeLineUsed );
+		free( scene->jobs.subTrees );
+		free( scene->jobs.skins );
+		free( scene->jobs.skinJoints );
+		free( scene->jobs.mappedJointBuffers );
+		free( scene->jobs.skinUsed );
+	}
+	{
+		free( scene->drawList.transforms );
+		free( scene->drawList.surfaces );
+		free( scene->drawList.keys );
+		free( scene->drawList.order );
+		free( scene->drawList.sortKeys );
+		free( scene->drawList.sortOrder );
+		free( scene->drawList.batches );
+	}
+	{
+		for ( int bufferIndex = 0; bufferIndex < scene->bufferCount; bufferIndex++ )
+		{
+			free( scene->buffers[bufferIndex].name );
+			free( scene->buffers[bufferIndex].type );
+			free( scene->buffers[bufferIndex].bufferData );
+		}
+		free( scene->buffers );
+		ksGltfNameHash_Destroy( &scene->bufferNameHash );
+	}
+	{
+		for ( int bufferViewIndex = 0; bufferViewIndex < scene->bufferViewCount; bufferViewIndex++ )
+		{
+			free( scene->bufferViews[bufferViewIndex].name );
+		}
+		free( scene->bufferViews );
+		ksGltfNameHash_Destroy( &scene->bufferViewNameHash );
+	}
+	{
+		for ( int accessorIndex = 0; accessorIndex < scene->accessorCount; accessorIndex++ )
+		{
+			free( scene->accessors[accessorIndex].name );
+			free( scene->accessors[accessorIndex].type );
+		}
+		free( scene->accessors );
+		ksGltfNameHash_Destroy( &scene->accessorNameHash );
+	}
+	{
+		for ( int imageIndex = 0; imageIndex < scene->imageCount; imageIndex++ )
+		{
+			free( scene->images[imageIndex].name );
+			for ( int versionIndex = 0; versionIndex < scene->images[imageIndex].versionCount; versionIndex++ )
+			{
+				free( scene->images[imageIndex].versions[versionIndex].container );
+				free( scene->images[imageIndex].versions[versionIndex].uri );
+			}
+			free( scene->images[imageIndex].versions );
+		}
+		free( scene->images );
+		ksGltfNameHash_Destroy( &scene->imageNameHash );
+	}
+	{
+		for ( int samplerIndex = 0; samplerIndex < scene->samplerCount; samplerIndex++ )
+		{
+			free( scene->samplers[samplerIndex].name );
+		}
+		free( scene->samplers );
+		ksGltfNameHash_Destroy( &scene->samplerNameHash );
+	}
+	{
+		for ( int textureIndex = 0; textureIndex < scene->textureCount; textureIndex++ )
+		{
+			free( scene->textures[textureIndex].name );
+			ksGpuTexture_Destroy( context, &scene->textures[textureIndex].texture );
+		}
+		free( scene->textures );
+		ksGltfNameHash_Destroy( &scene->textureNameHash );
+	}
+	{
+		for ( int shaderIndex = 0; shaderIndex < scene->shaderCount; shaderIndex++ )
+		{
+			free( scene->shaders[shaderIndex].name );
+			for ( int shaderType = 0; shaderType < GLTF_SHADER_TYPE_MAX; shaderType++ )
+			{
+				for ( int index = 0; index < scene->shaders[shaderIndex].shaderCount[shaderType]; index++ )
+				{
+					free( scene->shaders[shaderIndex].shaders[shaderType][index].api );
+					free( scene->shaders[shaderIndex].shaders[shaderType][index].version );
+					free( scene->shaders[shaderIndex].shaders[shaderType][index].uri );
+				}
+				free( scene->shaders[shaderIndex].shaders[shaderType] );
+			}
+		}
+		free( scene->shaders );
+		ksGltfNameHash_Destroy( &scene->shaderNameHash );
+	}
+	{
+		for ( int programIndex = 0; programIndex < scene->programCount; programIndex++ )
+		{
+			free( scene->programs[programIndex].name );
+			free( scene->programs[programIndex].vertexSource );
+			free( scene->programs[programIndex].fragmentSource );
+		}
+		free( scene->programs );
+		ksGltfNameHash_Destroy( &scene->programNameHash );
+	}
+	{
+		for ( int techniqueIndex = 0; techniqueIndex < scene->techniqueCount; techniqueIndex++ )
+		{
+			for ( int uniformIndex = 0; uniformIndex < scene->techniques[techniqueIndex].uniformCount; uniformIndex++ )
+			{
+				free( (void *)scene->techniques[techniqueIndex].parms[uniformIndex].name );
+				free( scene->techniques[techniqueIndex].uniforms[uniformIndex].name );
+				free( scene->techniques[techniqueIndex].uniforms[uniformIndex].nodeName );
+			}
+			for ( int attributeIndex = 0; attributeIndex < scene->techniques[techniqueIndex].attributeCount; attributeIndex++ )
+			{
+				free( scene->techniques[techniqueIndex].attributes[attributeIndex].name );
+			}
+			free( scene->techniques[techniqueIndex].name );
+			free( scene->techniques[techniqueIndex].parms );
+			free( scene->techniques[techniqueIndex].uniforms );
+			free( scene->techniques[techniqueIndex].attributes );
+			free( scene->techniques[techniqueIndex].vertexAttributeLayout );
+			ksGpuGraphicsProgram_Destroy( context, &scene->techniques[techniqueIndex].program );
+			if ( scene->techniques[techniqueIndex].instanced )
+			{
+				ksGpuGraphicsProgram_Destroy( context, &scene->techniques[techniqueIndex].instancedProgram );
+			}
+		}
+		free( scene->techniques );
+		ksGltfNameHash_Destroy( &scene->techniqueNameHash );
+	}
+	{
+		for ( int materialIndex = 0; materialIndex < scene->materialCount; materialIndex++ )
+		{
+			free( scene->materials[materialIndex].name );
+			free( scene->materials[materialIndex].values );
+			free( scene->materials[materialIndex].uniformOps );
+		}
+		free( scene->materials );
+		ksGltfNameHash_Destroy( &scene->materialNameHash );
+	}
+	{
+		for ( int modelIndex = 0; modelIndex < scene->modelCount; modelIndex++ )
+		{
+			for ( int surfaceIndex = 0; surfaceIndex < scene->models[modelIndex].surfaceCount; surfaceIndex++ )
+			{
+				if ( scene->models[modelIndex].surfaces[surfaceIndex].geometry.instanceCount > 0 )
+				{
+					ksGpuGraphicsPipeline_Destroy( context, &scene->models[modelIndex].surfaces[surfaceIndex].instancedPipeline );
+				}
+				ksGpuGeometry_Destroy( context, &scene->models[modelIndex].surfaces[surfaceIndex].geometry );
+				ksGpuGraphicsPipeline_Destroy( context, &scene->models[modelIndex].surfaces[surfaceIndex].pipeline );
+			}
+			free( scene->models[modelIndex].name );
+			free( scene->models[modelIndex].surfaces );
+		}
+		free( scene->models );
+		ksGltfNameHash_Destroy( &scene->modelNameHash );
+	}
+	{
+		for ( int timeLineIndex = 0; timeLineIndex < scene->timeLineCount; timeLineIndex++ )
+		{
+			for ( int type = 0; type < GLTF_CHANNEL_MAX; type++ )
+			{
+				free( scene->timeLines[timeLineIndex].channelBlocks[type].nodes );
+				FreeAlignedMemory( scene->timeLines[timeLineIndex].channelBlocks[type].keys );
+			}
+		}
+		free( scene->timeLines );
+		ksGltfNameHash_Destroy( &scene->timeLineNameHash );
+	}
+	{
+		for ( int animationIndex = 0; animationIndex < scene->animationCount; animationIndex++ )
+		{
+			for ( int channelIndex = 0; channelIndex < scene->animations[animationIndex].channelCount; channelIndex++ )
+			{
+				free( scene->animations[animationIndex].channels[channelIndex].nodeName );
+			}
+			free( scene->animations[animationIndex].name );
+			free( scene->animations[animationIndex].channels );
+		}
+		free( scene->animations );
+		ksGltfNameHash_Destroy( &scene->animationNameHash );
+	}
+	{
+		for ( int skinIndex = 0; skinIndex < scene->skinCount; skinIndex++ )
+		{
+			for ( int jointIndex = 0; jointIndex < scene->skins[skinIndex].jointCount; jointIndex++ )
+			{
+				free( scene->skins[skinIndex].joints[jointIndex].name );
+			}
+			free( scene->skins[skinIndex].name );
+			free( scene->skins[skinIndex].joints );
+			ksGpuBuffer_Destroy( context, &scene->skins[skinIndex].jointBuffer );
+		}
+		free( scene->skins );
+		ksGltfNameHash_Destroy( &scene->skinNameHash );
+	}
+	{
+		for ( int cameraIndex = 0; cameraIndex < scene->cameraCount; cameraIndex++ )
+		{
+			free( scene->cameras[cameraIndex].name );
+		}
+		free( scene->cameras );
+		ksGltfNameHash_Destroy( &scene->cameraNameHash );
+	}
+	{
+		for ( int nodeIndex = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
+		{
+			for ( int childIndex = 0; childIndex < scene->nodes[nodeIndex].childCount && scene->nodes[nodeIndex].childNames != NULL; childIndex++ )
+			{
+				free( scene->nodes[nodeIndex].childNames[childIndex] );
+			}
+			free( scene->nodes[nodeIndex].name );
+			free( scene->nodes[nodeIndex].jointName );
+			free( scene->nodes[nodeIndex].children );
+			free( scene->nodes[nodeIndex].childNames );
+			free( scene->nodes[nodeIndex].models );
+		}
+		free( scene->nodes );
+		ksGltfNameHash_Destroy( &scene->nodeNameHash );
+		ksGltfNameHash_Destroy( &scene->nodeJointNameHash );
+	}
+	{
+		for ( int subTreeIndex = 0; subTreeIndex < scene->subTreeCount; subTreeIndex++ )
+		{
+			free( scene->subTrees[subTreeIndex].name );
+			free( scene->subTrees[subTreeIndex].nodes );
+			free( scene->subTrees[subTreeIndex].timeLines );
+			free( scene->subTrees[subTreeIndex].animations );
+			free( scene->subTrees[subTreeIndex].levelOffsets );
+		}
+		free( scene->subTrees );
+		ksGltfNameHash_Destroy( &scene->subTreeNameHash );
+	}
+	{
+		for ( int subSceneIndex = 0; subSceneIndex < scene->subSceneCount; subSceneIndex++ )
+		{
+			free( scene->subScenes[subSceneIndex].name );
+			free( scene->subScenes[subSceneIndex].subTrees );
+		}
+		free( scene->subScenes );
+		ksGltfNameHash_Destroy( &scene->subSceneNameHash );
+	}
+
+	ksGpuBuffer_Destroy( context, &scene->viewProjectionBuffer );
+	if ( scene->drawIndirect )
+	{
+		ksGpuBuffer_Destroy( context, &scene->indirectBuffer );
+	}
+	ksGpuBuffer_Destroy( context, &scene->defaultJointBuffer );
+	ksGpuGraphicsPipeline_Destroy( context, &scene->unitCubePipeline );
+	ksGpuGraphicsProgram_Destroy( context, &scene->unitCubeFlatShadeProgram );
+	ksGpuGeometry_Destroy( context, &scene->unitCubeGeometry );
+
+	memset( scene, 0, sizeof( ksGltfScene ) );
+}
+
+static void ksGltfScene_SetSubScene( ksGltfScene * scene, const char * subSceneName )
+{
+	ksGltfSubScene * subScene = ksGltf_GetSubSceneByName( scene, subSceneName );
+	assert( subScene != NULL );
+	if ( subScene != NULL )
+	{
+		scene->state.currentSubScene = subScene;
+	}
+}
+
+static void ksGltfScene_SetSubTreeVisible( ksGltfScene * scene, const char * subTreeName, const bool visible )
+{
+	ksGltfSubTree * subTree = ksGltf_GetSubTreeByName( scene, subTreeName );
+	assert( subTree != NULL );
+	if ( subTree != NULL )
+	{
+		scene->state.subTreeState[(int)( subTree - scene->subTrees )].visible = visible;
+	}
+}
+
+static void ksGltfScene_SetAnimationEnabled( ksGltfScene * scene, const char * animationName, const bool enabled )
+{
+	ksGltfAnimation * animation = ksGltf_GetAnimationByName( scene, animationName );
+	assert( animation != NULL );
+	if ( animation != NULL )
+	{
+		UNUSED_PARM( enabled );
+	}
+}
+
+static void ksGltfScene_SetNodeTranslation( ksGltfScene * scene, const char * nodeName, const ksVector3f * translation )
+{
+	ksGltfNode * node = ksGltf_GetNodeByName( scene, nodeName );
+	assert( node != NULL );
+	if ( node != NULL )
+	{
+		ksGltfNodeState * nodeState = &scene->state.nodeState[(int)( node - scene->nodes )];
+		nodeState->translation = *translation;
+		nodeState->localDirty = true;
+	}
+}
+
+static void ksGltfScene_SetNodeRotation( ksGltfScene * scene, const char * nodeName, const ksQuatf * rotation )
+{
+	ksGltfNode * node = ksGltf_GetNodeByName( scene, nodeName );
+	assert( node != NULL );
+	if ( node != NULL )
+	{
+		ksGltfNodeState * nodeState = &scene->state.nodeState[(int)( node - scene->nodes )];
+		nodeState->rotation = *rotation;
+		nodeState->localDirty = true;
+	}
+}
 
-		const ksNanoseconds endTime = GetTimeNanoseconds();
-		Print( "%1.3f seconds to load nodes\n", ( endTime - startTime ) * 1e-9f );
+static void ksGltfScene_SetNodeScale( ksGltfScene * scene, const char * nodeName, const ksVector3f * scale )
+{
+	ksGltfNode * node = ksGltf_GetNodeByName( scene, nodeName );
+	assert( node != NULL );
+	if ( node != NULL )
+	{
+		ksGltfNodeState * nodeState = &scene->state.nodeState[(int)( node - scene->nodes )];
+		nodeState->scale = *scale;
+		nodeState->localDirty = true;
 	}
+}
 
-	//
-	// Assign node pointers now that the nodes are sorted and the hash is setup.
-	//
+static void ksGltf_UpdateTimeLineFrameState( ksGltfScene * scene, const ksGltfTimeLine * timeLine, const ksNanoseconds time )
+{
+	ksGltfTimeLineFrameState * frameState = &scene->state.timeLineFrameState[(int)( timeLine - scene->timeLines )];
+	const float timeInSeconds = fmodf( time * 1e-9f, timeLine->duration );
+	int frame = 0;
+	if ( timeLine->rcpStep != 0.0f )
 	{
-		// Get the node children and parents.
-		for ( int nodeIndex = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
-		{
-			ksGltfNode * node = &scene->nodes[nodeIndex];
-			node->children = (ksGltfNode **) calloc( node->childCount, sizeof( ksGltfNode * ) );
-			for ( int childIndex = 0; childIndex < node->childCount; childIndex++ )
-			{
-				node->children[childIndex] = ksGltf_GetNodeByName( scene, node->childNames[childIndex] );
-				assert( node->children[childIndex] != NULL );
-				node->children[childIndex]->parent = node;
-			}
-		}
-		// Get the uniform nodes of techniques.
-		for ( int techniqueIndex = 0; techniqueIndex < scene->techniqueCount; techniqueIndex++ )
+		// Use direct lookup if this is a fixed rate animation.
+		frame = (int)( timeInSeconds * timeLine->rcpStep );
+	}
+	else
+	{
+		// Playback time usually advances monotonically so first walk forward from the key frame of the last update.
+		frame = frameState->frame;
+		if ( timeInSeconds >= timeLine->sampleTimes[frame] )
 		{
-			for ( int uniformIndex = 0; uniformIndex < scene->techniques[techniqueIndex].uniformCount; uniformIndex++ )
+			for ( int step = 0; step < GLTF_TIMELINE_MAX_FORWARD_STEPS && frame < timeLine->sampleCount - 2; step++ )
 			{
-				ksGltfUniform * uniform = &scene->techniques[techniqueIndex].uniforms[uniformIndex];
-				if ( uniform->nodeName != NULL )
+				if ( timeInSeconds < timeLine->sampleTimes[frame + 1] )
 				{
-					uniform->node = ksGltf_GetNodeByName( scene, uniform->nodeName );
-					assert( uniform->node != NULL );
+					break;
 				}
+				frame++;
 			}
 		}
-		// Get the animated nodes.
-		for ( int animationIndex = 0; animationIndex < scene->animationCount; animationIndex++ )
-		{
-			for ( int channelIndex = 0; channelIndex < scene->animations[animationIndex].channelCount; channelIndex++ )
-			{
-				ksGltfAnimationChannel * channel = &scene->animations[animationIndex].channels[channelIndex];
-				channel->node = ksGltf_GetNodeByName( scene, channel->nodeName );
-				assert( channel->node != NULL );
-			}
-		}
-		// Get the skin joint nodes.
-		for ( int skinIndex = 0; skinIndex < scene->skinCount; skinIndex++ )
+		// Use a binary search to find the key frame after a seek or when the animation loops.
+		if ( timeInSeconds < timeLine->sampleTimes[frame] || timeInSeconds >= timeLine->sampleTimes[frame + 1] )
 		{
-			for ( int jointIndex = 0; jointIndex < scene->skins[skinIndex].jointCount; jointIndex++ )
-			{
-				scene->skins[skinIndex].joints[jointIndex].node = ksGltf_GetNodeByJointName( scene, scene->skins[skinIndex].joints[jointIndex].name );
-				assert( scene->skins[skinIndex].joints[jointIndex].node != NULL );
-			}
-			// Find the parent of the root node of the skin.
-			ksGltfNode * root = NULL;
-			for ( int jointIndex = 0; jointIndex < scene->skins[skinIndex].jointCount && root == NULL; jointIndex++ )
+			frame = 0;
+			for ( int sampleCount = timeLine->sampleCount; sampleCount > 1; sampleCount >>= 1 )
 			{
-				root = scene->skins[skinIndex].joints[jointIndex].node;
-				for ( int k = 0; k < scene->skins[skinIndex].jointCount; k++ )
+				const int mid = sampleCount >> 1;
+				if ( timeInSeconds >= timeLine->sampleTimes[frame + mid] )
 				{
-					if ( root->parent == scene->skins[skinIndex].joints[k].node )
-					{
-						root = NULL;
-						break;
-					}
+					frame += mid;
+					sampleCount = ( sampleCount - mid ) * 2;
 				}
 			}
-			scene->skins[skinIndex].parentNode = root->parent;
 		}
 	}
+	assert( timeInSeconds >= timeLine->sampleTimes[frame] && timeInSeconds < timeLine->sampleTimes[frame + 1] );
+	frameState->frame = frame;
+	frameState->fraction = ( timeInSeconds - timeLine->sampleTimes[frame] ) / ( timeLine->sampleTimes[frame + 1] - timeLine->sampleTimes[frame] );
+}
 
-	//
-	// glTF sub-scenes
-	//
+// Stores an interpolated rotation in the node state and marks the node dirty if the rotation changed.
+static void ksGltf_StoreChannelRotation( ksGltfScene * scene, const ksGltfNode * node, const float x, const float y, const float z, const float w )
+{
+	ksGltfNodeState * nodeState = &scene->state.nodeState[(int)( node - scene->nodes )];
+	ksQuatf * rotation = &nodeState->rotation;
+	if ( rotation->x != x || rotation->y != y || rotation->z != z || rotation->w != w )
 	{
-		const ksJson * subScenes = ksJson_GetMemberByName( rootNode, "scenes" );
-		scene->subTreeCount = 0;
-		scene->subTrees = (ksGltfSubTree *) calloc( scene->nodeCount, sizeof( ksGltfSubTree ) );
-		scene->subSceneCount = ksJson_GetMemberCount( subScenes );
-		scene->subScenes = (ksGltfSubScene *) calloc( scene->subSceneCount, sizeof( ksGltfSubScene ) );
-		for ( int subSceneIndex = 0; subSceneIndex < scene->subSceneCount; subSceneIndex++ )
-		{
-			const ksJson * subScene = ksJson_GetMemberByIndex( subScenes, subSceneIndex );
-			scene->subScenes[subSceneIndex].name = ksGltf_strdup( ksJson_GetMemberName( subScene ) );
-
-			const ksJson * nodes = ksJson_GetMemberByName( subScene, "nodes" );
-			scene->subScenes[subSceneIndex].subTreeCount = ksJson_GetMemberCount( nodes );
-			scene->subScenes[subSceneIndex].subTrees = (ksGltfSubTree **) calloc( scene->subScenes[subSceneIndex].subTreeCount, sizeof( ksGltfSubTree * ) );
-
-			for ( int subTreeIndex = 0; subTreeIndex < scene->subScenes[subSceneIndex].subTreeCount; subTreeIndex++ )
-			{
-				const char * nodeName = ksJson_GetString( ksJson_GetMemberByIndex( nodes, subTreeIndex ), "" );
+		rotation->x = x;
+		rotation->y = y;
+		rotation->z = z;
+		rotation->w = w;
+		nodeState->channelDirty[GLTF_CHANNEL_ROTATION] = true;
+	}
+}
 
-				scene->subScenes[subSceneIndex].subTrees[subTreeIndex] = NULL;
-				for ( int i = 0; i < scene->subTreeCount; i++ )
-				{
-					if ( strcmp( scene->subTrees[i].name, nodeName ) == 0 )
-					{
-						scene->subScenes[subSceneIndex].subTrees[subTreeIndex] = &scene->subTrees[i];
-						break;
-					}
-				}
+// Stores an interpolated translation or scale in the node state and marks the node dirty if the vector changed.
+static void ksGltf_StoreChannelVector( ksGltfScene * scene, const ksGltfNode * node, const ksGltfChannelType type, const float x, const float y, const float z )
+{
+	ksGltfNodeState * nodeState = &scene->state.nodeState[(int)( node - scene->nodes )];
+	ksVector3f * vector = ( type == GLTF_CHANNEL_TRANSLATION ) ? &nodeState->translation : &nodeState->scale;
+	if ( vector->x != x || vector->y != y || vector->z != z )
+	{
+		vector->x = x;
+		vector->y = y;
+		vector->z = z;
+		nodeState->channelDirty[type] = true;
+	}
+}
 
-				if ( scene->subScenes[subSceneIndex].subTrees[subTreeIndex] == NULL )
-				{
-					ksGltfSubTree * subTree = &scene->subTrees[scene->subTreeCount++];
-					subTree->name = ksGltf_strdup( nodeName );
+// Interpolates a range of channels of a channel block and stores the results in the node states.
+// The arithmetic is the same as that of ksVector3f_Lerp and ksQuatf_Lerp so the results are identical to
+// interpolating the channels one at a time. A node is only marked dirty if a value actually changed, so
+// channels that hold a value, or time lines that are paused, do not cause the node to be transformed again.
+// With SSE four channels are interpolated at once. The range must start at a multiple of four channels,
+// so the loads are aligned and the last group of four only reads the zero padding of the block.
+static void ksGltf_ApplyChannelBlock( ksGltfScene * scene, const ksGltfTimeLine * timeLine, const ksGltfChannelBlock * block, const int firstChannel, const int channelCount )
+{
+	const ksGltfTimeLineFrameState * frameState = &scene->state.timeLineFrameState[(int)( timeLine - scene->timeLines )];
+	const float fraction = frameState->fraction;
+	const int stride = block->stride;
+	const float * a = block->keys + ( frameState->frame + 0 ) * block->componentCount * stride + firstChannel;
+	const float * b = block->keys + ( frameState->frame + 1 ) * block->componentCount * stride + firstChannel;
+	ksGltfNode ** nodes = block->nodes + firstChannel;
 
-					ksGltfNode * subTreeRootNode = ksGltf_GetNodeByName( scene, nodeName );
-					assert( subTreeRootNode != NULL );
+	const float SMALLEST_NON_DENORMAL = 1.1754943508222875e-038f;	// ( 1U << 23 )
 
-					subTree->nodes = (ksGltfNode **) calloc( subTreeRootNode->subTreeNodeCount, sizeof( ksGltfNode * ) );
-					subTree->nodeCount = subTreeRootNode->subTreeNodeCount;
-					for ( int nodeIndex = 0; nodeIndex < subTreeRootNode->subTreeNodeCount; nodeIndex++ )
-					{
-						// Note that the nodes of one subtree should be laid out consecutively in memory after sorting the nodes.
-						subTree->nodes[nodeIndex] = subTreeRootNode + nodeIndex;
-					}
-					subTree->timeLines = (ksGltfTimeLine **) calloc( scene->timeLineCount, sizeof( ksGltfTimeLine * ) );
-					subTree->timeLineCount = 0;
-					subTree->animations = (ksGltfAnimation **) calloc( scene->animationCount, sizeof( ksGltfAnimation * ) );
-					subTree->animationCount = 0;
-					for ( int animationIndex = 0; animationIndex < scene->animationCount; animationIndex++ )
-					{
-						bool include = false;
-						ksGltfAnimation * animation = &scene->animations[animationIndex];
-						for ( int channelIndex = 0; animation->channelCount; channelIndex++ )
-						{
-							if ( animation->channels[channelIndex].node >= subTreeRootNode &&
-									animation->channels[channelIndex].node < subTreeRootNode + subTreeRootNode->subTreeNodeCount )
-							{
-								include = true;
-								break;
-							}
-						}
-						if ( include )
-						{
-							for ( int i = 0; i < subTree->animationCount; i++ )
-							{
-								if ( subTree->animations[i] == animation )
-								{
-									include = false;
-									break;
-								}
-							}
-							if ( include )
-							{
-								subTree->animations[subTree->animationCount++] = animation;
-								for ( int i = 0; i < subTree->timeLineCount; i++ )
-								{
-									if ( subTree->timeLines[i] == animation->timeLine )
-									{
-										include = false;
-										break;
-									}
-								}
-								if ( include )
-								{
-									subTree->timeLines[subTree->timeLineCount++] = animation->timeLine;
-								}
-							}
-						}
-					}
+#if defined( KSALGEBRA_USE_SSE )
+	assert( ( firstChannel & 3 ) == 0 );
 
-					scene->subScenes[subSceneIndex].subTrees[subTreeIndex] = subTree;
-				}
+	if ( block->type == GLTF_CHANNEL_ROTATION )
+	{
+		const __m128 vfa = _mm_set1_ps( 1.0f - fraction );
+		const __m128 vf = _mm_set1_ps( fraction );
+		const __m128 vzero = _mm_setzero_ps();
+		const __m128 vone = _mm_set1_ps( 1.0f );
+		const __m128 vsign = _mm_set1_ps( -0.0f );
+		const __m128 vsmallest = _mm_set1_ps( SMALLEST_NON_DENORMAL );
+		for ( int lane = 0; lane < channelCount; lane += 4 )
+		{
+			const __m128 ax = _mm_load_ps( &a[0 * stride + lane] );
+			const __m128 ay = _mm_load_ps( &a[1 * stride + lane] );
+			const __m128 az = _mm_load_ps( &a[2 * stride + lane] );
+			const __m128 aw = _mm_load_ps( &a[3 * stride + lane] );
+			const __m128 bx = _mm_load_ps( &b[0 * stride + lane] );
+			const __m128 by = _mm_load_ps( &b[1 * stride + lane] );
+			const __m128 bz = _mm_load_ps( &b[2 * stride + lane] );
+			const __m128 bw = _mm_load_ps( &b[3 * stride + lane] );
+
+			__m128 s = _mm_mul_ps( ax, bx );
+			s = _mm_add_ps( s, _mm_mul_ps( ay, by ) );
+			s = _mm_add_ps( s, _mm_mul_ps( az, bz ) );
+			s = _mm_add_ps( s, _mm_mul_ps( aw, bw ) );
+			const __m128 vfb = _mm_xor_ps( vf, _mm_and_ps( _mm_cmplt_ps( s, vzero ), vsign ) );
+
+			const __m128 x = _mm_add_ps( _mm_mul_ps( ax, vfa ), _mm_mul_ps( bx, vfb ) );
+			const __m128 y = _mm_add_ps( _mm_mul_ps( ay, vfa ), _mm_mul_ps( by, vfb ) );
+			const __m128 z = _mm_add_ps( _mm_mul_ps( az, vfa ), _mm_mul_ps( bz, vfb ) );
+			const __m128 w = _mm_add_ps( _mm_mul_ps( aw, vfa ), _mm_mul_ps( bw, vfb ) );
+
+			__m128 lengthSquared = _mm_mul_ps( x, x );
+			lengthSquared = _mm_add_ps( lengthSquared, _mm_mul_ps( y, y ) );
+			lengthSquared = _mm_add_ps( lengthSquared, _mm_mul_ps( z, z ) );
+			lengthSquared = _mm_add_ps( lengthSquared, _mm_mul_ps( w, w ) );
+			const __m128 normal = _mm_cmpge_ps( lengthSquared, vsmallest );
+			const __m128 lengthRcp = _mm_or_ps( _mm_and_ps( normal, _mm_div_ps( vone, _mm_sqrt_ps( lengthSquared ) ) ), _mm_andnot_ps( normal, vone ) );
+
+			float rotations[4][4];
+			_mm_storeu_ps( rotations[0], _mm_mul_ps( x, lengthRcp ) );
+			_mm_storeu_ps( rotations[1], _mm_mul_ps( y, lengthRcp ) );
+			_mm_storeu_ps( rotations[2], _mm_mul_ps( z, lengthRcp ) );
+			_mm_storeu_ps( rotations[3], _mm_mul_ps( w, lengthRcp ) );
+
+			const int laneCount = ( channelCount - lane < 4 ) ? channelCount - lane : 4;
+			for ( int i = 0; i < laneCount; i++ )
+			{
+				ksGltf_StoreChannelRotation( scene, nodes[lane + i], rotations[0][i], rotations[1][i], rotations[2][i], rotations[3][i] );
 			}
 		}
-		ksGltf_CreateSubTreeNameHash( scene );
-		ksGltf_CreateSubSceneNameHash( scene );
 	}
+	else
+	{
+		const __m128 vf = _mm_set1_ps( fraction );
+		for ( int lane = 0; lane < channelCount; lane += 4 )
+		{
+			const __m128 ax = _mm_load_ps( &a[0 * stride + lane] );
+			const __m128 ay = _mm_load_ps( &a[1 * stride + lane] );
+			const __m128 az = _mm_load_ps( &a[2 * stride + lane] );
 
-	//
-	// glTF default scene
-	//
-
-	const char * defaultSceneName = ksJson_GetString( ksJson_GetMemberByName( rootNode, "scene" ), "" );
-	scene->state.currentSubScene = ksGltf_GetSubSceneByName( scene, defaultSceneName );
-	assert( scene->state.currentSubScene != NULL );
-
-	ksJson_Destroy( rootNode );
+			float vectors[3][4];
+			_mm_storeu_ps( vectors[0], _mm_add_ps( ax, _mm_mul_ps( vf, _mm_sub_ps( _mm_load_ps( &b[0 * stride + lane] ), ax ) ) ) );
+			_mm_storeu_ps( vectors[1], _mm_add_ps( ay, _mm_mul_ps( vf, _mm_sub_ps( _mm_load_ps( &b[1 * stride + lane] ), ay ) ) ) );
+			_mm_storeu_ps( vectors[2], _mm_add_ps( az, _mm_mul_ps( vf, _mm_sub_ps( _mm_load_ps( &b[2 * stride + lane] ), az ) ) ) );
 
-	// Allocate run-time state memory.
-	scene->state.timeLineFrameState = (ksGltfTimeLineFrameState *) calloc( scene->timeLineCount, sizeof( ksGltfTimeLineFrameState ) );
-	scene->state.skinCullingState = (ksGltfSkinCullingState *) calloc( scene->skinCount, sizeof( ksGltfSkinCullingState ) );
-	for ( int skinIndex = 0; skinIndex < scene->skinCount; skinIndex++ )
-	{
-		ksGltfSkinCullingState * skinCullingState = &scene->state.skinCullingState[skinIndex];
-		ksVector3f_Set( &skinCullingState->mins, FLT_MAX );
-		ksVector3f_Set( &skinCullingState->maxs, -FLT_MAX );
-		skinCullingState->culled = false;
+			const int laneCount = ( channelCount - lane < 4 ) ? channelCount - lane : 4;
+			for ( int i = 0; i < laneCount; i++ )
+			{
+				ksGltf_StoreChannelVector( scene, nodes[lane + i], block->type, vectors[0][i], vectors[1][i], vectors[2][i] );
+			}
+		}
 	}
-	scene->state.nodeState = (ksGltfNodeState *) calloc( scene->nodeCount, sizeof( ksGltfNodeState ) );
-	for ( int nodeIndex = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
+#else
+	if ( block->type == GLTF_CHANNEL_ROTATION )
 	{
-		const ksGltfNode * node = &scene->nodes[nodeIndex];
-		ksGltfNodeState * nodeState = &scene->state.nodeState[nodeIndex];
-		nodeState->parent = ( node->parent != NULL ) ? &scene->state.nodeState[(int)( node->parent - scene->nodes )] : NULL;
-		nodeState->translation = node->translation;
-		nodeState->rotation = node->rotation;
-		nodeState->scale = node->scale;
-		ksMatrix4x4f_CreateIdentity( &nodeState->localTransform );
-		ksMatrix4x4f_CreateIdentity( &nodeState->globalTransform );
+		const float fa = 1.0f - fraction;
+		for ( int lane = 0; lane < channelCount; lane++ )
+		{
+			const float s = a[0 * stride + lane] * b[0 * stride + lane] + a[1 * stride + lane] * b[1 * stride + lane] +
+							a[2 * stride + lane] * b[2 * stride + lane] + a[3 * stride + lane] * b[3 * stride + lane];
+			const float fb = ( s < 0.0f ) ? -fraction : fraction;
+			const float x = a[0 * stride + lane] * fa + b[0 * stride + lane] * fb;
+			const float y = a[1 * stride + lane] * fa + b[1 * stride + lane] * fb;
+			const float z = a[2 * stride + lane] * fa + b[2 * stride + lane] * fb;
+			const float w = a[3 * stride + lane] * fa + b[3 * stride + lane] * fb;
+			const float lengthSquared = x * x + y * y + z * z + w * w;
+			const float lengthRcp = ( lengthSquared >= SMALLEST_NON_DENORMAL ) ? 1.0f / sqrtf( lengthSquared ) : 1.0f;
+
+			ksGltf_StoreChannelRotation( scene, nodes[lane], x * lengthRcp, y * lengthRcp, z * lengthRcp, w * lengthRcp );
+		}
 	}
-	scene->state.subTreeState = (ksGltfSubTreeState *) calloc( scene->subTreeCount, sizeof( ksGltfSubTreeState ) );
-	for ( int subTreeIndex = 0; subTreeIndex < scene->subTreeCount; subTreeIndex++ )
+	else
 	{
-		scene->state.subTreeState[subTreeIndex].visible = true;
+		for ( int lane = 0; lane < channelCount; lane++ )
+		{
+			const float x = a[0 * stride + lane] + fraction * ( b[0 * stride + lane] - a[0 * stride + lane] );
+			const float y = a[1 * stride + lane] + fraction * ( b[1 * stride + lane] - a[1 * stride + lane] );
+			const float z = a[2 * stride + lane] + fraction * ( b[2 * stride + lane] - a[2 * stride + lane] );
+
+			ksGltf_StoreChannelVector( scene, nodes[lane], block->type, x, y, z );
+		}
 	}
+#endif
+}
 
-	// Create view projection uniform buffer.
+static void ksGltf_ApplyTimeLineChannels( ksGltfScene * scene, const ksGltfTimeLine * timeLine )
+{
+	for ( int type = 0; type < GLTF_CHANNEL_MAX; type++ )
 	{
-		ksGpuBuffer_Create( context, &scene->viewProjectionBuffer, KS_GPU_BUFFER_TYPE_UNIFORM, 4 * sizeof( ksMatrix4x4f ), NULL, false );
+		ksGltf_ApplyChannelBlock( scene, timeLine, &timeLine->channelBlocks[type], 0, timeLine->channelBlocks[type].channelCount );
 	}
+}
 
-	// Create a default joint uniform buffer.
+// Only nodes with a local transform that was changed by the application or by an animation channel, or nodes with
+// an ancestor whose global transform changed, are updated. Parents must be transformed before their children, so the
+// parent's global dirty flag is up to date.
+static void ksGltf_TransformNodes( ksGltfScene * scene, ksGltfNode ** nodes, const int nodeCount )
+{
+	for ( int nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++ )
 	{
-		ksMatrix4x4f * data = malloc( MAX_JOINTS * sizeof( ksMatrix4x4f ) );
-		for ( int jointIndex = 0; jointIndex < MAX_JOINTS; jointIndex++ )
+		ksGltfNodeState * nodeState = &scene->state.nodeState[(int)( nodes[nodeIndex] - scene->nodes )];
+
+		const bool localDirty = nodeState->localDirty ||
+								nodeState->channelDirty[GLTF_CHANNEL_TRANSLATION] ||
+								nodeState->channelDirty[GLTF_CHANNEL_ROTATION] ||
+								nodeState->channelDirty[GLTF_CHANNEL_SCALE];
+		if ( localDirty )
 		{
-			ksMatrix4x4f_CreateIdentity( &data[jointIndex] );
+			ksMatrix4x4f_CreateTranslationRotationScale( &nodeState->localTransform, &nodeState->translation, &nodeState->rotation, &nodeState->scale );
+		}
+
+		nodeState->globalDirty = localDirty || ( nodeState->parent != NULL && nodeState->parent->globalDirty );
+		nodeState->boundsDirty |= nodeState->globalDirty;
+		nodeState->localDirty = false;
+		nodeState->channelDirty[GLTF_CHANNEL_TRANSLATION] = false;
+		nodeState->channelDirty[GLTF_CHANNEL_ROTATION] = false;
+		nodeState->channelDirty[GLTF_CHANNEL_SCALE] = false;
+		if ( !nodeState->globalDirty )
+		{
+			continue;
+		}
+
+		if ( nodeState->parent != NULL )
+		{
+			assert( nodeState->parent < nodeState );
+			ksMatrix4x4f_Multiply( &nodeState->globalTransform, &nodeState->parent->globalTransform, &nodeState->localTransform );
+		}
+		else
+		{
+			nodeState->globalTransform = nodeState->localTransform;
 		}
-		ksGpuBuffer_Create( context, &scene->defaultJointBuffer, KS_GPU_BUFFER_TYPE_UNIFORM, MAX_JOINTS * sizeof( ksMatrix4x4f ), data, false );
-		free( data );
 	}
+}
 
-	// Create unit cube.
+// Calculates the bounds of a skin and culls the skin against the combined view-projection matrix.
+static void ksGltf_CullSkin( ksGltfScene * scene, const ksGltfSkin * skin, const ksViewState * viewState )
+{
+	ksGltfSkinCullingState * skinCullingState = &scene->state.skinCullingState[(int)( skin - scene->skins )];
+	skinCullingState->culled = false;
+
+	if ( skin->jointGeometryMins == NULL || skin->jointGeometryMaxs == NULL )
 	{
-		ksGpuGeometry_CreateCube( context, &scene->unitCubeGeometry, 0.0f, 1.0f );
-		ksGpuGraphicsProgram_Create( context, &scene->unitCubeFlatShadeProgram,
-									PROGRAM( unitCubeFlatShadeVertexProgram ), sizeof( PROGRAM( unitCubeFlatShadeVertexProgram ) ),
-									PROGRAM( unitCubeFlatShadeFragmentProgram ), sizeof( PROGRAM( unitCubeFlatShadeFragmentProgram ) ),
-									unitCubeFlatShadeProgramParms, ARRAY_SIZE( unitCubeFlatShadeProgramParms ),
-									scene->unitCubeGeometry.layout, VERTEX_ATTRIBUTE_FLAG_POSITION | VERTEX_ATTRIBUTE_FLAG_NORMAL );
+		return;
+	}
 
-		ksGpuGraphicsPipelineParms pipelineParms;
-		ksGpuGraphicsPipelineParms_Init( &pipelineParms );
+	const ksGltfNodeState * parentNodeState = &scene->state.nodeState[(int)( skin->parentNode - scene->nodes )];
 
-		pipelineParms.renderPass = renderPass;
-		pipelineParms.program = &scene->unitCubeFlatShadeProgram;
-		pipelineParms.geometry = &scene->unitCubeGeometry;
+	ksMatrix4x4f inverseGlobalSkeletonTransfom;
+	ksMatrix4x4f_Invert( &inverseGlobalSkeletonTransfom, &parentNodeState->globalTransform );
 
-		ksGpuGraphicsPipeline_Create( context, &scene->unitCubePipeline, &pipelineParms );
-	}
+	ksVector3f_Set( &skinCullingState->mins, FLT_MAX );
+	ksVector3f_Set( &skinCullingState->maxs, -FLT_MAX );
+	for ( int jointIndex = 0; jointIndex < skin->jointCount; jointIndex++ )
+	{
+		const ksGltfNodeState * jointNodeState = &scene->state.nodeState[(int)( skin->joints[jointIndex].node - scene->nodes )];
 
-	const ksNanoseconds t1 = GetTimeNanoseconds();
+		ksMatrix4x4f localJointTransform;
+		ksMatrix4x4f_Multiply( &localJointTransform, &inverseGlobalSkeletonTransfom, &jointNodeState->globalTransform );
 
-	Print( "%1.3f seconds to load %s\n", ( t1 - t0 ) * 1e-9f, fileName );
+		ksVector3f jointMins;
+		ksVector3f jointMaxs;
+		ksMatrix4x4f_TransformBounds( &jointMins, &jointMaxs, &localJointTransform, &skin->jointGeometryMins[jointIndex], &skin->jointGeometryMaxs[jointIndex] );
+		ksVector3f_Min( &skinCullingState->mins, &skinCullingState->mins, &jointMins );
+		ksVector3f_Max( &skinCullingState->maxs, &skinCullingState->maxs, &jointMaxs );
+	}
 
-	return true;
+	ksMatrix4x4f modelViewProjectionCullMatrix;
+	ksMatrix4x4f_Multiply( &modelViewProjectionCullMatrix, &viewState->combinedViewProjectionMatrix, &parentNodeState->globalTransform );
+
+	skinCullingState->culled = ksMatrix4x4f_CullBounds( &modelViewProjectionCullMatrix, &skinCullingState->mins, &skinCullingState->maxs );
 }
 
-static void ksGltfScene_Destroy( ksGpuContext * context, ksGltfScene * scene )
+// Calculates the joint matrices of a skin. The transform of the whole skeleton is excluded
+// because that transform will be passed down the vertex shader as the model matrix.
+static void ksGltf_UpdateSkinJoints( const ksGltfScene * scene, const ksGltfSkin * skin, ksMatrix4x4f * joints )
 {
-	ksGpuContext_WaitIdle( context );
+	const ksGltfNodeState * parentNodeState = &scene->state.nodeState[(int)( skin->parentNode - scene->nodes )];
 
+	ksMatrix4x4f inverseGlobalSkeletonTransfom;
+	ksMatrix4x4f_Invert( &inverseGlobalSkeletonTransfom, &parentNodeState->globalTransform );
+
+	for ( int jointIndex = 0; jointIndex < skin->jointCount; jointIndex++ )
 	{
-		free( scene->state.timeLineFrameState );
-		free( scene->state.skinCullingState );
-		free( scene->state.nodeState );
-		free( scene->state.subTreeState );
-	}
-	{
-		for ( int bufferIndex = 0; bufferIndex < scene->bufferCount; bufferIndex++ )
-		{
-			free( scene->buffers[bufferIndex].name );
-			free( scene->buffers[bufferIndex].type );
-			free( scene->buffers[bufferIndex].bufferData );
-		}
-		free( scene->buffers );
-		free( scene->bufferNameHash );
-	}
-	{
-		for ( int bufferViewIndex = 0; bufferViewIndex < scene->bufferViewCount; bufferViewIndex++ )
-		{
-			free( scene->bufferViews[bufferViewIndex].name );
-		}
-		free( scene->bufferViews );
-		free( scene->bufferViewNameHash );
+		const ksGltfNodeState * jointNodeState = &scene->state.nodeState[(int)( skin->joints[jointIndex].node - scene->nodes )];
+
+		ksMatrix4x4f localJointTransform;
+		ksMatrix4x4f_Multiply( &localJointTransform, &inverseGlobalSkeletonTransfom, &jointNodeState->globalTransform );
+		ksMatrix4x4f_Multiply( &joints[jointIndex], &localJointTransform, &skin->inverseBindMatrices[jointIndex] );
 	}
+}
+
+// Refits the global space bounds of the nodes of a sub-tree and culls the nodes hierarchically against the frusta
+// of both eyes. Walking the breadth-first sorted nodes backwards visits all children before their
+// parent, and walking the nodes forwards visits all parents before their children. The bounds of the geometry of a node
+// are only recalculated if the node moved since they were last recalculated, which may have been several simulated
+// frames ago, or if the geometry is skinned. A node is culled without testing its bounds if
+// its parent in the same sub-tree is culled. A node is culled if it is not visible in the given eye. When 'eye' is 2, or
+// the commands recorded for one eye are reused for the other eye, a node is only culled if it is not visible in either eye.
+// The number of nodes with bounds tested against the frusta and the number of culled nodes are added to 'testedNodes'
+// and 'culledNodes'.
+static void ksGltf_CullSubTree( ksGltfScene * scene, const ksGltfSubTree * subTree, const ksViewState * viewState, const int eye,
+								int * testedNodes, int * culledNodes )
+{
+	const int eyeMask = ( eye == 2 || scene->cullBothEyes ) ? ( 1 << NUM_EYES ) - 1 : 1 << eye;
+
+	for ( int nodeIndex = subTree->nodeCount - 1; nodeIndex >= 0; nodeIndex-- )
 	{
-		for ( int accessorIndex = 0; accessorIndex < scene->accessorCount; accessorIndex++ )
+		const ksGltfNode * node = subTree->nodes[nodeIndex];
+		ksGltfNodeState * nodeState = &scene->state.nodeState[(int)( node - scene->nodes )];
+
+		if ( node->modelCount > 0 && node->skin != NULL )
 		{
-			free( scene->accessors[accessorIndex].name );
-			free( scene->accessors[accessorIndex].type );
-		}
-		free( scene->accessors );
-		free( scene->accessorNameHash );
-	}
-	{
-		for ( int imageIndex = 0; imageIndex < scene->imageCount; imageIndex++ )
+			const ksGltfSkin * skin = node->skin;
+			if ( skin->jointGeometryMins != NULL && skin->jointGeometryMaxs != NULL )
+			{
+				const ksGltfSkinCullingState * skinCullingState = &scene->state.skinCullingState[(int)( skin - scene->skins )];
+				const ksGltfNodeState * skinParentNodeState = &scene->state.nodeState[(int)( skin->parentNode - scene->nodes )];
+				ksMatrix4x4f_TransformBounds( &nodeState->geometryMins, &nodeState->geometryMaxs, &skinParentNodeState->globalTransform,
+												&skinCullingState->mins, &skinCullingState->maxs );
+			}
+			else
+			{
+				// Skins without KHR_skin_culling cannot be bounded.
+				ksVector3f_Set( &nodeState->geometryMins, -FLT_MAX );
+				ksVector3f_Set( &nodeState->geometryMaxs, FLT_MAX );
+			}
+		}
+		else if ( node->modelCount > 0 && nodeState->boundsDirty )
 		{
-			free( scene->images[imageIndex].name );
-			for ( int versionIndex = 0; versionIndex < scene->images[imageIndex].versionCount; versionIndex++ )
+			ksVector3f mins;
+			ksVector3f maxs;
+			ksVector3f_Set( &mins, FLT_MAX );
+			ksVector3f_Set( &maxs, -FLT_MAX );
+			for ( int modelIndex = 0; modelIndex < node->modelCount; modelIndex++ )
 			{
-				free( scene->images[imageIndex].versions[versionIndex].container );
-				free( scene->images[imageIndex].versions[versionIndex].uri );
+				ksVector3f_Min( &mins, &mins, &node->models[modelIndex]->mins );
+				ksVector3f_Max( &maxs, &maxs, &node->models[modelIndex]->maxs );
 			}
+			ksMatrix4x4f_TransformBounds( &nodeState->geometryMins, &nodeState->geometryMaxs, &nodeState->globalTransform, &mins, &maxs );
 		}
-		free( scene->images );
-		free( scene->imageNameHash );
-	}
-	{
-		for ( int textureIndex = 0; textureIndex < scene->textureCount; textureIndex++ )
+		nodeState->boundsDirty = false;
+
+		nodeState->subTreeMins = nodeState->geometryMins;
+		nodeState->subTreeMaxs = nodeState->geometryMaxs;
+		for ( int childIndex = 0; childIndex < node->childCount; childIndex++ )
 		{
-			free( scene->textures[textureIndex].name );
-			ksGpuTexture_Destroy( context, &scene->textures[textureIndex].texture );
+			const ksGltfNodeState * childNodeState = &scene->state.nodeState[(int)( node->children[childIndex] - scene->nodes )];
+			ksVector3f_Min( &nodeState->subTreeMins, &nodeState->subTreeMins, &childNodeState->subTreeMins );
+			ksVector3f_Max( &nodeState->subTreeMaxs, &nodeState->subTreeMaxs, &childNodeState->subTreeMaxs );
 		}
-		free( scene->textures );
-		free( scene->textureNameHash );
 	}
+
+	// Each depth level is a contiguous range of nodes, so the bounds of a level are culled in batches
+	// after all parents on the previous level are resolved.
+	for ( int level = 0; level < subTree->levelCount; level++ )
 	{
-		for ( int shaderIndex = 0; shaderIndex < scene->shaderCount; shaderIndex++ )
+		const int levelEnd = subTree->levelOffsets[level + 1];
+		for ( int first = subTree->levelOffsets[level]; first < levelEnd; first += GLTF_JOB_SIZE )
 		{
-			free( scene->shaders[shaderIndex].name );
-			for ( int shaderType = 0; shaderType < GLTF_SHADER_TYPE_MAX; shaderType++ )
+			const int last = ( levelEnd - first < GLTF_JOB_SIZE ) ? levelEnd : first + GLTF_JOB_SIZE;
+
+			ksGltfNodeState * cullNodeStates[GLTF_JOB_SIZE];
+			ksVector3f cullMins[GLTF_JOB_SIZE];
+			ksVector3f cullMaxs[GLTF_JOB_SIZE];
+			int cullCount = 0;
+
+			for ( int nodeIndex = first; nodeIndex < last; nodeIndex++ )
 			{
-				for ( int index = 0; index < scene->shaders[shaderIndex].shaderCount[shaderType]; index++ )
+				const ksGltfNode * node = subTree->nodes[nodeIndex];
+				ksGltfNodeState * nodeState = &scene->state.nodeState[(int)( node - scene->nodes )];
+
+				if ( node->parent != NULL && node->parent >= subTree->nodes[0] && nodeState->parent->culled )
 				{
-					free( scene->shaders[shaderIndex].shaders[shaderType][index].api );
-					free( scene->shaders[shaderIndex].shaders[shaderType][index].version );
-					free( scene->shaders[shaderIndex].shaders[shaderType][index].uri );
+					nodeState->culled = true;
 				}
-				free( scene->shaders[shaderIndex].shaders[shaderType] );
+				else if ( nodeState->subTreeMins.x > nodeState->subTreeMaxs.x )
+				{
+					// There is no geometry.
+					nodeState->culled = true;
+				}
+				else if ( nodeState->subTreeMins.x == -FLT_MAX )
+				{
+					// The geometry is unbounded.
+					nodeState->culled = false;
+				}
+				else
+				{
+					cullNodeStates[cullCount] = nodeState;
+					cullMins[cullCount] = nodeState->subTreeMins;
+					cullMaxs[cullCount] = nodeState->subTreeMaxs;
+					cullCount++;
+				}
+			}
+
+			unsigned char visibleEyes[GLTF_JOB_SIZE];
+			ksViewState_CullBounds( viewState, cullMins, cullMaxs, cullCount, visibleEyes );
+
+			for ( int cullIndex = 0; cullIndex < cullCount; cullIndex++ )
+			{
+				cullNodeStates[cullIndex]->culled = ( ( visibleEyes[cullIndex] & eyeMask ) == 0 );
+			}
+			*testedNodes += cullCount;
+
+			for ( int nodeIndex = first; nodeIndex < last; nodeIndex++ )
+			{
+				*culledNodes += scene->state.nodeState[(int)( subTree->nodes[nodeIndex] - scene->nodes )].culled;
 			}
 		}
-		free( scene->shaders );
-		free( scene->shaderNameHash );
 	}
+}
+
+static void ksGltf_JobThread( void * data )
+{
+	ksGltfJobs * jobs = (ksGltfJobs *)data;
+
+	// Loop until no more jobs to process.
+	for ( ; ; )
 	{
-		for ( int programIndex = 0; programIndex < scene->programCount; programIndex++ )
+		// Atomically add 1 to claim a job.
+		const unsigned int jobIndex = ksAtomicUint32_Increment( &jobs->nextJob ) - 1;
+
+		// Done when all jobs have been claimed for processing.
+		if ( jobIndex >= (unsigned int)jobs->jobCount )
 		{
-			free( scene->programs[programIndex].name );
-			free( scene->programs[programIndex].vertexSource );
-			free( scene->programs[programIndex].fragmentSource );
+			break;
 		}
-		free( scene->programs );
-		free( scene->programNameHash );
-	}
-	{
-		for ( int techniqueIndex = 0; techniqueIndex < scene->techniqueCount; techniqueIndex++ )
+
+		ksGltfJob * job = &jobs->jobs[jobIndex];
+		if ( job->timeLines != NULL )
 		{
-			for ( int uniformIndex = 0; uniformIndex < scene->techniques[techniqueIndex].uniformCount; uniformIndex++ )
+			for ( int timeLineIndex = 0; timeLineIndex < job->count; timeLineIndex++ )
 			{
-				free( (void *)scene->techniques[techniqueIndex].parms[uniformIndex].name );
-				free( scene->techniques[techniqueIndex].uniforms[uniformIndex].name );
-				free( scene->techniques[techniqueIndex].uniforms[uniformIndex].nodeName );
+				ksGltf_UpdateTimeLineFrameState( jobs->scene, job->timeLines[timeLineIndex], jobs->time );
 			}
-			for ( int attributeIndex = 0; attributeIndex < scene->techniques[techniqueIndex].attributeCount; attributeIndex++ )
+		}
+		else if ( job->channelBlock != NULL )
+		{
+			ksGltf_ApplyChannelBlock( jobs->scene, job->channelTimeLine, job->channelBlock, job->first, job->count );
+		}
+		else if ( job->nodes != NULL )
+		{
+			ksGltf_TransformNodes( jobs->scene, job->nodes, job->count );
+		}
+		else if ( job->cullSkins != NULL )
+		{
+			for ( int skinIndex = 0; skinIndex < job->count; skinIndex++ )
 			{
-				free( scene->techniques[techniqueIndex].attributes[attributeIndex].name );
+				ksGltf_CullSkin( jobs->scene, job->cullSkins[skinIndex], jobs->viewState );
 			}
-			free( scene->techniques[techniqueIndex].name );
-			free( scene->techniques[techniqueIndex].parms );
-			free( scene->techniques[techniqueIndex].uniforms );
-			free( scene->techniques[techniqueIndex].attributes );
-			free( scene->techniques[techniqueIndex].vertexAttributeLayout );
-			ksGpuGraphicsProgram_Destroy( context, &scene->techniques[techniqueIndex].program );
 		}
-		free( scene->techniques );
-		free( scene->techniqueNameHash );
-	}
-	{
-		for ( int materialIndex = 0; materialIndex < scene->materialCount; materialIndex++ )
+		else if ( job->cullSubTrees != NULL )
 		{
-			free( scene->materials[materialIndex].name );
-			free( scene->materials[materialIndex].values );
+			for ( int subTreeIndex = 0; subTreeIndex < job->count; subTreeIndex++ )
+			{
+				ksGltf_CullSubTree( jobs->scene, job->cullSubTrees[subTreeIndex], jobs->viewState, jobs->eye, &job->testedNodes, &job->culledNodes );
+			}
 		}
-		free( scene->materials );
-		free( scene->materialNameHash );
-	}
-	{
-		for ( int modelIndex = 0; modelIndex < scene->modelCount; modelIndex++ )
+		else if ( job->jointSkins != NULL )
 		{
-			for ( int surfaceIndex = 0; surfaceIndex < scene->models[modelIndex].surfaceCount; surfaceIndex++ )
+			for ( int skinIndex = 0; skinIndex < job->count; skinIndex++ )
 			{
-				ksGpuGeometry_Destroy( context, &scene->models[modelIndex].surfaces[surfaceIndex].geometry );
-				ksGpuGraphicsPipeline_Destroy( context, &scene->models[modelIndex].surfaces[surfaceIndex].pipeline );
+				ksGltf_UpdateSkinJoints( jobs->scene, job->jointSkins[skinIndex], job->joints[skinIndex] );
 			}
-			free( scene->models[modelIndex].name );
-			free( scene->models[modelIndex].surfaces );
 		}
-		free( scene->models );
-		free( scene->modelNameHash );
 	}
+}
+
+static ksGltfJob * ksGltf_AddJob( ksGltfJobs * jobs, const int first, const int total, const int jobSize )
+{
+	ksGltfJob * job = &jobs->jobs[jobs->jobCount++];
+	memset( job, 0, sizeof( ksGltfJob ) );
+	job->first = first;
+	job->count = ( total - first < jobSize ) ? total - first : jobSize;
+	return job;
+}
+
+static void ksGltf_RunJobs( ksGltfScene * scene )
+{
+	ksGltfJobs * jobs = &scene->jobs;
+	jobs->nextJob = 0;
+	if ( scene->useThreadPool && jobs->jobCount > 1 )
+	{
+		ksThreadPool_Submit( &scene->threadPool, ksGltf_JobThread, jobs );
+		ksThreadPool_Join( &scene->threadPool );
+	}
+	else
 	{
-		free( scene->timeLines );
-		free( scene->timeLineNameHash );
+		ksGltf_JobThread( jobs );
 	}
+	jobs->jobCount = 0;
+}
+
+// Collects each time line used by a visible sub-tree once in jobs->timeLines and returns the number of time lines.
+static int ksGltf_GetVisibleTimeLines( ksGltfScene * scene )
+{
+	ksGltfJobs * jobs = &scene->jobs;
+	const ksGltfSubScene * subScene = scene->state.currentSubScene;
+
+	memset( jobs->timeLineUsed, 0, scene->timeLineCount * sizeof( bool ) );
+
+	int timeLineCount = 0;
+	for ( int subTreeIndex = 0; subTreeIndex < subScene->subTreeCount; subTreeIndex++ )
 	{
-		for ( int animationIndex = 0; animationIndex < scene->animationCount; animationIndex++ )
+		const ksGltfSubTree * subTree = subScene->subTrees[subTreeIndex];
+		if ( !scene->state.subTreeState[(int)( subTree - scene->subTrees )].visible )
 		{
-			for ( int channelIndex = 0; channelIndex < scene->animations[animationIndex].channelCount; channelIndex++ )
+			continue;
+		}
+		for ( int timeLineIndex = 0; timeLineIndex < subTree->timeLineCount; timeLineIndex++ )
+		{
+			ksGltfTimeLine * timeLine = subTree->timeLines[timeLineIndex];
+			bool * used = &jobs->timeLineUsed[(int)( timeLine - scene->timeLines )];
+			if ( !*used )
 			{
-				free( scene->animations[animationIndex].channels[channelIndex].nodeName );
+				*used = true;
+				jobs->timeLines[timeLineCount++] = timeLine;
 			}
-			free( scene->animations[animationIndex].name );
-			free( scene->animations[animationIndex].channels );
 		}
-		free( scene->animations );
-		free( scene->animationNameHash );
 	}
+	return timeLineCount;
+}
+
+// Simulates the visible sub-trees on the worker threads. Each phase only starts after the previous phase completed.
+// Each job only writes to nodes that are not written by any other job in the same phase, and the jobs perform
+// exactly the same calculations as the serial path, so the results are identical.
+static void ksGltf_SimulateParallel( ksGltfScene * scene, const ksNanoseconds time )
+{
+	ksGltfJobs * jobs = &scene->jobs;
+	const ksGltfSubScene * subScene = scene->state.currentSubScene;
+
+	jobs->time = time;
+
+	// Get the current frame index and frame fraction for each time line used by a visible sub-tree.
+	const int timeLineCount = ksGltf_GetVisibleTimeLines( scene );
+	for ( int first = 0; first < timeLineCount; first += GLTF_JOB_SIZE )
+	{
+		ksGltfJob * job = ksGltf_AddJob( jobs, first, timeLineCount, GLTF_JOB_SIZE );
+		job->timeLines = jobs->timeLines + first;
+	}
+	ksGltf_RunJobs( scene );
+
+	// Apply the animation channels of these time lines in ranges of channels.
+	for ( int timeLineIndex = 0; timeLineIndex < timeLineCount; timeLineIndex++ )
 	{
-		for ( int skinIndex = 0; skinIndex < scene->skinCount; skinIndex++ )
+		const ksGltfTimeLine * timeLine = jobs->timeLines[timeLineIndex];
+		for ( int type = 0; type < GLTF_CHANNEL_MAX; type++ )
 		{
-			for ( int jointIndex = 0; jointIndex < scene->skins[skinIndex].jointCount; jointIndex++ )
+			const ksGltfChannelBlock * block = &timeLine->channelBlocks[type];
+			for ( int first = 0; first < block->channelCount; first += GLTF_JOB_SIZE )
 			{
-				free( scene->skins[skinIndex].joints[jointIndex].name );
+				ksGltfJob * job = ksGltf_AddJob( jobs, first, block->channelCount, GLTF_JOB_SIZE );
+				job->channelTimeLine = timeLine;
+				job->channelBlock = block;
 			}
-			free( scene->skins[skinIndex].name );
-			free( scene->skins[skinIndex].joints );
-			ksGpuBuffer_Destroy( context, &scene->skins[skinIndex].jointBuffer );
 		}
-		free( scene->skins );
-		free( scene->skinNameHash );
 	}
+	ksGltf_RunJobs( scene );
+
+	// Transform the node hierarchies into global space one breadth-first depth level at a time.
+	int levelCount = 0;
+	for ( int subTreeIndex = 0; subTreeIndex < subScene->subTreeCount; subTreeIndex++ )
 	{
-		for ( int cameraIndex = 0; cameraIndex < scene->cameraCount; cameraIndex++ )
+		const ksGltfSubTree * subTree = subScene->subTrees[subTreeIndex];
+		if ( subTree->levelCount > levelCount )
 		{
-			free( scene->cameras[cameraIndex].name );
+			levelCount = subTree->levelCount;
 		}
-		free( scene->cameras );
-		free( scene->cameraNameHash );
 	}
+	for ( int level = 0; level < levelCount; level++ )
 	{
-		for ( int nodeIndex = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
+		for ( int subTreeIndex = 0; subTreeIndex < subScene->subTreeCount; subTreeIndex++ )
 		{
-			for ( int childIndex = 0; childIndex < scene->nodes[nodeIndex].childCount; childIndex++ )
+			const ksGltfSubTree * subTree = subScene->subTrees[subTreeIndex];
+			if ( !scene->state.subTreeState[(int)( subTree - scene->subTrees )].visible || level >= subTree->levelCount )
 			{
-				free( scene->nodes[nodeIndex].childNames[childIndex] );
+				continue;
+			}
+			ksGltfNode ** levelNodes = subTree->nodes + subTree->levelOffsets[level];
+			const int levelNodeCount = subTree->levelOffsets[level + 1] - subTree->levelOffsets[level];
+			for ( int first = 0; first < levelNodeCount; first += GLTF_JOB_SIZE )
+			{
+				ksGltfJob * job = ksGltf_AddJob( jobs, first, levelNodeCount, GLTF_JOB_SIZE );
+				job->nodes = levelNodes + first;
 			}
-			free( scene->nodes[nodeIndex].name );
-			free( scene->nodes[nodeIndex].jointName );
-			free( scene->nodes[nodeIndex].children );
-			free( scene->nodes[nodeIndex].childNames );
-			free( scene->nodes[nodeIndex].models );
 		}
-		free( scene->nodes );
-		free( scene->nodeNameHash );
-		free( scene->nodeJointNameHash );
+		ksGltf_RunJobs( scene );
+	}
+}
+
+static int ksGltf_CompareProfileSamples( const void * a, const void * b )
+{
+	const ksNanoseconds sampleA = *(const ksNanoseconds *)a;
+	const ksNanoseconds sampleB = *(const ksNanoseconds *)b;
+	return ( sampleA < sampleB ) ? -1 : ( ( sampleA > sampleB ) ? 1 : 0 );
+}
+
+// Adds the time since 'startTime' to the samples of a phase and prints the percentiles once enough samples were taken.
+static void ksGltf_AddProfileSample( ksGltfProfile * profile, const ksGltfProfilePhase phase, const ksNanoseconds startTime )
+{
+#if GLTF_PROFILE_CPU == 1
+	static const char * phaseNames[GLTF_PROFILE_MAX] = { "simulate", "cull", "joints", "draw list" };
+
+	ksNanoseconds * samples = profile->samples[phase];
+	samples[profile->sampleCount[phase]++] = GetTimeNanoseconds() - startTime;
+	if ( profile->sampleCount[phase] < GLTF_PROFILE_SAMPLES )
+	{
+		return;
 	}
+	profile->sampleCount[phase] = 0;
+
+	qsort( samples, GLTF_PROFILE_SAMPLES, sizeof( samples[0] ), ksGltf_CompareProfileSamples );
+	Print( "%-10s p50 = %1.3f ms, p90 = %1.3f ms, p99 = %1.3f ms, max = %1.3f ms\n", phaseNames[phase],
+			samples[GLTF_PROFILE_SAMPLES * 50 / 100] * 1e-6f,
+			samples[GLTF_PROFILE_SAMPLES * 90 / 100] * 1e-6f,
+			samples[GLTF_PROFILE_SAMPLES * 99 / 100] * 1e-6f,
+			samples[GLTF_PROFILE_SAMPLES - 1] * 1e-6f );
+
+	if ( phase == GLTF_PROFILE_CULL )
 	{
-		for ( int subTreeIndex = 0; subTreeIndex < scene->subTreeCount; subTreeIndex++ )
+		Print( "%-10s visited = %d, tested = %d, culled = %d nodes per cull\n", phaseNames[phase],
+				profile->cullVisitedNodes / GLTF_PROFILE_SAMPLES,
+				profile->cullTestedNodes / GLTF_PROFILE_SAMPLES,
+				profile->cullCulledNodes / GLTF_PROFILE_SAMPLES );
+		profile->cullVisitedNodes = 0;
+		profile->cullTestedNodes = 0;
+		profile->cullCulledNodes = 0;
+	}
+	else if ( phase == GLTF_PROFILE_DRAW_LIST )
+	{
+		Print( "%-10s draws = %d, pipeline changes = %d, material changes = %d per draw list\n", phaseNames[phase],
+				profile->drawBatches / GLTF_PROFILE_SAMPLES,
+				profile->drawPipelineChanges / GLTF_PROFILE_SAMPLES,
+				profile->drawMaterialChanges / GLTF_PROFILE_SAMPLES );
+		profile->drawBatches = 0;
+		profile->drawPipelineChanges = 0;
+		profile->drawMaterialChanges = 0;
+	}
+#else
+	UNUSED_PARM( profile );
+	UNUSED_PARM( phase );
+	UNUSED_PARM( startTime );
+#endif
+}
+
+static void ksGltfScene_Simulate( ksGltfScene * scene, ksViewState * viewState, ksGpuWindowInput * input, const ksNanoseconds time )
+{
+	const ksNanoseconds simulateStartTime = GetTimeNanoseconds();
+
+	// Multi-view can be toggled while the scene is rendered, so the nodes are culled against the
+	// frusta of both eyes in any frame in which the commands for one eye are reused for the other eye.
+	scene->cullBothEyes = scene->newSettings->useMultiView;
+
+	if ( scene->simulateParallel )
+	{
+		ksGltf_SimulateParallel( scene, time );
+	}
+	else
+	{
+		// Sub-trees may share time lines, so each time line used by a visible sub-tree is only updated and applied once.
+		const int timeLineCount = ksGltf_GetVisibleTimeLines( scene );
+
+		// Get the current frame index and frame fraction for each time line.
+		for ( int timeLineIndex = 0; timeLineIndex < timeLineCount; timeLineIndex++ )
 		{
-			free( scene->subTrees[subTreeIndex].nodes );
-			free( scene->subTrees[subTreeIndex].timeLines );
-			free( scene->subTrees[subTreeIndex].animations );
+			ksGltf_UpdateTimeLineFrameState( scene, scene->jobs.timeLines[timeLineIndex], time );
+		}
+
+		// Apply the animation channels of each time line to the nodes in the hierarchy.
+		for ( int timeLineIndex = 0; timeLineIndex < timeLineCount; timeLineIndex++ )
+		{
+			ksGltf_ApplyTimeLineChannels( scene, scene->jobs.timeLines[timeLineIndex] );
+		}
+
+		// Transform the node hierarchies of all visible sub-trees into global space.
+		for ( int subTreeIndex = 0; subTreeIndex < scene->state.currentSubScene->subTreeCount; subTreeIndex++ )
+		{
+			ksGltfSubTree * subTree = scene->state.currentSubScene->subTrees[subTreeIndex];
+			if ( !scene->state.subTreeState[(int)( subTree - scene->subTrees )].visible )
+			{
+				continue;
+			}
+			ksGltf_TransformNodes( scene, subTree->nodes, subTree->nodeCount );
 		}
-		free( scene->subTrees );
 	}
+
+	ksGltf_AddProfileSample( &scene->profile, GLTF_PROFILE_SIMULATE, simulateStartTime );
+
+	// Find the first camera in the current sub-trees.
+	const ksGltfNode * cameraNode = NULL;
+	for ( int subTreeIndex = 0; subTreeIndex < scene->state.currentSubScene->subTreeCount && cameraNode == NULL; subTreeIndex++ )
 	{
-		for ( int subSceneIndex = 0; subSceneIndex < scene->subSceneCount; subSceneIndex++ )
+		ksGltfSubTree * subTree = scene->state.currentSubScene->subTrees[subTreeIndex];
+		if ( !scene->state.subTreeState[(int)( subTree - scene->subTrees )].visible )
 		{
-			free( scene->subScenes[subSceneIndex].subTrees );
+			continue;
+		}
+		for ( int nodeIndex = 0; nodeIndex < subTree->nodeCount; nodeIndex++ )
+		{
+			ksGltfNode * node = subTree->nodes[nodeIndex];
+			if ( node->camera != NULL )
+			{
+				cameraNode = node;
+				break;
+			}
 		}
-		free( scene->subScenes );
-		free( scene->subSceneNameHash );
 	}
 
-	ksGpuBuffer_Destroy( context, &scene->viewProjectionBuffer );
-	ksGpuBuffer_Destroy( context, &scene->defaultJointBuffer );
-	ksGpuGraphicsPipeline_Destroy( context, &scene->unitCubePipeline );
-	ksGpuGraphicsProgram_Destroy( context, &scene->unitCubeFlatShadeProgram );
-	ksGpuGeometry_Destroy( context, &scene->unitCubeGeometry );
+	// Use the camera if there is one, otherwise use input to move the view point.
+	if ( cameraNode != NULL )
+	{
+		GetHmdViewMatrixForTime( &viewState->displayViewMatrix, time );
 
-	memset( scene, 0, sizeof( ksGltfScene ) );
-}
+		ksMatrix4x4f cameraViewMatrix;
+		ksMatrix4x4f_Invert( &cameraViewMatrix, &scene->state.nodeState[(int)( cameraNode - scene->nodes )].globalTransform );
 
-static void ksGltfScene_SetSubScene( ksGltfScene * scene, const char * subSceneName )
-{
-	ksGltfSubScene * subScene = ksGltf_GetSubSceneByName( scene, subSceneName );
-	assert( subScene != NULL );
-	if ( subScene != NULL )
+		ksMatrix4x4f centerViewMatrix;
+		ksMatrix4x4f_Multiply( &centerViewMatrix, &viewState->displayViewMatrix, &cameraViewMatrix );
+
+		for ( int eye = 0; eye < NUM_EYES; eye++ )
+		{
+			ksMatrix4x4f eyeOffsetMatrix;
+			ksMatrix4x4f_CreateTranslation( &eyeOffsetMatrix, ( eye ? -0.5f : 0.5f ) * viewState->interpupillaryDistance, 0.0f, 0.0f );
+
+			ksMatrix4x4f_Multiply( &viewState->viewMatrix[eye], &eyeOffsetMatrix, &centerViewMatrix );
+			ksMatrix4x4f_CreateProjectionFov( &viewState->projectionMatrix[eye],
+											cameraNode->camera->perspective.fovDegreesX * 0.5f,
+											cameraNode->camera->perspective.fovDegreesX * 0.5f,
+											cameraNode->camera->perspective.fovDegreesY * 0.5f,
+											cameraNode->camera->perspective.fovDegreesY * 0.5f,
+											cameraNode->camera->perspective.nearZ, cameraNode->camera->perspective.farZ );
+
+			ksViewState_DerivedData( viewState, &centerViewMatrix );
+		}
+	}
+	else if ( input != NULL )
 	{
-		scene->state.currentSubScene = subScene;
+		ksViewState_HandleInput( viewState, input, time );
 	}
-}
-
-static void ksGltfScene_SetSubTreeVisible( ksGltfScene * scene, const char * subTreeName, const bool visible )
-{
-	ksGltfSubTree * subTree = ksGltf_GetSubTreeByName( scene, subTreeName );
-	assert( subTree != NULL );
-	if ( subTree != NULL )
+	else
 	{
-		scene->state.subTreeState[(int)( subTree - scene->subTrees )].visible = visible;
+		ksViewState_HandleHmd( viewState, time );
 	}
 }
 
-static void ksGltfScene_SetAnimationEnabled( ksGltfScene * scene, const char * animationName, const bool enabled )
+/*
+	The visible surfaces are collected into a draw list with a 64-bit state sort key per surface.
+	Opaque surfaces are sorted on pipeline rank, then material (textures and values), then model,
+	and then front-to-back depth. The pipeline rank is shared by all techniques with the same converted
+	program and raster operations, so techniques that only differ in their uniform values do not break
+	up runs of the same program and render state. Sorting on the model before the depth places all visible instances of
+	a surface next to each other, so they can be drawn with a single instanced draw call.
+	Translucent surfaces are drawn after all opaque surfaces, sorted back-to-front.
+
+	Opaque key:			[63] 0 | [62:48] pipeline rank | [47:32] material | [31:16] model | [15:0] depth
+	Translucent key:	[63] 1 | [62:47] inverted depth | [46:32] pipeline rank | [31:16] material
+
+	When the pipeline ranks, materials or models of a scene do not fit in their fields, the scene
+	falls back to keys without state, and the stable sort keeps opaque surfaces in hierarchy order:
+
+	Fallback opaque key:		[63] 0 | [62:0] 0
+	Fallback translucent key:	[63] 1 | [62:47] inverted depth | [46:0] 0
+
+	The squared distance is a positive float, which sorts like an integer,
+	so the upper 16 bits of the float are used as a coarse depth.
+*/
+static uint64_t ksGltf_GetDrawKey( const bool sortOnState, const bool translucent, const int pipelineRank, const int material, const int model, const float distanceSquared )
 {
-	ksGltfAnimation * animation = ksGltf_GetAnimationByName( scene, animationName );
-	assert( animation != NULL );
-	if ( animation != NULL )
+	union
 	{
-		UNUSED_PARM( enabled );
-	}
-}
+		float		f;
+		uint32_t	u;
+	} depth;
+	depth.f = distanceSquared;
+	const uint64_t depthBits = ( depth.u >> 16 ) & 0xFFFF;
 
-static void ksGltfScene_SetNodeTranslation( ksGltfScene * scene, const char * nodeName, const ksVector3f * translation )
-{
-	ksGltfNode * node = ksGltf_GetNodeByName( scene, nodeName );
-	assert( node != NULL );
-	if ( node != NULL )
+	if ( !sortOnState )
 	{
-		scene->state.nodeState[(int)( node - scene->nodes )].translation = *translation;
+		return ( translucent ) ? ( (uint64_t)1 << 63 ) | ( ( 0xFFFF - depthBits ) << 47 ) : 0;
 	}
-}
 
-static void ksGltfScene_SetNodeRotation( ksGltfScene * scene, const char * nodeName, const ksQuatf * rotation )
-{
-	ksGltfNode * node = ksGltf_GetNodeByName( scene, nodeName );
-	assert( node != NULL );
-	if ( node != NULL )
+	assert( pipelineRank >= 0 && pipelineRank < GLTF_DRAW_KEY_MAX_PIPELINE_RANKS );
+	assert( material >= 0 && material < GLTF_DRAW_KEY_MAX_MATERIALS );
+	assert( model >= 0 && model < GLTF_DRAW_KEY_MAX_MODELS );
+
+	if ( !translucent )
 	{
-		scene->state.nodeState[(int)( node - scene->nodes )].rotation = *rotation;
+		return	( (uint64_t)pipelineRank << 48 ) |
+				( (uint64_t)material << 32 ) |
+				( (uint64_t)model << 16 ) |
+				depthBits;
 	}
+	return	( (uint64_t)1 << 63 ) |
+			( ( 0xFFFF - depthBits ) << 47 ) |
+			( (uint64_t)pipelineRank << 32 ) |
+			( (uint64_t)material << 16 );
 }
 
-static void ksGltfScene_SetNodeScale( ksGltfScene * scene, const char * nodeName, const ksVector3f * scale )
+// Collects the visible surfaces of the current sub-trees with their transforms and sort keys.
+// This only touches CPU memory.
+static void ksGltf_BuildDrawList( ksGltfScene * scene, const ksViewState * viewState )
 {
-	ksGltfNode * node = ksGltf_GetNodeByName( scene, nodeName );
-	assert( node != NULL );
-	if ( node != NULL )
+	ksGltfDrawList * drawList = &scene->drawList;
+	drawList->transformCount = 0;
+	drawList->surfaceCount = 0;
+
+	ksVector3f viewPosition = { 0.0f, 0.0f, 0.0f };
+	for ( int eye = 0; eye < NUM_EYES; eye++ )
 	{
-		scene->state.nodeState[(int)( node - scene->nodes )].scale = *scale;
+		viewPosition.x += viewState->viewInverseMatrix[eye].m[3][0] * ( 1.0f / NUM_EYES );
+		viewPosition.y += viewState->viewInverseMatrix[eye].m[3][1] * ( 1.0f / NUM_EYES );
+		viewPosition.z += viewState->viewInverseMatrix[eye].m[3][2] * ( 1.0f / NUM_EYES );
 	}
-}
-
-static void ksGltfScene_Simulate( ksGltfScene * scene, ksViewState * viewState, ksGpuWindowInput * input, const ksNanoseconds time )
-{
-	const ksGltfNode * cameraNode = NULL;
 
-	// Go through all current sub-trees.
 	for ( int subTreeIndex = 0; subTreeIndex < scene->state.currentSubScene->subTreeCount; subTreeIndex++ )
 	{
 		ksGltfSubTree * subTree = scene->state.currentSubScene->subTrees[subTreeIndex];
@@ -5013,130 +9193,225 @@ static void ksGltfScene_Simulate( ksGltfScene * scene, ksViewState * viewState,
 			continue;
 		}
 
-		// Get the current frame index and frame fraction for each time line.
-		for ( int timeLineIndex = 0; timeLineIndex < subTree->timeLineCount; timeLineIndex++ )
+		for ( int nodeIndex = 0; nodeIndex < subTree->nodeCount; nodeIndex++ )
 		{
-			ksGltfTimeLine * timeLine = subTree->timeLines[timeLineIndex];
-			const float timeInSeconds = fmodf( time * 1e-9f, timeLine->duration );
-			int frame = 0;
-			if ( timeLine->rcpStep != 0.0f )
+			ksGltfNode * node = subTree->nodes[nodeIndex];
+			if ( node->modelCount == 0 || scene->state.nodeState[(int)( node - scene->nodes )].culled )
 			{
-				// Use direct lookup if this is a fixed rate animation.
-				frame = (int)( timeInSeconds * timeLine->rcpStep );
+				continue;
 			}
-			else
+
+			const ksGltfSkin * skin = node->skin;
+			if ( skin != NULL && scene->state.skinCullingState[(int)( skin - scene->skins )].culled )
 			{
-				// Use a binary search to find the key frame.
-				for ( int sampleCount = timeLine->sampleCount; sampleCount > 1; sampleCount >>= 1 )
-				{
-					const int mid = sampleCount >> 1;
-					if ( timeInSeconds >= timeLine->sampleTimes[frame + mid] )
-					{
-						frame += mid;
-						sampleCount = ( sampleCount - mid ) * 2;
-					}
-				}
+				continue;
 			}
-			assert( timeInSeconds >= timeLine->sampleTimes[frame] && timeInSeconds < timeLine->sampleTimes[frame + 1] );
-			scene->state.timeLineFrameState[timeLineIndex].frame = frame;
-			scene->state.timeLineFrameState[timeLineIndex].fraction = ( timeInSeconds - timeLine->sampleTimes[frame] ) / ( timeLine->sampleTimes[frame + 1] - timeLine->sampleTimes[frame] );
-		}
 
-		// Apply animations to the nodes in the hierarchy.
-		for ( int animIndex = 0; animIndex < subTree->animationCount; animIndex++ )
-		{
-			const ksGltfAnimation * animation = subTree->animations[animIndex];
+			const ksGltfNode * parentNode = ( skin != NULL ) ? skin->parentNode : node;
+			const ksGltfNodeState * parentNodeState = &scene->state.nodeState[(int)( parentNode - scene->nodes )];
 
-			const int timeLineIndex = (int)( animation->timeLine - scene->timeLines );
-			const int frame = scene->state.timeLineFrameState[timeLineIndex].frame;
-			const float fraction = scene->state.timeLineFrameState[timeLineIndex].fraction;
+			const int transformIndex = drawList->transformCount++;
+			ksGltfDrawTransform * transform = &drawList->transforms[transformIndex];
+			transform->localMatrix = &parentNodeState->localTransform;
+			transform->modelMatrix = &parentNodeState->globalTransform;
+			ksMatrix4x4f_Invert( &transform->modelInverseMatrix, &parentNodeState->globalTransform );
+			transform->jointBuffer = ( skin != NULL ) ? skin->jointBinding : &scene->defaultJointBuffer;
+			transform->skin = skin;
 
-			for ( int channelIndex = 0; channelIndex < animation->channelCount; channelIndex++ )
+			ksMatrix4x4f modelViewProjectionCullMatrix;
+			ksMatrix4x4f_Multiply( &modelViewProjectionCullMatrix, &viewState->combinedViewProjectionMatrix, transform->modelMatrix );
+
+			for ( int modelIndex = 0; modelIndex < node->modelCount; modelIndex++ )
 			{
-				const ksGltfAnimationChannel * channel = &animation->channels[channelIndex];
-				ksGltfNodeState * nodeState = &scene->state.nodeState[(int)( channel->node - scene->nodes )];
-				if ( channel->translation != NULL )
-				{
-					ksVector3f_Lerp( &nodeState->translation, &channel->translation[frame], &channel->translation[frame + 1], fraction );
-				}
-				if ( channel->rotation != NULL )
+				ksGltfModel * model = node->models[modelIndex];
+
+				if ( skin == NULL && ksMatrix4x4f_CullBounds( &modelViewProjectionCullMatrix, &model->mins, &model->maxs ) )
 				{
-					ksQuatf_Lerp( &nodeState->rotation, &channel->rotation[frame], &channel->rotation[frame + 1], fraction );
+					continue;
 				}
-				if ( channel->scale != NULL )
+
+				for ( int surfaceIndex = 0; surfaceIndex < model->surfaceCount; surfaceIndex++ )
 				{
-					ksVector3f_Lerp( &nodeState->scale, &channel->scale[frame], &channel->scale[frame + 1], fraction );
+					ksGltfSurface * surface = &model->surfaces[surfaceIndex];
+
+					if ( skin == NULL && model->surfaceCount > 1 && ksMatrix4x4f_CullBounds( &modelViewProjectionCullMatrix, &surface->mins, &surface->maxs ) )
+					{
+						continue;
+					}
+
+					ksVector3f localCenter;
+					ksVector3f_Lerp( &localCenter, &surface->mins, &surface->maxs, 0.5f );
+					ksVector3f center;
+					ksMatrix4x4f_TransformVector3f( &center, transform->modelMatrix, &localCenter );
+					ksVector3f delta;
+					ksVector3f_Sub( &delta, &center, &viewPosition );
+					const float distanceSquared = delta.x * delta.x + delta.y * delta.y + delta.z * delta.z;
+
+					const ksGltfMaterial * material = surface->material;
+					const int drawIndex = drawList->surfaceCount++;
+					drawList->surfaces[drawIndex].surface = surface;
+					drawList->surfaces[drawIndex].transform = transformIndex;
+					drawList->keys[drawIndex] = ksGltf_GetDrawKey( drawList->sortOnState,
+																	material->technique->rop.blendEnable,
+																	material->technique->pipelineRank,
+																	(int)( material - scene->materials ),
+																	(int)( model - scene->models ),
+																	distanceSquared );
+					drawList->order[drawIndex] = drawIndex;
 				}
 			}
 		}
+	}
+}
 
-		// Transform the node hierarchy into global space.
-		for ( int nodeIndex = 0; nodeIndex < subTree->nodeCount; nodeIndex++ )
+// Sorts the draw list on the sort keys with a stable least significant digit radix sort.
+// Passes over digits that are the same for all keys are skipped.
+static void ksGltf_SortDrawList( ksGltfDrawList * drawList )
+{
+	const int count = drawList->surfaceCount;
+	if ( count <= 1 )
+	{
+		return;
+	}
+
+	uint64_t * keys = drawList->keys;
+	int * order = drawList->order;
+	uint64_t * sortKeys = drawList->sortKeys;
+	int * sortOrder = drawList->sortOrder;
+
+	for ( int shift = 0; shift < 64; shift += 8 )
+	{
+		int offsets[256] = { 0 };
+		for ( int i = 0; i < count; i++ )
+		{
+			offsets[( keys[i] >> shift ) & 0xFF]++;
+		}
+		if ( offsets[( keys[0] >> shift ) & 0xFF] == count )
+		{
+			continue;
+		}
+		for ( int digit = 0, total = 0; digit < 256; digit++ )
+		{
+			const int digitCount = offsets[digit];
+			offsets[digit] = total;
+			total += digitCount;
+		}
+		for ( int i = 0; i < count; i++ )
 		{
-			ksGltfNodeState * nodeState = &scene->state.nodeState[(int)( subTree->nodes[nodeIndex] - scene->nodes )];
+			const int index = offsets[( keys[i] >> shift ) & 0xFF]++;
+			sortKeys[index] = keys[i];
+			sortOrder[index] = order[i];
+		}
 
-			ksMatrix4x4f_CreateTranslationRotationScale( &nodeState->localTransform, &nodeState->translation, &nodeState->rotation, &nodeState->scale );
-			if ( nodeState->parent != NULL )
-			{
-				assert( nodeState->parent < nodeState );
-				ksMatrix4x4f_Multiply( &nodeState->globalTransform, &nodeState->parent->globalTransform, &nodeState->localTransform );
-			}
-			else
+		uint64_t * tempKeys = keys;
+		keys = sortKeys;
+		sortKeys = tempKeys;
+		int * tempOrder = order;
+		order = sortOrder;
+		sortOrder = tempOrder;
+	}
+
+	if ( keys != drawList->keys )
+	{
+		memcpy( drawList->keys, keys, count * sizeof( uint64_t ) );
+		memcpy( drawList->order, order, count * sizeof( int ) );
+	}
+}
+
+// Merges runs of the same opaque surface in the sorted draw list into instanced draw batches.
+// Translucent surfaces are always drawn one at a time to keep the back-to-front order.
+// Also counts the pipeline and material changes between consecutive batches.
+static void ksGltf_BuildDrawBatches( ksGltfDrawList * drawList )
+{
+	drawList->batchCount = 0;
+	drawList->pipelineChanges = 0;
+	drawList->materialChanges = 0;
+	const ksGltfSurface * previousSurface = NULL;
+	for ( int drawIndex = 0; drawIndex < drawList->surfaceCount; )
+	{
+		const ksGltfSurface * surface = drawList->surfaces[drawList->order[drawIndex]].surface;
+		int count = 1;
+		if ( surface->geometry.instanceCount > 0 && ( drawList->keys[drawIndex] >> 63 ) == 0 )
+		{
+			while ( drawIndex + count < drawList->surfaceCount &&
+					count < surface->geometry.instanceCount &&
+					drawList->surfaces[drawList->order[drawIndex + count]].surface == surface )
 			{
-				nodeState->globalTransform = nodeState->localTransform;
+				count++;
 			}
 		}
 
-		// Find a camera if no camera has been found yet.
-		if ( cameraNode == NULL )
+		ksGltfDrawBatch * batch = &drawList->batches[drawList->batchCount++];
+		batch->first = drawIndex;
+		batch->count = count;
+		drawIndex += count;
+
+		if ( previousSurface == NULL || previousSurface->material->technique->pipelineRank != surface->material->technique->pipelineRank )
 		{
-			for ( int nodeIndex = 0; nodeIndex < subTree->nodeCount; nodeIndex++ )
-			{
-				ksGltfNode * node = subTree->nodes[nodeIndex];
-				if ( node->camera != NULL )
-				{
-					cameraNode = node;
-					break;
-				}
-			}
+			drawList->pipelineChanges++;
 		}
+		if ( previousSurface == NULL || previousSurface->material != surface->material )
+		{
+			drawList->materialChanges++;
+		}
+		previousSurface = surface;
 	}
+}
 
-	// Use the camera if there is one, otherwise use input to move the view point.
-	if ( cameraNode != NULL )
+// Writes the model matrices, and the inverse model matrices if used, of the instanced draw batches into the instance buffers of the surfaces.
+static void ksGltf_UpdateInstanceBuffers( ksGpuCommandBuffer * commandBuffer, ksGltfDrawList * drawList )
+{
+	for ( int batchIndex = 0; batchIndex < drawList->batchCount; batchIndex++ )
 	{
-		GetHmdViewMatrixForTime( &viewState->displayViewMatrix, time );
-
-		ksMatrix4x4f cameraViewMatrix;
-		ksMatrix4x4f_Invert( &cameraViewMatrix, &scene->state.nodeState[(int)( cameraNode - scene->nodes )].globalTransform );
-
-		ksMatrix4x4f centerViewMatrix;
-		ksMatrix4x4f_Multiply( &centerViewMatrix, &viewState->displayViewMatrix, &cameraViewMatrix );
-
-		for ( int eye = 0; eye < NUM_EYES; eye++ )
+		const ksGltfDrawBatch * batch = &drawList->batches[batchIndex];
+		if ( batch->count <= 1 )
 		{
-			ksMatrix4x4f eyeOffsetMatrix;
-			ksMatrix4x4f_CreateTranslation( &eyeOffsetMatrix, ( eye ? -0.5f : 0.5f ) * viewState->interpupillaryDistance, 0.0f, 0.0f );
+			continue;
+		}
 
-			ksMatrix4x4f_Multiply( &viewState->viewMatrix[eye], &eyeOffsetMatrix, &centerViewMatrix );
-			ksMatrix4x4f_CreateProjectionFov( &viewState->projectionMatrix[eye],
-											cameraNode->camera->perspective.fovDegreesX * 0.5f,
-											cameraNode->camera->perspective.fovDegreesX * 0.5f,
-											cameraNode->camera->perspective.fovDegreesY * 0.5f,
-											cameraNode->camera->perspective.fovDegreesY * 0.5f,
-											cameraNode->camera->perspective.nearZ, cameraNode->camera->perspective.farZ );
+		ksGltfSurface * surface = drawList->surfaces[drawList->order[batch->first]].surface;
 
-			ksViewState_DerivedData( viewState, &centerViewMatrix );
+		ksDefaultVertexAttributeArrays attribs;
+		ksGpuBuffer * mappedInstanceBuffer = ksGpuCommandBuffer_MapInstanceAttributes( commandBuffer, &surface->geometry, &attribs.base );
+		for ( int instanceIndex = 0; instanceIndex < batch->count; instanceIndex++ )
+		{
+			const ksGltfDrawSurface * drawSurface = &drawList->surfaces[drawList->order[batch->first + instanceIndex]];
+			attribs.transform[instanceIndex] = *drawList->transforms[drawSurface->transform].modelMatrix;
 		}
+		if ( ( surface->geometry.instanceAttribsFlags & VERTEX_ATTRIBUTE_FLAG_TRANSFORM_INVERSE ) != 0 )
+		{
+			for ( int instanceIndex = 0; instanceIndex < batch->count; instanceIndex++ )
+			{
+				const ksGltfDrawSurface * drawSurface = &drawList->surfaces[drawList->order[batch->first + instanceIndex]];
+				attribs.transformInverse[instanceIndex] = drawList->transforms[drawSurface->transform].modelInverseMatrix;
+			}
+		}
+		ksGpuCommandBuffer_UnmapInstanceAttributes( commandBuffer, &surface->geometry, mappedInstanceBuffer, KS_GPU_BUFFER_UNMAP_TYPE_COPY_BACK );
 	}
-	else if ( input != NULL )
-	{
-		ksViewState_HandleInput( viewState, input, time );
-	}
-	else
+}
+
+// Writes an indirect draw command for each draw batch. The commands are written to a newly allocated host visible buffer
+// because the copy back of a mapped buffer is not synchronized with reading the indirect draw commands.
+static void ksGltf_UpdateIndirectBuffer( ksGpuCommandBuffer * commandBuffer, ksGltfScene * scene )
+{
+	ksGltfDrawList * drawList = &scene->drawList;
+
+	ksGpuDrawIndirectCommand * commands = NULL;
+	ksGpuBuffer * mappedIndirectBuffer = ksGpuCommandBuffer_MapBuffer( commandBuffer, &scene->indirectBuffer, (void **)&commands );
+	for ( int batchIndex = 0; batchIndex < drawList->batchCount; batchIndex++ )
 	{
-		ksViewState_HandleHmd( viewState, time );
+		const ksGltfDrawBatch * batch = &drawList->batches[batchIndex];
+		const ksGltfSurface * surface = drawList->surfaces[drawList->order[batch->first]].surface;
+
+		commands[batchIndex].indexCount = surface->geometry.indexCount;
+		commands[batchIndex].instanceCount = batch->count;
+		commands[batchIndex].firstIndex = 0;
+		commands[batchIndex].vertexOffset = 0;
+		commands[batchIndex].firstInstance = 0;
 	}
+	ksGpuCommandBuffer_UnmapBuffer( commandBuffer, &scene->indirectBuffer, mappedIndirectBuffer, KS_GPU_BUFFER_UNMAP_TYPE_USE_ALLOCATED );
+
+	drawList->indirectBuffer = mappedIndirectBuffer;
 }
 
 static void ksGltfScene_UpdateBuffers( ksGpuCommandBuffer * commandBuffer, ksGltfScene * scene, const ksViewState * viewState, const int eye )
@@ -5149,9 +9424,23 @@ static void ksGltfScene_UpdateBuffers( ksGpuCommandBuffer * commandBuffer, ksGlt
 	memcpy( matrices + 1 * count, &viewState->viewInverseMatrix[eye], count * sizeof( ksMatrix4x4f ) );
 	memcpy( matrices + 2 * count, &viewState->projectionMatrix[eye], count * sizeof( ksMatrix4x4f ) );
 	memcpy( matrices + 3 * count, &viewState->projectionInverseMatrix[eye], count * sizeof( ksMatrix4x4f ) );
-	ksGpuCommandBuffer_UnmapBuffer( commandBuffer, &scene->viewProjectionBuffer, mappedViewProjectionBuffer, KS_GPU_BUFFER_UNMAP_TYPE_COPY_BACK );
 
-	// Cull skins and update any joint uniform buffers of skins that are not culled.
+	// The mapped memory is bound directly, unless the commands recorded for one eye are also used for the other
+	// eye, in which case each eye copies its matrices back to the buffers that are bound by the recorded commands.
+	const ksGpuBufferUnmapType unmapType = scene->cullBothEyes ? KS_GPU_BUFFER_UNMAP_TYPE_COPY_BACK : KS_GPU_BUFFER_UNMAP_TYPE_USE_ALLOCATED;
+	ksGpuCommandBuffer_UnmapBuffer( commandBuffer, &scene->viewProjectionBuffer, mappedViewProjectionBuffer, unmapType );
+	scene->drawList.viewProjectionBuffer = ( unmapType == KS_GPU_BUFFER_UNMAP_TYPE_USE_ALLOCATED ) ? mappedViewProjectionBuffer : &scene->viewProjectionBuffer;
+
+	ksGltfJobs * jobs = &scene->jobs;
+	jobs->viewState = viewState;
+	jobs->eye = eye;
+
+	const ksNanoseconds cullStartTime = GetTimeNanoseconds();
+
+	// Gather the visible sub-trees and their skins.
+	memset( jobs->skinUsed, 0, scene->skinCount * sizeof( bool ) );
+	int subTreeCount = 0;
+	int skinCount = 0;
 	for ( int subTreeIndex = 0; subTreeIndex < scene->state.currentSubScene->subTreeCount; subTreeIndex++ )
 	{
 		ksGltfSubTree * subTree = scene->state.currentSubScene->subTrees[subTreeIndex];
@@ -5160,68 +9449,102 @@ static void ksGltfScene_UpdateBuffers( ksGpuCommandBuffer * commandBuffer, ksGlt
 			continue;
 		}
 
+		jobs->subTrees[subTreeCount++] = subTree;
+		scene->profile.cullVisitedNodes += subTree->nodeCount;
+
 		for ( int nodeIndex = 0; nodeIndex < subTree->nodeCount; nodeIndex++ )
 		{
-			ksGltfNode * node = subTree->nodes[nodeIndex];
-			ksGltfSkin * skin = node->skin;
-			if ( skin == NULL )
+			ksGltfSkin * skin = subTree->nodes[nodeIndex]->skin;
+			if ( skin != NULL && !jobs->skinUsed[(int)( skin - scene->skins )] )
 			{
-				continue;
+				jobs->skinUsed[(int)( skin - scene->skins )] = true;
+				jobs->skins[skinCount++] = skin;
 			}
+		}
+	}
 
-			const ksGltfNodeState * parentNodeState = &scene->state.nodeState[(int)( skin->parentNode - scene->nodes )];
+	// Cull the skins.
+	for ( int first = 0; first < skinCount; first += GLTF_SKIN_JOB_SIZE )
+	{
+		ksGltfJob * job = ksGltf_AddJob( jobs, first, skinCount, GLTF_SKIN_JOB_SIZE );
+		job->cullSkins = jobs->skins + first;
+	}
+	ksGltf_RunJobs( scene );
 
-			// Exclude the transform of the whole skeleton because that transform will be
-			// passed down the vertex shader as the model matrix.
-			ksMatrix4x4f inverseGlobalSkeletonTransfom;
-			ksMatrix4x4f_Invert( &inverseGlobalSkeletonTransfom, &parentNodeState->globalTransform );
+	// Cull the nodes hierarchically. A sub-tree only writes the state of its own nodes, so the sub-trees
+	// are culled in parallel in jobs of consecutive sub-trees with at least GLTF_JOB_SIZE nodes.
+	for ( int first = 0; first < subTreeCount; )
+	{
+		int last = first;
+		for ( int jobNodeCount = 0; last < subTreeCount && jobNodeCount < GLTF_JOB_SIZE; last++ )
+		{
+			jobNodeCount += jobs->subTrees[last]->nodeCount;
+		}
+		ksGltfJob * job = ksGltf_AddJob( jobs, first, subTreeCount, last - first );
+		job->cullSubTrees = jobs->subTrees + first;
+		first = last;
+	}
+	const int cullJobCount = jobs->jobCount;
+	ksGltf_RunJobs( scene );
 
-			// Calculate the skin bounds.
-			if ( skin->jointGeometryMins != NULL && skin->jointGeometryMaxs != NULL )
-			{
-				ksGltfSkinCullingState * skinCullingState = &scene->state.skinCullingState[(int)( skin - scene->skins )];
+	for ( int jobIndex = 0; jobIndex < cullJobCount; jobIndex++ )
+	{
+		scene->profile.cullTestedNodes += jobs->jobs[jobIndex].testedNodes;
+		scene->profile.cullCulledNodes += jobs->jobs[jobIndex].culledNodes;
+	}
 
-				for ( int jointIndex = 0; jointIndex < skin->jointCount; jointIndex++ )
-				{
-					const ksGltfNodeState * jointNodeState = &scene->state.nodeState[(int)( skin->joints[jointIndex].node - scene->nodes )];
+	ksGltf_AddProfileSample( &scene->profile, GLTF_PROFILE_CULL, cullStartTime );
+	const ksNanoseconds jointsStartTime = GetTimeNanoseconds();
 
-					ksMatrix4x4f localJointTransform;
-					ksMatrix4x4f_Multiply( &localJointTransform, &inverseGlobalSkeletonTransfom, &jointNodeState->globalTransform );
+	// Map the joint uniform buffers of the skins that are not culled on this thread.
+	int jointSkinCount = 0;
+	for ( int skinIndex = 0; skinIndex < skinCount; skinIndex++ )
+	{
+		ksGltfSkin * skin = jobs->skins[skinIndex];
+		if ( !scene->state.skinCullingState[(int)( skin - scene->skins )].culled )
+		{
+			jobs->skins[jointSkinCount] = skin;
+			jobs->mappedJointBuffers[jointSkinCount] = ksGpuCommandBuffer_MapBuffer( commandBuffer, &skin->jointBuffer, (void **)&jobs->skinJoints[jointSkinCount] );
+			jointSkinCount++;
+		}
+	}
 
-					ksVector3f jointMins;
-					ksVector3f jointMaxs;
-					ksMatrix4x4f_TransformBounds( &jointMins, &jointMaxs, &localJointTransform, &skin->jointGeometryMins[jointIndex], &skin->jointGeometryMaxs[jointIndex] );
-					ksVector3f_Min( &skinCullingState->mins, &skin->mins, &jointMins );
-					ksVector3f_Max( &skinCullingState->maxs, &skin->maxs, &jointMaxs );
-				}
+	// Calculate the joint matrices straight into the mapped memory.
+	for ( int first = 0; first < jointSkinCount; first += GLTF_SKIN_JOB_SIZE )
+	{
+		ksGltfJob * job = ksGltf_AddJob( jobs, first, jointSkinCount, GLTF_SKIN_JOB_SIZE );
+		job->jointSkins = jobs->skins + first;
+		job->joints = jobs->skinJoints + first;
+	}
+	ksGltf_RunJobs( scene );
 
-				// Do not update the joint buffer if the skin bounds are culled.
-				ksMatrix4x4f modelViewProjectionCullMatrix;
-				ksMatrix4x4f_Multiply( &modelViewProjectionCullMatrix, &viewState->combinedViewProjectionMatrix, &parentNodeState->globalTransform );
+	for ( int skinIndex = 0; skinIndex < jointSkinCount; skinIndex++ )
+	{
+		ksGltfSkin * skin = jobs->skins[skinIndex];
+		ksGpuCommandBuffer_UnmapBuffer( commandBuffer, &skin->jointBuffer, jobs->mappedJointBuffers[skinIndex], unmapType );
+		skin->jointBinding = ( unmapType == KS_GPU_BUFFER_UNMAP_TYPE_USE_ALLOCATED ) ? jobs->mappedJointBuffers[skinIndex] : &skin->jointBuffer;
+	}
 
-				skinCullingState->culled = ksMatrix4x4f_CullBounds( &modelViewProjectionCullMatrix, &skin->mins, &skin->maxs );
-				if ( skinCullingState->culled )
-				{
-					continue;
-				}
-			}
+	ksGltf_AddProfileSample( &scene->profile, GLTF_PROFILE_JOINTS, jointsStartTime );
+	const ksNanoseconds drawListStartTime = GetTimeNanoseconds();
 
-			// Update the skin joint buffer.
-			ksMatrix4x4f * joints = NULL;
-			ksGpuBuffer * mappedJointBuffer = ksGpuCommandBuffer_MapBuffer( commandBuffer, &skin->jointBuffer, (void **)&joints );
+	// Collect and sort the visible surfaces, and update the instance buffers outside the render pass.
+	ksGltf_BuildDrawList( scene, viewState );
+	ksGltf_SortDrawList( &scene->drawList );
+	ksGltf_BuildDrawBatches( &scene->drawList );
+	ksGltf_UpdateInstanceBuffers( commandBuffer, &scene->drawList );
 
-			for ( int jointIndex = 0; jointIndex < skin->jointCount; jointIndex++ )
-			{
-				const ksGltfNodeState * jointNodeState = &scene->state.nodeState[(int)( skin->joints[jointIndex].node - scene->nodes )];
+	scene->drawList.indirectBuffer = NULL;
+	if ( scene->drawIndirect && scene->newSettings->useIndirect )
+	{
+		ksGltf_UpdateIndirectBuffer( commandBuffer, scene );
+	}
 
-				ksMatrix4x4f localJointTransform;
-				ksMatrix4x4f_Multiply( &localJointTransform, &inverseGlobalSkeletonTransfom, &jointNodeState->globalTransform );
-				ksMatrix4x4f_Multiply( &joints[jointIndex], &localJointTransform, &skin->inverseBindMatrices[jointIndex] );
-			}
+	scene->profile.drawBatches += scene->drawList.batchCount;
+	scene->profile.drawPipelineChanges += scene->drawList.pipelineChanges;
+	scene->profile.drawMaterialChanges += scene->drawList.materialChanges;
 
-			ksGpuCommandBuffer_UnmapBuffer( commandBuffer, &skin->jointBuffer, mappedJointBuffer, KS_GPU_BUFFER_UNMAP_TYPE_COPY_BACK );
-		}
-	}
+	ksGltf_AddProfileSample( &scene->profile, GLTF_PROFILE_DRAW_LIST, drawListStartTime );
 }
 
 static void ksGltfScene_SetUniformValue( ksGpuGraphicsCommand * command, const ksGltfUniform * uniform, const ksGltfUniformValue * value )
@@ -5250,141 +9573,98 @@ static void ksGltfScene_SetUniformValue( ksGpuGraphicsCommand * command, const k
 	}
 }
 
-static void ksGltfScene_Render( ksGpuCommandBuffer * commandBuffer, const ksGltfScene * scene, const ksViewState * viewState )
+// Renders part 'part' of 'partCount' equally sized parts of the draw batches.
+static void ksGltfScene_RenderPart( ksGpuCommandBuffer * commandBuffer, const ksGltfScene * scene, const ksViewState * viewState, const int part, const int partCount )
 {
+	assert( part >= 0 && part < partCount );
+
 	ksVector4f viewport;
 	viewport.x = 0.0f;
 	viewport.y = 0.0f;
 	viewport.z = 1.0f;
 	viewport.w = 1.0f;
 
-	for ( int subTreeIndex = 0; subTreeIndex < scene->state.currentSubScene->subTreeCount; subTreeIndex++ )
-	{
-		ksGltfSubTree * subTree = scene->state.currentSubScene->subTrees[subTreeIndex];
-		if ( !scene->state.subTreeState[(int)( subTree - scene->subTrees )].visible )
-		{
-			continue;
-		}
+	ksMatrix4x4f identity;
+	ksMatrix4x4f_CreateIdentity( &identity );
 
-		for ( int nodeIndex = 0; nodeIndex < subTree->nodeCount; nodeIndex++ )
+	const ksGltfDrawList * drawList = &scene->drawList;
+
+	bool showSkinBounds = false;
+	if ( showSkinBounds && part == 0 )
+	{
+		for ( int transformIndex = 0; transformIndex < drawList->transformCount; transformIndex++ )
 		{
-			ksGltfNode * node = subTree->nodes[nodeIndex];
-			if ( node->modelCount == 0 )
+			const ksGltfDrawTransform * transform = &drawList->transforms[transformIndex];
+			if ( transform->skin == NULL )
 			{
 				continue;
 			}
 
-			const ksGltfSkin * skin = node->skin;
-			const ksGltfNode * parentNode = ( skin != NULL ) ? skin->parentNode : node;
-			const int parentNodeIndex = (int)( parentNode - scene->nodes );
-
-			ksMatrix4x4f localMatrix = scene->state.nodeState[parentNodeIndex].localTransform;
-			ksMatrix4x4f modelMatrix = scene->state.nodeState[parentNodeIndex].globalTransform;
-			ksMatrix4x4f modelInverseMatrix;
-			ksMatrix4x4f_Invert( &modelInverseMatrix, &modelMatrix );
-
-			if ( skin != NULL )
-			{
-				const ksGltfSkinCullingState * skinCullingState = &scene->state.skinCullingState[(int)( skin - scene->skins )];
-
-				bool showSkinBounds = false;
-				if ( showSkinBounds )
-				{
-					ksMatrix4x4f unitCubeMatrix;
-					ksMatrix4x4f_CreateOffsetScaleForBounds( &unitCubeMatrix, &modelMatrix, &skinCullingState->mins, &skinCullingState->maxs );
+			const ksGltfSkinCullingState * skinCullingState = &scene->state.skinCullingState[(int)( transform->skin - scene->skins )];
 
-					ksGpuGraphicsCommand command;
-					ksGpuGraphicsCommand_Init( &command );
-					ksGpuGraphicsCommand_SetPipeline( &command, &scene->unitCubePipeline );
-					ksGpuGraphicsCommand_SetParmFloatMatrix4x4( &command, 0, &unitCubeMatrix );
-					ksGpuGraphicsCommand_SetParmFloatMatrix4x4( &command, 1, &viewState->viewMatrix[0] );		// FIXME: use uniform buffer
-					ksGpuGraphicsCommand_SetParmFloatMatrix4x4( &command, 2, &viewState->projectionMatrix[0] );
+			ksMatrix4x4f unitCubeMatrix;
+			ksMatrix4x4f_CreateOffsetScaleForBounds( &unitCubeMatrix, transform->modelMatrix, &skinCullingState->mins, &skinCullingState->maxs );
 
-					ksGpuCommandBuffer_SubmitGraphicsCommand( commandBuffer, &command );
-				}
+			ksGpuGraphicsCommand command;
+			ksGpuGraphicsCommand_Init( &command );
+			ksGpuGraphicsCommand_SetPipeline( &command, &scene->unitCubePipeline );
+			ksGpuGraphicsCommand_SetParmFloatMatrix4x4( &command, 0, &unitCubeMatrix );
+			ksGpuGraphicsCommand_SetParmFloatMatrix4x4( &command, 1, &viewState->viewMatrix[0] );		// FIXME: use uniform buffer
+			ksGpuGraphicsCommand_SetParmFloatMatrix4x4( &command, 2, &viewState->projectionMatrix[0] );
 
-				if ( skinCullingState->culled )
-				{
-					continue;
-				}
-			}
+			ksGpuCommandBuffer_SubmitGraphicsCommand( commandBuffer, &command );
+		}
+	}
 
-			const ksGpuBuffer * jointBuffer = ( skin != NULL ) ? &skin->jointBuffer : &scene->defaultJointBuffer;
+	const int firstBatch = (int)( (long long)drawList->batchCount * part / partCount );
+	const int endBatch = (int)( (long long)drawList->batchCount * ( part + 1 ) / partCount );
 
-			ksMatrix4x4f modelViewProjectionCullMatrix;
-			ksMatrix4x4f_Multiply( &modelViewProjectionCullMatrix, &viewState->combinedViewProjectionMatrix, &modelMatrix );
+	for ( int batchIndex = firstBatch; batchIndex < endBatch; batchIndex++ )
+	{
+		const ksGltfDrawBatch * batch = &drawList->batches[batchIndex];
+		const ksGltfDrawSurface * drawSurface = &drawList->surfaces[drawList->order[batch->first]];
+		const ksGltfDrawTransform * transform = &drawList->transforms[drawSurface->transform];
+		const ksGltfSurface * surface = drawSurface->surface;
+		const bool instanced = ( batch->count > 1 );
+
+		// The instanced program multiplies the model matrix uniforms with the per-instance model matrix.
+		const ksMatrix4x4f * drawMatrices[GLTF_DRAW_MATRIX_MAX];
+		drawMatrices[GLTF_DRAW_MATRIX_LOCAL] = transform->localMatrix;
+		drawMatrices[GLTF_DRAW_MATRIX_MODEL] = instanced ? &identity : transform->modelMatrix;
+		drawMatrices[GLTF_DRAW_MATRIX_MODEL_INVERSE] = instanced ? &identity : &transform->modelInverseMatrix;
+
+		ksGpuGraphicsCommand command;
+		ksGpuGraphicsCommand_Init( &command );
+		ksGpuGraphicsCommand_SetPipeline( &command, instanced ? &surface->instancedPipeline : &surface->pipeline );
+		if ( drawList->indirectBuffer != NULL )
+		{
+			ksGpuGraphicsCommand_SetIndirectBuffer( &command, drawList->indirectBuffer, batchIndex, 1 );
+		}
+		else
+		{
+			ksGpuGraphicsCommand_SetNumInstances( &command, batch->count );
+		}
 
-			for ( int modelIndex = 0; modelIndex < node->modelCount; modelIndex++ )
+		const ksGltfMaterial * material = surface->material;
+		for ( int opIndex = 0; opIndex < material->uniformOpCount; opIndex++ )
+		{
+			const ksGltfUniformOp * op = &material->uniformOps[opIndex];
+			switch ( op->type )
 			{
-				const ksGltfModel * model = node->models[modelIndex];
-
-				if ( skin == NULL && ksMatrix4x4f_CullBounds( &modelViewProjectionCullMatrix, &model->mins, &model->maxs ) )
-				{
-					continue;
-				}
-
-				for ( int surfaceIndex = 0; surfaceIndex < model->surfaceCount; surfaceIndex++ )
-				{
-					const ksGltfSurface * surface = &model->surfaces[surfaceIndex];
-
-					if ( skin == NULL && model->surfaceCount > 1 && ksMatrix4x4f_CullBounds( &modelViewProjectionCullMatrix, &surface->mins, &surface->maxs ) )
-					{
-						continue;
-					}
-
-					ksGpuGraphicsCommand command;
-					ksGpuGraphicsCommand_Init( &command );
-					ksGpuGraphicsCommand_SetPipeline( &command, &surface->pipeline );
-
-					const ksGltfTechnique * technique = surface->material->technique;
-					for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
-					{
-						const ksGltfUniform * uniform = &technique->uniforms[uniformIndex];
-						if ( uniform->node != NULL )
-						{
-							const ksMatrix4x4f * matrix = &scene->state.nodeState[(int)( uniform->node - scene->nodes )].globalTransform;
-							ksGpuGraphicsCommand_SetParmFloatMatrix4x4( &command, uniform->index, matrix );
-						}
-						else
-						{
-							switch ( uniform->semantic )
-							{
-								case GLTF_UNIFORM_SEMANTIC_DEFAULT_VALUE:						ksGltfScene_SetUniformValue( &command, uniform, &uniform->defaultValue ); break;
-								case GLTF_UNIFORM_SEMANTIC_VIEW:								assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
-								case GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE:						assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
-								case GLTF_UNIFORM_SEMANTIC_PROJECTION:							assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
-								case GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE:					assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
-								case GLTF_UNIFORM_SEMANTIC_LOCAL:								ksGpuGraphicsCommand_SetParmFloatMatrix4x4( &command, uniform->index, &localMatrix ); break;
-								case GLTF_UNIFORM_SEMANTIC_MODEL:								ksGpuGraphicsCommand_SetParmFloatMatrix4x4( &command, uniform->index, &modelMatrix ); break;
-								case GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE:						ksGpuGraphicsCommand_SetParmFloatMatrix4x4( &command, uniform->index, &modelInverseMatrix ); break;
-								case GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE_TRANSPOSE:				assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
-								case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW:							assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
-								case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE:					assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
-								case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE_TRANSPOSE:		assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
-								case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION:				assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
-								case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION_INVERSE:		assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
-								case GLTF_UNIFORM_SEMANTIC_VIEWPORT:							ksGpuGraphicsCommand_SetParmFloatVector4( &command, uniform->index, &viewport ); break;
-								case GLTF_UNIFORM_SEMANTIC_JOINT_ARRAY:							assert( false ); break;	// replaced by KHR_glsl_joint_buffer
-								case GLTF_UNIFORM_SEMANTIC_JOINT_BUFFER:						ksGpuGraphicsCommand_SetParmBufferUniform( &command, uniform->index, jointBuffer ); break;
-								case GLTF_UNIFORM_SEMANTIC_VIEW_PROJECTION_BUFFER:				ksGpuGraphicsCommand_SetParmBufferUniform( &command, uniform->index, &scene->viewProjectionBuffer ); break;
-								case GLTF_UNIFORM_SEMANTIC_VIEW_PROJECTION_MULTI_VIEW_BUFFER:	ksGpuGraphicsCommand_SetParmBufferUniform( &command, uniform->index, &scene->viewProjectionBuffer ); break;
-								default: break;
-							}
-						}
-					}
-
-					for ( int valueIndex = 0; valueIndex < surface->material->valueCount; valueIndex++ )
-					{
-						const ksGltfMaterialValue * value = &surface->material->values[valueIndex];
-						if ( value->uniform != NULL )
-						{
-							ksGltfScene_SetUniformValue( &command, value->uniform, &value->value );
-						}
-					}
-
-					ksGpuCommandBuffer_SubmitGraphicsCommand( commandBuffer, &command );
-				}
+				case GLTF_UNIFORM_OP_VALUE:					ksGltfScene_SetUniformValue( &command, op->uniform, op->value ); break;
+				case GLTF_UNIFORM_OP_MATRIX:				ksGpuGraphicsCommand_SetParmFloatMatrix4x4( &command, op->index, op->matrix ); break;
+				case GLTF_UNIFORM_OP_DRAW_MATRIX:			ksGpuGraphicsCommand_SetParmFloatMatrix4x4( &command, op->index, drawMatrices[op->slot] ); break;
+				case GLTF_UNIFORM_OP_DRAW_JOINT_BUFFER:		ksGpuGraphicsCommand_SetParmBufferUniform( &command, op->index, transform->jointBuffer ); break;
+				case GLTF_UNIFORM_OP_VIEW_PROJECTION_BUFFER:	ksGpuGraphicsCommand_SetParmBufferUniform( &command, op->index, drawList->viewProjectionBuffer ); break;
+				case GLTF_UNIFORM_OP_VIEWPORT:				ksGpuGraphicsCommand_SetParmFloatVector4( &command, op->index, &viewport ); break;
 			}
 		}
+
+		ksGpuCommandBuffer_SubmitGraphicsCommand( commandBuffer, &command );
 	}
 }
+
+static void ksGltfScene_Render( ksGpuCommandBuffer * commandBuffer, const ksGltfScene * scene, const ksViewState * viewState )
+{
+	ksGltfScene_RenderPart( commandBuffer, scene, viewState, 0, 1 );
+}
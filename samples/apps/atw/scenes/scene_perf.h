@@ -40,17 +40,73 @@ static void ksPerfScene_Destroy( ksGpuContext * context, ksPerfScene * scene );
 static void ksPerfScene_Simulate( ksPerfScene * scene, ksViewState * viewState, const ksNanoseconds time );
 static void ksPerfScene_UpdateBuffers( ksGpuCommandBuffer * commandBuffer, ksPerfScene * scene, const ksViewState * viewState, const int eye );
 static void ksPerfScene_Render( ksGpuCommandBuffer * commandBuffer, ksPerfScene * scene, const ksViewState * viewState );
+static void ksPerfScene_RenderPart( ksGpuCommandBuffer * commandBuffer, const ksPerfScene * scene, const ksViewState * viewState, const int part, const int partCount );
+
+ksPerfScene_RenderPart only reads the scene, so the parts can be recorded into different command buffers on different threads.
 
 ================================================================================================================================
 */
 
+#define PERF_WORKERS				4		// number of worker threads used to calculate the model matrices of large grids
+#define PERF_THREAD_POOL_OBJECTS	4096	// minimum number of objects for which the model matrices are calculated on the workers
+#define PERF_MAX_DIMENSION			( 2 * ( 1 << ( MAX_SCENE_DRAWCALL_LEVELS - 1 ) ) )
+#define PERF_OBJECT_SPACING			2.0f	// distance between the centers of neighbouring objects in the grid
+#define PERF_OBJECT_RADIUS			1.0f	// radius of a sphere that encloses the cube and the tori
+#define PERF_CULL_LOCAL_SIZE_X		64		// the SPIR-V cull program has this local size built in
+
+// The instanced vertex programs are available as GLSL for OpenGL and OpenGL ES. The Vulkan
+// SPIR-V of these programs and of the cull compute program has been run on SwiftShader, but it
+// has not been checked with spirv-val, so Vulkan only uses it when PERF_VULKAN_INSTANCED_SPIRV
+// is defined to 1. The HLSL and Metal programs of this scene are not written yet. Where the
+// instanced and indirect draw paths are disabled, every object is drawn with its own draw call.
+#if !defined( PERF_VULKAN_INSTANCED_SPIRV )
+	#define PERF_VULKAN_INSTANCED_SPIRV	0
+#endif
+
+#if GRAPHICS_API_OPENGL == 1 || GRAPHICS_API_OPENGL_ES == 1 || ( GRAPHICS_API_VULKAN == 1 && PERF_VULKAN_INSTANCED_SPIRV == 1 )
+	#define PERF_INSTANCED_PROGRAMS		1
+#else
+	#define PERF_INSTANCED_PROGRAMS		0
+#endif
+
+// Per frame constants shared by the threads that calculate the model matrices.
+// Each job is a slice of the grid with constant x.
+typedef struct
+{
+	ksMatrix4x4f			bigTransformMatrix;
+	ksMatrix4x4f			smallRotationMatrix;
+	ksMatrix4x4f			smallRotationPartial;	// translation independent part of translation * smallRotationMatrix
+	float					offsets[PERF_MAX_DIMENSION];
+	ksMatrix4x4f *			modelMatrices;
+	int						dimension;
+	ksAtomicUint32			nextSlice;				// atomic counter shared by all workers
+} ksPerfSceneMatrixJobs;
+
+// Layout of the CullParms uniform buffer of the cull compute program.
+// The planes are in the space of the grid, so the program only needs the grid index of an object.
+typedef struct
+{
+	ksVector4f				planes[2][5];			// left, right, bottom, top and near plane of each view
+	ksVector4f				grid;					// x = object spacing, y = grid center, z = object radius
+	ksVector4i				counts;					// x = grid dimension
+} ksPerfSceneCullParms;
+
 typedef struct
 {
 	// assets
 	ksGpuGeometry			geometry[MAX_SCENE_TRIANGLE_LEVELS];
 	ksGpuGraphicsProgram	program[MAX_SCENE_FRAGMENT_LEVELS];
 	ksGpuGraphicsPipeline	pipelines[MAX_SCENE_TRIANGLE_LEVELS][MAX_SCENE_FRAGMENT_LEVELS];
+	ksGpuGraphicsProgram	instancedProgram[MAX_SCENE_FRAGMENT_LEVELS];
+	ksGpuGraphicsPipeline	instancedPipelines[MAX_SCENE_TRIANGLE_LEVELS][MAX_SCENE_FRAGMENT_LEVELS];
+	ksGpuBuffer				indirectBuffers[MAX_SCENE_TRIANGLE_LEVELS];
+	ksGpuComputeProgram		cullProgram;
+	ksGpuComputePipeline	cullPipeline;
+	ksGpuBuffer				cullParms;
+	bool					drawInstanced;
+	bool					drawIndirect;
 	ksGpuBuffer				sceneMatrices;
+	const ksGpuBuffer *		sceneMatricesBinding;	// buffer with the scene matrices of this frame
 	ksGpuTexture			diffuseTexture;
 	ksGpuTexture			specularTexture;
 	ksGpuTexture			normalTexture;
@@ -62,6 +118,9 @@ typedef struct
 	float					smallRotationX;
 	float					smallRotationY;
 	ksMatrix4x4f *			modelMatrix;
+	ksPerfSceneMatrixJobs	matrixJobs;
+	ksThreadPool			threadPool;
+	bool					useThreadPool;		// true once a grid was large enough to create the worker threads
 } ksPerfScene;
 
 enum
@@ -73,6 +132,12 @@ enum
 	PROGRAM_TEXTURE_2
 };
 
+enum
+{
+	COMPUTE_PROGRAM_UNIFORM_CULL_PARMS,
+	COMPUTE_PROGRAM_BUFFER_INDIRECT_COMMANDS
+};
+
 #if GRAPHICS_API_OPENGL == 1 || GRAPHICS_API_OPENGL_ES == 1
 
 static ksGpuProgramParm flatShadedProgramParms[] =
@@ -159,6 +224,89 @@ static const char flatShadedMultiViewVertexProgramGLSL[] =
 	"	fragmentNormal = multiply3x3( ModelMatrix, vertexNormal );\n"
 	"}\n";
 
+static ksGpuProgramParm flatShadedInstancedProgramParms[] =
+{
+	{ KS_GPU_PROGRAM_STAGE_FLAG_VERTEX,	KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM,				KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	PROGRAM_UNIFORM_SCENE_MATRICES,		"SceneMatrices",	0 }
+};
+
+static const char flatShadedInstancedVertexProgramGLSL[] =
+	"#version " GLSL_VERSION "\n"
+	GLSL_EXTENSIONS
+	"uniform SceneMatrices\n"
+	"{\n"
+	"	mat4 ViewMatrix;\n"
+	"	mat4 ProjectionMatrix;\n"
+	"};\n"
+	"in vec3 vertexPosition;\n"
+	"in vec3 vertexNormal;\n"
+	"in mat4 vertexTransform;\n"
+	"out vec3 fragmentEyeDir;\n"
+	"out vec3 fragmentNormal;\n"
+	"out gl_PerVertex { vec4 gl_Position; };\n"
+	"vec3 multiply3x3( mat4 m, vec3 v )\n"
+	"{\n"
+	"	return vec3(\n"
+	"		m[0].x * v.x + m[1].x * v.y + m[2].x * v.z,\n"
+	"		m[0].y * v.x + m[1].y * v.y + m[2].y * v.z,\n"
+	"		m[0].z * v.x + m[1].z * v.y + m[2].z * v.z );\n"
+	"}\n"
+	"vec3 transposeMultiply3x3( mat4 m, vec3 v )\n"
+	"{\n"
+	"	return vec3(\n"
+	"		m[0].x * v.x + m[0].y * v.y + m[0].z * v.z,\n"
+	"		m[1].x * v.x + m[1].y * v.y + m[1].z * v.z,\n"
+	"		m[2].x * v.x + m[2].y * v.y + m[2].z * v.z );\n"
+	"}\n"
+	"void main( void )\n"
+	"{\n"
+	"	vec4 vertexWorldPos = vertexTransform * vec4( vertexPosition, 1.0 );\n"
+	"	vec3 eyeWorldPos = transposeMultiply3x3( ViewMatrix, -vec3( ViewMatrix[3] ) );\n"
+	"	gl_Position = ProjectionMatrix * ( ViewMatrix * vertexWorldPos );\n"
+	"	fragmentEyeDir = eyeWorldPos - vec3( vertexWorldPos );\n"
+	"	fragmentNormal = multiply3x3( vertexTransform, vertexNormal );\n"
+	"}\n";
+
+static const char flatShadedInstancedMultiViewVertexProgramGLSL[] =
+	"#version " GLSL_VERSION "\n"
+	GLSL_EXTENSIONS
+	"#define NUM_VIEWS 2\n"
+	"#define VIEW_ID gl_ViewID_OVR\n"
+	"#extension GL_OVR_multiview2 : require\n"
+	"layout( num_views = NUM_VIEWS ) in;\n"
+	"\n"
+	"uniform SceneMatrices\n"
+	"{\n"
+	"	mat4 ViewMatrix[NUM_VIEWS];\n"
+	"	mat4 ProjectionMatrix[NUM_VIEWS];\n"
+	"} ub;\n"
+	"in vec3 vertexPosition;\n"
+	"in vec3 vertexNormal;\n"
+	"in mat4 vertexTransform;\n"
+	"out vec3 fragmentEyeDir;\n"
+	"out vec3 fragmentNormal;\n"
+	"vec3 multiply3x3( mat4 m, vec3 v )\n"
+	"{\n"
+	"	return vec3(\n"
+	"		m[0].x * v.x + m[1].x * v.y + m[2].x * v.z,\n"
+	"		m[0].y * v.x + m[1].y * v.y + m[2].y * v.z,\n"
+	"		m[0].z * v.x + m[1].z * v.y + m[2].z * v.z );\n"
+	"}\n"
+	"vec3 transposeMultiply3x3( mat4 m, vec3 v )\n"
+	"{\n"
+	"	return vec3(\n"
+	"		m[0].x * v.x + m[0].y * v.y + m[0].z * v.z,\n"
+	"		m[1].x * v.x + m[1].y * v.y + m[1].z * v.z,\n"
+	"		m[2].x * v.x + m[2].y * v.y + m[2].z * v.z );\n"
+	"}\n"
+	"void main( void )\n"
+	"{\n"
+	"	vec4 vertexWorldPos = vertexTransform * vec4( vertexPosition, 1.0 );\n"
+	"	vec3 eyeWorldPos = transposeMultiply3x3( ub.ViewMatrix[VIEW_ID], -vec3( ub.ViewMatrix[VIEW_ID][3] ) );\n"
+	"	gl_Position = ub.ProjectionMatrix[VIEW_ID] * ( ub.ViewMatrix[VIEW_ID] * vertexWorldPos );\n"
+	"	fragmentEyeDir = eyeWorldPos - vec3( vertexWorldPos );\n"
+	"	fragmentNormal = multiply3x3( vertexTransform, vertexNormal );\n"
+	"}\n";
+
 static const char flatShadedFragmentProgramGLSL[] =
 	"#version " GLSL_VERSION "\n"
 	GLSL_EXTENSIONS
@@ -287,6 +435,110 @@ static const char normalMappedMultiViewVertexProgramGLSL[] =
 	"	fragmentUv0 = vertexUv0;\n"
 	"}\n";
 
+static ksGpuProgramParm normalMappedInstancedProgramParms[] =
+{
+	{ KS_GPU_PROGRAM_STAGE_FLAG_VERTEX,		KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM,				KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	PROGRAM_UNIFORM_SCENE_MATRICES,		"SceneMatrices",	0 },
+	{ KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT,	KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED,				KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	PROGRAM_TEXTURE_0,					"Texture0",			0 },
+	{ KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT,	KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED,				KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	PROGRAM_TEXTURE_1,					"Texture1",			1 },
+	{ KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT,	KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED,				KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	PROGRAM_TEXTURE_2,					"Texture2",			2 }
+};
+
+static const char normalMappedInstancedVertexProgramGLSL[] =
+	"#version " GLSL_VERSION "\n"
+	GLSL_EXTENSIONS
+	"uniform SceneMatrices\n"
+	"{\n"
+	"	mat4 ViewMatrix;\n"
+	"	mat4 ProjectionMatrix;\n"
+	"};\n"
+	"in vec3 vertexPosition;\n"
+	"in vec3 vertexNormal;\n"
+	"in vec3 vertexTangent;\n"
+	"in vec3 vertexBinormal;\n"
+	"in vec2 vertexUv0;\n"
+	"in mat4 vertexTransform;\n"
+	"out vec3 fragmentEyeDir;\n"
+	"out vec3 fragmentNormal;\n"
+	"out vec3 fragmentTangent;\n"
+	"out vec3 fragmentBinormal;\n"
+	"out vec2 fragmentUv0;\n"
+	"out gl_PerVertex { vec4 gl_Position; };\n"
+	"vec3 multiply3x3( mat4 m, vec3 v )\n"
+	"{\n"
+	"	return vec3(\n"
+	"		m[0].x * v.x + m[1].x * v.y + m[2].x * v.z,\n"
+	"		m[0].y * v.x + m[1].y * v.y + m[2].y * v.z,\n"
+	"		m[0].z * v.x + m[1].z * v.y + m[2].z * v.z );\n"
+	"}\n"
+	"vec3 transposeMultiply3x3( mat4 m, vec3 v )\n"
+	"{\n"
+	"	return vec3(\n"
+	"		m[0].x * v.x + m[0].y * v.y + m[0].z * v.z,\n"
+	"		m[1].x * v.x + m[1].y * v.y + m[1].z * v.z,\n"
+	"		m[2].x * v.x + m[2].y * v.y + m[2].z * v.z );\n"
+	"}\n"
+	"void main( void )\n"
+	"{\n"
+	"	vec4 vertexWorldPos = vertexTransform * vec4( vertexPosition, 1.0 );\n"
+	"	vec3 eyeWorldPos = transposeMultiply3x3( ViewMatrix, -vec3( ViewMatrix[3] ) );\n"
+	"	gl_Position = ProjectionMatrix * ( ViewMatrix * vertexWorldPos );\n"
+	"	fragmentEyeDir = eyeWorldPos - vec3( vertexWorldPos );\n"
+	"	fragmentNormal = multiply3x3( vertexTransform, vertexNormal );\n"
+	"	fragmentTangent = multiply3x3( vertexTransform, vertexTangent );\n"
+	"	fragmentBinormal = multiply3x3( vertexTransform, vertexBinormal );\n"
+	"	fragmentUv0 = vertexUv0;\n"
+	"}\n";
+
+static const char normalMappedInstancedMultiViewVertexProgramGLSL[] =
+	"#version " GLSL_VERSION "\n"
+	GLSL_EXTENSIONS
+	"#define NUM_VIEWS 2\n"
+	"#define VIEW_ID gl_ViewID_OVR\n"
+	"#extension GL_OVR_multiview2 : require\n"
+	"layout( num_views = NUM_VIEWS ) in;\n"
+	"\n"
+	"uniform SceneMatrices\n"
+	"{\n"
+	"	mat4 ViewMatrix[NUM_VIEWS];\n"
+	"	mat4 ProjectionMatrix[NUM_VIEWS];\n"
+	"} ub;\n"
+	"in vec3 vertexPosition;\n"
+	"in vec3 vertexNormal;\n"
+	"in vec3 vertexTangent;\n"
+	"in vec3 vertexBinormal;\n"
+	"in vec2 vertexUv0;\n"
+	"in mat4 vertexTransform;\n"
+	"out vec3 fragmentEyeDir;\n"
+	"out vec3 fragmentNormal;\n"
+	"out vec3 fragmentTangent;\n"
+	"out vec3 fragmentBinormal;\n"
+	"out vec2 fragmentUv0;\n"
+	"vec3 multiply3x3( mat4 m, vec3 v )\n"
+	"{\n"
+	"	return vec3(\n"
+	"		m[0].x * v.x + m[1].x * v.y + m[2].x * v.z,\n"
+	"		m[0].y * v.x + m[1].y * v.y + m[2].y * v.z,\n"
+	"		m[0].z * v.x + m[1].z * v.y + m[2].z * v.z );\n"
+	"}\n"
+	"vec3 transposeMultiply3x3( mat4 m, vec3 v )\n"
+	"{\n"
+	"	return vec3(\n"
+	"		m[0].x * v.x + m[0].y * v.y + m[0].z * v.z,\n"
+	"		m[1].x * v.x + m[1].y * v.y + m[1].z * v.z,\n"
+	"		m[2].x * v.x + m[2].y * v.y + m[2].z * v.z );\n"
+	"}\n"
+	"void main( void )\n"
+	"{\n"
+	"	vec4 vertexWorldPos = vertexTransform * vec4( vertexPosition, 1.0 );\n"
+	"	vec3 eyeWorldPos = transposeMultiply3x3( ub.ViewMatrix[VIEW_ID], -vec3( ub.ViewMatrix[VIEW_ID][3] ) );\n"
+	"	gl_Position = ub.ProjectionMatrix[VIEW_ID] * ( ub.ViewMatrix[VIEW_ID] * vertexWorldPos );\n"
+	"	fragmentEyeDir = eyeWorldPos - vec3( vertexWorldPos );\n"
+	"	fragmentNormal = multiply3x3( vertexTransform, vertexNormal );\n"
+	"	fragmentTangent = multiply3x3( vertexTransform, vertexTangent );\n"
+	"	fragmentBinormal = multiply3x3( vertexTransform, vertexBinormal );\n"
+	"	fragmentUv0 = vertexUv0;\n"
+	"}\n";
+
 static const char normalMapped100LightsFragmentProgramGLSL[] =
 	"#version " GLSL_VERSION "\n"
 	GLSL_EXTENSIONS
@@ -392,6 +644,40 @@ static const char normalMapped2000LightsFragmentProgramGLSL[] =
 	"	outColor.w = 1.0;\n"
 	"}\n";
 
+static ksGpuProgramParm perfCullComputeProgramParms[] =
+{
+	{ KS_GPU_PROGRAM_STAGE_FLAG_COMPUTE, KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM,	KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	COMPUTE_PROGRAM_UNIFORM_CULL_PARMS,			"CullParms",		0 },
+	{ KS_GPU_PROGRAM_STAGE_FLAG_COMPUTE, KS_GPU_PROGRAM_PARM_TYPE_BUFFER_STORAGE,	KS_GPU_PROGRAM_PARM_ACCESS_WRITE_ONLY,	COMPUTE_PROGRAM_BUFFER_INDIRECT_COMMANDS,	"IndirectCommands",	0 }
+};
+
+static const char perfCullComputeProgramGLSL[] =
+	"#version " GLSL_VERSION "\n"
+	GLSL_EXTENSIONS
+	"\n"
+	"layout( local_size_x = " STRINGIFY( PERF_CULL_LOCAL_SIZE_X ) " ) in;\n"
+	"\n"
+	"layout( std140 ) uniform CullParms\n"
+	"{\n"
+	"	vec4 Planes[10];\n"
+	"	vec4 Grid;\n"
+	"	ivec4 Counts;\n"
+	"};\n"
+	"layout( std430, binding = 0 ) buffer IndirectCommands { uint Commands[]; };\n"
+	"\n"
+	"void main()\n"
+	"{\n"
+	"	int index = int( gl_GlobalInvocationID.x );\n"
+	"	int dimension = Counts.x;\n"
+	"	if ( index < dimension * dimension * dimension )\n"
+	"	{\n"
+	"		vec3 gridPos = vec3( ivec3( index / ( dimension * dimension ), ( index / dimension ) % dimension, index % dimension ) );\n"
+	"		vec4 center = vec4( ( gridPos - vec3( Grid.y ) ) * Grid.x, 1.0 );\n"
+	"		float view0 = min( min( min( min( dot( Planes[0], center ), dot( Planes[1], center ) ), dot( Planes[2], center ) ), dot( Planes[3], center ) ), dot( Planes[4], center ) );\n"
+	"		float view1 = min( min( min( min( dot( Planes[5], center ), dot( Planes[6], center ) ), dot( Planes[7], center ) ), dot( Planes[8], center ) ), dot( Planes[9], center ) );\n"
+	"		Commands[index * 5 + 1] = ( max( view0, view1 ) > -Grid.z ) ? 1u : 0u;\n"
+	"	}\n"
+	"}\n";
+
 #elif GRAPHICS_API_VULKAN == 1
 
 static ksGpuProgramParm flatShadedProgramParms[] =
@@ -602,6 +888,207 @@ static const unsigned int flatShadedMultiViewVertexProgramSPIRV[] =
 	0x00000000
 };
 
+static ksGpuProgramParm flatShadedInstancedProgramParms[] =
+{
+	{ KS_GPU_PROGRAM_STAGE_FLAG_VERTEX,	KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM,				KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	PROGRAM_UNIFORM_SCENE_MATRICES,		"SceneMatrices",	0 }
+};
+
+static const char flatShadedInstancedVertexProgramGLSL[] =
+	"#version " GLSL_VERSION "\n"
+	GLSL_EXTENSIONS
+	"layout( std140, binding = 0 ) uniform SceneMatrices\n"
+	"{\n"
+	"	layout( offset =   0 ) mat4 ViewMatrix;\n"
+	"	layout( offset =  64 ) mat4 ProjectionMatrix;\n"
+	"};\n"
+	"layout( location = 0 ) in vec3 vertexPosition;\n"
+	"layout( location = 1 ) in vec3 vertexNormal;\n"
+	"layout( location = 2 ) in mat4 vertexTransform;\n"
+	"layout( location = 0 ) out vec3 fragmentEyeDir;\n"
+	"layout( location = 1 ) out vec3 fragmentNormal;\n"
+	"out gl_PerVertex { vec4 gl_Position; };\n"
+	"vec3 multiply3x3( mat4 m, vec3 v )\n"
+	"{\n"
+	"	return vec3(\n"
+	"		m[0].x * v.x + m[1].x * v.y + m[2].x * v.z,\n"
+	"		m[0].y * v.x + m[1].y * v.y + m[2].y * v.z,\n"
+	"		m[0].z * v.x + m[1].z * v.y + m[2].z * v.z );\n"
+	"}\n"
+	"vec3 transposeMultiply3x3( mat4 m, vec3 v )\n"
+	"{\n"
+	"	return vec3(\n"
+	"		m[0].x * v.x + m[0].y * v.y + m[0].z * v.z,\n"
+	"		m[1].x * v.x + m[1].y * v.y + m[1].z * v.z,\n"
+	"		m[2].x * v.x + m[2].y * v.y + m[2].z * v.z );\n"
+	"}\n"
+	"void main( void )\n"
+	"{\n"
+	"	vec4 vertexWorldPos = vertexTransform * vec4( vertexPosition, 1.0 );\n"
+	"	vec3 eyeWorldPos = transposeMultiply3x3( ViewMatrix, -vec3( ViewMatrix[3] ) );\n"
+	"	gl_Position = ProjectionMatrix * ( ViewMatrix * vertexWorldPos );\n"
+	"	fragmentEyeDir = eyeWorldPos - vec3( vertexWorldPos );\n"
+	"	fragmentNormal = multiply3x3( vertexTransform, vertexNormal );\n"
+	"}\n";
+
+// Same as flatShadedVertexProgramSPIRV except that the push constant model matrix is replaced
+// by the per instance vertexTransform attribute at location 2.
+static const unsigned int flatShadedInstancedVertexProgramSPIRV[] =
+{
+	0x07230203,0x00010000,0x00080001,0x000000cb,0x00000000,0x00020011,0x00000001,0x0006000b,
+	0x00000001,0x4c534c47,0x6474732e,0x3035342e,0x00000000,0x0003000e,0x00000000,0x00000001,
+	0x000b000f,0x00000000,0x00000004,0x6e69616d,0x00000000,0x00000093,0x000000b0,0x000000bb,
+	0x000000c3,0x000000c4,0x0000008e,0x00030003,0x00000001,0x00000136,0x00040005,0x00000004,
+	0x6e69616d,0x00000000,0x00080005,0x0000000f,0x746c756d,0x796c7069,0x28337833,0x3434666d,
+	0x3366763b,0x0000003b,0x00030005,0x0000000d,0x0000006d,0x00030005,0x0000000e,0x00000076,
+	0x000a0005,0x00000013,0x6e617274,0x736f7073,0x6c754d65,0x6c706974,0x33783379,0x34666d28,
+	0x66763b34,0x00003b33,0x00030005,0x00000011,0x0000006d,0x00030005,0x00000012,0x00000076,
+	0x00060005,0x0000008b,0x74726576,0x6f577865,0x50646c72,0x0000736f,0x00060005,0x0000008e,
+	0x74726576,0x72547865,0x66736e61,0x006d726f,0x00060005,0x00000093,0x74726576,0x6f507865,
+	0x69746973,0x00006e6f,0x00050005,0x0000009b,0x57657965,0x646c726f,0x00736f50,0x00060005,
+	0x0000009c,0x6e656353,0x74614d65,0x65636972,0x00000073,0x00060006,0x0000009c,0x00000000,
+	0x77656956,0x7274614d,0x00007869,0x00080006,0x0000009c,0x00000001,0x6a6f7250,0x69746365,
+	0x614d6e6f,0x78697274,0x00000000,0x00030005,0x0000009e,0x00006275,0x00040005,0x000000a8,
+	0x61726170,0x0000006d,0x00040005,0x000000ac,0x61726170,0x0000006d,0x00060005,0x000000ae,
+	0x505f6c67,0x65567265,0x78657472,0x00000000,0x00060006,0x000000ae,0x00000000,0x505f6c67,
+	0x7469736f,0x006e6f69,0x00070006,0x000000ae,0x00000001,0x505f6c67,0x746e696f,0x657a6953,
+	0x00000000,0x00030005,0x000000b0,0x00000000,0x00060005,0x000000bb,0x67617266,0x746e656d,
+	0x44657945,0x00007269,0x00060005,0x000000c3,0x67617266,0x746e656d,0x6d726f4e,0x00006c61,
+	0x00060005,0x000000c4,0x74726576,0x6f4e7865,0x6c616d72,0x00000000,0x00040005,0x000000c5,
+	0x61726170,0x0000006d,0x00040005,0x000000c8,0x61726170,0x0000006d,0x00040047,0x00000093,
+	0x0000001e,0x00000000,0x00040047,0x0000008e,0x0000001e,0x00000002,0x00040048,0x0000009c,
+	0x00000000,0x00000005,0x00050048,0x0000009c,0x00000000,0x00000023,0x00000000,0x00050048,
+	0x0000009c,0x00000000,0x00000007,0x00000010,0x00040048,0x0000009c,0x00000001,0x00000005,
+	0x00050048,0x0000009c,0x00000001,0x00000023,0x00000040,0x00050048,0x0000009c,0x00000001,
+	0x00000007,0x00000010,0x00030047,0x0000009c,0x00000002,0x00040047,0x0000009e,0x00000022,
+	0x00000000,0x00040047,0x0000009e,0x00000021,0x00000000,0x00050048,0x000000ae,0x00000000,
+	0x0000000b,0x00000000,0x00050048,0x000000ae,0x00000001,0x0000000b,0x00000001,0x00030047,
+	0x000000ae,0x00000002,0x00040047,0x000000bb,0x0000001e,0x00000000,0x00040047,0x000000c3,
+	0x0000001e,0x00000001,0x00040047,0x000000c4,0x0000001e,0x00000001,0x00020013,0x00000002,
+	0x00030021,0x00000003,0x00000002,0x00030016,0x00000006,0x00000020,0x00040017,0x00000007,
+	0x00000006,0x00000004,0x00040018,0x00000008,0x00000007,0x00000004,0x00040020,0x00000009,
+	0x00000007,0x00000008,0x00040017,0x0000000a,0x00000006,0x00000003,0x00040020,0x0000000b,
+	0x00000007,0x0000000a,0x00050021,0x0000000c,0x0000000a,0x00000009,0x0000000b,0x00040015,
+	0x00000015,0x00000020,0x00000001,0x0004002b,0x00000015,0x00000016,0x00000000,0x00040015,
+	0x00000017,0x00000020,0x00000000,0x0004002b,0x00000017,0x00000018,0x00000000,0x00040020,
+	0x00000019,0x00000007,0x00000006,0x0004002b,0x00000015,0x0000001f,0x00000001,0x0004002b,
+	0x00000017,0x00000022,0x00000001,0x0004002b,0x00000015,0x00000027,0x00000002,0x0004002b,
+	0x00000017,0x0000002a,0x00000002,0x00040020,0x0000008a,0x00000007,0x00000007,0x00040020,
+	0x0000008f,0x00000001,0x00000008,0x0004003b,0x0000008f,0x0000008e,0x00000001,0x00040020,
+	0x00000092,0x00000001,0x0000000a,0x0004003b,0x00000092,0x00000093,0x00000001,0x0004002b,
+	0x00000006,0x00000095,0x3f800000,0x0004001e,0x0000009c,0x00000008,0x00000008,0x00040020,
+	0x0000009d,0x00000002,0x0000009c,0x0004003b,0x0000009d,0x0000009e,0x00000002,0x0004002b,
+	0x00000015,0x0000009f,0x00000003,0x00040020,0x000000a0,0x00000002,0x00000007,0x00040020,
+	0x000000a9,0x00000002,0x00000008,0x0004001e,0x000000ae,0x00000007,0x00000006,0x00040020,
+	0x000000af,0x00000003,0x000000ae,0x0004003b,0x000000af,0x000000b0,0x00000003,0x00040020,
+	0x000000b8,0x00000003,0x00000007,0x00040020,0x000000ba,0x00000003,0x0000000a,0x0004003b,
+	0x000000ba,0x000000bb,0x00000003,0x0004003b,0x000000ba,0x000000c3,0x00000003,0x0004003b,
+	0x00000092,0x000000c4,0x00000001,0x00050036,0x00000002,0x00000004,0x00000000,0x00000003,
+	0x000200f8,0x00000005,0x0004003b,0x0000008a,0x0000008b,0x00000007,0x0004003b,0x0000000b,
+	0x0000009b,0x00000007,0x0004003b,0x00000009,0x000000a8,0x00000007,0x0004003b,0x0000000b,
+	0x000000ac,0x00000007,0x0004003b,0x00000009,0x000000c5,0x00000007,0x0004003b,0x0000000b,
+	0x000000c8,0x00000007,0x0004003d,0x00000008,0x00000091,0x0000008e,0x0004003d,0x0000000a,
+	0x00000094,0x00000093,0x00050051,0x00000006,0x00000096,0x00000094,0x00000000,0x00050051,
+	0x00000006,0x00000097,0x00000094,0x00000001,0x00050051,0x00000006,0x00000098,0x00000094,
+	0x00000002,0x00070050,0x00000007,0x00000099,0x00000096,0x00000097,0x00000098,0x00000095,
+	0x00050091,0x00000007,0x0000009a,0x00000091,0x00000099,0x0003003e,0x0000008b,0x0000009a,
+	0x00060041,0x000000a0,0x000000a1,0x0000009e,0x00000016,0x0000009f,0x0004003d,0x00000007,
+	0x000000a2,0x000000a1,0x00050051,0x00000006,0x000000a3,0x000000a2,0x00000000,0x00050051,
+	0x00000006,0x000000a4,0x000000a2,0x00000001,0x00050051,0x00000006,0x000000a5,0x000000a2,
+	0x00000002,0x00060050,0x0000000a,0x000000a6,0x000000a3,0x000000a4,0x000000a5,0x0004007f,
+	0x0000000a,0x000000a7,0x000000a6,0x00050041,0x000000a9,0x000000aa,0x0000009e,0x00000016,
+	0x0004003d,0x00000008,0x000000ab,0x000000aa,0x0003003e,0x000000a8,0x000000ab,0x0003003e,
+	0x000000ac,0x000000a7,0x00060039,0x0000000a,0x000000ad,0x00000013,0x000000a8,0x000000ac,
+	0x0003003e,0x0000009b,0x000000ad,0x00050041,0x000000a9,0x000000b1,0x0000009e,0x0000001f,
+	0x0004003d,0x00000008,0x000000b2,0x000000b1,0x00050041,0x000000a9,0x000000b3,0x0000009e,
+	0x00000016,0x0004003d,0x00000008,0x000000b4,0x000000b3,0x0004003d,0x00000007,0x000000b5,
+	0x0000008b,0x00050091,0x00000007,0x000000b6,0x000000b4,0x000000b5,0x00050091,0x00000007,
+	0x000000b7,0x000000b2,0x000000b6,0x00050041,0x000000b8,0x000000b9,0x000000b0,0x00000016,
+	0x0003003e,0x000000b9,0x000000b7,0x0004003d,0x0000000a,0x000000bc,0x0000009b,0x0004003d,
+	0x00000007,0x000000bd,0x0000008b,0x00050051,0x00000006,0x000000be,0x000000bd,0x00000000,
+	0x00050051,0x00000006,0x000000bf,0x000000bd,0x00000001,0x00050051,0x00000006,0x000000c0,
+	0x000000bd,0x00000002,0x00060050,0x0000000a,0x000000c1,0x000000be,0x000000bf,0x000000c0,
+	0x00050083,0x0000000a,0x000000c2,0x000000bc,0x000000c1,0x0003003e,0x000000bb,0x000000c2,
+	0x0004003d,0x00000008,0x000000c7,0x0000008e,0x0003003e,0x000000c5,0x000000c7,0x0004003d,
+	0x0000000a,0x000000c9,0x000000c4,0x0003003e,0x000000c8,0x000000c9,0x00060039,0x0000000a,
+	0x000000ca,0x0000000f,0x000000c5,0x000000c8,0x0003003e,0x000000c3,0x000000ca,0x000100fd,
+	0x00010038,0x00050036,0x0000000a,0x0000000f,0x00000000,0x0000000c,0x00030037,0x00000009,
+	0x0000000d,0x00030037,0x0000000b,0x0000000e,0x000200f8,0x00000010,0x00060041,0x00000019,
+	0x0000001a,0x0000000d,0x00000016,0x00000018,0x0004003d,0x00000006,0x0000001b,0x0000001a,
+	0x00050041,0x00000019,0x0000001c,0x0000000e,0x00000018,0x0004003d,0x00000006,0x0000001d,
+	0x0000001c,0x00050085,0x00000006,0x0000001e,0x0000001b,0x0000001d,0x00060041,0x00000019,
+	0x00000020,0x0000000d,0x0000001f,0x00000018,0x0004003d,0x00000006,0x00000021,0x00000020,
+	0x00050041,0x00000019,0x00000023,0x0000000e,0x00000022,0x0004003d,0x00000006,0x00000024,
+	0x00000023,0x00050085,0x00000006,0x00000025,0x00000021,0x00000024,0x00050081,0x00000006,
+	0x00000026,0x0000001e,0x00000025,0x00060041,0x00000019,0x00000028,0x0000000d,0x00000027,
+	0x00000018,0x0004003d,0x00000006,0x00000029,0x00000028,0x00050041,0x00000019,0x0000002b,
+	0x0000000e,0x0000002a,0x0004003d,0x00000006,0x0000002c,0x0000002b,0x00050085,0x00000006,
+	0x0000002d,0x00000029,0x0000002c,0x00050081,0x00000006,0x0000002e,0x00000026,0x0000002d,
+	0x00060041,0x00000019,0x0000002f,0x0000000d,0x00000016,0x00000022,0x0004003d,0x00000006,
+	0x00000030,0x0000002f,0x00050041,0x00000019,0x00000031,0x0000000e,0x00000018,0x0004003d,
+	0x00000006,0x00000032,0x00000031,0x00050085,0x00000006,0x00000033,0x00000030,0x00000032,
+	0x00060041,0x00000019,0x00000034,0x0000000d,0x0000001f,0x00000022,0x0004003d,0x00000006,
+	0x00000035,0x00000034,0x00050041,0x00000019,0x00000036,0x0000000e,0x00000022,0x0004003d,
+	0x00000006,0x00000037,0x00000036,0x00050085,0x00000006,0x00000038,0x00000035,0x00000037,
+	0x00050081,0x00000006,0x00000039,0x00000033,0x00000038,0x00060041,0x00000019,0x0000003a,
+	0x0000000d,0x00000027,0x00000022,0x0004003d,0x00000006,0x0000003b,0x0000003a,0x00050041,
+	0x00000019,0x0000003c,0x0000000e,0x0000002a,0x0004003d,0x00000006,0x0000003d,0x0000003c,
+	0x00050085,0x00000006,0x0000003e,0x0000003b,0x0000003d,0x00050081,0x00000006,0x0000003f,
+	0x00000039,0x0000003e,0x00060041,0x00000019,0x00000040,0x0000000d,0x00000016,0x0000002a,
+	0x0004003d,0x00000006,0x00000041,0x00000040,0x00050041,0x00000019,0x00000042,0x0000000e,
+	0x00000018,0x0004003d,0x00000006,0x00000043,0x00000042,0x00050085,0x00000006,0x00000044,
+	0x00000041,0x00000043,0x00060041,0x00000019,0x00000045,0x0000000d,0x0000001f,0x0000002a,
+	0x0004003d,0x00000006,0x00000046,0x00000045,0x00050041,0x00000019,0x00000047,0x0000000e,
+	0x00000022,0x0004003d,0x00000006,0x00000048,0x00000047,0x00050085,0x00000006,0x00000049,
+	0x00000046,0x00000048,0x00050081,0x00000006,0x0000004a,0x00000044,0x00000049,0x00060041,
+	0x00000019,0x0000004b,0x0000000d,0x00000027,0x0000002a,0x0004003d,0x00000006,0x0000004c,
+	0x0000004b,0x00050041,0x00000019,0x0000004d,0x0000000e,0x0000002a,0x0004003d,0x00000006,
+	0x0000004e,0x0000004d,0x00050085,0x00000006,0x0000004f,0x0000004c,0x0000004e,0x00050081,
+	0x00000006,0x00000050,0x0000004a,0x0000004f,0x00060050,0x0000000a,0x00000051,0x0000002e,
+	0x0000003f,0x00000050,0x000200fe,0x00000051,0x00010038,0x00050036,0x0000000a,0x00000013,
+	0x00000000,0x0000000c,0x00030037,0x00000009,0x00000011,0x00030037,0x0000000b,0x00000012,
+	0x000200f8,0x00000014,0x00060041,0x00000019,0x00000054,0x00000011,0x00000016,0x00000018,
+	0x0004003d,0x00000006,0x00000055,0x00000054,0x00050041,0x00000019,0x00000056,0x00000012,
+	0x00000018,0x0004003d,0x00000006,0x00000057,0x00000056,0x00050085,0x00000006,0x00000058,
+	0x00000055,0x00000057,0x00060041,0x00000019,0x00000059,0x00000011,0x00000016,0x00000022,
+	0x0004003d,0x00000006,0x0000005a,0x00000059,0x00050041,0x00000019,0x0000005b,0x00000012,
+	0x00000022,0x0004003d,0x00000006,0x0000005c,0x0000005b,0x00050085,0x00000006,0x0000005d,
+	0x0000005a,0x0000005c,0x00050081,0x00000006,0x0000005e,0x00000058,0x0000005d,0x00060041,
+	0x00000019,0x0000005f,0x00000011,0x00000016,0x0000002a,0x0004003d,0x00000006,0x00000060,
+	0x0000005f,0x00050041,0x00000019,0x00000061,0x00000012,0x0000002a,0x0004003d,0x00000006,
+	0x00000062,0x00000061,0x00050085,0x00000006,0x00000063,0x00000060,0x00000062,0x00050081,
+	0x00000006,0x00000064,0x0000005e,0x00000063,0x00060041,0x00000019,0x00000065,0x00000011,
+	0x0000001f,0x00000018,0x0004003d,0x00000006,0x00000066,0x00000065,0x00050041,0x00000019,
+	0x00000067,0x00000012,0x00000018,0x0004003d,0x00000006,0x00000068,0x00000067,0x00050085,
+	0x00000006,0x00000069,0x00000066,0x00000068,0x00060041,0x00000019,0x0000006a,0x00000011,
+	0x0000001f,0x00000022,0x0004003d,0x00000006,0x0000006b,0x0000006a,0x00050041,0x00000019,
+	0x0000006c,0x00000012,0x00000022,0x0004003d,0x00000006,0x0000006d,0x0000006c,0x00050085,
+	0x00000006,0x0000006e,0x0000006b,0x0000006d,0x00050081,0x00000006,0x0000006f,0x00000069,
+	0x0000006e,0x00060041,0x00000019,0x00000070,0x00000011,0x0000001f,0x0000002a,0x0004003d,
+	0x00000006,0x00000071,0x00000070,0x00050041,0x00000019,0x00000072,0x00000012,0x0000002a,
+	0x0004003d,0x00000006,0x00000073,0x00000072,0x00050085,0x00000006,0x00000074,0x00000071,
+	0x00000073,0x00050081,0x00000006,0x00000075,0x0000006f,0x00000074,0x00060041,0x00000019,
+	0x00000076,0x00000011,0x00000027,0x00000018,0x0004003d,0x00000006,0x00000077,0x00000076,
+	0x00050041,0x00000019,0x00000078,0x00000012,0x00000018,0x0004003d,0x00000006,0x00000079,
+	0x00000078,0x00050085,0x00000006,0x0000007a,0x00000077,0x00000079,0x00060041,0x00000019,
+	0x0000007b,0x00000011,0x00000027,0x00000022,0x0004003d,0x00000006,0x0000007c,0x0000007b,
+	0x00050041,0x00000019,0x0000007d,0x00000012,0x00000022,0x0004003d,0x00000006,0x0000007e,
+	0x0000007d,0x00050085,0x00000006,0x0000007f,0x0000007c,0x0000007e,0x00050081,0x00000006,
+	0x00000080,0x0000007a,0x0000007f,0x00060041,0x00000019,0x00000081,0x00000011,0x00000027,
+	0x0000002a,0x0004003d,0x00000006,0x00000082,0x00000081,0x00050041,0x00000019,0x00000083,
+	0x00000012,0x0000002a,0x0004003d,0x00000006,0x00000084,0x00000083,0x00050085,0x00000006,
+	0x00000085,0x00000082,0x00000084,0x00050081,0x00000006,0x00000086,0x00000080,0x00000085,
+	0x00060050,0x0000000a,0x00000087,0x00000064,0x00000075,0x00000086,0x000200fe,0x00000087,
+	0x00010038
+};
+
+static const char flatShadedInstancedMultiViewVertexProgramGLSL[] =
+	"";
+
+static const unsigned int flatShadedInstancedMultiViewVertexProgramSPIRV[] =
+{
+	0x00000000
+};
+
 static const char flatShadedFragmentProgramGLSL[] =
 	"#version " GLSL_VERSION "\n"
 	GLSL_EXTENSIONS
@@ -950,9 +1437,245 @@ static const unsigned int normalMappedMultiViewVertexProgramSPIRV[] =
 	0x00000000
 };
 
-static const char normalMapped100LightsFragmentProgramGLSL[] =
-	"#version " GLSL_VERSION "\n"
-	GLSL_EXTENSIONS
+static ksGpuProgramParm normalMappedInstancedProgramParms[] =
+{
+	{ KS_GPU_PROGRAM_STAGE_FLAG_VERTEX,		KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM,				KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	PROGRAM_UNIFORM_SCENE_MATRICES,		"SceneMatrices",	0 },
+	{ KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT,	KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED,				KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	PROGRAM_TEXTURE_0,					"Texture0",			1 },
+	{ KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT,	KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED,				KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	PROGRAM_TEXTURE_1,					"Texture1",			2 },
+	{ KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT,	KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED,				KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	PROGRAM_TEXTURE_2,					"Texture2",			3 }
+};
+
+static const char normalMappedInstancedVertexProgramGLSL[] =
+	"#version " GLSL_VERSION "\n"
+	GLSL_EXTENSIONS
+	"layout( std140, binding = 0 ) uniform SceneMatrices\n"
+	"{\n"
+	"	layout( offset =   0 ) mat4 ViewMatrix;\n"
+	"	layout( offset =  64 ) mat4 ProjectionMatrix;\n"
+	"};\n"
+	"layout( location = 0 ) in vec3 vertexPosition;\n"
+	"layout( location = 1 ) in vec3 vertexNormal;\n"
+	"layout( location = 2 ) in vec3 vertexTangent;\n"
+	"layout( location = 3 ) in vec3 vertexBinormal;\n"
+	"layout( location = 4 ) in vec2 vertexUv0;\n"
+	"layout( location = 5 ) in mat4 vertexTransform;\n"
+	"layout( location = 0 ) out vec3 fragmentEyeDir;\n"
+	"layout( location = 1 ) out vec3 fragmentNormal;\n"
+	"layout( location = 2 ) out vec3 fragmentTangent;\n"
+	"layout( location = 3 ) out vec3 fragmentBinormal;\n"
+	"layout( location = 4 ) out vec2 fragmentUv0;\n"
+	"out gl_PerVertex { vec4 gl_Position; };\n"
+	"vec3 multiply3x3( mat4 m, vec3 v )\n"
+	"{\n"
+	"	return vec3(\n"
+	"		m[0].x * v.x + m[1].x * v.y + m[2].x * v.z,\n"
+	"		m[0].y * v.x + m[1].y * v.y + m[2].y * v.z,\n"
+	"		m[0].z * v.x + m[1].z * v.y + m[2].z * v.z );\n"
+	"}\n"
+	"vec3 transposeMultiply3x3( mat4 m, vec3 v )\n"
+	"{\n"
+	"	return vec3(\n"
+	"		m[0].x * v.x + m[0].y * v.y + m[0].z * v.z,\n"
+	"		m[1].x * v.x + m[1].y * v.y + m[1].z * v.z,\n"
+	"		m[2].x * v.x + m[2].y * v.y + m[2].z * v.z );\n"
+	"}\n"
+	"void main( void )\n"
+	"{\n"
+	"	vec4 vertexWorldPos = vertexTransform * vec4( vertexPosition, 1.0 );\n"
+	"	vec3 eyeWorldPos = transposeMultiply3x3( ViewMatrix, -vec3( ViewMatrix[3] ) );\n"
+	"	gl_Position = ProjectionMatrix * ( ViewMatrix * vertexWorldPos );\n"
+	"	fragmentEyeDir = eyeWorldPos - vec3( vertexWorldPos );\n"
+	"	fragmentNormal = multiply3x3( vertexTransform, vertexNormal );\n"
+	"	fragmentTangent = multiply3x3( vertexTransform, vertexTangent );\n"
+	"	fragmentBinormal = multiply3x3( vertexTransform, vertexBinormal );\n"
+	"	fragmentUv0 = vertexUv0;\n"
+	"}\n";
+
+// Same as normalMappedVertexProgramSPIRV except that the push constant model matrix is replaced
+// by the per instance vertexTransform attribute at location 5.
+static const unsigned int normalMappedInstancedVertexProgramSPIRV[] =
+{
+	0x07230203,0x00010000,0x00080001,0x000000e1,0x00000000,0x00020011,0x00000001,0x0006000b,
+	0x00000001,0x4c534c47,0x6474732e,0x3035342e,0x00000000,0x0003000e,0x00000000,0x00000001,
+	0x0011000f,0x00000000,0x00000004,0x6e69616d,0x00000000,0x00000093,0x000000b0,0x000000bb,
+	0x000000c3,0x000000c4,0x000000cb,0x000000cc,0x000000d3,0x000000d4,0x000000dd,0x000000df,
+	0x0000008e,0x00030003,0x00000001,0x00000136,0x00040005,0x00000004,0x6e69616d,0x00000000,
+	0x00080005,0x0000000f,0x746c756d,0x796c7069,0x28337833,0x3434666d,0x3366763b,0x0000003b,
+	0x00030005,0x0000000d,0x0000006d,0x00030005,0x0000000e,0x00000076,0x000a0005,0x00000013,
+	0x6e617274,0x736f7073,0x6c754d65,0x6c706974,0x33783379,0x34666d28,0x66763b34,0x00003b33,
+	0x00030005,0x00000011,0x0000006d,0x00030005,0x00000012,0x00000076,0x00060005,0x0000008b,
+	0x74726576,0x6f577865,0x50646c72,0x0000736f,0x00060005,0x0000008e,0x74726576,0x72547865,
+	0x66736e61,0x006d726f,0x00060005,0x00000093,0x74726576,0x6f507865,0x69746973,0x00006e6f,
+	0x00050005,0x0000009b,0x57657965,0x646c726f,0x00736f50,0x00060005,0x0000009c,0x6e656353,
+	0x74614d65,0x65636972,0x00000073,0x00060006,0x0000009c,0x00000000,0x77656956,0x7274614d,
+	0x00007869,0x00080006,0x0000009c,0x00000001,0x6a6f7250,0x69746365,0x614d6e6f,0x78697274,
+	0x00000000,0x00030005,0x0000009e,0x00006275,0x00040005,0x000000a8,0x61726170,0x0000006d,
+	0x00040005,0x000000ac,0x61726170,0x0000006d,0x00060005,0x000000ae,0x505f6c67,0x65567265,
+	0x78657472,0x00000000,0x00060006,0x000000ae,0x00000000,0x505f6c67,0x7469736f,0x006e6f69,
+	0x00070006,0x000000ae,0x00000001,0x505f6c67,0x746e696f,0x657a6953,0x00000000,0x00030005,
+	0x000000b0,0x00000000,0x00060005,0x000000bb,0x67617266,0x746e656d,0x44657945,0x00007269,
+	0x00060005,0x000000c3,0x67617266,0x746e656d,0x6d726f4e,0x00006c61,0x00060005,0x000000c4,
+	0x74726576,0x6f4e7865,0x6c616d72,0x00000000,0x00040005,0x000000c5,0x61726170,0x0000006d,
+	0x00040005,0x000000c8,0x61726170,0x0000006d,0x00060005,0x000000cb,0x67617266,0x746e656d,
+	0x676e6154,0x00746e65,0x00060005,0x000000cc,0x74726576,0x61547865,0x6e65676e,0x00000074,
+	0x00040005,0x000000cd,0x61726170,0x0000006d,0x00040005,0x000000d0,0x61726170,0x0000006d,
+	0x00070005,0x000000d3,0x67617266,0x746e656d,0x6f6e6942,0x6c616d72,0x00000000,0x00060005,
+	0x000000d4,0x74726576,0x69427865,0x6d726f6e,0x00006c61,0x00040005,0x000000d5,0x61726170,
+	0x0000006d,0x00040005,0x000000d8,0x61726170,0x0000006d,0x00050005,0x000000dd,0x67617266,
+	0x746e656d,0x00307655,0x00050005,0x000000df,0x74726576,0x76557865,0x00000030,0x00040047,
+	0x00000093,0x0000001e,0x00000000,0x00040047,0x0000008e,0x0000001e,0x00000005,0x00040048,
+	0x0000009c,0x00000000,0x00000005,0x00050048,0x0000009c,0x00000000,0x00000023,0x00000000,
+	0x00050048,0x0000009c,0x00000000,0x00000007,0x00000010,0x00040048,0x0000009c,0x00000001,
+	0x00000005,0x00050048,0x0000009c,0x00000001,0x00000023,0x00000040,0x00050048,0x0000009c,
+	0x00000001,0x00000007,0x00000010,0x00030047,0x0000009c,0x00000002,0x00040047,0x0000009e,
+	0x00000022,0x00000000,0x00040047,0x0000009e,0x00000021,0x00000000,0x00050048,0x000000ae,
+	0x00000000,0x0000000b,0x00000000,0x00050048,0x000000ae,0x00000001,0x0000000b,0x00000001,
+	0x00030047,0x000000ae,0x00000002,0x00040047,0x000000bb,0x0000001e,0x00000000,0x00040047,
+	0x000000c3,0x0000001e,0x00000001,0x00040047,0x000000c4,0x0000001e,0x00000001,0x00040047,
+	0x000000cb,0x0000001e,0x00000002,0x00040047,0x000000cc,0x0000001e,0x00000002,0x00040047,
+	0x000000d3,0x0000001e,0x00000003,0x00040047,0x000000d4,0x0000001e,0x00000003,0x00040047,
+	0x000000dd,0x0000001e,0x00000004,0x00040047,0x000000df,0x0000001e,0x00000004,0x00020013,
+	0x00000002,0x00030021,0x00000003,0x00000002,0x00030016,0x00000006,0x00000020,0x00040017,
+	0x00000007,0x00000006,0x00000004,0x00040018,0x00000008,0x00000007,0x00000004,0x00040020,
+	0x00000009,0x00000007,0x00000008,0x00040017,0x0000000a,0x00000006,0x00000003,0x00040020,
+	0x0000000b,0x00000007,0x0000000a,0x00050021,0x0000000c,0x0000000a,0x00000009,0x0000000b,
+	0x00040015,0x00000015,0x00000020,0x00000001,0x0004002b,0x00000015,0x00000016,0x00000000,
+	0x00040015,0x00000017,0x00000020,0x00000000,0x0004002b,0x00000017,0x00000018,0x00000000,
+	0x00040020,0x00000019,0x00000007,0x00000006,0x0004002b,0x00000015,0x0000001f,0x00000001,
+	0x0004002b,0x00000017,0x00000022,0x00000001,0x0004002b,0x00000015,0x00000027,0x00000002,
+	0x0004002b,0x00000017,0x0000002a,0x00000002,0x00040020,0x0000008a,0x00000007,0x00000007,
+	0x00040020,0x0000008f,0x00000001,0x00000008,0x0004003b,0x0000008f,0x0000008e,0x00000001,
+	0x00040020,0x00000092,0x00000001,0x0000000a,0x0004003b,0x00000092,0x00000093,0x00000001,
+	0x0004002b,0x00000006,0x00000095,0x3f800000,0x0004001e,0x0000009c,0x00000008,0x00000008,
+	0x00040020,0x0000009d,0x00000002,0x0000009c,0x0004003b,0x0000009d,0x0000009e,0x00000002,
+	0x0004002b,0x00000015,0x0000009f,0x00000003,0x00040020,0x000000a0,0x00000002,0x00000007,
+	0x00040020,0x000000a9,0x00000002,0x00000008,0x0004001e,0x000000ae,0x00000007,0x00000006,
+	0x00040020,0x000000af,0x00000003,0x000000ae,0x0004003b,0x000000af,0x000000b0,0x00000003,
+	0x00040020,0x000000b8,0x00000003,0x00000007,0x00040020,0x000000ba,0x00000003,0x0000000a,
+	0x0004003b,0x000000ba,0x000000bb,0x00000003,0x0004003b,0x000000ba,0x000000c3,0x00000003,
+	0x0004003b,0x00000092,0x000000c4,0x00000001,0x0004003b,0x000000ba,0x000000cb,0x00000003,
+	0x0004003b,0x00000092,0x000000cc,0x00000001,0x0004003b,0x000000ba,0x000000d3,0x00000003,
+	0x0004003b,0x00000092,0x000000d4,0x00000001,0x00040017,0x000000db,0x00000006,0x00000002,
+	0x00040020,0x000000dc,0x00000003,0x000000db,0x0004003b,0x000000dc,0x000000dd,0x00000003,
+	0x00040020,0x000000de,0x00000001,0x000000db,0x0004003b,0x000000de,0x000000df,0x00000001,
+	0x00050036,0x00000002,0x00000004,0x00000000,0x00000003,0x000200f8,0x00000005,0x0004003b,
+	0x0000008a,0x0000008b,0x00000007,0x0004003b,0x0000000b,0x0000009b,0x00000007,0x0004003b,
+	0x00000009,0x000000a8,0x00000007,0x0004003b,0x0000000b,0x000000ac,0x00000007,0x0004003b,
+	0x00000009,0x000000c5,0x00000007,0x0004003b,0x0000000b,0x000000c8,0x00000007,0x0004003b,
+	0x00000009,0x000000cd,0x00000007,0x0004003b,0x0000000b,0x000000d0,0x00000007,0x0004003b,
+	0x00000009,0x000000d5,0x00000007,0x0004003b,0x0000000b,0x000000d8,0x00000007,0x0004003d,
+	0x00000008,0x00000091,0x0000008e,0x0004003d,0x0000000a,0x00000094,0x00000093,0x00050051,
+	0x00000006,0x00000096,0x00000094,0x00000000,0x00050051,0x00000006,0x00000097,0x00000094,
+	0x00000001,0x00050051,0x00000006,0x00000098,0x00000094,0x00000002,0x00070050,0x00000007,
+	0x00000099,0x00000096,0x00000097,0x00000098,0x00000095,0x00050091,0x00000007,0x0000009a,
+	0x00000091,0x00000099,0x0003003e,0x0000008b,0x0000009a,0x00060041,0x000000a0,0x000000a1,
+	0x0000009e,0x00000016,0x0000009f,0x0004003d,0x00000007,0x000000a2,0x000000a1,0x00050051,
+	0x00000006,0x000000a3,0x000000a2,0x00000000,0x00050051,0x00000006,0x000000a4,0x000000a2,
+	0x00000001,0x00050051,0x00000006,0x000000a5,0x000000a2,0x00000002,0x00060050,0x0000000a,
+	0x000000a6,0x000000a3,0x000000a4,0x000000a5,0x0004007f,0x0000000a,0x000000a7,0x000000a6,
+	0x00050041,0x000000a9,0x000000aa,0x0000009e,0x00000016,0x0004003d,0x00000008,0x000000ab,
+	0x000000aa,0x0003003e,0x000000a8,0x000000ab,0x0003003e,0x000000ac,0x000000a7,0x00060039,
+	0x0000000a,0x000000ad,0x00000013,0x000000a8,0x000000ac,0x0003003e,0x0000009b,0x000000ad,
+	0x00050041,0x000000a9,0x000000b1,0x0000009e,0x0000001f,0x0004003d,0x00000008,0x000000b2,
+	0x000000b1,0x00050041,0x000000a9,0x000000b3,0x0000009e,0x00000016,0x0004003d,0x00000008,
+	0x000000b4,0x000000b3,0x0004003d,0x00000007,0x000000b5,0x0000008b,0x00050091,0x00000007,
+	0x000000b6,0x000000b4,0x000000b5,0x00050091,0x00000007,0x000000b7,0x000000b2,0x000000b6,
+	0x00050041,0x000000b8,0x000000b9,0x000000b0,0x00000016,0x0003003e,0x000000b9,0x000000b7,
+	0x0004003d,0x0000000a,0x000000bc,0x0000009b,0x0004003d,0x00000007,0x000000bd,0x0000008b,
+	0x00050051,0x00000006,0x000000be,0x000000bd,0x00000000,0x00050051,0x00000006,0x000000bf,
+	0x000000bd,0x00000001,0x00050051,0x00000006,0x000000c0,0x000000bd,0x00000002,0x00060050,
+	0x0000000a,0x000000c1,0x000000be,0x000000bf,0x000000c0,0x00050083,0x0000000a,0x000000c2,
+	0x000000bc,0x000000c1,0x0003003e,0x000000bb,0x000000c2,0x0004003d,0x00000008,0x000000c7,
+	0x0000008e,0x0003003e,0x000000c5,0x000000c7,0x0004003d,0x0000000a,0x000000c9,0x000000c4,
+	0x0003003e,0x000000c8,0x000000c9,0x00060039,0x0000000a,0x000000ca,0x0000000f,0x000000c5,
+	0x000000c8,0x0003003e,0x000000c3,0x000000ca,0x0004003d,0x00000008,0x000000cf,0x0000008e,
+	0x0003003e,0x000000cd,0x000000cf,0x0004003d,0x0000000a,0x000000d1,0x000000cc,0x0003003e,
+	0x000000d0,0x000000d1,0x00060039,0x0000000a,0x000000d2,0x0000000f,0x000000cd,0x000000d0,
+	0x0003003e,0x000000cb,0x000000d2,0x0004003d,0x00000008,0x000000d7,0x0000008e,0x0003003e,
+	0x000000d5,0x000000d7,0x0004003d,0x0000000a,0x000000d9,0x000000d4,0x0003003e,0x000000d8,
+	0x000000d9,0x00060039,0x0000000a,0x000000da,0x0000000f,0x000000d5,0x000000d8,0x0003003e,
+	0x000000d3,0x000000da,0x0004003d,0x000000db,0x000000e0,0x000000df,0x0003003e,0x000000dd,
+	0x000000e0,0x000100fd,0x00010038,0x00050036,0x0000000a,0x0000000f,0x00000000,0x0000000c,
+	0x00030037,0x00000009,0x0000000d,0x00030037,0x0000000b,0x0000000e,0x000200f8,0x00000010,
+	0x00060041,0x00000019,0x0000001a,0x0000000d,0x00000016,0x00000018,0x0004003d,0x00000006,
+	0x0000001b,0x0000001a,0x00050041,0x00000019,0x0000001c,0x0000000e,0x00000018,0x0004003d,
+	0x00000006,0x0000001d,0x0000001c,0x00050085,0x00000006,0x0000001e,0x0000001b,0x0000001d,
+	0x00060041,0x00000019,0x00000020,0x0000000d,0x0000001f,0x00000018,0x0004003d,0x00000006,
+	0x00000021,0x00000020,0x00050041,0x00000019,0x00000023,0x0000000e,0x00000022,0x0004003d,
+	0x00000006,0x00000024,0x00000023,0x00050085,0x00000006,0x00000025,0x00000021,0x00000024,
+	0x00050081,0x00000006,0x00000026,0x0000001e,0x00000025,0x00060041,0x00000019,0x00000028,
+	0x0000000d,0x00000027,0x00000018,0x0004003d,0x00000006,0x00000029,0x00000028,0x00050041,
+	0x00000019,0x0000002b,0x0000000e,0x0000002a,0x0004003d,0x00000006,0x0000002c,0x0000002b,
+	0x00050085,0x00000006,0x0000002d,0x00000029,0x0000002c,0x00050081,0x00000006,0x0000002e,
+	0x00000026,0x0000002d,0x00060041,0x00000019,0x0000002f,0x0000000d,0x00000016,0x00000022,
+	0x0004003d,0x00000006,0x00000030,0x0000002f,0x00050041,0x00000019,0x00000031,0x0000000e,
+	0x00000018,0x0004003d,0x00000006,0x00000032,0x00000031,0x00050085,0x00000006,0x00000033,
+	0x00000030,0x00000032,0x00060041,0x00000019,0x00000034,0x0000000d,0x0000001f,0x00000022,
+	0x0004003d,0x00000006,0x00000035,0x00000034,0x00050041,0x00000019,0x00000036,0x0000000e,
+	0x00000022,0x0004003d,0x00000006,0x00000037,0x00000036,0x00050085,0x00000006,0x00000038,
+	0x00000035,0x00000037,0x00050081,0x00000006,0x00000039,0x00000033,0x00000038,0x00060041,
+	0x00000019,0x0000003a,0x0000000d,0x00000027,0x00000022,0x0004003d,0x00000006,0x0000003b,
+	0x0000003a,0x00050041,0x00000019,0x0000003c,0x0000000e,0x0000002a,0x0004003d,0x00000006,
+	0x0000003d,0x0000003c,0x00050085,0x00000006,0x0000003e,0x0000003b,0x0000003d,0x00050081,
+	0x00000006,0x0000003f,0x00000039,0x0000003e,0x00060041,0x00000019,0x00000040,0x0000000d,
+	0x00000016,0x0000002a,0x0004003d,0x00000006,0x00000041,0x00000040,0x00050041,0x00000019,
+	0x00000042,0x0000000e,0x00000018,0x0004003d,0x00000006,0x00000043,0x00000042,0x00050085,
+	0x00000006,0x00000044,0x00000041,0x00000043,0x00060041,0x00000019,0x00000045,0x0000000d,
+	0x0000001f,0x0000002a,0x0004003d,0x00000006,0x00000046,0x00000045,0x00050041,0x00000019,
+	0x00000047,0x0000000e,0x00000022,0x0004003d,0x00000006,0x00000048,0x00000047,0x00050085,
+	0x00000006,0x00000049,0x00000046,0x00000048,0x00050081,0x00000006,0x0000004a,0x00000044,
+	0x00000049,0x00060041,0x00000019,0x0000004b,0x0000000d,0x00000027,0x0000002a,0x0004003d,
+	0x00000006,0x0000004c,0x0000004b,0x00050041,0x00000019,0x0000004d,0x0000000e,0x0000002a,
+	0x0004003d,0x00000006,0x0000004e,0x0000004d,0x00050085,0x00000006,0x0000004f,0x0000004c,
+	0x0000004e,0x00050081,0x00000006,0x00000050,0x0000004a,0x0000004f,0x00060050,0x0000000a,
+	0x00000051,0x0000002e,0x0000003f,0x00000050,0x000200fe,0x00000051,0x00010038,0x00050036,
+	0x0000000a,0x00000013,0x00000000,0x0000000c,0x00030037,0x00000009,0x00000011,0x00030037,
+	0x0000000b,0x00000012,0x000200f8,0x00000014,0x00060041,0x00000019,0x00000054,0x00000011,
+	0x00000016,0x00000018,0x0004003d,0x00000006,0x00000055,0x00000054,0x00050041,0x00000019,
+	0x00000056,0x00000012,0x00000018,0x0004003d,0x00000006,0x00000057,0x00000056,0x00050085,
+	0x00000006,0x00000058,0x00000055,0x00000057,0x00060041,0x00000019,0x00000059,0x00000011,
+	0x00000016,0x00000022,0x0004003d,0x00000006,0x0000005a,0x00000059,0x00050041,0x00000019,
+	0x0000005b,0x00000012,0x00000022,0x0004003d,0x00000006,0x0000005c,0x0000005b,0x00050085,
+	0x00000006,0x0000005d,0x0000005a,0x0000005c,0x00050081,0x00000006,0x0000005e,0x00000058,
+	0x0000005d,0x00060041,0x00000019,0x0000005f,0x00000011,0x00000016,0x0000002a,0x0004003d,
+	0x00000006,0x00000060,0x0000005f,0x00050041,0x00000019,0x00000061,0x00000012,0x0000002a,
+	0x0004003d,0x00000006,0x00000062,0x00000061,0x00050085,0x00000006,0x00000063,0x00000060,
+	0x00000062,0x00050081,0x00000006,0x00000064,0x0000005e,0x00000063,0x00060041,0x00000019,
+	0x00000065,0x00000011,0x0000001f,0x00000018,0x0004003d,0x00000006,0x00000066,0x00000065,
+	0x00050041,0x00000019,0x00000067,0x00000012,0x00000018,0x0004003d,0x00000006,0x00000068,
+	0x00000067,0x00050085,0x00000006,0x00000069,0x00000066,0x00000068,0x00060041,0x00000019,
+	0x0000006a,0x00000011,0x0000001f,0x00000022,0x0004003d,0x00000006,0x0000006b,0x0000006a,
+	0x00050041,0x00000019,0x0000006c,0x00000012,0x00000022,0x0004003d,0x00000006,0x0000006d,
+	0x0000006c,0x00050085,0x00000006,0x0000006e,0x0000006b,0x0000006d,0x00050081,0x00000006,
+	0x0000006f,0x00000069,0x0000006e,0x00060041,0x00000019,0x00000070,0x00000011,0x0000001f,
+	0x0000002a,0x0004003d,0x00000006,0x00000071,0x00000070,0x00050041,0x00000019,0x00000072,
+	0x00000012,0x0000002a,0x0004003d,0x00000006,0x00000073,0x00000072,0x00050085,0x00000006,
+	0x00000074,0x00000071,0x00000073,0x00050081,0x00000006,0x00000075,0x0000006f,0x00000074,
+	0x00060041,0x00000019,0x00000076,0x00000011,0x00000027,0x00000018,0x0004003d,0x00000006,
+	0x00000077,0x00000076,0x00050041,0x00000019,0x00000078,0x00000012,0x00000018,0x0004003d,
+	0x00000006,0x00000079,0x00000078,0x00050085,0x00000006,0x0000007a,0x00000077,0x00000079,
+	0x00060041,0x00000019,0x0000007b,0x00000011,0x00000027,0x00000022,0x0004003d,0x00000006,
+	0x0000007c,0x0000007b,0x00050041,0x00000019,0x0000007d,0x00000012,0x00000022,0x0004003d,
+	0x00000006,0x0000007e,0x0000007d,0x00050085,0x00000006,0x0000007f,0x0000007c,0x0000007e,
+	0x00050081,0x00000006,0x00000080,0x0000007a,0x0000007f,0x00060041,0x00000019,0x00000081,
+	0x00000011,0x00000027,0x0000002a,0x0004003d,0x00000006,0x00000082,0x00000081,0x00050041,
+	0x00000019,0x00000083,0x00000012,0x0000002a,0x0004003d,0x00000006,0x00000084,0x00000083,
+	0x00050085,0x00000006,0x00000085,0x00000082,0x00000084,0x00050081,0x00000006,0x00000086,
+	0x00000080,0x00000085,0x00060050,0x0000000a,0x00000087,0x00000064,0x00000075,0x00000086,
+	0x000200fe,0x00000087,0x00010038
+};
+
+static const char normalMappedInstancedMultiViewVertexProgramGLSL[] =
+	"";
+
+static const unsigned int normalMappedInstancedMultiViewVertexProgramSPIRV[] =
+{
+	0x00000000
+};
+
+static const char normalMapped100LightsFragmentProgramGLSL[] =
+	"#version " GLSL_VERSION "\n"
+	GLSL_EXTENSIONS
 	"layout( binding = 1 ) uniform sampler2D Texture0;\n"
 	"layout( binding = 2 ) uniform sampler2D Texture1;\n"
 	"layout( binding = 3 ) uniform sampler2D Texture2;\n"
@@ -1490,6 +2213,130 @@ static const unsigned int normalMapped2000LightsFragmentProgramSPIRV[] =
 	0x0003003e,0x00000089,0x00000025,0x000100fd,0x00010038
 };
 
+static ksGpuProgramParm perfCullComputeProgramParms[] =
+{
+	{ KS_GPU_PROGRAM_STAGE_FLAG_COMPUTE, KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM,	KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	COMPUTE_PROGRAM_UNIFORM_CULL_PARMS,			"CullParms",		0 },
+	{ KS_GPU_PROGRAM_STAGE_FLAG_COMPUTE, KS_GPU_PROGRAM_PARM_TYPE_BUFFER_STORAGE,	KS_GPU_PROGRAM_PARM_ACCESS_WRITE_ONLY,	COMPUTE_PROGRAM_BUFFER_INDIRECT_COMMANDS,	"IndirectCommands",	1 }
+};
+
+static const char perfCullComputeProgramGLSL[] =
+	"#version " GLSL_VERSION "\n"
+	GLSL_EXTENSIONS
+	"\n"
+	"layout( local_size_x = " STRINGIFY( PERF_CULL_LOCAL_SIZE_X ) " ) in;\n"
+	"\n"
+	"layout( std140, binding = 0 ) uniform CullParms\n"
+	"{\n"
+	"	layout( offset =   0 ) vec4 Planes[10];\n"
+	"	layout( offset = 160 ) vec4 Grid;\n"
+	"	layout( offset = 176 ) ivec4 Counts;\n"
+	"};\n"
+	"layout( std430, binding = 1 ) buffer IndirectCommands { uint Commands[]; };\n"
+	"\n"
+	"void main()\n"
+	"{\n"
+	"	int index = int( gl_GlobalInvocationID.x );\n"
+	"	int dimension = Counts.x;\n"
+	"	if ( index < dimension * dimension * dimension )\n"
+	"	{\n"
+	"		vec3 gridPos = vec3( ivec3( index / ( dimension * dimension ), ( index / dimension ) % dimension, index % dimension ) );\n"
+	"		vec4 center = vec4( ( gridPos - vec3( Grid.y ) ) * Grid.x, 1.0 );\n"
+	"		float view0 = min( min( min( min( dot( Planes[0], center ), dot( Planes[1], center ) ), dot( Planes[2], center ) ), dot( Planes[3], center ) ), dot( Planes[4], center ) );\n"
+	"		float view1 = min( min( min( min( dot( Planes[5], center ), dot( Planes[6], center ) ), dot( Planes[7], center ) ), dot( Planes[8], center ) ), dot( Planes[9], center ) );\n"
+	"		Commands[index * 5 + 1] = ( max( view0, view1 ) > -Grid.z ) ? 1u : 0u;\n"
+	"	}\n"
+	"}\n";
+
+// Assembled by hand from the GLSL above.
+static const unsigned int perfCullComputeProgramSPIRV[] =
+{
+	0x07230203,0x00010000,0x00000000,0x00000073,0x00000000,0x00020011,0x00000001,0x0006000b,
+	0x00000001,0x4c534c47,0x6474732e,0x3035342e,0x00000000,0x0003000e,0x00000000,0x00000001,
+	0x0006000f,0x00000005,0x00000004,0x6e69616d,0x00000000,0x00000006,0x00060010,0x00000004,
+	0x00000011,0x00000040,0x00000001,0x00000001,0x00030003,0x00000002,0x000001b8,0x00040005,
+	0x00000004,0x6e69616d,0x00000000,0x00080005,0x00000006,0x475f6c67,0x61626f6c,0x766e496c,
+	0x7461636f,0x496e6f69,0x00000044,0x00050005,0x00000007,0x6c6c7543,0x6d726150,0x00000073,
+	0x00050006,0x00000007,0x00000000,0x6e616c50,0x00007365,0x00050006,0x00000007,0x00000001,
+	0x64697247,0x00000000,0x00050006,0x00000007,0x00000002,0x6e756f43,0x00007374,0x00030005,
+	0x00000008,0x00000000,0x00070005,0x00000009,0x69646e49,0x74636572,0x6d6d6f43,0x73646e61,
+	0x00000000,0x00060006,0x00000009,0x00000000,0x6d6d6f43,0x73646e61,0x00000000,0x00030005,
+	0x0000000a,0x00000000,0x00040047,0x00000006,0x0000000b,0x0000001c,0x00040047,0x0000000b,
+	0x00000006,0x00000010,0x00050048,0x00000007,0x00000000,0x00000023,0x00000000,0x00050048,
+	0x00000007,0x00000001,0x00000023,0x000000a0,0x00050048,0x00000007,0x00000002,0x00000023,
+	0x000000b0,0x00030047,0x00000007,0x00000002,0x00040047,0x00000008,0x00000022,0x00000000,
+	0x00040047,0x00000008,0x00000021,0x00000000,0x00040047,0x0000000c,0x00000006,0x00000004,
+	0x00050048,0x00000009,0x00000000,0x00000023,0x00000000,0x00030047,0x00000009,0x00000003,
+	0x00040047,0x0000000a,0x00000022,0x00000000,0x00040047,0x0000000a,0x00000021,0x00000001,
+	0x00020013,0x00000002,0x00030021,0x00000003,0x00000002,0x00040015,0x0000000d,0x00000020,
+	0x00000001,0x00040015,0x0000000e,0x00000020,0x00000000,0x00040017,0x0000000f,0x0000000e,
+	0x00000003,0x00040020,0x00000010,0x00000001,0x0000000f,0x0004003b,0x00000010,0x00000006,
+	0x00000001,0x0004002b,0x0000000e,0x00000011,0x00000000,0x00030016,0x00000012,0x00000020,
+	0x00040017,0x00000013,0x00000012,0x00000004,0x0004002b,0x0000000e,0x00000014,0x0000000a,
+	0x0004001c,0x0000000b,0x00000013,0x00000014,0x00040017,0x00000015,0x0000000d,0x00000004,
+	0x0005001e,0x00000007,0x0000000b,0x00000013,0x00000015,0x00040020,0x00000016,0x00000002,
+	0x00000007,0x0004003b,0x00000016,0x00000008,0x00000002,0x0004002b,0x0000000d,0x00000017,
+	0x00000000,0x0004002b,0x0000000d,0x00000018,0x00000001,0x0004002b,0x0000000d,0x00000019,
+	0x00000002,0x0004002b,0x0000000d,0x0000001a,0x00000003,0x0004002b,0x0000000d,0x0000001b,
+	0x00000004,0x0004002b,0x0000000d,0x0000001c,0x00000005,0x0004002b,0x0000000d,0x0000001d,
+	0x00000006,0x0004002b,0x0000000d,0x0000001e,0x00000007,0x0004002b,0x0000000d,0x0000001f,
+	0x00000008,0x0004002b,0x0000000d,0x00000020,0x00000009,0x00040020,0x00000021,0x00000002,
+	0x0000000d,0x00020014,0x00000022,0x00040017,0x00000023,0x0000000d,0x00000003,0x00040017,
+	0x00000024,0x00000012,0x00000003,0x00040020,0x00000025,0x00000002,0x00000012,0x0004002b,
+	0x0000000e,0x00000026,0x00000001,0x0004002b,0x0000000e,0x00000027,0x00000002,0x0004002b,
+	0x00000012,0x00000028,0x3f800000,0x00040020,0x00000029,0x00000002,0x00000013,0x0003001d,
+	0x0000000c,0x0000000e,0x0003001e,0x00000009,0x0000000c,0x00040020,0x0000002a,0x00000002,
+	0x00000009,0x0004003b,0x0000002a,0x0000000a,0x00000002,0x00040020,0x0000002b,0x00000002,
+	0x0000000e,0x00050036,0x00000002,0x00000004,0x00000000,0x00000003,0x000200f8,0x00000005,
+	0x0004003d,0x0000000f,0x0000002c,0x00000006,0x00050051,0x0000000e,0x0000002d,0x0000002c,
+	0x00000000,0x0004007c,0x0000000d,0x0000002e,0x0000002d,0x00060041,0x00000021,0x0000002f,
+	0x00000008,0x00000019,0x00000011,0x0004003d,0x0000000d,0x00000030,0x0000002f,0x00050084,
+	0x0000000d,0x00000031,0x00000030,0x00000030,0x00050084,0x0000000d,0x00000032,0x00000031,
+	0x00000030,0x000500b1,0x00000022,0x00000033,0x0000002e,0x00000032,0x000300f7,0x00000034,
+	0x00000000,0x000400fa,0x00000033,0x00000035,0x00000034,0x000200f8,0x00000035,0x00050087,
+	0x0000000d,0x00000036,0x0000002e,0x00000031,0x00050087,0x0000000d,0x00000037,0x0000002e,
+	0x00000030,0x0005008b,0x0000000d,0x00000038,0x00000037,0x00000030,0x0005008b,0x0000000d,
+	0x00000039,0x0000002e,0x00000030,0x00060050,0x00000023,0x0000003a,0x00000036,0x00000038,
+	0x00000039,0x0004006f,0x00000024,0x0000003b,0x0000003a,0x00060041,0x00000025,0x0000003c,
+	0x00000008,0x00000018,0x00000011,0x0004003d,0x00000012,0x0000003d,0x0000003c,0x00060041,
+	0x00000025,0x0000003e,0x00000008,0x00000018,0x00000026,0x0004003d,0x00000012,0x0000003f,
+	0x0000003e,0x00060050,0x00000024,0x00000040,0x0000003f,0x0000003f,0x0000003f,0x00050083,
+	0x00000024,0x00000041,0x0000003b,0x00000040,0x0005008e,0x00000024,0x00000042,0x00000041,
+	0x0000003d,0x00050050,0x00000013,0x00000043,0x00000042,0x00000028,0x00060041,0x00000029,
+	0x00000044,0x00000008,0x00000017,0x00000017,0x0004003d,0x00000013,0x00000045,0x00000044,
+	0x00050094,0x00000012,0x00000046,0x00000045,0x00000043,0x00060041,0x00000029,0x00000047,
+	0x00000008,0x00000017,0x00000018,0x0004003d,0x00000013,0x00000048,0x00000047,0x00050094,
+	0x00000012,0x00000049,0x00000048,0x00000043,0x00060041,0x00000029,0x0000004a,0x00000008,
+	0x00000017,0x00000019,0x0004003d,0x00000013,0x0000004b,0x0000004a,0x00050094,0x00000012,
+	0x0000004c,0x0000004b,0x00000043,0x00060041,0x00000029,0x0000004d,0x00000008,0x00000017,
+	0x0000001a,0x0004003d,0x00000013,0x0000004e,0x0000004d,0x00050094,0x00000012,0x0000004f,
+	0x0000004e,0x00000043,0x00060041,0x00000029,0x00000050,0x00000008,0x00000017,0x0000001b,
+	0x0004003d,0x00000013,0x00000051,0x00000050,0x00050094,0x00000012,0x00000052,0x00000051,
+	0x00000043,0x00060041,0x00000029,0x00000053,0x00000008,0x00000017,0x0000001c,0x0004003d,
+	0x00000013,0x00000054,0x00000053,0x00050094,0x00000012,0x00000055,0x00000054,0x00000043,
+	0x00060041,0x00000029,0x00000056,0x00000008,0x00000017,0x0000001d,0x0004003d,0x00000013,
+	0x00000057,0x00000056,0x00050094,0x00000012,0x00000058,0x00000057,0x00000043,0x00060041,
+	0x00000029,0x00000059,0x00000008,0x00000017,0x0000001e,0x0004003d,0x00000013,0x0000005a,
+	0x00000059,0x00050094,0x00000012,0x0000005b,0x0000005a,0x00000043,0x00060041,0x00000029,
+	0x0000005c,0x00000008,0x00000017,0x0000001f,0x0004003d,0x00000013,0x0000005d,0x0000005c,
+	0x00050094,0x00000012,0x0000005e,0x0000005d,0x00000043,0x00060041,0x00000029,0x0000005f,
+	0x00000008,0x00000017,0x00000020,0x0004003d,0x00000013,0x00000060,0x0000005f,0x00050094,
+	0x00000012,0x00000061,0x00000060,0x00000043,0x0007000c,0x00000012,0x00000062,0x00000001,
+	0x00000025,0x00000046,0x00000049,0x0007000c,0x00000012,0x00000063,0x00000001,0x00000025,
+	0x00000062,0x0000004c,0x0007000c,0x00000012,0x00000064,0x00000001,0x00000025,0x00000063,
+	0x0000004f,0x0007000c,0x00000012,0x00000065,0x00000001,0x00000025,0x00000064,0x00000052,
+	0x0007000c,0x00000012,0x00000066,0x00000001,0x00000025,0x00000055,0x00000058,0x0007000c,
+	0x00000012,0x00000067,0x00000001,0x00000025,0x00000066,0x0000005b,0x0007000c,0x00000012,
+	0x00000068,0x00000001,0x00000025,0x00000067,0x0000005e,0x0007000c,0x00000012,0x00000069,
+	0x00000001,0x00000025,0x00000068,0x00000061,0x0007000c,0x00000012,0x0000006a,0x00000001,
+	0x00000028,0x00000065,0x00000069,0x00060041,0x00000025,0x0000006b,0x00000008,0x00000018,
+	0x00000027,0x0004003d,0x00000012,0x0000006c,0x0000006b,0x0004007f,0x00000012,0x0000006d,
+	0x0000006c,0x000500ba,0x00000022,0x0000006e,0x0000006a,0x0000006d,0x000600a9,0x0000000e,
+	0x0000006f,0x0000006e,0x00000026,0x00000011,0x00050084,0x0000000d,0x00000070,0x0000002e,
+	0x0000001c,0x00050080,0x0000000d,0x00000071,0x00000070,0x00000018,0x00060041,0x0000002b,
+	0x00000072,0x0000000a,0x00000017,0x00000071,0x0003003e,0x00000072,0x0000006f,0x000200f9,
+	0x00000034,0x000200f8,0x00000034,0x000100fd,0x00010038
+};
+
 #elif GRAPHICS_API_D3D == 1
 
 static ksGpuProgramParm flatShadedProgramParms[] =
@@ -1504,6 +2351,17 @@ static const char flatShadedVertexProgramHLSL[] =
 static const char flatShadedMultiViewVertexProgramHLSL[] =
 	"";
 
+static ksGpuProgramParm flatShadedInstancedProgramParms[] =
+{
+	{ KS_GPU_PROGRAM_STAGE_FLAG_VERTEX,	KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM,				KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	PROGRAM_UNIFORM_SCENE_MATRICES,		"SceneMatrices",	0 }
+};
+
+static const char flatShadedInstancedVertexProgramHLSL[] =
+	"";
+
+static const char flatShadedInstancedMultiViewVertexProgramHLSL[] =
+	"";
+
 static const char flatShadedFragmentProgramHLSL[] =
 	"";
 
@@ -1522,6 +2380,20 @@ static const char normalMappedVertexProgramHLSL[] =
 static const char normalMappedMultiViewVertexProgramHLSL[] =
 	"";
 
+static ksGpuProgramParm normalMappedInstancedProgramParms[] =
+{
+	{ KS_GPU_PROGRAM_STAGE_FLAG_VERTEX,		KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM,				KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	PROGRAM_UNIFORM_SCENE_MATRICES,		"SceneMatrices",	0 },
+	{ KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT,	KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED,				KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	PROGRAM_TEXTURE_0,					"Texture0",			0 },
+	{ KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT,	KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED,				KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	PROGRAM_TEXTURE_1,					"Texture1",			1 },
+	{ KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT,	KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED,				KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	PROGRAM_TEXTURE_2,					"Texture2",			2 }
+};
+
+static const char normalMappedInstancedVertexProgramHLSL[] =
+	"";
+
+static const char normalMappedInstancedMultiViewVertexProgramHLSL[] =
+	"";
+
 static const char normalMapped100LightsFragmentProgramHLSL[] =
 	"";
 
@@ -1531,6 +2403,15 @@ static const char normalMapped1000LightsFragmentProgramHLSL[] =
 static const char normalMapped2000LightsFragmentProgramHLSL[] =
 	"";
 
+static ksGpuProgramParm perfCullComputeProgramParms[] =
+{
+	{ KS_GPU_PROGRAM_STAGE_FLAG_COMPUTE, KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM,	KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	COMPUTE_PROGRAM_UNIFORM_CULL_PARMS,			"CullParms",		0 },
+	{ KS_GPU_PROGRAM_STAGE_FLAG_COMPUTE, KS_GPU_PROGRAM_PARM_TYPE_BUFFER_STORAGE,	KS_GPU_PROGRAM_PARM_ACCESS_WRITE_ONLY,	COMPUTE_PROGRAM_BUFFER_INDIRECT_COMMANDS,	"IndirectCommands",	0 }
+};
+
+static const char perfCullComputeProgramHLSL[] =
+	"";
+
 #elif GRAPHICS_API_METAL == 1
 
 static ksGpuProgramParm flatShadedProgramParms[] =
@@ -1545,6 +2426,17 @@ static const char flatShadedVertexProgramMetalSL[] =
 static const char flatShadedMultiViewVertexProgramMetalSL[] =
 	"";
 
+static ksGpuProgramParm flatShadedInstancedProgramParms[] =
+{
+	{ KS_GPU_PROGRAM_STAGE_FLAG_VERTEX,	KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM,				KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	PROGRAM_UNIFORM_SCENE_MATRICES,		"SceneMatrices",	0 }
+};
+
+static const char flatShadedInstancedVertexProgramMetalSL[] =
+	"";
+
+static const char flatShadedInstancedMultiViewVertexProgramMetalSL[] =
+	"";
+
 static const char flatShadedFragmentProgramMetalSL[] =
 	"";
 
@@ -1563,6 +2455,20 @@ static const char normalMappedVertexProgramMetalSL[] =
 static const char normalMappedMultiViewVertexProgramMetalSL[] =
 	"";
 
+static ksGpuProgramParm normalMappedInstancedProgramParms[] =
+{
+	{ KS_GPU_PROGRAM_STAGE_FLAG_VERTEX,		KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM,				KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	PROGRAM_UNIFORM_SCENE_MATRICES,		"SceneMatrices",	0 },
+	{ KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT,	KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED,				KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	PROGRAM_TEXTURE_0,					"Texture0",			0 },
+	{ KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT,	KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED,				KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	PROGRAM_TEXTURE_1,					"Texture1",			1 },
+	{ KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT,	KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED,				KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	PROGRAM_TEXTURE_2,					"Texture2",			2 }
+};
+
+static const char normalMappedInstancedVertexProgramMetalSL[] =
+	"";
+
+static const char normalMappedInstancedMultiViewVertexProgramMetalSL[] =
+	"";
+
 static const char normalMapped100LightsFragmentProgramMetalSL[] =
 	"";
 
@@ -1572,6 +2478,15 @@ static const char normalMapped1000LightsFragmentProgramMetalSL[] =
 static const char normalMapped2000LightsFragmentProgramMetalSL[] =
 	"";
 
+static ksGpuProgramParm perfCullComputeProgramParms[] =
+{
+	{ KS_GPU_PROGRAM_STAGE_FLAG_COMPUTE, KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM,	KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,	COMPUTE_PROGRAM_UNIFORM_CULL_PARMS,			"CullParms",		0 },
+	{ KS_GPU_PROGRAM_STAGE_FLAG_COMPUTE, KS_GPU_PROGRAM_PARM_TYPE_BUFFER_STORAGE,	KS_GPU_PROGRAM_PARM_ACCESS_WRITE_ONLY,	COMPUTE_PROGRAM_BUFFER_INDIRECT_COMMANDS,	"IndirectCommands",	0 }
+};
+
+static const char perfCullComputeProgramMetalSL[] =
+	"";
+
 #endif
 
 static void ksPerfScene_Create( ksGpuContext * context, ksPerfScene * scene, ksSceneSettings * settings, ksGpuRenderPass * renderPass )
@@ -1583,6 +2498,20 @@ static void ksPerfScene_Create( ksGpuContext * context, ksPerfScene * scene, ksS
 	ksGpuGeometry_CreateTorus( context, &scene->geometry[2], 16, 0.0f, 1.0f );	// 512 triangles
 	ksGpuGeometry_CreateTorus( context, &scene->geometry[3], 32, 0.0f, 1.0f );	// 2048 triangles
 
+	const int maxDimension = PERF_MAX_DIMENSION;
+
+	scene->drawInstanced = ( PERF_INSTANCED_PROGRAMS != 0 );
+	if ( !scene->drawInstanced && ( settings->useInstancing || settings->useIndirect ) )
+	{
+		Print( "Instanced and indirect draws are not supported by this graphics API.\n" );
+	}
+
+	// Add a model matrix per object for the instanced draw calls.
+	for ( int i = 0; i < MAX_SCENE_TRIANGLE_LEVELS && scene->drawInstanced; i++ )
+	{
+		ksGpuGeometry_AddInstanceAttributes( context, &scene->geometry[i], maxDimension * maxDimension * maxDimension, VERTEX_ATTRIBUTE_FLAG_TRANSFORM );
+	}
+
 	ksGpuGraphicsProgram_Create( context, &scene->program[0],
 								settings->useMultiView ? PROGRAM( flatShadedMultiViewVertexProgram ) : PROGRAM( flatShadedVertexProgram ),
 								settings->useMultiView ? sizeof( PROGRAM( flatShadedMultiViewVertexProgram ) ) : sizeof( PROGRAM( flatShadedVertexProgram ) ),
@@ -1618,6 +2547,45 @@ static void ksPerfScene_Create( ksGpuContext * context, ksPerfScene * scene, ksS
 								VERTEX_ATTRIBUTE_FLAG_TANGENT | VERTEX_ATTRIBUTE_FLAG_BINORMAL |
 								VERTEX_ATTRIBUTE_FLAG_UV0 );
 
+	if ( scene->drawInstanced )
+	{
+		ksGpuGraphicsProgram_Create( context, &scene->instancedProgram[0],
+									settings->useMultiView ? PROGRAM( flatShadedInstancedMultiViewVertexProgram ) : PROGRAM( flatShadedInstancedVertexProgram ),
+									settings->useMultiView ? sizeof( PROGRAM( flatShadedInstancedMultiViewVertexProgram ) ) : sizeof( PROGRAM( flatShadedInstancedVertexProgram ) ),
+									PROGRAM( flatShadedFragmentProgram ),
+									sizeof( PROGRAM( flatShadedFragmentProgram ) ),
+									flatShadedInstancedProgramParms, ARRAY_SIZE( flatShadedInstancedProgramParms ),
+									scene->geometry[0].layout, VERTEX_ATTRIBUTE_FLAG_POSITION | VERTEX_ATTRIBUTE_FLAG_NORMAL |
+									VERTEX_ATTRIBUTE_FLAG_TRANSFORM );
+		ksGpuGraphicsProgram_Create( context, &scene->instancedProgram[1],
+									settings->useMultiView ? PROGRAM( normalMappedInstancedMultiViewVertexProgram ) : PROGRAM( normalMappedInstancedVertexProgram ),
+									settings->useMultiView ? sizeof( PROGRAM( normalMappedInstancedMultiViewVertexProgram ) ) : sizeof( PROGRAM( normalMappedInstancedVertexProgram ) ),
+									PROGRAM( normalMapped100LightsFragmentProgram ),
+									sizeof( PROGRAM( normalMapped100LightsFragmentProgram ) ),
+									normalMappedInstancedProgramParms, ARRAY_SIZE( normalMappedInstancedProgramParms ),
+									scene->geometry[0].layout, VERTEX_ATTRIBUTE_FLAG_POSITION | VERTEX_ATTRIBUTE_FLAG_NORMAL |
+									VERTEX_ATTRIBUTE_FLAG_TANGENT | VERTEX_ATTRIBUTE_FLAG_BINORMAL |
+									VERTEX_ATTRIBUTE_FLAG_UV0 | VERTEX_ATTRIBUTE_FLAG_TRANSFORM );
+		ksGpuGraphicsProgram_Create( context, &scene->instancedProgram[2],
+									settings->useMultiView ? PROGRAM( normalMappedInstancedMultiViewVertexProgram ) : PROGRAM( normalMappedInstancedVertexProgram ),
+									settings->useMultiView ? sizeof( PROGRAM( normalMappedInstancedMultiViewVertexProgram ) ) : sizeof( PROGRAM( normalMappedInstancedVertexProgram ) ),
+									PROGRAM( normalMapped1000LightsFragmentProgram ),
+									sizeof( PROGRAM( normalMapped1000LightsFragmentProgram ) ),
+									normalMappedInstancedProgramParms, ARRAY_SIZE( normalMappedInstancedProgramParms ),
+									scene->geometry[0].layout, VERTEX_ATTRIBUTE_FLAG_POSITION | VERTEX_ATTRIBUTE_FLAG_NORMAL |
+									VERTEX_ATTRIBUTE_FLAG_TANGENT | VERTEX_ATTRIBUTE_FLAG_BINORMAL |
+									VERTEX_ATTRIBUTE_FLAG_UV0 | VERTEX_ATTRIBUTE_FLAG_TRANSFORM );
+		ksGpuGraphicsProgram_Create( context, &scene->instancedProgram[3],
+									settings->useMultiView ? PROGRAM( normalMappedInstancedMultiViewVertexProgram ) : PROGRAM( normalMappedInstancedVertexProgram ),
+									settings->useMultiView ? sizeof( PROGRAM( normalMappedInstancedMultiViewVertexProgram ) ) : sizeof( PROGRAM( normalMappedInstancedVertexProgram ) ),
+									PROGRAM( normalMapped2000LightsFragmentProgram ),
+									sizeof( PROGRAM( normalMapped2000LightsFragmentProgram ) ),
+									normalMappedInstancedProgramParms, ARRAY_SIZE( normalMappedInstancedProgramParms ),
+									scene->geometry[0].layout, VERTEX_ATTRIBUTE_FLAG_POSITION | VERTEX_ATTRIBUTE_FLAG_NORMAL |
+									VERTEX_ATTRIBUTE_FLAG_TANGENT | VERTEX_ATTRIBUTE_FLAG_BINORMAL |
+									VERTEX_ATTRIBUTE_FLAG_UV0 | VERTEX_ATTRIBUTE_FLAG_TRANSFORM );
+	}
+
 	for ( int i = 0; i < MAX_SCENE_TRIANGLE_LEVELS; i++ )
 	{
 		for ( int j = 0; j < MAX_SCENE_FRAGMENT_LEVELS; j++ )
@@ -1633,7 +2601,55 @@ static void ksPerfScene_Create( ksGpuContext * context, ksPerfScene * scene, ksS
 		}
 	}
 
+	for ( int i = 0; i < MAX_SCENE_TRIANGLE_LEVELS && scene->drawInstanced; i++ )
+	{
+		for ( int j = 0; j < MAX_SCENE_FRAGMENT_LEVELS; j++ )
+		{
+			ksGpuGraphicsPipelineParms pipelineParms;
+			ksGpuGraphicsPipelineParms_Init( &pipelineParms );
+
+			pipelineParms.renderPass = renderPass;
+			pipelineParms.program = &scene->instancedProgram[j];
+			pipelineParms.geometry = &scene->geometry[i];
+
+			ksGpuGraphicsPipeline_Create( context, &scene->instancedPipelines[i][j], &pipelineParms );
+		}
+	}
+
+	// The indirect draw commands are built once on the CPU, so the CPU cost of an indirect draw does not depend on the
+	// number of objects. Each object is drawn as a single instance that picks up its model matrix from the instance buffer.
+	// Every frame a compute program culls the objects against the view frustum by setting the instance count of each
+	// command to either zero or one. The draw call level only changes the number of commands that are drawn.
+	ksGpuLimits limits;
+	ksGpuContext_GetLimits( context, &limits );
+	scene->drawIndirect = scene->drawInstanced && limits.drawIndirect;
+	if ( scene->drawIndirect )
+	{
+		const int maxObjects = maxDimension * maxDimension * maxDimension;
+		ksGpuDrawIndirectCommand * indirectCommands = (ksGpuDrawIndirectCommand *) malloc( maxObjects * sizeof( ksGpuDrawIndirectCommand ) );
+		for ( int i = 0; i < MAX_SCENE_TRIANGLE_LEVELS; i++ )
+		{
+			for ( int j = 0; j < maxObjects; j++ )
+			{
+				indirectCommands[j].indexCount = scene->geometry[i].indexCount;
+				indirectCommands[j].instanceCount = 1;
+				indirectCommands[j].firstIndex = 0;
+				indirectCommands[j].vertexOffset = 0;
+				indirectCommands[j].firstInstance = j;
+			}
+			ksGpuBuffer_Create( context, &scene->indirectBuffers[i], KS_GPU_BUFFER_TYPE_INDIRECT, maxObjects * sizeof( ksGpuDrawIndirectCommand ), indirectCommands, false );
+		}
+		free( indirectCommands );
+
+		ksGpuComputeProgram_Create( context, &scene->cullProgram,
+									PROGRAM( perfCullComputeProgram ), sizeof( PROGRAM( perfCullComputeProgram ) ),
+									perfCullComputeProgramParms, ARRAY_SIZE( perfCullComputeProgramParms ) );
+		ksGpuComputePipeline_Create( context, &scene->cullPipeline, &scene->cullProgram );
+		ksGpuBuffer_Create( context, &scene->cullParms, KS_GPU_BUFFER_TYPE_UNIFORM, sizeof( ksPerfSceneCullParms ), NULL, false );
+	}
+
 	ksGpuBuffer_Create( context, &scene->sceneMatrices, KS_GPU_BUFFER_TYPE_UNIFORM, ( settings->useMultiView ? 4 : 2 ) * sizeof( ksMatrix4x4f ), NULL, false );
+	scene->sceneMatricesBinding = &scene->sceneMatrices;
 
 	ksGpuTexture_CreateDefault( context, &scene->diffuseTexture, KS_GPU_TEXTURE_DEFAULT_CHECKERBOARD, 256, 256, 0, 0, 1, true, false );
 	ksGpuTexture_CreateDefault( context, &scene->specularTexture, KS_GPU_TEXTURE_DEFAULT_CHECKERBOARD, 256, 256, 0, 0, 1, true, false );
@@ -1642,14 +2658,15 @@ static void ksPerfScene_Create( ksGpuContext * context, ksPerfScene * scene, ksS
 	scene->settings = *settings;
 	scene->newSettings = settings;
 
-	const int maxDimension = 2 * ( 1 << ( MAX_SCENE_DRAWCALL_LEVELS - 1 ) );
-
 	scene->bigRotationX = 0.0f;
 	scene->bigRotationY = 0.0f;
 	scene->smallRotationX = 0.0f;
 	scene->smallRotationY = 0.0f;
 
 	scene->modelMatrix = (ksMatrix4x4f *) AllocAlignedMemory( maxDimension * maxDimension * maxDimension * sizeof( ksMatrix4x4f ), sizeof( ksMatrix4x4f ) );
+
+	// The worker threads are only created when the draw call level is first raised to a large grid.
+	scene->useThreadPool = false;
 }
 
 static void ksPerfScene_Destroy( ksGpuContext * context, ksPerfScene * scene )
@@ -1661,6 +2678,10 @@ static void ksPerfScene_Destroy( ksGpuContext * context, ksPerfScene * scene )
 		for ( int j = 0; j < MAX_SCENE_FRAGMENT_LEVELS; j++ )
 		{
 			ksGpuGraphicsPipeline_Destroy( context, &scene->pipelines[i][j] );
+			if ( scene->drawInstanced )
+			{
+				ksGpuGraphicsPipeline_Destroy( context, &scene->instancedPipelines[i][j] );
+			}
 		}
 	}
 
@@ -1672,6 +2693,21 @@ static void ksPerfScene_Destroy( ksGpuContext * context, ksPerfScene * scene )
 	for ( int i = 0; i < MAX_SCENE_FRAGMENT_LEVELS; i++ )
 	{
 		ksGpuGraphicsProgram_Destroy( context, &scene->program[i] );
+		if ( scene->drawInstanced )
+		{
+			ksGpuGraphicsProgram_Destroy( context, &scene->instancedProgram[i] );
+		}
+	}
+
+	if ( scene->drawIndirect )
+	{
+		for ( int i = 0; i < MAX_SCENE_TRIANGLE_LEVELS; i++ )
+		{
+			ksGpuBuffer_Destroy( context, &scene->indirectBuffers[i] );
+		}
+		ksGpuComputePipeline_Destroy( context, &scene->cullPipeline );
+		ksGpuComputeProgram_Destroy( context, &scene->cullProgram );
+		ksGpuBuffer_Destroy( context, &scene->cullParms );
 	}
 
 	ksGpuBuffer_Destroy( context, &scene->sceneMatrices );
@@ -1680,6 +2716,12 @@ static void ksPerfScene_Destroy( ksGpuContext * context, ksPerfScene * scene )
 	ksGpuTexture_Destroy( context, &scene->specularTexture );
 	ksGpuTexture_Destroy( context, &scene->normalTexture );
 
+	if ( scene->useThreadPool )
+	{
+		ksThreadPool_Destroy( &scene->threadPool );
+		scene->useThreadPool = false;
+	}
+
 	FreeAlignedMemory( scene->modelMatrix );
 	scene->modelMatrix = NULL;
 }
@@ -1703,6 +2745,226 @@ static void ksPerfScene_Simulate( ksPerfScene * scene, ksViewState * viewState,
 	}
 }
 
+// Calculates the model matrices of one slice of the grid with constant x.
+// The small transform is calculated with the same operations in the same order as
+// ksMatrix4x4f_Multiply( smallTranslationMatrix, smallRotationMatrix ) but the part
+// that does not depend on the translation is only calculated once per frame.
+// As a result the model matrices are bit-identical to those of the straight forward loop,
+// as long as the compiler does not contract the scalar code into fused multiply-adds.
+static void ksPerfScene_CalculateModelMatrixSlice( const ksPerfSceneMatrixJobs * jobs, const int x )
+{
+	const int dimension = jobs->dimension;
+	const ksMatrix4x4f * partial = &jobs->smallRotationPartial;
+	const ksMatrix4x4f * rotation = &jobs->smallRotationMatrix;
+	ksMatrix4x4f * modelMatrices = jobs->modelMatrices + x * dimension * dimension;
+
+	for ( int y = 0; y < dimension; y++ )
+	{
+		for ( int z = 0; z < dimension; z++ )
+		{
+			ksMatrix4x4f smallTransformMatrix;
+#if defined( KSALGEBRA_USE_SSE )
+			const __m128 translation = _mm_set_ps( 1.0f, jobs->offsets[z], jobs->offsets[y], jobs->offsets[x] );
+			for ( int i = 0; i < 4; i++ )
+			{
+				const __m128 r = _mm_add_ps( _mm_loadu_ps( partial->m[i] ), _mm_mul_ps( translation, _mm_set1_ps( rotation->m[i][3] ) ) );
+				_mm_storeu_ps( smallTransformMatrix.m[i], r );
+			}
+#elif defined( KSALGEBRA_USE_NEON )
+			const float translationValues[4] = { jobs->offsets[x], jobs->offsets[y], jobs->offsets[z], 1.0f };
+			const float32x4_t translation = vld1q_f32( translationValues );
+			for ( int i = 0; i < 4; i++ )
+			{
+				const float32x4_t r = vaddq_f32( vld1q_f32( partial->m[i] ), vmulq_f32( translation, vdupq_n_f32( rotation->m[i][3] ) ) );
+				vst1q_f32( smallTransformMatrix.m[i], r );
+			}
+#else
+			for ( int i = 0; i < 4; i++ )
+			{
+				smallTransformMatrix.m[i][0] = partial->m[i][0] + jobs->offsets[x] * rotation->m[i][3];
+				smallTransformMatrix.m[i][1] = partial->m[i][1] + jobs->offsets[y] * rotation->m[i][3];
+				smallTransformMatrix.m[i][2] = partial->m[i][2] + jobs->offsets[z] * rotation->m[i][3];
+				smallTransformMatrix.m[i][3] = partial->m[i][3] + 1.0f * rotation->m[i][3];
+			}
+#endif
+			ksMatrix4x4f_Multiply( &modelMatrices[y * dimension + z], &jobs->bigTransformMatrix, &smallTransformMatrix );
+		}
+	}
+}
+
+static void ksPerfScene_MatrixJobThread( void * data )
+{
+	ksPerfSceneMatrixJobs * jobs = (ksPerfSceneMatrixJobs *)data;
+
+	// Loop until no more slices to process.
+	for ( ; ; )
+	{
+		// Atomically add 1 to claim a slice.
+		const unsigned int x = ksAtomicUint32_Increment( &jobs->nextSlice ) - 1;
+
+		// Done when all slices have been claimed for processing.
+		if ( x >= (unsigned int)jobs->dimension )
+		{
+			break;
+		}
+
+		ksPerfScene_CalculateModelMatrixSlice( jobs, (int)x );
+	}
+}
+
+// Calculates the model matrices of all objects in the grid for the current draw call level.
+// This only touches CPU memory, so it can be timed without a GPU.
+// Large grids are split across the worker threads.
+static void ksPerfScene_CalculateModelMatrices( ksPerfScene * scene, ksMatrix4x4f * modelMatrices )
+{
+	ksPerfSceneMatrixJobs * jobs = &scene->matrixJobs;
+
+	const int dimension = 2 * ( 1 << scene->settings.drawCallLevel );
+	const float cubeOffset = ( dimension - 1.0f ) * 0.5f;
+	const float cubeScale = PERF_OBJECT_SPACING;
+
+	ksMatrix4x4f bigRotationMatrix;
+	ksMatrix4x4f_CreateRotation( &bigRotationMatrix, scene->bigRotationX, scene->bigRotationY, 0.0f );
+
+	ksMatrix4x4f bigTranslationMatrix;
+	ksMatrix4x4f_CreateTranslation( &bigTranslationMatrix, 0.0f, 0.0f, - 2.5f * dimension );
+
+	ksMatrix4x4f_Multiply( &jobs->bigTransformMatrix, &bigTranslationMatrix, &bigRotationMatrix );
+
+	ksMatrix4x4f_CreateRotation( &jobs->smallRotationMatrix, scene->smallRotationX, scene->smallRotationY, 0.0f );
+
+	// The first three columns of a translation matrix are the identity.
+	ksMatrix4x4f identityMatrix;
+	ksMatrix4x4f_CreateIdentity( &identityMatrix );
+	for ( int i = 0; i < 4; i++ )
+	{
+		for ( int j = 0; j < 4; j++ )
+		{
+			jobs->smallRotationPartial.m[i][j] =	identityMatrix.m[0][j] * jobs->smallRotationMatrix.m[i][0] +
+													identityMatrix.m[1][j] * jobs->smallRotationMatrix.m[i][1] +
+													identityMatrix.m[2][j] * jobs->smallRotationMatrix.m[i][2];
+		}
+	}
+
+	for ( int i = 0; i < dimension; i++ )
+	{
+		jobs->offsets[i] = cubeScale * ( i - cubeOffset );
+	}
+
+	jobs->modelMatrices = modelMatrices;
+	jobs->dimension = dimension;
+	jobs->nextSlice = 0;
+
+	if ( dimension * dimension * dimension >= PERF_THREAD_POOL_OBJECTS )
+	{
+		if ( !scene->useThreadPool )
+		{
+			ksThreadPool_Create( &scene->threadPool, PERF_WORKERS );
+			scene->useThreadPool = true;
+		}
+		ksThreadPool_Submit( &scene->threadPool, ksPerfScene_MatrixJobThread, jobs );
+		ksThreadPool_Join( &scene->threadPool );
+	}
+	else
+	{
+		ksPerfScene_MatrixJobThread( jobs );
+	}
+}
+
+// Calculates the left, right, bottom, top and near plane of a view frustum in the space of the grid.
+// The planes are normalized, so the dot product of a plane with a point is the distance to the plane.
+// The far plane is left out because the projection may place it at infinity. The near plane w + z = 0
+// of an OpenGL projection lies behind the near plane of a Vulkan projection, so it is conservative for both.
+static void ksPerfScene_GetCullPlanes( ksVector4f planes[5], const ksMatrix4x4f * projectionMatrix, const ksMatrix4x4f * viewMatrix, const ksMatrix4x4f * gridMatrix )
+{
+	ksMatrix4x4f viewGridMatrix;
+	ksMatrix4x4f_Multiply( &viewGridMatrix, viewMatrix, gridMatrix );
+
+	ksMatrix4x4f clipMatrix;
+	ksMatrix4x4f_Multiply( &clipMatrix, projectionMatrix, &viewGridMatrix );
+
+	const int rows[5] = { 0, 0, 1, 1, 2 };
+	const float signs[5] = { 1.0f, -1.0f, 1.0f, -1.0f, 1.0f };
+	for ( int i = 0; i < 5; i++ )
+	{
+		const float x = clipMatrix.m[0][3] + signs[i] * clipMatrix.m[0][rows[i]];
+		const float y = clipMatrix.m[1][3] + signs[i] * clipMatrix.m[1][rows[i]];
+		const float z = clipMatrix.m[2][3] + signs[i] * clipMatrix.m[2][rows[i]];
+		const float w = clipMatrix.m[3][3] + signs[i] * clipMatrix.m[3][rows[i]];
+		const float length = sqrtf( x * x + y * y + z * z );
+		const float scale = ( length > 0.0f ) ? 1.0f / length : 0.0f;
+		planes[i].x = x * scale;
+		planes[i].y = y * scale;
+		planes[i].z = z * scale;
+		planes[i].w = w * scale;
+	}
+}
+
+// Returns true if the cull compute program sets the instance count of the object with the given grid index to one.
+// This performs the same calculations as the compute program so the culling can be verified on the CPU.
+static bool ksPerfScene_IsObjectVisible( const ksPerfSceneCullParms * parms, const int index )
+{
+	const int dimension = parms->counts.x;
+	const float x = ( (float)( index / ( dimension * dimension ) ) - parms->grid.y ) * parms->grid.x;
+	const float y = ( (float)( ( index / dimension ) % dimension ) - parms->grid.y ) * parms->grid.x;
+	const float z = ( (float)( index % dimension ) - parms->grid.y ) * parms->grid.x;
+
+	float maxDistance = 0.0f;
+	for ( int view = 0; view < 2; view++ )
+	{
+		float minDistance = 0.0f;
+		for ( int i = 0; i < 5; i++ )
+		{
+			const ksVector4f * plane = &parms->planes[view][i];
+			const float distance = plane->x * x + plane->y * y + plane->z * z + plane->w;
+			minDistance = ( i == 0 || distance < minDistance ) ? distance : minDistance;
+		}
+		maxDistance = ( view == 0 || minDistance > maxDistance ) ? minDistance : maxDistance;
+	}
+	return ( maxDistance > -parms->grid.z );
+}
+
+// Culls the objects of the grid by writing the instance counts of the indirect draw commands with a compute program.
+// The model matrices must have been calculated for the current frame.
+static void ksPerfScene_CullObjects( ksGpuCommandBuffer * commandBuffer, ksPerfScene * scene, const ksViewState * viewState, const int eye )
+{
+	const ksPerfSceneMatrixJobs * jobs = &scene->matrixJobs;
+	const int objectCount = jobs->dimension * jobs->dimension * jobs->dimension;
+
+	ksPerfSceneCullParms * cullParms = NULL;
+	ksGpuBuffer * cullParmsBuffer = ksGpuCommandBuffer_MapBuffer( commandBuffer, &scene->cullParms, (void **)&cullParms );
+	for ( int view = 0; view < 2; view++ )
+	{
+		// A single eye is culled against the same frustum twice.
+		const int viewEye = ( eye == 2 ) ? view : eye;
+		ksPerfScene_GetCullPlanes( cullParms->planes[view], &viewState->projectionMatrix[viewEye], &viewState->viewMatrix[viewEye], &jobs->bigTransformMatrix );
+	}
+	cullParms->grid.x = PERF_OBJECT_SPACING;
+	cullParms->grid.y = ( jobs->dimension - 1.0f ) * 0.5f;
+	cullParms->grid.z = PERF_OBJECT_RADIUS;
+	cullParms->grid.w = 0.0f;
+	cullParms->counts.x = jobs->dimension;
+	cullParms->counts.y = 0;
+	cullParms->counts.z = 0;
+	cullParms->counts.w = 0;
+	ksGpuCommandBuffer_UnmapBuffer( commandBuffer, &scene->cullParms, cullParmsBuffer, KS_GPU_BUFFER_UNMAP_TYPE_USE_ALLOCATED );
+
+	ksGpuBuffer * indirectBuffer = &scene->indirectBuffers[scene->settings.triangleLevel];
+
+	ksGpuCommandBuffer_ChangeBufferUsage( commandBuffer, indirectBuffer, KS_GPU_BUFFER_USAGE_STORAGE );
+
+	ksGpuComputeCommand command;
+	ksGpuComputeCommand_Init( &command );
+	ksGpuComputeCommand_SetPipeline( &command, &scene->cullPipeline );
+	ksGpuComputeCommand_SetParmBufferUniform( &command, COMPUTE_PROGRAM_UNIFORM_CULL_PARMS, cullParmsBuffer );
+	ksGpuComputeCommand_SetParmBufferStorage( &command, COMPUTE_PROGRAM_BUFFER_INDIRECT_COMMANDS, indirectBuffer );
+	ksGpuComputeCommand_SetDimensions( &command, ( objectCount + PERF_CULL_LOCAL_SIZE_X - 1 ) / PERF_CULL_LOCAL_SIZE_X, 1, 1 );
+
+	ksGpuCommandBuffer_SubmitComputeCommand( commandBuffer, &command );
+
+	ksGpuCommandBuffer_ChangeBufferUsage( commandBuffer, indirectBuffer, KS_GPU_BUFFER_USAGE_INDIRECT );
+}
+
 static void ksPerfScene_UpdateBuffers( ksGpuCommandBuffer * commandBuffer, ksPerfScene * scene, const ksViewState * viewState, const int eye )
 {
 	ksMatrix4x4f * sceneMatrices = NULL;
@@ -1710,56 +2972,90 @@ static void ksPerfScene_UpdateBuffers( ksGpuCommandBuffer * commandBuffer, ksPer
 	const int count = ( eye == 2 ) ? 2 : 1;
 	memcpy( sceneMatrices + 0 * count, &viewState->viewMatrix[eye], count * sizeof( ksMatrix4x4f ) );
 	memcpy( sceneMatrices + 1 * count, &viewState->projectionMatrix[eye], count * sizeof( ksMatrix4x4f ) );
-	ksGpuCommandBuffer_UnmapBuffer( commandBuffer, &scene->sceneMatrices, sceneMatricesBuffer, KS_GPU_BUFFER_UNMAP_TYPE_COPY_BACK );
+	// The mapped memory is bound directly, unless the commands recorded for one eye are also used for the other
+	// eye, in which case each eye copies its matrices back to the buffer that is bound by the recorded commands.
+	const ksGpuBufferUnmapType unmapType = scene->settings.useMultiView ? KS_GPU_BUFFER_UNMAP_TYPE_COPY_BACK : KS_GPU_BUFFER_UNMAP_TYPE_USE_ALLOCATED;
+	ksGpuCommandBuffer_UnmapBuffer( commandBuffer, &scene->sceneMatrices, sceneMatricesBuffer, unmapType );
+	scene->sceneMatricesBinding = ( unmapType == KS_GPU_BUFFER_UNMAP_TYPE_USE_ALLOCATED ) ? sceneMatricesBuffer : &scene->sceneMatrices;
+
+	// Write the model matrices straight into the instance buffer outside the render pass.
+	if ( scene->drawInstanced && ( scene->settings.useInstancing || scene->settings.useIndirect ) )
+	{
+		ksGpuGeometry * geometry = &scene->geometry[scene->settings.triangleLevel];
+		ksDefaultVertexAttributeArrays attribs;
+		ksGpuBuffer * instanceBuffer = ksGpuCommandBuffer_MapInstanceAttributes( commandBuffer, geometry, &attribs.base );
+		ksPerfScene_CalculateModelMatrices( scene, attribs.transform );
+		ksGpuCommandBuffer_UnmapInstanceAttributes( commandBuffer, geometry, instanceBuffer, KS_GPU_BUFFER_UNMAP_TYPE_COPY_BACK );
+	}
+	else
+	{
+		ksPerfScene_CalculateModelMatrices( scene, scene->modelMatrix );
+	}
+
+	if ( scene->drawIndirect && scene->settings.useIndirect )
+	{
+		ksPerfScene_CullObjects( commandBuffer, scene, viewState, eye );
+	}
 }
 
-static void ksPerfScene_Render( ksGpuCommandBuffer * commandBuffer, ksPerfScene * scene, const ksViewState * viewState )
+// Renders part 'part' of 'partCount' equally sized parts of the grid.
+static void ksPerfScene_RenderPart( ksGpuCommandBuffer * commandBuffer, const ksPerfScene * scene, const ksViewState * viewState, const int part, const int partCount )
 {
 	UNUSED_PARM( viewState );
+	assert( part >= 0 && part < partCount );
 
 	const int dimension = 2 * ( 1 << scene->settings.drawCallLevel );
-	const float cubeOffset = ( dimension - 1.0f ) * 0.5f;
-	const float cubeScale = 2.0f;
+	const int objectCount = dimension * dimension * dimension;
 
-	ksMatrix4x4f bigRotationMatrix;
-	ksMatrix4x4f_CreateRotation( &bigRotationMatrix, scene->bigRotationX, scene->bigRotationY, 0.0f );
+	if ( scene->drawInstanced && ( scene->settings.useInstancing || scene->settings.useIndirect ) )
+	{
+		// All objects are drawn with a single instanced or indirect draw call using the model matrices written by ksPerfScene_UpdateBuffers.
+		if ( part != 0 )
+		{
+			return;
+		}
 
-	ksMatrix4x4f bigTranslationMatrix;
-	ksMatrix4x4f_CreateTranslation( &bigTranslationMatrix, 0.0f, 0.0f, - 2.5f * dimension );
+		ksGpuGraphicsCommand command;
+		ksGpuGraphicsCommand_Init( &command );
+		ksGpuGraphicsCommand_SetPipeline( &command, &scene->instancedPipelines[scene->settings.triangleLevel][scene->settings.fragmentLevel] );
+		ksGpuGraphicsCommand_SetParmBufferUniform( &command, PROGRAM_UNIFORM_SCENE_MATRICES, scene->sceneMatricesBinding );
+		ksGpuGraphicsCommand_SetParmTextureSampled( &command, PROGRAM_TEXTURE_0, ( scene->settings.fragmentLevel >= 1 ) ? &scene->diffuseTexture : NULL );
+		ksGpuGraphicsCommand_SetParmTextureSampled( &command, PROGRAM_TEXTURE_1, ( scene->settings.fragmentLevel >= 1 ) ? &scene->specularTexture : NULL );
+		ksGpuGraphicsCommand_SetParmTextureSampled( &command, PROGRAM_TEXTURE_2, ( scene->settings.fragmentLevel >= 1 ) ? &scene->normalTexture : NULL );
+		if ( scene->settings.useIndirect && scene->drawIndirect )
+		{
+			ksGpuGraphicsCommand_SetIndirectBuffer( &command, &scene->indirectBuffers[scene->settings.triangleLevel], 0, objectCount );
+		}
+		else
+		{
+			ksGpuGraphicsCommand_SetNumInstances( &command, objectCount );
+		}
 
-	ksMatrix4x4f bigTransformMatrix;
-	ksMatrix4x4f_Multiply( &bigTransformMatrix, &bigTranslationMatrix, &bigRotationMatrix );
+		ksGpuCommandBuffer_SubmitGraphicsCommand( commandBuffer, &command );
+		return;
+	}
 
-	ksMatrix4x4f smallRotationMatrix;
-	ksMatrix4x4f_CreateRotation( &smallRotationMatrix, scene->smallRotationX, scene->smallRotationY, 0.0f );
+	// The model matrices were calculated by ksPerfScene_UpdateBuffers.
+	const int firstObject = (int)( (long long)objectCount * part / partCount );
+	const int endObject = (int)( (long long)objectCount * ( part + 1 ) / partCount );
 
 	ksGpuGraphicsCommand command;
 	ksGpuGraphicsCommand_Init( &command );
 	ksGpuGraphicsCommand_SetPipeline( &command, &scene->pipelines[scene->settings.triangleLevel][scene->settings.fragmentLevel] );
-	ksGpuGraphicsCommand_SetParmBufferUniform( &command, PROGRAM_UNIFORM_SCENE_MATRICES, &scene->sceneMatrices );
+	ksGpuGraphicsCommand_SetParmBufferUniform( &command, PROGRAM_UNIFORM_SCENE_MATRICES, scene->sceneMatricesBinding );
 	ksGpuGraphicsCommand_SetParmTextureSampled( &command, PROGRAM_TEXTURE_0, ( scene->settings.fragmentLevel >= 1 ) ? &scene->diffuseTexture : NULL );
 	ksGpuGraphicsCommand_SetParmTextureSampled( &command, PROGRAM_TEXTURE_1, ( scene->settings.fragmentLevel >= 1 ) ? &scene->specularTexture : NULL );
 	ksGpuGraphicsCommand_SetParmTextureSampled( &command, PROGRAM_TEXTURE_2, ( scene->settings.fragmentLevel >= 1 ) ? &scene->normalTexture : NULL );
 
-	for ( int x = 0; x < dimension; x++ )
+	for ( int objectIndex = firstObject; objectIndex < endObject; objectIndex++ )
 	{
-		for ( int y = 0; y < dimension; y++ )
-		{
-			for ( int z = 0; z < dimension; z++ )
-			{
-				ksMatrix4x4f smallTranslationMatrix;
-				ksMatrix4x4f_CreateTranslation( &smallTranslationMatrix, cubeScale * ( x - cubeOffset ), cubeScale * ( y - cubeOffset ), cubeScale * ( z - cubeOffset ) );
-
-				ksMatrix4x4f smallTransformMatrix;
-				ksMatrix4x4f_Multiply( &smallTransformMatrix, &smallTranslationMatrix, &smallRotationMatrix );
+		ksGpuGraphicsCommand_SetParmFloatMatrix4x4( &command, PROGRAM_UNIFORM_MODEL_MATRIX, &scene->modelMatrix[objectIndex] );
 
-				ksMatrix4x4f * modelMatrix = &scene->modelMatrix[( x * dimension + y ) * dimension + z];
-				ksMatrix4x4f_Multiply( modelMatrix, &bigTransformMatrix, &smallTransformMatrix );
-
-				ksGpuGraphicsCommand_SetParmFloatMatrix4x4( &command, PROGRAM_UNIFORM_MODEL_MATRIX, modelMatrix );
-
-				ksGpuCommandBuffer_SubmitGraphicsCommand( commandBuffer, &command );
-			}
-		}
+		ksGpuCommandBuffer_SubmitGraphicsCommand( commandBuffer, &command );
 	}
 }
+
+static void ksPerfScene_Render( ksGpuCommandBuffer * commandBuffer, ksPerfScene * scene, const ksViewState * viewState )
+{
+	ksPerfScene_RenderPart( commandBuffer, scene, viewState, 0, 1 );
+}
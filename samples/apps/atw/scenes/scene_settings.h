@@ -38,10 +38,16 @@ static void ksSceneSettings_Init( ksGpuContext * context, ksSceneSettings * sett
 static void ksSceneSettings_SetGltf( ksSceneSettings * settings, const char * fileName );
 static void ksSceneSettings_ToggleSimulationPaused( ksSceneSettings * settings );
 static void ksSceneSettings_ToggleMultiView( ksSceneSettings * settings );
+static void ksSceneSettings_ToggleInstancing( ksSceneSettings * settings );
+static void ksSceneSettings_ToggleIndirect( ksSceneSettings * settings );
 static void ksSceneSettings_SetSimulationPaused( ksSceneSettings * settings, const bool set );
 static void ksSceneSettings_SetMultiView( ksSceneSettings * settings, const bool set );
+static void ksSceneSettings_SetInstancing( ksSceneSettings * settings, const bool set );
+static void ksSceneSettings_SetIndirect( ksSceneSettings * settings, const bool set );
 static bool ksSceneSettings_GetSimulationPaused( ksSceneSettings * settings );
 static bool ksSceneSettings_GetMultiView( ksSceneSettings * settings );
+static bool ksSceneSettings_GetInstancing( ksSceneSettings * settings );
+static bool ksSceneSettings_GetIndirect( ksSceneSettings * settings );
 
 static void ksSceneSettings_CycleDisplayResolutionLevel( ksSceneSettings * settings );
 static void ksSceneSettings_CycleEyeImageResolutionLevel( ksSceneSettings * settings );
@@ -107,6 +113,8 @@ typedef struct
 	const char *	glTF;
 	bool			simulationPaused;
 	bool			useMultiView;
+	bool			useInstancing;
+	bool			useIndirect;
 	int				displayResolutionLevel;
 	int				eyeImageResolutionLevel;
 	int				eyeImageSamplesLevel;
@@ -123,6 +131,8 @@ static void ksSceneSettings_Init( ksGpuContext * context, ksSceneSettings * sett
 	settings->glTF = NULL;
 	settings->simulationPaused = false;
 	settings->useMultiView = false;
+	settings->useInstancing = false;
+	settings->useIndirect = false;
 	settings->displayResolutionLevel = 0;
 	settings->eyeImageResolutionLevel = 0;
 	settings->eyeImageSamplesLevel = 0;
@@ -147,12 +157,18 @@ static void ksSceneSettings_SetGltf( ksSceneSettings * settings, const char * fi
 
 static void ksSceneSettings_ToggleSimulationPaused( ksSceneSettings * settings ) { settings->simulationPaused = !settings->simulationPaused; }
 static void ksSceneSettings_ToggleMultiView( ksSceneSettings * settings ) { settings->useMultiView = !settings->useMultiView; }
+static void ksSceneSettings_ToggleInstancing( ksSceneSettings * settings ) { settings->useInstancing = !settings->useInstancing; }
+static void ksSceneSettings_ToggleIndirect( ksSceneSettings * settings ) { settings->useIndirect = !settings->useIndirect; }
 
 static void ksSceneSettings_SetSimulationPaused( ksSceneSettings * settings, const bool set ) { settings->simulationPaused = set; }
 static void ksSceneSettings_SetMultiView( ksSceneSettings * settings, const bool set ) { settings->useMultiView = set; }
+static void ksSceneSettings_SetInstancing( ksSceneSettings * settings, const bool set ) { settings->useInstancing = set; }
+static void ksSceneSettings_SetIndirect( ksSceneSettings * settings, const bool set ) { settings->useIndirect = set; }
 
 static bool ksSceneSettings_GetSimulationPaused( ksSceneSettings * settings ) { return settings->simulationPaused; }
 static bool ksSceneSettings_GetMultiView( ksSceneSettings * settings ) { return settings->useMultiView; }
+static bool ksSceneSettings_GetInstancing( ksSceneSettings * settings ) { return settings->useInstancing; }
+static bool ksSceneSettings_GetIndirect( ksSceneSettings * settings ) { return settings->useIndirect; }
 
 static void ksSceneSettings_CycleDisplayResolutionLevel( ksSceneSettings * settings ) { CycleLevel( &settings->displayResolutionLevel, settings->maxDisplayResolutionLevels ); }
 static void ksSceneSettings_CycleEyeImageResolutionLevel( ksSceneSettings * settings ) { CycleLevel( &settings->eyeImageResolutionLevel, settings->maxEyeImageResolutionLevels ); }
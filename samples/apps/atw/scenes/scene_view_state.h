@@ -37,6 +37,8 @@ ksViewState
 static void ksViewState_Init( ksViewState * viewState, const float interpupillaryDistance );
 static void ksViewState_HandleInput( ksViewState * viewState, ksGpuWindowInput * input, const ksNanoseconds time );
 static void ksViewState_HandleHmd( ksViewState * viewState, const ksNanoseconds time );
+static void ksViewState_CullBounds( const ksViewState * viewState, const ksVector3f * mins, const ksVector3f * maxs,
+									const int count, unsigned char * visibleEyes );
 
 ================================================================================================
 */
@@ -54,8 +56,21 @@ typedef struct ksViewState
 	ksMatrix4x4f				viewInverseMatrix[NUM_EYES];			// Per eye inverse view matrix.
 	ksMatrix4x4f				projectionInverseMatrix[NUM_EYES];		// Per eye inverse projection matrix.
 	ksMatrix4x4f				combinedViewProjectionMatrix;			// Combined matrix containing all views for culling.
+	ksVector4f					combinedCullPlanes[6];					// World space planes of the combined view-projection.
+	ksVector4f					eyeCullPlanes[NUM_EYES][2];				// World space left and right planes per eye.
 } ksViewState;
 
+#define VIEW_STATE_CULL_LANES		4
+
+// Calculates the world space plane of the clip space half-space 'sign' * clip[row] < clip.w.
+static void ksViewState_GetCullPlane( ksVector4f * plane, const ksMatrix4x4f * viewProjection, const int row, const float sign )
+{
+	plane->x = viewProjection->m[0][3] + sign * viewProjection->m[0][row];
+	plane->y = viewProjection->m[1][3] + sign * viewProjection->m[1][row];
+	plane->z = viewProjection->m[2][3] + sign * viewProjection->m[2][row];
+	plane->w = viewProjection->m[3][3] + sign * viewProjection->m[3][row];
+}
+
 static void ksViewState_DerivedData( ksViewState * viewState, const ksMatrix4x4f * centerViewMatrix )
 {
 	for ( int eye = 0; eye < NUM_EYES; eye++ )
@@ -77,6 +92,24 @@ static void ksViewState_DerivedData( ksViewState * viewState, const ksMatrix4x4f
 	ksMatrix4x4f_Multiply( &combinedViewMatrix, &moveBackMatrix, centerViewMatrix );
 
 	ksMatrix4x4f_Multiply( &viewState->combinedViewProjectionMatrix, &combinedProjectionMatrix, &combinedViewMatrix );
+
+	for ( int plane = 0; plane < 6; plane++ )
+	{
+		ksViewState_GetCullPlane( &viewState->combinedCullPlanes[plane], &viewState->combinedViewProjectionMatrix, plane >> 1, ( plane & 1 ) ? -1.0f : 1.0f );
+	}
+
+	// The combined frustum encloses both eye frusta. Because it is moved back, not only its left and right planes
+	// but also its top, bottom and near planes are looser than those of each eye. The eyes are only offset along
+	// the view X axis, so the left and right planes are the ones that separate the eyes, and only those are derived
+	// per eye. Bounds that pass the combined planes and the left and right planes of an eye may still be outside the
+	// top, bottom or near plane of that eye, which only makes the culling conservative.
+	for ( int eye = 0; eye < NUM_EYES; eye++ )
+	{
+		ksMatrix4x4f eyeViewProjectionMatrix;
+		ksMatrix4x4f_Multiply( &eyeViewProjectionMatrix, &viewState->projectionMatrix[eye], &viewState->viewMatrix[eye] );
+		ksViewState_GetCullPlane( &viewState->eyeCullPlanes[eye][0], &eyeViewProjectionMatrix, 0, 1.0f );
+		ksViewState_GetCullPlane( &viewState->eyeCullPlanes[eye][1], &eyeViewProjectionMatrix, 0, -1.0f );
+	}
 }
 
 static void ksViewState_Init( ksViewState * viewState, const float interpupillaryDistance )
@@ -215,3 +248,101 @@ static void ksViewState_HandleHmd( ksViewState * viewState, const ksNanoseconds
 
 	ksViewState_DerivedData( viewState, &viewState->displayViewMatrix );
 }
+
+/*
+	Culls an array of world space bounds for all eyes at once.
+
+	Each bounds is first tested against the planes of the combined frustum that encloses both eyes.
+	Only when at least one bounds survives, the left and right planes of each eye are tested to
+	resolve which eyes can see the bounds. The bounds are processed in groups of lanes that are
+	laid out as structure-of-arrays, such that the compiler can vectorize across the bounds.
+	The per-eye planes are tested for all lanes of a group, also for the lanes that are already
+	outside the combined frustum, which keeps the loops branch free.
+
+	On return visibleEyes[i] holds a bit per eye that is set if bounds 'i' is visible in that eye.
+	Like ksMatrix4x4f_CullBounds degenerate bounds are never culled.
+*/
+static void ksViewState_CullBounds( const ksViewState * viewState, const ksVector3f * mins, const ksVector3f * maxs,
+									const int count, unsigned char * visibleEyes )
+{
+	const int allEyes = ( 1 << NUM_EYES ) - 1;
+
+	for ( int first = 0; first < count; first += VIEW_STATE_CULL_LANES )
+	{
+		const int laneCount = ( count - first < VIEW_STATE_CULL_LANES ) ? count - first : VIEW_STATE_CULL_LANES;
+
+		// Gather the centers and extents, replicating the first bounds into unused lanes.
+		float centerX[VIEW_STATE_CULL_LANES];
+		float centerY[VIEW_STATE_CULL_LANES];
+		float centerZ[VIEW_STATE_CULL_LANES];
+		float extentX[VIEW_STATE_CULL_LANES];
+		float extentY[VIEW_STATE_CULL_LANES];
+		float extentZ[VIEW_STATE_CULL_LANES];
+		int degenerate[VIEW_STATE_CULL_LANES];
+		for ( int lane = 0; lane < VIEW_STATE_CULL_LANES; lane++ )
+		{
+			const int index = first + ( ( lane < laneCount ) ? lane : 0 );
+			centerX[lane] = 0.5f * ( maxs[index].x + mins[index].x );
+			centerY[lane] = 0.5f * ( maxs[index].y + mins[index].y );
+			centerZ[lane] = 0.5f * ( maxs[index].z + mins[index].z );
+			extentX[lane] = 0.5f * ( maxs[index].x - mins[index].x );
+			extentY[lane] = 0.5f * ( maxs[index].y - mins[index].y );
+			extentZ[lane] = 0.5f * ( maxs[index].z - mins[index].z );
+			degenerate[lane] = ( maxs[index].x <= mins[index].x && maxs[index].y <= mins[index].y && maxs[index].z <= mins[index].z );
+		}
+
+		// The bounds are outside a plane if the corner furthest along the plane normal is not in front of the plane.
+		int outside[VIEW_STATE_CULL_LANES] = { 0 };
+		for ( int planeIndex = 0; planeIndex < 6; planeIndex++ )
+		{
+			const ksVector4f * plane = &viewState->combinedCullPlanes[planeIndex];
+			const float absX = fabsf( plane->x );
+			const float absY = fabsf( plane->y );
+			const float absZ = fabsf( plane->z );
+			for ( int lane = 0; lane < VIEW_STATE_CULL_LANES; lane++ )
+			{
+				const float distance =	plane->x * centerX[lane] + plane->y * centerY[lane] + plane->z * centerZ[lane] + plane->w +
+										absX * extentX[lane] + absY * extentY[lane] + absZ * extentZ[lane];
+				outside[lane] |= ( distance <= 0.0f );
+			}
+		}
+
+		int anyInside = 0;
+		for ( int lane = 0; lane < VIEW_STATE_CULL_LANES; lane++ )
+		{
+			outside[lane] &= !degenerate[lane];
+			anyInside |= !outside[lane];
+		}
+
+		int eyes[VIEW_STATE_CULL_LANES] = { 0 };
+		if ( anyInside )
+		{
+			for ( int eye = 0; eye < NUM_EYES; eye++ )
+			{
+				int eyeOutside[VIEW_STATE_CULL_LANES] = { 0 };
+				for ( int planeIndex = 0; planeIndex < 2; planeIndex++ )
+				{
+					const ksVector4f * plane = &viewState->eyeCullPlanes[eye][planeIndex];
+					const float absX = fabsf( plane->x );
+					const float absY = fabsf( plane->y );
+					const float absZ = fabsf( plane->z );
+					for ( int lane = 0; lane < VIEW_STATE_CULL_LANES; lane++ )
+					{
+						const float distance =	plane->x * centerX[lane] + plane->y * centerY[lane] + plane->z * centerZ[lane] + plane->w +
+												absX * extentX[lane] + absY * extentY[lane] + absZ * extentZ[lane];
+						eyeOutside[lane] |= ( distance <= 0.0f );
+					}
+				}
+				for ( int lane = 0; lane < VIEW_STATE_CULL_LANES; lane++ )
+				{
+					eyes[lane] |= ( !outside[lane] && ( !eyeOutside[lane] || degenerate[lane] ) ) << eye;
+				}
+			}
+		}
+
+		for ( int lane = 0; lane < laneCount; lane++ )
+		{
+			visibleEyes[first + lane] = (unsigned char)( degenerate[lane] ? allEyes : eyes[lane] );
+		}
+	}
+}
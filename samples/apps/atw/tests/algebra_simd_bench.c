@@ -0,0 +1,161 @@
+/*
+================================================================================================
+
+Description	:	Test and benchmark of the SIMD matrix multiply.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Compares ksMatrix4x4f_Multiply, compiled with KSALGEBRA_SIMD enabled, bit for bit with
+the scalar code on random matrices, and measures the number of matrix multiplies per
+millisecond of both. This test must be compiled with -ffp-contract=off because the results
+are only bit-identical when the scalar code is not contracted into fused multiply-adds.
+
+================================================================================================
+*/
+
+#define KSALGEBRA_SIMD			1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <utils/nanoseconds.h>
+#include <utils/algebra.h>
+
+#define MATRIX_COUNT			1024
+
+// Same as the scalar path of ksMatrix4x4f_Multiply.
+static void ScalarMatrix4x4f_Multiply( ksMatrix4x4f * result, const ksMatrix4x4f * a, const ksMatrix4x4f * b )
+{
+	for ( int i = 0; i < 4; i++ )
+	{
+		for ( int j = 0; j < 4; j++ )
+		{
+			result->m[i][j] = a->m[0][j] * b->m[i][0] + a->m[1][j] * b->m[i][1] + a->m[2][j] * b->m[i][2] + a->m[3][j] * b->m[i][3];
+		}
+	}
+}
+
+static float RandomFloat( unsigned int * seed )
+{
+	*seed = *seed * 1664525 + 1013904223;
+	return (float)( *seed >> 8 ) * ( 2.0f / (float)( 1 << 24 ) ) - 1.0f;
+}
+
+static void RandomMatrix( ksMatrix4x4f * matrix, unsigned int * seed )
+{
+	for ( int i = 0; i < 4; i++ )
+	{
+		for ( int j = 0; j < 4; j++ )
+		{
+			matrix->m[i][j] = RandomFloat( seed ) * 100.0f;
+		}
+	}
+}
+
+// Multiplies consecutive pairs of matrices and returns the time it took in nanoseconds.
+static ksNanoseconds TimeMultiply( void (*multiply)( ksMatrix4x4f *, const ksMatrix4x4f *, const ksMatrix4x4f * ),
+									ksMatrix4x4f * results, const ksMatrix4x4f * matrices, const int iterations )
+{
+	const ksNanoseconds startTime = GetTimeNanoseconds();
+	for ( int iteration = 0; iteration < iterations; iteration++ )
+	{
+		for ( int i = 0; i < MATRIX_COUNT; i++ )
+		{
+			multiply( &results[i], &matrices[i], &matrices[( i + iteration + 1 ) % MATRIX_COUNT] );
+		}
+	}
+	return GetTimeNanoseconds() - startTime;
+}
+
+int main( int argc, char * argv[] )
+{
+	int pairCount = 100000;
+	int iterations = 1000;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char * arg = argv[i];
+		if ( arg[0] == '-' ) { arg++; }
+
+		if ( strcmp( arg, "p" ) == 0 && i + 1 < argc )		{ pairCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "i" ) == 0 && i + 1 < argc )	{ iterations = atoi( argv[++i] ); }
+		else
+		{
+			printf( "Unknown option: %s\n"
+					"atw_algebra_simd_bench [options]\n"
+					"options:\n"
+					"   -p <n>      number of random matrix pairs to compare\n"
+					"   -i <n>      number of timed iterations over %d matrices\n",
+					arg, MATRIX_COUNT );
+			return 1;
+		}
+	}
+
+#if defined( KSALGEBRA_USE_SSE )
+	const char * path = "SSE";
+#elif defined( KSALGEBRA_USE_NEON )
+	const char * path = "NEON";
+#else
+	const char * path = "scalar";
+#endif
+
+	unsigned int seed = 12345;
+	int mismatches = 0;
+	for ( int pair = 0; pair < pairCount; pair++ )
+	{
+		ksMatrix4x4f a;
+		ksMatrix4x4f b;
+		RandomMatrix( &a, &seed );
+		RandomMatrix( &b, &seed );
+
+		ksMatrix4x4f simdResult;
+		ksMatrix4x4f scalarResult;
+		ksMatrix4x4f_Multiply( &simdResult, &a, &b );
+		ScalarMatrix4x4f_Multiply( &scalarResult, &a, &b );
+		mismatches += ( memcmp( &simdResult, &scalarResult, sizeof( ksMatrix4x4f ) ) != 0 );
+	}
+	printf( "%s: %d of %d matrix products differ from the scalar code\n", path, mismatches, pairCount );
+
+	ksMatrix4x4f * matrices = (ksMatrix4x4f *) malloc( MATRIX_COUNT * sizeof( ksMatrix4x4f ) );
+	ksMatrix4x4f * results = (ksMatrix4x4f *) malloc( MATRIX_COUNT * sizeof( ksMatrix4x4f ) );
+	for ( int i = 0; i < MATRIX_COUNT; i++ )
+	{
+		RandomMatrix( &matrices[i], &seed );
+	}
+
+	const ksNanoseconds scalarTime = TimeMultiply( ScalarMatrix4x4f_Multiply, results, matrices, iterations );
+	const ksNanoseconds simdTime = TimeMultiply( ksMatrix4x4f_Multiply, results, matrices, iterations );
+	const double multiplies = (double)MATRIX_COUNT * iterations;
+	printf( "scalar: %1.0f multiplies/ms\n", multiplies / ( scalarTime * 1e-6 ) );
+	printf( "%s: %1.0f multiplies/ms\n", path, multiplies / ( simdTime * 1e-6 ) );
+
+	free( results );
+	free( matrices );
+
+	return ( mismatches == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,216 @@
+/*
+================================================================================================
+
+Description	:	Headless comparison of the recorded commands per draw path.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Records a frame of the perf scene and of a synthetic glTF scene on top of the headless GPU
+layer with each of the available draw paths, and prints the number of recorded commands
+per frame side by side.
+
+The perf scene is recorded with a draw call per object, with a single instanced draw call
+and with a single indirect draw call of which the instance counts are written by a compute
+dispatch. The glTF scene is recorded with a draw call per batch and with an indirect draw
+call per batch.
+
+The test fails when a draw path does not record the expected number of commands, or when
+the indirect glTF draw calls do not draw the same instances as the direct draw calls.
+
+================================================================================================
+*/
+
+#include "gpu_mock.h"
+#include "../scenes/scene_settings.h"
+#include "../scenes/scene_view_state.h"
+#include "../scenes/scene_perf.h"
+#include "../scenes/scene_gltf.h"
+#include "gltf_scene_gen.h"
+
+typedef enum
+{
+	DRAW_PATH_DIRECT,
+	DRAW_PATH_INSTANCED,
+	DRAW_PATH_INDIRECT,
+	DRAW_PATH_MAX
+} ksDrawPath;
+
+static const char * drawPathNames[DRAW_PATH_MAX] = { "direct", "instanced", "indirect" };
+
+static void PrintCounters( const char * scene, const char * path, const ksGpuMockCounters * counters )
+{
+	Print( "%-24s %-10s %6u %8u %9u %10u %8u %8u %8u\n", scene, path,
+			counters->drawCalls, counters->indirectDraws, counters->instances,
+			counters->computeDispatches, counters->bufferBarriers,
+			counters->pipelineChanges, counters->bufferMaps );
+}
+
+static void SetDrawPath( ksSceneSettings * settings, const ksDrawPath path )
+{
+	ksSceneSettings_SetInstancing( settings, path == DRAW_PATH_INSTANCED );
+	ksSceneSettings_SetIndirect( settings, path == DRAW_PATH_INDIRECT );
+}
+
+int main( int argc, char * argv[] )
+{
+	UNUSED_PARM( argc );
+	UNUSED_PARM( argv );
+
+	ksGpuContext context;
+	ksGpuMock_CreateContext( &context );
+
+	ksGpuRenderPass renderPass;
+	renderPass.sampleCount = KS_GPU_SAMPLE_COUNT_1;
+
+	ksGpuCommandBuffer commandBuffer;
+	memset( &commandBuffer, 0, sizeof( commandBuffer ) );
+	commandBuffer.context = &context;
+
+	ksGpuWindowInput input;
+	memset( &input, 0, sizeof( input ) );
+
+	Print( "%-24s %-10s %6s %8s %9s %10s %8s %8s %8s\n", "scene", "path",
+			"draws", "indirect", "instances", "dispatches", "barriers", "pipeline", "maps" );
+
+	int failures = 0;
+
+	// Perf scene.
+	{
+		ksSceneSettings settings;
+		ksSceneSettings_Init( &context, &settings );
+
+		ksViewState viewState;
+		ksViewState_Init( &viewState, 0.0640f );
+
+		ksPerfScene scene;
+		ksPerfScene_Create( &context, &scene, &settings, &renderPass );
+
+		for ( int level = 0; level < MAX_SCENE_DRAWCALL_LEVELS; level++ )
+		{
+			ksSceneSettings_SetDrawCallLevel( &settings, level );
+
+			const int dimension = 2 * ( 1 << level );
+			const uint32_t objectCount = dimension * dimension * dimension;
+
+			char sceneName[32];
+			snprintf( sceneName, sizeof( sceneName ), "perf %u objects", objectCount );
+
+			for ( int path = 0; path < DRAW_PATH_MAX; path++ )
+			{
+				SetDrawPath( &settings, (ksDrawPath)path );
+				ksPerfScene_Simulate( &scene, &viewState, 0 );
+
+				ksGpuMock_ResetCounters();
+
+				ksPerfScene_UpdateBuffers( &commandBuffer, &scene, &viewState, 0 );
+				ksGpuMock_BeginRenderPass( &commandBuffer );
+				ksPerfScene_Render( &commandBuffer, &scene, &viewState );
+				ksGpuMock_EndRenderPass( &commandBuffer );
+
+				const ksGpuMockCounters counters = ksGpuMock_GetCounters();
+				PrintCounters( sceneName, drawPathNames[path], &counters );
+
+				const uint32_t expectedDrawCalls = ( path == DRAW_PATH_DIRECT ) ? objectCount : 1;
+				const uint32_t expectedDispatches = ( path == DRAW_PATH_INDIRECT ) ? 1 : 0;
+				if ( counters.drawCalls != expectedDrawCalls || counters.computeDispatches != expectedDispatches )
+				{
+					Error( "%s %s recorded %u draw calls and %u dispatches instead of %u and %u", sceneName, drawPathNames[path],
+							counters.drawCalls, counters.computeDispatches, expectedDrawCalls, expectedDispatches );
+					failures++;
+				}
+			}
+		}
+
+		ksPerfScene_Destroy( &context, &scene );
+	}
+
+	// glTF scene.
+	{
+		ksGltfSceneGenParms genParms;
+		ksGltfSceneGen_InitParms( &genParms );
+
+		const char * fileName = OUTPUT_PATH "draw_command_count_test.gltf";
+		if ( !ksGltfSceneGen_WriteFile( fileName, &genParms ) )
+		{
+			return 1;
+		}
+
+		ksSceneSettings settings;
+		ksSceneSettings_Init( &context, &settings );
+		ksSceneSettings_SetGltf( &settings, fileName );
+
+		ksViewState viewState;
+		ksViewState_Init( &viewState, 0.0640f );
+
+		ksGltfScene scene;
+		ksGltfScene_CreateFromFile( &context, &scene, &settings, &renderPass );
+
+		// The glTF scene always instances repeated surfaces, so there is no separate instanced path.
+		ksGpuMockCounters directCounters;
+		memset( &directCounters, 0, sizeof( directCounters ) );
+		for ( int path = DRAW_PATH_DIRECT; path < DRAW_PATH_MAX; path += DRAW_PATH_INDIRECT - DRAW_PATH_DIRECT )
+		{
+			SetDrawPath( &settings, (ksDrawPath)path );
+			ksGltfScene_Simulate( &scene, &viewState, &input, 0 );
+
+			ksGpuMock_ResetCounters();
+
+			ksGltfScene_UpdateBuffers( &commandBuffer, &scene, &viewState, 0 );
+			ksGpuMock_BeginRenderPass( &commandBuffer );
+			ksGltfScene_Render( &commandBuffer, &scene, &viewState );
+			ksGpuMock_EndRenderPass( &commandBuffer );
+
+			const ksGpuMockCounters counters = ksGpuMock_GetCounters();
+			PrintCounters( "glTF", drawPathNames[path], &counters );
+
+			if ( path == DRAW_PATH_DIRECT )
+			{
+				directCounters = counters;
+				continue;
+			}
+
+			// An indirect draw call per batch that reads a single command.
+			if ( counters.drawCalls != directCounters.drawCalls ||
+				counters.indirectDraws != directCounters.drawCalls ||
+				counters.instances != directCounters.instances ||
+				counters.bufferMaps != directCounters.bufferMaps + 1 )
+			{
+				Error( "glTF indirect recorded %u draw calls, %u indirect draws, %u instances and %u maps",
+						counters.drawCalls, counters.indirectDraws, counters.instances, counters.bufferMaps );
+				failures++;
+			}
+		}
+
+		ksGltfScene_Destroy( &context, &scene );
+
+		remove( fileName );
+	}
+
+	Print( "%d draw paths recorded an unexpected number of commands\n", failures );
+
+	return ( failures == 0 ) ? 0 : 1;
+}
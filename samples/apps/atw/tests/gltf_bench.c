@@ -0,0 +1,262 @@
+/*
+================================================================================================
+
+Description	:	Headless glTF scene benchmark.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Generates a synthetic glTF scene, loads it on top of the headless GPU layer and runs a
+number of frames of simulation, buffer updates and command recording the same way the
+scene thread of atw_opengl does. The CPU time of each part of the frame is reported as
+percentiles together with the number of draw calls, state changes and memory allocations
+per frame. The per phase percentiles of the scene itself are printed as well because this
+benchmark is compiled with GLTF_PROFILE_CPU enabled.
+
+The benchmark fails when a frame after the warm-up frames allocates memory.
+
+================================================================================================
+*/
+
+#define GLTF_PROFILE_CPU		1
+
+#include "gpu_mock.h"
+#include "../scenes/scene_settings.h"
+#include "../scenes/scene_view_state.h"
+#include "../scenes/scene_gltf.h"
+#include "gltf_scene_gen.h"
+
+#define WARMUP_FRAMES			8
+
+typedef enum
+{
+	BENCH_PHASE_SIMULATE,		// ksGltfScene_Simulate
+	BENCH_PHASE_UPDATE,			// ksGltfScene_UpdateBuffers for all passes
+	BENCH_PHASE_RENDER,			// ksGltfScene_Render for all passes
+	BENCH_PHASE_FRAME,			// all of the above
+	BENCH_PHASE_MAX
+} ksBenchPhase;
+
+static const char * benchPhaseNames[BENCH_PHASE_MAX] = { "simulate", "update", "render", "frame" };
+
+static int CompareNanoseconds( const void * a, const void * b )
+{
+	const ksNanoseconds sampleA = *(const ksNanoseconds *)a;
+	const ksNanoseconds sampleB = *(const ksNanoseconds *)b;
+	return ( sampleA < sampleB ) ? -1 : ( ( sampleA > sampleB ) ? 1 : 0 );
+}
+
+static void PrintPercentiles( const char * name, ksNanoseconds * samples, const int sampleCount )
+{
+	qsort( samples, sampleCount, sizeof( samples[0] ), CompareNanoseconds );
+	Print( "%-10s p50 = %7.3f ms, p90 = %7.3f ms, p99 = %7.3f ms, max = %7.3f ms\n", name,
+			samples[sampleCount * 50 / 100] * 1e-6f,
+			samples[sampleCount * 90 / 100] * 1e-6f,
+			samples[sampleCount * 99 / 100] * 1e-6f,
+			samples[sampleCount - 1] * 1e-6f );
+}
+
+int main( int argc, char * argv[] )
+{
+	ksGltfSceneGenParms genParms;
+	ksGltfSceneGen_InitParms( &genParms );
+
+	int frameCount = 256;
+	bool useMultiView = false;
+	const char * fileName = OUTPUT_PATH "gltf_bench_scene.gltf";
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char * arg = argv[i];
+		if ( arg[0] == '-' ) { arg++; }
+
+		if ( strcmp( arg, "f" ) == 0 && i + 1 < argc )		{ frameCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "t" ) == 0 && i + 1 < argc )	{ genParms.subTreeCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "n" ) == 0 && i + 1 < argc )	{ genParms.subTreeNodeCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "a" ) == 0 && i + 1 < argc )	{ genParms.animatedNodeCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "o" ) == 0 && i + 1 < argc )	{ genParms.modelCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "l" ) == 0 && i + 1 < argc )	{ genParms.materialCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "k" ) == 0 && i + 1 < argc )	{ genParms.techniqueCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "m" ) == 0 && i + 1 < argc )	{ useMultiView = ( atoi( argv[++i] ) != 0 ); }
+		else
+		{
+			Print( "Unknown option: %s\n"
+				   "atw_gltf_bench [options]\n"
+				   "options:\n"
+				   "   -f <n>      number of frames\n"
+				   "   -t <n>      number of sub-trees\n"
+				   "   -n <n>      number of nodes per sub-tree\n"
+				   "   -a <n>      number of animated nodes per sub-tree\n"
+				   "   -o <n>      number of meshes\n"
+				   "   -l <n>      number of materials\n"
+				   "   -k <n>      number of techniques\n"
+				   "   -m <0-1>    enable/disable multi-view\n",
+				   arg );
+			return 1;
+		}
+	}
+
+	if ( frameCount <= WARMUP_FRAMES )
+	{
+		frameCount = WARMUP_FRAMES + 1;
+	}
+
+	Print( "%d sub-trees x %d nodes, %d animated, %d meshes, %d materials, %d techniques, multi-view = %d\n",
+			genParms.subTreeCount, genParms.subTreeNodeCount, genParms.animatedNodeCount,
+			genParms.modelCount, genParms.materialCount, genParms.techniqueCount,
+			useMultiView );
+
+	if ( !ksGltfSceneGen_WriteFile( fileName, &genParms ) )
+	{
+		return 1;
+	}
+
+	ksGpuContext context;
+	ksGpuMock_CreateContext( &context );
+
+	ksGpuRenderPass renderPass;
+	renderPass.sampleCount = KS_GPU_SAMPLE_COUNT_1;
+
+	ksSceneSettings settings;
+	ksSceneSettings_Init( &context, &settings );
+	ksSceneSettings_SetGltf( &settings, fileName );
+	ksSceneSettings_SetMultiView( &settings, useMultiView );
+
+	ksViewState viewState;
+	ksViewState_Init( &viewState, 0.0640f );
+
+	ksGpuWindowInput input;
+	memset( &input, 0, sizeof( input ) );
+
+	ksGpuCommandBuffer commandBuffer;
+	memset( &commandBuffer, 0, sizeof( commandBuffer ) );
+	commandBuffer.context = &context;
+
+	ksGpuMock_ResetCounters();
+
+	const ksNanoseconds loadStartTime = GetTimeNanoseconds();
+
+	ksGltfScene scene;
+	ksGltfScene_CreateFromFile( &context, &scene, &settings, &renderPass );
+
+	const ksNanoseconds loadEndTime = GetTimeNanoseconds();
+	const ksGpuMockCounters loadCounters = ksGpuMock_GetCounters();
+
+	Print( "load       %1.3f ms, %u allocations, %u buffers, %u programs, %u pipelines\n",
+			( loadEndTime - loadStartTime ) * 1e-6f, loadCounters.allocations,
+			loadCounters.buffersCreated, loadCounters.programsCreated, loadCounters.pipelinesCreated );
+
+	const int numPasses = useMultiView ? 1 : NUM_EYES;
+	const int sampleCount = frameCount - WARMUP_FRAMES;
+	ksNanoseconds * samples[BENCH_PHASE_MAX];
+	for ( int phase = 0; phase < BENCH_PHASE_MAX; phase++ )
+	{
+		samples[phase] = (ksNanoseconds *) malloc( sampleCount * sizeof( ksNanoseconds ) );
+	}
+
+	ksGpuMockCounters frameCounters;
+	memset( &frameCounters, 0, sizeof( frameCounters ) );
+
+	for ( int frameIndex = 0; frameIndex < frameCount; frameIndex++ )
+	{
+		if ( frameIndex == WARMUP_FRAMES )
+		{
+			ksGpuMock_ResetCounters();
+		}
+
+		// Frames at 90 Hz.
+		const ksNanoseconds time = (ksNanoseconds)frameIndex * 1000 * 1000 * 1000 / 90;
+
+		const ksNanoseconds t0 = GetTimeNanoseconds();
+
+		ksGltfScene_Simulate( &scene, &viewState, &input, time );
+
+		const ksNanoseconds t1 = GetTimeNanoseconds();
+
+		ksNanoseconds updateTime = 0;
+		ksNanoseconds renderTime = 0;
+		for ( int eye = 0; eye < numPasses; eye++ )
+		{
+			const ksNanoseconds t2 = GetTimeNanoseconds();
+
+			ksGltfScene_UpdateBuffers( &commandBuffer, &scene, &viewState, ( numPasses == 1 ) ? 2 : eye );
+
+			const ksNanoseconds t3 = GetTimeNanoseconds();
+
+			ksGpuMock_BeginRenderPass( &commandBuffer );
+			ksGltfScene_Render( &commandBuffer, &scene, &viewState );
+			ksGpuMock_EndRenderPass( &commandBuffer );
+
+			const ksNanoseconds t4 = GetTimeNanoseconds();
+
+			updateTime += t3 - t2;
+			renderTime += t4 - t3;
+		}
+
+		const ksNanoseconds t5 = GetTimeNanoseconds();
+
+		if ( frameIndex >= WARMUP_FRAMES )
+		{
+			const int sampleIndex = frameIndex - WARMUP_FRAMES;
+			samples[BENCH_PHASE_SIMULATE][sampleIndex] = t1 - t0;
+			samples[BENCH_PHASE_UPDATE][sampleIndex] = updateTime;
+			samples[BENCH_PHASE_RENDER][sampleIndex] = renderTime;
+			samples[BENCH_PHASE_FRAME][sampleIndex] = t5 - t0;
+		}
+	}
+
+	frameCounters = ksGpuMock_GetCounters();
+
+	for ( int phase = 0; phase < BENCH_PHASE_MAX; phase++ )
+	{
+		PrintPercentiles( benchPhaseNames[phase], samples[phase], sampleCount );
+		free( samples[phase] );
+	}
+
+	Print( "per frame  %1.1f draw calls, %1.1f indirect draws, %1.1f instances, %1.1f program changes, %1.1f pipeline changes, %1.1f buffer maps\n",
+			(float)frameCounters.drawCalls / sampleCount,
+			(float)frameCounters.indirectDraws / sampleCount,
+			(float)frameCounters.instances / sampleCount,
+			(float)frameCounters.programChanges / sampleCount,
+			(float)frameCounters.pipelineChanges / sampleCount,
+			(float)frameCounters.bufferMaps / sampleCount );
+	Print( "per frame  %1.1f allocations, %1.1f reallocations, %1.1f frees\n",
+			(float)frameCounters.allocations / sampleCount,
+			(float)frameCounters.reallocations / sampleCount,
+			(float)frameCounters.frees / sampleCount );
+
+	ksGltfScene_Destroy( &context, &scene );
+
+	remove( fileName );
+
+	// The frame loop should not allocate after the warm-up frames.
+	if ( frameCounters.allocations != 0 || frameCounters.reallocations != 0 )
+	{
+		Error( "%u allocations and %u reallocations after the warm-up frames", frameCounters.allocations, frameCounters.reallocations );
+		return 1;
+	}
+	return 0;
+}
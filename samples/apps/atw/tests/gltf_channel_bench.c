@@ -0,0 +1,216 @@
+/*
+================================================================================================
+
+Description	:	Headless benchmark of the glTF animation channel sweep.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Fills the translation, rotation and scale channel blocks of a single time line with random
+key frames and measures how many channels ksGltf_ApplyChannelBlock interpolates per
+millisecond. Before timing, the results of a number of frames are compared bit for bit with
+interpolating each channel on its own with ksVector3f_Lerp and ksQuatf_Lerp.
+
+This benchmark is built once with KSALGEBRA_SIMD enabled and once without. Both builds use
+-ffp-contract=off so the scalar code is not contracted into fused multiply-adds.
+
+================================================================================================
+*/
+
+#include "gpu_mock.h"
+#include "../scenes/scene_settings.h"
+#include "../scenes/scene_view_state.h"
+#include "../scenes/scene_gltf.h"
+
+#define VERIFY_FRAMES			64
+
+static float RandomFloat( unsigned int * seed )
+{
+	*seed = *seed * 1664525 + 1013904223;
+	return (float)( *seed >> 8 ) * ( 2.0f / (float)( 1 << 24 ) ) - 1.0f;
+}
+
+static void SetFrame( ksGltfScene * scene, const int frameIndex, const int sampleCount )
+{
+	scene->state.timeLineFrameState[0].frame = ( frameIndex * 7 ) % ( sampleCount - 1 );
+	scene->state.timeLineFrameState[0].fraction = (float)( ( frameIndex * 37 ) % 100 ) * 0.01f;
+}
+
+static void ApplyChannels( ksGltfScene * scene, const int firstChannel, const int channelCount )
+{
+	for ( int type = 0; type < GLTF_CHANNEL_MAX; type++ )
+	{
+		ksGltf_ApplyChannelBlock( scene, &scene->timeLines[0], &scene->timeLines[0].channelBlocks[type], firstChannel, channelCount );
+	}
+}
+
+int main( int argc, char * argv[] )
+{
+	int channelCount = 4093;
+	int sampleCount = 32;
+	int frameCount = 4096;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char * arg = argv[i];
+		if ( arg[0] == '-' ) { arg++; }
+
+		if ( strcmp( arg, "c" ) == 0 && i + 1 < argc )		{ channelCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "s" ) == 0 && i + 1 < argc )	{ sampleCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "f" ) == 0 && i + 1 < argc )	{ frameCount = atoi( argv[++i] ); }
+		else
+		{
+			Print( "Unknown option: %s\n"
+				   "atw_gltf_channel_bench [options]\n"
+				   "options:\n"
+				   "   -c <n>      number of channels per channel type\n"
+				   "   -s <n>      number of key frames\n"
+				   "   -f <n>      number of frames to time\n",
+				   arg );
+			return 1;
+		}
+	}
+
+	if ( channelCount < 1 || sampleCount < 2 || frameCount < 1 )
+	{
+		Error( "Invalid arguments" );
+		return 1;
+	}
+
+	// Set up just enough of a scene for the channel sweep: one node per channel and a single time line.
+	ksGltfScene scene;
+	memset( &scene, 0, sizeof( scene ) );
+	scene.nodeCount = channelCount;
+	scene.nodes = (ksGltfNode *) calloc( channelCount, sizeof( ksGltfNode ) );
+	scene.state.nodeState = (ksGltfNodeState *) calloc( channelCount, sizeof( ksGltfNodeState ) );
+	scene.timeLineCount = 1;
+	scene.timeLines = (ksGltfTimeLine *) calloc( 1, sizeof( ksGltfTimeLine ) );
+	scene.state.timeLineFrameState = (ksGltfTimeLineFrameState *) calloc( 1, sizeof( ksGltfTimeLineFrameState ) );
+
+	unsigned int seed = 12345;
+	ksGltfTimeLine * timeLine = &scene.timeLines[0];
+	timeLine->sampleCount = sampleCount;
+	for ( int type = 0; type < GLTF_CHANNEL_MAX; type++ )
+	{
+		ksGltfChannelBlock * block = &timeLine->channelBlocks[type];
+		block->type = (ksGltfChannelType)type;
+		block->componentCount = ( type == GLTF_CHANNEL_ROTATION ) ? 4 : 3;
+		block->channelCount = channelCount;
+		block->stride = ( channelCount + 3 ) & ~3;
+		block->nodes = (ksGltfNode **) malloc( block->stride * sizeof( ksGltfNode * ) );
+		block->keys = (float *) AllocAlignedMemory( sampleCount * block->componentCount * block->stride * sizeof( float ), 16 );
+		memset( block->keys, 0, sampleCount * block->componentCount * block->stride * sizeof( float ) );
+		for ( int lane = 0; lane < channelCount; lane++ )
+		{
+			block->nodes[lane] = &scene.nodes[lane];
+			for ( int frame = 0; frame < sampleCount; frame++ )
+			{
+				for ( int component = 0; component < block->componentCount; component++ )
+				{
+					block->keys[( frame * block->componentCount + component ) * block->stride + lane] = RandomFloat( &seed );
+				}
+			}
+		}
+	}
+
+	// Compare with interpolating each channel on its own, also when the channels are split over jobs.
+	int mismatches = 0;
+	for ( int frameIndex = 0; frameIndex < VERIFY_FRAMES; frameIndex++ )
+	{
+		SetFrame( &scene, frameIndex, sampleCount );
+		if ( ( frameIndex & 1 ) == 0 )
+		{
+			ApplyChannels( &scene, 0, channelCount );
+		}
+		else
+		{
+			for ( int first = 0; first < channelCount; first += GLTF_JOB_SIZE )
+			{
+				ApplyChannels( &scene, first, ( channelCount - first < GLTF_JOB_SIZE ) ? channelCount - first : GLTF_JOB_SIZE );
+			}
+		}
+
+		const int frame = scene.state.timeLineFrameState[0].frame;
+		const float fraction = scene.state.timeLineFrameState[0].fraction;
+		for ( int lane = 0; lane < channelCount; lane++ )
+		{
+			const ksGltfNodeState * nodeState = &scene.state.nodeState[lane];
+			for ( int type = 0; type < GLTF_CHANNEL_MAX; type++ )
+			{
+				const ksGltfChannelBlock * block = &timeLine->channelBlocks[type];
+				float a[4];
+				float b[4];
+				for ( int component = 0; component < block->componentCount; component++ )
+				{
+					a[component] = block->keys[( ( frame + 0 ) * block->componentCount + component ) * block->stride + lane];
+					b[component] = block->keys[( ( frame + 1 ) * block->componentCount + component ) * block->stride + lane];
+				}
+				if ( type == GLTF_CHANNEL_ROTATION )
+				{
+					ksQuatf expected;
+					ksQuatf_Lerp( &expected, (const ksQuatf *)a, (const ksQuatf *)b, fraction );
+					mismatches += ( memcmp( &expected, &nodeState->rotation, sizeof( expected ) ) != 0 );
+				}
+				else
+				{
+					ksVector3f expected;
+					ksVector3f_Lerp( &expected, (const ksVector3f *)a, (const ksVector3f *)b, fraction );
+					mismatches += ( memcmp( &expected, ( type == GLTF_CHANNEL_TRANSLATION ) ? &nodeState->translation : &nodeState->scale, sizeof( expected ) ) != 0 );
+				}
+			}
+		}
+	}
+
+	const ksNanoseconds startTime = GetTimeNanoseconds();
+	for ( int frameIndex = 0; frameIndex < frameCount; frameIndex++ )
+	{
+		SetFrame( &scene, frameIndex, sampleCount );
+		ApplyChannels( &scene, 0, channelCount );
+	}
+	const ksNanoseconds endTime = GetTimeNanoseconds();
+
+	const double milliseconds = ( endTime - startTime ) * 1e-6;
+	const double channels = (double)frameCount * channelCount * GLTF_CHANNEL_MAX;
+#if defined( KSALGEBRA_USE_SSE )
+	const char * path = "SSE";
+#else
+	const char * path = "scalar";
+#endif
+	Print( "%s: %d channels x %d types, %d frames, %1.3f ms, %1.0f channels/ms, %d mismatches\n",
+			path, channelCount, GLTF_CHANNEL_MAX, frameCount, milliseconds, channels / milliseconds, mismatches );
+
+	for ( int type = 0; type < GLTF_CHANNEL_MAX; type++ )
+	{
+		FreeAlignedMemory( timeLine->channelBlocks[type].keys );
+		free( timeLine->channelBlocks[type].nodes );
+	}
+	free( scene.state.timeLineFrameState );
+	free( scene.timeLines );
+	free( scene.state.nodeState );
+	free( scene.nodes );
+
+	return ( mismatches == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,224 @@
+/*
+================================================================================================
+
+Description	:	Headless benchmark of the hierarchical glTF node culling.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Writes a synthetic scene with animated nodes and loads it twice. Both copies are simulated
+every frame and the application moves the root node of every sub-tree in every odd frame.
+The sub-trees of one copy are culled with ksGltf_CullSubTree after every frame, and the
+sub-trees of the other copy are only culled after every even frame, like a renderer that
+simulates more often than it culls. In the even frames the roots did not move, but they did
+move since the last time the second copy was culled.
+
+The average number of visited, tested and culled nodes and the average cull time per frame
+of the copy that is culled every frame are printed.
+
+The benchmark fails when the geometry bounds, sub-tree bounds or culled flag of any node of
+the copy that is culled every other frame is not bit for bit the same as that of the copy
+that is culled every frame.
+
+================================================================================================
+*/
+
+#include "gpu_mock.h"
+#include "../scenes/scene_settings.h"
+#include "../scenes/scene_view_state.h"
+#include "../scenes/scene_gltf.h"
+#include "gltf_scene_gen.h"
+
+typedef enum
+{
+	CULL_EVERY_FRAME,
+	CULL_EVERY_OTHER_FRAME,
+	CULL_MAX
+} ksCullMode;
+
+// Culls all visible sub-trees for both eyes and adds the visited, tested and culled nodes.
+static void CullScene( ksGltfScene * scene, const ksViewState * viewState, int * visitedNodes, int * testedNodes, int * culledNodes )
+{
+	for ( int subTreeIndex = 0; subTreeIndex < scene->state.currentSubScene->subTreeCount; subTreeIndex++ )
+	{
+		const ksGltfSubTree * subTree = scene->state.currentSubScene->subTrees[subTreeIndex];
+		if ( !scene->state.subTreeState[(int)( subTree - scene->subTrees )].visible )
+		{
+			continue;
+		}
+		*visitedNodes += subTree->nodeCount;
+		ksGltf_CullSubTree( scene, subTree, viewState, 2, testedNodes, culledNodes );
+	}
+}
+
+// Returns the number of nodes of which the bounds or the culled flag differ from the reference scene.
+static int CompareCulling( const ksGltfScene * scene, const ksGltfScene * reference )
+{
+	int differences = 0;
+	for ( int nodeIndex = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
+	{
+		const ksGltfNodeState * nodeState = &scene->state.nodeState[nodeIndex];
+		const ksGltfNodeState * referenceState = &reference->state.nodeState[nodeIndex];
+		differences += ( memcmp( &nodeState->geometryMins, &referenceState->geometryMins, sizeof( ksVector3f ) ) != 0 ||
+						memcmp( &nodeState->geometryMaxs, &referenceState->geometryMaxs, sizeof( ksVector3f ) ) != 0 ||
+						memcmp( &nodeState->subTreeMins, &referenceState->subTreeMins, sizeof( ksVector3f ) ) != 0 ||
+						memcmp( &nodeState->subTreeMaxs, &referenceState->subTreeMaxs, sizeof( ksVector3f ) ) != 0 ||
+						nodeState->culled != referenceState->culled );
+	}
+	return differences;
+}
+
+int main( int argc, char * argv[] )
+{
+	ksGltfSceneGenParms genParms;
+	ksGltfSceneGen_InitParms( &genParms );
+	genParms.subTreeCount = 64;
+	genParms.subTreeNodeCount = 256;
+
+	int frameCount = 64;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char * arg = argv[i];
+		if ( arg[0] == '-' ) { arg++; }
+
+		if ( strcmp( arg, "f" ) == 0 && i + 1 < argc )		{ frameCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "t" ) == 0 && i + 1 < argc )	{ genParms.subTreeCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "n" ) == 0 && i + 1 < argc )	{ genParms.subTreeNodeCount = atoi( argv[++i] ); }
+		else
+		{
+			Print( "Unknown option: %s\n"
+				   "atw_gltf_cull_bench [options]\n"
+				   "options:\n"
+				   "   -f <n>      number of frames\n"
+				   "   -t <n>      number of sub-trees\n"
+				   "   -n <n>      number of nodes per sub-tree\n",
+				   arg );
+			return 1;
+		}
+	}
+
+	if ( frameCount < 2 || genParms.subTreeCount < 1 || genParms.subTreeNodeCount < 4 )
+	{
+		Error( "Invalid arguments" );
+		return 1;
+	}
+
+	genParms.animatedNodeCount = genParms.subTreeNodeCount / 4;
+
+	const char * fileName = OUTPUT_PATH "gltf_cull_bench_scene.gltf";
+	if ( !ksGltfSceneGen_WriteFile( fileName, &genParms ) )
+	{
+		return 1;
+	}
+
+	ksGpuContext context;
+	ksGpuMock_CreateContext( &context );
+
+	ksGpuRenderPass renderPass;
+	renderPass.sampleCount = KS_GPU_SAMPLE_COUNT_1;
+
+	ksViewState viewState;
+	ksViewState_Init( &viewState, 0.0640f );
+
+	ksGpuWindowInput input;
+	memset( &input, 0, sizeof( input ) );
+
+	ksSceneSettings settings;
+	ksSceneSettings_Init( &context, &settings );
+	ksSceneSettings_SetGltf( &settings, fileName );
+
+	ksGltfScene scenes[CULL_MAX];
+	for ( int mode = 0; mode < CULL_MAX; mode++ )
+	{
+		ksGltfScene_CreateFromFile( &context, &scenes[mode], &settings, &renderPass );
+	}
+
+	remove( fileName );
+
+	int failures = 0;
+	int visitedNodes = 0;
+	int testedNodes = 0;
+	int culledNodes = 0;
+	ksNanoseconds cullTime = 0;
+
+	for ( int frameIndex = 0; frameIndex < frameCount; frameIndex++ )
+	{
+		// Frames at 90 Hz.
+		const ksNanoseconds time = (ksNanoseconds)frameIndex * 1000 * 1000 * 1000 / 90;
+
+		for ( int mode = 0; mode < CULL_MAX; mode++ )
+		{
+			ksGltfScene * scene = &scenes[mode];
+
+			// The application moves the sub-tree roots in odd frames.
+			if ( ( frameIndex & 1 ) != 0 )
+			{
+				for ( int subTreeIndex = 0; subTreeIndex < scene->subTreeCount; subTreeIndex++ )
+				{
+					ksGltfNodeState * rootState = &scene->state.nodeState[(int)( scene->subTrees[subTreeIndex].nodes[0] - scene->nodes )];
+					rootState->translation.x += ( ( frameIndex & 2 ) != 0 ) ? 0.5f : -0.5f;
+					rootState->localDirty = true;
+				}
+			}
+
+			ksGltfScene_Simulate( scene, &viewState, &input, time );
+		}
+
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+		CullScene( &scenes[CULL_EVERY_FRAME], &viewState, &visitedNodes, &testedNodes, &culledNodes );
+		cullTime += GetTimeNanoseconds() - startTime;
+
+		if ( ( frameIndex & 1 ) == 0 )
+		{
+			int unusedVisitedNodes = 0;
+			int unusedTestedNodes = 0;
+			int unusedCulledNodes = 0;
+			CullScene( &scenes[CULL_EVERY_OTHER_FRAME], &viewState, &unusedVisitedNodes, &unusedTestedNodes, &unusedCulledNodes );
+
+			const int differences = CompareCulling( &scenes[CULL_EVERY_OTHER_FRAME], &scenes[CULL_EVERY_FRAME] );
+			if ( differences != 0 )
+			{
+				Print( "frame %d: the bounds or culled flags of %d nodes are stale\n", frameIndex, differences );
+				failures++;
+			}
+		}
+	}
+
+	for ( int mode = 0; mode < CULL_MAX; mode++ )
+	{
+		ksGltfScene_Destroy( &context, &scenes[mode] );
+	}
+
+	Print( "%d sub-trees x %d nodes, %d animated nodes per sub-tree, %d frames\n",
+			genParms.subTreeCount, genParms.subTreeNodeCount, genParms.animatedNodeCount, frameCount );
+	Print( "visited = %d, tested = %d, culled = %d nodes per frame, %1.3f ms per frame\n",
+			visitedNodes / frameCount, testedNodes / frameCount, culledNodes / frameCount, cullTime * 1e-6 / frameCount );
+
+	Print( "%d culls differ from culling every frame\n", failures );
+
+	return ( failures == 0 ) ? 0 : 1;
+}
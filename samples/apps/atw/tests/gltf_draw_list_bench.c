@@ -0,0 +1,382 @@
+/*
+================================================================================================
+
+Description	:	Headless benchmark of building and rendering the glTF draw list.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Writes a synthetic forest scene in which a few meshes are repeated by thousands of nodes,
+loads it on top of the headless GPU layer and renders a number of frames in two ways:
+
+	- instanced: the visible instances of a surface are drawn with a single draw call,
+	- direct: the surfaces are drawn one at a time, because their instance counts are
+	  set to zero, which is how the scene was drawn before instancing.
+
+For both ways the draw calls, instances, pipeline changes and material changes per frame are
+printed, together with the CPU time of ksGltfScene_UpdateBuffers and ksGltfScene_Render per
+frame. The render time of the direct frames is also printed per 10000 draw calls, which is
+the cost of walking the compiled uniform operations of the materials.
+
+The benchmark fails when:
+	- the two ways do not draw the same number of instances,
+	- the instances drawn are not the visible surfaces of the draw list,
+	- a batch contains different surfaces or more instances than the surface supports,
+	- instancing does not reduce the number of draw calls,
+	- the pipeline or material changes are not equal to the number of distinct pipeline
+	  ranks and materials in the draw list, which means the draw list is not sorted on state,
+	- a material sets the same uniform more than once per draw.
+
+The mock GPU layer asserts that every uniform of a program has been set for every draw.
+
+================================================================================================
+*/
+
+#include "gpu_mock.h"
+#include "../scenes/scene_settings.h"
+#include "../scenes/scene_view_state.h"
+#include "../scenes/scene_gltf.h"
+#include "gltf_scene_gen.h"
+
+typedef enum
+{
+	DRAW_PATH_INSTANCED,
+	DRAW_PATH_DIRECT,
+	DRAW_PATH_MAX
+} ksDrawPath;
+
+static const char * drawPathNames[DRAW_PATH_MAX] = { "instanced", "direct" };
+
+typedef struct
+{
+	ksNanoseconds		updateTime;
+	ksNanoseconds		renderTime;
+	ksGpuMockCounters	counters;
+	int					surfaceCount;		// visible surfaces summed over all frames and passes
+	int					batchCount;			// batches summed over all frames and passes
+	int					pipelineChanges;	// summed over all frames and passes
+	int					materialChanges;	// summed over all frames and passes
+} ksDrawPathResult;
+
+// Counts the distinct values in a small array.
+static int CountDistinct( const int * values, const int count )
+{
+	int distinct = 0;
+	for ( int i = 0; i < count; i++ )
+	{
+		int j = 0;
+		while ( j < i && values[j] != values[i] )
+		{
+			j++;
+		}
+		distinct += ( j == i );
+	}
+	return distinct;
+}
+
+// Verifies the batches of the sorted draw list and returns the number of failed checks.
+static int VerifyDrawList( const ksGltfScene * scene, const ksDrawPath path )
+{
+	const ksGltfDrawList * drawList = &scene->drawList;
+	int failures = 0;
+
+	int instanceCount = 0;
+	for ( int batchIndex = 0; batchIndex < drawList->batchCount; batchIndex++ )
+	{
+		const ksGltfDrawBatch * batch = &drawList->batches[batchIndex];
+		const ksGltfSurface * surface = drawList->surfaces[drawList->order[batch->first]].surface;
+		for ( int drawIndex = batch->first; drawIndex < batch->first + batch->count; drawIndex++ )
+		{
+			if ( drawList->surfaces[drawList->order[drawIndex]].surface != surface )
+			{
+				Print( "%s: batch %d contains different surfaces\n", drawPathNames[path], batchIndex );
+				failures++;
+				break;
+			}
+		}
+		if ( batch->count > 1 && batch->count > surface->geometry.instanceCount )
+		{
+			Print( "%s: batch %d has %d instances, more than %d\n", drawPathNames[path], batchIndex, batch->count, surface->geometry.instanceCount );
+			failures++;
+		}
+		instanceCount += batch->count;
+	}
+	if ( instanceCount != drawList->surfaceCount )
+	{
+		Print( "%s: the batches have %d instances instead of %d\n", drawPathNames[path], instanceCount, drawList->surfaceCount );
+		failures++;
+	}
+
+	if ( drawList->sortOnState && drawList->surfaceCount > 0 )
+	{
+		int * pipelineRanks = (int *) malloc( drawList->surfaceCount * sizeof( int ) );
+		int * materials = (int *) malloc( drawList->surfaceCount * sizeof( int ) );
+		for ( int drawIndex = 0; drawIndex < drawList->surfaceCount; drawIndex++ )
+		{
+			const ksGltfMaterial * material = drawList->surfaces[drawIndex].surface->material;
+			pipelineRanks[drawIndex] = material->technique->pipelineRank;
+			materials[drawIndex] = (int)( material - scene->materials );
+		}
+		const int distinctPipelineRanks = CountDistinct( pipelineRanks, drawList->surfaceCount );
+		const int distinctMaterials = CountDistinct( materials, drawList->surfaceCount );
+		if ( drawList->pipelineChanges != distinctPipelineRanks || drawList->materialChanges != distinctMaterials )
+		{
+			Print( "%s: %d pipeline and %d material changes for %d pipeline ranks and %d materials\n", drawPathNames[path],
+					drawList->pipelineChanges, drawList->materialChanges, distinctPipelineRanks, distinctMaterials );
+			failures++;
+		}
+		free( materials );
+		free( pipelineRanks );
+	}
+
+	return failures;
+}
+
+// Returns the number of materials that set the same uniform more than once.
+static int VerifyUniformOps( const ksGltfScene * scene )
+{
+	int failures = 0;
+	for ( int materialIndex = 0; materialIndex < scene->materialCount; materialIndex++ )
+	{
+		const ksGltfMaterial * material = &scene->materials[materialIndex];
+		for ( int opIndex = 0; opIndex < material->uniformOpCount; opIndex++ )
+		{
+			int otherIndex = opIndex + 1;
+			while ( otherIndex < material->uniformOpCount && material->uniformOps[otherIndex].index != material->uniformOps[opIndex].index )
+			{
+				otherIndex++;
+			}
+			if ( otherIndex < material->uniformOpCount )
+			{
+				Print( "%s sets uniform %d more than once\n", material->name, material->uniformOps[opIndex].index );
+				failures++;
+				break;
+			}
+		}
+	}
+	return failures;
+}
+
+int main( int argc, char * argv[] )
+{
+	ksGltfSceneGenParms genParms;
+	ksGltfSceneGen_InitParms( &genParms );
+	genParms.techniqueCount = 4;
+	genParms.materialCount = 8;
+	genParms.modelCount = 8;
+	genParms.subTreeCount = 16;
+	genParms.subTreeNodeCount = 256;
+	genParms.animatedNodeCount = 0;
+
+	int frameCount = 64;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char * arg = argv[i];
+		if ( arg[0] == '-' ) { arg++; }
+
+		if ( strcmp( arg, "f" ) == 0 && i + 1 < argc )		{ frameCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "t" ) == 0 && i + 1 < argc )	{ genParms.subTreeCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "n" ) == 0 && i + 1 < argc )	{ genParms.subTreeNodeCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "o" ) == 0 && i + 1 < argc )	{ genParms.modelCount = atoi( argv[++i] ); }
+		else
+		{
+			Print( "Unknown option: %s\n"
+				   "atw_gltf_draw_list_bench [options]\n"
+				   "options:\n"
+				   "   -f <n>      number of frames\n"
+				   "   -t <n>      number of sub-trees\n"
+				   "   -n <n>      number of nodes per sub-tree\n"
+				   "   -o <n>      number of meshes\n",
+				   arg );
+			return 1;
+		}
+	}
+
+	if ( frameCount < 1 || genParms.subTreeCount < 1 || genParms.subTreeNodeCount < 2 || genParms.modelCount < 1 )
+	{
+		Error( "Invalid arguments" );
+		return 1;
+	}
+
+	const char * fileName = OUTPUT_PATH "gltf_draw_list_bench_scene.gltf";
+	if ( !ksGltfSceneGen_WriteFile( fileName, &genParms ) )
+	{
+		return 1;
+	}
+
+	ksGpuContext context;
+	ksGpuMock_CreateContext( &context );
+
+	ksGpuRenderPass renderPass;
+	renderPass.sampleCount = KS_GPU_SAMPLE_COUNT_1;
+
+	ksSceneSettings settings;
+	ksSceneSettings_Init( &context, &settings );
+	ksSceneSettings_SetGltf( &settings, fileName );
+
+	ksViewState viewState;
+	ksViewState_Init( &viewState, 0.0640f );
+
+	ksGpuWindowInput input;
+	memset( &input, 0, sizeof( input ) );
+
+	ksGpuCommandBuffer commandBuffer;
+	memset( &commandBuffer, 0, sizeof( commandBuffer ) );
+	commandBuffer.context = &context;
+
+	ksGltfScene scene;
+	ksGltfScene_CreateFromFile( &context, &scene, &settings, &renderPass );
+
+	remove( fileName );
+
+	int failures = VerifyUniformOps( &scene );
+
+	// Remember the instance counts so the direct path can turn instancing off.
+	int totalSurfaceCount = 0;
+	for ( int modelIndex = 0; modelIndex < scene.modelCount; modelIndex++ )
+	{
+		totalSurfaceCount += scene.models[modelIndex].surfaceCount;
+	}
+	int * instanceCounts = (int *) malloc( ( totalSurfaceCount + 1 ) * sizeof( int ) );
+
+	ksDrawPathResult results[DRAW_PATH_MAX];
+	memset( results, 0, sizeof( results ) );
+
+	for ( int path = 0; path < DRAW_PATH_MAX; path++ )
+	{
+		for ( int modelIndex = 0, surfaceIndex = 0; modelIndex < scene.modelCount; modelIndex++ )
+		{
+			for ( int i = 0; i < scene.models[modelIndex].surfaceCount; i++, surfaceIndex++ )
+			{
+				ksGpuGeometry * geometry = &scene.models[modelIndex].surfaces[i].geometry;
+				if ( path == DRAW_PATH_INSTANCED )
+				{
+					instanceCounts[surfaceIndex] = geometry->instanceCount;
+				}
+				else
+				{
+					geometry->instanceCount = 0;
+				}
+			}
+		}
+
+		ksDrawPathResult * result = &results[path];
+		ksGpuMock_ResetCounters();
+
+		for ( int frameIndex = 0; frameIndex < frameCount; frameIndex++ )
+		{
+			// Frames at 90 Hz.
+			const ksNanoseconds time = (ksNanoseconds)frameIndex * 1000 * 1000 * 1000 / 90;
+
+			ksGltfScene_Simulate( &scene, &viewState, &input, time );
+
+			for ( int eye = 0; eye < NUM_EYES; eye++ )
+			{
+				const ksNanoseconds t0 = GetTimeNanoseconds();
+
+				ksGltfScene_UpdateBuffers( &commandBuffer, &scene, &viewState, eye );
+
+				const ksNanoseconds t1 = GetTimeNanoseconds();
+
+				ksGpuMock_BeginRenderPass( &commandBuffer );
+				ksGltfScene_Render( &commandBuffer, &scene, &viewState );
+				ksGpuMock_EndRenderPass( &commandBuffer );
+
+				const ksNanoseconds t2 = GetTimeNanoseconds();
+
+				result->updateTime += t1 - t0;
+				result->renderTime += t2 - t1;
+				result->surfaceCount += scene.drawList.surfaceCount;
+				result->batchCount += scene.drawList.batchCount;
+				result->pipelineChanges += scene.drawList.pipelineChanges;
+				result->materialChanges += scene.drawList.materialChanges;
+
+				if ( frameIndex == 0 )
+				{
+					failures += VerifyDrawList( &scene, (ksDrawPath)path );
+				}
+			}
+		}
+
+		result->counters = ksGpuMock_GetCounters();
+
+		if ( result->counters.instances != (uint32_t)result->surfaceCount )
+		{
+			Print( "%s: drew %u instances of %d visible surfaces\n", drawPathNames[path], result->counters.instances, result->surfaceCount );
+			failures++;
+		}
+		if ( result->counters.drawCalls != (uint32_t)result->batchCount )
+		{
+			Print( "%s: %u draw calls for %d batches\n", drawPathNames[path], result->counters.drawCalls, result->batchCount );
+			failures++;
+		}
+	}
+
+	for ( int modelIndex = 0, surfaceIndex = 0; modelIndex < scene.modelCount; modelIndex++ )
+	{
+		for ( int i = 0; i < scene.models[modelIndex].surfaceCount; i++, surfaceIndex++ )
+		{
+			scene.models[modelIndex].surfaces[i].geometry.instanceCount = instanceCounts[surfaceIndex];
+		}
+	}
+	free( instanceCounts );
+
+	if ( results[DRAW_PATH_INSTANCED].counters.instances != results[DRAW_PATH_DIRECT].counters.instances )
+	{
+		Print( "the instanced path drew %u instances and the direct path %u\n",
+				results[DRAW_PATH_INSTANCED].counters.instances, results[DRAW_PATH_DIRECT].counters.instances );
+		failures++;
+	}
+	if ( results[DRAW_PATH_INSTANCED].counters.drawCalls >= results[DRAW_PATH_DIRECT].counters.drawCalls )
+	{
+		Print( "instancing did not reduce the %u draw calls\n", results[DRAW_PATH_DIRECT].counters.drawCalls );
+		failures++;
+	}
+
+	Print( "%d sub-trees x %d nodes, %d meshes, %d materials, %d techniques, %d frames\n",
+			genParms.subTreeCount, genParms.subTreeNodeCount, genParms.modelCount,
+			genParms.materialCount, genParms.techniqueCount, frameCount );
+	Print( "%-10s %10s %10s %10s %10s %10s %10s %12s\n", "path", "draws", "instances", "pipelines", "materials", "update ms", "render ms", "ms/10k draws" );
+	for ( int path = 0; path < DRAW_PATH_MAX; path++ )
+	{
+		const ksDrawPathResult * result = &results[path];
+		Print( "%-10s %10.1f %10.1f %10.1f %10.1f %10.3f %10.3f %12.3f\n", drawPathNames[path],
+				(double)result->counters.drawCalls / frameCount,
+				(double)result->counters.instances / frameCount,
+				(double)result->pipelineChanges / frameCount,
+				(double)result->materialChanges / frameCount,
+				result->updateTime * 1e-6 / frameCount,
+				result->renderTime * 1e-6 / frameCount,
+				( result->counters.drawCalls > 0 ) ? result->renderTime * 1e-6 * 10000.0 / result->counters.drawCalls : 0.0 );
+	}
+
+	ksGltfScene_Destroy( &context, &scene );
+
+	Print( "%d draw list checks failed\n", failures );
+
+	return ( failures == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,288 @@
+/*
+================================================================================================
+
+Description	:	Headless benchmark of calculating the glTF skin joint palettes.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Writes a crowd of skinned characters, loads it on top of the headless GPU layer and animates
+it. After every simulated frame the joint palettes of all skins are calculated three ways:
+
+	- old: the loop ksGltfScene_UpdateBuffers used before the joint palettes were calculated
+	  in jobs, walking the nodes of the sub-trees and multiplying with the scalar code,
+	- serial: ksGltf_UpdateSkinJoints for every skin on the calling thread,
+	- jobs: ksGltf_UpdateSkinJoints in skin jobs on the worker threads of the scene.
+
+The number of joint matrices per millisecond of each is printed. This benchmark is built with
+KSALGEBRA_SIMD enabled, such that ksGltf_UpdateSkinJoints uses the SIMD matrix multiply where
+available, and with -ffp-contract=off because the results are only bit-identical when the
+scalar code is not contracted into fused multiply-adds.
+
+The benchmark fails when any joint matrix of the serial or jobs palettes is not bit for bit
+the same as the joint matrix of the old loop after any frame.
+
+================================================================================================
+*/
+
+#include "gpu_mock.h"
+#include "../scenes/scene_settings.h"
+#include "../scenes/scene_view_state.h"
+#include "../scenes/scene_gltf.h"
+#include "gltf_scene_gen.h"
+
+typedef enum
+{
+	JOINTS_OLD,
+	JOINTS_SERIAL,
+	JOINTS_JOBS,
+	JOINTS_MAX
+} ksJointsMode;
+
+static const char * jointsModeNames[JOINTS_MAX] = { "old", "serial", "jobs" };
+
+// Same as the scalar path of ksMatrix4x4f_Multiply.
+static void ScalarMatrix4x4f_Multiply( ksMatrix4x4f * result, const ksMatrix4x4f * a, const ksMatrix4x4f * b )
+{
+	for ( int i = 0; i < 4; i++ )
+	{
+		for ( int j = 0; j < 4; j++ )
+		{
+			result->m[i][j] = a->m[0][j] * b->m[i][0] + a->m[1][j] * b->m[i][1] + a->m[2][j] * b->m[i][2] + a->m[3][j] * b->m[i][3];
+		}
+	}
+}
+
+// The joint palette loop of ksGltfScene_UpdateBuffers before the palettes were calculated in jobs.
+static void OldUpdateJoints( const ksGltfScene * scene, ksMatrix4x4f ** skinJoints )
+{
+	for ( int subTreeIndex = 0; subTreeIndex < scene->state.currentSubScene->subTreeCount; subTreeIndex++ )
+	{
+		const ksGltfSubTree * subTree = scene->state.currentSubScene->subTrees[subTreeIndex];
+		for ( int nodeIndex = 0; nodeIndex < subTree->nodeCount; nodeIndex++ )
+		{
+			const ksGltfNode * node = subTree->nodes[nodeIndex];
+			const ksGltfSkin * skin = node->skin;
+			if ( skin == NULL )
+			{
+				continue;
+			}
+
+			const ksGltfNodeState * parentNodeState = &scene->state.nodeState[(int)( skin->parentNode - scene->nodes )];
+
+			ksMatrix4x4f inverseGlobalSkeletonTransfom;
+			ksMatrix4x4f_Invert( &inverseGlobalSkeletonTransfom, &parentNodeState->globalTransform );
+
+			ksMatrix4x4f * joints = skinJoints[(int)( skin - scene->skins )];
+			for ( int jointIndex = 0; jointIndex < skin->jointCount; jointIndex++ )
+			{
+				const ksGltfNodeState * jointNodeState = &scene->state.nodeState[(int)( skin->joints[jointIndex].node - scene->nodes )];
+
+				ksMatrix4x4f localJointTransform;
+				ScalarMatrix4x4f_Multiply( &localJointTransform, &inverseGlobalSkeletonTransfom, &jointNodeState->globalTransform );
+				ScalarMatrix4x4f_Multiply( &joints[jointIndex], &localJointTransform, &skin->inverseBindMatrices[jointIndex] );
+			}
+		}
+	}
+}
+
+int main( int argc, char * argv[] )
+{
+	ksGltfSceneGenParms genParms;
+	ksGltfSceneGen_InitParms( &genParms );
+	genParms.techniqueCount = 1;
+	genParms.materialCount = 1;
+	genParms.modelCount = 1;
+	genParms.subTreeCount = 1024;
+	genParms.branchCount = 4;
+	genParms.jointNames = GLTF_SCENE_GEN_JOINT_NAMES_UNIQUE;
+	genParms.skinned = true;
+
+	int jointCount = 32;
+	int frameCount = 64;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char * arg = argv[i];
+		if ( arg[0] == '-' ) { arg++; }
+
+		if ( strcmp( arg, "f" ) == 0 && i + 1 < argc )		{ frameCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "c" ) == 0 && i + 1 < argc )	{ genParms.subTreeCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "j" ) == 0 && i + 1 < argc )	{ jointCount = atoi( argv[++i] ); }
+		else
+		{
+			Print( "Unknown option: %s\n"
+				   "atw_gltf_joint_bench [options]\n"
+				   "options:\n"
+				   "   -f <n>      number of frames\n"
+				   "   -c <n>      number of characters\n"
+				   "   -j <n>      number of joints per character\n",
+				   arg );
+			return 1;
+		}
+	}
+
+	if ( frameCount < 1 || genParms.subTreeCount < 1 || jointCount < 1 || jointCount > GLTF_MAX_JOINTS )
+	{
+		Error( "Invalid arguments" );
+		return 1;
+	}
+
+	genParms.subTreeNodeCount = jointCount + 1;
+	genParms.animatedNodeCount = jointCount;
+
+#if defined( KSALGEBRA_USE_SSE )
+	const char * path = "SSE";
+#elif defined( KSALGEBRA_USE_NEON )
+	const char * path = "NEON";
+#else
+	const char * path = "scalar";
+#endif
+
+	const char * fileName = OUTPUT_PATH "gltf_joint_bench_scene.gltf";
+	if ( !ksGltfSceneGen_WriteFile( fileName, &genParms ) )
+	{
+		return 1;
+	}
+
+	ksGpuContext context;
+	ksGpuMock_CreateContext( &context );
+
+	ksGpuRenderPass renderPass;
+	renderPass.sampleCount = KS_GPU_SAMPLE_COUNT_1;
+
+	ksViewState viewState;
+	ksViewState_Init( &viewState, 0.0640f );
+
+	ksGpuWindowInput input;
+	memset( &input, 0, sizeof( input ) );
+
+	ksSceneSettings settings;
+	ksSceneSettings_Init( &context, &settings );
+	ksSceneSettings_SetGltf( &settings, fileName );
+
+	ksGltfScene scene;
+	ksGltfScene_CreateFromFile( &context, &scene, &settings, &renderPass );
+
+	remove( fileName );
+
+	// The joint palettes of each mode are stored consecutively per skin.
+	int totalJointCount = 0;
+	for ( int skinIndex = 0; skinIndex < scene.skinCount; skinIndex++ )
+	{
+		totalJointCount += scene.skins[skinIndex].jointCount;
+	}
+
+	ksGltfSkin ** skins = (ksGltfSkin **) malloc( scene.skinCount * sizeof( ksGltfSkin * ) );
+	ksMatrix4x4f * palettes[JOINTS_MAX];
+	ksMatrix4x4f ** skinJoints[JOINTS_MAX];
+	for ( int mode = 0; mode < JOINTS_MAX; mode++ )
+	{
+		palettes[mode] = (ksMatrix4x4f *) malloc( totalJointCount * sizeof( ksMatrix4x4f ) );
+		skinJoints[mode] = (ksMatrix4x4f **) malloc( scene.skinCount * sizeof( ksMatrix4x4f * ) );
+		for ( int skinIndex = 0, offset = 0; skinIndex < scene.skinCount; offset += scene.skins[skinIndex++].jointCount )
+		{
+			skinJoints[mode][skinIndex] = palettes[mode] + offset;
+		}
+	}
+	for ( int skinIndex = 0; skinIndex < scene.skinCount; skinIndex++ )
+	{
+		skins[skinIndex] = &scene.skins[skinIndex];
+	}
+
+	int failures = 0;
+	ksNanoseconds jointTimes[JOINTS_MAX] = { 0 };
+
+	for ( int frameIndex = 0; frameIndex < frameCount; frameIndex++ )
+	{
+		// Frames at 90 Hz.
+		const ksNanoseconds time = (ksNanoseconds)frameIndex * 1000 * 1000 * 1000 / 90;
+
+		ksGltfScene_Simulate( &scene, &viewState, &input, time );
+
+		for ( int mode = 0; mode < JOINTS_MAX; mode++ )
+		{
+			memset( palettes[mode], 0, totalJointCount * sizeof( ksMatrix4x4f ) );
+		}
+
+		ksNanoseconds startTime = GetTimeNanoseconds();
+		OldUpdateJoints( &scene, skinJoints[JOINTS_OLD] );
+		jointTimes[JOINTS_OLD] += GetTimeNanoseconds() - startTime;
+
+		startTime = GetTimeNanoseconds();
+		for ( int skinIndex = 0; skinIndex < scene.skinCount; skinIndex++ )
+		{
+			ksGltf_UpdateSkinJoints( &scene, skins[skinIndex], skinJoints[JOINTS_SERIAL][skinIndex] );
+		}
+		jointTimes[JOINTS_SERIAL] += GetTimeNanoseconds() - startTime;
+
+		// Same jobs as ksGltfScene_UpdateBuffers, but without mapping the joint buffers.
+		startTime = GetTimeNanoseconds();
+		for ( int first = 0; first < scene.skinCount; first += GLTF_SKIN_JOB_SIZE )
+		{
+			ksGltfJob * job = ksGltf_AddJob( &scene.jobs, first, scene.skinCount, GLTF_SKIN_JOB_SIZE );
+			job->jointSkins = skins + first;
+			job->joints = skinJoints[JOINTS_JOBS] + first;
+		}
+		ksGltf_RunJobs( &scene );
+		jointTimes[JOINTS_JOBS] += GetTimeNanoseconds() - startTime;
+
+		for ( int mode = JOINTS_SERIAL; mode < JOINTS_MAX; mode++ )
+		{
+			int differences = 0;
+			for ( int jointIndex = 0; jointIndex < totalJointCount; jointIndex++ )
+			{
+				differences += ( memcmp( &palettes[mode][jointIndex], &palettes[JOINTS_OLD][jointIndex], sizeof( ksMatrix4x4f ) ) != 0 );
+			}
+			if ( differences != 0 )
+			{
+				Print( "frame %d: %d %s joint matrices differ\n", frameIndex, differences, jointsModeNames[mode] );
+				failures++;
+			}
+		}
+	}
+
+	Print( "%d skins x %d joints, %d frames, %s matrix multiply, %d workers\n", scene.skinCount, jointCount, frameCount, path,
+			scene.useThreadPool ? GLTF_WORKERS : 0 );
+	for ( int mode = 0; mode < JOINTS_MAX; mode++ )
+	{
+		Print( "%-8s %10.3f ms/frame %10.0f joints/ms\n", jointsModeNames[mode], jointTimes[mode] * 1e-6 / frameCount,
+				(double)totalJointCount * frameCount / ( jointTimes[mode] * 1e-6 ) );
+	}
+
+	for ( int mode = 0; mode < JOINTS_MAX; mode++ )
+	{
+		free( skinJoints[mode] );
+		free( palettes[mode] );
+	}
+	free( skins );
+
+	ksGltfScene_Destroy( &context, &scene );
+
+	Print( "%d frames differ from the old joint palette loop\n", failures );
+
+	return ( failures == 0 ) ? 0 : 1;
+}
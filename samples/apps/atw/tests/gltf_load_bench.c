@@ -0,0 +1,248 @@
+/*
+================================================================================================
+
+Description	:	Headless benchmark of loading glTF 1.0, glTF 2.0 and GLB files.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Writes the same synthetic scene as a glTF 1.0 file, a glTF 2.0 file with the buffer as a
+data URI, a glTF 2.0 .glb file with the buffer in the binary chunk and a textured .glb file.
+Every file is loaded a number of times on top of the headless GPU layer and the fastest and
+average load times are printed, so the name based glTF 1.0 path can be compared with the
+index based glTF 2.0 path on equivalent scenes.
+
+This benchmark is built once with GLTF_WORKERS worker threads, and once with a single worker
+thread, so loading the buffers, images and shaders serially can be compared with loading them
+in parallel.
+
+The benchmark fails when a glTF 2.0 scene does not load the same number of nodes, models,
+materials, sub-trees and animations as the glTF 1.0 scene, when a frame of a glTF 2.0
+scene does not record the same draw calls and instances, or when the textured scene does
+not create its texture.
+
+================================================================================================
+*/
+
+#include "gpu_mock.h"
+#include "../scenes/scene_settings.h"
+#include "../scenes/scene_view_state.h"
+#include "../scenes/scene_gltf.h"
+#include "gltf_scene_gen.h"
+
+typedef enum
+{
+	LOAD_FORMAT_GLTF_10,
+	LOAD_FORMAT_GLTF_20,
+	LOAD_FORMAT_GLB_20,
+	LOAD_FORMAT_GLB_20_TEXTURED,
+	LOAD_FORMAT_MAX
+} ksLoadFormat;
+
+static const char * loadFormatNames[LOAD_FORMAT_MAX] =
+{
+	"glTF 1.0",
+	"glTF 2.0",
+	"GLB 2.0",
+	"GLB 2.0 textured"
+};
+
+static const char * loadFormatFileNames[LOAD_FORMAT_MAX] =
+{
+	OUTPUT_PATH "gltf_load_bench_10.gltf",
+	OUTPUT_PATH "gltf_load_bench_20.gltf",
+	OUTPUT_PATH "gltf_load_bench_20.glb",
+	OUTPUT_PATH "gltf_load_bench_20_textured.glb"
+};
+
+typedef struct
+{
+	ksNanoseconds	minLoadTime;
+	ksNanoseconds	totalLoadTime;
+	int				nodeCount;
+	int				modelCount;
+	int				materialCount;
+	int				subTreeCount;
+	int				animationCount;
+	unsigned int	texturesCreated;
+	unsigned int	drawCalls;
+	unsigned int	instances;
+} ksLoadResult;
+
+static void LoadScene( ksLoadResult * result, ksGpuContext * context, const char * fileName, const int loadCount )
+{
+	ksGpuRenderPass renderPass;
+	renderPass.sampleCount = KS_GPU_SAMPLE_COUNT_1;
+
+	ksGpuWindowInput input;
+	memset( &input, 0, sizeof( input ) );
+
+	memset( result, 0, sizeof( ksLoadResult ) );
+	result->minLoadTime = ~0ULL;
+
+	for ( int loadIndex = 0; loadIndex < loadCount; loadIndex++ )
+	{
+		ksSceneSettings settings;
+		ksSceneSettings_Init( context, &settings );
+		ksSceneSettings_SetGltf( &settings, fileName );
+
+		ksViewState viewState;
+		ksViewState_Init( &viewState, 0.0640f );
+
+		ksGpuMock_ResetCounters();
+
+		ksGltfScene scene;
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+		ksGltfScene_CreateFromFile( context, &scene, &settings, &renderPass );
+		const ksNanoseconds loadTime = GetTimeNanoseconds() - startTime;
+
+		result->minLoadTime = MIN( result->minLoadTime, loadTime );
+		result->totalLoadTime += loadTime;
+
+		if ( loadIndex == 0 )
+		{
+			result->nodeCount = scene.nodeCount;
+			result->modelCount = scene.modelCount;
+			result->materialCount = scene.materialCount;
+			result->subTreeCount = scene.subTreeCount;
+			result->animationCount = scene.animationCount;
+			result->texturesCreated = ksGpuMock_GetCounters().texturesCreated;
+
+			ksGpuCommandBuffer commandBuffer;
+			memset( &commandBuffer, 0, sizeof( commandBuffer ) );
+			commandBuffer.context = context;
+
+			ksGltfScene_Simulate( &scene, &viewState, &input, 0 );
+			ksGltfScene_UpdateBuffers( &commandBuffer, &scene, &viewState, 0 );
+
+			ksGpuMock_ResetCounters();
+			ksGpuMock_BeginRenderPass( &commandBuffer );
+			ksGltfScene_Render( &commandBuffer, &scene, &viewState );
+			ksGpuMock_EndRenderPass( &commandBuffer );
+
+			const ksGpuMockCounters counters = ksGpuMock_GetCounters();
+			result->drawCalls = counters.drawCalls;
+			result->instances = counters.instances;
+		}
+
+		ksGltfScene_Destroy( context, &scene );
+	}
+}
+
+int main( int argc, char * argv[] )
+{
+	int loadCount = 4;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char * arg = argv[i];
+		if ( arg[0] == '-' ) { arg++; }
+
+		if ( strcmp( arg, "l" ) == 0 && i + 1 < argc )		{ loadCount = atoi( argv[++i] ); }
+		else
+		{
+			Print( "Unknown option: %s\n"
+				   "atw_gltf_load_bench [options]\n"
+				   "options:\n"
+				   "   -l <n>      number of times each file is loaded\n",
+				   arg );
+			return 1;
+		}
+	}
+
+	loadCount = MAX( loadCount, 1 );
+
+	ksGpuContext context;
+	ksGpuMock_CreateContext( &context );
+
+	ksGltfSceneGenParms genParms;
+	ksGltfSceneGen_InitParms( &genParms );
+
+	ksGltfSceneGenParms texturedGenParms = genParms;
+	texturedGenParms.textured = true;
+
+	if ( !ksGltfSceneGen_WriteFile( loadFormatFileNames[LOAD_FORMAT_GLTF_10], &genParms ) ||
+			!ksGltfSceneGen_WriteFile20( loadFormatFileNames[LOAD_FORMAT_GLTF_20], &genParms, false ) ||
+				!ksGltfSceneGen_WriteFile20( loadFormatFileNames[LOAD_FORMAT_GLB_20], &genParms, true ) ||
+					!ksGltfSceneGen_WriteFile20( loadFormatFileNames[LOAD_FORMAT_GLB_20_TEXTURED], &texturedGenParms, true ) )
+	{
+		return 1;
+	}
+
+	ksLoadResult results[LOAD_FORMAT_MAX];
+	for ( int format = 0; format < LOAD_FORMAT_MAX; format++ )
+	{
+		LoadScene( &results[format], &context, loadFormatFileNames[format], loadCount );
+	}
+
+	Print( "%-18s %8s %8s %6s %6s %9s %6s %8s %8s\n", "format", "min ms", "avg ms", "nodes", "models", "materials", "anims", "draws", "textures" );
+	for ( int format = 0; format < LOAD_FORMAT_MAX; format++ )
+	{
+		const ksLoadResult * result = &results[format];
+		Print( "%-18s %8.3f %8.3f %6d %6d %9d %6d %8u %8u\n", loadFormatNames[format],
+				result->minLoadTime * 1e-6, result->totalLoadTime * 1e-6 / loadCount,
+				result->nodeCount, result->modelCount, result->materialCount, result->animationCount,
+				result->drawCalls, result->texturesCreated );
+	}
+
+	int failures = 0;
+	const ksLoadResult * reference = &results[LOAD_FORMAT_GLTF_10];
+	for ( int format = LOAD_FORMAT_GLTF_20; format < LOAD_FORMAT_MAX; format++ )
+	{
+		const ksLoadResult * result = &results[format];
+		if ( result->nodeCount != reference->nodeCount ||
+				result->modelCount != reference->modelCount ||
+				result->materialCount != reference->materialCount ||
+				result->subTreeCount != reference->subTreeCount ||
+				result->animationCount != reference->animationCount )
+		{
+			Print( "%s loaded %d nodes, %d models, %d materials, %d sub-trees and %d animations instead of %d, %d, %d, %d and %d\n",
+					loadFormatNames[format], result->nodeCount, result->modelCount, result->materialCount, result->subTreeCount, result->animationCount,
+					reference->nodeCount, reference->modelCount, reference->materialCount, reference->subTreeCount, reference->animationCount );
+			failures++;
+		}
+		if ( result->drawCalls != reference->drawCalls || result->instances != reference->instances )
+		{
+			Print( "%s recorded %u draw calls and %u instances instead of %u and %u\n",
+					loadFormatNames[format], result->drawCalls, result->instances, reference->drawCalls, reference->instances );
+			failures++;
+		}
+	}
+	if ( results[LOAD_FORMAT_GLB_20_TEXTURED].texturesCreated != 1 )
+	{
+		Print( "%s created %u textures instead of 1\n", loadFormatNames[LOAD_FORMAT_GLB_20_TEXTURED], results[LOAD_FORMAT_GLB_20_TEXTURED].texturesCreated );
+		failures++;
+	}
+
+	for ( int format = 0; format < LOAD_FORMAT_MAX; format++ )
+	{
+		remove( loadFormatFileNames[format] );
+	}
+
+	Print( "%d glTF 2.0 scenes differ from the glTF 1.0 scene\n", failures );
+
+	return ( failures == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+/*
+================================================================================================
+
+Description	:	Headless test of the glTF name hash tables.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Loads a synthetic glTF scene in which half of the nodes have an empty joint name and the
+other half share joint names in groups, and verifies that:
+
+	- every name is stored in the joint name hash table exactly once,
+	- empty names are not stored and do not resolve to a node,
+	- a name that occurs more than once resolves to the last node with that name,
+	- the longest probe sequence stays short,
+	- every node name resolves to its own node.
+
+================================================================================================
+*/
+
+#include "gpu_mock.h"
+#include "../scenes/scene_settings.h"
+#include "../scenes/scene_view_state.h"
+#include "../scenes/scene_gltf.h"
+#include "gltf_scene_gen.h"
+
+// With a load factor of at most one half the longest probe sequence is expected to be far below this.
+#define MAX_PROBE_LENGTH		64
+
+static int failureCount = 0;
+
+#define CHECK( condition, ... ) \
+	if ( !( condition ) ) \
+	{ \
+		Print( "FAILED: " __VA_ARGS__ ); \
+		Print( "\n" ); \
+		failureCount++; \
+	}
+
+static int ksNameHashTest_MaxProbeLength( const ksGltfNameHash * table )
+{
+	int maxProbeLength = 0;
+	for ( int slot = 0; slot < table->size; slot++ )
+	{
+		if ( table->indices[slot] >= 0 )
+		{
+			const int probeLength = ( slot - ksGltfNameHash_FirstSlot( table, table->hashes[slot] ) ) & ( table->size - 1 );
+			maxProbeLength = ( probeLength > maxProbeLength ) ? probeLength : maxProbeLength;
+		}
+	}
+	return maxProbeLength;
+}
+
+int main( int argc, char * argv[] )
+{
+	ksGltfSceneGenParms genParms;
+	ksGltfSceneGen_InitParms( &genParms );
+	genParms.subTreeCount = 16;
+	genParms.subTreeNodeCount = 256;
+	genParms.animatedNodeCount = 0;
+	genParms.jointNames = GLTF_SCENE_GEN_JOINT_NAMES_DUPLICATE;
+	genParms.duplicateJointNames = 4;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char * arg = argv[i];
+		if ( arg[0] == '-' ) { arg++; }
+
+		if ( strcmp( arg, "t" ) == 0 && i + 1 < argc )		{ genParms.subTreeCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "n" ) == 0 && i + 1 < argc )	{ genParms.subTreeNodeCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "d" ) == 0 && i + 1 < argc )	{ genParms.duplicateJointNames = atoi( argv[++i] ); }
+		else
+		{
+			Print( "Unknown option: %s\n"
+				   "atw_gltf_name_hash_test [options]\n"
+				   "options:\n"
+				   "   -t <n>      number of sub-trees\n"
+				   "   -n <n>      number of nodes per sub-tree\n"
+				   "   -d <n>      number of nodes that share a joint name\n",
+				   arg );
+			return 1;
+		}
+	}
+
+	const char * fileName = OUTPUT_PATH "gltf_name_hash_test.gltf";
+	if ( !ksGltfSceneGen_WriteFile( fileName, &genParms ) )
+	{
+		return 1;
+	}
+
+	ksGpuContext context;
+	ksGpuMock_CreateContext( &context );
+
+	ksGpuRenderPass renderPass;
+	renderPass.sampleCount = KS_GPU_SAMPLE_COUNT_1;
+
+	ksSceneSettings settings;
+	ksSceneSettings_Init( &context, &settings );
+	ksSceneSettings_SetGltf( &settings, fileName );
+
+	ksGltfScene scene;
+	ksGltfScene_CreateFromFile( &context, &scene, &settings, &renderPass );
+
+	remove( fileName );
+
+	// Count the distinct non-empty joint names and check that each resolves to the last node with that name.
+	int emptyCount = 0;
+	int distinctCount = 0;
+	for ( int nodeIndex = scene.nodeCount - 1; nodeIndex >= 0; nodeIndex-- )
+	{
+		const char * jointName = scene.nodes[nodeIndex].jointName;
+		if ( jointName[0] == '\0' )
+		{
+			emptyCount++;
+			continue;
+		}
+		bool seenLater = false;
+		for ( int laterIndex = nodeIndex + 1; laterIndex < scene.nodeCount && !seenLater; laterIndex++ )
+		{
+			seenLater = ( strcmp( scene.nodes[laterIndex].jointName, jointName ) == 0 );
+		}
+		if ( !seenLater )
+		{
+			distinctCount++;
+			const ksGltfNode * node = ksGltf_GetNodeByJointName( &scene, jointName );
+			CHECK( node == &scene.nodes[nodeIndex], "joint name '%s' resolves to node %d instead of node %d",
+					jointName, ( node != NULL ) ? (int)( node - scene.nodes ) : -1, nodeIndex );
+		}
+	}
+
+	CHECK( emptyCount == scene.nodeCount / 2, "%d empty joint names out of %d nodes", emptyCount, scene.nodeCount );
+	CHECK( scene.nodeJointNameHash.count == distinctCount, "%d joint names stored for %d distinct joint names",
+			scene.nodeJointNameHash.count, distinctCount );
+	CHECK( ksGltf_GetNodeByJointName( &scene, "" ) == NULL, "the empty joint name resolves to a node" );
+	CHECK( ksGltf_GetNodeByJointName( &scene, "no_such_joint" ) == NULL, "an unknown joint name resolves to a node" );
+
+	const int jointProbeLength = ksNameHashTest_MaxProbeLength( &scene.nodeJointNameHash );
+	CHECK( jointProbeLength < MAX_PROBE_LENGTH, "joint name hash has a probe sequence of length %d", jointProbeLength );
+
+	// Node names are unique so every node resolves to itself.
+	for ( int nodeIndex = 0; nodeIndex < scene.nodeCount; nodeIndex++ )
+	{
+		const ksGltfNode * node = ksGltf_GetNodeByName( &scene, scene.nodes[nodeIndex].name );
+		CHECK( node == &scene.nodes[nodeIndex], "node name '%s' does not resolve to its node", scene.nodes[nodeIndex].name );
+	}
+	CHECK( scene.nodeNameHash.count == scene.nodeCount, "%d node names stored for %d nodes", scene.nodeNameHash.count, scene.nodeCount );
+
+	const int nodeProbeLength = ksNameHashTest_MaxProbeLength( &scene.nodeNameHash );
+	CHECK( nodeProbeLength < MAX_PROBE_LENGTH, "node name hash has a probe sequence of length %d", nodeProbeLength );
+
+	Print( "%d nodes, %d empty joint names, %d distinct joint names, longest probe: joint names = %d, node names = %d\n",
+			scene.nodeCount, emptyCount, distinctCount, jointProbeLength, nodeProbeLength );
+
+	ksGltfScene_Destroy( &context, &scene );
+
+	Print( "%s\n", ( failureCount == 0 ) ? "PASSED" : "FAILED" );
+	return ( failureCount == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,888 @@
+/*
+================================================================================================
+
+Description	:	Synthetic glTF scenes for the scene tests and benchmarks.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Writes a self-contained glTF 1.0 file with a configurable number of techniques, materials,
+meshes, sub-trees, nodes and animated nodes. All buffers and shaders are embedded as data
+URIs so the file can be loaded without any other files. Every mesh is a unit cube and all
+nodes are laid out on a grid in front of the viewer so they are not trivially culled.
+When 'fragmentShaderCount' is less than the technique count, the programs of the techniques
+repeat the same fragment shader sources, so identical shader conversions can be tested.
+
+Each sub-tree is a root node with 'subTreeNodeCount - 1' children. The children are spread
+over the depth levels such that every level has at most 'branchCount' nodes per parent.
+The first 'animatedNodeCount' children of each sub-tree are animated with a translation and
+rotation channel that all share a single time line.
+
+Nodes are given a 'jointName' according to 'jointNames'. When using duplicate joint names,
+every odd node has an empty joint name and every group of 'duplicateJointNames' even nodes
+share the same joint name.
+
+With 'skinned' set, every sub-tree is a skinned character. The root node has a skinned cube
+mesh with a skin of which the joints are all other nodes of the sub-tree, and the other nodes
+have no meshes. Skinning requires unique joint names and at most 256 joints per sub-tree.
+Skinned scenes can only be written as glTF 1.0 files.
+
+ksGltfSceneGen_WriteFile20 writes the same nodes, meshes and animations as a glTF 2.0 .gltf
+file with the buffer as a data URI, or as a .glb file with the buffer in the binary chunk.
+There are no techniques in glTF 2.0, so every material is a metallic-roughness material with
+the diffuse color of the glTF 1.0 material as base color. With 'textured' set, the meshes get
+texture coordinates and the materials sample a 1x1 KTX image stored in a buffer view.
+
+INTERFACE
+=========
+
+ksGltfSceneGenParms
+
+static void ksGltfSceneGen_InitParms( ksGltfSceneGenParms * parms );
+static bool ksGltfSceneGen_WriteFile( const char * fileName, const ksGltfSceneGenParms * parms );
+static bool ksGltfSceneGen_WriteFile20( const char * fileName, const ksGltfSceneGenParms * parms, const bool binary );
+
+================================================================================================
+*/
+
+#if !defined( KSGLTF_SCENE_GEN_H )
+#define KSGLTF_SCENE_GEN_H
+
+#include <utils/base64.h>
+
+typedef enum
+{
+	GLTF_SCENE_GEN_JOINT_NAMES_NONE,		// no node has a joint name
+	GLTF_SCENE_GEN_JOINT_NAMES_UNIQUE,		// every node has a unique joint name
+	GLTF_SCENE_GEN_JOINT_NAMES_DUPLICATE,	// groups of nodes share a joint name and every other node has an empty joint name
+} ksGltfSceneGenJointNames;
+
+typedef struct
+{
+	int							techniqueCount;			// techniques, each with its own program
+	int							fragmentShaderCount;	// distinct fragment shaders shared by the techniques, or zero for one per technique
+	int							materialCount;			// materials spread over the techniques
+	int							modelCount;				// meshes spread over the materials
+	int							subTreeCount;			// root nodes in the default scene
+	int							subTreeNodeCount;		// nodes per sub-tree including the root
+	int							branchCount;			// maximum number of children per node
+	int							animatedNodeCount;		// animated nodes per sub-tree
+	int							sampleCount;			// animation key frames
+	float						spacing;				// distance between the sub-trees
+	ksGltfSceneGenJointNames	jointNames;
+	int							duplicateJointNames;	// number of nodes that share a joint name
+	bool						textured;				// glTF 2.0 materials sample an embedded KTX texture
+	bool						skinned;				// glTF 1.0 sub-trees are skinned characters
+} ksGltfSceneGenParms;
+
+static void ksGltfSceneGen_InitParms( ksGltfSceneGenParms * parms )
+{
+	parms->techniqueCount = 4;
+	parms->fragmentShaderCount = 0;
+	parms->materialCount = 16;
+	parms->modelCount = 64;
+	parms->subTreeCount = 16;
+	parms->subTreeNodeCount = 64;
+	parms->branchCount = 8;
+	parms->animatedNodeCount = 8;
+	parms->sampleCount = 32;
+	parms->spacing = 4.0f;
+	parms->jointNames = GLTF_SCENE_GEN_JOINT_NAMES_NONE;
+	parms->duplicateJointNames = 4;
+	parms->textured = false;
+	parms->skinned = false;
+}
+
+static const char * gltfSceneGenVertexShader =
+	"precision highp float;\n"
+	"uniform mat4 u_modelViewMatrix;\n"
+	"uniform mat4 u_projectionMatrix;\n"
+	"attribute vec3 a_position;\n"
+	"attribute vec3 a_normal;\n"
+	"varying vec3 v_normal;\n"
+	"void main( void )\n"
+	"{\n"
+	"	v_normal = mat3( u_modelViewMatrix ) * a_normal;\n"
+	"	gl_Position = u_projectionMatrix * ( u_modelViewMatrix * vec4( a_position, 1.0 ) );\n"
+	"}\n";
+
+// The joint count is printed into the skinned vertex shader.
+static const char * gltfSceneGenSkinnedVertexShader =
+	"precision highp float;\n"
+	"uniform mat4 u_jointMatrix[%d];\n"
+	"uniform mat4 u_modelViewMatrix;\n"
+	"uniform mat4 u_projectionMatrix;\n"
+	"attribute vec3 a_position;\n"
+	"attribute vec3 a_normal;\n"
+	"attribute vec4 a_joint;\n"
+	"attribute vec4 a_weight;\n"
+	"varying vec3 v_normal;\n"
+	"void main( void )\n"
+	"{\n"
+	"	mat4 skinMatrix =	a_weight.x * u_jointMatrix[int( a_joint.x )] +\n"
+	"						a_weight.y * u_jointMatrix[int( a_joint.y )] +\n"
+	"						a_weight.z * u_jointMatrix[int( a_joint.z )] +\n"
+	"						a_weight.w * u_jointMatrix[int( a_joint.w )];\n"
+	"	v_normal = mat3( u_modelViewMatrix ) * ( mat3( skinMatrix ) * a_normal );\n"
+	"	gl_Position = u_projectionMatrix * ( u_modelViewMatrix * ( skinMatrix * vec4( a_position, 1.0 ) ) );\n"
+	"}\n";
+
+// The fragment shader index is printed into the fragment shader to give every fragment shader a different program.
+static const char * gltfSceneGenFragmentShader =
+	"precision highp float;\n"
+	"uniform vec4 u_diffuse;\n"
+	"varying vec3 v_normal;\n"
+	"void main( void )\n"
+	"{\n"
+	"	float shade = %d.0 / %d.0 + max( normalize( v_normal ).z, 0.0 );\n"
+	"	gl_FragColor = vec4( u_diffuse.xyz * shade, u_diffuse.w );\n"
+	"}\n";
+
+static void ksGltfSceneGen_WriteEscapedString( FILE * file, const char * string )
+{
+	for ( const char * c = string; c[0] != '\0'; c++ )
+	{
+		if ( c[0] == '\n' )			{ fputs( "\\n", file ); }
+		else if ( c[0] == '\t' )	{ fputs( "\\t", file ); }
+		else if ( c[0] == '"' )		{ fputs( "\\\"", file ); }
+		else if ( c[0] == '\\' )	{ fputs( "\\\\", file ); }
+		else						{ fputc( c[0], file ); }
+	}
+}
+
+static void ksGltfSceneGen_WriteJointName( FILE * file, const ksGltfSceneGenParms * parms, const int nodeIndex )
+{
+	switch ( parms->jointNames )
+	{
+		case GLTF_SCENE_GEN_JOINT_NAMES_NONE:
+			break;
+		case GLTF_SCENE_GEN_JOINT_NAMES_UNIQUE:
+			fprintf( file, ", \"jointName\": \"joint_%d\"", nodeIndex );
+			break;
+		case GLTF_SCENE_GEN_JOINT_NAMES_DUPLICATE:
+			if ( ( nodeIndex & 1 ) == 0 )
+			{
+				fprintf( file, ", \"jointName\": \"joint_%d\"", nodeIndex / ( 2 * parms->duplicateJointNames ) );
+			}
+			else
+			{
+				fprintf( file, ", \"jointName\": \"\"" );
+			}
+			break;
+	}
+}
+
+#define GLTF_SCENE_GEN_VERTEX_COUNT		24
+#define GLTF_SCENE_GEN_INDEX_COUNT		36
+
+// 1x1 RGBA8 KTX image that is embedded in the buffer of textured scenes.
+static const unsigned char gltfSceneGenImage[72] =
+{
+	0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n',	// identifier
+	0x01, 0x02, 0x03, 0x04,		// endianness
+	0x01, 0x14, 0x00, 0x00,		// glType = GL_UNSIGNED_BYTE
+	0x01, 0x00, 0x00, 0x00,		// glTypeSize
+	0x08, 0x19, 0x00, 0x00,		// glFormat = GL_RGBA
+	0x58, 0x80, 0x00, 0x00,		// glInternalFormat = GL_RGBA8
+	0x08, 0x19, 0x00, 0x00,		// glBaseInternalFormat = GL_RGBA
+	0x01, 0x00, 0x00, 0x00,		// pixelWidth
+	0x01, 0x00, 0x00, 0x00,		// pixelHeight
+	0x00, 0x00, 0x00, 0x00,		// pixelDepth
+	0x00, 0x00, 0x00, 0x00,		// numberOfArrayElements
+	0x01, 0x00, 0x00, 0x00,		// numberOfFaces
+	0x01, 0x00, 0x00, 0x00,		// numberOfMipmapLevels
+	0x00, 0x00, 0x00, 0x00,		// bytesOfKeyValueData
+	0x04, 0x00, 0x00, 0x00,		// imageSize
+	0xFF, 0xFF, 0xFF, 0xFF		// white texel
+};
+
+// Layout of the single buffer with the cube geometry, the animation key frames and the optional texture.
+typedef struct
+{
+	unsigned char *				data;
+	size_t						size;
+	size_t						positionsOffset;
+	size_t						normalsOffset;
+	size_t						vertexViewSize;
+	size_t						indexViewOffset;
+	size_t						indexViewSize;
+	size_t						animationViewOffset;
+	size_t						animationViewSize;
+	size_t						timesOffset;			// relative to the animation view
+	size_t						translationsOffset;		// relative to the animation view
+	size_t						rotationsOffset;		// relative to the animation view
+	size_t						texCoordViewOffset;
+	size_t						texCoordViewSize;		// zero if not textured
+	size_t						imageViewOffset;
+	size_t						imageViewSize;			// zero if not textured
+	size_t						skinViewOffset;
+	size_t						skinViewSize;			// zero if not skinned
+	size_t						jointsOffset;			// relative to the skin view
+	size_t						weightsOffset;			// relative to the skin view
+	size_t						inverseBindOffset;		// relative to the skin view
+} ksGltfSceneGenBuffer;
+
+static void ksGltfSceneGen_CreateBuffer( ksGltfSceneGenBuffer * buffer, const ksGltfSceneGenParms * parms )
+{
+	static const float cubePositions[24][3] =
+	{
+		{ -0.5f, -0.5f,  0.5f }, {  0.5f, -0.5f,  0.5f }, {  0.5f,  0.5f,  0.5f }, { -0.5f,  0.5f,  0.5f },	// +Z
+		{  0.5f, -0.5f, -0.5f }, { -0.5f, -0.5f, -0.5f }, { -0.5f,  0.5f, -0.5f }, {  0.5f,  0.5f, -0.5f },	// -Z
+		{  0.5f, -0.5f,  0.5f }, {  0.5f, -0.5f, -0.5f }, {  0.5f,  0.5f, -0.5f }, {  0.5f,  0.5f,  0.5f },	// +X
+		{ -0.5f, -0.5f, -0.5f }, { -0.5f, -0.5f,  0.5f }, { -0.5f,  0.5f,  0.5f }, { -0.5f,  0.5f, -0.5f },	// -X
+		{ -0.5f,  0.5f,  0.5f }, {  0.5f,  0.5f,  0.5f }, {  0.5f,  0.5f, -0.5f }, { -0.5f,  0.5f, -0.5f },	// +Y
+		{ -0.5f, -0.5f, -0.5f }, {  0.5f, -0.5f, -0.5f }, {  0.5f, -0.5f,  0.5f }, { -0.5f, -0.5f,  0.5f }	// -Y
+	};
+	static const float cubeNormals[6][3] =
+	{
+		{ 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f }, { 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f }
+	};
+
+	const int vertexCount = GLTF_SCENE_GEN_VERTEX_COUNT;
+	const int indexCount = GLTF_SCENE_GEN_INDEX_COUNT;
+	buffer->positionsOffset = 0;
+	buffer->normalsOffset = buffer->positionsOffset + vertexCount * 3 * sizeof( float );
+	buffer->vertexViewSize = buffer->normalsOffset + vertexCount * 3 * sizeof( float );
+	buffer->indexViewOffset = buffer->vertexViewSize;
+	buffer->indexViewSize = ROUNDUP( indexCount * sizeof( unsigned short ), 4 );
+	buffer->animationViewOffset = buffer->indexViewOffset + buffer->indexViewSize;
+	buffer->timesOffset = 0;
+	buffer->translationsOffset = buffer->timesOffset + parms->sampleCount * sizeof( float );
+	buffer->rotationsOffset = buffer->translationsOffset + parms->sampleCount * 3 * sizeof( float );
+	buffer->animationViewSize = buffer->rotationsOffset + parms->sampleCount * 4 * sizeof( float );
+	buffer->texCoordViewOffset = buffer->animationViewOffset + buffer->animationViewSize;
+	buffer->texCoordViewSize = parms->textured ? vertexCount * 2 * sizeof( float ) : 0;
+	buffer->imageViewOffset = buffer->texCoordViewOffset + buffer->texCoordViewSize;
+	buffer->imageViewSize = parms->textured ? sizeof( gltfSceneGenImage ) : 0;
+	buffer->skinViewOffset = ROUNDUP( buffer->imageViewOffset + buffer->imageViewSize, 4 );
+	buffer->jointsOffset = 0;
+	buffer->weightsOffset = buffer->jointsOffset + vertexCount * 4 * sizeof( float );
+	buffer->inverseBindOffset = buffer->weightsOffset + vertexCount * 4 * sizeof( float );
+	buffer->skinViewSize = parms->skinned ? buffer->inverseBindOffset + ( parms->subTreeNodeCount - 1 ) * 16 * sizeof( float ) : 0;
+	buffer->size = buffer->skinViewOffset + buffer->skinViewSize;
+	buffer->data = (unsigned char *) calloc( buffer->size, 1 );
+
+	float * positions = (float *)( buffer->data + buffer->positionsOffset );
+	float * normals = (float *)( buffer->data + buffer->normalsOffset );
+	unsigned short * indices = (unsigned short *)( buffer->data + buffer->indexViewOffset );
+	float * times = (float *)( buffer->data + buffer->animationViewOffset + buffer->timesOffset );
+	float * translations = (float *)( buffer->data + buffer->animationViewOffset + buffer->translationsOffset );
+	float * rotations = (float *)( buffer->data + buffer->animationViewOffset + buffer->rotationsOffset );
+
+	for ( int v = 0; v < vertexCount; v++ )
+	{
+		for ( int c = 0; c < 3; c++ )
+		{
+			positions[v * 3 + c] = cubePositions[v][c];
+			normals[v * 3 + c] = cubeNormals[v / 4][c];
+		}
+	}
+	for ( int face = 0; face < 6; face++ )
+	{
+		static const int quad[6] = { 0, 1, 2, 2, 3, 0 };
+		for ( int i = 0; i < 6; i++ )
+		{
+			indices[face * 6 + i] = (unsigned short)( face * 4 + quad[i] );
+		}
+	}
+	for ( int s = 0; s < parms->sampleCount; s++ )
+	{
+		const float fraction = (float)s / ( parms->sampleCount - 1 );
+		const float angle = fraction * MATH_PI;
+		times[s] = fraction * 2.0f;
+		translations[s * 3 + 0] = 0.25f * sinf( 2.0f * angle );
+		translations[s * 3 + 1] = 0.25f * cosf( 2.0f * angle );
+		translations[s * 3 + 2] = 0.0f;
+		rotations[s * 4 + 0] = 0.0f;
+		rotations[s * 4 + 1] = sinf( angle );
+		rotations[s * 4 + 2] = 0.0f;
+		rotations[s * 4 + 3] = cosf( angle );
+	}
+	if ( parms->textured )
+	{
+		float * texCoords = (float *)( buffer->data + buffer->texCoordViewOffset );
+		for ( int v = 0; v < vertexCount; v++ )
+		{
+			texCoords[v * 2 + 0] = ( ( v & 3 ) == 1 || ( v & 3 ) == 2 ) ? 1.0f : 0.0f;
+			texCoords[v * 2 + 1] = ( ( v & 3 ) >= 2 ) ? 1.0f : 0.0f;
+		}
+		memcpy( buffer->data + buffer->imageViewOffset, gltfSceneGenImage, sizeof( gltfSceneGenImage ) );
+	}
+	if ( parms->skinned )
+	{
+		// Every face of the cube follows a different joint and all sub-trees share the identity inverse bind matrices.
+		const int jointCount = parms->subTreeNodeCount - 1;
+		float * joints = (float *)( buffer->data + buffer->skinViewOffset + buffer->jointsOffset );
+		float * weights = (float *)( buffer->data + buffer->skinViewOffset + buffer->weightsOffset );
+		float * inverseBindMatrices = (float *)( buffer->data + buffer->skinViewOffset + buffer->inverseBindOffset );
+		for ( int v = 0; v < vertexCount; v++ )
+		{
+			joints[v * 4 + 0] = (float)( ( v / 4 ) % jointCount );
+			weights[v * 4 + 0] = 1.0f;
+		}
+		for ( int j = 0; j < jointCount; j++ )
+		{
+			for ( int c = 0; c < 4; c++ )
+			{
+				inverseBindMatrices[j * 16 + c * 5] = 1.0f;
+			}
+		}
+	}
+}
+
+static char * ksGltfSceneGen_EncodeBuffer( const ksGltfSceneGenBuffer * buffer )
+{
+	char * base64 = (char *) malloc( ksBase64_EncodeSizeInBytes( buffer->size ) + 1 );
+	const size_t base64Size = ksBase64_Encode( base64, buffer->data, buffer->size );
+	base64[base64Size] = '\0';
+	return base64;
+}
+
+static bool ksGltfSceneGen_WriteFile( const char * fileName, const ksGltfSceneGenParms * parms )
+{
+	assert( parms->techniqueCount >= 1 && parms->materialCount >= parms->techniqueCount && parms->modelCount >= 1 );
+	assert( parms->subTreeCount >= 1 && parms->subTreeNodeCount >= 1 && parms->branchCount >= 1 );
+	assert( parms->animatedNodeCount < parms->subTreeNodeCount && parms->sampleCount >= 2 );
+	assert( !parms->skinned || ( parms->jointNames == GLTF_SCENE_GEN_JOINT_NAMES_UNIQUE && parms->subTreeNodeCount >= 2 && parms->subTreeNodeCount <= 257 ) );
+
+	FILE * file = fopen( fileName, "wb" );
+	if ( file == NULL )
+	{
+		Error( "Failed to open %s", fileName );
+		return false;
+	}
+
+	//
+	// Buffer with the cube geometry and the animation key frames.
+	//
+
+	ksGltfSceneGenBuffer buffer;
+	ksGltfSceneGen_CreateBuffer( &buffer, parms );
+	char * base64 = ksGltfSceneGen_EncodeBuffer( &buffer );
+
+	fprintf( file, "{\n" );
+	fprintf( file, "\"asset\": { \"version\": \"1.0\" },\n" );
+
+	fprintf( file, "\"buffers\": {\n" );
+	fprintf( file, "\t\"buffer\": { \"byteLength\": %zu, \"uri\": \"data:application/octet-stream;base64,%s\" }\n", buffer.size, base64 );
+	fprintf( file, "},\n" );
+
+	free( base64 );
+	free( buffer.data );
+
+	fprintf( file, "\"bufferViews\": {\n" );
+	fprintf( file, "\t\"vertexView\": { \"buffer\": \"buffer\", \"byteOffset\": 0, \"byteLength\": %zu, \"target\": 34962 },\n", buffer.vertexViewSize );
+	fprintf( file, "\t\"indexView\": { \"buffer\": \"buffer\", \"byteOffset\": %zu, \"byteLength\": %zu, \"target\": 34963 },\n", buffer.indexViewOffset, buffer.indexViewSize );
+	fprintf( file, "\t\"animationView\": { \"buffer\": \"buffer\", \"byteOffset\": %zu, \"byteLength\": %zu }%s\n", buffer.animationViewOffset, buffer.animationViewSize,
+					parms->skinned ? "," : "" );
+	if ( parms->skinned )
+	{
+		fprintf( file, "\t\"skinView\": { \"buffer\": \"buffer\", \"byteOffset\": %zu, \"byteLength\": %zu }\n", buffer.skinViewOffset, buffer.skinViewSize );
+	}
+	fprintf( file, "},\n" );
+
+	fprintf( file, "\"accessors\": {\n" );
+	fprintf( file, "\t\"positions\": { \"bufferView\": \"vertexView\", \"byteOffset\": %zu, \"byteStride\": 12, \"componentType\": 5126, \"count\": %d, \"type\": \"VEC3\", "
+					"\"min\": [ -0.5, -0.5, -0.5 ], \"max\": [ 0.5, 0.5, 0.5 ] },\n", buffer.positionsOffset, GLTF_SCENE_GEN_VERTEX_COUNT );
+	fprintf( file, "\t\"normals\": { \"bufferView\": \"vertexView\", \"byteOffset\": %zu, \"byteStride\": 12, \"componentType\": 5126, \"count\": %d, \"type\": \"VEC3\" },\n",
+					buffer.normalsOffset, GLTF_SCENE_GEN_VERTEX_COUNT );
+	fprintf( file, "\t\"indices\": { \"bufferView\": \"indexView\", \"byteOffset\": 0, \"byteStride\": 0, \"componentType\": 5123, \"count\": %d, \"type\": \"SCALAR\" },\n",
+					GLTF_SCENE_GEN_INDEX_COUNT );
+	fprintf( file, "\t\"times\": { \"bufferView\": \"animationView\", \"byteOffset\": %zu, \"byteStride\": 0, \"componentType\": 5126, \"count\": %d, \"type\": \"SCALAR\" },\n",
+					buffer.timesOffset, parms->sampleCount );
+	fprintf( file, "\t\"translations\": { \"bufferView\": \"animationView\", \"byteOffset\": %zu, \"byteStride\": 0, \"componentType\": 5126, \"count\": %d, \"type\": \"VEC3\" },\n",
+					buffer.translationsOffset, parms->sampleCount );
+	fprintf( file, "\t\"rotations\": { \"bufferView\": \"animationView\", \"byteOffset\": %zu, \"byteStride\": 0, \"componentType\": 5126, \"count\": %d, \"type\": \"VEC4\" }%s\n",
+					buffer.rotationsOffset, parms->sampleCount, parms->skinned ? "," : "" );
+	if ( parms->skinned )
+	{
+		fprintf( file, "\t\"joints\": { \"bufferView\": \"skinView\", \"byteOffset\": %zu, \"byteStride\": 16, \"componentType\": 5126, \"count\": %d, \"type\": \"VEC4\" },\n",
+						buffer.jointsOffset, GLTF_SCENE_GEN_VERTEX_COUNT );
+		fprintf( file, "\t\"weights\": { \"bufferView\": \"skinView\", \"byteOffset\": %zu, \"byteStride\": 16, \"componentType\": 5126, \"count\": %d, \"type\": \"VEC4\" },\n",
+						buffer.weightsOffset, GLTF_SCENE_GEN_VERTEX_COUNT );
+		fprintf( file, "\t\"inverseBindMatrices\": { \"bufferView\": \"skinView\", \"byteOffset\": %zu, \"byteStride\": 0, \"componentType\": 5126, \"count\": %d, \"type\": \"MAT4\" }\n",
+						buffer.inverseBindOffset, parms->subTreeNodeCount - 1 );
+	}
+	fprintf( file, "},\n" );
+
+	//
+	// Shaders, programs and techniques.
+	//
+
+	fprintf( file, "\"shaders\": {\n" );
+	fprintf( file, "\t\"vertexShader\": { \"type\": 35633, \"uri\": \"data:text/plain," );
+	ksGltfSceneGen_WriteEscapedString( file, gltfSceneGenVertexShader );
+	fprintf( file, "\" }" );
+	if ( parms->skinned )
+	{
+		char skinnedVertexShader[1024];
+		snprintf( skinnedVertexShader, sizeof( skinnedVertexShader ), gltfSceneGenSkinnedVertexShader, parms->subTreeNodeCount - 1 );
+		fprintf( file, ",\n\t\"skinnedVertexShader\": { \"type\": 35633, \"uri\": \"data:text/plain," );
+		ksGltfSceneGen_WriteEscapedString( file, skinnedVertexShader );
+		fprintf( file, "\" }" );
+	}
+	const int fragmentShaderCount = ( parms->fragmentShaderCount > 0 ) ? parms->fragmentShaderCount : parms->techniqueCount;
+	for ( int t = 0; t < parms->techniqueCount; t++ )
+	{
+		char fragmentShader[1024];
+		snprintf( fragmentShader, sizeof( fragmentShader ), gltfSceneGenFragmentShader, t % fragmentShaderCount, fragmentShaderCount );
+		fprintf( file, ",\n\t\"fragmentShader_%d\": { \"type\": 35632, \"uri\": \"data:text/plain,", t );
+		ksGltfSceneGen_WriteEscapedString( file, fragmentShader );
+		fprintf( file, "\" }" );
+	}
+	fprintf( file, "\n},\n" );
+
+	fprintf( file, "\"programs\": {\n" );
+	if ( parms->skinned )
+	{
+		fprintf( file, "\t\"program_skinned\": { \"vertexShader\": \"skinnedVertexShader\", \"fragmentShader\": \"fragmentShader_0\" },\n" );
+	}
+	for ( int t = 0; t < parms->techniqueCount; t++ )
+	{
+		fprintf( file, "\t\"program_%d\": { \"vertexShader\": \"vertexShader\", \"fragmentShader\": \"fragmentShader_%d\" }%s\n",
+					t, t, ( t < parms->techniqueCount - 1 ) ? "," : "" );
+	}
+	fprintf( file, "},\n" );
+
+	fprintf( file, "\"techniques\": {\n" );
+	if ( parms->skinned )
+	{
+		fprintf( file, "\t\"technique_skinned\": {\n" );
+		fprintf( file, "\t\t\"parameters\": {\n" );
+		fprintf( file, "\t\t\t\"jointMatrix\": { \"semantic\": \"JOINTMATRIX\", \"type\": 35676, \"count\": %d },\n", parms->subTreeNodeCount - 1 );
+		fprintf( file, "\t\t\t\"modelViewMatrix\": { \"semantic\": \"MODELVIEW\", \"type\": 35676 },\n" );
+		fprintf( file, "\t\t\t\"projectionMatrix\": { \"semantic\": \"PROJECTION\", \"type\": 35676 },\n" );
+		fprintf( file, "\t\t\t\"diffuse\": { \"type\": 35666 },\n" );
+		fprintf( file, "\t\t\t\"position\": { \"semantic\": \"POSITION\", \"type\": 35665 },\n" );
+		fprintf( file, "\t\t\t\"normal\": { \"semantic\": \"NORMAL\", \"type\": 35665 },\n" );
+		fprintf( file, "\t\t\t\"joint\": { \"semantic\": \"JOINT\", \"type\": 35666 },\n" );
+		fprintf( file, "\t\t\t\"weight\": { \"semantic\": \"WEIGHT\", \"type\": 35666 }\n" );
+		fprintf( file, "\t\t},\n" );
+		fprintf( file, "\t\t\"attributes\": { \"a_position\": \"position\", \"a_normal\": \"normal\", \"a_joint\": \"joint\", \"a_weight\": \"weight\" },\n" );
+		fprintf( file, "\t\t\"uniforms\": { \"u_jointMatrix\": \"jointMatrix\", \"u_modelViewMatrix\": \"modelViewMatrix\", \"u_projectionMatrix\": \"projectionMatrix\", \"u_diffuse\": \"diffuse\" },\n" );
+		fprintf( file, "\t\t\"program\": \"program_skinned\",\n" );
+		fprintf( file, "\t\t\"states\": { \"enable\": [ 2929, 2884 ] }\n" );
+		fprintf( file, "\t},\n" );
+	}
+	for ( int t = 0; t < parms->techniqueCount; t++ )
+	{
+		fprintf( file, "\t\"technique_%d\": {\n", t );
+		fprintf( file, "\t\t\"parameters\": {\n" );
+		fprintf( file, "\t\t\t\"modelViewMatrix\": { \"semantic\": \"MODELVIEW\", \"type\": 35676 },\n" );
+		fprintf( file, "\t\t\t\"projectionMatrix\": { \"semantic\": \"PROJECTION\", \"type\": 35676 },\n" );
+		fprintf( file, "\t\t\t\"diffuse\": { \"type\": 35666 },\n" );
+		fprintf( file, "\t\t\t\"position\": { \"semantic\": \"POSITION\", \"type\": 35665 },\n" );
+		fprintf( file, "\t\t\t\"normal\": { \"semantic\": \"NORMAL\", \"type\": 35665 }\n" );
+		fprintf( file, "\t\t},\n" );
+		fprintf( file, "\t\t\"attributes\": { \"a_position\": \"position\", \"a_normal\": \"normal\" },\n" );
+		fprintf( file, "\t\t\"uniforms\": { \"u_modelViewMatrix\": \"modelViewMatrix\", \"u_projectionMatrix\": \"projectionMatrix\", \"u_diffuse\": \"diffuse\" },\n" );
+		fprintf( file, "\t\t\"program\": \"program_%d\",\n", t );
+		fprintf( file, "\t\t\"states\": { \"enable\": [ 2929, 2884 ] }\n" );
+		fprintf( file, "\t}%s\n", ( t < parms->techniqueCount - 1 ) ? "," : "" );
+	}
+	fprintf( file, "},\n" );
+
+	//
+	// Materials and meshes.
+	//
+
+	fprintf( file, "\"materials\": {\n" );
+	if ( parms->skinned )
+	{
+		fprintf( file, "\t\"material_skinned\": { \"technique\": \"technique_skinned\", \"values\": { \"diffuse\": [ 1.0, 1.0, 1.0, 1.0 ] } },\n" );
+	}
+	for ( int m = 0; m < parms->materialCount; m++ )
+	{
+		fprintf( file, "\t\"material_%d\": { \"technique\": \"technique_%d\", \"values\": { \"diffuse\": [ %1.3f, %1.3f, %1.3f, 1.0 ] } }%s\n",
+					m, m % parms->techniqueCount,
+					( m % 7 ) / 7.0f, ( m % 5 ) / 5.0f, ( m % 3 ) / 3.0f,
+					( m < parms->materialCount - 1 ) ? "," : "" );
+	}
+	fprintf( file, "},\n" );
+
+	fprintf( file, "\"meshes\": {\n" );
+	if ( parms->skinned )
+	{
+		fprintf( file, "\t\"mesh_skinned\": { \"primitives\": [ { \"attributes\": { \"POSITION\": \"positions\", \"NORMAL\": \"normals\", \"JOINT\": \"joints\", \"WEIGHT\": \"weights\" }, "
+						"\"indices\": \"indices\", \"material\": \"material_skinned\", \"mode\": 4 } ] },\n" );
+	}
+	for ( int m = 0; m < parms->modelCount; m++ )
+	{
+		fprintf( file, "\t\"mesh_%d\": { \"primitives\": [ { \"attributes\": { \"POSITION\": \"positions\", \"NORMAL\": \"normals\" }, "
+						"\"indices\": \"indices\", \"material\": \"material_%d\", \"mode\": 4 } ] }%s\n",
+					m, m % parms->materialCount, ( m < parms->modelCount - 1 ) ? "," : "" );
+	}
+	fprintf( file, "},\n" );
+
+	//
+	// Animations with a single shared time line.
+	//
+
+	const bool animated = ( parms->animatedNodeCount > 0 );
+	fprintf( file, "\"animations\": {\n" );
+	for ( int r = 0; r < parms->subTreeCount && animated; r++ )
+	{
+		fprintf( file, "\t\"animation_%d\": {\n", r );
+		fprintf( file, "\t\t\"parameters\": { \"TIME\": \"times\", \"translation\": \"translations\", \"rotation\": \"rotations\" },\n" );
+		fprintf( file, "\t\t\"samplers\": {\n" );
+		fprintf( file, "\t\t\t\"translationSampler\": { \"input\": \"TIME\", \"interpolation\": \"LINEAR\", \"output\": \"translation\" },\n" );
+		fprintf( file, "\t\t\t\"rotationSampler\": { \"input\": \"TIME\", \"interpolation\": \"LINEAR\", \"output\": \"rotation\" }\n" );
+		fprintf( file, "\t\t},\n" );
+		fprintf( file, "\t\t\"channels\": [\n" );
+		for ( int a = 0; a < parms->animatedNodeCount; a++ )
+		{
+			const int nodeIndex = r * parms->subTreeNodeCount + 1 + a;
+			fprintf( file, "\t\t\t{ \"sampler\": \"translationSampler\", \"target\": { \"id\": \"node_%d\", \"path\": \"translation\" } },\n", nodeIndex );
+			fprintf( file, "\t\t\t{ \"sampler\": \"rotationSampler\", \"target\": { \"id\": \"node_%d\", \"path\": \"rotation\" } }%s\n",
+						nodeIndex, ( a < parms->animatedNodeCount - 1 ) ? "," : "" );
+		}
+		fprintf( file, "\t\t]\n" );
+		fprintf( file, "\t}%s\n", ( r < parms->subTreeCount - 1 ) ? "," : "" );
+	}
+	fprintf( file, "},\n" );
+
+	//
+	// Skins with all nodes below the root of a sub-tree as joints.
+	//
+
+	if ( parms->skinned )
+	{
+		fprintf( file, "\"skins\": {\n" );
+		for ( int r = 0; r < parms->subTreeCount; r++ )
+		{
+			fprintf( file, "\t\"skin_%d\": { \"bindShapeMatrix\": [ 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 ], \"inverseBindMatrices\": \"inverseBindMatrices\", \"jointNames\": [", r );
+			for ( int n = 1; n < parms->subTreeNodeCount; n++ )
+			{
+				fprintf( file, " \"joint_%d\"%s", r * parms->subTreeNodeCount + n, ( n < parms->subTreeNodeCount - 1 ) ? "," : "" );
+			}
+			fprintf( file, " ] }%s\n", ( r < parms->subTreeCount - 1 ) ? "," : "" );
+		}
+		fprintf( file, "},\n" );
+	}
+
+	//
+	// Nodes. The children of each node are the next nodes of the sub-tree in breadth-first order.
+	//
+
+	const int gridSize = (int)ceilf( sqrtf( (float)parms->subTreeCount ) );
+	int meshIndex = 0;
+	fprintf( file, "\"nodes\": {\n" );
+	for ( int r = 0; r < parms->subTreeCount; r++ )
+	{
+		for ( int n = 0; n < parms->subTreeNodeCount; n++ )
+		{
+			const int nodeIndex = r * parms->subTreeNodeCount + n;
+			const int firstChild = n * parms->branchCount + 1;
+			const int lastChild = MIN( firstChild + parms->branchCount, parms->subTreeNodeCount );
+
+			fprintf( file, "\t\"node_%d\": { ", nodeIndex );
+			if ( n == 0 )
+			{
+				fprintf( file, "\"translation\": [ %1.3f, %1.3f, %1.3f ]",
+							( r % gridSize - 0.5f * ( gridSize - 1 ) ) * parms->spacing,
+							( r / gridSize - 0.5f * ( gridSize - 1 ) ) * parms->spacing,
+							-2.0f * parms->spacing );
+			}
+			else
+			{
+				const int siblingIndex = ( n - 1 ) % parms->branchCount;
+				fprintf( file, "\"translation\": [ %1.3f, %1.3f, %1.3f ]",
+							( siblingIndex % 3 - 1 ) * 0.3f,
+							( siblingIndex / 3 % 3 - 1 ) * 0.3f,
+							0.1f );
+			}
+			fprintf( file, ", \"rotation\": [ 0.0, 0.0, 0.0, 1.0 ], \"scale\": [ %1.3f, %1.3f, %1.3f ]",
+						( n == 0 ) ? 1.0f : 0.5f, ( n == 0 ) ? 1.0f : 0.5f, ( n == 0 ) ? 1.0f : 0.5f );
+			if ( !parms->skinned )
+			{
+				fprintf( file, ", \"meshes\": [ \"mesh_%d\" ]", meshIndex );
+				meshIndex = ( meshIndex + 1 ) % parms->modelCount;
+			}
+			else if ( n == 0 )
+			{
+				fprintf( file, ", \"meshes\": [ \"mesh_skinned\" ], \"skin\": \"skin_%d\", \"skeletons\": [ \"node_%d\" ]", r, nodeIndex + 1 );
+			}
+			ksGltfSceneGen_WriteJointName( file, parms, nodeIndex );
+			fprintf( file, ", \"children\": [" );
+			for ( int c = firstChild; c < lastChild; c++ )
+			{
+				fprintf( file, " \"node_%d\"%s", r * parms->subTreeNodeCount + c, ( c < lastChild - 1 ) ? "," : "" );
+			}
+			fprintf( file, " ] }%s\n", ( r < parms->subTreeCount - 1 || n < parms->subTreeNodeCount - 1 ) ? "," : "" );
+		}
+	}
+	fprintf( file, "},\n" );
+
+	fprintf( file, "\"scenes\": {\n" );
+	fprintf( file, "\t\"defaultScene\": { \"nodes\": [" );
+	for ( int r = 0; r < parms->subTreeCount; r++ )
+	{
+		fprintf( file, " \"node_%d\"%s", r * parms->subTreeNodeCount, ( r < parms->subTreeCount - 1 ) ? "," : "" );
+	}
+	fprintf( file, " ] }\n" );
+	fprintf( file, "},\n" );
+	fprintf( file, "\"scene\": \"defaultScene\"\n" );
+	fprintf( file, "}\n" );
+
+	fclose( file );
+	return true;
+}
+
+static void ksGltfSceneGen_WriteJson20( FILE * file, const ksGltfSceneGenParms * parms, const ksGltfSceneGenBuffer * buffer, const char * base64 )
+{
+	fprintf( file, "{\n" );
+	fprintf( file, "\"asset\": { \"version\": \"2.0\" },\n" );
+
+	// A .glb file stores the buffer in the binary chunk, which is the buffer without a uri.
+	fprintf( file, "\"buffers\": [\n" );
+	if ( base64 != NULL )
+	{
+		fprintf( file, "\t{ \"byteLength\": %zu, \"uri\": \"data:application/gltf-buffer;base64,%s\" }\n", buffer->size, base64 );
+	}
+	else
+	{
+		fprintf( file, "\t{ \"byteLength\": %zu }\n", buffer->size );
+	}
+	fprintf( file, "],\n" );
+
+	fprintf( file, "\"bufferViews\": [\n" );
+	fprintf( file, "\t{ \"buffer\": 0, \"byteOffset\": 0, \"byteLength\": %zu, \"byteStride\": 12, \"target\": 34962 },\n", buffer->vertexViewSize );
+	fprintf( file, "\t{ \"buffer\": 0, \"byteOffset\": %zu, \"byteLength\": %zu, \"target\": 34963 },\n", buffer->indexViewOffset, buffer->indexViewSize );
+	fprintf( file, "\t{ \"buffer\": 0, \"byteOffset\": %zu, \"byteLength\": %zu }", buffer->animationViewOffset, buffer->animationViewSize );
+	if ( parms->textured )
+	{
+		fprintf( file, ",\n\t{ \"buffer\": 0, \"byteOffset\": %zu, \"byteLength\": %zu, \"byteStride\": 8, \"target\": 34962 }", buffer->texCoordViewOffset, buffer->texCoordViewSize );
+		fprintf( file, ",\n\t{ \"buffer\": 0, \"byteOffset\": %zu, \"byteLength\": %zu }", buffer->imageViewOffset, buffer->imageViewSize );
+	}
+	fprintf( file, "\n],\n" );
+
+	fprintf( file, "\"accessors\": [\n" );
+	fprintf( file, "\t{ \"bufferView\": 0, \"byteOffset\": %zu, \"componentType\": 5126, \"count\": %d, \"type\": \"VEC3\", "
+					"\"min\": [ -0.5, -0.5, -0.5 ], \"max\": [ 0.5, 0.5, 0.5 ] },\n", buffer->positionsOffset, GLTF_SCENE_GEN_VERTEX_COUNT );
+	fprintf( file, "\t{ \"bufferView\": 0, \"byteOffset\": %zu, \"componentType\": 5126, \"count\": %d, \"type\": \"VEC3\" },\n",
+					buffer->normalsOffset, GLTF_SCENE_GEN_VERTEX_COUNT );
+	fprintf( file, "\t{ \"bufferView\": 1, \"byteOffset\": 0, \"componentType\": 5123, \"count\": %d, \"type\": \"SCALAR\" },\n",
+					GLTF_SCENE_GEN_INDEX_COUNT );
+	fprintf( file, "\t{ \"bufferView\": 2, \"byteOffset\": %zu, \"componentType\": 5126, \"count\": %d, \"type\": \"SCALAR\" },\n",
+					buffer->timesOffset, parms->sampleCount );
+	fprintf( file, "\t{ \"bufferView\": 2, \"byteOffset\": %zu, \"componentType\": 5126, \"count\": %d, \"type\": \"VEC3\" },\n",
+					buffer->translationsOffset, parms->sampleCount );
+	fprintf( file, "\t{ \"bufferView\": 2, \"byteOffset\": %zu, \"componentType\": 5126, \"count\": %d, \"type\": \"VEC4\" }",
+					buffer->rotationsOffset, parms->sampleCount );
+	if ( parms->textured )
+	{
+		fprintf( file, ",\n\t{ \"bufferView\": 3, \"byteOffset\": 0, \"componentType\": 5126, \"count\": %d, \"type\": \"VEC2\" }", GLTF_SCENE_GEN_VERTEX_COUNT );
+	}
+	fprintf( file, "\n],\n" );
+
+	if ( parms->textured )
+	{
+		fprintf( file, "\"images\": [ { \"bufferView\": 4, \"mimeType\": \"image/ktx\" } ],\n" );
+		fprintf( file, "\"samplers\": [ { \"magFilter\": 9729, \"minFilter\": 9729, \"wrapS\": 10497, \"wrapT\": 10497 } ],\n" );
+		fprintf( file, "\"textures\": [ { \"source\": 0, \"sampler\": 0 } ],\n" );
+	}
+
+	//
+	// Materials and meshes with the same colors and geometry as the glTF 1.0 scene.
+	//
+
+	fprintf( file, "\"materials\": [\n" );
+	for ( int m = 0; m < parms->materialCount; m++ )
+	{
+		fprintf( file, "\t{ \"name\": \"material_%d\", \"pbrMetallicRoughness\": { \"baseColorFactor\": [ %1.3f, %1.3f, %1.3f, 1.0 ], \"metallicFactor\": 0.0%s } }%s\n",
+					m, ( m % 7 ) / 7.0f, ( m % 5 ) / 5.0f, ( m % 3 ) / 3.0f,
+					parms->textured ? ", \"baseColorTexture\": { \"index\": 0 }" : "",
+					( m < parms->materialCount - 1 ) ? "," : "" );
+	}
+	fprintf( file, "],\n" );
+
+	fprintf( file, "\"meshes\": [\n" );
+	for ( int m = 0; m < parms->modelCount; m++ )
+	{
+		fprintf( file, "\t{ \"name\": \"mesh_%d\", \"primitives\": [ { \"attributes\": { \"POSITION\": 0, \"NORMAL\": 1%s }, "
+						"\"indices\": 2, \"material\": %d, \"mode\": 4 } ] }%s\n",
+					m, parms->textured ? ", \"TEXCOORD_0\": 6" : "", m % parms->materialCount, ( m < parms->modelCount - 1 ) ? "," : "" );
+	}
+	fprintf( file, "],\n" );
+
+	//
+	// Animations with a single shared time line.
+	//
+
+	const bool animated = ( parms->animatedNodeCount > 0 );
+	fprintf( file, "\"animations\": [\n" );
+	for ( int r = 0; r < parms->subTreeCount && animated; r++ )
+	{
+		fprintf( file, "\t{\n" );
+		fprintf( file, "\t\t\"name\": \"animation_%d\",\n", r );
+		fprintf( file, "\t\t\"samplers\": [\n" );
+		fprintf( file, "\t\t\t{ \"input\": 3, \"interpolation\": \"LINEAR\", \"output\": 4 },\n" );
+		fprintf( file, "\t\t\t{ \"input\": 3, \"interpolation\": \"LINEAR\", \"output\": 5 }\n" );
+		fprintf( file, "\t\t],\n" );
+		fprintf( file, "\t\t\"channels\": [\n" );
+		for ( int a = 0; a < parms->animatedNodeCount; a++ )
+		{
+			const int nodeIndex = r * parms->subTreeNodeCount + 1 + a;
+			fprintf( file, "\t\t\t{ \"sampler\": 0, \"target\": { \"node\": %d, \"path\": \"translation\" } },\n", nodeIndex );
+			fprintf( file, "\t\t\t{ \"sampler\": 1, \"target\": { \"node\": %d, \"path\": \"rotation\" } }%s\n",
+						nodeIndex, ( a < parms->animatedNodeCount - 1 ) ? "," : "" );
+		}
+		fprintf( file, "\t\t]\n" );
+		fprintf( file, "\t}%s\n", ( r < parms->subTreeCount - 1 ) ? "," : "" );
+	}
+	fprintf( file, "],\n" );
+
+	//
+	// Nodes. The children of each node are the next nodes of the sub-tree in breadth-first order.
+	//
+
+	const int gridSize = (int)ceilf( sqrtf( (float)parms->subTreeCount ) );
+	int meshIndex = 0;
+	fprintf( file, "\"nodes\": [\n" );
+	for ( int r = 0; r < parms->subTreeCount; r++ )
+	{
+		for ( int n = 0; n < parms->subTreeNodeCount; n++ )
+		{
+			const int nodeIndex = r * parms->subTreeNodeCount + n;
+			const int firstChild = n * parms->branchCount + 1;
+			const int lastChild = MIN( firstChild + parms->branchCount, parms->subTreeNodeCount );
+
+			fprintf( file, "\t{ \"name\": \"node_%d\", ", nodeIndex );
+			if ( n == 0 )
+			{
+				fprintf( file, "\"translation\": [ %1.3f, %1.3f, %1.3f ]",
+							( r % gridSize - 0.5f * ( gridSize - 1 ) ) * parms->spacing,
+							( r / gridSize - 0.5f * ( gridSize - 1 ) ) * parms->spacing,
+							-2.0f * parms->spacing );
+			}
+			else
+			{
+				const int siblingIndex = ( n - 1 ) % parms->branchCount;
+				fprintf( file, "\"translation\": [ %1.3f, %1.3f, %1.3f ]",
+							( siblingIndex % 3 - 1 ) * 0.3f,
+							( siblingIndex / 3 % 3 - 1 ) * 0.3f,
+							0.1f );
+			}
+			fprintf( file, ", \"scale\": [ %1.3f, %1.3f, %1.3f ]",
+						( n == 0 ) ? 1.0f : 0.5f, ( n == 0 ) ? 1.0f : 0.5f, ( n == 0 ) ? 1.0f : 0.5f );
+			fprintf( file, ", \"mesh\": %d", meshIndex );
+			meshIndex = ( meshIndex + 1 ) % parms->modelCount;
+			if ( firstChild < lastChild )
+			{
+				fprintf( file, ", \"children\": [" );
+				for ( int c = firstChild; c < lastChild; c++ )
+				{
+					fprintf( file, " %d%s", r * parms->subTreeNodeCount + c, ( c < lastChild - 1 ) ? "," : "" );
+				}
+				fprintf( file, " ]" );
+			}
+			fprintf( file, " }%s\n", ( r < parms->subTreeCount - 1 || n < parms->subTreeNodeCount - 1 ) ? "," : "" );
+		}
+	}
+	fprintf( file, "],\n" );
+
+	fprintf( file, "\"scenes\": [\n" );
+	fprintf( file, "\t{ \"name\": \"defaultScene\", \"nodes\": [" );
+	for ( int r = 0; r < parms->subTreeCount; r++ )
+	{
+		fprintf( file, " %d%s", r * parms->subTreeNodeCount, ( r < parms->subTreeCount - 1 ) ? "," : "" );
+	}
+	fprintf( file, " ] }\n" );
+	fprintf( file, "],\n" );
+	fprintf( file, "\"scene\": 0\n" );
+	fprintf( file, "}\n" );
+}
+
+// Writes the same scene as ksGltfSceneGen_WriteFile as a glTF 2.0 file with a metallic-roughness material
+// per glTF 1.0 material. With 'binary' set a .glb file is written with the buffer in the binary chunk.
+static bool ksGltfSceneGen_WriteFile20( const char * fileName, const ksGltfSceneGenParms * parms, const bool binary )
+{
+	assert( parms->materialCount >= 1 && parms->modelCount >= 1 );
+	assert( parms->subTreeCount >= 1 && parms->subTreeNodeCount >= 1 && parms->branchCount >= 1 );
+	assert( parms->animatedNodeCount < parms->subTreeNodeCount && parms->sampleCount >= 2 );
+	assert( !parms->skinned );
+
+	FILE * file = fopen( fileName, "wb" );
+	if ( file == NULL )
+	{
+		Error( "Failed to open %s", fileName );
+		return false;
+	}
+
+	ksGltfSceneGenBuffer buffer;
+	ksGltfSceneGen_CreateBuffer( &buffer, parms );
+
+	if ( !binary )
+	{
+		char * base64 = ksGltfSceneGen_EncodeBuffer( &buffer );
+		ksGltfSceneGen_WriteJson20( file, parms, &buffer, base64 );
+		free( base64 );
+	}
+	else
+	{
+		// The JSON chunk is written to a temporary file first because its length precedes it.
+		FILE * jsonFile = tmpfile();
+		if ( jsonFile == NULL )
+		{
+			fclose( file );
+			free( buffer.data );
+			Error( "Failed to create a temporary file for %s", fileName );
+			return false;
+		}
+		ksGltfSceneGen_WriteJson20( jsonFile, parms, &buffer, NULL );
+		const size_t jsonLength = (size_t)ftell( jsonFile );
+		const size_t jsonChunkLength = ROUNDUP( jsonLength, 4 );
+		char * json = (char *) malloc( jsonChunkLength );
+		memset( json, ' ', jsonChunkLength );	// the JSON chunk is padded with spaces
+		rewind( jsonFile );
+		const size_t jsonRead = fread( json, 1, jsonLength, jsonFile );
+		fclose( jsonFile );
+		assert( jsonRead == jsonLength );
+		UNUSED_PARM( jsonRead );
+
+		const uint32_t header[5] =
+		{
+			GLTF_BINARY_MAGIC,
+			GLTF_BINARY_VERSION_20,
+			(uint32_t)( 12 + 8 + jsonChunkLength + 8 + buffer.size ),
+			(uint32_t)jsonChunkLength,
+			GLTF_BINARY_CHUNK_TYPE_JSON
+		};
+		const uint32_t binaryChunkHeader[2] = { (uint32_t)buffer.size, GLTF_BINARY_CHUNK_TYPE_BIN };
+
+		fwrite( header, 1, sizeof( header ), file );
+		fwrite( json, 1, jsonChunkLength, file );
+		fwrite( binaryChunkHeader, 1, sizeof( binaryChunkHeader ), file );
+		fwrite( buffer.data, 1, buffer.size, file );
+		free( json );
+	}
+
+	free( buffer.data );
+	fclose( file );
+	return true;
+}
+
+#endif // !KSGLTF_SCENE_GEN_H
@@ -0,0 +1,221 @@
+/*
+================================================================================================
+
+Description	:	Headless benchmark of the glTF technique shader cache.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Writes a synthetic scene with a number of techniques of which the programs repeat a smaller
+number of fragment shaders, removes the shader cache files listed in the shader cache index,
+and loads the scene a number of times on top of the headless GPU layer:
+
+	- the first load is cold: every distinct program is converted and written to the disk
+	  cache, and the other techniques are served from the in-memory cache,
+	- the other loads are warm: every distinct program is read from the disk cache.
+
+For both the cold and the warm loads, the load time, the cache hits, the time spent converting
+shaders and the conversion time saved by the cache are printed. The loader also prints how
+long every load phase took.
+
+This benchmark is built once with GLTF_WORKERS worker threads, and once with a single worker
+thread, which loads the buffers, images and shaders and converts the shaders serially.
+
+The benchmark fails when:
+	- the cold load does not serve the repeated techniques from the in-memory cache,
+	- a warm load does not serve the distinct techniques from the disk cache,
+	- a warm load does not create exactly the same programs as the cold load.
+
+================================================================================================
+*/
+
+#include "gpu_mock.h"
+#include "../scenes/scene_settings.h"
+#include "../scenes/scene_view_state.h"
+#include "../scenes/scene_gltf.h"
+#include "gltf_scene_gen.h"
+
+// Removes all shader cache files listed in the index, and the index.
+static void ClearShaderCache()
+{
+	FILE * file = fopen( GLTF_SHADER_CACHE_INDEX, "rb" );
+	if ( file != NULL )
+	{
+		ksGltfShaderCacheIndexHeader header;
+		if ( fread( &header, sizeof( header ), 1, file ) == 1 && header.magic == GLTF_SHADER_CACHE_MAGIC )
+		{
+			ksGltfShaderCacheIndexEntry entry;
+			for ( uint32_t entryIndex = 0; entryIndex < header.entryCount && fread( &entry, sizeof( entry ), 1, file ) == 1; entryIndex++ )
+			{
+				char fileName[1024];
+				ksGltf_GetShaderCacheFileName( fileName, sizeof( fileName ), entry.hash );
+				remove( fileName );
+			}
+		}
+		fclose( file );
+	}
+	remove( GLTF_SHADER_CACHE_INDEX );
+}
+
+int main( int argc, char * argv[] )
+{
+	ksGltfSceneGenParms genParms;
+	ksGltfSceneGen_InitParms( &genParms );
+	genParms.techniqueCount = 64;
+	genParms.fragmentShaderCount = 16;
+	genParms.materialCount = 64;
+	genParms.animatedNodeCount = 0;
+
+	int loadCount = 8;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char * arg = argv[i];
+		if ( arg[0] == '-' ) { arg++; }
+
+		if ( strcmp( arg, "l" ) == 0 && i + 1 < argc )		{ loadCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "k" ) == 0 && i + 1 < argc )	{ genParms.techniqueCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "s" ) == 0 && i + 1 < argc )	{ genParms.fragmentShaderCount = atoi( argv[++i] ); }
+		else
+		{
+			Print( "Unknown option: %s\n"
+				   "atw_gltf_shader_cache_bench [options]\n"
+				   "options:\n"
+				   "   -l <n>      number of loads including the cold load\n"
+				   "   -k <n>      number of techniques\n"
+				   "   -s <n>      number of distinct fragment shaders\n",
+				   arg );
+			return 1;
+		}
+	}
+
+	if ( loadCount < 2 || genParms.techniqueCount < 1 || genParms.fragmentShaderCount < 1 )
+	{
+		Error( "Invalid arguments" );
+		return 1;
+	}
+
+	genParms.fragmentShaderCount = MIN( genParms.fragmentShaderCount, genParms.techniqueCount );
+	genParms.materialCount = MAX( genParms.materialCount, genParms.techniqueCount );
+
+	const char * fileName = OUTPUT_PATH "gltf_shader_cache_bench_scene.gltf";
+	if ( !ksGltfSceneGen_WriteFile( fileName, &genParms ) )
+	{
+		return 1;
+	}
+
+	ClearShaderCache();
+
+	ksGpuContext context;
+	ksGpuMock_CreateContext( &context );
+
+	ksGpuRenderPass renderPass;
+	renderPass.sampleCount = KS_GPU_SAMPLE_COUNT_1;
+
+	ksSceneSettings settings;
+	ksSceneSettings_Init( &context, &settings );
+	ksSceneSettings_SetGltf( &settings, fileName );
+
+	const int techniqueCount = genParms.techniqueCount;
+	const int distinctCount = genParms.fragmentShaderCount;
+	ksStringHash * programHashes = (ksStringHash *) malloc( 2 * techniqueCount * sizeof( ksStringHash ) );
+
+	int failures = 0;
+	ksNanoseconds loadTime[2] = { 0, 0 };
+	ksGltfProfile loadProfile[2];
+	memset( loadProfile, 0, sizeof( loadProfile ) );
+
+	for ( int loadIndex = 0; loadIndex < loadCount; loadIndex++ )
+	{
+		const int warm = ( loadIndex > 0 );
+
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+
+		ksGltfScene scene;
+		ksGltfScene_CreateFromFile( &context, &scene, &settings, &renderPass );
+
+		loadTime[warm] += GetTimeNanoseconds() - startTime;
+		loadProfile[warm].shaderCacheMemoryHits += scene.profile.shaderCacheMemoryHits;
+		loadProfile[warm].shaderCacheDiskHits += scene.profile.shaderCacheDiskHits;
+		loadProfile[warm].shaderConversionTime += scene.profile.shaderConversionTime;
+		loadProfile[warm].shaderCacheSavedTime += scene.profile.shaderCacheSavedTime;
+
+		const int expectedDiskHits = warm ? distinctCount : 0;
+		if ( scene.techniqueCount != techniqueCount ||
+				scene.profile.shaderCacheMemoryHits != techniqueCount - distinctCount ||
+				scene.profile.shaderCacheDiskHits != expectedDiskHits )
+		{
+			Print( "load %d: %d memory and %d disk hits instead of %d and %d\n", loadIndex,
+					scene.profile.shaderCacheMemoryHits, scene.profile.shaderCacheDiskHits,
+					techniqueCount - distinctCount, expectedDiskHits );
+			failures++;
+		}
+
+		// The mock programs hash their sources, so the programs are the same if the hashes are the same.
+		for ( int techniqueIndex = 0; techniqueIndex < scene.techniqueCount && techniqueIndex < techniqueCount; techniqueIndex++ )
+		{
+			const ksGltfTechnique * technique = &scene.techniques[techniqueIndex];
+			const ksStringHash hashes[2] = { technique->program.hash, technique->instanced ? technique->instancedProgram.hash : 0 };
+			if ( !warm )
+			{
+				programHashes[techniqueIndex * 2 + 0] = hashes[0];
+				programHashes[techniqueIndex * 2 + 1] = hashes[1];
+			}
+			else if ( hashes[0] != programHashes[techniqueIndex * 2 + 0] || hashes[1] != programHashes[techniqueIndex * 2 + 1] )
+			{
+				Print( "load %d: %s created a different program than the cold load\n", loadIndex, technique->name );
+				failures++;
+			}
+		}
+
+		ksGltfScene_Destroy( &context, &scene );
+	}
+
+	ClearShaderCache();
+	remove( fileName );
+	free( programHashes );
+
+	const int loads[2] = { 1, loadCount - 1 };
+	static const char * loadNames[2] = { "cold", "warm" };
+
+	Print( "%d techniques, %d distinct programs, %d workers\n", techniqueCount, distinctCount, GLTF_WORKERS );
+	Print( "%-6s %10s %12s %10s %9s %14s %10s\n", "load", "load ms", "memory hits", "disk hits", "hit rate", "converting ms", "saved ms" );
+	for ( int warm = 0; warm < 2; warm++ )
+	{
+		const ksGltfProfile * profile = &loadProfile[warm];
+		Print( "%-6s %10.3f %12.1f %10.1f %8.0f%% %14.3f %10.3f\n", loadNames[warm],
+				loadTime[warm] * 1e-6 / loads[warm],
+				(double)profile->shaderCacheMemoryHits / loads[warm],
+				(double)profile->shaderCacheDiskHits / loads[warm],
+				100.0 * ( profile->shaderCacheMemoryHits + profile->shaderCacheDiskHits ) / ( techniqueCount * loads[warm] ),
+				profile->shaderConversionTime * 1e-6 / loads[warm],
+				profile->shaderCacheSavedTime * 1e-6 / loads[warm] );
+	}
+
+	Print( "%d scene loads did not use the shader cache as expected\n", failures );
+
+	return ( failures == 0 ) ? 0 : 1;
+}
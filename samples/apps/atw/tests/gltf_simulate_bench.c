@@ -0,0 +1,432 @@
+/*
+================================================================================================
+
+Description	:	Headless benchmark of simulating glTF scenes with dirty flags and worker threads.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Writes a synthetic crowd scene with a number of animated nodes per sub-tree, loads it three
+times on top of the headless GPU layer and simulates the same frames with each copy:
+
+	- full: every node is marked dirty before every frame, so all local and global transforms
+	  are recomputed, which is what ksGltfScene_Simulate did before it tracked dirty nodes,
+	- dirty: serial simulation that only recomputes the transforms of changed nodes,
+	- parallel: simulation of the time lines, channels and hierarchy levels on worker threads.
+
+The average ksGltfScene_Simulate time per frame of each copy is printed for none, 1/16, 1/4
+and all but the root of the nodes of every sub-tree animated.
+
+Next, crowds of 16 up to thousands of skinned characters are written, where every joint of
+every character is animated. Each crowd is loaded once per worker configuration: serial, and
+1, 2, 4 and as many workers as there are processors. The viewer is moved back until the whole
+crowd is in view, such that the joints of every character are updated. The average time of
+ksGltfScene_Simulate plus ksGltfScene_UpdateBuffers per frame is printed for each crowd and
+configuration. For each worker count the crowd size from which the workers are faster than
+serial is reported, and the largest node count for which GLTF_WORKERS workers are not faster
+is suggested for GLTF_THREAD_MIN_NODES.
+
+The benchmark fails when the global transform of any node of the dirty or parallel copy is not
+bit for bit the same as the global transform of the full copy after any frame, when the
+parallel copy does not simulate on worker threads, or when the global transforms or joint
+matrices of any crowd simulated on workers are not bit for bit the same as those of the
+serial crowd after any frame.
+
+================================================================================================
+*/
+
+#include "gpu_mock.h"				// first, it selects the POSIX and GNU features
+#include <sys/sysinfo.h>
+#include "../scenes/scene_settings.h"
+#include "../scenes/scene_view_state.h"
+#include "../scenes/scene_gltf.h"
+#include "gltf_scene_gen.h"
+
+typedef enum
+{
+	SIMULATE_FULL,
+	SIMULATE_DIRTY,
+	SIMULATE_PARALLEL,
+	SIMULATE_MAX
+} ksSimulateMode;
+
+static const char * simulateModeNames[SIMULATE_MAX] = { "full", "dirty", "parallel" };
+
+// Returns the number of nodes of which the global transform differs from the reference scene.
+static int CompareGlobalTransforms( const ksGltfScene * scene, const ksGltfScene * reference )
+{
+	int differences = 0;
+	for ( int nodeIndex = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
+	{
+		differences += ( memcmp( &scene->state.nodeState[nodeIndex].globalTransform,
+								&reference->state.nodeState[nodeIndex].globalTransform, sizeof( ksMatrix4x4f ) ) != 0 );
+	}
+	return differences;
+}
+
+// Returns the number of skins of which the joint matrices differ from the reference scene.
+static int CompareJoints( const ksGltfScene * scene, const ksGltfScene * reference )
+{
+	int differences = 0;
+	for ( int skinIndex = 0; skinIndex < scene->skinCount; skinIndex++ )
+	{
+		differences += ( memcmp( scene->skins[skinIndex].jointBuffer.data, reference->skins[skinIndex].jointBuffer.data,
+								scene->skins[skinIndex].jointCount * sizeof( ksMatrix4x4f ) ) != 0 );
+	}
+	return differences;
+}
+
+#define MAX_CROWD_SIZES		8
+#define MAX_CROWD_CONFIGS	5
+
+// Simulates and updates crowds of skinned characters serially and on different numbers of workers.
+// Returns the number of frames in which a crowd on workers differs from the serial crowd.
+static int CrowdBenchmark( ksGpuContext * context, const int frameCount, const int maxCharacterCount, const int jointCount )
+{
+	ksGltfSceneGenParms genParms;
+	ksGltfSceneGen_InitParms( &genParms );
+	genParms.techniqueCount = 1;
+	genParms.materialCount = 1;
+	genParms.modelCount = 1;
+	genParms.subTreeNodeCount = jointCount + 1;
+	genParms.branchCount = 4;
+	genParms.animatedNodeCount = jointCount;
+	genParms.jointNames = GLTF_SCENE_GEN_JOINT_NAMES_UNIQUE;
+	genParms.skinned = true;
+
+	// Zero workers is the serial configuration.
+	int workerCounts[MAX_CROWD_CONFIGS] = { 0, 1, 2, 4 };
+	int configCount = 4;
+	const int processorCount = MIN( get_nprocs(), MAX_WORKERS );
+	if ( processorCount != 1 && processorCount != 2 && processorCount != 4 )
+	{
+		workerCounts[configCount++] = processorCount;
+	}
+
+	int characterCounts[MAX_CROWD_SIZES];
+	int sizeCount = 0;
+	for ( int characterCount = 16; characterCount <= maxCharacterCount && sizeCount < MAX_CROWD_SIZES; characterCount *= 4 )
+	{
+		characterCounts[sizeCount++] = characterCount;
+	}
+
+	const char * fileName = OUTPUT_PATH "gltf_simulate_bench_crowd.gltf";
+
+	ksGpuRenderPass renderPass;
+	renderPass.sampleCount = KS_GPU_SAMPLE_COUNT_1;
+
+	ksGpuCommandBuffer commandBuffer;
+	memset( &commandBuffer, 0, sizeof( commandBuffer ) );
+	commandBuffer.context = context;
+
+	ksGpuWindowInput input;
+	memset( &input, 0, sizeof( input ) );
+
+	int failures = 0;
+	ksNanoseconds frameTimes[MAX_CROWD_SIZES][MAX_CROWD_CONFIGS];
+
+	for ( int sizeIndex = 0; sizeIndex < sizeCount; sizeIndex++ )
+	{
+		genParms.subTreeCount = characterCounts[sizeIndex];
+		if ( !ksGltfSceneGen_WriteFile( fileName, &genParms ) )
+		{
+			return 1;
+		}
+
+		// Move the viewer back until the whole crowd is in view, also with the view rotated by GetHmdViewMatrixForTime.
+		const int gridSize = (int)ceilf( sqrtf( (float)genParms.subTreeCount ) );
+		ksViewState viewState;
+		ksViewState_Init( &viewState, 0.0640f );
+		viewState.viewTranslation.y = 0.0f;
+		viewState.viewTranslation.z = 1.5f * gridSize * genParms.spacing;
+
+		ksSceneSettings settings;
+		ksSceneSettings_Init( context, &settings );
+		ksSceneSettings_SetGltf( &settings, fileName );
+
+		ksGltfScene scenes[MAX_CROWD_CONFIGS];
+		for ( int config = 0; config < configCount; config++ )
+		{
+			ksGltfScene * scene = &scenes[config];
+			ksGltfScene_CreateFromFile( context, scene, &settings, &renderPass );
+			frameTimes[sizeIndex][config] = 0;
+
+			// Every crowd has more than GLTF_THREAD_MIN_NODES nodes, so the thread pool is kept after loading.
+			assert( scene->useThreadPool );
+			ksThreadPool_Destroy( &scene->threadPool );
+			ksThreadPool_Create( &scene->threadPool, MAX( workerCounts[config], 1 ) );
+			scene->useThreadPool = ( workerCounts[config] > 0 );
+			scene->simulateParallel = ( scene->simulateParallel && scene->useThreadPool );
+		}
+
+		for ( int frameIndex = 0; frameIndex < frameCount; frameIndex++ )
+		{
+			// Frames at 90 Hz.
+			const ksNanoseconds time = (ksNanoseconds)frameIndex * 1000 * 1000 * 1000 / 90;
+
+			for ( int config = 0; config < configCount; config++ )
+			{
+				ksGltfScene * scene = &scenes[config];
+
+				const ksNanoseconds startTime = GetTimeNanoseconds();
+				ksGltfScene_Simulate( scene, &viewState, &input, time );
+				ksGltfScene_UpdateBuffers( &commandBuffer, scene, &viewState, 2 );
+				frameTimes[sizeIndex][config] += GetTimeNanoseconds() - startTime;
+			}
+
+			for ( int config = 1; config < configCount; config++ )
+			{
+				const int transformDifferences = CompareGlobalTransforms( &scenes[config], &scenes[0] );
+				const int jointDifferences = CompareJoints( &scenes[config], &scenes[0] );
+				if ( transformDifferences != 0 || jointDifferences != 0 )
+				{
+					Print( "%d characters, %d workers, frame %d: %d global transforms and %d skins differ\n",
+							characterCounts[sizeIndex], workerCounts[config], frameIndex, transformDifferences, jointDifferences );
+					failures++;
+				}
+			}
+		}
+
+		for ( int config = 0; config < configCount; config++ )
+		{
+			// The pool of the serial configuration is destroyed with the scene.
+			scenes[config].useThreadPool = true;
+			ksGltfScene_Destroy( context, &scenes[config] );
+		}
+	}
+
+	remove( fileName );
+
+	Print( "crowds of characters with %d joints, %d frames, %d processors\n", jointCount, frameCount, get_nprocs() );
+	Print( "%-10s %8s", "characters", "nodes" );
+	for ( int config = 0; config < configCount; config++ )
+	{
+		char label[32];
+		snprintf( label, sizeof( label ), ( workerCounts[config] == 0 ) ? "serial ms" : "%d workers ms", workerCounts[config] );
+		Print( " %14s", label );
+	}
+	Print( "\n" );
+	for ( int sizeIndex = 0; sizeIndex < sizeCount; sizeIndex++ )
+	{
+		Print( "%-10d %8d", characterCounts[sizeIndex], characterCounts[sizeIndex] * genParms.subTreeNodeCount );
+		for ( int config = 0; config < configCount; config++ )
+		{
+			Print( " %14.3f", frameTimes[sizeIndex][config] * 1e-6 / frameCount );
+		}
+		Print( "\n" );
+	}
+
+	// The crossover is the smallest crowd from which the workers are faster than serial for all larger crowds.
+	for ( int config = 1; config < configCount; config++ )
+	{
+		int crossover = sizeCount;
+		while ( crossover > 0 && frameTimes[crossover - 1][config] < frameTimes[crossover - 1][0] )
+		{
+			crossover--;
+		}
+		if ( crossover < sizeCount )
+		{
+			Print( "%d workers are faster than serial from %d characters (%d nodes)\n", workerCounts[config],
+					characterCounts[crossover], characterCounts[crossover] * genParms.subTreeNodeCount );
+		}
+		else
+		{
+			Print( "%d workers are not faster than serial up to %d characters\n", workerCounts[config], characterCounts[sizeCount - 1] );
+		}
+
+		if ( workerCounts[config] == GLTF_WORKERS )
+		{
+			if ( crossover == 0 )
+			{
+				Print( "GLTF_THREAD_MIN_NODES: at most %d, currently %d\n", characterCounts[0] * genParms.subTreeNodeCount, GLTF_THREAD_MIN_NODES );
+			}
+			else if ( crossover < sizeCount )
+			{
+				Print( "GLTF_THREAD_MIN_NODES: %d, currently %d\n", characterCounts[crossover - 1] * genParms.subTreeNodeCount, GLTF_THREAD_MIN_NODES );
+			}
+			else
+			{
+				Print( "GLTF_THREAD_MIN_NODES: more than %d, currently %d\n", characterCounts[sizeCount - 1] * genParms.subTreeNodeCount, GLTF_THREAD_MIN_NODES );
+			}
+		}
+	}
+
+	return failures;
+}
+
+int main( int argc, char * argv[] )
+{
+	ksGltfSceneGenParms genParms;
+	ksGltfSceneGen_InitParms( &genParms );
+	genParms.subTreeCount = 32;
+	genParms.subTreeNodeCount = 256;
+
+	int frameCount = 64;
+	int maxCharacterCount = 4096;
+	int jointCount = 16;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char * arg = argv[i];
+		if ( arg[0] == '-' ) { arg++; }
+
+		if ( strcmp( arg, "f" ) == 0 && i + 1 < argc )		{ frameCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "t" ) == 0 && i + 1 < argc )	{ genParms.subTreeCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "n" ) == 0 && i + 1 < argc )	{ genParms.subTreeNodeCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "c" ) == 0 && i + 1 < argc )	{ maxCharacterCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "j" ) == 0 && i + 1 < argc )	{ jointCount = atoi( argv[++i] ); }
+		else
+		{
+			Print( "Unknown option: %s\n"
+				   "atw_gltf_simulate_bench [options]\n"
+				   "options:\n"
+				   "   -f <n>      number of frames\n"
+				   "   -t <n>      number of sub-trees\n"
+				   "   -n <n>      number of nodes per sub-tree\n"
+				   "   -c <n>      maximum number of characters in a crowd\n"
+				   "   -j <n>      number of joints per character\n",
+				   arg );
+			return 1;
+		}
+	}
+
+	if ( frameCount < 1 || genParms.subTreeCount < 1 || genParms.subTreeNodeCount < 16 ||
+			maxCharacterCount < 16 || jointCount < GLTF_THREAD_MIN_NODES / 16 || jointCount > GLTF_MAX_JOINTS )
+	{
+		Error( "Invalid arguments" );
+		return 1;
+	}
+
+	const char * fileName = OUTPUT_PATH "gltf_simulate_bench_scene.gltf";
+	const int animatedNodeCounts[] =
+	{
+		0,
+		genParms.subTreeNodeCount / 16,
+		genParms.subTreeNodeCount / 4,
+		genParms.subTreeNodeCount - 1
+	};
+
+	ksGpuContext context;
+	ksGpuMock_CreateContext( &context );
+
+	ksGpuRenderPass renderPass;
+	renderPass.sampleCount = KS_GPU_SAMPLE_COUNT_1;
+
+	ksViewState viewState;
+	ksViewState_Init( &viewState, 0.0640f );
+
+	ksGpuWindowInput input;
+	memset( &input, 0, sizeof( input ) );
+
+	int failures = 0;
+	ksNanoseconds simulateTimes[ARRAY_SIZE( animatedNodeCounts )][SIMULATE_MAX];
+
+	for ( int countIndex = 0; countIndex < (int)ARRAY_SIZE( animatedNodeCounts ); countIndex++ )
+	{
+		genParms.animatedNodeCount = animatedNodeCounts[countIndex];
+		if ( !ksGltfSceneGen_WriteFile( fileName, &genParms ) )
+		{
+			return 1;
+		}
+
+		ksSceneSettings settings;
+		ksSceneSettings_Init( &context, &settings );
+		ksSceneSettings_SetGltf( &settings, fileName );
+
+		ksGltfScene scenes[SIMULATE_MAX];
+		for ( int mode = 0; mode < SIMULATE_MAX; mode++ )
+		{
+			ksGltfScene_CreateFromFile( &context, &scenes[mode], &settings, &renderPass );
+			simulateTimes[countIndex][mode] = 0;
+		}
+
+		if ( !scenes[SIMULATE_PARALLEL].simulateParallel )
+		{
+			Print( "%d animated nodes: the scene is not simulated on worker threads\n", genParms.animatedNodeCount );
+			failures++;
+		}
+		scenes[SIMULATE_FULL].simulateParallel = false;
+		scenes[SIMULATE_DIRTY].simulateParallel = false;
+
+		for ( int frameIndex = 0; frameIndex < frameCount; frameIndex++ )
+		{
+			// Frames at 90 Hz.
+			const ksNanoseconds time = (ksNanoseconds)frameIndex * 1000 * 1000 * 1000 / 90;
+
+			for ( int mode = 0; mode < SIMULATE_MAX; mode++ )
+			{
+				ksGltfScene * scene = &scenes[mode];
+				if ( mode == SIMULATE_FULL )
+				{
+					for ( int nodeIndex = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
+					{
+						scene->state.nodeState[nodeIndex].localDirty = true;
+					}
+				}
+
+				const ksNanoseconds startTime = GetTimeNanoseconds();
+				ksGltfScene_Simulate( scene, &viewState, &input, time );
+				simulateTimes[countIndex][mode] += GetTimeNanoseconds() - startTime;
+			}
+
+			for ( int mode = SIMULATE_DIRTY; mode < SIMULATE_MAX; mode++ )
+			{
+				const int differences = CompareGlobalTransforms( &scenes[mode], &scenes[SIMULATE_FULL] );
+				if ( differences != 0 )
+				{
+					Print( "%d animated nodes, frame %d: %d %s global transforms differ\n",
+							genParms.animatedNodeCount, frameIndex, differences, simulateModeNames[mode] );
+					failures++;
+				}
+			}
+		}
+
+		for ( int mode = 0; mode < SIMULATE_MAX; mode++ )
+		{
+			ksGltfScene_Destroy( &context, &scenes[mode] );
+		}
+	}
+
+	remove( fileName );
+
+	Print( "%d sub-trees x %d nodes, %d frames, %d workers\n", genParms.subTreeCount, genParms.subTreeNodeCount, frameCount, GLTF_WORKERS );
+	Print( "%-10s %10s %10s %12s\n", "animated", "full ms", "dirty ms", "parallel ms" );
+	for ( int countIndex = 0; countIndex < (int)ARRAY_SIZE( animatedNodeCounts ); countIndex++ )
+	{
+		Print( "%-10d %10.3f %10.3f %12.3f\n", animatedNodeCounts[countIndex],
+				simulateTimes[countIndex][SIMULATE_FULL] * 1e-6 / frameCount,
+				simulateTimes[countIndex][SIMULATE_DIRTY] * 1e-6 / frameCount,
+				simulateTimes[countIndex][SIMULATE_PARALLEL] * 1e-6 / frameCount );
+	}
+
+	Print( "%d simulations differ from the full simulation\n", failures );
+
+	const int crowdFailures = CrowdBenchmark( &context, frameCount, maxCharacterCount, jointCount );
+
+	Print( "%d crowd frames differ from the serial crowd\n", crowdFailures );
+
+	return ( failures == 0 && crowdFailures == 0 ) ? 0 : 1;
+}
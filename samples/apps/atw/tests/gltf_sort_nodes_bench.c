@@ -0,0 +1,342 @@
+/*
+================================================================================================
+
+Description	:	Headless benchmark of sorting glTF 1.0 nodes into contiguous sub-trees.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Creates node arrays in which the nodes reference their children by name, like glTF 1.0 nodes,
+and sorts them with ksGltf_SortNodes, which resolves the child names through a name hash
+table. The same nodes are also sorted with the reference implementation below, which is the
+original quadratic implementation that finds the parents and children of every node by
+comparing names with strcmp.
+
+The nodes are stored in a random order, so children often come before their parents, and some
+nodes reference a child name that does not exist. Three node graph shapes are used:
+
+	- forest: a number of random trees,
+	- chain: a single tree in which every node has one child,
+	- flat: nodes without children.
+
+For 1000, 10000 and 100000 nodes the time to sort a forest is printed for both implementations.
+The reference implementation is only timed up to a maximum number of nodes because it is
+quadratic in the number of nodes.
+
+The benchmark fails when the hashed sort does not produce exactly the same node order and the
+same sub-tree node counts as the reference implementation.
+
+================================================================================================
+*/
+
+#include "gpu_mock.h"
+#include "../scenes/scene_settings.h"
+#include "../scenes/scene_view_state.h"
+#include "../scenes/scene_gltf.h"
+
+#define MAX_NODE_NAME			32
+#define MISSING_CHILD_INTERVAL	16		// every so many nodes reference a child name that does not exist
+
+typedef enum
+{
+	NODE_GRAPH_FOREST,
+	NODE_GRAPH_CHAIN,
+	NODE_GRAPH_FLAT,
+	NODE_GRAPH_MAX
+} ksNodeGraph;
+
+static const char * nodeGraphNames[NODE_GRAPH_MAX] = { "forest", "chain", "flat" };
+
+typedef struct
+{
+	ksGltfNode *	nodes;
+	int				nodeCount;
+	char *			names;				// node names followed by the missing child names
+	char **			childNames;			// child names of all nodes
+} ksNodeArray;
+
+static uint32_t Random( uint32_t * seed )
+{
+	*seed = *seed * 1664525u + 1013904223u;
+	return *seed >> 8;
+}
+
+// Creates the nodes in a random order. Node 'i' in creation order gets a parent that was created before it.
+static void ksNodeArray_Create( ksNodeArray * array, const int nodeCount, const ksNodeGraph graph, uint32_t seed )
+{
+	const int missingCount = nodeCount / MISSING_CHILD_INTERVAL;
+
+	int * parent = (int *) malloc( nodeCount * sizeof( int ) );
+	int * position = (int *) malloc( nodeCount * sizeof( int ) );
+	int * childCount = (int *) calloc( nodeCount, sizeof( int ) );
+	for ( int i = 0; i < nodeCount; i++ )
+	{
+		const int rootCount = 1 + nodeCount / 64;
+		parent[i] = ( graph == NODE_GRAPH_FLAT || i == 0 ) ? -1 :
+					( ( graph == NODE_GRAPH_CHAIN ) ? i - 1 :
+					( ( i < rootCount ) ? -1 : (int)( Random( &seed ) % i ) ) );
+		position[i] = i;
+	}
+	for ( int i = nodeCount - 1; i > 0; i-- )
+	{
+		const int j = (int)( Random( &seed ) % ( i + 1 ) );
+		const int temp = position[i];
+		position[i] = position[j];
+		position[j] = temp;
+	}
+
+	array->nodes = (ksGltfNode *) calloc( nodeCount, sizeof( ksGltfNode ) );
+	array->nodeCount = nodeCount;
+	array->names = (char *) malloc( ( nodeCount + missingCount ) * MAX_NODE_NAME );
+	array->childNames = (char **) malloc( ( nodeCount + missingCount + 1 ) * sizeof( char * ) );
+
+	for ( int i = 0; i < nodeCount; i++ )
+	{
+		ksGltfNode * node = &array->nodes[position[i]];
+		node->name = array->names + i * MAX_NODE_NAME;
+		snprintf( node->name, MAX_NODE_NAME, "node_%d", i );
+		childCount[position[i]] = ( i % MISSING_CHILD_INTERVAL == MISSING_CHILD_INTERVAL - 1 );
+	}
+	for ( int i = 0; i < nodeCount; i++ )
+	{
+		if ( parent[i] >= 0 )
+		{
+			childCount[position[parent[i]]]++;
+		}
+	}
+
+	// Give every node a contiguous range of child names.
+	char ** childNames = array->childNames;
+	for ( int nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++ )
+	{
+		array->nodes[nodeIndex].childNames = childNames;
+		childNames += childCount[nodeIndex];
+	}
+	for ( int i = 0, missingIndex = 0; i < nodeCount; i++ )
+	{
+		if ( parent[i] >= 0 )
+		{
+			ksGltfNode * parentNode = &array->nodes[position[parent[i]]];
+			parentNode->childNames[parentNode->childCount++] = array->nodes[position[i]].name;
+		}
+		if ( i % MISSING_CHILD_INTERVAL == MISSING_CHILD_INTERVAL - 1 )
+		{
+			ksGltfNode * node = &array->nodes[position[i]];
+			char * missingName = array->names + ( nodeCount + missingIndex++ ) * MAX_NODE_NAME;
+			snprintf( missingName, MAX_NODE_NAME, "missing_%d", i );
+			node->childNames[node->childCount++] = missingName;
+		}
+	}
+
+	free( childCount );
+	free( position );
+	free( parent );
+}
+
+static void ksNodeArray_Destroy( ksNodeArray * array )
+{
+	free( array->childNames );
+	free( array->names );
+	free( array->nodes );
+}
+
+// The original implementation, which compares the names of all nodes to find the parents and children.
+static void SortNodesReference( ksGltfNode * nodes, const int nodeCount )
+{
+	ksGltfNode * nodeStack = (ksGltfNode *) malloc( nodeCount * sizeof( ksGltfNode ) );
+	int stackSize = 0;
+	int stackOffset = 0;
+	for ( int nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++ )
+	{
+		bool foundParent = false;
+		for ( int nodeSearchIndex = 0; nodeSearchIndex < nodeCount; nodeSearchIndex++ )
+		{
+			for ( int childIndex = 0; childIndex < nodes[nodeSearchIndex].childCount; childIndex++ )
+			{
+				if ( strcmp( nodes[nodeSearchIndex].childNames[childIndex], nodes[nodeIndex].name ) == 0 )
+				{
+					foundParent = true;
+					break;
+				}
+			}
+		}
+		if ( !foundParent )
+		{
+			const int subTreeStartOffset = stackSize;
+			nodeStack[stackSize++] = nodes[nodeIndex];
+			while ( stackOffset < stackSize )
+			{
+				const ksGltfNode * node = &nodeStack[stackOffset++];
+				for ( int childIndex = 0; childIndex < node->childCount; childIndex++ )
+				{
+					for ( int nodeSearchIndex = 0; nodeSearchIndex < nodeCount; nodeSearchIndex++ )
+					{
+						if ( strcmp( node->childNames[childIndex], nodes[nodeSearchIndex].name ) == 0 )
+						{
+							assert( stackSize < nodeCount );
+							nodeStack[stackSize++] = nodes[nodeSearchIndex];
+							break;
+						}
+					}
+				}
+			}
+			for ( int updateNodeIndex = subTreeStartOffset; updateNodeIndex < stackSize; updateNodeIndex++ )
+			{
+				nodeStack[updateNodeIndex].subTreeNodeCount = stackSize - updateNodeIndex;
+			}
+		}
+	}
+	assert( stackSize == nodeCount );
+	memcpy( nodes, nodeStack, nodeCount * sizeof( nodes[0] ) );
+	free( nodeStack );
+}
+
+// Sorts a copy of the nodes with both implementations and returns the number of nodes that differ.
+static int CompareSort( const ksNodeArray * array, ksNanoseconds * hashedTime, ksNanoseconds * referenceTime )
+{
+	const size_t size = array->nodeCount * sizeof( ksGltfNode );
+	ksGltfNode * hashed = (ksGltfNode *) malloc( size );
+	ksGltfNode * reference = (ksGltfNode *) malloc( size );
+	memcpy( hashed, array->nodes, size );
+	memcpy( reference, array->nodes, size );
+
+	const ksNanoseconds t0 = GetTimeNanoseconds();
+	ksGltf_SortNodes( hashed, array->nodeCount );
+	const ksNanoseconds t1 = GetTimeNanoseconds();
+	SortNodesReference( reference, array->nodeCount );
+	const ksNanoseconds t2 = GetTimeNanoseconds();
+
+	*hashedTime = t1 - t0;
+	*referenceTime = t2 - t1;
+
+	int differences = 0;
+	for ( int nodeIndex = 0; nodeIndex < array->nodeCount; nodeIndex++ )
+	{
+		differences += ( hashed[nodeIndex].name != reference[nodeIndex].name ||
+						hashed[nodeIndex].subTreeNodeCount != reference[nodeIndex].subTreeNodeCount );
+	}
+
+	free( reference );
+	free( hashed );
+	return differences;
+}
+
+int main( int argc, char * argv[] )
+{
+	int maxReferenceNodes = 10000;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char * arg = argv[i];
+		if ( arg[0] == '-' ) { arg++; }
+
+		if ( strcmp( arg, "r" ) == 0 && i + 1 < argc )		{ maxReferenceNodes = atoi( argv[++i] ); }
+		else
+		{
+			Print( "Unknown option: %s\n"
+				   "atw_gltf_sort_nodes_bench [options]\n"
+				   "options:\n"
+				   "   -r <n>      maximum number of nodes sorted with the reference implementation\n",
+				   arg );
+			return 1;
+		}
+	}
+
+	int failures = 0;
+
+	// Compare the order for every graph shape.
+	for ( int graph = 0; graph < NODE_GRAPH_MAX; graph++ )
+	{
+		ksNodeArray array;
+		ksNodeArray_Create( &array, 1000, (ksNodeGraph)graph, 1 + graph );
+
+		ksNanoseconds hashedTime;
+		ksNanoseconds referenceTime;
+		const int differences = CompareSort( &array, &hashedTime, &referenceTime );
+		if ( differences != 0 )
+		{
+			Print( "%s: %d of %d nodes differ from the reference order\n", nodeGraphNames[graph], differences, array.nodeCount );
+			failures++;
+		}
+
+		ksNodeArray_Destroy( &array );
+	}
+
+	// Time both implementations on forests.
+	static const int nodeCounts[] = { 1000, 10000, 100000 };
+
+	Print( "%-8s %12s %12s\n", "nodes", "hashed ms", "reference ms" );
+	for ( int countIndex = 0; countIndex < (int)ARRAY_SIZE( nodeCounts ); countIndex++ )
+	{
+		const int nodeCount = nodeCounts[countIndex];
+
+		ksNodeArray array;
+		ksNodeArray_Create( &array, nodeCount, NODE_GRAPH_FOREST, 1234 + countIndex );
+
+		if ( nodeCount <= maxReferenceNodes )
+		{
+			ksNanoseconds hashedTime;
+			ksNanoseconds referenceTime;
+			const int differences = CompareSort( &array, &hashedTime, &referenceTime );
+			if ( differences != 0 )
+			{
+				Print( "%d nodes: %d nodes differ from the reference order\n", nodeCount, differences );
+				failures++;
+			}
+			Print( "%-8d %12.3f %12.3f\n", nodeCount, hashedTime * 1e-6, referenceTime * 1e-6 );
+		}
+		else
+		{
+			ksGltfNode * hashed = (ksGltfNode *) malloc( nodeCount * sizeof( ksGltfNode ) );
+			memcpy( hashed, array.nodes, nodeCount * sizeof( ksGltfNode ) );
+
+			const ksNanoseconds startTime = GetTimeNanoseconds();
+			ksGltf_SortNodes( hashed, nodeCount );
+			const ksNanoseconds hashedTime = GetTimeNanoseconds() - startTime;
+
+			// Without the reference, check that every sub-tree is contiguous and the counts add up.
+			for ( int nodeIndex = 0; nodeIndex < nodeCount; )
+			{
+				if ( hashed[nodeIndex].subTreeNodeCount < 1 || nodeIndex + hashed[nodeIndex].subTreeNodeCount > nodeCount )
+				{
+					Print( "%d nodes: invalid sub-tree node count %d\n", nodeCount, hashed[nodeIndex].subTreeNodeCount );
+					failures++;
+					break;
+				}
+				nodeIndex += hashed[nodeIndex].subTreeNodeCount;
+			}
+			free( hashed );
+
+			Print( "%-8d %12.3f %12s\n", nodeCount, hashedTime * 1e-6, "-" );
+		}
+
+		ksNodeArray_Destroy( &array );
+	}
+
+	Print( "%d node sorts differ from the reference\n", failures );
+
+	return ( failures == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,245 @@
+/*
+================================================================================================
+
+Description	:	Headless benchmark of the glTF time line key frame lookup.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Creates a number of long variable rate time lines, like motion capture data, with key frames
+at random intervals around 120 Hz, and looks up the key frame of every time line for a
+number of 90 Hz frames with ksGltf_UpdateTimeLineFrameState, which walks forward from the
+key frame of the previous update. The same frames are also looked up with a plain binary
+search over all key frames, which is how every lookup was done before.
+
+The lookups are verified while playing forward, after seeking forward and backward, and
+when the animations loop. The time per lookup is printed for both searches.
+
+The benchmark fails when ksGltf_UpdateTimeLineFrameState finds a different key frame or
+fraction than the binary search for any lookup.
+
+================================================================================================
+*/
+
+#include "gpu_mock.h"
+#include "../scenes/scene_settings.h"
+#include "../scenes/scene_view_state.h"
+#include "../scenes/scene_gltf.h"
+
+#define FRAME_RATE			90
+#define KEY_FRAME_RATE		120
+
+static uint32_t Random( uint32_t * seed )
+{
+	*seed = *seed * 1664525u + 1013904223u;
+	return *seed >> 8;
+}
+
+// The search that was used for every lookup before the key frame of the last update was used as a cursor.
+static void UpdateTimeLineFrameStateReference( ksGltfTimeLineFrameState * frameState, const ksGltfTimeLine * timeLine, const ksNanoseconds time )
+{
+	const float timeInSeconds = fmodf( time * 1e-9f, timeLine->duration );
+	int frame = 0;
+	for ( int sampleCount = timeLine->sampleCount; sampleCount > 1; sampleCount >>= 1 )
+	{
+		const int mid = sampleCount >> 1;
+		if ( timeInSeconds >= timeLine->sampleTimes[frame + mid] )
+		{
+			frame += mid;
+			sampleCount = ( sampleCount - mid ) * 2;
+		}
+	}
+	frameState->frame = frame;
+	frameState->fraction = ( timeInSeconds - timeLine->sampleTimes[frame] ) / ( timeLine->sampleTimes[frame + 1] - timeLine->sampleTimes[frame] );
+}
+
+static ksNanoseconds GetFrameTime( const int frameIndex )
+{
+	return (ksNanoseconds)frameIndex * 1000 * 1000 * 1000 / FRAME_RATE;
+}
+
+// Looks up a sequence of frames with both searches and returns the number of lookups that differ.
+static int VerifyFrames( ksGltfScene * scene, ksGltfTimeLineFrameState * referenceState, const int firstFrame, const int frameCount )
+{
+	int differences = 0;
+	for ( int frameIndex = firstFrame; frameIndex < firstFrame + frameCount; frameIndex++ )
+	{
+		for ( int timeLineIndex = 0; timeLineIndex < scene->timeLineCount; timeLineIndex++ )
+		{
+			const ksGltfTimeLine * timeLine = &scene->timeLines[timeLineIndex];
+			ksGltf_UpdateTimeLineFrameState( scene, timeLine, GetFrameTime( frameIndex ) );
+			UpdateTimeLineFrameStateReference( &referenceState[timeLineIndex], timeLine, GetFrameTime( frameIndex ) );
+
+			differences += ( scene->state.timeLineFrameState[timeLineIndex].frame != referenceState[timeLineIndex].frame ||
+							scene->state.timeLineFrameState[timeLineIndex].fraction != referenceState[timeLineIndex].fraction );
+		}
+	}
+	return differences;
+}
+
+int main( int argc, char * argv[] )
+{
+	int timeLineCount = 64;
+	int sampleCount = 65536;
+	int frameCount = 16384;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char * arg = argv[i];
+		if ( arg[0] == '-' ) { arg++; }
+
+		if ( strcmp( arg, "t" ) == 0 && i + 1 < argc )		{ timeLineCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "s" ) == 0 && i + 1 < argc )	{ sampleCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "f" ) == 0 && i + 1 < argc )	{ frameCount = atoi( argv[++i] ); }
+		else
+		{
+			Print( "Unknown option: %s\n"
+				   "atw_gltf_time_line_bench [options]\n"
+				   "options:\n"
+				   "   -t <n>      number of time lines\n"
+				   "   -s <n>      number of key frames per time line\n"
+				   "   -f <n>      number of frames to time\n",
+				   arg );
+			return 1;
+		}
+	}
+
+	if ( timeLineCount < 1 || sampleCount < 2 || frameCount < 1 )
+	{
+		Error( "Invalid arguments" );
+		return 1;
+	}
+
+	// Set up just enough of a scene for the key frame lookup.
+	ksGltfScene scene;
+	memset( &scene, 0, sizeof( scene ) );
+	scene.timeLineCount = timeLineCount;
+	scene.timeLines = (ksGltfTimeLine *) calloc( timeLineCount, sizeof( ksGltfTimeLine ) );
+	scene.state.timeLineFrameState = (ksGltfTimeLineFrameState *) calloc( timeLineCount, sizeof( ksGltfTimeLineFrameState ) );
+	ksGltfTimeLineFrameState * referenceState = (ksGltfTimeLineFrameState *) calloc( timeLineCount, sizeof( ksGltfTimeLineFrameState ) );
+
+	// Key frames at 1/240 to 3/240 seconds apart, so a 90 Hz frame steps over zero, one or more key frames.
+	uint32_t seed = 12345;
+	for ( int timeLineIndex = 0; timeLineIndex < timeLineCount; timeLineIndex++ )
+	{
+		ksGltfTimeLine * timeLine = &scene.timeLines[timeLineIndex];
+		timeLine->sampleCount = sampleCount;
+		timeLine->sampleTimes = (float *) malloc( sampleCount * sizeof( float ) );
+		timeLine->rcpStep = 0.0f;
+		float time = 0.0f;
+		for ( int sampleIndex = 0; sampleIndex < sampleCount; sampleIndex++ )
+		{
+			timeLine->sampleTimes[sampleIndex] = time;
+			time += ( 1.0f + (float)( Random( &seed ) % 1024 ) / 512.0f ) / ( 2 * KEY_FRAME_RATE );
+		}
+		timeLine->duration = timeLine->sampleTimes[sampleCount - 1];
+	}
+
+	int failures = 0;
+
+	// Play forward past the end of the shortest time line so every time line loops at least once.
+	{
+		const float duration = scene.timeLines[0].duration;
+		const int loopFrameCount = (int)( duration * FRAME_RATE ) + FRAME_RATE;
+		const int differences = VerifyFrames( &scene, referenceState, 0, loopFrameCount );
+		if ( differences != 0 )
+		{
+			Print( "playback: %d lookups differ from the binary search\n", differences );
+			failures++;
+		}
+	}
+
+	// Seek forward and backward by random amounts, and play a few frames after every seek.
+	{
+		int differences = 0;
+		int frameIndex = 0;
+		for ( int seekIndex = 0; seekIndex < 1024; seekIndex++ )
+		{
+			frameIndex += (int)( Random( &seed ) % ( 8 * FRAME_RATE ) ) - 4 * FRAME_RATE;
+			frameIndex = ( frameIndex < 0 ) ? 0 : frameIndex;
+			differences += VerifyFrames( &scene, referenceState, frameIndex, 4 );
+		}
+		if ( differences != 0 )
+		{
+			Print( "seek: %d lookups differ from the binary search\n", differences );
+			failures++;
+		}
+	}
+
+	// Time both searches while playing forward.
+	ksNanoseconds cursorTime = 0;
+	ksNanoseconds referenceTime = 0;
+	{
+		int checksum = 0;
+
+		const ksNanoseconds t0 = GetTimeNanoseconds();
+		for ( int frameIndex = 0; frameIndex < frameCount; frameIndex++ )
+		{
+			for ( int timeLineIndex = 0; timeLineIndex < timeLineCount; timeLineIndex++ )
+			{
+				ksGltf_UpdateTimeLineFrameState( &scene, &scene.timeLines[timeLineIndex], GetFrameTime( frameIndex ) );
+				checksum += scene.state.timeLineFrameState[timeLineIndex].frame;
+			}
+		}
+		const ksNanoseconds t1 = GetTimeNanoseconds();
+		for ( int frameIndex = 0; frameIndex < frameCount; frameIndex++ )
+		{
+			for ( int timeLineIndex = 0; timeLineIndex < timeLineCount; timeLineIndex++ )
+			{
+				UpdateTimeLineFrameStateReference( &referenceState[timeLineIndex], &scene.timeLines[timeLineIndex], GetFrameTime( frameIndex ) );
+				checksum -= referenceState[timeLineIndex].frame;
+			}
+		}
+		const ksNanoseconds t2 = GetTimeNanoseconds();
+
+		cursorTime = t1 - t0;
+		referenceTime = t2 - t1;
+
+		if ( checksum != 0 )
+		{
+			Print( "timing: the searches found different key frames\n" );
+			failures++;
+		}
+	}
+
+	const double lookupCount = (double)frameCount * timeLineCount;
+	Print( "%d time lines x %d key frames, %d frames\n", timeLineCount, sampleCount, frameCount );
+	Print( "%-14s %10s %14s\n", "search", "total ms", "ns per lookup" );
+	Print( "%-14s %10.3f %14.1f\n", "cursor", cursorTime * 1e-6, cursorTime / lookupCount );
+	Print( "%-14s %10.3f %14.1f\n", "binary search", referenceTime * 1e-6, referenceTime / lookupCount );
+
+	for ( int timeLineIndex = 0; timeLineIndex < timeLineCount; timeLineIndex++ )
+	{
+		free( scene.timeLines[timeLineIndex].sampleTimes );
+	}
+	free( referenceState );
+	free( scene.state.timeLineFrameState );
+	free( scene.timeLines );
+
+	Print( "%d key frame lookups differ from the binary search\n", failures );
+
+	return ( failures == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,499 @@
+/*
+================================================================================================
+
+Description	:	Unit tests for the descriptor set cache of the Vulkan GPU layer.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+
+DESCRIPTION
+===========
+
+Drives the descriptor set cache from atw_vulkan.c with fake descriptor pools and sets.
+The bound resources are never dereferenced by the cache, so they are plain pointer values
+that can be chosen to make the descriptor hashes collide. The fake driver checks that a
+pool never hands out more sets than it was created with.
+
+The test fails when:
+	- the same layout and resources do not return the same cached descriptor set,
+	- different layouts or resources with the same hash share a descriptor set,
+	- resources are recycled before they were unused for 16 frames or not recycled after,
+	- a recycled descriptor set is not updated or is reused for a different set layout,
+	- a new pool is not created when the current pools run out of sets or descriptors,
+	- a cleared cache creates new pools instead of reusing the pools it has,
+	- pools are not reset on a clear or not destroyed with the cache.
+
+================================================================================================
+*/
+
+#include "vk_mock.h"
+
+/*
+================================================================================================================================
+
+Program parms.
+
+The subset of the program parm layout and state from atw_vulkan.c that the cache looks at.
+
+================================================================================================================================
+*/
+
+#define MAX_PROGRAM_PARMS	16
+
+typedef enum
+{
+	KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED,
+	KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_STORAGE,
+	KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM,
+	KS_GPU_PROGRAM_PARM_TYPE_BUFFER_STORAGE,
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT
+} ksGpuProgramParmType;
+
+typedef struct
+{
+	ksGpuProgramParmType		type;
+	int							index;
+	int							binding;
+} ksGpuProgramParm;
+
+typedef struct
+{
+	VkDescriptorSetLayout		descriptorSetLayout;
+	const ksGpuProgramParm *	bindings[MAX_PROGRAM_PARMS];
+	int							numBindings;
+	unsigned int				hash;
+} ksGpuProgramParmLayout;
+
+typedef struct
+{
+	const void *	parms[MAX_PROGRAM_PARMS];
+} ksGpuProgramParmState;
+
+static bool ksGpuProgramParm_IsOpaqueBinding( const ksGpuProgramParmType type )
+{
+	return ( type <= KS_GPU_PROGRAM_PARM_TYPE_BUFFER_STORAGE );
+}
+
+static bool ksGpuProgramParmState_DescriptorsMatch( const ksGpuProgramParmLayout * layout1, const ksGpuProgramParmState * parmState1,
+													const ksGpuProgramParmLayout * layout2, const ksGpuProgramParmState * parmState2 )
+{
+	if ( layout1 == NULL || layout2 == NULL )
+	{
+		return false;
+	}
+	if ( layout1->hash != layout2->hash )
+	{
+		return false;
+	}
+	for ( int i = 0; i < layout1->numBindings; i++ )
+	{
+		if ( parmState1->parms[layout1->bindings[i]->index] != parmState2->parms[layout2->bindings[i]->index] )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+#include "../gpu/gpu_descriptor_set_cache.h"
+
+#define MAX_FAKE_POOLS		64
+
+/*
+================================================================================================================================
+
+Fake driver.
+
+================================================================================================================================
+*/
+
+typedef struct
+{
+	int		createdPools;
+	int		destroyedPools;
+	int		resetPools;
+	int		allocatedSets;
+	int		updatedSets;
+	int		poolSetCount[MAX_FAKE_POOLS];		// sets allocated from each pool since it was created or reset
+	int		poolMaxSets[MAX_FAKE_POOLS];
+	bool	overflow;							// a pool handed out more sets than it was created with
+} ksFakeDriver;
+
+// Pool handles are 1 + the index of the pool, set handles hold the pool handle in the high bits.
+static VkDescriptorPool ksFakeDriver_CreatePool( void * userData, const int maxSets, const int maxDescriptorsPerType )
+{
+	UNUSED_PARM( maxDescriptorsPerType );
+	ksFakeDriver * driver = (ksFakeDriver *)userData;
+	assert( driver->createdPools < MAX_FAKE_POOLS );
+	driver->poolSetCount[driver->createdPools] = 0;
+	driver->poolMaxSets[driver->createdPools] = maxSets;
+	return (VkDescriptorPool)( ++driver->createdPools );
+}
+
+static void ksFakeDriver_DestroyPool( void * userData, VkDescriptorPool pool )
+{
+	UNUSED_PARM( pool );
+	ksFakeDriver * driver = (ksFakeDriver *)userData;
+	driver->destroyedPools++;
+}
+
+static void ksFakeDriver_ResetPool( void * userData, VkDescriptorPool pool )
+{
+	ksFakeDriver * driver = (ksFakeDriver *)userData;
+	driver->poolSetCount[pool - 1] = 0;
+	driver->resetPools++;
+}
+
+static VkDescriptorSet ksFakeDriver_AllocateSet( void * userData, VkDescriptorPool pool, VkDescriptorSetLayout descriptorSetLayout )
+{
+	UNUSED_PARM( descriptorSetLayout );
+	ksFakeDriver * driver = (ksFakeDriver *)userData;
+	if ( ++driver->poolSetCount[pool - 1] > driver->poolMaxSets[pool - 1] )
+	{
+		driver->overflow = true;
+	}
+	driver->allocatedSets++;
+	return ( (VkDescriptorSet)pool << 32 ) | (VkDescriptorSet)driver->poolSetCount[pool - 1];
+}
+
+static void ksFakeDriver_UpdateSet( void * userData, VkDescriptorSet descriptorSet,
+									const ksGpuProgramParmLayout * parmLayout, const ksGpuProgramParmState * parms )
+{
+	UNUSED_PARM( descriptorSet );
+	UNUSED_PARM( parmLayout );
+	UNUSED_PARM( parms );
+	ksFakeDriver * driver = (ksFakeDriver *)userData;
+	driver->updatedSets++;
+}
+
+static void ksFakeDriver_CreateCache( ksGpuDescriptorSetCache * cache, ksFakeDriver * driver )
+{
+	memset( driver, 0, sizeof( ksFakeDriver ) );
+
+	ksGpuDescriptorSetCallbacks callbacks;
+	callbacks.userData = driver;
+	callbacks.createPool = ksFakeDriver_CreatePool;
+	callbacks.destroyPool = ksFakeDriver_DestroyPool;
+	callbacks.resetPool = ksFakeDriver_ResetPool;
+	callbacks.allocateSet = ksFakeDriver_AllocateSet;
+	callbacks.updateSet = ksFakeDriver_UpdateSet;
+
+	ksGpuDescriptorSetCache_Create( cache, &callbacks );
+}
+
+/*
+================================================================================================================================
+
+Helpers.
+
+================================================================================================================================
+*/
+
+// Creates a layout with 'count' bindings of the given type at parm indices 0 to count - 1.
+static void CreateLayout( ksGpuProgramParmLayout * layout, ksGpuProgramParm * parms, const int count, const ksGpuProgramParmType type,
+							const VkDescriptorSetLayout descriptorSetLayout, const unsigned int hash )
+{
+	memset( layout, 0, sizeof( ksGpuProgramParmLayout ) );
+	for ( int i = 0; i < count; i++ )
+	{
+		parms[i].type = type;
+		parms[i].index = i;
+		parms[i].binding = i;
+		layout->bindings[i] = &parms[i];
+	}
+	layout->numBindings = count;
+	layout->descriptorSetLayout = descriptorSetLayout;
+	layout->hash = hash;
+}
+
+// Binds fake resource pointers that are never dereferenced.
+static void SetParms( ksGpuProgramParmState * state, const int count, const uint64_t first )
+{
+	memset( state, 0, sizeof( ksGpuProgramParmState ) );
+	for ( int i = 0; i < count; i++ )
+	{
+		state->parms[i] = (const void *)(uintptr_t)( first + i * 64 );
+	}
+}
+
+/*
+================================================================================================================================
+
+Tests.
+
+================================================================================================================================
+*/
+
+// The same layout and resources return the same descriptor set without calling the driver.
+static int TestHit()
+{
+	const char * test = "hit";
+	int failures = 0;
+
+	ksFakeDriver driver;
+	ksGpuDescriptorSetCache cache;
+	ksFakeDriver_CreateCache( &cache, &driver );
+
+	ksGpuProgramParm parms[2];
+	ksGpuProgramParmLayout layout;
+	CreateLayout( &layout, parms, 2, KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM, 1, 0x1234 );
+
+	ksGpuProgramParmState state;
+	SetParms( &state, 2, 0x10000 );
+
+	ksGpuPipelineResources * first = ksGpuDescriptorSetCache_Get( &cache, &layout, &state );
+	ksGpuPipelineResources * second = ksGpuDescriptorSetCache_Get( &cache, &layout, &state );
+	failures += !Expect( first == second, test, "the same resources returned different descriptor sets" );
+	failures += !Expect( cache.hitCount == 1 && cache.missCount == 1, test, "the hit and miss counts are wrong" );
+	failures += !Expect( driver.allocatedSets == 1 && driver.updatedSets == 1, test, "a cache hit allocated or updated a descriptor set" );
+
+	ksGpuDescriptorSetCache_Destroy( &cache );
+	failures += !Expect( driver.destroyedPools == driver.createdPools, test, "not all pools were destroyed" );
+
+	return failures;
+}
+
+// Different layouts or resources never share a descriptor set, not even when their hashes collide.
+static int TestCollisions()
+{
+	const char * test = "collisions";
+	int failures = 0;
+
+	ksFakeDriver driver;
+	ksGpuDescriptorSetCache cache;
+	ksFakeDriver_CreateCache( &cache, &driver );
+
+	ksGpuProgramParm parms[1];
+	ksGpuProgramParmLayout layout;
+	CreateLayout( &layout, parms, 1, KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED, 1, 0x1234 );
+
+	// The hash folds the high half of a pointer into the low half, so these two pointers have the same hash.
+	const uint64_t pointer = 0x5670;
+	const uint64_t collidingPointer = ( 1ULL << 32 ) | ( pointer ^ 1 );
+	ksGpuProgramParmState state1;
+	ksGpuProgramParmState state2;
+	SetParms( &state1, 1, pointer );
+	SetParms( &state2, 1, collidingPointer );
+	failures += !Expect( ksGpuProgramParmState_DescriptorHash( &layout, &state1 ) == ksGpuProgramParmState_DescriptorHash( &layout, &state2 ),
+							test, "the colliding pointers have different hashes" );
+
+	ksGpuPipelineResources * r1 = ksGpuDescriptorSetCache_Get( &cache, &layout, &state1 );
+	ksGpuPipelineResources * r2 = ksGpuDescriptorSetCache_Get( &cache, &layout, &state2 );
+	failures += !Expect( r1 != r2 && r1->descriptorSet != r2->descriptorSet, test, "resources with the same hash share a descriptor set" );
+	failures += !Expect( ksGpuDescriptorSetCache_Get( &cache, &layout, &state1 ) == r1 &&
+							ksGpuDescriptorSetCache_Get( &cache, &layout, &state2 ) == r2, test, "colliding resources are not found again" );
+
+	// A different layout with the same resources gets its own descriptor set.
+	ksGpuProgramParm otherParms[1];
+	ksGpuProgramParmLayout otherLayout;
+	CreateLayout( &otherLayout, otherParms, 1, KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED, 2, 0x5678 );
+	ksGpuPipelineResources * r3 = ksGpuDescriptorSetCache_Get( &cache, &otherLayout, &state1 );
+	failures += !Expect( r3 != r1 && r3->descriptorSetLayout == 2, test, "a different layout shares a descriptor set" );
+
+	// Many resources grow the hash table and can all be found again.
+	const int count = 1000;
+	ksGpuPipelineResources ** resources = (ksGpuPipelineResources **) malloc( count * sizeof( ksGpuPipelineResources * ) );
+	for ( int i = 0; i < count; i++ )
+	{
+		ksGpuProgramParmState state;
+		SetParms( &state, 1, 0x100000 + (uint64_t)i * 256 );
+		resources[i] = ksGpuDescriptorSetCache_Get( &cache, &layout, &state );
+	}
+	const int missCount = cache.missCount;
+	for ( int i = 0; i < count; i++ )
+	{
+		ksGpuProgramParmState state;
+		SetParms( &state, 1, 0x100000 + (uint64_t)i * 256 );
+		failures += !Expect( ksGpuDescriptorSetCache_Get( &cache, &layout, &state ) == resources[i], test, "resources are lost when the table grows" );
+	}
+	failures += !Expect( cache.missCount == missCount, test, "finding resources again missed the cache" );
+	failures += !Expect( cache.count == count + 3 && cache.tableSize >= cache.count, test, "the table did not grow with the number of resources" );
+	free( resources );
+
+	ksGpuDescriptorSetCache_Destroy( &cache );
+
+	return failures;
+}
+
+// Resources are recycled after they were not used for 16 frames, and only for the same descriptor set layout.
+static int TestRecycle()
+{
+	const char * test = "recycle";
+	int failures = 0;
+
+	const int maxUnusedCount = 16;
+
+	ksFakeDriver driver;
+	ksGpuDescriptorSetCache cache;
+	ksFakeDriver_CreateCache( &cache, &driver );
+
+	ksGpuProgramParm parms[1];
+	ksGpuProgramParmLayout layout;
+	CreateLayout( &layout, parms, 1, KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM, 1, 0x1234 );
+
+	ksGpuProgramParmState usedState;
+	ksGpuProgramParmState unusedState;
+	SetParms( &usedState, 1, 0x10000 );
+	SetParms( &unusedState, 1, 0x20000 );
+
+	ksGpuPipelineResources * used = ksGpuDescriptorSetCache_Get( &cache, &layout, &usedState );
+	ksGpuPipelineResources * unused = ksGpuDescriptorSetCache_Get( &cache, &layout, &unusedState );
+	const VkDescriptorSet unusedSet = unused->descriptorSet;
+
+	for ( int frame = 1; frame <= maxUnusedCount; frame++ )
+	{
+		ksGpuDescriptorSetCache_RemoveUnused( &cache, maxUnusedCount );
+		ksGpuDescriptorSetCache_Get( &cache, &layout, &usedState );
+	}
+	failures += !Expect( cache.count == 2 && cache.freeResources == NULL, test, "resources were recycled before they were unused for 16 frames" );
+
+	ksGpuDescriptorSetCache_RemoveUnused( &cache, maxUnusedCount );
+	failures += !Expect( cache.count == 1 && cache.freeResources == unused, test, "resources were not recycled after they were unused for 16 frames" );
+	failures += !Expect( ksGpuDescriptorSetCache_Get( &cache, &layout, &usedState ) == used, test, "resources that are used every frame were recycled" );
+
+	// A different descriptor set layout does not take the recycled descriptor set.
+	ksGpuProgramParm otherParms[1];
+	ksGpuProgramParmLayout otherLayout;
+	CreateLayout( &otherLayout, otherParms, 1, KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM, 2, 0x5678 );
+	ksGpuProgramParmState newState;
+	SetParms( &newState, 1, 0x30000 );
+	const int allocatedSets = driver.allocatedSets;
+	ksGpuPipelineResources * other = ksGpuDescriptorSetCache_Get( &cache, &otherLayout, &newState );
+	failures += !Expect( other != unused && driver.allocatedSets == allocatedSets + 1, test, "a descriptor set was recycled for a different set layout" );
+
+	// The same descriptor set layout does, and the recycled descriptor set is updated.
+	const int updatedSets = driver.updatedSets;
+	ksGpuPipelineResources * recycled = ksGpuDescriptorSetCache_Get( &cache, &layout, &newState );
+	failures += !Expect( recycled == unused && recycled->descriptorSet == unusedSet, test, "the unused descriptor set was not recycled" );
+	failures += !Expect( cache.recycleCount == 1 && driver.allocatedSets == allocatedSets + 1, test, "recycling allocated a descriptor set" );
+	failures += !Expect( driver.updatedSets == updatedSets + 1, test, "the recycled descriptor set was not updated" );
+	failures += !Expect( cache.freeResources == NULL, test, "recycled resources are still on the free list" );
+
+	// The old resources are gone.
+	const int missCount = cache.missCount;
+	ksGpuDescriptorSetCache_Get( &cache, &layout, &unusedState );
+	failures += !Expect( cache.missCount == missCount + 1, test, "recycled resources are still found with their old resources" );
+
+	ksGpuDescriptorSetCache_Destroy( &cache );
+
+	return failures;
+}
+
+// A new pool is created when the pools run out of sets or descriptors, and a cleared cache reuses its pools.
+static int TestPoolGrowth()
+{
+	const char * test = "pool growth";
+	int failures = 0;
+
+	ksFakeDriver driver;
+	ksGpuDescriptorSetCache cache;
+	ksFakeDriver_CreateCache( &cache, &driver );
+
+	// One descriptor per set, so a pool runs out of sets first.
+	ksGpuProgramParm parms[MAX_PROGRAM_PARMS];
+	ksGpuProgramParmLayout layout;
+	CreateLayout( &layout, parms, 1, KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED, 1, 0x1234 );
+
+	for ( int i = 0; i < DESCRIPTOR_POOL_MAX_SETS; i++ )
+	{
+		ksGpuProgramParmState state;
+		SetParms( &state, 1, 0x100000 + (uint64_t)i * 256 );
+		ksGpuDescriptorSetCache_Get( &cache, &layout, &state );
+	}
+	failures += !Expect( cache.poolCount == 1 && driver.createdPools == 1, test, "a pool was created before the first pool ran out of sets" );
+	{
+		ksGpuProgramParmState state;
+		SetParms( &state, 1, 0x10000000 );
+		ksGpuDescriptorSetCache_Get( &cache, &layout, &state );
+	}
+	failures += !Expect( cache.poolCount == 2 && driver.createdPools == 2, test, "no pool was created when the first pool ran out of sets" );
+
+	// Eight descriptors per set, so a pool runs out of descriptors after DESCRIPTOR_POOL_MAX_DESCRIPTORS / 8 sets.
+	ksGpuDescriptorSetCache_Destroy( &cache );
+	ksFakeDriver_CreateCache( &cache, &driver );
+	const int descriptorsPerSet = 8;
+	const int setsPerPool = DESCRIPTOR_POOL_MAX_DESCRIPTORS / descriptorsPerSet;
+	CreateLayout( &layout, parms, descriptorsPerSet, KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM, 1, 0x1234 );
+
+	const int setCount = 3 * setsPerPool + 1;
+	for ( int i = 0; i < setCount; i++ )
+	{
+		ksGpuProgramParmState state;
+		SetParms( &state, descriptorsPerSet, 0x100000 + (uint64_t)i * 4096 );
+		ksGpuDescriptorSetCache_Get( &cache, &layout, &state );
+	}
+	failures += !Expect( cache.poolCount == 4 && driver.createdPools == 4, test, "pools were not created when they ran out of descriptors" );
+
+	// A cleared cache resets its pools and fills them again before creating new pools.
+	ksGpuDescriptorSetCache_Clear( &cache );
+	failures += !Expect( cache.count == 0 && driver.resetPools == 4, test, "clearing did not free the resources and reset the pools" );
+	for ( int i = 0; i < setCount; i++ )
+	{
+		ksGpuProgramParmState state;
+		SetParms( &state, descriptorsPerSet, 0x100000 + (uint64_t)i * 4096 );
+		ksGpuDescriptorSetCache_Get( &cache, &layout, &state );
+	}
+	failures += !Expect( cache.poolCount == 4 && driver.createdPools == 4, test, "a cleared cache created new pools" );
+	failures += !Expect( !driver.overflow, test, "a pool handed out more sets than it was created with" );
+
+	const int createdPools = driver.createdPools;
+	ksGpuDescriptorSetCache_Destroy( &cache );
+	failures += !Expect( driver.destroyedPools == createdPools, test, "not all pools were destroyed" );
+
+	return failures;
+}
+
+int main( int argc, char * argv[] )
+{
+	UNUSED_PARM( argc );
+	UNUSED_PARM( argv );
+
+	typedef struct
+	{
+		const char *	name;
+		int				(*function)();
+	} ksTest;
+
+	const ksTest tests[] =
+	{
+		{ "hit",			TestHit },
+		{ "collisions",		TestCollisions },
+		{ "recycle",		TestRecycle },
+		{ "pool growth",	TestPoolGrowth }
+	};
+
+	int failures = 0;
+	for ( int i = 0; i < (int)ARRAY_SIZE( tests ); i++ )
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+		const int testFailures = tests[i].function();
+		const ksNanoseconds time = GetTimeNanoseconds() - startTime;
+		Print( "%-12s %s (%1.1f ms)\n", tests[i].name, ( testFailures == 0 ) ? "passed" : "FAILED", time * 1e-6 );
+		failures += testFailures;
+	}
+
+	Print( "%d descriptor set cache checks failed\n", failures );
+
+	return ( failures == 0 ) ? 0 : 1;
+}
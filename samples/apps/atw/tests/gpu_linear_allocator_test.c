@@ -0,0 +1,284 @@
+/*
+================================================================================================
+
+Description	:	Unit tests for the per-frame linear allocator of the Vulkan GPU layer.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+
+DESCRIPTION
+===========
+
+Drives the per-frame linear allocator from atw_vulkan.c the way a command buffer does.
+Every frame maps a number of buffers, and when the mapped memory runs out the remaining
+maps fall back to separate buffers. When the command buffer is reused, the memory grows
+to the size returned by ksGpuLinearAllocator_GetGrowSize and the allocator is reset.
+
+The test fails when:
+	- an allocation is not aligned, does not fit inside the memory or overlaps another allocation,
+	- an allocation fails while there is room or succeeds while there is none,
+	- the required size does not include the allocations that did not fit,
+	- the memory does not grow to fit a frame that did not fit, or grows while everything fit,
+	- a frame that is repeated after the memory has grown still does not fit,
+	- a reset does not make the whole memory available again.
+
+================================================================================================
+*/
+
+#include "vk_mock.h"
+#include "../gpu/gpu_linear_allocator.h"
+
+#define MIN_MEMORY_SIZE				( 256 * 1024 )
+#define RANDOM_FRAME_COUNT			2000
+#define MAX_FRAME_ALLOCATIONS		256
+
+/*
+================================================================================================================================
+
+Tests.
+
+================================================================================================================================
+*/
+
+// Allocations are aligned and packed after each other.
+static int TestAlignment()
+{
+	const char * test = "alignment";
+	int failures = 0;
+
+	ksGpuLinearAllocator allocator;
+	ksGpuLinearAllocator_Init( &allocator, 1024 );
+
+	VkDeviceSize a = ~0ULL, b = ~0ULL, c = ~0ULL, d = ~0ULL;
+	failures += !Expect( ksGpuLinearAllocator_Allocate( &allocator, 100, 256, &a ) && a == 0, test, "the first allocation is not at the start" );
+	failures += !Expect( ksGpuLinearAllocator_Allocate( &allocator, 100, 256, &b ) && b == 256, test, "the second allocation is not aligned after the first" );
+	failures += !Expect( ksGpuLinearAllocator_Allocate( &allocator, 4, 4, &c ) && c == 356, test, "a small alignment added padding" );
+	failures += !Expect( ksGpuLinearAllocator_Allocate( &allocator, 64, 64, &d ) && d == 384, test, "the fourth allocation is not aligned after the third" );
+	failures += !Expect( allocator.offset == 448 && allocator.required == 448, test, "the allocated and required sizes do not match the allocations" );
+
+	return failures;
+}
+
+// An allocation that does not fit fails, but its size is still added to the required size.
+static int TestExhaustion()
+{
+	const char * test = "exhaustion";
+	int failures = 0;
+
+	ksGpuLinearAllocator allocator;
+	ksGpuLinearAllocator_Init( &allocator, 1024 );
+
+	VkDeviceSize a = ~0ULL, b = ~0ULL, c = ~0ULL;
+	failures += !Expect( ksGpuLinearAllocator_Allocate( &allocator, 768, 256, &a ) && a == 0, test, "the first allocation is not at the start" );
+	failures += !Expect( !ksGpuLinearAllocator_Allocate( &allocator, 512, 256, &b ), test, "an allocation past the end succeeded" );
+	failures += !Expect( b == ~0ULL, test, "a failed allocation returned an offset" );
+	failures += !Expect( allocator.offset == 768, test, "a failed allocation changed the allocated size" );
+	failures += !Expect( allocator.required == 768 + 512, test, "a failed allocation is not added to the required size" );
+
+	// A smaller allocation still fits after a failed one.
+	failures += !Expect( ksGpuLinearAllocator_Allocate( &allocator, 256, 256, &c ) && c == 768, test, "an allocation that fits exactly at the end failed" );
+	failures += !Expect( allocator.required == 768 + 512 + 256, test, "the required size does not include all allocations" );
+	failures += !Expect( !ksGpuLinearAllocator_Allocate( &allocator, 1, 1, &c ), test, "an allocation succeeded while the memory is full" );
+
+	// An allocation larger than the memory never fits.
+	ksGpuLinearAllocator_Reset( &allocator );
+	failures += !Expect( !ksGpuLinearAllocator_Allocate( &allocator, 2048, 256, &c ), test, "an allocation larger than the memory succeeded" );
+
+	return failures;
+}
+
+// A reset makes the whole memory available again and forgets the required size.
+static int TestReset()
+{
+	const char * test = "reset";
+	int failures = 0;
+
+	ksGpuLinearAllocator allocator;
+	ksGpuLinearAllocator_Init( &allocator, 1024 );
+
+	VkDeviceSize offset = ~0ULL;
+	ksGpuLinearAllocator_Allocate( &allocator, 1000, 16, &offset );
+	ksGpuLinearAllocator_Allocate( &allocator, 1000, 16, &offset );
+	ksGpuLinearAllocator_Reset( &allocator );
+	failures += !Expect( allocator.offset == 0 && allocator.required == 0, test, "the allocator is not empty after a reset" );
+	failures += !Expect( allocator.size == 1024, test, "a reset changed the size" );
+	failures += !Expect( ksGpuLinearAllocator_Allocate( &allocator, 1024, 256, &offset ) && offset == 0, test, "the whole memory is not available after a reset" );
+
+	return failures;
+}
+
+// The memory only grows when something did not fit, and then to a power of two times the minimum size that fits everything.
+static int TestGrowSize()
+{
+	const char * test = "grow size";
+	int failures = 0;
+
+	ksGpuLinearAllocator allocator;
+	ksGpuLinearAllocator_Init( &allocator, MIN_MEMORY_SIZE );
+
+	VkDeviceSize offset;
+	failures += !Expect( ksGpuLinearAllocator_GetGrowSize( &allocator, MIN_MEMORY_SIZE ) == 0, test, "empty memory wants to grow" );
+	ksGpuLinearAllocator_Allocate( &allocator, MIN_MEMORY_SIZE, 256, &offset );
+	failures += !Expect( ksGpuLinearAllocator_GetGrowSize( &allocator, MIN_MEMORY_SIZE ) == 0, test, "memory that is exactly full wants to grow" );
+	ksGpuLinearAllocator_Allocate( &allocator, 1, 256, &offset );
+	failures += !Expect( ksGpuLinearAllocator_GetGrowSize( &allocator, MIN_MEMORY_SIZE ) == 2 * MIN_MEMORY_SIZE, test, "memory that is one byte short does not double" );
+	ksGpuLinearAllocator_Allocate( &allocator, 3 * MIN_MEMORY_SIZE, 256, &offset );
+	failures += !Expect( ksGpuLinearAllocator_GetGrowSize( &allocator, MIN_MEMORY_SIZE ) == 8 * MIN_MEMORY_SIZE, test, "the grow size is not the next power of two times the minimum size" );
+
+	// Grown memory that is large enough for the frame does not grow again.
+	ksGpuLinearAllocator_Init( &allocator, 8 * MIN_MEMORY_SIZE );
+	ksGpuLinearAllocator_Allocate( &allocator, MIN_MEMORY_SIZE, 256, &offset );
+	ksGpuLinearAllocator_Allocate( &allocator, 1, 256, &offset );
+	ksGpuLinearAllocator_Allocate( &allocator, 3 * MIN_MEMORY_SIZE, 256, &offset );
+	failures += !Expect( ksGpuLinearAllocator_GetGrowSize( &allocator, MIN_MEMORY_SIZE ) == 0, test, "grown memory that fits the frame wants to grow again" );
+
+	return failures;
+}
+
+typedef struct
+{
+	int				count;
+	VkDeviceSize	sizes[MAX_FRAME_ALLOCATIONS];
+	VkDeviceSize	alignments[MAX_FRAME_ALLOCATIONS];
+} ksFakeFrame;
+
+// Mostly uniform buffer sized maps with now and then a large vertex or instance buffer.
+static void ksFakeFrame_Create( ksFakeFrame * frame, uint32_t * seed )
+{
+	frame->count = 1 + Random( seed ) % MAX_FRAME_ALLOCATIONS;
+	for ( int i = 0; i < frame->count; i++ )
+	{
+		frame->sizes[i] = ( Random( seed ) % 16 == 0 ) ? 1 + Random( seed ) % ( 64 * 1024 ) : 1 + Random( seed ) % 1024;
+		frame->alignments[i] = (VkDeviceSize)1 << ( Random( seed ) % 9 );
+	}
+}
+
+// Maps all buffers of a frame and returns the number of maps that did not fit.
+static int RunFrame( ksGpuLinearAllocator * allocator, const ksFakeFrame * frame, const char * test, int * failures )
+{
+	VkDeviceSize end = 0;		// end of the last allocation
+	VkDeviceSize required = 0;
+	int separateCount = 0;
+	for ( int i = 0; i < frame->count; i++ )
+	{
+		const VkDeviceSize size = frame->sizes[i];
+		const VkDeviceSize alignment = frame->alignments[i];
+		required = ( ( required + alignment - 1 ) & ~( alignment - 1 ) ) + size;
+
+		VkDeviceSize offset = ~0ULL;
+		if ( !ksGpuLinearAllocator_Allocate( allocator, size, alignment, &offset ) )
+		{
+			*failures += !Expect( ( ( end + alignment - 1 ) & ~( alignment - 1 ) ) + size > allocator->size, test, "an allocation failed while there is room" );
+			separateCount++;
+			continue;
+		}
+		*failures += !Expect( ( offset & ( alignment - 1 ) ) == 0, test, "an allocation is not aligned" );
+		*failures += !Expect( offset + size <= allocator->size, test, "an allocation does not fit inside the memory" );
+		*failures += !Expect( offset >= end, test, "an allocation overlaps the previous allocation" );
+		end = offset + size;
+	}
+	*failures += !Expect( allocator->required == required, test, "the required size does not include all allocations" );
+	return separateCount;
+}
+
+// Frames of random maps, where the memory grows like ksGpuCommandBuffer_ManageBuffers grows it.
+static int TestRandom()
+{
+	const char * test = "random";
+	int failures = 0;
+
+	ksGpuLinearAllocator allocator;
+	ksGpuLinearAllocator_Init( &allocator, MIN_MEMORY_SIZE );
+
+	int growCount = 0;
+	uint32_t seed = 1;
+	for ( int frameIndex = 0; frameIndex < RANDOM_FRAME_COUNT && failures == 0; frameIndex++ )
+	{
+		ksFakeFrame frame;
+		ksFakeFrame_Create( &frame, &seed );
+
+		const int separateCount = RunFrame( &allocator, &frame, test, &failures );
+		const VkDeviceSize required = allocator.required;
+
+		// Reuse the command buffer.
+		const VkDeviceSize growSize = ksGpuLinearAllocator_GetGrowSize( &allocator, MIN_MEMORY_SIZE );
+		failures += !Expect( ( growSize != 0 ) == ( separateCount != 0 ), test, "the memory grows while everything fit or does not grow while something did not fit" );
+		if ( growSize != 0 )
+		{
+			failures += !Expect( growSize >= required && growSize > allocator.size, test, "the grown memory does not fit the frame" );
+			ksGpuLinearAllocator_Init( &allocator, growSize );
+			growCount++;
+
+			// The same frame fits once the memory has grown.
+			failures += !Expect( RunFrame( &allocator, &frame, test, &failures ) == 0, test, "a repeated frame does not fit after the memory grew" );
+		}
+		ksGpuLinearAllocator_Reset( &allocator );
+		failures += !Expect( allocator.offset == 0 && allocator.required == 0, test, "the allocator is not empty after a reset" );
+
+		// Start over with the minimum size now and then, so the memory runs out more than once.
+		if ( Random( &seed ) % 64 == 0 )
+		{
+			ksGpuLinearAllocator_Init( &allocator, MIN_MEMORY_SIZE );
+		}
+	}
+
+	failures += !Expect( growCount > 0, test, "the memory never ran out" );
+
+	return failures;
+}
+
+int main( int argc, char * argv[] )
+{
+	UNUSED_PARM( argc );
+	UNUSED_PARM( argv );
+
+	typedef struct
+	{
+		const char *	name;
+		int				(*function)();
+	} ksTest;
+
+	const ksTest tests[] =
+	{
+		{ "alignment",		TestAlignment },
+		{ "exhaustion",		TestExhaustion },
+		{ "reset",			TestReset },
+		{ "grow size",		TestGrowSize },
+		{ "random",			TestRandom }
+	};
+
+	int failures = 0;
+	for ( int i = 0; i < (int)ARRAY_SIZE( tests ); i++ )
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+		const int testFailures = tests[i].function();
+		const ksNanoseconds time = GetTimeNanoseconds() - startTime;
+		Print( "%-12s %s (%1.1f ms)\n", tests[i].name, ( testFailures == 0 ) ? "passed" : "FAILED", time * 1e-6 );
+		failures += testFailures;
+	}
+
+	Print( "%d linear allocator checks failed\n", failures );
+
+	return ( failures == 0 ) ? 0 : 1;
+}
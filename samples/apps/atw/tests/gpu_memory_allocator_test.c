@@ -0,0 +1,667 @@
+/*
+================================================================================================
+
+Description	:	Unit tests for the Vulkan device memory sub-allocator.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Drives the device memory allocator from atw_vulkan.c against a fake memory type table
+with a large device local heap and a small host visible heap. The fake device hands out
+plain CPU memory for host visible blocks and refuses allocations that do not fit in the
+heap, so running out of device memory can be tested.
+
+The test fails when:
+	- freeing all allocations does not merge the buddy nodes back into a single free block,
+	- an allocation is not aligned to the requested alignment,
+	- two live allocations overlap,
+	- buffers and images share a block when the bufferImageGranularity requires separate pools,
+	- large images or allocations that do not fit in a block are not dedicated allocations,
+	- running out of heap memory is not reported or the allocator does not recover,
+	- allocations made and freed concurrently from multiple threads overlap,
+	- the statistics do not return to zero when everything is freed.
+
+================================================================================================
+*/
+
+#include "vk_mock.h"
+#include "../gpu/gpu_memory_allocator.h"
+
+#define DEVICE_LOCAL_HEAP_SIZE		( 256 * 1024 * 1024 )		// 32 MB blocks
+#define HOST_VISIBLE_HEAP_SIZE		( 64 * 1024 * 1024 )		// 8 MB blocks
+#define SMALL_HEAP_SIZE				( 8 * 1024 * 1024 )			// 1 MB blocks
+
+#define MEMORY_TYPE_DEVICE_LOCAL	0
+#define MEMORY_TYPE_HOST_VISIBLE	1
+#define MEMORY_TYPE_HOST_CACHED		2
+
+#define MAX_FAKE_BLOCKS				256
+#define MAX_LIVE_ALLOCATIONS		1024
+
+/*
+================================================================================================================================
+
+Fake device.
+
+Device memory is a unique handle. Host visible memory is backed by CPU memory and the
+handle is the address of that memory so the allocations can be written and verified.
+
+================================================================================================================================
+*/
+
+typedef struct
+{
+	VkDeviceMemory	memory;
+	VkDeviceSize	size;
+	uint32_t		heapIndex;
+	void *			data;
+} ksFakeBlock;
+
+typedef struct
+{
+	VkPhysicalDeviceMemoryProperties	memoryProperties;
+	VkDeviceSize						heapUsed[VK_MAX_MEMORY_HEAPS];
+	ksFakeBlock							blocks[MAX_FAKE_BLOCKS];
+	int									blockCount;
+	uint64_t							nextHandle;
+} ksFakeDevice;
+
+static void ksFakeDevice_Create( ksFakeDevice * device, const VkDeviceSize deviceLocalHeapSize, const VkDeviceSize hostVisibleHeapSize )
+{
+	memset( device, 0, sizeof( ksFakeDevice ) );
+
+	VkPhysicalDeviceMemoryProperties * props = &device->memoryProperties;
+	props->memoryHeapCount = 2;
+	props->memoryHeaps[0].size = deviceLocalHeapSize;
+	props->memoryHeaps[0].flags = VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+	props->memoryHeaps[1].size = hostVisibleHeapSize;
+	props->memoryHeaps[1].flags = 0;
+
+	props->memoryTypeCount = 3;
+	props->memoryTypes[MEMORY_TYPE_DEVICE_LOCAL].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+	props->memoryTypes[MEMORY_TYPE_DEVICE_LOCAL].heapIndex = 0;
+	props->memoryTypes[MEMORY_TYPE_HOST_VISIBLE].propertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+	props->memoryTypes[MEMORY_TYPE_HOST_VISIBLE].heapIndex = 1;
+	props->memoryTypes[MEMORY_TYPE_HOST_CACHED].propertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+	props->memoryTypes[MEMORY_TYPE_HOST_CACHED].heapIndex = 1;
+
+	device->nextHandle = 1;
+}
+
+static bool ksFakeDevice_AllocateBlock( void * userData, const uint32_t memoryTypeIndex, const VkDeviceSize size, const bool map,
+										VkDeviceMemory * memory, void ** mapped )
+{
+	ksFakeDevice * device = (ksFakeDevice *)userData;
+	const uint32_t heapIndex = device->memoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+
+	if ( device->heapUsed[heapIndex] + size > device->memoryProperties.memoryHeaps[heapIndex].size || device->blockCount >= MAX_FAKE_BLOCKS )
+	{
+		return false;	// VK_ERROR_OUT_OF_DEVICE_MEMORY
+	}
+
+	ksFakeBlock * block = &device->blocks[device->blockCount++];
+	block->size = size;
+	block->heapIndex = heapIndex;
+	block->data = map ? malloc( size ) : NULL;
+	block->memory = map ? (VkDeviceMemory)(uintptr_t)block->data : ( device->nextHandle++ << 32 );
+	device->heapUsed[heapIndex] += size;
+
+	*memory = block->memory;
+	*mapped = block->data;
+	return true;
+}
+
+static void ksFakeDevice_FreeBlock( void * userData, VkDeviceMemory memory )
+{
+	ksFakeDevice * device = (ksFakeDevice *)userData;
+	for ( int i = 0; i < device->blockCount; i++ )
+	{
+		if ( device->blocks[i].memory == memory )
+		{
+			device->heapUsed[device->blocks[i].heapIndex] -= device->blocks[i].size;
+			free( device->blocks[i].data );
+			device->blocks[i] = device->blocks[--device->blockCount];
+			return;
+		}
+	}
+	assert( false );
+}
+
+static void ksFakeDevice_CreateAllocator( ksFakeDevice * device, ksGpuMemoryAllocator * allocator, const VkDeviceSize bufferImageGranularity )
+{
+	ksGpuMemoryBlockCallbacks callbacks;
+	callbacks.userData = device;
+	callbacks.allocateBlock = ksFakeDevice_AllocateBlock;
+	callbacks.freeBlock = ksFakeDevice_FreeBlock;
+
+	ksGpuMemoryAllocator_Create( allocator, &device->memoryProperties, bufferImageGranularity, &callbacks );
+}
+
+/*
+================================================================================================================================
+
+Helpers.
+
+================================================================================================================================
+*/
+
+static VkMemoryRequirements Requirements( const VkDeviceSize size, const VkDeviceSize alignment, const uint32_t memoryTypeIndex )
+{
+	VkMemoryRequirements requirements;
+	requirements.size = size;
+	requirements.alignment = alignment;
+	requirements.memoryTypeBits = 1 << memoryTypeIndex;
+	return requirements;
+}
+
+static bool Overlap( const ksGpuMemoryAllocation * a, const ksGpuMemoryAllocation * b )
+{
+	return a->memory == b->memory && a->offset < b->offset + b->size && b->offset < a->offset + a->size;
+}
+
+/*
+================================================================================================================================
+
+Tests.
+
+================================================================================================================================
+*/
+
+// Buddy nodes split on allocation and merge back when both buddies are free.
+static int TestSplitMerge()
+{
+	const char * test = "split/merge";
+	int failures = 0;
+
+	ksFakeDevice device;
+	ksFakeDevice_Create( &device, SMALL_HEAP_SIZE, HOST_VISIBLE_HEAP_SIZE );
+	ksGpuMemoryAllocator allocator;
+	ksFakeDevice_CreateAllocator( &device, &allocator, 1 );
+
+	const VkDeviceSize blockSize = allocator.pools[MEMORY_TYPE_DEVICE_LOCAL][0].blockSize;
+	failures += !Expect( blockSize == 1024 * 1024, test, "a 8 MB heap does not use 1 MB blocks" );
+
+	// Two minimum size buddies and the node that holds both.
+	const VkMemoryRequirements minReq = Requirements( 1, 1, MEMORY_TYPE_DEVICE_LOCAL );
+	const VkMemoryRequirements pairReq = Requirements( 2 * KS_GPU_MEMORY_MIN_NODE_SIZE, 1, MEMORY_TYPE_DEVICE_LOCAL );
+	ksGpuMemoryAllocation a, b, c;
+	ksGpuMemoryAllocator_Allocate( &allocator, &a, &minReq, 0, false );
+	ksGpuMemoryAllocator_Allocate( &allocator, &b, &minReq, 0, false );
+	failures += !Expect( a.memory == b.memory && a.size == KS_GPU_MEMORY_MIN_NODE_SIZE && b.size == KS_GPU_MEMORY_MIN_NODE_SIZE, test, "minimum allocations are not minimum nodes in one block" );
+	failures += !Expect( ( a.offset ^ b.offset ) == KS_GPU_MEMORY_MIN_NODE_SIZE, test, "consecutive minimum allocations are not buddies" );
+
+	ksGpuMemoryStats stats;
+	ksGpuMemoryAllocator_GetStats( &allocator, MEMORY_TYPE_DEVICE_LOCAL, &stats );
+	failures += !Expect( stats.largestFreeBytes == blockSize / 2, test, "a split block does not have half the block free" );
+	failures += !Expect( stats.requestedBytes == 2 && stats.reservedBytes == 2 * KS_GPU_MEMORY_MIN_NODE_SIZE, test, "requested or reserved bytes are wrong" );
+
+	ksGpuMemoryAllocator_Free( &allocator, &a );
+	ksGpuMemoryAllocator_Free( &allocator, &b );
+	ksGpuMemoryAllocator_Allocate( &allocator, &c, &pairReq, 0, false );
+	failures += !Expect( c.offset == 0, test, "freed buddies did not merge into the first node" );
+	ksGpuMemoryAllocator_Free( &allocator, &c );
+
+	// Fill the block with allocations of random orders, then free them in random order.
+	ksGpuMemoryAllocation * allocations = (ksGpuMemoryAllocation *) malloc( MAX_LIVE_ALLOCATIONS * sizeof( ksGpuMemoryAllocation ) );
+	int count = 0;
+	uint32_t seed = 1;
+	VkDeviceSize reserved = 0;
+	for ( ; count < MAX_LIVE_ALLOCATIONS; count++ )
+	{
+		const VkDeviceSize size = (VkDeviceSize)KS_GPU_MEMORY_MIN_NODE_SIZE << ( Random( &seed ) % 8 );
+		if ( reserved + size > blockSize )
+		{
+			break;
+		}
+		const VkMemoryRequirements req = Requirements( size, 1, MEMORY_TYPE_DEVICE_LOCAL );
+		ksGpuMemoryAllocator_Allocate( &allocator, &allocations[count], &req, 0, false );
+		reserved += size;
+	}
+
+	ksGpuMemoryAllocator_GetStats( &allocator, MEMORY_TYPE_DEVICE_LOCAL, &stats );
+	failures += !Expect( stats.reservedBytes == reserved, test, "reserved bytes do not add up" );
+	failures += !Expect( stats.blockCount <= 2, test, "allocations that fit in a block spilled into more than two blocks" );
+
+	for ( int i = count - 1; i > 0; i-- )
+	{
+		const int j = Random( &seed ) % ( i + 1 );
+		const ksGpuMemoryAllocation t = allocations[i];
+		allocations[i] = allocations[j];
+		allocations[j] = t;
+	}
+	for ( int i = 0; i < count; i++ )
+	{
+		ksGpuMemoryAllocator_Free( &allocator, &allocations[i] );
+	}
+	free( allocations );
+
+	ksGpuMemoryAllocator_GetStats( &allocator, MEMORY_TYPE_DEVICE_LOCAL, &stats );
+	failures += !Expect( stats.allocationCount == 0 && stats.reservedBytes == 0 && stats.requestedBytes == 0, test, "statistics are not zero after freeing everything" );
+	failures += !Expect( stats.blockCount == 1, test, "the last empty block was released or empty blocks were kept" );
+	failures += !Expect( stats.largestFreeBytes == blockSize, test, "buddy nodes did not merge back into a free block" );
+
+	ksGpuMemoryAllocator_Destroy( &allocator );
+	failures += !Expect( device.blockCount == 0, test, "blocks leaked after destroying the allocator" );
+
+	return failures;
+}
+
+// Random sizes and alignments on a host visible memory type, verifying alignment, mapping and overlap.
+static int TestAlignment()
+{
+	const char * test = "alignment";
+	int failures = 0;
+
+	ksFakeDevice device;
+	ksFakeDevice_Create( &device, DEVICE_LOCAL_HEAP_SIZE, HOST_VISIBLE_HEAP_SIZE );
+	ksGpuMemoryAllocator allocator;
+	ksFakeDevice_CreateAllocator( &device, &allocator, 1 );
+
+	ksGpuMemoryAllocation * allocations = (ksGpuMemoryAllocation *) malloc( MAX_LIVE_ALLOCATIONS * sizeof( ksGpuMemoryAllocation ) );
+	VkDeviceSize * alignments = (VkDeviceSize *) malloc( MAX_LIVE_ALLOCATIONS * sizeof( VkDeviceSize ) );
+	int count = 0;
+	uint32_t seed = 7;
+
+	for ( int iteration = 0; iteration < 20000; iteration++ )
+	{
+		if ( count > 0 && ( count == MAX_LIVE_ALLOCATIONS || Random( &seed ) % 3 == 0 ) )
+		{
+			const int index = Random( &seed ) % count;
+			ksGpuMemoryAllocator_Free( &allocator, &allocations[index] );
+			allocations[index] = allocations[--count];
+			alignments[index] = alignments[count];
+			continue;
+		}
+
+		const VkDeviceSize size = 1 + Random( &seed ) % ( 64 * 1024 );
+		const VkDeviceSize alignment = (VkDeviceSize)1 << ( Random( &seed ) % 17 );
+		const uint32_t memoryTypeIndex = ( Random( &seed ) & 1 ) ? MEMORY_TYPE_HOST_VISIBLE : MEMORY_TYPE_HOST_CACHED;
+		const VkMemoryRequirements req = Requirements( size, alignment, memoryTypeIndex );
+
+		ksGpuMemoryAllocation * allocation = &allocations[count];
+		if ( !ksGpuMemoryAllocator_Allocate( &allocator, allocation, &req, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, false ) )
+		{
+			failures += !Expect( false, test, "allocation failed" );
+			break;
+		}
+		alignments[count] = alignment;
+
+		if ( ( allocation->offset % alignment ) != 0 || allocation->size < size || allocation->memoryTypeIndex != memoryTypeIndex )
+		{
+			Print( "%s: %lld bytes aligned to %lld placed at offset %lld with %lld bytes in memory type %d\n", test,
+					(long long)size, (long long)alignment, (long long)allocation->offset, (long long)allocation->size, allocation->memoryTypeIndex );
+			failures++;
+		}
+		if ( allocation->mapped != (uint8_t *)(uintptr_t)allocation->memory + allocation->offset )
+		{
+			failures += !Expect( false, test, "host visible allocation is not mapped at its offset" );
+		}
+		for ( int i = 0; i < count; i++ )
+		{
+			if ( Overlap( allocation, &allocations[i] ) )
+			{
+				Print( "%s: [%lld, %lld) overlaps [%lld, %lld)\n", test,
+						(long long)allocation->offset, (long long)( allocation->offset + allocation->size ),
+						(long long)allocations[i].offset, (long long)( allocations[i].offset + allocations[i].size ) );
+				failures++;
+			}
+		}
+		count++;
+	}
+
+	for ( int i = 0; i < count; i++ )
+	{
+		ksGpuMemoryAllocator_Free( &allocator, &allocations[i] );
+	}
+	free( alignments );
+	free( allocations );
+
+	for ( uint32_t type = 0; type < device.memoryProperties.memoryTypeCount; type++ )
+	{
+		ksGpuMemoryStats stats;
+		ksGpuMemoryAllocator_GetStats( &allocator, type, &stats );
+		failures += !Expect( stats.allocationCount == 0 && stats.reservedBytes == 0 && stats.blockCount <= 1, test, "statistics are not zero after freeing everything" );
+	}
+
+	ksGpuMemoryAllocator_Destroy( &allocator );
+	failures += !Expect( device.blockCount == 0, test, "blocks leaked after destroying the allocator" );
+
+	return failures;
+}
+
+// Buffers and images only share blocks when the bufferImageGranularity is at most the minimum node size.
+static int TestGranularity()
+{
+	const char * test = "granularity";
+	int failures = 0;
+
+	const VkDeviceSize granularities[] = { 1, KS_GPU_MEMORY_MIN_NODE_SIZE, 1024, 64 * 1024 };
+	for ( int g = 0; g < (int)ARRAY_SIZE( granularities ); g++ )
+	{
+		ksFakeDevice device;
+		ksFakeDevice_Create( &device, DEVICE_LOCAL_HEAP_SIZE, HOST_VISIBLE_HEAP_SIZE );
+		ksGpuMemoryAllocator allocator;
+		ksFakeDevice_CreateAllocator( &device, &allocator, granularities[g] );
+
+		const VkMemoryRequirements bufferReq = Requirements( 1000, 16, MEMORY_TYPE_DEVICE_LOCAL );
+		const VkMemoryRequirements imageReq = Requirements( 4096, 4096, MEMORY_TYPE_DEVICE_LOCAL );
+		ksGpuMemoryAllocation buffer, image;
+		ksGpuMemoryAllocator_Allocate( &allocator, &buffer, &bufferReq, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, false );
+		ksGpuMemoryAllocator_Allocate( &allocator, &image, &imageReq, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, true );
+
+		const bool separate = ( granularities[g] > KS_GPU_MEMORY_MIN_NODE_SIZE );
+		if ( separate != ( buffer.memory != image.memory ) )
+		{
+			Print( "%s: with a granularity of %lld the buffer and image %s\n", test, (long long)granularities[g],
+					separate ? "share a block" : "are in separate blocks" );
+			failures++;
+		}
+		failures += !Expect( !Overlap( &buffer, &image ), test, "buffer and image overlap" );
+
+		ksGpuMemoryAllocator_Free( &allocator, &buffer );
+		ksGpuMemoryAllocator_Free( &allocator, &image );
+		ksGpuMemoryAllocator_Destroy( &allocator );
+	}
+
+	return failures;
+}
+
+// Large images and allocations that do not fit in a block get their own device memory.
+static int TestDedicated()
+{
+	const char * test = "dedicated";
+	int failures = 0;
+
+	ksFakeDevice device;
+	ksFakeDevice_Create( &device, DEVICE_LOCAL_HEAP_SIZE, HOST_VISIBLE_HEAP_SIZE );
+	ksGpuMemoryAllocator allocator;
+	ksFakeDevice_CreateAllocator( &device, &allocator, 1 );
+
+	const VkDeviceSize blockSize = allocator.pools[MEMORY_TYPE_DEVICE_LOCAL][0].blockSize;
+
+	const VkMemoryRequirements smallImageReq = Requirements( KS_GPU_MEMORY_DEDICATED_IMAGE_SIZE / 2, 4096, MEMORY_TYPE_DEVICE_LOCAL );
+	const VkMemoryRequirements largeImageReq = Requirements( KS_GPU_MEMORY_DEDICATED_IMAGE_SIZE, 4096, MEMORY_TYPE_DEVICE_LOCAL );
+	const VkMemoryRequirements largeBufferReq = Requirements( blockSize / 2 + 1, 256, MEMORY_TYPE_DEVICE_LOCAL );
+	const VkMemoryRequirements hugeBufferReq = Requirements( 3 * blockSize, 256, MEMORY_TYPE_DEVICE_LOCAL );
+
+	ksGpuMemoryAllocation smallImage, largeImage, largeBuffer, hugeBuffer;
+	ksGpuMemoryAllocator_Allocate( &allocator, &smallImage, &smallImageReq, 0, true );
+	ksGpuMemoryAllocator_Allocate( &allocator, &largeImage, &largeImageReq, 0, true );
+	ksGpuMemoryAllocator_Allocate( &allocator, &largeBuffer, &largeBufferReq, 0, false );
+	ksGpuMemoryAllocator_Allocate( &allocator, &hugeBuffer, &hugeBufferReq, 0, false );
+
+	failures += !Expect( smallImage.order >= 0, test, "an image smaller than the dedicated size is not sub-allocated" );
+	failures += !Expect( largeImage.order < 0 && largeImage.offset == 0 && largeImage.size == largeImageReq.size, test, "a large image is not dedicated" );
+	failures += !Expect( largeBuffer.order < 0 && largeBuffer.offset == 0, test, "a buffer larger than half a block is not dedicated" );
+	failures += !Expect( hugeBuffer.order < 0 && hugeBuffer.size == hugeBufferReq.size, test, "a buffer larger than a block is not dedicated" );
+
+	ksGpuMemoryStats stats;
+	ksGpuMemoryAllocator_GetStats( &allocator, MEMORY_TYPE_DEVICE_LOCAL, &stats );
+	failures += !Expect( stats.dedicatedCount == 3 && stats.blockCount == 1, test, "wrong number of dedicated allocations or blocks" );
+	failures += !Expect( stats.dedicatedBytes == largeImageReq.size + largeBufferReq.size + hugeBufferReq.size, test, "dedicated bytes do not add up" );
+
+	ksGpuMemoryAllocator_Free( &allocator, &largeImage );
+	ksGpuMemoryAllocator_Free( &allocator, &largeBuffer );
+	ksGpuMemoryAllocator_Free( &allocator, &hugeBuffer );
+	ksGpuMemoryAllocator_Free( &allocator, &smallImage );
+
+	ksGpuMemoryAllocator_GetStats( &allocator, MEMORY_TYPE_DEVICE_LOCAL, &stats );
+	failures += !Expect( stats.dedicatedCount == 0 && stats.dedicatedBytes == 0, test, "dedicated memory was not released" );
+	failures += !Expect( stats.peakBytes == blockSize + largeImageReq.size + largeBufferReq.size + hugeBufferReq.size, test, "peak bytes are wrong" );
+
+	ksGpuMemoryAllocator_Destroy( &allocator );
+	failures += !Expect( device.blockCount == 0, test, "blocks leaked after destroying the allocator" );
+
+	return failures;
+}
+
+// Running out of heap memory is reported and the allocator recovers once memory is freed.
+static int TestExhaustion()
+{
+	const char * test = "exhaustion";
+	int failures = 0;
+
+	ksFakeDevice device;
+	ksFakeDevice_Create( &device, SMALL_HEAP_SIZE, HOST_VISIBLE_HEAP_SIZE );
+	ksGpuMemoryAllocator allocator;
+	ksFakeDevice_CreateAllocator( &device, &allocator, 1 );
+
+	const VkDeviceSize blockSize = allocator.pools[MEMORY_TYPE_DEVICE_LOCAL][0].blockSize;
+	const int expectedCount = (int)( SMALL_HEAP_SIZE / ( blockSize / 4 ) );
+	const VkMemoryRequirements req = Requirements( blockSize / 4, 256, MEMORY_TYPE_DEVICE_LOCAL );
+
+	ksVkMock_ResetErrorCount();
+
+	ksGpuMemoryAllocation allocations[64];
+	int count = 0;
+	while ( count < (int)ARRAY_SIZE( allocations ) && ksGpuMemoryAllocator_Allocate( &allocator, &allocations[count], &req, 0, false ) )
+	{
+		count++;
+	}
+	failures += !Expect( count == expectedCount, test, "the heap did not fill up with the expected number of allocations" );
+	failures += !Expect( ksVkMock_GetErrorCount() == 1, test, "running out of memory was not reported exactly once" );
+	failures += !Expect( allocations[count].memory == VK_NULL_HANDLE, test, "a failed allocation is not empty" );
+
+	// A dedicated allocation that does not fit in the heap fails as well.
+	const VkMemoryRequirements dedicatedReq = Requirements( SMALL_HEAP_SIZE, 256, MEMORY_TYPE_DEVICE_LOCAL );
+	ksGpuMemoryAllocation dedicated;
+	failures += !Expect( !ksGpuMemoryAllocator_Allocate( &allocator, &dedicated, &dedicatedReq, 0, true ), test, "a dedicated allocation larger than the free heap succeeded" );
+	failures += !Expect( ksVkMock_GetErrorCount() == 2, test, "a failed dedicated allocation was not reported" );
+
+	// Free a single allocation and the space is reused without a new block.
+	ksGpuMemoryAllocator_Free( &allocator, &allocations[count / 2] );
+	failures += !Expect( ksGpuMemoryAllocator_Allocate( &allocator, &allocations[count / 2], &req, 0, false ), test, "freed space was not reused" );
+
+	for ( int i = 0; i < count; i++ )
+	{
+		ksGpuMemoryAllocator_Free( &allocator, &allocations[i] );
+	}
+	failures += !Expect( device.heapUsed[0] == blockSize, test, "empty blocks were not returned to the heap" );
+
+	// Once the blocks are released, the heap can be used for a dedicated allocation.
+	const VkMemoryRequirements halfHeapReq = Requirements( SMALL_HEAP_SIZE / 2, 256, MEMORY_TYPE_DEVICE_LOCAL );
+	failures += !Expect( ksGpuMemoryAllocator_Allocate( &allocator, &dedicated, &halfHeapReq, 0, true ), test, "the allocator did not recover" );
+	ksGpuMemoryAllocator_Free( &allocator, &dedicated );
+
+	// Asking for a memory type that does not exist is reported.
+	const uint32_t typeIndex = ksGpuMemoryAllocator_GetMemoryTypeIndex( &allocator, 1 << MEMORY_TYPE_DEVICE_LOCAL, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT );
+	failures += !Expect( typeIndex == 0 && ksVkMock_GetErrorCount() == 3, test, "a missing memory type was not reported" );
+
+	ksGpuMemoryAllocator_Destroy( &allocator );
+	failures += !Expect( device.blockCount == 0, test, "blocks leaked after destroying the allocator" );
+
+	return failures;
+}
+
+/*
+================================================================================================================================
+
+Multi-threaded test.
+
+Every job allocates and frees host visible memory and fills each allocation with a pattern
+unique to the job and allocation. A pattern that changed before the memory is freed means
+another job was handed overlapping memory.
+
+================================================================================================================================
+*/
+
+#define THREAD_JOB_COUNT				8
+#define THREAD_JOB_ITERATIONS			4000
+#define THREAD_JOB_LIVE_ALLOCATIONS		64
+
+typedef struct
+{
+	ksGpuMemoryAllocator *	allocator;
+	int						jobIndex;
+	int						failures;
+} ksAllocatorJob;
+
+static uint32_t Pattern( const ksAllocatorJob * job, const int slot )
+{
+	return ( (uint32_t)job->jobIndex << 24 ) | ( (uint32_t)slot << 16 ) | 0xA5A5;
+}
+
+static bool CheckPattern( const ksGpuMemoryAllocation * allocation, const uint32_t pattern )
+{
+	const uint32_t * words = (const uint32_t *)allocation->mapped;
+	for ( VkDeviceSize i = 0; i < allocation->requestedSize / sizeof( uint32_t ); i++ )
+	{
+		if ( words[i] != pattern )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static void AllocatorJobThread( void * data )
+{
+	ksAllocatorJob * job = (ksAllocatorJob *)data;
+
+	ksGpuMemoryAllocation allocations[THREAD_JOB_LIVE_ALLOCATIONS];
+	memset( allocations, 0, sizeof( allocations ) );
+	uint32_t seed = 1234 + job->jobIndex;
+
+	for ( int iteration = 0; iteration < THREAD_JOB_ITERATIONS; iteration++ )
+	{
+		const int slot = Random( &seed ) % THREAD_JOB_LIVE_ALLOCATIONS;
+		ksGpuMemoryAllocation * allocation = &allocations[slot];
+		if ( allocation->memory != VK_NULL_HANDLE )
+		{
+			if ( !CheckPattern( allocation, Pattern( job, slot ) ) )
+			{
+				job->failures++;
+			}
+			ksGpuMemoryAllocator_Free( job->allocator, allocation );
+			continue;
+		}
+
+		const VkDeviceSize size = sizeof( uint32_t ) * ( 1 + Random( &seed ) % 4096 );
+		const VkMemoryRequirements req = Requirements( size, 4, MEMORY_TYPE_HOST_VISIBLE );
+		if ( !ksGpuMemoryAllocator_Allocate( job->allocator, allocation, &req, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, false ) )
+		{
+			job->failures++;
+			continue;
+		}
+		const uint32_t pattern = Pattern( job, slot );
+		uint32_t * words = (uint32_t *)allocation->mapped;
+		for ( VkDeviceSize i = 0; i < size / sizeof( uint32_t ); i++ )
+		{
+			words[i] = pattern;
+		}
+	}
+
+	for ( int slot = 0; slot < THREAD_JOB_LIVE_ALLOCATIONS; slot++ )
+	{
+		if ( allocations[slot].memory != VK_NULL_HANDLE )
+		{
+			if ( !CheckPattern( &allocations[slot], Pattern( job, slot ) ) )
+			{
+				job->failures++;
+			}
+			ksGpuMemoryAllocator_Free( job->allocator, &allocations[slot] );
+		}
+	}
+}
+
+static int TestThreads()
+{
+	const char * test = "threads";
+	int failures = 0;
+
+	ksFakeDevice device;
+	ksFakeDevice_Create( &device, DEVICE_LOCAL_HEAP_SIZE, HOST_VISIBLE_HEAP_SIZE );
+	ksGpuMemoryAllocator allocator;
+	ksFakeDevice_CreateAllocator( &device, &allocator, 1 );
+
+	ksAllocatorJob jobs[THREAD_JOB_COUNT];
+	ksThreadPool threadPool;
+	ksThreadPool_Create( &threadPool, THREAD_JOB_COUNT );
+	for ( int i = 0; i < THREAD_JOB_COUNT; i++ )
+	{
+		jobs[i].allocator = &allocator;
+		jobs[i].jobIndex = i;
+		jobs[i].failures = 0;
+		ksThreadPool_Submit( &threadPool, AllocatorJobThread, &jobs[i] );
+	}
+	ksThreadPool_Join( &threadPool );
+	ksThreadPool_Destroy( &threadPool );
+
+	for ( int i = 0; i < THREAD_JOB_COUNT; i++ )
+	{
+		if ( jobs[i].failures != 0 )
+		{
+			Print( "%s: job %d found %d overwritten or failed allocations\n", test, i, jobs[i].failures );
+			failures += jobs[i].failures;
+		}
+	}
+
+	ksGpuMemoryStats stats;
+	ksGpuMemoryAllocator_GetStats( &allocator, MEMORY_TYPE_HOST_VISIBLE, &stats );
+	failures += !Expect( stats.allocationCount == 0 && stats.reservedBytes == 0 && stats.requestedBytes == 0, test, "statistics are not zero after freeing everything" );
+	failures += !Expect( stats.blockCount == 1 && stats.largestFreeBytes == allocator.pools[MEMORY_TYPE_HOST_VISIBLE][0].blockSize, test, "blocks did not merge back" );
+
+	ksGpuMemoryAllocator_Destroy( &allocator );
+	failures += !Expect( device.blockCount == 0, test, "blocks leaked after destroying the allocator" );
+
+	return failures;
+}
+
+int main( int argc, char * argv[] )
+{
+	UNUSED_PARM( argc );
+	UNUSED_PARM( argv );
+
+	typedef struct
+	{
+		const char *	name;
+		int				(*function)();
+	} ksTest;
+
+	const ksTest tests[] =
+	{
+		{ "split/merge",	TestSplitMerge },
+		{ "alignment",		TestAlignment },
+		{ "granularity",	TestGranularity },
+		{ "dedicated",		TestDedicated },
+		{ "exhaustion",		TestExhaustion },
+		{ "threads",		TestThreads }
+	};
+
+	int failures = 0;
+	for ( int i = 0; i < (int)ARRAY_SIZE( tests ); i++ )
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+		const int testFailures = tests[i].function();
+		const ksNanoseconds time = GetTimeNanoseconds() - startTime;
+		Print( "%-12s %s (%1.1f ms)\n", tests[i].name, ( testFailures == 0 ) ? "passed" : "FAILED", time * 1e-6 );
+		failures += testFailures;
+	}
+
+	Print( "%d allocator checks failed\n", failures );
+
+	return ( failures == 0 ) ? 0 : 1;
+}
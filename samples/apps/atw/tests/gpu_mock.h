@@ -0,0 +1,1639 @@
+/*
+================================================================================================
+
+Description	:	Headless GPU layer for the scene tests and benchmarks.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+This header provides the subset of the GPU layer from atw_opengl.c that is used by the
+scenes, implemented on top of plain CPU memory. No GPU, window or driver is needed, so
+the scene simulation, culling, draw sorting and command recording can be tested and
+benchmarked on any machine, including continuous integration servers.
+
+The mock presents itself as the OpenGL implementation (GRAPHICS_API_OPENGL) so the
+scenes pick the GLSL code paths. Programs are not compiled. Buffers are plain memory
+that can be mapped and inspected. Submitted graphics and compute commands are not
+executed but they are counted together with the state changes and barriers they would
+cause.
+
+All memory allocations made after including this header are counted as well. This is
+used to verify that the per-frame code paths do not allocate.
+
+Include this header first, then the scene headers:
+
+	#include "gpu_mock.h"
+	#include "../scenes/scene_settings.h"
+	#include "../scenes/scene_view_state.h"
+	#include "../scenes/scene_perf.h"
+	#include "../scenes/scene_gltf.h"
+
+INTERFACE
+=========
+
+ksGpuMockCounters
+
+static void ksGpuMock_ResetCounters();
+static ksGpuMockCounters ksGpuMock_GetCounters();
+static void ksGpuMock_CreateContext( ksGpuContext * context );
+static void ksGpuMock_BeginRenderPass( ksGpuCommandBuffer * commandBuffer );
+static void ksGpuMock_EndRenderPass( ksGpuCommandBuffer * commandBuffer );
+
+================================================================================================
+*/
+
+#if !defined( KSGPU_MOCK_H )
+#define KSGPU_MOCK_H
+
+#if defined( _WIN32 )
+	#define OS_WINDOWS
+#elif defined( __APPLE__ )
+	#define OS_APPLE
+#else
+	#define OS_LINUX
+#endif
+
+#define GRAPHICS_API_OPENGL		1
+
+#if defined( OS_LINUX )
+	#define _GNU_SOURCE						// for pthread_setname_np, pthread_setaffinity_np and strcasecmp
+	#if __STDC_VERSION__ >= 199901L
+	#define _XOPEN_SOURCE 600
+	#else
+	#define _XOPEN_SOURCE 500
+	#endif
+	#if !defined( __USE_UNIX98 )
+		#define __USE_UNIX98	1				// for pthread_mutexattr_settype
+	#endif
+	#include <pthread.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+#include <assert.h>
+#include <string.h>
+#include <errno.h>
+#include <ctype.h>
+
+#include <GL/gl.h>				// only for the enumerants, nothing is called
+#include <GL/glext.h>
+
+#include <utils/sysinfo.h>
+#include <utils/nanoseconds.h>
+#include <utils/threading.h>
+#include <utils/algebra.h>
+
+/*
+================================
+Common defines
+================================
+*/
+
+#define UNUSED_PARM( x )				{ (void)(x); }
+#define ARRAY_SIZE( a )					( sizeof( (a) ) / sizeof( (a)[0] ) )
+#define OFFSETOF_MEMBER( type, member )	(size_t)&((type *)0)->member
+#define SIZEOF_MEMBER( type, member )	sizeof( ((type *)0)->member )
+#define BIT( x )						( 1 << (x) )
+#define ROUNDUP( x, granularity )		( ( (x) + (granularity) - 1 ) & ~( (granularity) - 1 ) )
+#define MAX( x, y )						( ( x > y ) ? ( x ) : ( y ) )
+#define MIN( x, y )						( ( x < y ) ? ( x ) : ( y ) )
+#define CLAMP( x, min, max )			( ( (x) < (min) ) ? (min) : ( ( (x) > (max) ) ? (max) : (x) ) )
+#define STRINGIFY_EXPANDED( a )			#a
+#define STRINGIFY( a )					STRINGIFY_EXPANDED(a)
+
+#define PROGRAM( name )					name##GLSL
+#define GLSL_VERSION					"430"
+#define SPIRV_VERSION					"99"
+#define GLSL_EXTENSIONS					"#extension GL_EXT_shader_io_blocks : enable\n"
+#define ES_HIGHP						""
+
+#if !defined( OUTPUT_PATH )
+	#define OUTPUT_PATH					""
+#endif
+
+/*
+================================================================================================================================
+
+Counters.
+
+Every counter is only ever incremented, possibly from multiple threads.
+
+================================================================================================================================
+*/
+
+typedef struct
+{
+	ksAtomicUint32	allocations;		// malloc, calloc, realloc( NULL, ... ) and aligned allocations
+	ksAtomicUint32	reallocations;		// realloc of an existing block
+	ksAtomicUint32	frees;				// free of a non-NULL pointer
+	ksAtomicUint32	buffersCreated;
+	ksAtomicUint32	texturesCreated;
+	ksAtomicUint32	programsCreated;
+	ksAtomicUint32	pipelinesCreated;
+	ksAtomicUint32	bufferMaps;
+	ksAtomicUint32	bufferCopyBacks;
+	ksAtomicUint32	drawCalls;			// glDrawElements, glDrawElementsInstanced or glMultiDrawElementsIndirect
+	ksAtomicUint32	indirectDraws;		// ksGpuDrawIndirectCommand structures consumed by indirect draw calls
+	ksAtomicUint32	instances;			// total number of drawn instances
+	ksAtomicUint32	programChanges;
+	ksAtomicUint32	pipelineChanges;
+	ksAtomicUint32	computeDispatches;	// glDispatchCompute
+	ksAtomicUint32	bufferBarriers;		// buffer usage changes between compute writes and indirect draws
+} ksGpuMockCounters;
+
+static ksGpuMockCounters gpuMockCounters;
+
+static void ksGpuMock_ResetCounters()
+{
+	memset( &gpuMockCounters, 0, sizeof( gpuMockCounters ) );
+}
+
+static ksGpuMockCounters ksGpuMock_GetCounters()
+{
+	return gpuMockCounters;
+}
+
+static void ksGpuMock_Add( ksAtomicUint32 * counter, const unsigned int value )
+{
+	__sync_add_and_fetch( counter, value );
+}
+
+/*
+================================================================================================================================
+
+Counted memory allocation.
+
+================================================================================================================================
+*/
+
+static void * ksGpuMock_Malloc( size_t size )
+{
+	ksAtomicUint32_Increment( &gpuMockCounters.allocations );
+	return malloc( size );
+}
+
+static void * ksGpuMock_Calloc( size_t count, size_t size )
+{
+	ksAtomicUint32_Increment( &gpuMockCounters.allocations );
+	return calloc( count, size );
+}
+
+static void * ksGpuMock_Realloc( void * ptr, size_t size )
+{
+	ksAtomicUint32_Increment( ( ptr == NULL ) ? &gpuMockCounters.allocations : &gpuMockCounters.reallocations );
+	return realloc( ptr, size );
+}
+
+static void ksGpuMock_Free( void * ptr )
+{
+	if ( ptr != NULL )
+	{
+		ksAtomicUint32_Increment( &gpuMockCounters.frees );
+	}
+	free( ptr );
+}
+
+static void * AllocAlignedMemory( size_t size, size_t alignment )
+{
+	ksAtomicUint32_Increment( &gpuMockCounters.allocations );
+	alignment = ( alignment < sizeof( void * ) ) ? sizeof( void * ) : alignment;
+	void * ptr = NULL;
+	return ( posix_memalign( &ptr, alignment, size ) == 0 ) ? ptr : NULL;
+}
+
+static void FreeAlignedMemory( void * ptr )
+{
+	ksGpuMock_Free( ptr );
+}
+
+#define malloc( size )			ksGpuMock_Malloc( size )
+#define calloc( count, size )	ksGpuMock_Calloc( count, size )
+#define realloc( ptr, size )	ksGpuMock_Realloc( ptr, size )
+#define free( ptr )				ksGpuMock_Free( ptr )
+
+/*
+================================================================================================================================
+
+System level functionality
+
+================================================================================================================================
+*/
+
+static void Print( const char * format, ... )
+{
+	va_list args;
+	va_start( args, format );
+	vprintf( format, args );
+	va_end( args );
+	fflush( stdout );
+}
+
+static void Error( const char * format, ... )
+{
+	va_list args;
+	va_start( args, format );
+	vprintf( format, args );
+	va_end( args );
+	printf( "\n" );
+	fflush( stdout );
+	// Without exiting, the application will likely crash.
+	if ( format != NULL )
+	{
+		exit( 1 );
+	}
+}
+
+typedef uint32_t ksStringHash;
+
+static void ksStringHash_Init( ksStringHash * hash )
+{
+	*hash = 5381;
+}
+
+static void ksStringHash_Update( ksStringHash * hash, const char * string )
+{
+	ksStringHash value = *hash;
+	for ( int i = 0; string[i] != '\0'; i++ )
+	{
+		value = ( ( value << 5 ) - value ) + string[i];
+	}
+	*hash = value;
+}
+
+static int IntegerLog2( int i )
+{
+	int r = 0;
+	int t;
+	t = ( (~( ( i >> 16 ) + ~0U ) ) >> 27 ) & 0x10; r |= t; i >>= t;
+	t = ( (~( ( i >>  8 ) + ~0U ) ) >> 28 ) &  0x8; r |= t; i >>= t;
+	t = ( (~( ( i >>  4 ) + ~0U ) ) >> 29 ) &  0x4; r |= t; i >>= t;
+	t = ( (~( ( i >>  2 ) + ~0U ) ) >> 30 ) &  0x2; r |= t; i >>= t;
+	return ( r | ( i >> 1 ) );
+}
+
+/*
+================================================================================================================================
+
+GPU context, window input and limits.
+
+================================================================================================================================
+*/
+
+typedef enum
+{
+	KS_GPU_SAMPLE_COUNT_1		= 1,
+	KS_GPU_SAMPLE_COUNT_2		= 2,
+	KS_GPU_SAMPLE_COUNT_4		= 4,
+	KS_GPU_SAMPLE_COUNT_8		= 8,
+	KS_GPU_SAMPLE_COUNT_16		= 16,
+	KS_GPU_SAMPLE_COUNT_32		= 32,
+	KS_GPU_SAMPLE_COUNT_64		= 64,
+} ksGpuSampleCount;
+
+typedef struct ksGpuLimits
+{
+	size_t					maxPushConstantsSize;
+	int						maxSamples;
+	bool					drawIndirect;
+} ksGpuLimits;
+
+typedef struct
+{
+	ksGpuLimits				limits;
+} ksGpuContext;
+
+static void ksGpuMock_CreateContext( ksGpuContext * context )
+{
+	context->limits.maxPushConstantsSize = 512;
+	context->limits.maxSamples = 8;
+	context->limits.drawIndirect = true;
+}
+
+static void ksGpuContext_GetLimits( ksGpuContext * context, ksGpuLimits * limits )
+{
+	*limits = context->limits;
+}
+
+static void ksGpuContext_WaitIdle( ksGpuContext * context )
+{
+	UNUSED_PARM( context );
+}
+
+typedef enum
+{
+	KEY_A				= 0x41,
+	KEY_B				= 0x42,
+	KEY_C				= 0x43,
+	KEY_D				= 0x44,
+	KEY_E				= 0x45,
+	KEY_F				= 0x46,
+	KEY_G				= 0x47,
+	KEY_H				= 0x48,
+	KEY_I				= 0x49,
+	KEY_J				= 0x4A,
+	KEY_K				= 0x4B,
+	KEY_L				= 0x4C,
+	KEY_M				= 0x4D,
+	KEY_N				= 0x4E,
+	KEY_O				= 0x4F,
+	KEY_P				= 0x50,
+	KEY_Q				= 0x51,
+	KEY_R				= 0x52,
+	KEY_S				= 0x53,
+	KEY_T				= 0x54,
+	KEY_U				= 0x55,
+	KEY_V				= 0x56,
+	KEY_W				= 0x57,
+	KEY_X				= 0x58,
+	KEY_Y				= 0x59,
+	KEY_Z				= 0x5A,
+	KEY_RETURN			= 0x0D,
+	KEY_TAB				= 0x09,
+	KEY_ESCAPE			= 0x1B,
+	KEY_SHIFT_LEFT		= 0x10,
+	KEY_CTRL_LEFT		= 0x11,
+	KEY_ALT_LEFT		= 0x12,
+	KEY_CURSOR_UP		= 0x26,
+	KEY_CURSOR_DOWN		= 0x28,
+	KEY_CURSOR_LEFT		= 0x25,
+	KEY_CURSOR_RIGHT	= 0x27
+} ksKeyboardKey;
+
+typedef struct
+{
+	bool					keyInput[256];
+	bool					mouseInput[8];
+	int						mouseInputX[8];
+	int						mouseInputY[8];
+} ksGpuWindowInput;
+
+static bool ksGpuWindow_SupportedResolution( const int width, const int height )
+{
+	UNUSED_PARM( width );
+	UNUSED_PARM( height );
+	return true;
+}
+
+static bool ksGpuWindowInput_CheckKeyboardKey( ksGpuWindowInput * input, const ksKeyboardKey key )
+{
+	return ( input->keyInput[key] != false );
+}
+
+/*
+================================================================================================================================
+
+GPU buffer.
+
+================================================================================================================================
+*/
+
+typedef enum
+{
+	KS_GPU_BUFFER_TYPE_VERTEX,
+	KS_GPU_BUFFER_TYPE_INDEX,
+	KS_GPU_BUFFER_TYPE_UNIFORM,
+	KS_GPU_BUFFER_TYPE_STORAGE,
+	KS_GPU_BUFFER_TYPE_INDIRECT
+} ksGpuBufferType;
+
+typedef enum
+{
+	KS_GPU_BUFFER_USAGE_STORAGE,				// written by a compute program
+	KS_GPU_BUFFER_USAGE_INDIRECT				// read by indirect draw calls
+} ksGpuBufferUsage;
+
+typedef struct
+{
+	ksGpuBufferType		type;
+	ksGpuBufferUsage	usage;					// only tracked to validate the barriers
+	size_t				size;
+	void *				data;
+	bool				owner;
+} ksGpuBuffer;
+
+static bool ksGpuBuffer_Create( ksGpuContext * context, ksGpuBuffer * buffer, const ksGpuBufferType type,
+							const size_t dataSize, const void * data, const bool hostVisible )
+{
+	UNUSED_PARM( context );
+	UNUSED_PARM( hostVisible );
+
+	ksAtomicUint32_Increment( &gpuMockCounters.buffersCreated );
+
+	buffer->type = type;
+	buffer->usage = ( type == KS_GPU_BUFFER_TYPE_INDIRECT ) ? KS_GPU_BUFFER_USAGE_INDIRECT : KS_GPU_BUFFER_USAGE_STORAGE;
+	buffer->size = dataSize;
+	buffer->data = calloc( 1, ( dataSize > 0 ) ? dataSize : 1 );
+	buffer->owner = true;
+	if ( data != NULL )
+	{
+		memcpy( buffer->data, data, dataSize );
+	}
+	return true;
+}
+
+static void ksGpuBuffer_Destroy( ksGpuContext * context, ksGpuBuffer * buffer )
+{
+	UNUSED_PARM( context );
+
+	if ( buffer->owner )
+	{
+		free( buffer->data );
+	}
+	memset( buffer, 0, sizeof( ksGpuBuffer ) );
+}
+
+/*
+================================================================================================================================
+
+GPU texture.
+
+================================================================================================================================
+*/
+
+typedef enum
+{
+	KS_GPU_TEXTURE_USAGE_UNDEFINED			= BIT( 0 ),
+	KS_GPU_TEXTURE_USAGE_GENERAL			= BIT( 1 ),
+	KS_GPU_TEXTURE_USAGE_TRANSFER_SRC		= BIT( 2 ),
+	KS_GPU_TEXTURE_USAGE_TRANSFER_DST		= BIT( 3 ),
+	KS_GPU_TEXTURE_USAGE_SAMPLED			= BIT( 4 ),
+	KS_GPU_TEXTURE_USAGE_STORAGE			= BIT( 5 ),
+	KS_GPU_TEXTURE_USAGE_COLOR_ATTACHMENT	= BIT( 6 ),
+	KS_GPU_TEXTURE_USAGE_PRESENTATION		= BIT( 7 )
+} ksGpuTextureUsage;
+
+typedef enum
+{
+	KS_GPU_TEXTURE_WRAP_MODE_REPEAT,
+	KS_GPU_TEXTURE_WRAP_MODE_CLAMP_TO_EDGE,
+	KS_GPU_TEXTURE_WRAP_MODE_CLAMP_TO_BORDER
+} ksGpuTextureWrapMode;
+
+typedef enum
+{
+	KS_GPU_TEXTURE_FILTER_NEAREST,
+	KS_GPU_TEXTURE_FILTER_LINEAR,
+	KS_GPU_TEXTURE_FILTER_BILINEAR
+} ksGpuTextureFilter;
+
+typedef enum
+{
+	KS_GPU_TEXTURE_DEFAULT_CHECKERBOARD,	// 32x32 checkerboard pattern (KS_GPU_TEXTURE_FORMAT_R8G8B8A8_UNORM)
+	KS_GPU_TEXTURE_DEFAULT_PYRAMIDS,		// 32x32 block pattern of pyramids (KS_GPU_TEXTURE_FORMAT_R8G8B8A8_UNORM)
+	KS_GPU_TEXTURE_DEFAULT_CIRCLES			// 32x32 block pattern with circles (KS_GPU_TEXTURE_FORMAT_R8G8B8A8_UNORM)
+} ksGpuTextureDefault;
+
+typedef struct
+{
+	int						width;
+	int						height;
+	int						depth;
+	int						layerCount;
+	int						mipCount;
+	ksGpuSampleCount		sampleCount;
+	ksGpuTextureUsage		usage;
+	ksGpuTextureWrapMode	wrapMode;
+	ksGpuTextureFilter		filter;
+	float					maxAnisotropy;
+} ksGpuTexture;
+
+static bool ksGpuTexture_CreateDefault( ksGpuContext * context, ksGpuTexture * texture, const ksGpuTextureDefault defaultType,
+										const int width, const int height, const int depth,
+										const int layerCount, const int faceCount,
+										const bool mipmaps, const bool border )
+{
+	UNUSED_PARM( context );
+	UNUSED_PARM( defaultType );
+	UNUSED_PARM( faceCount );
+	UNUSED_PARM( border );
+
+	ksAtomicUint32_Increment( &gpuMockCounters.texturesCreated );
+
+	memset( texture, 0, sizeof( ksGpuTexture ) );
+	texture->width = width;
+	texture->height = height;
+	texture->depth = depth;
+	texture->layerCount = layerCount;
+	texture->mipCount = mipmaps ? IntegerLog2( ( width > height ) ? width : height ) + 1 : 1;
+	texture->sampleCount = KS_GPU_SAMPLE_COUNT_1;
+	texture->usage = KS_GPU_TEXTURE_USAGE_SAMPLED;
+	return true;
+}
+
+// Only the KTX header is parsed, the texel data is never touched.
+static bool ksGpuTexture_CreateFromKTX( ksGpuContext * context, ksGpuTexture * texture, const char * fileName,
+									const unsigned char * buffer, const size_t bufferSize )
+{
+	UNUSED_PARM( context );
+
+	static const unsigned char fileIdentifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', '\x1A', '\n' };
+
+	memset( texture, 0, sizeof( ksGpuTexture ) );
+
+	if ( buffer == NULL || bufferSize < 64 || memcmp( buffer, fileIdentifier, sizeof( fileIdentifier ) ) != 0 )
+	{
+		Error( "%s: Invalid KTX file", fileName );
+		return false;
+	}
+
+	ksAtomicUint32_Increment( &gpuMockCounters.texturesCreated );
+
+	const uint32_t * header = (const uint32_t *)( buffer + 12 );
+	texture->width = (int)header[6];
+	texture->height = (int)header[7];
+	texture->depth = (int)header[8];
+	texture->layerCount = (int)header[9];
+	texture->mipCount = ( header[11] > 0 ) ? (int)header[11] : 1;
+	texture->sampleCount = KS_GPU_SAMPLE_COUNT_1;
+	texture->usage = KS_GPU_TEXTURE_USAGE_SAMPLED;
+	return true;
+}
+
+static void ksGpuTexture_Destroy( ksGpuContext * context, ksGpuTexture * texture )
+{
+	UNUSED_PARM( context );
+	memset( texture, 0, sizeof( ksGpuTexture ) );
+}
+
+/*
+================================================================================================================================
+
+GPU indices and vertex attributes.
+
+================================================================================================================================
+*/
+
+typedef unsigned short ksGpuTriangleIndex;
+
+typedef struct
+{
+	const ksGpuBuffer *		buffer;
+	ksGpuTriangleIndex *	indexArray;
+	int						indexCount;
+} ksGpuTriangleIndexArray;
+
+typedef enum
+{
+	KS_GPU_ATTRIBUTE_FORMAT_R32_SFLOAT				= ( 1 << 16 ) | GL_FLOAT,
+	KS_GPU_ATTRIBUTE_FORMAT_R32G32_SFLOAT			= ( 2 << 16 ) | GL_FLOAT,
+	KS_GPU_ATTRIBUTE_FORMAT_R32G32B32_SFLOAT		= ( 3 << 16 ) | GL_FLOAT,
+	KS_GPU_ATTRIBUTE_FORMAT_R32G32B32A32_SFLOAT		= ( 4 << 16 ) | GL_FLOAT
+} ksGpuAttributeFormat;
+
+typedef struct
+{
+	int						attributeFlag;		// VERTEX_ATTRIBUTE_FLAG_
+	size_t					attributeOffset;	// Offset in bytes to the pointer in ksGpuVertexAttributeArrays
+	size_t					attributeSize;		// Size in bytes of a single attribute
+	ksGpuAttributeFormat	attributeFormat;	// Format of the attribute
+	int						locationCount;		// Number of attribute locations
+	const char *			name;				// Name in vertex program
+} ksGpuVertexAttribute;
+
+typedef struct
+{
+	const ksGpuBuffer *				buffer;
+	const ksGpuVertexAttribute *	layout;
+	void *							data;
+	size_t							dataSize;
+	int								vertexCount;
+	int								attribsFlags;
+} ksGpuVertexAttributeArrays;
+
+static void ksGpuTriangleIndexArray_CreateFromBuffer( ksGpuTriangleIndexArray * indices, const int indexCount, const ksGpuBuffer * buffer )
+{
+	indices->indexCount = indexCount;
+	indices->indexArray = NULL;
+	indices->buffer = buffer;
+}
+
+static void ksGpuTriangleIndexArray_Alloc( ksGpuTriangleIndexArray * indices, const int indexCount, const ksGpuTriangleIndex * data )
+{
+	indices->indexCount = indexCount;
+	indices->indexArray = (ksGpuTriangleIndex *) malloc( indexCount * sizeof( ksGpuTriangleIndex ) );
+	if ( data != NULL )
+	{
+		memcpy( indices->indexArray, data, indexCount * sizeof( ksGpuTriangleIndex ) );
+	}
+	indices->buffer = NULL;
+}
+
+static void ksGpuTriangleIndexArray_Free( ksGpuTriangleIndexArray * indices )
+{
+	free( indices->indexArray );
+	memset( indices, 0, sizeof( ksGpuTriangleIndexArray ) );
+}
+
+static size_t ksGpuVertexAttributeArrays_GetDataSize( const ksGpuVertexAttribute * layout, const int vertexCount, const int attribsFlags )
+{
+	size_t totalSize = 0;
+	for ( int i = 0; layout[i].attributeFlag != 0; i++ )
+	{
+		const ksGpuVertexAttribute * v = &layout[i];
+		if ( ( v->attributeFlag & attribsFlags ) != 0 )
+		{
+			totalSize += v->attributeSize;
+		}
+	}
+	return vertexCount * totalSize;
+}
+
+static void ksGpuVertexAttributeArrays_Map( ksGpuVertexAttributeArrays * attribs, void * data, const size_t dataSize, const int vertexCount, const int attribsFlags )
+{
+	unsigned char * dataBytePtr = (unsigned char *) data;
+	size_t offset = 0;
+
+	for ( int i = 0; attribs->layout[i].attributeFlag != 0; i++ )
+	{
+		const ksGpuVertexAttribute * v = &attribs->layout[i];
+		void ** attribPtr = (void **) ( ((char *)attribs) + v->attributeOffset );
+		if ( ( v->attributeFlag & attribsFlags ) != 0 )
+		{
+			*attribPtr = ( dataBytePtr + offset );
+			offset += vertexCount * v->attributeSize;
+		}
+		else
+		{
+			*attribPtr = NULL;
+		}
+	}
+
+	assert( offset == dataSize );
+	UNUSED_PARM( dataSize );
+}
+
+static void ksGpuVertexAttributeArrays_CreateFromBuffer( ksGpuVertexAttributeArrays * attribs, const ksGpuVertexAttribute * layout,
+															const int vertexCount, const int attribsFlags, const ksGpuBuffer * buffer )
+{
+	attribs->buffer = buffer;
+	attribs->layout = layout;
+	attribs->data = NULL;
+	attribs->dataSize = 0;
+	attribs->vertexCount = vertexCount;
+	attribs->attribsFlags = attribsFlags;
+}
+
+static void ksGpuVertexAttributeArrays_Alloc( ksGpuVertexAttributeArrays * attribs, const ksGpuVertexAttribute * layout, const int vertexCount, const int attribsFlags )
+{
+	const size_t dataSize = ksGpuVertexAttributeArrays_GetDataSize( layout, vertexCount, attribsFlags );
+	void * data = malloc( dataSize );
+	attribs->buffer = NULL;
+	attribs->layout = layout;
+	attribs->data = data;
+	attribs->dataSize = dataSize;
+	attribs->vertexCount = vertexCount;
+	attribs->attribsFlags = attribsFlags;
+	ksGpuVertexAttributeArrays_Map( attribs, data, dataSize, vertexCount, attribsFlags );
+}
+
+static void ksGpuVertexAttributeArrays_Free( ksGpuVertexAttributeArrays * attribs )
+{
+	free( attribs->data );
+	memset( attribs, 0, sizeof( ksGpuVertexAttributeArrays ) );
+}
+
+typedef enum
+{
+	VERTEX_ATTRIBUTE_FLAG_POSITION		= BIT( 0 ),		// vec3 vertexPosition
+	VERTEX_ATTRIBUTE_FLAG_NORMAL		= BIT( 1 ),		// vec3 vertexNormal
+	VERTEX_ATTRIBUTE_FLAG_TANGENT		= BIT( 2 ),		// vec3 vertexTangent
+	VERTEX_ATTRIBUTE_FLAG_BINORMAL		= BIT( 3 ),		// vec3 vertexBinormal
+	VERTEX_ATTRIBUTE_FLAG_COLOR			= BIT( 4 ),		// vec4 vertexColor
+	VERTEX_ATTRIBUTE_FLAG_UV0			= BIT( 5 ),		// vec2 vertexUv0
+	VERTEX_ATTRIBUTE_FLAG_UV1			= BIT( 6 ),		// vec2 vertexUv1
+	VERTEX_ATTRIBUTE_FLAG_UV2			= BIT( 7 ),		// vec2 vertexUv2
+	VERTEX_ATTRIBUTE_FLAG_JOINT_INDICES	= BIT( 8 ),		// vec4 jointIndices
+	VERTEX_ATTRIBUTE_FLAG_JOINT_WEIGHTS	= BIT( 9 ),		// vec4 jointWeights
+	VERTEX_ATTRIBUTE_FLAG_TRANSFORM		= BIT( 10 ),	// mat4 vertexTransform (NOTE this mat4 takes up 4 attribute locations)
+	VERTEX_ATTRIBUTE_FLAG_TRANSFORM_INVERSE	= BIT( 11 )	// mat4 vertexTransformInverse (NOTE this mat4 takes up 4 attribute locations)
+} ksDefaultVertexAttributeFlags;
+
+typedef struct
+{
+	ksGpuVertexAttributeArrays	base;
+	ksVector3f *				position;
+	ksVector3f *				normal;
+	ksVector3f *				tangent;
+	ksVector3f *				binormal;
+	ksVector4f *				color;
+	ksVector2f *				uv0;
+	ksVector2f *				uv1;
+	ksVector2f *				uv2;
+	ksVector4f *				jointIndices;
+	ksVector4f *				jointWeights;
+	ksMatrix4x4f *				transform;
+	ksMatrix4x4f *				transformInverse;
+} ksDefaultVertexAttributeArrays;
+
+static const ksGpuVertexAttribute DefaultVertexAttributeLayout[] =
+{
+	{ VERTEX_ATTRIBUTE_FLAG_POSITION,		OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, position ),		SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, position[0] ),		KS_GPU_ATTRIBUTE_FORMAT_R32G32B32_SFLOAT,		1,	"vertexPosition" },
+	{ VERTEX_ATTRIBUTE_FLAG_NORMAL,			OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, normal ),			SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, normal[0] ),			KS_GPU_ATTRIBUTE_FORMAT_R32G32B32_SFLOAT,		1,	"vertexNormal" },
+	{ VERTEX_ATTRIBUTE_FLAG_TANGENT,		OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, tangent ),			SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, tangent[0] ),		KS_GPU_ATTRIBUTE_FORMAT_R32G32B32_SFLOAT,		1,	"vertexTangent" },
+	{ VERTEX_ATTRIBUTE_FLAG_BINORMAL,		OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, binormal ),		SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, binormal[0] ),		KS_GPU_ATTRIBUTE_FORMAT_R32G32B32_SFLOAT,		1,	"vertexBinormal" },
+	{ VERTEX_ATTRIBUTE_FLAG_COLOR,			OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, color ),			SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, color[0] ),			KS_GPU_ATTRIBUTE_FORMAT_R32G32B32A32_SFLOAT,	1,	"vertexColor" },
+	{ VERTEX_ATTRIBUTE_FLAG_UV0,			OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, uv0 ),				SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, uv0[0] ),			KS_GPU_ATTRIBUTE_FORMAT_R32G32_SFLOAT,			1,	"vertexUv0" },
+	{ VERTEX_ATTRIBUTE_FLAG_UV1,			OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, uv1 ),				SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, uv1[0] ),			KS_GPU_ATTRIBUTE_FORMAT_R32G32_SFLOAT,			1,	"vertexUv1" },
+	{ VERTEX_ATTRIBUTE_FLAG_UV2,			OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, uv2 ),				SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, uv2[0] ),			KS_GPU_ATTRIBUTE_FORMAT_R32G32_SFLOAT,			1,	"vertexUv2" },
+	{ VERTEX_ATTRIBUTE_FLAG_JOINT_INDICES,	OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, jointIndices ),	SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, jointIndices[0] ),	KS_GPU_ATTRIBUTE_FORMAT_R32G32B32A32_SFLOAT,	1,	"vertexJointIndices" },
+	{ VERTEX_ATTRIBUTE_FLAG_JOINT_WEIGHTS,	OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, jointWeights ),	SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, jointWeights[0] ),	KS_GPU_ATTRIBUTE_FORMAT_R32G32B32A32_SFLOAT,	1,	"vertexJointWeights" },
+	{ VERTEX_ATTRIBUTE_FLAG_TRANSFORM,		OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, transform ),		SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, transform[0] ),		KS_GPU_ATTRIBUTE_FORMAT_R32G32B32A32_SFLOAT,	4,	"vertexTransform" },
+	{ VERTEX_ATTRIBUTE_FLAG_TRANSFORM_INVERSE,	OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, transformInverse ),	SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, transformInverse[0] ),	KS_GPU_ATTRIBUTE_FORMAT_R32G32B32A32_SFLOAT,	4,	"vertexTransformInverse" },
+	{ 0, 0, 0, 0, 0, "" }
+};
+
+/*
+================================================================================================================================
+
+GPU geometry.
+
+================================================================================================================================
+*/
+
+typedef struct
+{
+	const ksGpuVertexAttribute *	layout;
+	int								vertexAttribsFlags;
+	int								instanceAttribsFlags;
+	int								vertexCount;
+	int								instanceCount;
+	int 							indexCount;
+	ksGpuBuffer						vertexBuffer;
+	ksGpuBuffer						instanceBuffer;
+	ksGpuBuffer						indexBuffer;
+} ksGpuGeometry;
+
+static void ksGpuGeometry_Create( ksGpuContext * context, ksGpuGeometry * geometry,
+								const ksGpuVertexAttributeArrays * attribs,
+								const ksGpuTriangleIndexArray * indices )
+{
+	memset( geometry, 0, sizeof( ksGpuGeometry ) );
+
+	geometry->layout = attribs->layout;
+	geometry->vertexAttribsFlags = attribs->attribsFlags;
+	geometry->vertexCount = attribs->vertexCount;
+	geometry->indexCount = indices->indexCount;
+
+	if ( attribs->buffer != NULL )
+	{
+		geometry->vertexBuffer = *attribs->buffer;
+		geometry->vertexBuffer.owner = false;
+	}
+	else
+	{
+		ksGpuBuffer_Create( context, &geometry->vertexBuffer, KS_GPU_BUFFER_TYPE_VERTEX, attribs->dataSize, attribs->data, false );
+	}
+	if ( indices->buffer != NULL )
+	{
+		geometry->indexBuffer = *indices->buffer;
+		geometry->indexBuffer.owner = false;
+	}
+	else
+	{
+		ksGpuBuffer_Create( context, &geometry->indexBuffer, KS_GPU_BUFFER_TYPE_INDEX, indices->indexCount * sizeof( indices->indexArray[0] ), indices->indexArray, false );
+	}
+}
+
+static void ksGpuGeometry_CreateBox( ksGpuContext * context, ksGpuGeometry * geometry, const int vertexCount, const int indexCount, const float offset, const float scale )
+{
+	ksDefaultVertexAttributeArrays attribs;
+	ksGpuVertexAttributeArrays_Alloc( &attribs.base, DefaultVertexAttributeLayout, vertexCount,
+									VERTEX_ATTRIBUTE_FLAG_POSITION | VERTEX_ATTRIBUTE_FLAG_NORMAL |
+									VERTEX_ATTRIBUTE_FLAG_TANGENT | VERTEX_ATTRIBUTE_FLAG_BINORMAL |
+									VERTEX_ATTRIBUTE_FLAG_UV0 );
+	for ( int i = 0; i < vertexCount; i++ )
+	{
+		attribs.position[i].x = ( ( i & 1 ) ? 1.0f : -1.0f ) * scale + offset;
+		attribs.position[i].y = ( ( i & 2 ) ? 1.0f : -1.0f ) * scale + offset;
+		attribs.position[i].z = ( ( i & 4 ) ? 1.0f : -1.0f ) * scale + offset;
+	}
+
+	ksGpuTriangleIndexArray indices;
+	ksGpuTriangleIndexArray_Alloc( &indices, indexCount, NULL );
+	for ( int i = 0; i < indexCount; i++ )
+	{
+		indices.indexArray[i] = (ksGpuTriangleIndex)( i % vertexCount );
+	}
+
+	ksGpuGeometry_Create( context, geometry, &attribs.base, &indices );
+
+	ksGpuVertexAttributeArrays_Free( &attribs.base );
+	ksGpuTriangleIndexArray_Free( &indices );
+}
+
+static void ksGpuGeometry_CreateCube( ksGpuContext * context, ksGpuGeometry * geometry, const float offset, const float scale )
+{
+	ksGpuGeometry_CreateBox( context, geometry, 24, 36, offset, scale );
+}
+
+static void ksGpuGeometry_CreateTorus( ksGpuContext * context, ksGpuGeometry * geometry, const int tesselation, const float offset, const float scale )
+{
+	ksGpuGeometry_CreateBox( context, geometry, ( tesselation + 1 ) * ( tesselation + 1 ), tesselation * tesselation * 6, offset, scale );
+}
+
+static void ksGpuGeometry_Destroy( ksGpuContext * context, ksGpuGeometry * geometry )
+{
+	ksGpuBuffer_Destroy( context, &geometry->indexBuffer );
+	ksGpuBuffer_Destroy( context, &geometry->vertexBuffer );
+	if ( geometry->instanceBuffer.size != 0 )
+	{
+		ksGpuBuffer_Destroy( context, &geometry->instanceBuffer );
+	}
+
+	memset( geometry, 0, sizeof( ksGpuGeometry ) );
+}
+
+static void ksGpuGeometry_AddInstanceAttributes( ksGpuContext * context, ksGpuGeometry * geometry, const int numInstances, const int instanceAttribsFlags )
+{
+	assert( geometry->layout != NULL );
+	assert( ( geometry->vertexAttribsFlags & instanceAttribsFlags ) == 0 );
+
+	geometry->instanceCount = numInstances;
+	geometry->instanceAttribsFlags = instanceAttribsFlags;
+
+	const size_t dataSize = ksGpuVertexAttributeArrays_GetDataSize( geometry->layout, numInstances, geometry->instanceAttribsFlags );
+
+	ksGpuBuffer_Create( context, &geometry->instanceBuffer, KS_GPU_BUFFER_TYPE_VERTEX, dataSize, NULL, false );
+}
+
+/*
+================================================================================================================================
+
+GPU render pass.
+
+================================================================================================================================
+*/
+
+typedef struct
+{
+	ksGpuSampleCount			sampleCount;
+} ksGpuRenderPass;
+
+/*
+================================================================================================================================
+
+GPU program parms and graphics program.
+
+================================================================================================================================
+*/
+
+#define MAX_PROGRAM_PARMS			16
+
+typedef enum
+{
+	KS_GPU_PROGRAM_STAGE_FLAG_VERTEX		= BIT( 0 ),
+	KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT		= BIT( 1 ),
+	KS_GPU_PROGRAM_STAGE_FLAG_COMPUTE		= BIT( 2 ),
+	KS_GPU_PROGRAM_STAGE_MAX				= 3
+} ksGpuProgramStageFlags;
+
+typedef enum
+{
+	KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED,				// texture plus sampler bound together		(GLSL: sampler*, isampler*, usampler*)
+	KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_STORAGE,				// not sampled, direct read-write storage	(GLSL: image*, iimage*, uimage*)
+	KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM,				// read-only uniform buffer					(GLSL: uniform)
+	KS_GPU_PROGRAM_PARM_TYPE_BUFFER_STORAGE,				// read-write storage buffer				(GLSL: buffer)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT,				// int										(GLSL: int)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT_VECTOR2,		// int[2]									(GLSL: ivec2)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT_VECTOR3,		// int[3]									(GLSL: ivec3)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT_VECTOR4,		// int[4]									(GLSL: ivec4)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT,			// float									(GLSL: float)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_VECTOR2,	// float[2]									(GLSL: vec2)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_VECTOR3,	// float[3]									(GLSL: vec3)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_VECTOR4,	// float[4]									(GLSL: vec4)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX2X2,	// float[2][2]								(GLSL: mat2x2 or mat2)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX2X3,	// float[2][3]								(GLSL: mat2x3)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX2X4,	// float[2][4]								(GLSL: mat2x4)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX3X2,	// float[3][2]								(GLSL: mat3x2)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX3X3,	// float[3][3]								(GLSL: mat3x3 or mat3)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX3X4,	// float[3][4]								(GLSL: mat3x4)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X2,	// float[4][2]								(GLSL: mat4x2)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X3,	// float[4][3]								(GLSL: mat4x3)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X4,	// float[4][4]								(GLSL: mat4x4 or mat4)
+	KS_GPU_PROGRAM_PARM_TYPE_MAX
+} ksGpuProgramParmType;
+
+typedef enum
+{
+	KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,
+	KS_GPU_PROGRAM_PARM_ACCESS_WRITE_ONLY,
+	KS_GPU_PROGRAM_PARM_ACCESS_READ_WRITE
+} ksGpuProgramParmAccess;
+
+typedef struct
+{
+	int							stageFlags;	// vertex, fragment and/or compute
+	ksGpuProgramParmType		type;		// texture, buffer or push constant
+	ksGpuProgramParmAccess		access;		// read and/or write
+	int							index;		// index into ksGpuProgramParmState::parms
+	const char * 				name;		// GLSL name
+	int							binding;	// OpenGL shader bind point
+} ksGpuProgramParm;
+
+typedef struct
+{
+	int							numParms;
+	const ksGpuProgramParm *	parms;
+	int							offsetForIndex[MAX_PROGRAM_PARMS];	// push constant offsets into ksGpuProgramParmState::data based on ksGpuProgramParm::index
+} ksGpuProgramParmLayout;
+
+static bool ksGpuProgramParm_IsOpaqueBinding( const ksGpuProgramParmType type )
+{
+	return	( ( type == KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED ) ?	true :
+			( ( type == KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_STORAGE ) ?	true :
+			( ( type == KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM ) ?		true :
+			( ( type == KS_GPU_PROGRAM_PARM_TYPE_BUFFER_STORAGE ) ?		true :
+																		false ) ) ) );
+}
+
+static int ksGpuProgramParm_GetPushConstantSize( const ksGpuProgramParmType type )
+{
+	static const int parmSize[KS_GPU_PROGRAM_PARM_TYPE_MAX] =
+	{
+		(unsigned int)0,
+		(unsigned int)0,
+		(unsigned int)0,
+		(unsigned int)0,
+		(unsigned int)sizeof( int ),
+		(unsigned int)sizeof( int[2] ),
+		(unsigned int)sizeof( int[3] ),
+		(unsigned int)sizeof( int[4] ),
+		(unsigned int)sizeof( float ),
+		(unsigned int)sizeof( float[2] ),
+		(unsigned int)sizeof( float[3] ),
+		(unsigned int)sizeof( float[4] ),
+		(unsigned int)sizeof( float[2][2] ),
+		(unsigned int)sizeof( float[2][3] ),
+		(unsigned int)sizeof( float[2][4] ),
+		(unsigned int)sizeof( float[3][2] ),
+		(unsigned int)sizeof( float[3][3] ),
+		(unsigned int)sizeof( float[3][4] ),
+		(unsigned int)sizeof( float[4][2] ),
+		(unsigned int)sizeof( float[4][3] ),
+		(unsigned int)sizeof( float[4][4] )
+	};
+	assert( ARRAY_SIZE( parmSize ) == KS_GPU_PROGRAM_PARM_TYPE_MAX );
+	return parmSize[type];
+}
+
+static const char * ksGpuProgramParm_GetPushConstantGlslType( const ksGpuProgramParmType type )
+{
+	static const char * glslType[KS_GPU_PROGRAM_PARM_TYPE_MAX] =
+	{
+		"",
+		"",
+		"",
+		"",
+		"int",
+		"ivec2",
+		"ivec3",
+		"ivec4",
+		"float",
+		"vec2",
+		"vec3",
+		"vec4",
+		"mat2",
+		"mat2x3",
+		"mat2x4",
+		"mat3x2",
+		"mat3",
+		"mat3x4",
+		"mat4x2",
+		"mat4x3",
+		"mat4"
+	};
+	assert( ARRAY_SIZE( glslType ) == KS_GPU_PROGRAM_PARM_TYPE_MAX );
+	return glslType[type];
+}
+
+typedef struct
+{
+	ksGpuProgramParmLayout	parmLayout;
+	int						vertexAttribsFlags;
+	ksStringHash			hash;
+} ksGpuGraphicsProgram;
+
+static bool ksGpuGraphicsProgram_Create( ksGpuContext * context, ksGpuGraphicsProgram * program,
+										const void * vertexSourceData, const size_t vertexSourceSize,
+										const void * fragmentSourceData, const size_t fragmentSourceSize,
+										const ksGpuProgramParm * parms, const int numParms,
+										const ksGpuVertexAttribute * vertexLayout, const int vertexAttribsFlags )
+{
+	UNUSED_PARM( context );
+	UNUSED_PARM( vertexSourceSize );
+	UNUSED_PARM( fragmentSourceSize );
+	UNUSED_PARM( vertexLayout );
+	assert( numParms <= MAX_PROGRAM_PARMS );
+
+	ksAtomicUint32_Increment( &gpuMockCounters.programsCreated );
+
+	memset( program, 0, sizeof( ksGpuGraphicsProgram ) );
+	program->vertexAttribsFlags = vertexAttribsFlags;
+	program->parmLayout.numParms = numParms;
+	program->parmLayout.parms = parms;
+
+	int offset = 0;
+	memset( program->parmLayout.offsetForIndex, -1, sizeof( program->parmLayout.offsetForIndex ) );
+	for ( int i = 0; i < numParms; i++ )
+	{
+		if ( !ksGpuProgramParm_IsOpaqueBinding( parms[i].type ) )
+		{
+			program->parmLayout.offsetForIndex[parms[i].index] = offset;
+			offset += ksGpuProgramParm_GetPushConstantSize( parms[i].type );
+		}
+	}
+
+	ksStringHash_Init( &program->hash );
+	ksStringHash_Update( &program->hash, (const char *)vertexSourceData );
+	ksStringHash_Update( &program->hash, (const char *)fragmentSourceData );
+	return true;
+}
+
+static void ksGpuGraphicsProgram_Destroy( ksGpuContext * context, ksGpuGraphicsProgram * program )
+{
+	UNUSED_PARM( context );
+	memset( program, 0, sizeof( ksGpuGraphicsProgram ) );
+}
+
+/*
+================================================================================================================================
+
+GPU graphics pipeline.
+
+================================================================================================================================
+*/
+
+typedef enum
+{
+	KS_GPU_FRONT_FACE_COUNTER_CLOCKWISE				= GL_CCW,
+	KS_GPU_FRONT_FACE_CLOCKWISE						= GL_CW
+} ksGpuFrontFace;
+
+typedef enum
+{
+	KS_GPU_CULL_MODE_NONE							= GL_NONE,
+	KS_GPU_CULL_MODE_FRONT							= GL_FRONT,
+	KS_GPU_CULL_MODE_BACK							= GL_BACK
+} ksGpuCullMode;
+
+typedef enum
+{
+	KS_GPU_COMPARE_OP_NEVER							= GL_NEVER,
+	KS_GPU_COMPARE_OP_LESS							= GL_LESS,
+	KS_GPU_COMPARE_OP_EQUAL							= GL_EQUAL,
+	KS_GPU_COMPARE_OP_LESS_OR_EQUAL					= GL_LEQUAL,
+	KS_GPU_COMPARE_OP_GREATER						= GL_GREATER,
+	KS_GPU_COMPARE_OP_NOT_EQUAL						= GL_NOTEQUAL,
+	KS_GPU_COMPARE_OP_GREATER_OR_EQUAL				= GL_GEQUAL,
+	KS_GPU_COMPARE_OP_ALWAYS						= GL_ALWAYS
+} ksGpuCompareOp;
+
+typedef enum
+{
+	KS_GPU_BLEND_OP_ADD								= GL_FUNC_ADD,
+	KS_GPU_BLEND_OP_SUBTRACT						= GL_FUNC_SUBTRACT,
+	KS_GPU_BLEND_OP_REVERSE_SUBTRACT				= GL_FUNC_REVERSE_SUBTRACT,
+	KS_GPU_BLEND_OP_MIN								= GL_MIN,
+	KS_GPU_BLEND_OP_MAX								= GL_MAX
+} ksGpuBlendOp;
+
+typedef enum
+{
+	KS_GPU_BLEND_FACTOR_ZERO						= GL_ZERO,
+	KS_GPU_BLEND_FACTOR_ONE							= GL_ONE,
+	KS_GPU_BLEND_FACTOR_SRC_COLOR					= GL_SRC_COLOR,
+	KS_GPU_BLEND_FACTOR_ONE_MINUS_SRC_COLOR			= GL_ONE_MINUS_SRC_COLOR,
+	KS_GPU_BLEND_FACTOR_DST_COLOR					= GL_DST_COLOR,
+	KS_GPU_BLEND_FACTOR_ONE_MINUS_DST_COLOR			= GL_ONE_MINUS_DST_COLOR,
+	KS_GPU_BLEND_FACTOR_SRC_ALPHA					= GL_SRC_ALPHA,
+	KS_GPU_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA			= GL_ONE_MINUS_SRC_ALPHA,
+	KS_GPU_BLEND_FACTOR_DST_ALPHA					= GL_DST_ALPHA,
+	KS_GPU_BLEND_FACTOR_ONE_MINUS_DST_ALPHA			= GL_ONE_MINUS_DST_ALPHA,
+	KS_GPU_BLEND_FACTOR_CONSTANT_COLOR				= GL_CONSTANT_COLOR,
+	KS_GPU_BLEND_FACTOR_ONE_MINUS_CONSTANT_COLOR	= GL_ONE_MINUS_CONSTANT_COLOR,
+	KS_GPU_BLEND_FACTOR_CONSTANT_ALPHA				= GL_CONSTANT_ALPHA,
+	KS_GPU_BLEND_FACTOR_ONE_MINUS_CONSTANT_ALPHA	= GL_ONE_MINUS_CONSTANT_ALPHA,
+	KS_GPU_BLEND_FACTOR_SRC_ALPHA_SATURATE			= GL_SRC_ALPHA_SATURATE
+} ksGpuBlendFactor;
+
+typedef struct
+{
+	bool							blendEnable;
+	bool							redWriteEnable;
+	bool							blueWriteEnable;
+	bool							greenWriteEnable;
+	bool							alphaWriteEnable;
+	bool							depthTestEnable;
+	bool							depthWriteEnable;
+	ksGpuFrontFace					frontFace;
+	ksGpuCullMode					cullMode;
+	ksGpuCompareOp					depthCompare;
+	ksVector4f						blendColor;
+	ksGpuBlendOp					blendOpColor;
+	ksGpuBlendFactor				blendSrcColor;
+	ksGpuBlendFactor				blendDstColor;
+	ksGpuBlendOp					blendOpAlpha;
+	ksGpuBlendFactor				blendSrcAlpha;
+	ksGpuBlendFactor				blendDstAlpha;
+} ksGpuRasterOperations;
+
+typedef struct
+{
+	ksGpuRasterOperations			rop;
+	const ksGpuRenderPass *			renderPass;
+	const ksGpuGraphicsProgram *	program;
+	const ksGpuGeometry *			geometry;
+} ksGpuGraphicsPipelineParms;
+
+typedef struct
+{
+	ksGpuRasterOperations			rop;
+	const ksGpuGraphicsProgram *	program;
+	const ksGpuGeometry *			geometry;
+} ksGpuGraphicsPipeline;
+
+static void ksGpuGraphicsPipelineParms_Init( ksGpuGraphicsPipelineParms * parms )
+{
+	memset( &parms->rop, 0, sizeof( parms->rop ) );
+	parms->rop.blendEnable = false;
+	parms->rop.redWriteEnable = true;
+	parms->rop.blueWriteEnable = true;
+	parms->rop.greenWriteEnable = true;
+	parms->rop.alphaWriteEnable = false;
+	parms->rop.depthTestEnable = true;
+	parms->rop.depthWriteEnable = true;
+	parms->rop.frontFace = KS_GPU_FRONT_FACE_COUNTER_CLOCKWISE;
+	parms->rop.cullMode = KS_GPU_CULL_MODE_BACK;
+	parms->rop.depthCompare = KS_GPU_COMPARE_OP_LESS_OR_EQUAL;
+	parms->rop.blendOpColor = KS_GPU_BLEND_OP_ADD;
+	parms->rop.blendSrcColor = KS_GPU_BLEND_FACTOR_ONE;
+	parms->rop.blendDstColor = KS_GPU_BLEND_FACTOR_ZERO;
+	parms->rop.blendOpAlpha = KS_GPU_BLEND_OP_ADD;
+	parms->rop.blendSrcAlpha = KS_GPU_BLEND_FACTOR_ONE;
+	parms->rop.blendDstAlpha = KS_GPU_BLEND_FACTOR_ZERO;
+	parms->renderPass = NULL;
+	parms->program = NULL;
+	parms->geometry = NULL;
+}
+
+static bool ksGpuGraphicsPipeline_Create( ksGpuContext * context, ksGpuGraphicsPipeline * pipeline, const ksGpuGraphicsPipelineParms * parms )
+{
+	UNUSED_PARM( context );
+
+	// Make sure the geometry provides all the attributes needed by the program.
+	assert( ( ( parms->geometry->vertexAttribsFlags | parms->geometry->instanceAttribsFlags ) & parms->program->vertexAttribsFlags ) == parms->program->vertexAttribsFlags );
+
+	ksAtomicUint32_Increment( &gpuMockCounters.pipelinesCreated );
+
+	pipeline->rop = parms->rop;
+	pipeline->program = parms->program;
+	pipeline->geometry = parms->geometry;
+	return true;
+}
+
+static void ksGpuGraphicsPipeline_Destroy( ksGpuContext * context, ksGpuGraphicsPipeline * pipeline )
+{
+	UNUSED_PARM( context );
+	memset( pipeline, 0, sizeof( ksGpuGraphicsPipeline ) );
+}
+
+/*
+================================================================================================================================
+
+GPU compute program and compute pipeline.
+
+================================================================================================================================
+*/
+
+typedef struct
+{
+	ksGpuProgramParmLayout	parmLayout;
+	ksStringHash			hash;
+} ksGpuComputeProgram;
+
+static bool ksGpuComputeProgram_Create( ksGpuContext * context, ksGpuComputeProgram * program,
+										const void * computeSourceData, const size_t computeSourceSize,
+										const ksGpuProgramParm * parms, const int numParms )
+{
+	UNUSED_PARM( context );
+	UNUSED_PARM( computeSourceSize );
+	assert( numParms <= MAX_PROGRAM_PARMS );
+
+	ksAtomicUint32_Increment( &gpuMockCounters.programsCreated );
+
+	memset( program, 0, sizeof( ksGpuComputeProgram ) );
+	program->parmLayout.numParms = numParms;
+	program->parmLayout.parms = parms;
+
+	int offset = 0;
+	memset( program->parmLayout.offsetForIndex, -1, sizeof( program->parmLayout.offsetForIndex ) );
+	for ( int i = 0; i < numParms; i++ )
+	{
+		if ( !ksGpuProgramParm_IsOpaqueBinding( parms[i].type ) )
+		{
+			program->parmLayout.offsetForIndex[parms[i].index] = offset;
+			offset += ksGpuProgramParm_GetPushConstantSize( parms[i].type );
+		}
+	}
+
+	ksStringHash_Init( &program->hash );
+	ksStringHash_Update( &program->hash, (const char *)computeSourceData );
+	return true;
+}
+
+static void ksGpuComputeProgram_Destroy( ksGpuContext * context, ksGpuComputeProgram * program )
+{
+	UNUSED_PARM( context );
+	memset( program, 0, sizeof( ksGpuComputeProgram ) );
+}
+
+typedef struct
+{
+	const ksGpuComputeProgram *	program;
+} ksGpuComputePipeline;
+
+static bool ksGpuComputePipeline_Create( ksGpuContext * context, ksGpuComputePipeline * pipeline, const ksGpuComputeProgram * program )
+{
+	UNUSED_PARM( context );
+
+	ksAtomicUint32_Increment( &gpuMockCounters.pipelinesCreated );
+
+	pipeline->program = program;
+	return true;
+}
+
+static void ksGpuComputePipeline_Destroy( ksGpuContext * context, ksGpuComputePipeline * pipeline )
+{
+	UNUSED_PARM( context );
+	memset( pipeline, 0, sizeof( ksGpuComputePipeline ) );
+}
+
+/*
+================================================================================================================================
+
+GPU graphics command.
+
+================================================================================================================================
+*/
+
+#define MAX_SAVED_PUSH_CONSTANT_BYTES		512
+
+typedef struct
+{
+	const void *	parms[MAX_PROGRAM_PARMS];
+	unsigned char	data[MAX_SAVED_PUSH_CONSTANT_BYTES];
+} ksGpuProgramParmState;
+
+// Same layout as DrawElementsIndirectCommand.
+typedef struct
+{
+	uint32_t	indexCount;
+	uint32_t	instanceCount;
+	uint32_t	firstIndex;
+	int32_t		vertexOffset;
+	uint32_t	firstInstance;
+} ksGpuDrawIndirectCommand;
+
+typedef struct
+{
+	const ksGpuGraphicsPipeline *	pipeline;
+	const ksGpuBuffer *				vertexBuffer;
+	const ksGpuBuffer *				instanceBuffer;
+	const ksGpuBuffer *				indirectBuffer;
+	ksGpuProgramParmState			parmState;
+	int								numInstances;
+	int								indirectFirstDraw;
+	int								indirectDrawCount;
+} ksGpuGraphicsCommand;
+
+static void ksGpuGraphicsCommand_Init( ksGpuGraphicsCommand * command )
+{
+	command->pipeline = NULL;
+	command->vertexBuffer = NULL;
+	command->instanceBuffer = NULL;
+	command->indirectBuffer = NULL;
+	memset( (void *)&command->parmState, 0, sizeof( command->parmState ) );
+	command->numInstances = 1;
+	command->indirectFirstDraw = 0;
+	command->indirectDrawCount = 0;
+}
+
+static void ksGpuGraphicsCommand_SetParm( ksGpuGraphicsCommand * command, const int index, const ksGpuProgramParmType parmType, const void * pointer )
+{
+	assert( index >= 0 && index < MAX_PROGRAM_PARMS );
+	const ksGpuProgramParmLayout * parmLayout = &command->pipeline->program->parmLayout;
+
+	command->parmState.parms[index] = pointer;
+
+	const int pushConstantSize = ksGpuProgramParm_GetPushConstantSize( parmType );
+	if ( pushConstantSize > 0 && parmLayout->offsetForIndex[index] >= 0 )
+	{
+		assert( parmLayout->offsetForIndex[index] + pushConstantSize <= MAX_SAVED_PUSH_CONSTANT_BYTES );
+		memcpy( &command->parmState.data[parmLayout->offsetForIndex[index]], pointer, pushConstantSize );
+	}
+}
+
+static void ksGpuGraphicsCommand_SetPipeline( ksGpuGraphicsCommand * command, const ksGpuGraphicsPipeline * pipeline ) { command->pipeline = pipeline; }
+static void ksGpuGraphicsCommand_SetVertexBuffer( ksGpuGraphicsCommand * command, const ksGpuBuffer * vertexBuffer ) { command->vertexBuffer = vertexBuffer; }
+static void ksGpuGraphicsCommand_SetInstanceBuffer( ksGpuGraphicsCommand * command, const ksGpuBuffer * instanceBuffer ) { command->instanceBuffer = instanceBuffer; }
+static void ksGpuGraphicsCommand_SetParmTextureSampled( ksGpuGraphicsCommand * command, const int index, const ksGpuTexture * texture ) { ksGpuGraphicsCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED, texture ); }
+static void ksGpuGraphicsCommand_SetParmTextureStorage( ksGpuGraphicsCommand * command, const int index, const ksGpuTexture * texture ) { ksGpuGraphicsCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_STORAGE, texture ); }
+static void ksGpuGraphicsCommand_SetParmBufferUniform( ksGpuGraphicsCommand * command, const int index, const ksGpuBuffer * buffer ) { ksGpuGraphicsCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM, buffer ); }
+static void ksGpuGraphicsCommand_SetParmBufferStorage( ksGpuGraphicsCommand * command, const int index, const ksGpuBuffer * buffer ) { ksGpuGraphicsCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_BUFFER_STORAGE, buffer ); }
+static void ksGpuGraphicsCommand_SetParmInt( ksGpuGraphicsCommand * command, const int index, const int * value ) { ksGpuGraphicsCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT, value ); }
+static void ksGpuGraphicsCommand_SetParmIntVector2( ksGpuGraphicsCommand * command, const int index, const ksVector2i * value ) { ksGpuGraphicsCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT_VECTOR2, value ); }
+static void ksGpuGraphicsCommand_SetParmIntVector3( ksGpuGraphicsCommand * command, const int index, const ksVector3i * value ) { ksGpuGraphicsCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT_VECTOR3, value ); }
+static void ksGpuGraphicsCommand_SetParmIntVector4( ksGpuGraphicsCommand * command, const int index, const ksVector4i * value ) { ksGpuGraphicsCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT_VECTOR4, value ); }
+static void ksGpuGraphicsCommand_SetParmFloat( ksGpuGraphicsCommand * command, const int index, const float * value ) { ksGpuGraphicsCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatVector2( ksGpuGraphicsCommand * command, const int index, const ksVector2f * value ) { ksGpuGraphicsCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_VECTOR2, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatVector3( ksGpuGraphicsCommand * command, const int index, const ksVector3f * value ) { ksGpuGraphicsCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_VECTOR3, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatVector4( ksGpuGraphicsCommand * command, const int index, const ksVector4f * value ) { ksGpuGraphicsCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_VECTOR4, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatMatrix2x2( ksGpuGraphicsCommand * command, const int index, const ksMatrix2x2f * value ) { ksGpuGraphicsCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX2X2, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatMatrix2x3( ksGpuGraphicsCommand * command, const int index, const ksMatrix2x3f * value ) { ksGpuGraphicsCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX2X3, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatMatrix2x4( ksGpuGraphicsCommand * command, const int index, const ksMatrix2x4f * value ) { ksGpuGraphicsCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX2X4, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatMatrix3x2( ksGpuGraphicsCommand * command, const int index, const ksMatrix3x2f * value ) { ksGpuGraphicsCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX3X2, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatMatrix3x3( ksGpuGraphicsCommand * command, const int index, const ksMatrix3x3f * value ) { ksGpuGraphicsCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX3X3, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatMatrix3x4( ksGpuGraphicsCommand * command, const int index, const ksMatrix3x4f * value ) { ksGpuGraphicsCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX3X4, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatMatrix4x2( ksGpuGraphicsCommand * command, const int index, const ksMatrix4x2f * value ) { ksGpuGraphicsCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X2, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatMatrix4x3( ksGpuGraphicsCommand * command, const int index, const ksMatrix4x3f * value ) { ksGpuGraphicsCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X3, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatMatrix4x4( ksGpuGraphicsCommand * command, const int index, const ksMatrix4x4f * value ) { ksGpuGraphicsCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X4, value ); }
+static void ksGpuGraphicsCommand_SetNumInstances( ksGpuGraphicsCommand * command, const int numInstances ) { command->numInstances = numInstances; }
+
+static void ksGpuGraphicsCommand_SetIndirectBuffer( ksGpuGraphicsCommand * command, const ksGpuBuffer * indirectBuffer, const int firstDraw, const int drawCount )
+{
+	command->indirectBuffer = indirectBuffer;
+	command->indirectFirstDraw = firstDraw;
+	command->indirectDrawCount = drawCount;
+}
+
+/*
+================================================================================================================================
+
+GPU compute command.
+
+================================================================================================================================
+*/
+
+typedef struct
+{
+	const ksGpuComputePipeline *	pipeline;
+	ksGpuProgramParmState			parmState;
+	int								x;
+	int								y;
+	int								z;
+} ksGpuComputeCommand;
+
+static void ksGpuComputeCommand_Init( ksGpuComputeCommand * command )
+{
+	command->pipeline = NULL;
+	memset( (void *)&command->parmState, 0, sizeof( command->parmState ) );
+	command->x = 1;
+	command->y = 1;
+	command->z = 1;
+}
+
+static void ksGpuComputeCommand_SetParm( ksGpuComputeCommand * command, const int index, const ksGpuProgramParmType parmType, const void * pointer )
+{
+	assert( index >= 0 && index < MAX_PROGRAM_PARMS );
+	const ksGpuProgramParmLayout * parmLayout = &command->pipeline->program->parmLayout;
+
+	command->parmState.parms[index] = pointer;
+
+	const int pushConstantSize = ksGpuProgramParm_GetPushConstantSize( parmType );
+	if ( pushConstantSize > 0 && parmLayout->offsetForIndex[index] >= 0 )
+	{
+		assert( parmLayout->offsetForIndex[index] + pushConstantSize <= MAX_SAVED_PUSH_CONSTANT_BYTES );
+		memcpy( &command->parmState.data[parmLayout->offsetForIndex[index]], pointer, pushConstantSize );
+	}
+}
+
+static void ksGpuComputeCommand_SetPipeline( ksGpuComputeCommand * command, const ksGpuComputePipeline * pipeline ) { command->pipeline = pipeline; }
+static void ksGpuComputeCommand_SetParmTextureSampled( ksGpuComputeCommand * command, const int index, const ksGpuTexture * texture ) { ksGpuComputeCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED, texture ); }
+static void ksGpuComputeCommand_SetParmTextureStorage( ksGpuComputeCommand * command, const int index, const ksGpuTexture * texture ) { ksGpuComputeCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_STORAGE, texture ); }
+static void ksGpuComputeCommand_SetParmBufferUniform( ksGpuComputeCommand * command, const int index, const ksGpuBuffer * buffer ) { ksGpuComputeCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM, buffer ); }
+static void ksGpuComputeCommand_SetParmBufferStorage( ksGpuComputeCommand * command, const int index, const ksGpuBuffer * buffer ) { ksGpuComputeCommand_SetParm( command, index, KS_GPU_PROGRAM_PARM_TYPE_BUFFER_STORAGE, buffer ); }
+
+static void ksGpuComputeCommand_SetDimensions( ksGpuComputeCommand * command, const int x, const int y, const int z )
+{
+	command->x = x;
+	command->y = y;
+	command->z = z;
+}
+
+/*
+================================================================================================================================
+
+GPU command buffer.
+
+The command buffer does not record anything. Submitted commands are validated and counted.
+
+================================================================================================================================
+*/
+
+typedef enum
+{
+	KS_GPU_BUFFER_UNMAP_TYPE_USE_ALLOCATED,		// use the newly allocated (host visible) buffer
+	KS_GPU_BUFFER_UNMAP_TYPE_COPY_BACK			// copy back to the original buffer
+} ksGpuBufferUnmapType;
+
+typedef struct
+{
+	ksGpuContext *			context;
+	ksGpuGraphicsCommand	currentGraphicsState;
+	ksGpuComputeCommand		currentComputeState;
+	bool					insideRenderPass;
+} ksGpuCommandBuffer;
+
+static void ksGpuMock_BeginRenderPass( ksGpuCommandBuffer * commandBuffer )
+{
+	assert( !commandBuffer->insideRenderPass );
+	commandBuffer->insideRenderPass = true;
+	ksGpuGraphicsCommand_Init( &commandBuffer->currentGraphicsState );
+}
+
+static void ksGpuMock_EndRenderPass( ksGpuCommandBuffer * commandBuffer )
+{
+	assert( commandBuffer->insideRenderPass );
+	commandBuffer->insideRenderPass = false;
+}
+
+static void ksGpuCommandBuffer_SubmitGraphicsCommand( ksGpuCommandBuffer * commandBuffer, const ksGpuGraphicsCommand * command )
+{
+	assert( commandBuffer->insideRenderPass );
+	assert( command->pipeline != NULL );
+
+	const ksGpuGraphicsCommand * state = &commandBuffer->currentGraphicsState;
+
+	if ( state->pipeline == NULL || command->pipeline->program->hash != state->pipeline->program->hash )
+	{
+		ksAtomicUint32_Increment( &gpuMockCounters.programChanges );
+	}
+	if ( command->pipeline != state->pipeline )
+	{
+		ksAtomicUint32_Increment( &gpuMockCounters.pipelineChanges );
+	}
+
+	// Every parm the program uses must have been set.
+	const ksGpuProgramParmLayout * layout = &command->pipeline->program->parmLayout;
+	for ( int i = 0; i < layout->numParms; i++ )
+	{
+		assert( command->parmState.parms[layout->parms[i].index] != NULL );
+	}
+
+	ksAtomicUint32_Increment( &gpuMockCounters.drawCalls );
+	if ( command->indirectBuffer != NULL )
+	{
+		assert( command->indirectBuffer->type == KS_GPU_BUFFER_TYPE_INDIRECT );
+		assert( command->indirectBuffer->usage == KS_GPU_BUFFER_USAGE_INDIRECT );
+		assert( ( command->indirectFirstDraw + command->indirectDrawCount ) * sizeof( ksGpuDrawIndirectCommand ) <= command->indirectBuffer->size );
+		const ksGpuDrawIndirectCommand * draws = (const ksGpuDrawIndirectCommand *)command->indirectBuffer->data + command->indirectFirstDraw;
+		for ( int i = 0; i < command->indirectDrawCount; i++ )
+		{
+			ksGpuMock_Add( &gpuMockCounters.instances, draws[i].instanceCount );
+		}
+		ksGpuMock_Add( &gpuMockCounters.indirectDraws, command->indirectDrawCount );
+	}
+	else
+	{
+		ksGpuMock_Add( &gpuMockCounters.instances, command->numInstances );
+	}
+
+	commandBuffer->currentGraphicsState = *command;
+}
+
+static void ksGpuCommandBuffer_SubmitComputeCommand( ksGpuCommandBuffer * commandBuffer, const ksGpuComputeCommand * command )
+{
+	assert( !commandBuffer->insideRenderPass );
+	assert( command->pipeline != NULL );
+
+	const ksGpuComputeCommand * state = &commandBuffer->currentComputeState;
+
+	if ( state->pipeline == NULL || command->pipeline->program->hash != state->pipeline->program->hash )
+	{
+		ksAtomicUint32_Increment( &gpuMockCounters.programChanges );
+	}
+	if ( command->pipeline != state->pipeline )
+	{
+		ksAtomicUint32_Increment( &gpuMockCounters.pipelineChanges );
+	}
+
+	// Every parm the program uses must have been set and storage buffers must be ready to be written.
+	const ksGpuProgramParmLayout * layout = &command->pipeline->program->parmLayout;
+	for ( int i = 0; i < layout->numParms; i++ )
+	{
+		const void * parm = command->parmState.parms[layout->parms[i].index];
+		assert( parm != NULL );
+		if ( layout->parms[i].type == KS_GPU_PROGRAM_PARM_TYPE_BUFFER_STORAGE )
+		{
+			assert( ((const ksGpuBuffer *)parm)->usage == KS_GPU_BUFFER_USAGE_STORAGE );
+		}
+		UNUSED_PARM( parm );
+	}
+
+	assert( command->x > 0 && command->y > 0 && command->z > 0 );
+	ksAtomicUint32_Increment( &gpuMockCounters.computeDispatches );
+
+	commandBuffer->currentComputeState = *command;
+}
+
+static void ksGpuCommandBuffer_ChangeBufferUsage( ksGpuCommandBuffer * commandBuffer, ksGpuBuffer * buffer, const ksGpuBufferUsage usage )
+{
+	// Barriers can only be issued outside a render pass.
+	assert( !commandBuffer->insideRenderPass );
+	assert( buffer->type == KS_GPU_BUFFER_TYPE_INDIRECT || buffer->type == KS_GPU_BUFFER_TYPE_STORAGE );
+	UNUSED_PARM( commandBuffer );
+
+	ksAtomicUint32_Increment( &gpuMockCounters.bufferBarriers );
+
+	buffer->usage = usage;
+}
+
+static ksGpuBuffer * ksGpuCommandBuffer_MapBuffer( ksGpuCommandBuffer * commandBuffer, ksGpuBuffer * buffer, void ** data )
+{
+	UNUSED_PARM( commandBuffer );
+
+	ksAtomicUint32_Increment( &gpuMockCounters.bufferMaps );
+
+	*data = buffer->data;
+	return buffer;
+}
+
+static void ksGpuCommandBuffer_UnmapBuffer( ksGpuCommandBuffer * commandBuffer, ksGpuBuffer * buffer, ksGpuBuffer * mappedBuffer, const ksGpuBufferUnmapType type )
+{
+	UNUSED_PARM( buffer );
+
+	assert( buffer == mappedBuffer );
+	UNUSED_PARM( mappedBuffer );
+
+	if ( type == KS_GPU_BUFFER_UNMAP_TYPE_COPY_BACK )
+	{
+		// Can only copy outside a render pass.
+		assert( !commandBuffer->insideRenderPass );
+		ksAtomicUint32_Increment( &gpuMockCounters.bufferCopyBacks );
+	}
+}
+
+static ksGpuBuffer * ksGpuCommandBuffer_MapInstanceAttributes( ksGpuCommandBuffer * commandBuffer, ksGpuGeometry * geometry, ksGpuVertexAttributeArrays * attribs )
+{
+	void * data = NULL;
+	ksGpuBuffer * buffer = ksGpuCommandBuffer_MapBuffer( commandBuffer, &geometry->instanceBuffer, &data );
+
+	attribs->layout = geometry->layout;
+	ksGpuVertexAttributeArrays_Map( attribs, data, buffer->size, geometry->instanceCount, geometry->instanceAttribsFlags );
+
+	return buffer;
+}
+
+static void ksGpuCommandBuffer_UnmapInstanceAttributes( ksGpuCommandBuffer * commandBuffer, ksGpuGeometry * geometry, ksGpuBuffer * mappedInstanceBuffer, const ksGpuBufferUnmapType type )
+{
+	ksGpuCommandBuffer_UnmapBuffer( commandBuffer, &geometry->instanceBuffer, mappedInstanceBuffer, type );
+}
+
+/*
+================================================================================================================================
+
+HMD
+
+================================================================================================================================
+*/
+
+#define NUM_EYES				2
+
+static void GetHmdViewMatrixForTime( ksMatrix4x4f * viewMatrix, const ksNanoseconds time )
+{
+	const float offset = time * ( MATH_PI / 1000.0f / 1000.0f / 1000.0f );
+	const float degrees = 10.0f;
+	const float degreesX = sinf( offset ) * degrees;
+	const float degreesY = cosf( offset ) * degrees;
+
+	ksMatrix4x4f_CreateRotation( viewMatrix, degreesX, degreesY, 0.0f );
+}
+
+#endif // !KSGPU_MOCK_H
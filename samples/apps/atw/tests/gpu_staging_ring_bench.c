@@ -0,0 +1,295 @@
+/*
+================================================================================================
+
+Description	:	Headless benchmark of texture uploads through the Vulkan staging ring.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Writes a texture file with a 64 byte KTX sized header and loads it a number of times into
+a staging ring of the same size as the one in atw_vulkan.c, with batches that retire in
+order the way the setup batches do. The file is loaded in two ways:
+
+	- read + copy: the file is read into a temporary buffer and the texture data is copied
+	  into the ring, which is how the textures were loaded before,
+	- read into ring: the file is read straight into ring memory, which is how
+	  ksGpuTexture_CreateFromFile loads textures now.
+
+The fastest and average load times and the throughput of both paths are printed, followed
+by the number of small ring allocations per second. The ring is plain CPU memory here, so
+the numbers show the cost of the extra copy, not the cost of writing to uncached memory.
+
+The benchmark fails when the data staged by the two paths differs from the file.
+
+================================================================================================
+*/
+
+#include "vk_mock.h"
+#include "../gpu/gpu_staging_ring.h"
+
+#if !defined( OUTPUT_PATH )
+	#define OUTPUT_PATH					""
+#endif
+
+#define MAX_SETUP_BATCHES			4
+#define STAGING_RING_SIZE			( 32 * 1024 * 1024 )
+#define STAGING_RING_ALIGNMENT		256
+#define KTX_HEADER_SIZE				64
+#define SMALL_ALLOCATION_COUNT		( 1024 * 1024 )
+
+typedef enum
+{
+	UPLOAD_PATH_READ_COPY,
+	UPLOAD_PATH_READ_INTO_RING,
+	UPLOAD_PATH_MAX
+} ksUploadPath;
+
+static const char * uploadPathNames[UPLOAD_PATH_MAX] =
+{
+	"read + copy",
+	"read into ring"
+};
+
+typedef struct
+{
+	ksGpuStagingRing	ring;
+	uint8_t *			memory;
+	VkDeviceSize		marks[MAX_SETUP_BATCHES];
+	int					batchCount;		// batches in flight
+	int					oldestBatch;
+} ksFakeStaging;
+
+static void ksFakeStaging_Create( ksFakeStaging * staging )
+{
+	memset( staging, 0, sizeof( ksFakeStaging ) );
+	ksGpuStagingRing_Init( &staging->ring, STAGING_RING_SIZE );
+	staging->memory = (uint8_t *) malloc( STAGING_RING_SIZE );
+	memset( staging->memory, 0, STAGING_RING_SIZE );
+}
+
+static void ksFakeStaging_Destroy( ksFakeStaging * staging )
+{
+	free( staging->memory );
+}
+
+static void ksFakeStaging_RetireOldest( ksFakeStaging * staging )
+{
+	assert( staging->batchCount > 0 );
+	ksGpuStagingRing_Release( &staging->ring, staging->marks[staging->oldestBatch] );
+	staging->oldestBatch = ( staging->oldestBatch + 1 ) % MAX_SETUP_BATCHES;
+	staging->batchCount--;
+}
+
+// Submits everything allocated so far as a batch, and retires the oldest batch when all batches are in flight.
+static void ksFakeStaging_Submit( ksFakeStaging * staging )
+{
+	if ( staging->batchCount == MAX_SETUP_BATCHES )
+	{
+		ksFakeStaging_RetireOldest( staging );
+	}
+	staging->marks[( staging->oldestBatch + staging->batchCount ) % MAX_SETUP_BATCHES] = ksGpuStagingRing_GetMark( &staging->ring );
+	staging->batchCount++;
+}
+
+static uint8_t * ksFakeStaging_Allocate( ksFakeStaging * staging, const VkDeviceSize size, const VkDeviceSize alignment )
+{
+	VkDeviceSize offset;
+	while ( !ksGpuStagingRing_Allocate( &staging->ring, size, alignment, &offset ) )
+	{
+		if ( staging->batchCount == 0 )
+		{
+			ksFakeStaging_Submit( staging );
+		}
+		ksFakeStaging_RetireOldest( staging );
+	}
+	return staging->memory + offset;
+}
+
+static bool WriteTextureFile( const char * fileName, const size_t dataSize )
+{
+	FILE * fp = fopen( fileName, "wb" );
+	if ( fp == NULL )
+	{
+		Print( "Failed to write %s\n", fileName );
+		return false;
+	}
+	uint8_t * buffer = (uint8_t *) malloc( KTX_HEADER_SIZE + dataSize );
+	memset( buffer, 0, KTX_HEADER_SIZE );
+	for ( size_t i = 0; i < dataSize; i++ )
+	{
+		buffer[KTX_HEADER_SIZE + i] = (uint8_t)( i * 7 + ( i >> 12 ) );
+	}
+	const bool success = ( fwrite( buffer, 1, KTX_HEADER_SIZE + dataSize, fp ) == KTX_HEADER_SIZE + dataSize );
+	free( buffer );
+	fclose( fp );
+	return success;
+}
+
+// Returns the staged texture data, which stays valid until the next load.
+static const uint8_t * LoadTexture( ksFakeStaging * staging, const char * fileName, const ksUploadPath path )
+{
+	FILE * fp = fopen( fileName, "rb" );
+	if ( fp == NULL )
+	{
+		return NULL;
+	}
+
+	fseek( fp, 0L, SEEK_END );
+	const size_t fileSize = ftell( fp );
+	fseek( fp, 0L, SEEK_SET );
+
+	const uint8_t * data = NULL;
+	if ( path == UPLOAD_PATH_READ_COPY )
+	{
+		uint8_t * buffer = (uint8_t *) malloc( fileSize );
+		if ( fread( buffer, 1, fileSize, fp ) == fileSize )
+		{
+			uint8_t * ring = ksFakeStaging_Allocate( staging, fileSize - KTX_HEADER_SIZE, STAGING_RING_ALIGNMENT );
+			memcpy( ring, buffer + KTX_HEADER_SIZE, fileSize - KTX_HEADER_SIZE );
+			data = ring;
+		}
+		free( buffer );
+	}
+	else
+	{
+		// Same as ksGpuTexture_CreateFromFile, pad the start so the texture data is aligned.
+		const size_t padding = ( STAGING_RING_ALIGNMENT - KTX_HEADER_SIZE % STAGING_RING_ALIGNMENT ) % STAGING_RING_ALIGNMENT;
+		uint8_t * ring = ksFakeStaging_Allocate( staging, padding + fileSize, STAGING_RING_ALIGNMENT ) + padding;
+		if ( fread( ring, 1, fileSize, fp ) == fileSize )
+		{
+			data = ring + KTX_HEADER_SIZE;
+		}
+	}
+	fclose( fp );
+
+	ksFakeStaging_Submit( staging );
+	return data;
+}
+
+int main( int argc, char * argv[] )
+{
+	int dataSizeMB = 4;
+	int loadCount = 32;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char * arg = argv[i];
+		if ( arg[0] == '-' ) { arg++; }
+
+		if ( strcmp( arg, "s" ) == 0 && i + 1 < argc )		{ dataSizeMB = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "l" ) == 0 && i + 1 < argc )	{ loadCount = atoi( argv[++i] ); }
+		else
+		{
+			Print( "Unknown option: %s\n"
+				   "atw_gpu_staging_ring_bench [options]\n"
+				   "options:\n"
+				   "   -s <MB>     size of the texture data in MB, at most 8\n"
+				   "   -l <n>      number of times the texture is loaded\n",
+				   arg );
+			return 1;
+		}
+	}
+
+	// Textures up to MAX_SETUP_STAGING_SIZE are staged in the ring.
+	dataSizeMB = CLAMP( dataSizeMB, 1, 8 );
+	loadCount = MAX( loadCount, 1 );
+
+	const size_t dataSize = (size_t)dataSizeMB * 1024 * 1024;
+	const char * fileName = OUTPUT_PATH "gpu_staging_ring_bench.ktx";
+	if ( !WriteTextureFile( fileName, dataSize ) )
+	{
+		return 1;
+	}
+
+	uint8_t * expected = (uint8_t *) malloc( dataSize );
+	for ( size_t i = 0; i < dataSize; i++ )
+	{
+		expected[i] = (uint8_t)( i * 7 + ( i >> 12 ) );
+	}
+
+	int failures = 0;
+
+	Print( "%-16s %8s %8s %10s\n", "path", "min ms", "avg ms", "MB/s" );
+	for ( int path = 0; path < UPLOAD_PATH_MAX; path++ )
+	{
+		ksFakeStaging staging;
+		ksFakeStaging_Create( &staging );
+
+		ksNanoseconds minLoadTime = ~0ULL;
+		ksNanoseconds totalLoadTime = 0;
+		for ( int loadIndex = 0; loadIndex < loadCount; loadIndex++ )
+		{
+			const ksNanoseconds startTime = GetTimeNanoseconds();
+			const uint8_t * data = LoadTexture( &staging, fileName, (ksUploadPath)path );
+			const ksNanoseconds loadTime = GetTimeNanoseconds() - startTime;
+
+			minLoadTime = MIN( minLoadTime, loadTime );
+			totalLoadTime += loadTime;
+
+			if ( data == NULL || memcmp( data, expected, dataSize ) != 0 )
+			{
+				Print( "%s: the staged texture data differs from the file\n", uploadPathNames[path] );
+				failures++;
+				break;
+			}
+		}
+
+		Print( "%-16s %8.3f %8.3f %10.1f\n", uploadPathNames[path], minLoadTime * 1e-6, totalLoadTime * 1e-6 / loadCount,
+				(double)dataSize * loadCount / ( 1024.0 * 1024.0 ) / ( totalLoadTime * 1e-9 ) );
+
+		ksFakeStaging_Destroy( &staging );
+	}
+
+	// Small uploads, like uniform and vertex buffer updates, with a batch every 64 allocations.
+	{
+		ksFakeStaging staging;
+		ksFakeStaging_Create( &staging );
+
+		uint32_t seed = 1;
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+		for ( int i = 0; i < SMALL_ALLOCATION_COUNT; i++ )
+		{
+			seed = seed * 1664525u + 1013904223u;
+			ksFakeStaging_Allocate( &staging, 16 + ( seed >> 8 ) % 4096, STAGING_RING_ALIGNMENT );
+			if ( ( i & 63 ) == 63 )
+			{
+				ksFakeStaging_Submit( &staging );
+			}
+		}
+		const ksNanoseconds time = GetTimeNanoseconds() - startTime;
+
+		Print( "%d small ring allocations in %1.3f ms (%1.1f M/s)\n", SMALL_ALLOCATION_COUNT, time * 1e-6, SMALL_ALLOCATION_COUNT * 1e3 / time );
+
+		ksFakeStaging_Destroy( &staging );
+	}
+
+	free( expected );
+	remove( fileName );
+
+	Print( "%d staged textures differ from the file\n", failures );
+
+	return ( failures == 0 ) ? 0 : 1;
+}
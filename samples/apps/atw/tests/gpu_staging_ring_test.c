@@ -0,0 +1,320 @@
+/*
+================================================================================================
+
+Description	:	Unit test of the Vulkan staging ring buffer.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Drives the staging ring from atw_vulkan.c the way the setup batches do. Every batch takes
+a mark when it is submitted and releases the mark when its fake fence signals, oldest first.
+When an allocation does not fit, the oldest batch in flight is retired, and when nothing is
+in flight the batch that is being recorded is submitted first, just like the context does.
+
+The test fails when:
+	- an allocation that does not fit before the end of the ring does not wrap around,
+	- the skipped space at the end of the ring is not accounted for until it is released,
+	- an allocation succeeds while the ring is full or fails while there is room,
+	- an allocation larger than the ring succeeds,
+	- an allocation is not aligned, does not fit inside the ring or overlaps a live allocation,
+	- data staged for a batch is overwritten before the batch is retired,
+	- the ring is not empty and back at the start once all batches are retired.
+
+================================================================================================
+*/
+
+#include "vk_mock.h"
+#include "../gpu/gpu_staging_ring.h"
+
+#define MAX_BATCHES					4
+#define MAX_BATCH_ALLOCATIONS		64
+#define RANDOM_RING_SIZE			( 1024 * 1024 )
+#define RANDOM_ALLOCATION_COUNT		20000
+
+/*
+================================================================================================================================
+
+Tests.
+
+================================================================================================================================
+*/
+
+// An allocation that does not fit before the end of the ring wraps around to the start.
+static int TestWrapAround()
+{
+	const char * test = "wrap-around";
+	int failures = 0;
+
+	ksGpuStagingRing ring;
+	ksGpuStagingRing_Init( &ring, 1024 );
+
+	VkDeviceSize a = ~0ULL, b = ~0ULL, c = ~0ULL;
+	failures += !Expect( ksGpuStagingRing_Allocate( &ring, 300, 256, &a ) && a == 0, test, "the first allocation is not at the start" );
+	const VkDeviceSize markA = ksGpuStagingRing_GetMark( &ring );
+	failures += !Expect( ksGpuStagingRing_Allocate( &ring, 300, 256, &b ) && b == 512, test, "the second allocation is not aligned after the first" );
+	const VkDeviceSize markB = ksGpuStagingRing_GetMark( &ring );
+
+	// The first allocation is still in use, so there is no room at the start.
+	failures += !Expect( !ksGpuStagingRing_Allocate( &ring, 200, 256, &c ), test, "wrapped onto an allocation that is still in use" );
+
+	ksGpuStagingRing_Release( &ring, markA );
+	failures += !Expect( ring.used == 512, test, "releasing the first batch did not keep the alignment padding and the second allocation" );
+
+	failures += !Expect( ksGpuStagingRing_Allocate( &ring, 200, 256, &c ) && c == 0, test, "an allocation past the end did not wrap around" );
+	failures += !Expect( c + 200 <= b, test, "the wrapped allocation overlaps the second allocation" );
+	failures += !Expect( ring.used == 512 + ( 1024 - 812 ) + 200, test, "the skipped space at the end is not counted as used" );
+	const VkDeviceSize markC = ksGpuStagingRing_GetMark( &ring );
+
+	// The skipped space at the end stays in use until the wrapped allocation is released.
+	ksGpuStagingRing_Release( &ring, markB );
+	failures += !Expect( ring.used == ( 1024 - 812 ) + 200, test, "the skipped space was released with the allocation before it" );
+
+	ksGpuStagingRing_Release( &ring, markC );
+	failures += !Expect( ring.used == 0 && ring.head == 0, test, "the ring is not empty and back at the start" );
+
+	// An allocation that ends exactly at the end of the ring does not wrap.
+	VkDeviceSize d = ~0ULL, e = ~0ULL;
+	failures += !Expect( ksGpuStagingRing_Allocate( &ring, 768, 256, &d ) && d == 0, test, "the first allocation is not at the start" );
+	const VkDeviceSize markD = ksGpuStagingRing_GetMark( &ring );
+	failures += !Expect( ksGpuStagingRing_Allocate( &ring, 256, 256, &e ) && e == 768, test, "an allocation that ends at the end of the ring wrapped" );
+	ksGpuStagingRing_Release( &ring, markD );
+	failures += !Expect( ksGpuStagingRing_Allocate( &ring, 768, 256, &d ) && d == 0, test, "a full ring did not wrap without padding" );
+	failures += !Expect( ring.used == 1024, test, "the ring is not full" );
+
+	return failures;
+}
+
+// Allocation fails when the ring is full and succeeds again once the oldest batch is released.
+static int TestFullRing()
+{
+	const char * test = "full ring";
+	int failures = 0;
+
+	ksGpuStagingRing ring;
+	ksGpuStagingRing_Init( &ring, 1024 );
+
+	VkDeviceSize offset;
+	failures += !Expect( !ksGpuStagingRing_Allocate( &ring, 1025, 1, &offset ), test, "an allocation larger than the ring succeeded" );
+	failures += !Expect( ring.used == 0 && ring.head == 0 && ring.allocated == 0, test, "a failed allocation changed the ring" );
+
+	VkDeviceSize marks[4];
+	for ( int i = 0; i < 4; i++ )
+	{
+		failures += !Expect( ksGpuStagingRing_Allocate( &ring, 256, 256, &offset ) && offset == (VkDeviceSize)i * 256, test, "an allocation is not at the next aligned offset" );
+		marks[i] = ksGpuStagingRing_GetMark( &ring );
+	}
+
+	const ksGpuStagingRing full = ring;
+	failures += !Expect( !ksGpuStagingRing_Allocate( &ring, 1, 1, &offset ), test, "an allocation succeeded while the ring is full" );
+	failures += !Expect( ring.used == full.used && ring.head == full.head && ring.allocated == full.allocated, test, "a failed allocation changed the ring" );
+
+	// Releasing the oldest batch makes room at the start of the ring.
+	ksGpuStagingRing_Release( &ring, marks[0] );
+	failures += !Expect( ksGpuStagingRing_Allocate( &ring, 256, 256, &offset ) && offset == 0, test, "the released space at the start was not reused" );
+	failures += !Expect( !ksGpuStagingRing_Allocate( &ring, 1, 1, &offset ), test, "an allocation succeeded while the ring is full" );
+	const VkDeviceSize markLast = ksGpuStagingRing_GetMark( &ring );
+
+	for ( int i = 1; i < 4; i++ )
+	{
+		ksGpuStagingRing_Release( &ring, marks[i] );
+	}
+	failures += !Expect( ring.used == 256, test, "releasing the older batches did not leave only the last allocation" );
+	ksGpuStagingRing_Release( &ring, markLast );
+	failures += !Expect( ring.used == 0 && ring.head == 0, test, "the ring is not empty and back at the start" );
+
+	failures += !Expect( ksGpuStagingRing_Allocate( &ring, 1024, 256, &offset ) && offset == 0, test, "an allocation of the whole empty ring failed" );
+
+	return failures;
+}
+
+typedef struct
+{
+	VkDeviceSize	mark;
+	VkDeviceSize	offsets[MAX_BATCH_ALLOCATIONS];
+	VkDeviceSize	sizes[MAX_BATCH_ALLOCATIONS];
+	int				count;
+	uint8_t			pattern;
+} ksFakeBatch;
+
+static void ksFakeBatch_Begin( ksFakeBatch * batch, uint8_t * pattern )
+{
+	memset( batch, 0, sizeof( ksFakeBatch ) );
+	*pattern = ( *pattern == 255 ) ? 1 : *pattern + 1;
+	batch->pattern = *pattern;
+}
+
+static bool ksFakeBatch_Check( const uint8_t * memory, const ksFakeBatch * batch )
+{
+	for ( int i = 0; i < batch->count; i++ )
+	{
+		for ( VkDeviceSize j = 0; j < batch->sizes[i]; j++ )
+		{
+			if ( memory[batch->offsets[i] + j] != batch->pattern )
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// Random uploads with batches in flight, writing every allocation and checking it when its batch retires.
+static int TestRandom()
+{
+	const char * test = "random";
+	int failures = 0;
+
+	ksGpuStagingRing ring;
+	ksGpuStagingRing_Init( &ring, RANDOM_RING_SIZE );
+	uint8_t * memory = (uint8_t *) malloc( RANDOM_RING_SIZE );
+
+	ksFakeBatch batches[MAX_BATCHES + 1];
+	int oldest = 0;			// oldest batch in flight
+	int inFlight = 0;
+	int current = 0;		// batch that is being recorded
+	uint8_t pattern = 0;
+	ksFakeBatch_Begin( &batches[current], &pattern );
+
+	uint32_t seed = 1;
+	int wraps = 0;
+	int fullCount = 0;
+	VkDeviceSize previousOffset = 0;
+	for ( int allocationIndex = 0; allocationIndex < RANDOM_ALLOCATION_COUNT && failures < 16; allocationIndex++ )
+	{
+		const VkDeviceSize size = 1 + Random( &seed ) % ( ( Random( &seed ) & 31 ) == 0 ? RANDOM_RING_SIZE / 4 : 4096 );
+		const VkDeviceSize alignment = (VkDeviceSize)1 << ( Random( &seed ) % 9 );
+
+		VkDeviceSize offset;
+		while ( !ksGpuStagingRing_Allocate( &ring, size, alignment, &offset ) )
+		{
+			fullCount++;
+			if ( inFlight == 0 )
+			{
+				// Submit the batch that is being recorded.
+				batches[current].mark = ksGpuStagingRing_GetMark( &ring );
+				inFlight++;
+				current = ( current + 1 ) % ( MAX_BATCHES + 1 );
+				ksFakeBatch_Begin( &batches[current], &pattern );
+			}
+			// Wait for the oldest batch and release it.
+			failures += !Expect( ksFakeBatch_Check( memory, &batches[oldest] ), test, "staged data was overwritten before its batch retired" );
+			ksGpuStagingRing_Release( &ring, batches[oldest].mark );
+			oldest = ( oldest + 1 ) % ( MAX_BATCHES + 1 );
+			inFlight--;
+		}
+
+		wraps += ( offset < previousOffset );
+		previousOffset = offset;
+
+		failures += !Expect( ( offset & ( alignment - 1 ) ) == 0, test, "an allocation is not aligned" );
+		failures += !Expect( offset + size <= RANDOM_RING_SIZE, test, "an allocation does not fit inside the ring" );
+		for ( int i = 0; i < inFlight + 1; i++ )
+		{
+			const ksFakeBatch * batch = &batches[( oldest + i ) % ( MAX_BATCHES + 1 )];
+			for ( int j = 0; j < batch->count; j++ )
+			{
+				if ( offset < batch->offsets[j] + batch->sizes[j] && batch->offsets[j] < offset + size )
+				{
+					failures += !Expect( false, test, "an allocation overlaps a live allocation" );
+				}
+			}
+		}
+
+		ksFakeBatch * batch = &batches[current];
+		memset( memory + offset, batch->pattern, size );
+		batch->offsets[batch->count] = offset;
+		batch->sizes[batch->count] = size;
+		batch->count++;
+
+		// Submit the batch when it is full or at random.
+		if ( batch->count == MAX_BATCH_ALLOCATIONS || ( Random( &seed ) & 15 ) == 0 )
+		{
+			if ( inFlight == MAX_BATCHES )
+			{
+				failures += !Expect( ksFakeBatch_Check( memory, &batches[oldest] ), test, "staged data was overwritten before its batch retired" );
+				ksGpuStagingRing_Release( &ring, batches[oldest].mark );
+				oldest = ( oldest + 1 ) % ( MAX_BATCHES + 1 );
+				inFlight--;
+			}
+			batch->mark = ksGpuStagingRing_GetMark( &ring );
+			inFlight++;
+			current = ( current + 1 ) % ( MAX_BATCHES + 1 );
+			ksFakeBatch_Begin( &batches[current], &pattern );
+		}
+	}
+
+	// Submit the last batch and retire everything.
+	batches[current].mark = ksGpuStagingRing_GetMark( &ring );
+	inFlight++;
+	while ( inFlight > 0 )
+	{
+		failures += !Expect( ksFakeBatch_Check( memory, &batches[oldest] ), test, "staged data was overwritten before its batch retired" );
+		ksGpuStagingRing_Release( &ring, batches[oldest].mark );
+		oldest = ( oldest + 1 ) % ( MAX_BATCHES + 1 );
+		inFlight--;
+	}
+
+	failures += !Expect( wraps > 0, test, "the ring never wrapped around" );
+	failures += !Expect( fullCount > 0, test, "the ring was never full" );
+	failures += !Expect( ring.used == 0 && ring.head == 0, test, "the ring is not empty and back at the start" );
+
+	free( memory );
+
+	return failures;
+}
+
+int main( int argc, char * argv[] )
+{
+	UNUSED_PARM( argc );
+	UNUSED_PARM( argv );
+
+	typedef struct
+	{
+		const char *	name;
+		int				(*function)();
+	} ksTest;
+
+	const ksTest tests[] =
+	{
+		{ "wrap-around",	TestWrapAround },
+		{ "full ring",		TestFullRing },
+		{ "random",			TestRandom }
+	};
+
+	int failures = 0;
+	for ( int i = 0; i < (int)ARRAY_SIZE( tests ); i++ )
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+		const int testFailures = tests[i].function();
+		const ksNanoseconds time = GetTimeNanoseconds() - startTime;
+		Print( "%-12s %s (%1.1f ms)\n", tests[i].name, ( testFailures == 0 ) ? "passed" : "FAILED", time * 1e-6 );
+		failures += testFailures;
+	}
+
+	Print( "%d staging ring checks failed\n", failures );
+
+	return ( failures == 0 ) ? 0 : 1;
+}
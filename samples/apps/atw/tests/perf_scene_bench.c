@@ -0,0 +1,155 @@
+/*
+================================================================================================
+
+Description	:	Headless benchmark of the perf scene model matrix calculation.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Creates the perf scene on top of the headless GPU layer and, for every draw call level,
+measures the time ksPerfScene_CalculateModelMatrices takes per frame. The model matrices
+are compared bit for bit with the straight forward calculation that multiplies the small
+translation, small rotation and big transform matrices for every object.
+
+This benchmark is built once with KSALGEBRA_SIMD enabled and once without. Both builds use
+-ffp-contract=off so the scalar code is not contracted into fused multiply-adds.
+
+================================================================================================
+*/
+
+#include "gpu_mock.h"
+#include "../scenes/scene_settings.h"
+#include "../scenes/scene_view_state.h"
+#include "../scenes/scene_perf.h"
+
+#define VERIFY_FRAMES			4
+
+static int VerifyModelMatrices( const ksPerfScene * scene )
+{
+	const ksPerfSceneMatrixJobs * jobs = &scene->matrixJobs;
+	const int dimension = jobs->dimension;
+	int mismatches = 0;
+	for ( int x = 0; x < dimension; x++ )
+	{
+		for ( int y = 0; y < dimension; y++ )
+		{
+			for ( int z = 0; z < dimension; z++ )
+			{
+				ksMatrix4x4f smallTranslationMatrix;
+				ksMatrix4x4f_CreateTranslation( &smallTranslationMatrix, jobs->offsets[x], jobs->offsets[y], jobs->offsets[z] );
+
+				ksMatrix4x4f smallTransformMatrix;
+				ksMatrix4x4f_Multiply( &smallTransformMatrix, &smallTranslationMatrix, &jobs->smallRotationMatrix );
+
+				ksMatrix4x4f modelMatrix;
+				ksMatrix4x4f_Multiply( &modelMatrix, &jobs->bigTransformMatrix, &smallTransformMatrix );
+
+				mismatches += ( memcmp( &modelMatrix, &scene->modelMatrix[( x * dimension + y ) * dimension + z], sizeof( ksMatrix4x4f ) ) != 0 );
+			}
+		}
+	}
+	return mismatches;
+}
+
+int main( int argc, char * argv[] )
+{
+	int frameCount = 256;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char * arg = argv[i];
+		if ( arg[0] == '-' ) { arg++; }
+
+		if ( strcmp( arg, "f" ) == 0 && i + 1 < argc )		{ frameCount = atoi( argv[++i] ); }
+		else
+		{
+			Print( "Unknown option: %s\n"
+				   "atw_perf_scene_bench [options]\n"
+				   "options:\n"
+				   "   -f <n>      number of frames per draw call level\n",
+				   arg );
+			return 1;
+		}
+	}
+
+#if defined( KSALGEBRA_USE_SSE )
+	const char * path = "SSE";
+#elif defined( KSALGEBRA_USE_NEON )
+	const char * path = "NEON";
+#else
+	const char * path = "scalar";
+#endif
+
+	ksGpuContext context;
+	ksGpuMock_CreateContext( &context );
+
+	ksGpuRenderPass renderPass;
+	renderPass.sampleCount = KS_GPU_SAMPLE_COUNT_1;
+
+	ksSceneSettings settings;
+	ksSceneSettings_Init( &context, &settings );
+
+	ksViewState viewState;
+	ksViewState_Init( &viewState, 0.0640f );
+
+	ksPerfScene scene;
+	ksPerfScene_Create( &context, &scene, &settings, &renderPass );
+
+	int mismatches = 0;
+	for ( int level = 0; level < MAX_SCENE_DRAWCALL_LEVELS; level++ )
+	{
+		ksSceneSettings_SetDrawCallLevel( &settings, level );
+
+		ksNanoseconds totalTime = 0;
+		for ( int frameIndex = 0; frameIndex < frameCount; frameIndex++ )
+		{
+			// Frames at 90 Hz.
+			const ksNanoseconds time = (ksNanoseconds)frameIndex * 1000 * 1000 * 1000 / 90;
+			ksPerfScene_Simulate( &scene, &viewState, time );
+
+			const ksNanoseconds startTime = GetTimeNanoseconds();
+			ksPerfScene_CalculateModelMatrices( &scene, scene.modelMatrix );
+			totalTime += GetTimeNanoseconds() - startTime;
+
+			if ( frameIndex < VERIFY_FRAMES )
+			{
+				mismatches += VerifyModelMatrices( &scene );
+			}
+		}
+
+		const int dimension = scene.matrixJobs.dimension;
+		Print( "%s: draw call level %d, %5d objects, %s, %7.4f ms per frame\n", path, level,
+				dimension * dimension * dimension,
+				( dimension * dimension * dimension >= PERF_THREAD_POOL_OBJECTS ) ? "workers" : "serial ",
+				totalTime * 1e-6 / frameCount );
+	}
+
+	ksPerfScene_Destroy( &context, &scene );
+
+	Print( "%d model matrices differ from the straight forward calculation\n", mismatches );
+
+	return ( mismatches == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,250 @@
+/*
+================================================================================================
+
+Description	:	Headless test of the perf scene indirect draw culling.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Creates the perf scene with indirect draws on top of the headless GPU layer and, for every
+draw call level and a number of view directions, verifies the parameters the perf scene
+passes to the cull compute program.
+
+The headless GPU layer does not execute compute programs, so the culling is performed with
+ksPerfScene_IsObjectVisible, which mirrors the compute program. The instance counts are
+written into the indirect draw commands, such that the instances counted by the headless
+GPU layer are the instances the GPU would draw.
+
+The test fails when:
+	- an object with a point inside the view frustum is culled,
+	- the objects are not all visible when looking at the grid,
+	- the objects are all visible or all culled when looking at the edge of the grid,
+	- the objects are not all culled when looking away from the grid,
+	- not exactly one dispatch and two buffer barriers are recorded per buffer update,
+	- the number of drawn instances differs from the number of visible objects.
+
+================================================================================================
+*/
+
+#include "gpu_mock.h"
+#include "../scenes/scene_settings.h"
+#include "../scenes/scene_view_state.h"
+#include "../scenes/scene_perf.h"
+
+static const float viewYaws[] = { 0.0f, 40.0f, 80.0f, 180.0f };
+
+// Returns true if clip space position 'clip' is inside the frustum that is culled against.
+static bool IsInsideFrustum( const ksVector4f * clip )
+{
+	return	clip->w > 0.0f &&
+			clip->x > -clip->w && clip->x < clip->w &&
+			clip->y > -clip->w && clip->y < clip->w &&
+			clip->z > -clip->w;
+}
+
+// Returns true if the center of the object, or a point on its bounding sphere along one of the axes, is visible in the eye.
+static bool IsObjectSampleVisible( const ksPerfScene * scene, const ksViewState * viewState, const int eye, const int index )
+{
+	const ksPerfSceneMatrixJobs * jobs = &scene->matrixJobs;
+	const int dimension = jobs->dimension;
+
+	ksMatrix4x4f viewProjectionMatrix;
+	ksMatrix4x4f_Multiply( &viewProjectionMatrix, &viewState->projectionMatrix[eye], &viewState->viewMatrix[eye] );
+
+	ksMatrix4x4f clipMatrix;
+	ksMatrix4x4f_Multiply( &clipMatrix, &viewProjectionMatrix, &jobs->bigTransformMatrix );
+
+	const ksVector4f center =
+	{
+		jobs->offsets[index / ( dimension * dimension )],
+		jobs->offsets[( index / dimension ) % dimension],
+		jobs->offsets[index % dimension],
+		1.0f
+	};
+
+	for ( int sample = 0; sample < 7; sample++ )
+	{
+		ksVector4f point = center;
+		if ( sample > 0 )
+		{
+			const float offset = ( ( sample & 1 ) ? 1.0f : -1.0f ) * PERF_OBJECT_RADIUS * 0.999f;
+			( &point.x )[( sample - 1 ) >> 1] += offset;
+		}
+
+		ksVector4f clip;
+		ksMatrix4x4f_TransformVector4f( &clip, &clipMatrix, &point );
+		if ( IsInsideFrustum( &clip ) )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// Performs the work of the cull compute program.
+static int CullObjects( ksPerfScene * scene )
+{
+	const ksPerfSceneCullParms * parms = (const ksPerfSceneCullParms *)scene->cullParms.data;
+	ksGpuDrawIndirectCommand * commands = (ksGpuDrawIndirectCommand *)scene->indirectBuffers[scene->settings.triangleLevel].data;
+	const int objectCount = parms->counts.x * parms->counts.x * parms->counts.x;
+
+	int visibleCount = 0;
+	for ( int index = 0; index < objectCount; index++ )
+	{
+		commands[index].instanceCount = ksPerfScene_IsObjectVisible( parms, index ) ? 1 : 0;
+		visibleCount += commands[index].instanceCount;
+	}
+	return visibleCount;
+}
+
+int main( int argc, char * argv[] )
+{
+	UNUSED_PARM( argc );
+	UNUSED_PARM( argv );
+
+	ksGpuContext context;
+	ksGpuMock_CreateContext( &context );
+
+	ksGpuRenderPass renderPass;
+	renderPass.sampleCount = KS_GPU_SAMPLE_COUNT_1;
+
+	ksGpuCommandBuffer commandBuffer;
+	memset( &commandBuffer, 0, sizeof( commandBuffer ) );
+	commandBuffer.context = &context;
+
+	int failures = 0;
+	for ( int multiView = 0; multiView <= 1; multiView++ )
+	{
+		ksSceneSettings settings;
+		ksSceneSettings_Init( &context, &settings );
+		ksSceneSettings_SetMultiView( &settings, multiView != 0 );
+		ksSceneSettings_SetIndirect( &settings, true );
+
+		ksViewState viewState;
+		ksViewState_Init( &viewState, 0.0640f );
+
+		ksPerfScene scene;
+		ksPerfScene_Create( &context, &scene, &settings, &renderPass );
+
+		if ( !scene.drawIndirect )
+		{
+			Error( "the perf scene does not draw indirect" );
+			return 1;
+		}
+
+		for ( int level = 0; level < MAX_SCENE_DRAWCALL_LEVELS; level++ )
+		{
+			ksSceneSettings_SetDrawCallLevel( &settings, level );
+
+			for ( int yawIndex = 0; yawIndex < (int)ARRAY_SIZE( viewYaws ); yawIndex++ )
+			{
+				ksPerfScene_Simulate( &scene, &viewState, 0 );
+
+				// Turn the head away from the grid.
+				ksMatrix4x4f yawMatrix;
+				ksMatrix4x4f_CreateRotation( &yawMatrix, 0.0f, viewYaws[yawIndex], 0.0f );
+				for ( int eye = 0; eye < NUM_EYES; eye++ )
+				{
+					const ksMatrix4x4f viewMatrix = viewState.viewMatrix[eye];
+					ksMatrix4x4f_Multiply( &viewState.viewMatrix[eye], &yawMatrix, &viewMatrix );
+				}
+
+				const int firstPass = multiView ? 2 : 0;
+				const int endPass = multiView ? 3 : NUM_EYES;
+				for ( int pass = firstPass; pass < endPass; pass++ )
+				{
+					ksGpuMock_ResetCounters();
+
+					ksPerfScene_UpdateBuffers( &commandBuffer, &scene, &viewState, pass );
+					const int visibleCount = CullObjects( &scene );
+
+					ksGpuMock_BeginRenderPass( &commandBuffer );
+					ksPerfScene_Render( &commandBuffer, &scene, &viewState );
+					ksGpuMock_EndRenderPass( &commandBuffer );
+
+					const ksGpuMockCounters counters = ksGpuMock_GetCounters();
+
+					const ksPerfSceneCullParms * parms = (const ksPerfSceneCullParms *)scene.cullParms.data;
+					const int objectCount = parms->counts.x * parms->counts.x * parms->counts.x;
+
+					int falseNegatives = 0;
+					for ( int index = 0; index < objectCount; index++ )
+					{
+						if ( ksPerfScene_IsObjectVisible( parms, index ) )
+						{
+							continue;
+						}
+						for ( int eye = ( pass == 2 ) ? 0 : pass; eye <= ( ( pass == 2 ) ? 1 : pass ); eye++ )
+						{
+							falseNegatives += IsObjectSampleVisible( &scene, &viewState, eye, index );
+						}
+					}
+
+					Print( "multi-view = %d, draw call level %d, yaw %3.0f, pass %d: %5d of %5d objects visible\n",
+							multiView, level, viewYaws[yawIndex], pass, visibleCount, objectCount );
+
+					if ( falseNegatives != 0 )
+					{
+						Error( "%d objects with a visible point are culled", falseNegatives );
+						failures++;
+					}
+					if ( viewYaws[yawIndex] == 0.0f && visibleCount != objectCount )
+					{
+						Error( "only %d of %d objects are visible when looking at the grid", visibleCount, objectCount );
+						failures++;
+					}
+					if ( viewYaws[yawIndex] == 40.0f && ( visibleCount == 0 || visibleCount == objectCount ) )
+					{
+						Error( "%d of %d objects are visible when looking at the edge of the grid", visibleCount, objectCount );
+						failures++;
+					}
+					if ( viewYaws[yawIndex] == 180.0f && visibleCount != 0 )
+					{
+						Error( "%d objects are visible when looking away from the grid", visibleCount );
+						failures++;
+					}
+					if ( counters.computeDispatches != 1 || counters.bufferBarriers != 2 )
+					{
+						Error( "%u dispatches and %u buffer barriers instead of 1 and 2", counters.computeDispatches, counters.bufferBarriers );
+						failures++;
+					}
+					if ( counters.drawCalls != 1 || counters.indirectDraws != (uint32_t)objectCount || counters.instances != (uint32_t)visibleCount )
+					{
+						Error( "%u draw calls, %u indirect draws and %u instances instead of 1, %d and %d",
+								counters.drawCalls, counters.indirectDraws, counters.instances, objectCount, visibleCount );
+						failures++;
+					}
+				}
+			}
+		}
+
+		ksPerfScene_Destroy( &context, &scene );
+	}
+
+	Print( "%d culling checks failed\n", failures );
+
+	return ( failures == 0 ) ? 0 : 1;
+}
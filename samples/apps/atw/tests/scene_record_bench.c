@@ -0,0 +1,263 @@
+/*
+================================================================================================
+
+Description	:	Headless benchmark of recording the scene on multiple threads.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Records the perf scene and a synthetic glTF scene on top of the headless GPU layer the way
+the Vulkan scene thread does with more than one record thread: the scene is split into one
+part per thread with ksPerfScene_RenderPart or ksGltfScene_RenderPart, and every part is
+recorded into its own command buffer by a worker of a thread pool.
+
+For 1, 2, 4 and 8 record threads the time to record a frame is printed, together with the
+number of processors, because the recording cannot get faster with more threads than
+processors.
+
+The benchmark fails when the parts together do not record exactly the draw calls and
+instances that are recorded when the whole scene is recorded into a single command buffer.
+
+================================================================================================
+*/
+
+#include "gpu_mock.h"				// first, it selects the POSIX and GNU features
+#include <sys/sysinfo.h>
+#include "../scenes/scene_settings.h"
+#include "../scenes/scene_view_state.h"
+#include "../scenes/scene_perf.h"
+#include "../scenes/scene_gltf.h"
+#include "gltf_scene_gen.h"
+
+#define MAX_RECORD_THREADS		8
+
+static const int recordThreadCounts[] = { 1, 2, 4, 8 };
+
+typedef struct
+{
+	ksGpuCommandBuffer *	commandBuffers;		// one command buffer per part
+	const ksPerfScene *		perfScene;			// either the perf scene or the glTF scene is recorded
+	const ksGltfScene *		gltfScene;
+	const ksViewState *		viewState;
+	int						partCount;
+	ksAtomicUint32			nextPart;			// atomic counter shared by all workers
+} ksRecordJobs;
+
+static void RecordJobThread( void * data )
+{
+	ksRecordJobs * jobs = (ksRecordJobs *)data;
+
+	for ( ; ; )
+	{
+		const unsigned int part = ksAtomicUint32_Increment( &jobs->nextPart ) - 1;
+		if ( part >= (unsigned int)jobs->partCount )
+		{
+			break;
+		}
+
+		ksGpuCommandBuffer * commandBuffer = &jobs->commandBuffers[part];
+		ksGpuMock_BeginRenderPass( commandBuffer );
+		if ( jobs->gltfScene == NULL )
+		{
+			ksPerfScene_RenderPart( commandBuffer, jobs->perfScene, jobs->viewState, (int)part, jobs->partCount );
+		}
+		else
+		{
+			ksGltfScene_RenderPart( commandBuffer, jobs->gltfScene, jobs->viewState, (int)part, jobs->partCount );
+		}
+		ksGpuMock_EndRenderPass( commandBuffer );
+	}
+}
+
+// Records 'frameCount' frames with each number of record threads and returns the number of thread counts with unexpected commands.
+static int RecordScene( ksGpuContext * context, const char * sceneName, ksPerfScene * perfScene, ksGltfScene * gltfScene,
+						ksViewState * viewState, ksGpuWindowInput * input, const int frameCount )
+{
+	ksGpuCommandBuffer commandBuffers[MAX_RECORD_THREADS];
+	memset( commandBuffers, 0, sizeof( commandBuffers ) );
+	for ( int part = 0; part < MAX_RECORD_THREADS; part++ )
+	{
+		commandBuffers[part].context = context;
+	}
+
+	// The draw list of the glTF scene is built while updating the buffers.
+	if ( perfScene != NULL )
+	{
+		ksPerfScene_Simulate( perfScene, viewState, 0 );
+		ksPerfScene_UpdateBuffers( &commandBuffers[0], perfScene, viewState, 0 );
+	}
+	else
+	{
+		ksGltfScene_Simulate( gltfScene, viewState, input, 0 );
+		ksGltfScene_UpdateBuffers( &commandBuffers[0], gltfScene, viewState, 0 );
+	}
+
+	// Record the whole scene into a single command buffer as the reference.
+	ksGpuMock_ResetCounters();
+	ksGpuMock_BeginRenderPass( &commandBuffers[0] );
+	if ( perfScene != NULL )
+	{
+		ksPerfScene_Render( &commandBuffers[0], perfScene, viewState );
+	}
+	else
+	{
+		ksGltfScene_Render( &commandBuffers[0], gltfScene, viewState );
+	}
+	ksGpuMock_EndRenderPass( &commandBuffers[0] );
+	const ksGpuMockCounters reference = ksGpuMock_GetCounters();
+
+	int failures = 0;
+	for ( int threadIndex = 0; threadIndex < (int)ARRAY_SIZE( recordThreadCounts ); threadIndex++ )
+	{
+		const int threadCount = recordThreadCounts[threadIndex];
+
+		ksThreadPool threadPool;
+		ksThreadPool_Create( &threadPool, threadCount );
+
+		ksRecordJobs jobs;
+		memset( &jobs, 0, sizeof( jobs ) );
+		jobs.commandBuffers = commandBuffers;
+		jobs.perfScene = perfScene;
+		jobs.gltfScene = gltfScene;
+		jobs.viewState = viewState;
+		jobs.partCount = threadCount;
+
+		ksNanoseconds totalTime = 0;
+		for ( int frameIndex = 0; frameIndex < frameCount; frameIndex++ )
+		{
+			ksGpuMock_ResetCounters();
+
+			const ksNanoseconds startTime = GetTimeNanoseconds();
+			jobs.nextPart = 0;
+			ksThreadPool_Submit( &threadPool, RecordJobThread, &jobs );
+			ksThreadPool_Join( &threadPool );
+			totalTime += GetTimeNanoseconds() - startTime;
+
+			const ksGpuMockCounters counters = ksGpuMock_GetCounters();
+			if ( frameIndex == 0 && ( counters.drawCalls != reference.drawCalls || counters.instances != reference.instances ) )
+			{
+				Error( "%s with %d record threads recorded %u draw calls and %u instances instead of %u and %u", sceneName, threadCount,
+						counters.drawCalls, counters.instances, reference.drawCalls, reference.instances );
+				failures++;
+			}
+		}
+
+		ksThreadPool_Destroy( &threadPool );
+
+		Print( "%-20s %6u draws, %d record threads: %7.4f ms per frame\n", sceneName, reference.drawCalls, threadCount, totalTime * 1e-6 / frameCount );
+	}
+	return failures;
+}
+
+int main( int argc, char * argv[] )
+{
+	int frameCount = 64;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char * arg = argv[i];
+		if ( arg[0] == '-' ) { arg++; }
+
+		if ( strcmp( arg, "f" ) == 0 && i + 1 < argc )		{ frameCount = atoi( argv[++i] ); }
+		else
+		{
+			Print( "Unknown option: %s\n"
+				   "atw_scene_record_bench [options]\n"
+				   "options:\n"
+				   "   -f <n>      number of frames per number of record threads\n",
+				   arg );
+			return 1;
+		}
+	}
+
+	Print( "%d processors\n", get_nprocs() );
+
+	ksGpuContext context;
+	ksGpuMock_CreateContext( &context );
+
+	ksGpuRenderPass renderPass;
+	renderPass.sampleCount = KS_GPU_SAMPLE_COUNT_1;
+
+	ksGpuWindowInput input;
+	memset( &input, 0, sizeof( input ) );
+
+	int failures = 0;
+
+	// Perf scene with a draw call per object.
+	{
+		ksSceneSettings settings;
+		ksSceneSettings_Init( &context, &settings );
+
+		ksViewState viewState;
+		ksViewState_Init( &viewState, 0.0640f );
+
+		ksPerfScene scene;
+		ksPerfScene_Create( &context, &scene, &settings, &renderPass );
+
+		for ( int level = 0; level < MAX_SCENE_DRAWCALL_LEVELS; level++ )
+		{
+			ksSceneSettings_SetDrawCallLevel( &settings, level );
+
+			char sceneName[32];
+			snprintf( sceneName, sizeof( sceneName ), "perf level %d", level );
+			failures += RecordScene( &context, sceneName, &scene, NULL, &viewState, &input, frameCount );
+		}
+
+		ksPerfScene_Destroy( &context, &scene );
+	}
+
+	// glTF scene with a draw call per batch.
+	{
+		ksGltfSceneGenParms genParms;
+		ksGltfSceneGen_InitParms( &genParms );
+
+		const char * fileName = OUTPUT_PATH "scene_record_bench.gltf";
+		if ( !ksGltfSceneGen_WriteFile( fileName, &genParms ) )
+		{
+			return 1;
+		}
+
+		ksSceneSettings settings;
+		ksSceneSettings_Init( &context, &settings );
+		ksSceneSettings_SetGltf( &settings, fileName );
+
+		ksViewState viewState;
+		ksViewState_Init( &viewState, 0.0640f );
+
+		ksGltfScene scene;
+		ksGltfScene_CreateFromFile( &context, &scene, &settings, &renderPass );
+
+		failures += RecordScene( &context, "glTF", NULL, &scene, &viewState, &input, frameCount );
+
+		ksGltfScene_Destroy( &context, &scene );
+
+		remove( fileName );
+	}
+
+	Print( "%d record thread counts recorded unexpected commands\n", failures );
+
+	return ( failures == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,192 @@
+/*
+================================================================================================
+
+Description	:	Headless benchmark of culling bounds for both eyes at once.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+Scatters random world space bounds around the viewer and, for a number of head poses, culls
+them two ways:
+
+	- combined: one ksViewState_CullBounds pass that resolves the visible eyes of all bounds,
+	- per-eye: one ksMatrix4x4f_CullBounds pass with the view-projection matrix of each eye.
+
+The number of bounds per millisecond of both is printed, together with the number of bounds
+the combined pass keeps for an eye while the per-eye pass culls them for that eye. The combined
+pass is conservative, so this number is allowed to be non-zero.
+
+The benchmark fails when the combined pass culls bounds for an eye while the per-eye pass
+finds the bounds visible in that eye.
+
+================================================================================================
+*/
+
+#include "gpu_mock.h"
+#include "../scenes/scene_view_state.h"
+
+typedef enum
+{
+	CULL_COMBINED,
+	CULL_PER_EYE,
+	CULL_MAX
+} ksCullMode;
+
+static const char * cullModeNames[CULL_MAX] = { "combined", "per-eye" };
+
+static float RandomFloat( unsigned int * seed )
+{
+	*seed = *seed * 1664525 + 1013904223;
+	return (float)( *seed >> 8 ) * ( 1.0f / (float)( 1 << 24 ) );
+}
+
+int main( int argc, char * argv[] )
+{
+	int boundsCount = 4096;
+	int poseCount = 64;
+	int passCount = 16;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char * arg = argv[i];
+		if ( arg[0] == '-' ) { arg++; }
+
+		if ( strcmp( arg, "b" ) == 0 && i + 1 < argc )		{ boundsCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "p" ) == 0 && i + 1 < argc )	{ poseCount = atoi( argv[++i] ); }
+		else if ( strcmp( arg, "r" ) == 0 && i + 1 < argc )	{ passCount = atoi( argv[++i] ); }
+		else
+		{
+			Print( "Unknown option: %s\n"
+				   "atw_stereo_cull_bench [options]\n"
+				   "options:\n"
+				   "   -b <n>      number of bounds\n"
+				   "   -p <n>      number of head poses\n"
+				   "   -r <n>      number of timed passes per head pose\n",
+				   arg );
+			return 1;
+		}
+	}
+
+	if ( boundsCount < 1 || poseCount < 1 || passCount < 1 )
+	{
+		Error( "Invalid arguments" );
+		return 1;
+	}
+
+	// Boxes of 0.01 to 1 units on a side within 16 units of the viewer.
+	ksVector3f * mins = (ksVector3f *) malloc( boundsCount * sizeof( ksVector3f ) );
+	ksVector3f * maxs = (ksVector3f *) malloc( boundsCount * sizeof( ksVector3f ) );
+	unsigned int seed = 12345;
+	for ( int index = 0; index < boundsCount; index++ )
+	{
+		const float size = 0.01f + RandomFloat( &seed );
+		mins[index].x = ( RandomFloat( &seed ) * 2.0f - 1.0f ) * 16.0f;
+		mins[index].y = ( RandomFloat( &seed ) * 2.0f - 1.0f ) * 16.0f;
+		mins[index].z = ( RandomFloat( &seed ) * 2.0f - 1.0f ) * 16.0f;
+		maxs[index].x = mins[index].x + size;
+		maxs[index].y = mins[index].y + size;
+		maxs[index].z = mins[index].z + size;
+	}
+
+	unsigned char * combinedEyes = (unsigned char *) malloc( boundsCount );
+	unsigned char * perEyeEyes = (unsigned char *) malloc( boundsCount );
+
+	ksViewState viewState;
+	ksViewState_Init( &viewState, 0.0640f );
+
+	int failures = 0;
+	int visibleBounds = 0;
+	int conservativeBounds = 0;
+	ksNanoseconds cullTimes[CULL_MAX] = { 0 };
+
+	for ( int poseIndex = 0; poseIndex < poseCount; poseIndex++ )
+	{
+		// Head poses 100 milliseconds apart.
+		ksViewState_HandleHmd( &viewState, (ksNanoseconds)poseIndex * 100 * 1000 * 1000 );
+
+		ksMatrix4x4f viewProjectionMatrix[NUM_EYES];
+		for ( int eye = 0; eye < NUM_EYES; eye++ )
+		{
+			ksMatrix4x4f_Multiply( &viewProjectionMatrix[eye], &viewState.projectionMatrix[eye], &viewState.viewMatrix[eye] );
+		}
+
+		ksNanoseconds startTime = GetTimeNanoseconds();
+		for ( int pass = 0; pass < passCount; pass++ )
+		{
+			ksViewState_CullBounds( &viewState, mins, maxs, boundsCount, combinedEyes );
+		}
+		cullTimes[CULL_COMBINED] += GetTimeNanoseconds() - startTime;
+
+		startTime = GetTimeNanoseconds();
+		for ( int pass = 0; pass < passCount; pass++ )
+		{
+			memset( perEyeEyes, 0, boundsCount );
+			for ( int eye = 0; eye < NUM_EYES; eye++ )
+			{
+				for ( int index = 0; index < boundsCount; index++ )
+				{
+					perEyeEyes[index] |= (unsigned char)( !ksMatrix4x4f_CullBounds( &viewProjectionMatrix[eye], &mins[index], &maxs[index] ) << eye );
+				}
+			}
+		}
+		cullTimes[CULL_PER_EYE] += GetTimeNanoseconds() - startTime;
+
+		int differences = 0;
+		for ( int index = 0; index < boundsCount; index++ )
+		{
+			for ( int eye = 0; eye < NUM_EYES; eye++ )
+			{
+				const int combinedVisible = ( combinedEyes[index] >> eye ) & 1;
+				const int perEyeVisible = ( perEyeEyes[index] >> eye ) & 1;
+				differences += ( perEyeVisible && !combinedVisible );
+				conservativeBounds += ( combinedVisible && !perEyeVisible );
+				visibleBounds += perEyeVisible;
+			}
+		}
+		if ( differences != 0 )
+		{
+			Print( "pose %d: %d bounds are culled for an eye in which they are visible\n", poseIndex, differences );
+			failures++;
+		}
+	}
+
+	free( perEyeEyes );
+	free( combinedEyes );
+	free( maxs );
+	free( mins );
+
+	Print( "%d bounds, %d head poses, %d passes per pose\n", boundsCount, poseCount, passCount );
+	for ( int mode = 0; mode < CULL_MAX; mode++ )
+	{
+		Print( "%-8s %10.3f ms/pass %10.0f bounds/ms\n", cullModeNames[mode], cullTimes[mode] * 1e-6 / ( poseCount * passCount ),
+				(double)boundsCount * poseCount * passCount / ( cullTimes[mode] * 1e-6 ) );
+	}
+	Print( "%d eye visible bounds per pose, %d more kept by the combined pass\n", visibleBounds / poseCount, conservativeBounds / poseCount );
+
+	Print( "%d head poses cull visible bounds\n", failures );
+
+	return ( failures == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,242 @@
+/*
+================================================================================================
+
+Description	:	Headless subset of Vulkan for the GPU layer unit tests.
+Date		:	10/17/2026
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+Copyright	:	Copyright (c) 2016 Oculus VR, LLC. All Rights reserved.
+
+
+LICENSE
+=======
+
+Copyright (c) 2016 Oculus VR, LLC.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+DESCRIPTION
+===========
+
+This header declares the few Vulkan types and enumerants that are used by the parts of
+the Vulkan GPU layer that do not call the driver, like the device memory allocator in
+gpu/gpu_memory_allocator.h and the descriptor set cache in gpu/gpu_descriptor_set_cache.h.
+The values match vulkan.h so the tests exercise the exact same code as atw_vulkan.c
+without a Vulkan SDK, driver or GPU.
+
+Unlike atw_vulkan.c, Error() does not abort. It counts the errors instead so the tests
+can verify that failure paths are reported.
+
+Include this header first, then the GPU layer headers:
+
+	#include "vk_mock.h"
+	#include "../gpu/gpu_memory_allocator.h"
+
+The tests share the helpers below. Each test calls Expect for every condition it checks
+and adds the failed conditions to its failure count. The driver objects a test fakes are
+named ksFake<Object> with ksFake<Object>_<Function> functions, for instance ksFakeDevice
+in gpu_memory_allocator_test.c and ksFakeDriver in gpu_descriptor_set_cache_test.c.
+
+INTERFACE
+=========
+
+static void ksVkMock_ResetErrorCount();
+static int ksVkMock_GetErrorCount();
+
+static uint32_t Random( uint32_t * seed );
+static bool Expect( const bool condition, const char * test, const char * what );
+
+================================================================================================
+*/
+
+#if !defined( KSVK_MOCK_H )
+#define KSVK_MOCK_H
+
+#if defined( _WIN32 )
+	#define OS_WINDOWS
+#elif defined( __APPLE__ )
+	#define OS_APPLE
+#else
+	#define OS_LINUX
+#endif
+
+#if defined( OS_LINUX )
+	#define _GNU_SOURCE						// for pthread_setname_np, pthread_setaffinity_np and strcasecmp
+	#if __STDC_VERSION__ >= 199901L
+	#define _XOPEN_SOURCE 600
+	#else
+	#define _XOPEN_SOURCE 500
+	#endif
+	#if !defined( __USE_UNIX98 )
+		#define __USE_UNIX98	1				// for pthread_mutexattr_settype
+	#endif
+	#include <pthread.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <assert.h>
+#include <string.h>
+#include <errno.h>
+
+/*
+================================
+Common defines
+================================
+*/
+
+#define UNUSED_PARM( x )				{ (void)(x); }
+#define ARRAY_SIZE( a )					( sizeof( (a) ) / sizeof( (a)[0] ) )
+#define BIT( x )						( 1 << (x) )
+#define ROUNDUP( x, granularity )		( ( (x) + (granularity) - 1 ) & ~( (granularity) - 1 ) )
+#define MAX( x, y )						( ( x > y ) ? ( x ) : ( y ) )
+#define MIN( x, y )						( ( x < y ) ? ( x ) : ( y ) )
+#define CLAMP( x, min, max )			( ( (x) < (min) ) ? (min) : ( ( (x) > (max) ) ? (max) : (x) ) )
+
+#include <utils/nanoseconds.h>
+#include <utils/threading.h>
+
+/*
+================================================================================================================================
+
+Vulkan subset.
+
+================================================================================================================================
+*/
+
+#define VK_MAX_MEMORY_TYPES						32
+#define VK_MAX_MEMORY_HEAPS						16
+#define VK_NULL_HANDLE							0
+
+typedef uint32_t VkFlags;
+typedef uint64_t VkDeviceSize;
+typedef uint64_t VkDeviceMemory;				// non-dispatchable handle
+typedef uint64_t VkDescriptorPool;				// non-dispatchable handle
+typedef uint64_t VkDescriptorSet;				// non-dispatchable handle
+typedef uint64_t VkDescriptorSetLayout;			// non-dispatchable handle
+
+typedef enum
+{
+	VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT			= 0x00000001,
+	VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT			= 0x00000002,
+	VK_MEMORY_PROPERTY_HOST_COHERENT_BIT		= 0x00000004,
+	VK_MEMORY_PROPERTY_HOST_CACHED_BIT			= 0x00000008,
+	VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT		= 0x00000010
+} VkMemoryPropertyFlagBits;
+typedef VkFlags VkMemoryPropertyFlags;
+
+typedef enum
+{
+	VK_MEMORY_HEAP_DEVICE_LOCAL_BIT				= 0x00000001
+} VkMemoryHeapFlagBits;
+typedef VkFlags VkMemoryHeapFlags;
+
+typedef struct
+{
+	VkDeviceSize	size;
+	VkDeviceSize	alignment;
+	uint32_t		memoryTypeBits;
+} VkMemoryRequirements;
+
+typedef struct
+{
+	VkMemoryPropertyFlags	propertyFlags;
+	uint32_t				heapIndex;
+} VkMemoryType;
+
+typedef struct
+{
+	VkDeviceSize		size;
+	VkMemoryHeapFlags	flags;
+} VkMemoryHeap;
+
+typedef struct
+{
+	uint32_t		memoryTypeCount;
+	VkMemoryType	memoryTypes[VK_MAX_MEMORY_TYPES];
+	uint32_t		memoryHeapCount;
+	VkMemoryHeap	memoryHeaps[VK_MAX_MEMORY_HEAPS];
+} VkPhysicalDeviceMemoryProperties;
+
+/*
+================================================================================================================================
+
+Print and counted errors.
+
+================================================================================================================================
+*/
+
+static ksAtomicUint32 vkMockErrorCount;
+
+static void Print( const char * format, ... )
+{
+	va_list args;
+	va_start( args, format );
+	vprintf( format, args );
+	va_end( args );
+	fflush( stdout );
+}
+
+static void Error( const char * format, ... )
+{
+	ksAtomicUint32_Increment( &vkMockErrorCount );
+
+	va_list args;
+	va_start( args, format );
+	printf( "Error: " );
+	vprintf( format, args );
+	printf( "\n" );
+	va_end( args );
+	fflush( stdout );
+}
+
+static void ksVkMock_ResetErrorCount()
+{
+	vkMockErrorCount = 0;
+}
+
+static int ksVkMock_GetErrorCount()
+{
+	return (int)vkMockErrorCount;
+}
+
+/*
+================================================================================================================================
+
+Test helpers.
+
+================================================================================================================================
+*/
+
+// Linear congruential generator, such that the random tests are the same on every platform.
+static uint32_t Random( uint32_t * seed )
+{
+	*seed = *seed * 1664525u + 1013904223u;
+	return *seed >> 8;
+}
+
+// Prints which condition of which test failed and returns the condition.
+static bool Expect( const bool condition, const char * test, const char * what )
+{
+	if ( !condition )
+	{
+		Print( "%s: %s\n", test, what );
+	}
+	return condition;
+}
+
+#endif // !KSVK_MOCK_H